@@ -32,6 +32,8 @@
 //*	Feb 26,	2021	<MLS> Added logic to look for different USB ports ttyACM0 -> ttyACM4
 //*	Dec 13,	2021	<MLS> Added WatchDog_TimeOut() to shutterdriver_arduino
 //*	Jun  9,	2023	<MLS> Fixed call to GetDomeShutterStatusString()
+//*	Oct 18,	2026	<MLS> Arduino serial I/O now uses serial_transport, no more blocking reads
+//*	Oct 18,	2026	<MLS> Removed tcflush(TCOFLUSH) from SendCommand(), it could discard the command
 //*****************************************************************************
 
 #ifdef _ENABLE_SHUTTER_
@@ -58,6 +60,7 @@
 #include	"shutterdriver_arduino.h"
 
 #include	"serialport.h"
+#include	"serial_transport.h"
 
 
 
@@ -95,6 +98,10 @@ ShutterArduino::ShutterArduino(const int argDevNum)
 ShutterArduino::~ShutterArduino(void)
 {
 	CONSOLE_DEBUG(__FUNCTION__);
+	if (cArduinoFileDesc >= 0)
+	{
+		SerialTransport_Close(&cArduinoTransport);
+	}
 }
 
 //*****************************************************************************
@@ -271,67 +278,43 @@ double		myPercentOpen;
 	}
 }
 
-#define	kReadBufferSize		256
-
+//*****************************************************************************
+//*	the Arduino sends status continuously, take whatever complete lines are there
+//*	this does not wait, a partial line stays in the transport buffer for next time
 //*****************************************************************************
 void	ShutterArduino::ReadArduinoData(void)
 {
-int		readCnt;
-char	readBuffer[kReadBufferSize];
-char	theChar;
-bool	keepGoing;
+int		lineCnt;
+int		frameLen;
 int		iii;
-int		charsRead;
-
+int		ccc;
+char	theChar;
 
 //	CONSOLE_DEBUG(__FUNCTION__);
 	if (cArduinoFileDesc >= 0)
 	{
-		keepGoing	=	true;
-		readCnt		=	0;
-		while (keepGoing && (readCnt < 20))
+		lineCnt		=	0;
+		frameLen	=	SerialTransport_ReadFrame(&cArduinoTransport, cArduinoLineBuf, kArduino_LineBuffSize, 0);
+		while ((frameLen >= 0) && (lineCnt < 20))
 		{
-			//*	read data from serial port
-			charsRead	=	read(cArduinoFileDesc, readBuffer, (kReadBufferSize - 2));
-			if (charsRead > 0)
+			//*	strip the CR and any other control characters
+			ccc	=	0;
+			for (iii=0; iii<frameLen; iii++)
 			{
-				readCnt++;
-				for (iii=0; iii<charsRead; iii++)
+				theChar		=	cArduinoLineBuf[iii];
+				if ((theChar >= 0x20) || (theChar == 0x09))
 				{
-					theChar		=	readBuffer[iii];
-					if ((theChar >= 0x20) || (theChar == 0x09))
-					{
-						if (cArduinoByteCnt < (kArduino_LineBuffSize - 2))
-						{
-							cArduinoLineBuf[cArduinoByteCnt++]	=	theChar;
-							cArduinoLineBuf[cArduinoByteCnt]	=	0;
-						}
-						else
-						{
-							CONSOLE_DEBUG("Buffer overflow");
-						//	CONSOLE_DEBUG_W_STR("Buffer overflow, current buf =", cArduinoLineBuf);
-							cArduinoByteCnt		=	0;
-							cArduinoLineBuf[0]	=	0;
-						}
-					}
-					else if ((theChar == 0x0d) || (theChar == 0x0a))
-					{
-						cArduinoLineBuf[cArduinoByteCnt]	=	0;
-						if (strlen(cArduinoLineBuf) > 2)
-						{
-//							CONSOLE_DEBUG_W_STR("Ard:", cArduinoLineBuf);
-							ProcessArduinoLine(cArduinoLineBuf);
-						}
-						cArduinoByteCnt		=	0;
-						cArduinoLineBuf[0]	=	0;
-					}
+					cArduinoLineBuf[ccc++]	=	theChar;
 				}
 			}
-			else
+			cArduinoLineBuf[ccc]	=	0;
+			if (ccc > 2)
 			{
-				//*	no more data to read for now
-				keepGoing	=	false;
+//				CONSOLE_DEBUG_W_STR("Ard:", cArduinoLineBuf);
+				ProcessArduinoLine(cArduinoLineBuf);
 			}
+			lineCnt++;
+			frameLen	=	SerialTransport_ReadFrame(&cArduinoTransport, cArduinoLineBuf, kArduino_LineBuffSize, 0);
 		}
 	}
 	else
@@ -504,6 +487,8 @@ int			usbPortNum;
 	{
 		openOK	=	true;
 		Serial_Set_Attribs(cArduinoFileDesc, B115200, 0);	//*	set the baud rate
+		SerialTransport_Init(&cArduinoTransport, cArduinoFileDesc);
+		SerialTransport_SetTerminator(&cArduinoTransport, 0x0a);
 	}
 	else
 	{
@@ -526,7 +511,7 @@ bool	sentOK;
 	if (cArduinoFileDesc >= 0)
 	{
 		sLen			=	strlen(theCommand);
-		bytesWritten	=	write(cArduinoFileDesc, theCommand, sLen);
+		bytesWritten	=	SerialTransport_Write(&cArduinoTransport, theCommand, sLen, 500);
 		if (bytesWritten > 0)
 		{
 			sentOK			=	true;
@@ -535,9 +520,6 @@ bool	sentOK;
 		{
 			CONSOLE_DEBUG_W_NUM("Error occurred on write, errno=", errno);
 		}
-		tcflush(cArduinoFileDesc, TCOFLUSH);
-
-		usleep(5000);
 	}
 	return(sentOK);
 }
@@ -9,6 +9,10 @@
 	#include	"shutterdriver.h"
 #endif
 
+#ifndef _SERIAL_TRANSPORT_H_
+	#include	"serial_transport.h"
+#endif
+
 #define	kArduino_LogBufferSize	4096
 #define	kArduino_LineBuffSize	256
 
@@ -42,8 +46,8 @@ class ShutterArduino: public ShutterDriver
 //				void	GetArduinoLog(void);
 
 				int		cArduinoFileDesc;				//*	port file descriptor
+				TYPE_SerialTransport	cArduinoTransport;
 				char	cArduinoLineBuf[kArduino_LineBuffSize];
-				int		cArduinoByteCnt;
 
 				char	cLogBuffer[kArduino_LogBufferSize];
 				int		cLogLineCnt;
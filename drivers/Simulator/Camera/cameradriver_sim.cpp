@@ -27,6 +27,7 @@
 //*	Apr 22,	2022	<MLS> Created cameradriver_sim.cpp
 //*	Mar  4,	2023	<MLS> CONFORMU-camera/simulator -> PASSED!!!!!!!!!!!!!!!!!!!!!
 //*	Jun 18,	2023	<MLS> Added Read_CoolerPowerLevel()
+//*	Oct 18,	2026	<MLS> Exposure time is honored, ImageReady is left alone in pipelined sequences
 //*****************************************************************************
 
 #if defined(_ENABLE_CAMERA_) && defined(_ENABLE_CAMERA_SIMULATOR_)
@@ -270,7 +271,11 @@ TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_NotImplemented;
 	CONSOLE_DEBUG(__FUNCTION__);
 	if (cCommonProp.Connected)
 	{
-		cCameraProp.ImageReady		=	false;
+		//*	in a pipelined sequence the previous frame can still be downloaded
+		if ((cImageMode != kImageMode_Sequence) || (cSeqPipelined == false))
+		{
+			cCameraProp.ImageReady		=	false;
+		}
 
 //		durationSeconds	=	(exposureMicrosecs * 1.0) / 1000000.0;
 //		durationSeconds	=	2;
@@ -303,7 +308,7 @@ TYPE_EXPOSURE_STATUS	CameraDriverSIM::Check_Exposure(bool verboseFlag)
 {
 TYPE_EXPOSURE_STATUS	myExposureStatus;
 struct timeval			currentTIme;
-time_t					deltaTime_secs;
+int64_t					deltaTime_us;
 
 	//--------------------------------------------
 	//*	simulate image
@@ -312,10 +317,11 @@ time_t					deltaTime_secs;
 		case kCameraState_TakingPicture:
 			myExposureStatus		=	kExposure_Working;
 			gettimeofday(&currentTIme, NULL);	//*	get the current time
-			deltaTime_secs	=	currentTIme.tv_sec - cCameraProp.Lastexposure_StartTime.tv_sec;
+			deltaTime_us	=	((currentTIme.tv_sec - cCameraProp.Lastexposure_StartTime.tv_sec) * 1000000LL) +
+								(currentTIme.tv_usec - cCameraProp.Lastexposure_StartTime.tv_usec);
 
-//			CONSOLE_DEBUG_W_LONG("deltaTime_secs\t=",			deltaTime_secs);
-			if (deltaTime_secs > 2)
+//			CONSOLE_DEBUG_W_LONG("deltaTime_us\t=",			deltaTime_us);
+			if (deltaTime_us >= cCameraProp.Lastexposure_duration_us)
 			{
 				CONSOLE_DEBUG("Not kCameraState_TakingPicture -->> kCameraState_Idle");
 				myExposureStatus		=	kExposure_Success;
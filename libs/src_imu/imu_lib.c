@@ -12,6 +12,13 @@
 //*	Jan 15,	2024	<MLS> Moved IMU averaging from imu_lib_bno055.c to imu_lib.c
 //*	Jan 15,	2024	<MLS> The LIS2DH12 has roll off by 90 degrees, fixed in IMU_GetAverageRoll()
 //*	Feb 25,	2024	<MLS> Added IMU_GetIMUtypeString()
+//*	Oct 18,	2026	<MLS> Fixed gIMUdataIdx writing one past the end of gIMUdata[]
+//*	Oct 18,	2026	<MLS> Samples now go into a lock free ring (imu_ring.c)
+//*	Oct 18,	2026	<MLS> Added IMU_GetAverageRoll_Pitch_Yaw() for a consistent triple
+//*	Oct 18,	2026	<MLS> Added IMU_SetSampleRate(), IMU_SetAverageCount()
+//*	Oct 18,	2026	<MLS> Added IMU_InitSynthetic() for testing without hardware
+//*	Oct 18,	2026	<MLS> BNO055 now feeds the background thread using Euler angles
+//*	Oct 18,	2026	<MLS> IMU_StartBackgroundThread() only starts the thread once
 //*****************************************************************************
 
 #ifdef _ENABLE_IMU_
@@ -22,6 +29,8 @@
 #include	<stdio.h>
 #include	<string.h>
 #include	<unistd.h>
+#include	<math.h>
+#include	<time.h>
 #include	<pthread.h>
 
 
@@ -30,28 +39,19 @@
 
 
 #include	"imu_lib.h"
+#include	"imu_ring.h"
 #include	"imu_lib_bno055.h"
 #include	"i2c_bno055.h"
 #include	"imu_lib_LIS2DH12.h"
 
 
-#define	kSampleFreuency	5
-#define	kAverageCount	10
-//*****************************************************************************
-typedef struct
-{
-	double			heading;
-	double			roll;
-	double			pitch;
-	double			yaw;
-
-} TYPE_IMU_DATA;
+#define	kDefaultSampleRate_Hz	1.0
+#define	kMaxSampleRate_Hz		10000.0
 
 
 //static	bool			gIMU_IsAvailable			=	false;
 //static	int				gIMUloopExceededErrCount	=	0;
 //static	int				gIMUresetCount				=	0;
-//static	bool			gIMU_ThreadIsRunning		=	false;
 //static	pthread_mutex_t gMutex	=	PTHREAD_MUTEX_INITIALIZER;
 //static long				gTotalDataErrors	=	0;
 //static long				gTotalReadCount		=	0;
@@ -59,9 +59,9 @@ typedef struct
 static	pthread_t			gIMUthreadID;
 
 static	bool				gIMU_needsInit				=	true;
-static TYPE_IMU_DATA		gIMUdata[kAverageCount];
-static TYPE_IMU_DATA		gIMUaverage;
-static int					gIMUdataIdx;
+static	bool				gIMU_ThreadIsRunning		=	false;
+static	TYPE_IMU_RING		gIMUring;
+static	double				gIMUsampleRate_Hz			=	kDefaultSampleRate_Hz;
 
 #define		kMaxIMUreadCnt	20
 
@@ -143,27 +143,56 @@ void	IMU_GetIMUtypeString(char *imuTypeString)
 		case kIMU_type_None:		strcpy(imuTypeString, "No IMU detected");	break;
 		case kIMU_type_BNO055:		strcpy(imuTypeString, "BNO055");			break;
 		case kIMU_type_LIS2DH12:	strcpy(imuTypeString, "LIS2DH12");			break;
+		case kIMU_type_Synthetic:	strcpy(imuTypeString, "Synthetic");			break;
 
 	}
 }
 
 
+//*****************************************************************************
+//*	Synthetic IMU, a slow swing with some noise.
+//*	pitch is always roll / 2 so mixed up readings are easy to spot,
+//*	yaw is 360 - roll so the heading crosses north
+//*****************************************************************************
+static int	IMU_Synthetic_GetRoll_Pitch_Yaw(double *rollValue, double *pitchValue, double *yawValue)
+{
+struct timespec	now;
+double			seconds;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	seconds		=	now.tv_sec + (now.tv_nsec / 1.0e9);
+	*rollValue	=	(30.0 * sin(seconds / 10.0)) + ((rand() % 100) / 1000.0);
+	*pitchValue	=	*rollValue / 2.0;
+	*yawValue	=	360.0 - *rollValue;
+	if (*yawValue >= 360.0)
+	{
+		*yawValue	-=	360.0;
+	}
+	return(0);
+}
+
 //*****************************************************************************
 static int	IMU_GetRoll_Pitch_Yaw(double *rollValue, double *pitchValue, double *yawValue)
 {
-int	returnCode;
+int		returnCode;
+double	heading;
 
 	returnCode	=	-1;
 	switch(gIMU_TypePresent)
 	{
 		case kIMU_type_BNO055:
-//			returnCode	=	IMU_BNO055_GetRoll_Pitch_Yaw();
+			returnCode	=	IMU_BNO055_Read_Euler(&heading, rollValue, pitchValue);
+			*yawValue	=	heading;
 			break;
 
 		case kIMU_type_LIS2DH12:
 			returnCode	=	IMU_LIS2DH12_GetRoll_Pitch_Yaw(rollValue, pitchValue, yawValue);
 			break;
 
+		case kIMU_type_Synthetic:
+			returnCode	=	IMU_Synthetic_GetRoll_Pitch_Yaw(rollValue, pitchValue, yawValue);
+			break;
+
 		default:
 			returnCode	=	-1;
 			break;
@@ -173,93 +202,140 @@ int	returnCode;
 
 
 //*****************************************************************************
-double	IMU_GetAverageRoll(void)
+//*	returns roll, pitch and yaw all from the same update of the average
+//*	returns -1 if there are no samples yet
+//*****************************************************************************
+int	IMU_GetAverageRoll_Pitch_Yaw(double *rollValue, double *pitchValue, double *yawValue)
 {
-double	adjustedRollValue;
+TYPE_IMU_READING	reading;
 
-	adjustedRollValue	=	gIMUaverage.roll;
-//	CONSOLE_DEBUG_W_DBL("adjustedRollValue\t=",	adjustedRollValue);
+	IMURing_GetReading(&gIMUring, &reading);
+	*rollValue	=	reading.roll;
+	*pitchValue	=	reading.pitch;
+	*yawValue	=	reading.yaw;
 	if (gIMU_TypePresent == kIMU_type_LIS2DH12)
 	{
-		adjustedRollValue	=	gIMUaverage.roll - 90;
+		*rollValue	=	reading.roll - 90;
 	}
-//	CONSOLE_DEBUG_W_DBL("adjustedRollValue\t=",	adjustedRollValue);
-//	CONSOLE_DEBUG_W_DBL(__FUNCTION__, gIMUaverage.roll);
-	return(adjustedRollValue);
+	return((reading.sampleCount > 0) ? 0 : -1);
 }
 
 //*****************************************************************************
-double	IMU_GetAveragePitch(void)
+double	IMU_GetAverageRoll(void)
 {
-//	CONSOLE_DEBUG_W_DBL(__FUNCTION__, gIMUaverage.pitch);
-	return(gIMUaverage.pitch);
+double	rollValue;
+double	pitchValue;
+double	yawValue;
+
+	IMU_GetAverageRoll_Pitch_Yaw(&rollValue, &pitchValue, &yawValue);
+	return(rollValue);
 }
 
 //*****************************************************************************
-double	IMU_GetAverageYaw(void)
+double	IMU_GetAveragePitch(void)
 {
-//	CONSOLE_DEBUG_W_DBL(__FUNCTION__, gIMUaverage.yaw);
-	return(gIMUaverage.yaw);
+double	rollValue;
+double	pitchValue;
+double	yawValue;
+
+	IMU_GetAverageRoll_Pitch_Yaw(&rollValue, &pitchValue, &yawValue);
+	return(pitchValue);
 }
 
 //*****************************************************************************
-static void	IMU_ComputeAverage(void)
+double	IMU_GetAverageYaw(void)
 {
-int			iii;
-double		rollSum;
-double		pitchSum;
-double		yawSum;
+double	rollValue;
+double	pitchValue;
+double	yawValue;
 
-//	CONSOLE_DEBUG(__FUNCTION__);
+	IMU_GetAverageRoll_Pitch_Yaw(&rollValue, &pitchValue, &yawValue);
+	return(yawValue);
+}
 
-	rollSum		=	0.0;
-	pitchSum	=	0.0;
-	yawSum		=	0.0;
+//*****************************************************************************
+//*	can be changed while the background thread is running
+//*****************************************************************************
+void	IMU_SetSampleRate(const double sampleRate_Hz)
+{
+double	newRate;
 
-	for (iii=0; iii<kAverageCount; iii++)
+	newRate	=	sampleRate_Hz;
+	if (newRate <= 0.0)
+	{
+		newRate	=	kDefaultSampleRate_Hz;
+	}
+	if (newRate > kMaxSampleRate_Hz)
 	{
-		rollSum		+=	gIMUdata[iii].roll;
-		pitchSum	+=	gIMUdata[iii].pitch;
-		yawSum		+=	gIMUdata[iii].yaw;
+		newRate	=	kMaxSampleRate_Hz;
 	}
+	__atomic_store(&gIMUsampleRate_Hz, &newRate, __ATOMIC_RELAXED);
+}
 
-	gIMUaverage.roll	=	rollSum		/ kAverageCount;
-	gIMUaverage.pitch	=	pitchSum	/ kAverageCount;
-	gIMUaverage.yaw		=	yawSum		/ kAverageCount;
+//*****************************************************************************
+//*	number of samples in the average, can be changed while the background thread is running
+//*****************************************************************************
+void	IMU_SetAverageCount(const int averageCount)
+{
+	IMURing_SetAverageCnt(&gIMUring, averageCount);
+}
 
+//*****************************************************************************
+//*	use the synthetic IMU instead of looking for hardware
+//*****************************************************************************
+int	IMU_InitSynthetic(void)
+{
+	CONSOLE_DEBUG(__FUNCTION__);
+	gIMU_TypePresent	=	kIMU_type_Synthetic;
+	gIMU_needsInit		=	false;
+	return(0);
 }
+
 //*****************************************************************************
 static void	*IMU_BackgroundThread(void *arg)
 {
-bool		keepRunning;
-double		myRoll;
-double		myPitch;
-double		myYaw;
-int			imuRetCode;
+bool			keepRunning;
+double			myRoll;
+double			myPitch;
+double			myYaw;
+int				imuRetCode;
+struct timespec	nextTime;
+struct timespec	now;
+double			sampleRate_Hz;
+long			period_ns;
 
 	if (arg != NULL)
 	{
 		CONSOLE_DEBUG("arg is not null");
 	}
+	clock_gettime(CLOCK_MONOTONIC, &nextTime);
 	keepRunning				=	true;
 	while (keepRunning)
 	{
 		imuRetCode	=	IMU_GetRoll_Pitch_Yaw(&myRoll, &myPitch, &myYaw);
 		if (imuRetCode == 0)
 		{
-			gIMUdata[gIMUdataIdx].roll	=	myRoll;
-			gIMUdata[gIMUdataIdx].pitch	=	myPitch;
-			gIMUdata[gIMUdataIdx].yaw	=	myYaw;
-
-			//*	check for buffer limits
-			gIMUdataIdx++;
-			if (gIMUdataIdx > kAverageCount)
-			{
-				gIMUdataIdx	=	0;
-			}
-			IMU_ComputeAverage();
+			clock_gettime(CLOCK_MONOTONIC, &now);
+			IMURing_AddSample(&gIMUring, now.tv_sec + (now.tv_nsec / 1.0e9), myRoll, myPitch, myYaw);
+		}
+
+		//*	absolute wake up times so the rate does not drift with the read time
+		__atomic_load(&gIMUsampleRate_Hz, &sampleRate_Hz, __ATOMIC_RELAXED);
+		period_ns			=	(long)(1.0e9 / sampleRate_Hz);
+		nextTime.tv_sec		+=	period_ns / 1000000000;
+		nextTime.tv_nsec	+=	period_ns % 1000000000;
+		if (nextTime.tv_nsec >= 1000000000)
+		{
+			nextTime.tv_nsec	-=	1000000000;
+			nextTime.tv_sec++;
 		}
-		sleep(1);
+		//*	if the read took longer than a period, start over from now
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		if ((now.tv_sec > nextTime.tv_sec) || ((now.tv_sec == nextTime.tv_sec) && (now.tv_nsec > nextTime.tv_nsec)))
+		{
+			nextTime	=	now;
+		}
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &nextTime, NULL);
 	}
 	return(NULL);
 }
@@ -274,8 +350,12 @@ bool		okToStartThread;
 	CONSOLE_DEBUG("***************************************************************");
 	CONSOLE_DEBUG(__FUNCTION__);
 
-	memset((void *)gIMUdata, 0, (kAverageCount * sizeof(TYPE_IMU_DATA)));
-	gIMUdataIdx		=	0;
+	//*	the camera and the telescope both want the averages, one thread feeds them all
+	if (gIMU_ThreadIsRunning)
+	{
+		return(0);
+	}
+	IMURing_Init(&gIMUring, kIMU_DefaultAverageCnt);
 	okToStartThread	=	true;
 	//*	check to see if the IMU needs to be initialized
 	if (gIMU_needsInit)
@@ -290,8 +370,11 @@ bool		okToStartThread;
 	if (okToStartThread)
 	{
 		//*	only start the thread if init was successful
-		gIMUdataIdx	=	0;
 		threadErr	=	pthread_create(&gIMUthreadID, NULL, &IMU_BackgroundThread, arg);
+		if (threadErr == 0)
+		{
+			gIMU_ThreadIsRunning	=	true;
+		}
 	}
 	return(threadErr);
 }
@@ -27,7 +27,10 @@ bool	IMU_StartBackgroundThread(void *thisPointer);
 double	IMU_GetAverageRoll(void);
 double	IMU_GetAveragePitch(void);
 double	IMU_GetAverageYaw(void);
-//int		IMU_GetRoll_Pitch_Yaw(double *rollValue, double *pitchValue, double *yawValue);
+int		IMU_GetAverageRoll_Pitch_Yaw(double *rollValue, double *pitchValue, double *yawValue);
+void	IMU_SetSampleRate(const double sampleRate_Hz);
+void	IMU_SetAverageCount(const int averageCount);
+int		IMU_InitSynthetic(void);
 
 
 //*****************************************************************************
@@ -36,6 +39,7 @@ enum
 	kIMU_type_None		=	0,
 	kIMU_type_BNO055,
 	kIMU_type_LIS2DH12,
+	kIMU_type_Synthetic,
 
 	kIMU_Last
 };
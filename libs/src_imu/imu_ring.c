@@ -0,0 +1,424 @@
+//*****************************************************************************
+//*		imu_ring.c
+//*
+//*		Sample ring with running averages for the IMU background thread
+//*
+//*		One thread writes samples, any thread can read the averages.
+//*		The averages are kept as running sums so adding a sample is O(1)
+//*		no matter the window size. Yaw is a heading, it is averaged as
+//*		sin/cos sums so 359 and 1 average to 0 and not 180.
+//*		The averages are published with a sequence lock,
+//*		the writer never waits for a reader and a reader always gets
+//*		roll, pitch and yaw from the same update.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 18,	2026	<MLS> Created imu_ring.c
+//*	Oct 18,	2026	<MLS> Added synthetic IMU test (_INCLUDE_IMU_RING_MAIN_)
+//*	Oct 18,	2026	<MLS> Yaw is now a circular mean, it was wrong across the 360 wrap
+//*****************************************************************************
+
+#include	<stdbool.h>
+#include	<stdint.h>
+#include	<string.h>
+#include	<math.h>
+
+#include	"imu_ring.h"
+
+#define	kIMU_RingMask	(kIMU_RingSize - 1)
+
+#define	RADIANS(degrees)	((degrees) * M_PI / 180.0)
+#define	DEGREES(radians)	((radians) * 180.0 / M_PI)
+
+//*	relaxed copies of the published values, the sequence number does the ordering
+#define	STORE_RELAXED(dst, src)		__atomic_store(&(dst), &(src), __ATOMIC_RELAXED)
+#define	LOAD_RELAXED(dst, src)		__atomic_load(&(src), &(dst), __ATOMIC_RELAXED)
+
+//*****************************************************************************
+static int	ClampAverageCnt(const int averageCnt)
+{
+	if (averageCnt < 1)
+	{
+		return(1);
+	}
+	if (averageCnt > kIMU_RingSize)
+	{
+		return(kIMU_RingSize);
+	}
+	return(averageCnt);
+}
+
+//*****************************************************************************
+void	IMURing_Init(TYPE_IMU_RING *ring, const int averageCnt)
+{
+	memset(ring, 0, sizeof(TYPE_IMU_RING));
+	ring->averageCnt	=	ClampAverageCnt(averageCnt);
+	ring->requestedCnt	=	ring->averageCnt;
+}
+
+//*****************************************************************************
+//*	can be called from any thread, takes effect with the next sample
+//*****************************************************************************
+void	IMURing_SetAverageCnt(TYPE_IMU_RING *ring, const int averageCnt)
+{
+	__atomic_store_n(&ring->requestedCnt, ClampAverageCnt(averageCnt), __ATOMIC_RELAXED);
+}
+
+//*****************************************************************************
+//*	recompute the sums from the samples in the window,
+//*	used when the window changes and now and then to limit rounding drift
+//*****************************************************************************
+static void	Resum(TYPE_IMU_RING *ring)
+{
+uint32_t	count;
+uint32_t	iii;
+uint32_t	ringIdx;
+
+	ring->rollSum	=	0.0;
+	ring->pitchSum	=	0.0;
+	ring->yawSinSum	=	0.0;
+	ring->yawCosSum	=	0.0;
+	count			=	(ring->writeCount < (uint32_t)ring->averageCnt) ? ring->writeCount : (uint32_t)ring->averageCnt;
+	for (iii=1; iii<=count; iii++)
+	{
+		ringIdx			=	(ring->writeCount - iii) & kIMU_RingMask;
+		ring->rollSum	+=	ring->sample[ringIdx].roll;
+		ring->pitchSum	+=	ring->sample[ringIdx].pitch;
+		ring->yawSinSum	+=	sin(RADIANS(ring->sample[ringIdx].yaw));
+		ring->yawCosSum	+=	cos(RADIANS(ring->sample[ringIdx].yaw));
+	}
+	ring->addsSinceResum	=	0;
+}
+
+//*****************************************************************************
+//*	only ONE thread may call this
+//*****************************************************************************
+void	IMURing_AddSample(	TYPE_IMU_RING	*ring,
+							const double	timeStamp,
+							const double	roll,
+							const double	pitch,
+							const double	yaw)
+{
+TYPE_IMU_SAMPLE		*oldSample;
+TYPE_IMU_SAMPLE		*newSample;
+TYPE_IMU_READING	reading;
+int					requestedCnt;
+bool				needsResum;
+uint32_t			sequence;
+
+	requestedCnt	=	__atomic_load_n(&ring->requestedCnt, __ATOMIC_RELAXED);
+	needsResum		=	(requestedCnt != ring->averageCnt);
+	ring->averageCnt	=	requestedCnt;
+
+	//*	take out the sample leaving the window before it gets overwritten
+	if ((needsResum == false) && (ring->writeCount >= (uint32_t)ring->averageCnt))
+	{
+		oldSample		=	&ring->sample[(ring->writeCount - ring->averageCnt) & kIMU_RingMask];
+		ring->rollSum	-=	oldSample->roll;
+		ring->pitchSum	-=	oldSample->pitch;
+		ring->yawSinSum	-=	sin(RADIANS(oldSample->yaw));
+		ring->yawCosSum	-=	cos(RADIANS(oldSample->yaw));
+	}
+	newSample				=	&ring->sample[ring->writeCount & kIMU_RingMask];
+	newSample->timeStamp	=	timeStamp;
+	newSample->roll			=	roll;
+	newSample->pitch		=	pitch;
+	newSample->yaw			=	yaw;
+	ring->rollSum			+=	roll;
+	ring->pitchSum			+=	pitch;
+	ring->yawSinSum			+=	sin(RADIANS(yaw));
+	ring->yawCosSum			+=	cos(RADIANS(yaw));
+	ring->writeCount++;
+
+	ring->addsSinceResum++;
+	if (needsResum || (ring->addsSinceResum >= kIMU_RingSize))
+	{
+		Resum(ring);
+	}
+
+	reading.sampleCount		=	(ring->writeCount < (uint32_t)ring->averageCnt) ? ring->writeCount : (uint32_t)ring->averageCnt;
+	reading.roll			=	ring->rollSum / reading.sampleCount;
+	reading.pitch			=	ring->pitchSum / reading.sampleCount;
+	reading.yaw				=	DEGREES(atan2(ring->yawSinSum, ring->yawCosSum));
+	if (reading.yaw < 0.0)
+	{
+		reading.yaw	+=	360.0;
+	}
+	//*	-1e-15 + 360 rounds to 360
+	if (reading.yaw >= 360.0)
+	{
+		reading.yaw	=	0.0;
+	}
+	reading.timeStamp		=	timeStamp;
+	reading.totalSamples	=	ring->writeCount;
+
+	//*	publish, the sequence is odd while the values are changing
+	sequence	=	ring->sequence;
+	__atomic_store_n(&ring->sequence, sequence + 1, __ATOMIC_RELAXED);
+	__atomic_thread_fence(__ATOMIC_RELEASE);
+	STORE_RELAXED(ring->published.roll,			reading.roll);
+	STORE_RELAXED(ring->published.pitch,		reading.pitch);
+	STORE_RELAXED(ring->published.yaw,			reading.yaw);
+	STORE_RELAXED(ring->published.timeStamp,	reading.timeStamp);
+	STORE_RELAXED(ring->published.sampleCount,	reading.sampleCount);
+	STORE_RELAXED(ring->published.totalSamples,	reading.totalSamples);
+	__atomic_store_n(&ring->sequence, sequence + 2, __ATOMIC_RELEASE);
+}
+
+//*****************************************************************************
+//*	can be called from any thread, never blocks the writer
+//*****************************************************************************
+void	IMURing_GetReading(TYPE_IMU_RING *ring, TYPE_IMU_READING *reading)
+{
+uint32_t	seqBefore;
+uint32_t	seqAfter;
+
+	while (true)
+	{
+		seqBefore	=	__atomic_load_n(&ring->sequence, __ATOMIC_ACQUIRE);
+		if ((seqBefore & 1) == 0)
+		{
+			LOAD_RELAXED(reading->roll,			ring->published.roll);
+			LOAD_RELAXED(reading->pitch,		ring->published.pitch);
+			LOAD_RELAXED(reading->yaw,			ring->published.yaw);
+			LOAD_RELAXED(reading->timeStamp,	ring->published.timeStamp);
+			LOAD_RELAXED(reading->sampleCount,	ring->published.sampleCount);
+			LOAD_RELAXED(reading->totalSamples,	ring->published.totalSamples);
+			__atomic_thread_fence(__ATOMIC_ACQUIRE);
+			seqAfter	=	__atomic_load_n(&ring->sequence, __ATOMIC_RELAXED);
+			if (seqBefore == seqAfter)
+			{
+				break;
+			}
+		}
+		__atomic_fetch_add(&ring->readRetries, 1, __ATOMIC_RELAXED);
+	}
+}
+
+
+#ifdef _INCLUDE_IMU_RING_MAIN_
+//*****************************************************************************
+//*	Synthetic IMU at kHz rates with several readers.
+//*	pitch is always roll / 2, so a reader that got values from two different
+//*	updates shows up as a mismatch. yaw is 360 - roll, it crosses the 360 wrap
+//*	every time roll goes through 0.
+//*
+//*	gcc -O2 -D_INCLUDE_IMU_RING_MAIN_ imu_ring.c -lpthread -lm -o imuringtest
+//*****************************************************************************
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<math.h>
+#include	<time.h>
+#include	<unistd.h>
+#include	<pthread.h>
+
+#define	kTestSampleRate		5000.0
+#define	kTestSeconds		3
+#define	kTestReaders		3
+
+static TYPE_IMU_RING	gTestRing;
+static volatile bool	gTestRunning	=	true;
+
+//*****************************************************************************
+static double	WrapDegrees(const double degrees)
+{
+double	wrapped;
+
+	wrapped	=	fmod(degrees, 360.0);
+	if (wrapped < 0.0)
+	{
+		wrapped	+=	360.0;
+	}
+	return(wrapped);
+}
+
+//*****************************************************************************
+//*	smallest difference between two headings
+//*****************************************************************************
+static double	AngleDiff(const double angle1, const double angle2)
+{
+	return(fabs(WrapDegrees(angle1 - angle2 + 180.0) - 180.0));
+}
+
+//*****************************************************************************
+//*	headings on both sides of north, single threaded, known answers
+//*****************************************************************************
+static int	YawWrap_Test(void)
+{
+TYPE_IMU_RING		ring;
+TYPE_IMU_READING	reading;
+int					failCnt;
+int					iii;
+
+	failCnt	=	0;
+
+	//*	359 and 1 have to average to 0, not 180
+	IMURing_Init(&ring, 2);
+	IMURing_AddSample(&ring, 0.0, 0.0, 0.0, 359.0);
+	IMURing_AddSample(&ring, 1.0, 0.0, 0.0, 1.0);
+	IMURing_GetReading(&ring, &reading);
+	printf("Yaw 359, 1           = %.6f\r\n", reading.yaw);
+	if ((AngleDiff(reading.yaw, 0.0) > 1.0e-9) || (reading.yaw < 0.0) || (reading.yaw >= 360.0))
+	{
+		failCnt++;
+	}
+
+	//*	355 through 364 in a window of 10, then keep turning past north,
+	//*	samples leave the window on one side of the wrap and enter on the other
+	IMURing_Init(&ring, 10);
+	for (iii=0; iii<40; iii++)
+	{
+		IMURing_AddSample(&ring, iii, 0.0, 0.0, WrapDegrees(355.0 + iii));
+		IMURing_GetReading(&ring, &reading);
+		if ((iii >= 9) && (AngleDiff(reading.yaw, WrapDegrees(355.0 + iii - 4.5)) > 1.0e-9))
+		{
+			printf("Yaw sweep %d          = %.6f, expected %.6f\r\n", iii, reading.yaw, WrapDegrees(355.0 + iii - 4.5));
+			failCnt++;
+		}
+		if ((reading.yaw < 0.0) || (reading.yaw >= 360.0))
+		{
+			printf("Yaw out of range     = %.6f\r\n", reading.yaw);
+			failCnt++;
+		}
+	}
+	printf("Yaw sweep across 360 = %.6f (expected %.6f)\r\n", reading.yaw, WrapDegrees(355.0 + 39 - 4.5));
+	return(failCnt);
+}
+
+//*****************************************************************************
+static double	GetSeconds(void)
+{
+struct timespec	now;
+
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	return(now.tv_sec + (now.tv_nsec / 1.0e9));
+}
+
+//*****************************************************************************
+static void	*SyntheticIMU_Thread(void *arg)
+{
+struct timespec	nextTime;
+double			seconds;
+double			roll;
+long			period_ns;
+
+	period_ns	=	(long)(1.0e9 / kTestSampleRate);
+	clock_gettime(CLOCK_MONOTONIC, &nextTime);
+	while (gTestRunning)
+	{
+		seconds	=	GetSeconds();
+		//*	slow swing plus some noise, like a scope being moved
+		roll	=	(30.0 * sin(seconds)) + ((rand() % 1000) / 1000.0);
+		IMURing_AddSample(&gTestRing, seconds, roll, roll / 2.0, WrapDegrees(360.0 - roll));
+
+		//*	change the window now and then while the readers are going
+		if ((gTestRing.writeCount % 2000) == 0)
+		{
+			IMURing_SetAverageCnt(&gTestRing, 1 + (rand() % 100));
+		}
+
+		nextTime.tv_nsec	+=	period_ns;
+		if (nextTime.tv_nsec >= 1000000000)
+		{
+			nextTime.tv_nsec	-=	1000000000;
+			nextTime.tv_sec++;
+		}
+		clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &nextTime, NULL);
+	}
+	return(arg);
+}
+
+//*****************************************************************************
+static void	*Reader_Thread(void *arg)
+{
+TYPE_IMU_READING	reading;
+long				*badCount	=	(long *)arg;
+long				readCount	=	0;
+
+	while (gTestRunning)
+	{
+		IMURing_GetReading(&gTestRing, &reading);
+		//*	the circular mean of yaw is not exactly the arithmetic mean of roll,
+		//*	roll and pitch are what catch mixed up updates
+		if ((fabs((reading.pitch * 2.0) - reading.roll) > 1.0e-9) || (AngleDiff(reading.yaw, 360.0 - reading.roll) > 1.0e-3))
+		{
+			(*badCount)++;
+		}
+		readCount++;
+	}
+	return((void *)readCount);
+}
+
+//*****************************************************************************
+int main(int argc, char *argv[])
+{
+pthread_t			writerThread;
+pthread_t			readerThread[kTestReaders];
+long				badCount[kTestReaders];
+void				*readCount;
+long				totalReads	=	0;
+long				totalBad	=	0;
+TYPE_IMU_READING	reading;
+double				bruteRoll	=	0.0;
+double				bruteSin	=	0.0;
+double				bruteCos	=	0.0;
+double				bruteYaw;
+int					failCnt;
+uint32_t			iii;
+
+	(void)argc;
+	(void)argv;
+	failCnt	=	YawWrap_Test();
+
+	IMURing_Init(&gTestRing, kIMU_DefaultAverageCnt);
+	pthread_create(&writerThread, NULL, &SyntheticIMU_Thread, NULL);
+	for (iii=0; iii<kTestReaders; iii++)
+	{
+		badCount[iii]	=	0;
+		pthread_create(&readerThread[iii], NULL, &Reader_Thread, &badCount[iii]);
+	}
+	sleep(kTestSeconds);
+	gTestRunning	=	false;
+	pthread_join(writerThread, NULL);
+	for (iii=0; iii<kTestReaders; iii++)
+	{
+		pthread_join(readerThread[iii], &readCount);
+		totalReads	+=	(long)readCount;
+		totalBad	+=	badCount[iii];
+	}
+
+	//*	the running average has to match a brute force one
+	IMURing_GetReading(&gTestRing, &reading);
+	for (iii=1; iii<=reading.sampleCount; iii++)
+	{
+		bruteRoll	+=	gTestRing.sample[(gTestRing.writeCount - iii) & kIMU_RingMask].roll;
+		bruteSin	+=	sin(RADIANS(gTestRing.sample[(gTestRing.writeCount - iii) & kIMU_RingMask].yaw));
+		bruteCos	+=	cos(RADIANS(gTestRing.sample[(gTestRing.writeCount - iii) & kIMU_RingMask].yaw));
+	}
+	bruteRoll	=	bruteRoll / reading.sampleCount;
+	bruteYaw	=	WrapDegrees(DEGREES(atan2(bruteSin, bruteCos)));
+	if (totalBad != 0)
+	{
+		failCnt++;
+	}
+	if (fabs(reading.roll - bruteRoll) > 1.0e-6)
+	{
+		failCnt++;
+	}
+	if (AngleDiff(reading.yaw, bruteYaw) > 1.0e-6)
+	{
+		failCnt++;
+	}
+
+	printf("Samples written      = %u (%.0f per sec)\r\n",	gTestRing.writeCount, gTestRing.writeCount / (double)kTestSeconds);
+	printf("Reads                = %ld\r\n",				totalReads);
+	printf("Read retries         = %u\r\n",					gTestRing.readRetries);
+	printf("Inconsistent triples = %ld\r\n",				totalBad);
+	printf("Average roll         = %.9f (brute force %.9f, window %u)\r\n", reading.roll, bruteRoll, reading.sampleCount);
+	printf("Average yaw          = %.9f (brute force %.9f)\r\n", reading.yaw, bruteYaw);
+	printf("Failures = %d\r\n", failCnt);
+	return(failCnt);
+}
+#endif // _INCLUDE_IMU_RING_MAIN_
@@ -0,0 +1,77 @@
+//*****************************************************************************
+//#include "imu_ring.h"
+
+#ifndef	_IMU_RING_H_
+#define	_IMU_RING_H_
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define	kIMU_RingSize			1024		//*	must be a power of 2
+#define	kIMU_DefaultAverageCnt	10
+
+//*****************************************************************************
+typedef struct	//	TYPE_IMU_SAMPLE
+{
+	double		timeStamp;
+	double		roll;
+	double		pitch;
+	double		yaw;
+} TYPE_IMU_SAMPLE;
+
+//*****************************************************************************
+//*	what a reader gets, always from the same update
+//*****************************************************************************
+typedef struct	//	TYPE_IMU_READING
+{
+	double		roll;			//*	averages over the window
+	double		pitch;
+	double		yaw;			//*	circular mean, 0 to 360
+	double		timeStamp;		//*	of the newest sample
+	uint32_t	sampleCount;	//*	samples in the average
+	uint32_t	totalSamples;
+} TYPE_IMU_READING;
+
+//*****************************************************************************
+//*	Single writer, any number of readers.
+//*	The writer keeps running sums so each sample is O(1), the result is
+//*	published under a sequence lock, readers never block the writer
+//*	and retry if the writer was in the middle of an update.
+//*****************************************************************************
+typedef struct	//	TYPE_IMU_RING
+{
+	TYPE_IMU_SAMPLE		sample[kIMU_RingSize];
+	uint32_t			writeCount;			//*	total samples written
+	int					averageCnt;			//*	window size, 1 to kIMU_RingSize
+	int					requestedCnt;		//*	set by any thread, applied by the writer
+	double				rollSum;
+	double				pitchSum;
+	double				yawSinSum;			//*	yaw wraps at 360, it is averaged as a unit vector
+	double				yawCosSum;
+	uint32_t			addsSinceResum;
+
+	uint32_t			sequence;			//*	odd while the writer is publishing
+	TYPE_IMU_READING	published;
+	uint32_t			readRetries;
+} TYPE_IMU_RING;
+
+
+void	IMURing_Init(			TYPE_IMU_RING *ring, const int averageCnt);
+void	IMURing_SetAverageCnt(	TYPE_IMU_RING *ring, const int averageCnt);
+void	IMURing_AddSample(		TYPE_IMU_RING *ring, const double timeStamp, const double roll, const double pitch, const double yaw);
+void	IMURing_GetReading(		TYPE_IMU_RING *ring, TYPE_IMU_READING *reading);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _IMU_RING_H_
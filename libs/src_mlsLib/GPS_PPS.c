@@ -0,0 +1,527 @@
+//**************************************************************************************
+//*	GPS PPS (pulse per second) time keeping
+//*
+//*		The NMEA sentences tell us which second it is, but they come over a serial
+//*		port some 10s to 100s of milliseconds after the second started and that
+//*		delay moves around. The PPS edge marks the start of the second to within
+//*		microseconds and the kernel time stamps it when it happens.
+//*
+//*		Each edge is time stamped with the system clock, the NMEA time that follows
+//*		says which UTC second it was, the spacing of the edges gives the rate of the
+//*		system clock. Any system clock time (i.e. the start of an exposure) can then
+//*		be converted to UTC with sub-millisecond accuracy.
+//*
+//*		Uses the Linux PPS API (/dev/ppsN), a GPS PPS line on a GPIO pin shows up
+//*		as /dev/ppsN with the pps-gpio kernel driver.
+//**************************************************************************************
+//*	Edit History
+//*		MLS	=	Mark Sproul
+//**************************************************************************************
+//*	Oct 18,	2026	<MLS> Created GPS_PPS.c
+//*	Oct 18,	2026	<MLS> Added NMEA replay harness (_INCLUDE_PPS_REPLAY_MAIN_)
+//**************************************************************************************
+
+#include	<errno.h>
+#include	<fcntl.h>
+#include	<math.h>
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	<time.h>
+#include	<unistd.h>
+#include	<sys/ioctl.h>
+
+#if defined(__linux__)
+	#include	<linux/pps.h>
+#endif
+
+#define	_ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"GPS_PPS.h"
+
+#define	kNanoSecsPerSec		1000000000LL
+#define	kSecsPerDay			86400LL
+
+//**************************************************************************************
+void	PPS_Init(TYPE_PPS_STATE *ppsState)
+{
+	memset(ppsState, 0, sizeof(TYPE_PPS_STATE));
+	pthread_mutex_init(&ppsState->mutex, NULL);
+	ppsState->ppsFileDesc	=	-1;
+	ppsState->rate			=	1.0;
+}
+
+//**************************************************************************************
+int64_t	PPS_GetSystemTime_ns(void)
+{
+struct timespec	now;
+
+	clock_gettime(CLOCK_REALTIME, &now);
+	return((now.tv_sec * kNanoSecsPerSec) + now.tv_nsec);
+}
+
+//**************************************************************************************
+//*	called for every PPS edge with the system clock time of the edge
+//**************************************************************************************
+void	PPS_AddEdge(TYPE_PPS_STATE *ppsState, const int64_t edgeSys_ns)
+{
+int64_t		period_ns;
+int64_t		seconds;
+double		measuredRate;
+double		residual_ns;
+double		delta;
+
+	pthread_mutex_lock(&ppsState->mutex);
+	if (ppsState->edgeValid)
+	{
+		period_ns	=	edgeSys_ns - ppsState->edgeSys_ns;
+		seconds		=	llround((period_ns * ppsState->rate) / kNanoSecsPerSec);
+		if (seconds < 1)
+		{
+			//*	noise on the PPS line, not a second
+			ppsState->glitchCount++;
+			pthread_mutex_unlock(&ppsState->mutex);
+			return;
+		}
+		ppsState->missedEdges	+=	(seconds - 1);
+
+		measuredRate	=	(double)(seconds * kNanoSecsPerSec) / period_ns;
+		if (fabs(measuredRate - 1.0) < kPPS_MaxRateError)
+		{
+			if (seconds == 1)
+			{
+				//*	how far off this edge was from where the rate said it would be
+				residual_ns		=	period_ns - (kNanoSecsPerSec / ppsState->rate);
+				ppsState->jitterCount++;
+				delta						=	residual_ns - ppsState->jitterMean_ns;
+				ppsState->jitterMean_ns		+=	delta / ppsState->jitterCount;
+				ppsState->jitterM2			+=	delta * (residual_ns - ppsState->jitterMean_ns);
+				if (fabs(residual_ns) > ppsState->jitterMax_ns)
+				{
+					ppsState->jitterMax_ns	=	fabs(residual_ns);
+				}
+			}
+			if (ppsState->edgeCount < 2)
+			{
+				ppsState->rate	=	measuredRate;
+			}
+			else
+			{
+				ppsState->rate	+=	(measuredRate - ppsState->rate) / kPPS_RateFilter;
+			}
+		}
+		else
+		{
+			ppsState->glitchCount++;
+		}
+
+		if (ppsState->utcLabeled)
+		{
+			ppsState->edgeUTC_ns	+=	seconds * kNanoSecsPerSec;
+		}
+	}
+	ppsState->edgeSys_ns	=	edgeSys_ns;
+	ppsState->edgeValid		=	true;
+	ppsState->edgeCount++;
+	pthread_mutex_unlock(&ppsState->mutex);
+}
+
+//**************************************************************************************
+//*	called with the UTC time from an NMEA sentence and the system time it arrived,
+//*	the sentence is about the second that started with the last edge
+//**************************************************************************************
+void	PPS_LabelSecond(TYPE_PPS_STATE *ppsState, const int64_t sentenceSys_ns, const long utcSecsOfDay)
+{
+int64_t		edgeAge_ns;
+int64_t		edgeSecs;
+int64_t		utcSecs;
+
+	pthread_mutex_lock(&ppsState->mutex);
+	edgeAge_ns	=	sentenceSys_ns - ppsState->edgeSys_ns;
+	if (ppsState->edgeValid && (edgeAge_ns >= 0) && (edgeAge_ns < kNanoSecsPerSec))
+	{
+		//*	the day comes from the system clock, it only has to be within 12 hours
+		edgeSecs	=	ppsState->edgeSys_ns / kNanoSecsPerSec;
+		utcSecs		=	((edgeSecs / kSecsPerDay) * kSecsPerDay) + utcSecsOfDay;
+		if ((utcSecs - edgeSecs) > (kSecsPerDay / 2))
+		{
+			utcSecs	-=	kSecsPerDay;
+		}
+		else if ((edgeSecs - utcSecs) > (kSecsPerDay / 2))
+		{
+			utcSecs	+=	kSecsPerDay;
+		}
+
+		if (ppsState->utcLabeled && (ppsState->edgeUTC_ns != (utcSecs * kNanoSecsPerSec)))
+		{
+			ppsState->relabelCount++;
+			CONSOLE_DEBUG_W_LONG("PPS edge relabeled, NMEA second\t=", utcSecsOfDay);
+		}
+		ppsState->edgeUTC_ns	=	utcSecs * kNanoSecsPerSec;
+		ppsState->utcLabeled	=	true;
+	}
+	pthread_mutex_unlock(&ppsState->mutex);
+}
+
+//**************************************************************************************
+//*	returns false if there is no recent labeled edge
+//**************************************************************************************
+bool	PPS_GetUTC(TYPE_PPS_STATE *ppsState, const int64_t sys_ns, int64_t *utc_ns)
+{
+bool		validTime;
+int64_t		sinceEdge_ns;
+
+	validTime	=	false;
+	pthread_mutex_lock(&ppsState->mutex);
+	sinceEdge_ns	=	sys_ns - ppsState->edgeSys_ns;
+	if (ppsState->edgeValid && ppsState->utcLabeled &&
+		(llabs(sinceEdge_ns) < (kPPS_HoldoverSecs * kNanoSecsPerSec)))
+	{
+		*utc_ns		=	ppsState->edgeUTC_ns + llround(sinceEdge_ns * ppsState->rate);
+		validTime	=	true;
+	}
+	pthread_mutex_unlock(&ppsState->mutex);
+	return(validTime);
+}
+
+//**************************************************************************************
+//*	converts a gettimeofday() time to PPS time,
+//*	returns false and leaves it alone if there is no PPS time
+//**************************************************************************************
+bool	PPS_CorrectTimeval(TYPE_PPS_STATE *ppsState, struct timeval *theTime)
+{
+bool		validTime;
+int64_t		utc_ns;
+
+	validTime	=	PPS_GetUTC(ppsState, (theTime->tv_sec * kNanoSecsPerSec) + (theTime->tv_usec * 1000LL), &utc_ns);
+	if (validTime)
+	{
+		theTime->tv_sec		=	utc_ns / kNanoSecsPerSec;
+		theTime->tv_usec	=	(utc_ns % kNanoSecsPerSec) / 1000;
+	}
+	return(validTime);
+}
+
+//**************************************************************************************
+//*	standard deviation of the edge spacing
+//**************************************************************************************
+double	PPS_GetJitter_ns(TYPE_PPS_STATE *ppsState)
+{
+double	jitter_ns;
+
+	jitter_ns	=	0.0;
+	pthread_mutex_lock(&ppsState->mutex);
+	if (ppsState->jitterCount > 1)
+	{
+		jitter_ns	=	sqrt(ppsState->jitterM2 / (ppsState->jitterCount - 1));
+	}
+	pthread_mutex_unlock(&ppsState->mutex);
+	return(jitter_ns);
+}
+
+#if defined(__linux__)
+//**************************************************************************************
+static void	*PPS_Thread(void *arg)
+{
+TYPE_PPS_STATE		*ppsState;
+struct pps_fdata	fetchData;
+unsigned int		lastSequence;
+int					returnCode;
+
+	ppsState		=	(TYPE_PPS_STATE *)arg;
+	lastSequence	=	0;
+	while (1)
+	{
+		memset(&fetchData, 0, sizeof(struct pps_fdata));
+		fetchData.timeout.sec	=	3;
+		//*	blocks until the next edge
+		returnCode	=	ioctl(ppsState->ppsFileDesc, PPS_FETCH, &fetchData);
+		if (returnCode == 0)
+		{
+			if (fetchData.info.assert_sequence != lastSequence)
+			{
+				lastSequence	=	fetchData.info.assert_sequence;
+				PPS_AddEdge(ppsState,	(fetchData.info.assert_tu.sec * kNanoSecsPerSec) +
+										fetchData.info.assert_tu.nsec);
+			}
+		}
+		else if (errno != ETIMEDOUT)
+		{
+			CONSOLE_DEBUG_W_STR("PPS_FETCH failed\t=", strerror(errno));
+			sleep(1);
+		}
+	}
+	return(NULL);
+}
+#endif // __linux__
+
+//**************************************************************************************
+bool	PPS_StartThread(TYPE_PPS_STATE *ppsState, const char *ppsDevicePath)
+{
+bool				threadStarted;
+#if defined(__linux__)
+int					threadErr;
+struct pps_kparams	ppsParams;
+int					ppsModes;
+
+	threadStarted			=	false;
+	ppsState->ppsFileDesc	=	open(ppsDevicePath, O_RDWR);
+	if (ppsState->ppsFileDesc < 0)
+	{
+		//*	setting the params needs write access, fetching does not
+		ppsState->ppsFileDesc	=	open(ppsDevicePath, O_RDONLY);
+	}
+	if (ppsState->ppsFileDesc >= 0)
+	{
+		if (ioctl(ppsState->ppsFileDesc, PPS_GETCAP, &ppsModes) == 0)
+		{
+			if ((ppsModes & PPS_CAPTUREASSERT) &&
+				(ioctl(ppsState->ppsFileDesc, PPS_GETPARAMS, &ppsParams) == 0))
+			{
+				ppsParams.mode	|=	PPS_CAPTUREASSERT;
+				ioctl(ppsState->ppsFileDesc, PPS_SETPARAMS, &ppsParams);
+			}
+			threadErr	=	pthread_create(&ppsState->threadID, NULL, &PPS_Thread, ppsState);
+			if (threadErr == 0)
+			{
+				threadStarted	=	true;
+			}
+			else
+			{
+				CONSOLE_DEBUG_W_NUM("pthread_create() returned error#", threadErr);
+			}
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_STR("Not a PPS device", ppsDevicePath);
+		}
+		if (threadStarted == false)
+		{
+			close(ppsState->ppsFileDesc);
+			ppsState->ppsFileDesc	=	-1;
+		}
+	}
+	else
+	{
+		CONSOLE_DEBUG_W_STR("Failed to open", ppsDevicePath);
+	}
+#else
+	threadStarted	=	false;
+#endif // __linux__
+	return(threadStarted);
+}
+
+
+#ifdef _INCLUDE_PPS_REPLAY_MAIN_
+//**************************************************************************************
+//*	Replays a recorded NMEA file:
+//*		1)	how many sentences per second ParseNMEAstring() can do
+//*		2)	the same file played back in simulated time against a drifting system clock
+//*			with PPS edges, comparing exposure time stamps from the PPS against
+//*			time stamps from when the NMEA sentence arrived.
+//*	The first sentence type in the file is taken as the start of each second.
+//*
+//*	g++ -O2 -D_INCLUDE_PPS_REPLAY_MAIN_ -x c++ GPS_PPS.c ParseNMEA.c NMEA_helper.c -I../../src -lpthread -o ppsreplay
+//*	./ppsreplay recorded.nmea
+//**************************************************************************************
+#include	"ParseNMEA.h"
+
+#define	kMaxReplayLines		100000
+#define	kReplayBenchPasses	20
+#define	kClockDrift			25.0e-6			//*	system clock runs fast by this much
+#define	kClockOffset_ns		347000000LL		//*	and is this far ahead
+#define	kEdgeJitter_ns		2000			//*	interrupt latency of the PPS time stamp
+#define	kNMEAlatency_ns		80000000LL		//*	the GPS starts sending this long after the edge
+#define	kSerialCharTime_ns	1041667LL		//*	9600 baud
+#define	kSchedJitter_ns		5000000			//*	when the reader thread gets to run
+#define	kExposuresPerSec	3
+
+static char	gReplayLines[kMaxReplayLines][128];
+
+//**************************************************************************************
+typedef struct
+{
+	long	count;
+	double	mean;
+	double	m2;
+	double	max;
+}	TYPE_ErrStats;
+
+//**************************************************************************************
+static void	AddErr(TYPE_ErrStats *stats, double err_ns)
+{
+double	delta;
+
+	stats->count++;
+	delta		=	err_ns - stats->mean;
+	stats->mean	+=	delta / stats->count;
+	stats->m2	+=	delta * (err_ns - stats->mean);
+	if (fabs(err_ns) > stats->max)
+	{
+		stats->max	=	fabs(err_ns);
+	}
+}
+
+//**************************************************************************************
+static void	PrintErr(const char *label, TYPE_ErrStats *stats)
+{
+	printf("%-22s mean=%10.1f us  jitter(std)=%9.1f us  max=%10.1f us\r\n",
+			label,
+			stats->mean / 1000.0,
+			sqrt(stats->m2 / (stats->count - 1)) / 1000.0,
+			stats->max / 1000.0);
+}
+
+//**************************************************************************************
+static int64_t	RandomNs(const int64_t range_ns)
+{
+	return((int64_t)((rand() / (double)RAND_MAX) * range_ns));
+}
+
+//**************************************************************************************
+//*	the simulated system clock
+static int64_t	TrueToSys(const int64_t true_ns, const int64_t start_ns)
+{
+	return(true_ns + kClockOffset_ns + (int64_t)((true_ns - start_ns) * kClockDrift));
+}
+
+//**************************************************************************************
+int main(int argc, char *argv[])
+{
+FILE					*filePtr;
+int						lineCnt;
+int						iii;
+int						pass;
+int						validCnt;
+struct timespec			startTime;
+struct timespec			endTime;
+double					elapsed;
+static TYPE_NMEAInfoStruct	nmeaData;
+TYPE_PPS_STATE			ppsState;
+TYPE_ErrStats			ppsErr;
+TYPE_ErrStats			nmeaErr;
+struct tm				startTM;
+int64_t					start_ns;
+int64_t					secondTrue_ns;
+int64_t					arrivalSys_ns;
+int64_t					firstArrivalSys_ns;
+int64_t					exposureTrue_ns;
+int64_t					exposureSys_ns;
+int64_t					ppsUTC_ns;
+int64_t					nmeaUTC_ns;
+long					lastGpsTime;
+int						exp;
+int						secondCnt;
+
+	if (argc < 2)
+	{
+		printf("usage: %s recorded.nmea\r\n", argv[0]);
+		return(1);
+	}
+	filePtr	=	fopen(argv[1], "r");
+	if (filePtr == NULL)
+	{
+		printf("Failed to open %s\r\n", argv[1]);
+		return(1);
+	}
+	lineCnt	=	0;
+	while ((lineCnt < kMaxReplayLines) && (fgets(gReplayLines[lineCnt], sizeof(gReplayLines[0]), filePtr) != NULL))
+	{
+		gReplayLines[lineCnt][strcspn(gReplayLines[lineCnt], "\r\n")]	=	0;
+		if (gReplayLines[lineCnt][0] == '$')
+		{
+			lineCnt++;
+		}
+	}
+	fclose(filePtr);
+	if (lineCnt == 0)
+	{
+		printf("No NMEA data in %s\r\n", argv[1]);
+		return(1);
+	}
+
+	//*	1) parsing speed
+	ParseNMEA_init(&nmeaData);
+	validCnt	=	0;
+	clock_gettime(CLOCK_MONOTONIC, &startTime);
+	for (pass=0; pass<kReplayBenchPasses; pass++)
+	{
+		for (iii=0; iii<lineCnt; iii++)
+		{
+			validCnt	+=	ParseNMEAstring(&nmeaData, gReplayLines[iii]);
+		}
+	}
+	clock_gettime(CLOCK_MONOTONIC, &endTime);
+	elapsed	=	(endTime.tv_sec - startTime.tv_sec) + ((endTime.tv_nsec - startTime.tv_nsec) / 1.0e9);
+	printf("Sentences            = %d x %d passes (%d valid)\r\n", lineCnt, kReplayBenchPasses, validCnt);
+	printf("Parse rate           = %.0f sentences/sec\r\n", (lineCnt * kReplayBenchPasses) / elapsed);
+
+	//*	2) time stamps, the recording is played back as Oct 18, 2026
+	//*	starting at the first GPS time in the file
+	ParseNMEA_init(&nmeaData);
+	for (iii=0; (iii<lineCnt) && (nmeaData.validTime == false); iii++)
+	{
+		ParseNMEAstring(&nmeaData, gReplayLines[iii]);
+	}
+	memset(&startTM,	0,	sizeof(struct tm));
+	startTM.tm_year		=	2026 - 1900;
+	startTM.tm_mon		=	9;
+	startTM.tm_mday		=	18;
+	start_ns			=	(timegm(&startTM) + nmeaData.gpsTime) * kNanoSecsPerSec;
+
+	ParseNMEA_init(&nmeaData);
+	PPS_Init(&ppsState);
+	memset(&ppsErr,		0,	sizeof(TYPE_ErrStats));
+	memset(&nmeaErr,	0,	sizeof(TYPE_ErrStats));
+	secondTrue_ns		=	start_ns - kNanoSecsPerSec;
+	arrivalSys_ns		=	0;
+	firstArrivalSys_ns	=	0;
+	lastGpsTime			=	-1;
+	secondCnt			=	0;
+	srand(1);
+	for (iii=0; iii<lineCnt; iii++)
+	{
+		if ((iii == 0) || (strncmp(gReplayLines[iii], gReplayLines[0], 6) == 0))
+		{
+			//*	exposures during the second that just finished, both ways
+			if (firstArrivalSys_ns > 0)
+			{
+				for (exp=0; exp<kExposuresPerSec; exp++)
+				{
+					exposureTrue_ns	=	secondTrue_ns + kNMEAlatency_ns + kSchedJitter_ns +
+										RandomNs(kNanoSecsPerSec - kNMEAlatency_ns - kSchedJitter_ns);
+					exposureSys_ns	=	TrueToSys(exposureTrue_ns, start_ns);
+					if (PPS_GetUTC(&ppsState, exposureSys_ns, &ppsUTC_ns))
+					{
+						AddErr(&ppsErr, (double)(ppsUTC_ns - exposureTrue_ns));
+					}
+					//*	without PPS, the second starts when its first NMEA sentence arrived
+					nmeaUTC_ns	=	secondTrue_ns + (exposureSys_ns - firstArrivalSys_ns);
+					AddErr(&nmeaErr, (double)(nmeaUTC_ns - exposureTrue_ns));
+				}
+			}
+			//*	next second, the PPS edge comes first
+			secondTrue_ns	+=	kNanoSecsPerSec;
+			secondCnt++;
+			PPS_AddEdge(&ppsState, TrueToSys(secondTrue_ns, start_ns) + RandomNs(kEdgeJitter_ns));
+			arrivalSys_ns		=	TrueToSys(secondTrue_ns + kNMEAlatency_ns, start_ns);
+			firstArrivalSys_ns	=	0;
+		}
+		arrivalSys_ns	+=	strlen(gReplayLines[iii]) * kSerialCharTime_ns;
+		if (ParseNMEAstring(&nmeaData, gReplayLines[iii]) && nmeaData.validTime &&
+			((long)nmeaData.gpsTime != lastGpsTime))
+		{
+			lastGpsTime			=	nmeaData.gpsTime;
+			firstArrivalSys_ns	=	arrivalSys_ns + RandomNs(kSchedJitter_ns);
+			PPS_LabelSecond(&ppsState, firstArrivalSys_ns, lastGpsTime);
+		}
+	}
+	printf("Seconds replayed     = %d, PPS edges = %u, relabels = %u\r\n", secondCnt, ppsState.edgeCount, ppsState.relabelCount);
+	printf("Clock                = %.1f ppm fast, PPS rate estimate %.1f ppm\r\n", kClockDrift * 1.0e6, (1.0 / ppsState.rate - 1.0) * 1.0e6);
+	printf("PPS edge jitter      = %.2f us (max %.2f us)\r\n", PPS_GetJitter_ns(&ppsState) / 1000.0, ppsState.jitterMax_ns / 1000.0);
+	PrintErr("Exposure time, PPS",	&ppsErr);
+	PrintErr("Exposure time, NMEA",	&nmeaErr);
+	return(((ppsErr.count > 0) && (ppsErr.max < 1.0e6)) ? 0 : 1);
+}
+#endif // _INCLUDE_PPS_REPLAY_MAIN_
@@ -0,0 +1,78 @@
+//**************************************************************************************
+//*	GPS PPS (pulse per second) time keeping
+//**************************************************************************************
+//*	Edit History
+//**************************************************************************************
+//*	Oct 18,	2026	<MLS> Created GPS_PPS.h
+//**************************************************************************************
+//#include	"GPS_PPS.h"
+
+#ifndef _GPS_PPS_H_
+#define	_GPS_PPS_H_
+
+#include	<stdint.h>
+#include	<pthread.h>
+#include	<sys/time.h>
+
+#ifndef __cplusplus
+	#include	<stdbool.h>
+#endif
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//*	the kernel PPS device, a PPS line on a GPIO pin shows up here as well
+//*	with the pps-gpio driver (i.e. dtoverlay=pps-gpio,gpiopin=18 on a Raspberry Pi)
+#define	kPPS_DefaultDevice		"/dev/pps0"
+
+#define	kPPS_HoldoverSecs		10			//*	how long the time is good without an edge
+#define	kPPS_MaxRateError		500.0e-6	//*	edges further off than this are ignored
+#define	kPPS_RateFilter			8			//*	rate is filtered over this many edges
+
+//**************************************************************************************
+//*	The system clock time of the last PPS edge plus the UTC second it marks.
+//*	The UTC second comes from the NMEA time that follows the edge.
+//*	Any system clock time close to the edge can then be turned into UTC
+//*	to the accuracy of the PPS time stamp, not the serial port timing.
+//**************************************************************************************
+typedef struct	//	TYPE_PPS_STATE
+{
+	pthread_mutex_t	mutex;
+	int				ppsFileDesc;
+	pthread_t		threadID;
+
+	bool			edgeValid;
+	int64_t			edgeSys_ns;			//*	system clock (CLOCK_REALTIME) at the last edge
+	int64_t			edgeUTC_ns;			//*	UTC of the last edge, whole seconds
+	bool			utcLabeled;			//*	edgeUTC_ns is valid
+	double			rate;				//*	UTC seconds per system clock second
+
+	uint32_t		edgeCount;
+	uint32_t		missedEdges;
+	uint32_t		glitchCount;		//*	edges that were not on a second
+	uint32_t		relabelCount;		//*	NMEA time did not agree with the edge count
+
+	//*	edge to edge jitter against the rate, running mean/variance
+	uint32_t		jitterCount;
+	double			jitterMean_ns;
+	double			jitterM2;
+	double			jitterMax_ns;
+} TYPE_PPS_STATE;
+
+
+void	PPS_Init(				TYPE_PPS_STATE *ppsState);
+bool	PPS_StartThread(		TYPE_PPS_STATE *ppsState, const char *ppsDevicePath);
+void	PPS_AddEdge(			TYPE_PPS_STATE *ppsState, const int64_t edgeSys_ns);
+void	PPS_LabelSecond(		TYPE_PPS_STATE *ppsState, const int64_t sentenceSys_ns, const long utcSecsOfDay);
+bool	PPS_GetUTC(				TYPE_PPS_STATE *ppsState, const int64_t sys_ns, int64_t *utc_ns);
+bool	PPS_CorrectTimeval(		TYPE_PPS_STATE *ppsState, struct timeval *theTime);
+double	PPS_GetJitter_ns(		TYPE_PPS_STATE *ppsState);
+int64_t	PPS_GetSystemTime_ns(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _GPS_PPS_H_
@@ -70,6 +70,10 @@
 //*	May 31,	2024	<MLS> Emlid Reach uses "$GNxxx" instead of "$GPxxx"
 //*	May 31,	2024	<MLS> Added FormatGoogleMapsRequest()
 //*	Jul 21,	2024	<MLS> Added parsing for GNGSA
+//*	Oct 18,	2026	<MLS> Replaced SeparateNMEAline() with TokenizeNMEAline()
+//*	Oct 18,	2026	<MLS> The args now point into one line buffer, no more copying/clearing 1k per sentence
+//*	Oct 18,	2026	<MLS> Checksum is checked in the same pass as the tokenizing
+//*	Oct 18,	2026	<MLS> ParseNMEA_TimeString() checks for RMC before doing the checksum
 //**************************************************************************************
 
 #include	<stdio.h>
@@ -110,7 +114,8 @@
 //TYPE_NMEAInfoStruct	gNMEAdata;
 
 #define	kMaxNumNmeaArgs		32
-#define	kNMEAargLen			32
+#define	kNMEAargLen			32		//*	longer args are truncated
+#define	kNMEAlineBuffLen	512
 
 #ifdef _ENABLE_NMEA_SENTANCE_TRACKING_
 	static void	NMEAtrack_Update(const unsigned long nmeaCode, const char *nmeaID, const char *fullString);
@@ -138,11 +143,21 @@ static unsigned long	gUnknownNEMAcount		=	0;
 
 //**************************************************************************************
 //*	this is done as a stucture so it can be easily passed to routines instead of being a global
+//*	argString points into the line buffer filled by TokenizeNMEAline()
 typedef	struct
 {
-	char			argString[kNMEAargLen];
+	const char		*argString;
 }	TYPE_NMEAargs;
 
+//*	TokenizeNMEAline() return codes
+enum
+{
+	kNMEAtoken_OK	=	0,
+	kNMEAtoken_NoChecksum,
+	kNMEAtoken_BadChecksum,
+	kNMEAtoken_TooLong
+};
+
 //**************************************************************************************
 void	ParseNMEA_init(TYPE_NMEAInfoStruct *nmeaData)
 {
@@ -359,39 +374,85 @@ int	GetMaxSatSignalStrength(void)
 
 
 //**************************************************************************************
-//*	returns number of args
+//*	One pass over the line, it gets split into args AND the checksum gets checked.
+//*	The args are terminated in place in lineBuff (kNMEAlineBuffLen) and point into it,
+//*	the args that are not in this sentence point to an empty string.
+//*	Nothing gets cleared or copied arg by arg.
+//*	returns kNMEAtoken_xxx
 //**************************************************************************************
-static int	SeparateNMEAline(char *theLine, TYPE_NMEAargs	*nmeaArgs)
+static int	TokenizeNMEAline(	const char		*theLine,
+								char			*lineBuff,
+								TYPE_NMEAargs	*nmeaArgs,
+								int				*argCount)
 {
 int		iii;
-int		jjj;
-int		kk;
-int		theLen;
-
-	//*	clear out all of the old values
-	for (iii=0; iii<kMaxNumNmeaArgs; iii++)
+int		argIdx;
+int		argLen;
+short	checkSum;
+short	lineCheckSum;
+char	theChar;
+int		tokenStatus;
+
+	checkSum				=	0;
+	argIdx					=	0;
+	argLen					=	0;
+	nmeaArgs[0].argString	=	lineBuff;
+	iii						=	0;
+	while (true)
 	{
-		memset(nmeaArgs[iii].argString, 0, kNMEAargLen);
+		if (iii >= (kNMEAlineBuffLen - 1))
+		{
+			*argCount	=	0;
+			return(kNMEAtoken_TooLong);
+		}
+		theChar	=	theLine[iii];
+		if ((theChar == '*') || (theChar < 0x20))
+		{
+			//*	end of the data, 0x00, CR or LF
+			lineBuff[iii]	=	0;
+			argIdx++;
+			break;
+		}
+		//*	the checksum covers everything between the "$" and the "*"
+		if (iii > 0)
+		{
+			checkSum	^=	theChar;
+		}
+		if (theChar == ',')
+		{
+			lineBuff[iii]	=	0;
+			argIdx++;
+			argLen			=	0;
+			if (argIdx < kMaxNumNmeaArgs)
+			{
+				nmeaArgs[argIdx].argString	=	&lineBuff[iii + 1];
+			}
+		}
+		else
+		{
+			argLen++;
+			lineBuff[iii]	=	(argLen < kNMEAargLen) ? theChar : 0;
+		}
+		iii++;
+	}
+	if (argIdx > kMaxNumNmeaArgs)
+	{
+		argIdx	=	kMaxNumNmeaArgs;
+	}
+	*argCount	=	argIdx;
+	while (argIdx < kMaxNumNmeaArgs)
+	{
+		nmeaArgs[argIdx++].argString	=	"";
 	}
 
-	iii	=	0;
-	jjj	=	0;
-	theLen	=	strlen(theLine);
-	while ((iii < theLen) && (jjj<kMaxNumNmeaArgs))
+	//*	some GPS's do not transmit checksums
+	tokenStatus	=	kNMEAtoken_NoChecksum;
+	if ((theChar == '*') && isxdigit(theLine[iii + 1]) && isxdigit(theLine[iii + 2]) && (theLine[iii + 3] < 0x20))
 	{
-		kk	=	0;
-		while  ((theLine[iii] != ',') &&
-				(theLine[iii] != '*') &&
-				(theLine[iii] != 0x0d) &&
-				(theLine[iii] != 0x0a) &&
-				(theLine[iii] != 0x00) && (kk < kNMEAargLen))
-		{
-			nmeaArgs[jjj].argString[kk++]	=	theLine[iii++];
-		}
-		iii++;	//	Skip delimiter
-		jjj++;	//	Next argument
+		lineCheckSum	=	Hextoi(theLine[iii + 1]) * 16 + Hextoi(theLine[iii + 2]);
+		tokenStatus		=	(lineCheckSum == (checkSum & 0x00ff)) ? kNMEAtoken_OK : kNMEAtoken_BadChecksum;
 	}
-	return(jjj);
+	return(tokenStatus);
 }
 
 //**************************************************************************************
@@ -1986,9 +2047,9 @@ bool	ParseNMEAstring(TYPE_NMEAInfoStruct *nmeaData, char *theNMEAstring)
 {
 bool			validString;
 bool			checkSumOK;
-short			nmeaChecksum;
-short			calculatedChecksum;
-int				lineLen;
+int				tokenStatus;
+int				argCount;
+char			lineBuff[kNMEAlineBuffLen];
 TYPE_NMEAargs	nmeaArgs[kMaxNumNmeaArgs];
 bool			processedOK;
 
@@ -2005,51 +2066,44 @@ bool			processedOK;
 	//*	make sure the line starts with a "$"
 	if (theNMEAstring[0] == '$')
 	{
-		//*	evaluate the checksum
-		lineLen	=	strlen(theNMEAstring);
-
-		//*	some GPS's do not transmit checksums
-		if (theNMEAstring[lineLen - 3] == '*')
+		//*	split it up and evaluate the checksum
+		tokenStatus	=	TokenizeNMEAline(theNMEAstring, lineBuff, nmeaArgs, &argCount);
+		switch(tokenStatus)
 		{
-			calculatedChecksum	=	CalculateNMEACheckSum(theNMEAstring);
-			nmeaChecksum		=	ExtractChecksumFromNMEAline(theNMEAstring);
-			if (calculatedChecksum == nmeaChecksum)
-			{
+			case kNMEAtoken_OK:
 				checkSumOK	=	true;
-			}
-			else
-			{
-				checkSumOK	=	false;
+				break;
+
+			case kNMEAtoken_BadChecksum:
 			#if defined(_ENABLE_GPS_DEBUGGING_) || defined(_SHOW_CHECKSUM_ERRORS_)
 				CONSOLE_DEBUG_W_STR("Checksum error:", theNMEAstring);
-				CONSOLE_DEBUG_W_HEX("calculatedChecksum=", calculatedChecksum);
+				CONSOLE_DEBUG_W_HEX("calculatedChecksum=", CalculateNMEACheckSum(theNMEAstring));
 			#endif
 				gNMEAcheckSumErrCnt++;
-			}
-		}
-		else
-		{
-			//*	since it did NOT have a checksum, assume its OK
-		//	checkSumOK	=	true;
+				break;
 
-			checkSumOK	=	false;
-		#if defined(_ENABLE_GPS_DEBUGGING_) || defined(_SHOW_CHECKSUM_ERRORS_)
-//			CONSOLE_DEBUG_W_STR("Checksum MISSING:", theNMEAstring);
-		#endif
+			case kNMEAtoken_TooLong:
+			#if defined(_ENABLE_GPS_DEBUGGING_) || defined(_SHOW_CHECKSUM_ERRORS_)
+				CONSOLE_DEBUG_W_NUM("NMEA line too long:", (int)strlen(theNMEAstring));
+			#endif
+				break;
+
+			default:
+				//*	since it did NOT have a checksum, assume its BAD
+			#if defined(_ENABLE_GPS_DEBUGGING_) || defined(_SHOW_CHECKSUM_ERRORS_)
+//				CONSOLE_DEBUG_W_STR("Checksum MISSING:", theNMEAstring);
+			#endif
+				break;
 		}
 
 
 		if (checkSumOK)
 		{
 			nmeaData->SequenceNumber++;
-			//*	now we have a known good NMEA string, lets tear it apart
-			SeparateNMEAline(theNMEAstring, nmeaArgs);
-		//	for (ii=0; ii<kMaxNumNmeaArgs; ii++)
+			//*	now we have a known good NMEA string, the args are already torn apart
+		//	for (ii=0; ii<argCount; ii++)
 		//	{
-		//		if (strlen(nmeaArgs[ii].argString) > 0)
-		//		{
-		//			printf("arg %2d =%s\n", ii, nmeaArgs[ii].argString);
-		//		}
+		//		printf("arg %2d =%s\n", ii, nmeaArgs[ii].argString);
 		//	}
 
 			processedOK	=	false;
@@ -2243,8 +2297,10 @@ int				slen;
 //	CONSOLE_DEBUG(__FUNCTION__);
 #endif
 	validTime	=	false;
-	//*	make sure the line starts with a "$"
-	if (theNMEAstring[0] == '$')
+	//*	make sure the line starts with a "$" and only checksum RMC sentences,
+	//*	this gets called for every sentence
+	if ((theNMEAstring[0] == '$') && (theNMEAstring[1] == 'G') && (theNMEAstring[2] != 0) &&
+		(strncmp(&theNMEAstring[3], "RMC", 3) == 0))
 	{
 		//*	evaluate the checksum
 		lineLen	=	strlen(theNMEAstring);
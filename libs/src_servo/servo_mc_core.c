@@ -38,6 +38,10 @@
 //*	May 31,	2022	<RNS> Removed the old hand coded RC messages and strings, obsolete
 //*	Jul  2,	2022	<RNS> Adding support for boolean types
 //*	Jul  3,	2022	<RNS> changed prefix on static global to gs*
+//*	Oct 18,	2026	<MLS> MC_calc_crc16() is now table driven, 4 bytes per step (slicing-by-4)
+//*	Oct 18,	2026	<MLS> MC_read_comm() waits with poll() and a deadline, fixed the partial read logic
+//*	Oct 18,	2026	<MLS> MC_write_comm() now writes the remainder after a partial write
+//*	Oct 18,	2026	<MLS> CRC tables are built with pthread_once(), the lazy init was racy
 //*****************************************************************************
 
 #include <stdio.h>
@@ -46,6 +50,9 @@
 #include <errno.h>
 #include <termios.h>
 #include <unistd.h>
+#include <poll.h>
+#include <pthread.h>
+#include <time.h>
 #include <stdint.h>
 #include <stdbool.h>
 #include <endian.h>
@@ -72,10 +79,18 @@
 
 #define kMAX_RETRY 3
 
+// Time allowed for a complete reply, RC answers within a few ms at 38.4K
+#define kMC_READ_TIMEOUT_MS	300
+
 // Internal global variables visibel for this file only
 static int gsCommPort;
 static int gsCommRetries;
 
+// CRC16 lookup tables, [n][byte] is the CRC of byte followed by n zero bytes
+// built once by pthread_once(), the mount and the alpaca threads can both be first
+static uint16_t			gsCrcTable[4][256];
+static pthread_once_t	gsCrcTableOnce	=	PTHREAD_ONCE_INIT;
+
 //*****************************************************************************
 // Resets to the top of buffer, and add MC target/cmd and updates rover
 //*****************************************************************************
@@ -176,29 +191,58 @@ int		iii;
 	return(sum);
 } //* of mc__calc_checksum
 
+//******************************************************************************
+// Builds the CRC16 (poly 0x1021, MSB first) lookup tables for slicing-by-4
+//******************************************************************************
+static void MC_init_crc_tables(void)
+{
+int			iii;
+int			bit;
+int			slice;
+uint16_t	crc;
+
+	for (iii = 0; iii < 256; iii++)
+	{
+		crc	=	(uint16_t)(iii << 8);
+		for (bit = 0; bit < 8; bit++)
+		{
+			crc	=	(crc & 0x8000) ? (uint16_t)((crc << 1) ^ 0x1021) : (uint16_t)(crc << 1);
+		}
+		gsCrcTable[0][iii]	=	crc;
+	}
+	// Each slice is the previous one advanced by one more zero byte
+	for (slice = 1; slice < 4; slice++)
+	{
+		for (iii = 0; iii < 256; iii++)
+		{
+			crc	=	gsCrcTable[slice - 1][iii];
+			gsCrcTable[slice][iii]	=	(uint16_t)((crc << 8) ^ gsCrcTable[0][crc >> 8]);
+		}
+	}
+}
+
 //******************************************************************************
 // Calc the specific flavor of CRC16 needed for a RoboClaw... and possibly others
+// Same result as the bit by bit version, 4 bytes are done per table step
 //******************************************************************************
 uint16_t MC_calc_crc16(unsigned char *packet, int numBytes, uint16_t crc)
 {
 int		byte;
-uint8_t	bit;
 
 	//	CONSOLE_DEBUG(__FUNCTION__);
-	for (byte = 0; byte < numBytes; byte++)
+	pthread_once(&gsCrcTableOnce, MC_init_crc_tables);
+	byte	=	0;
+	while ((numBytes - byte) >= 4)
 	{
-		crc	=	crc ^ ((unsigned int)packet[byte] << 8);
-		for (bit = 0; bit < 8; bit++)
-		{
-			if (crc & 0x8000)
-			{
-				crc	=	(crc << 1) ^ 0x1021;
-			}
-			else
-			{
-				crc	=	crc << 1;
-			}
-		}
+		crc	^=	(uint16_t)((packet[byte] << 8) | packet[byte + 1]);
+		crc	=	gsCrcTable[3][crc >> 8] ^ gsCrcTable[2][crc & 0xFF] ^
+				gsCrcTable[1][packet[byte + 2]] ^ gsCrcTable[0][packet[byte + 3]];
+		byte	+=	4;
+	}
+	while (byte < numBytes)
+	{
+		crc	=	(uint16_t)((crc << 8) ^ gsCrcTable[0][(crc >> 8) ^ packet[byte]]);
+		byte++;
 	}
 	//	CONSOLE_DEBUG_W_STR(__FUNCTION__, "exit");
 	return(crc);
@@ -275,64 +319,73 @@ int		status;
 } // MC_set_comm_attr()
 
 //**********************************************************************
-//  Reads data from comm port in the buffer, returns kERROR if retries exceeded
-// in[];   input data to be written
-// len;     length on input data
+//  Reads data from comm port in the buffer, returns kERROR on a port error
+//  otherwise the number of bytes read, which is short of len on a timeout
+// buf[];   buffer for the data read
+// len;     number of bytes expected
 //**********************************************************************
 int MC_read_comm(uint8_t *buf, size_t len)
 {
-uint8_t	retryBuf[kMAX_STR_LEN];
-uint8_t	*ptrA;
+struct pollfd	pollFd;
+struct timespec	now;
 ssize_t	size;
-ssize_t	total	=	0;
-int		retValue;
+size_t	total;
+long	deadline_ms;
+long	remaining_ms;
+int		pollStatus;
 
 //	CONSOLE_DEBUG(__FUNCTION__);
-	// Attempt to the read the message and set buffer ptr just-in-case
-	ptrA			=	retryBuf;
+	clock_gettime(CLOCK_MONOTONIC, &now);
+	deadline_ms		=	(now.tv_sec * 1000) + (now.tv_nsec / 1000000) + kMC_READ_TIMEOUT_MS;
+	total			=	0;
 	gsCommRetries	=	kMAX_RETRY;
 
-	// Loop to make sure the port does not return an error up to max retry
-	do
+	// Keep reading until the whole reply is in, it can arrive in several pieces
+	while (total < len)
 	{
-		size	=	read(gsCommPort, buf, len);
+		clock_gettime(CLOCK_MONOTONIC, &now);
+		remaining_ms	=	deadline_ms - ((now.tv_sec * 1000) + (now.tv_nsec / 1000000));
+		if (remaining_ms <= 0)
+		{
+			break;
+		}
+		pollFd.fd		=	gsCommPort;
+		pollFd.events	=	POLLIN;
+		pollFd.revents	=	0;
+		pollStatus		=	poll(&pollFd, 1, (int)remaining_ms);
+		if (pollStatus < 0)
+		{
+			if (errno == EINTR)
+			{
+				continue;
+			}
+			perror("Error in MC_read_comm: ");
+			return(kERROR);
+		}
+		if (pollStatus == 0)
+		{
+			break;
+		}
+		size	=	read(gsCommPort, (buf + total), (len - total));
 		if (size < 0)
 		{
 			perror("Error in MC_read_comm: ");
+			if (--gsCommRetries <= 0)
+			{
+				return(kERROR);
+			}
+		}
+		else
+		{
+			total	+=	size;
 		}
-		gsCommRetries--;
-	} while (size <= 0 && gsCommRetries > 0);
-
-	//printf("MC_read_comm: len = %d  and size = %d\n", (int)len, (int)size);
-
-	// If the read len doesn't meet the expected length and we still have retrys left
-	while ((size + total != (ssize_t)len) && (gsCommRetries > 0))
-	{
-		// Append the current read to the tempP
-		memcpy(ptrA, buf, size);
-		total += size;
-
-		ptrA	+=	size;
-		size	=	read(gsCommPort, buf, len);
-		gsCommRetries--;
 	}
 
-	// If > max retries then error
-	if (size < 0 || gsCommRetries < 0)
+	if (total != len)
 	{
-		printf("MC_read_comm: len = %d  and size = %d  retries = %d\n", (int)len, (int)size, gsCommRetries);
-		retValue	=	kERROR;
-	}
-	else
-	{
-		// If we had a retry attempt, need return the data from retryBuf
-		if (ptrA != retryBuf)
-		{
-			memcpy(buf, retryBuf, total);
-		}
-		retValue	=	((size > total) ? size : total);
+		printf("MC_read_comm: len = %d  and size = %d\n", (int)len, (int)total);
 	}
-	return(retValue);
+	return((int)total);
 } // of MC_read_comm()
 
 //**********************************************************************
@@ -343,21 +396,29 @@ int		retValue;
 int MC_write_comm(uint8_t *buf, size_t len)
 {
 	ssize_t count;
+	size_t total;
 	int returnCode;
 
 //	CONSOLE_DEBUG(__FUNCTION__);
 
 	gsCommRetries	=	kMAX_RETRY;
+	total			=	0;
 	// Write out all data ininput buf to the commport
 	tcflush(gsCommPort, TCIFLUSH);
-	count	=	write(gsCommPort, buf, len);
-	while ((count != (ssize_t)len) && (gsCommRetries > 0))
+	while ((total < len) && (gsCommRetries > 0))
 	{
-		count	=	write(gsCommPort, buf, len);
-		gsCommRetries--;
+		count	=	write(gsCommPort, (buf + total), (len - total));
+		if (count > 0)
+		{
+			total	+=	count;
+		}
+		else
+		{
+			gsCommRetries--;
+		}
 	}
 	// If > max retries then error
-	if (gsCommRetries < 0)
+	if (total != len)
 	{
 		returnCode	=	kERROR;
 	}
@@ -500,6 +561,32 @@ int			iii;
 	printf("  Byte  = %X  -> pat = %X\n", Receipt_get_byte(ptrB, &ptrA), pat8);
 	printf("  word  = %X  -> pat = %X\n", Receipt_get_word(ptrA, &ptrB), pat16);
 
+	// Check the table driven CRC against the bit by bit calculation
+	printf("\nChecking MC_calc_crc16() against bitwise CRC16\n");
+	for (iii = 0; iii < 64; iii++)
+	{
+		noteBuf[iii]	=	(uint8_t)((iii * 37) + 11);
+	}
+	for (iii = 0; iii <= 64; iii++)
+	{
+	uint16_t	refCrc	=	0;
+	int			byte, bit;
+
+		for (byte = 0; byte < iii; byte++)
+		{
+			refCrc	=	refCrc ^ ((unsigned int)noteBuf[byte] << 8);
+			for (bit = 0; bit < 8; bit++)
+			{
+				refCrc	=	(refCrc & 0x8000) ? (uint16_t)((refCrc << 1) ^ 0x1021) : (uint16_t)(refCrc << 1);
+			}
+		}
+		if (MC_calc_crc16(noteBuf, iii, kCLEAR_CRC) != refCrc)
+		{
+			printf("  CRC mismatch for len = %d\n", iii);
+		}
+	}
+	printf("  CRC check of '123456789' = %X -> 31C3\n", MC_calc_crc16((unsigned char *)"123456789", 9, kCLEAR_CRC));
+
 	iii	=	MC_init_comm("/dev/ttyACM0", 38400);
 	printf("MC_init_comm return status = %d\n", iii);
 
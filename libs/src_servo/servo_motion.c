@@ -38,6 +38,8 @@
 //*	Nov  9,	2022	<RNS> Added a routine to check all moves for buffer write timing
 //*	Nov 12,	2022	<RNS> Corrected unitialized status in _wait_axis_buffer_clear
 //*	Nov 12,	2022	<RNS> Added Motion_write_settings() to config RC HW EEPROM
+//*	Oct 18,	2026	<MLS> Added Motion_batch_begin() / Motion_batch_end() for multi-axis moves
+//*	Oct 18,	2026	<MLS> Added Motion_move_axis_by_profile() for planned slews
 //*****************************************************************************
 
 #include <stdio.h>
@@ -63,6 +65,10 @@
 
 TYPE_MOTION_CONFIG gMotionConfig;
 
+// While batching, the unbuffered move workaround wait is deferred per axis
+static bool gsBatchActive	=	false;
+static bool gsWaitPending[2]	=	{false, false};
+
 //*************************************************************************
 // Return the address of the motor struct from the specified axis RA or Dec
 // from the local global gMotionConfig
@@ -393,6 +399,27 @@ TYPE_MOTION_MOTOR	*motor;
 	return RC_calc_move_time(start, end, motor->vel, motor->acc);
 }
 
+//*************************************************************************
+// Waits for the selected axis buffers to be empty, one queue read covers both
+//*************************************************************************
+static int Motion_wait_buffers_clear(bool raAxis, bool decAxis)
+{
+uint8_t 			raState, decState;
+int 				status = kSTATUS_OK;
+
+	// Wait to see the unbuffered cmd (which clears buffer) is executing (0x0) or executed (0x80)
+	// Roboclaw only supports up to a 127 deep buffer, so use lower 7bit mask of 0x7F
+	do
+	{
+		// printf("(Motion_wait_axis_buffer_clear): SLEEPING....\n");
+		// wait for 1/100th of second then read both motor buffers
+		usleep(10000);
+		status = Motion_get_pending_cmds(&raState, &decState);
+	} while ((raAxis && ((raState & 0x7F) != 0)) || (decAxis && ((decState & 0x7F) != 0)));
+
+	return status;
+}
+
 //*************************************************************************
 // Check for axis buffer to be cleared when using unbuffered commands
 // This is a workaround for Roboclaw weirdness where it sometimes hangs
@@ -402,7 +429,6 @@ TYPE_MOTION_MOTOR	*motor;
 int Motion_wait_axis_buffer_clear(uint8_t axis)
 {
 TYPE_MOTION_MOTOR 	*motor;
-uint8_t 			raState, decState, motorState;
 int 				status = kSTATUS_OK;
 
 	motor = Motion_get_motor_ptr(axis);
@@ -414,22 +440,67 @@ int 				status = kSTATUS_OK;
 	// WORKAROUND! To RC Weirdness with adding unbuffered commands
 	if (motor->buffered == false)
 	{
-		// Wait to see the unbuffered cmd (which clears buffer) is executing (0x0) or executed (0x80)
-		// Roboclaw only supports up to a 127 deep buffer, so use lower 7bit mask of 0x7F
-		do
+		if (gsBatchActive)
 		{
-			// printf("(Motion_wait_axis_buffer_clear): SLEEPING....\n");
-			// wait for 1/100th of second then read both motor buffers
-			usleep(10000);
-			status = Motion_get_pending_cmds(&raState, &decState);
-			// if the input axis is RA return the RA buffer length, otherwise use Dec
-			motorState = (axis == SERVO_RA_AXIS) ? raState : decState;
-		} while ((motorState & 0x7F) != 0);
+			// Wait before the next cmd on this axis or at the end of the batch
+			gsWaitPending[axis] = true;
+		}
+		else
+		{
+			status = Motion_wait_buffers_clear((axis == SERVO_RA_AXIS), (axis == SERVO_DEC_AXIS));
+		}
 	} // of if unbuffered
 
 	return (status == kSTATUS_OK) ? kSTATUS_OK : kERROR;
 }
 
+//*************************************************************************
+// Does a deferred buffer clear wait before a new cmd goes to the axis
+//*************************************************************************
+static int Motion_check_axis_wait(uint8_t axis)
+{
+int status = kSTATUS_OK;
+
+	if ((axis <= SERVO_DEC_AXIS) && gsWaitPending[axis])
+	{
+		gsWaitPending[axis] = false;
+		status = Motion_wait_buffers_clear((axis == SERVO_RA_AXIS), (axis == SERVO_DEC_AXIS));
+	}
+	return status;
+}
+
+//*************************************************************************
+// Starts collecting the axis commands so the commands for both axes go out
+// in one transfer. The unbuffered move waits for both axes are done together
+// in Motion_batch_end(), which must be called to send the commands
+//*************************************************************************
+void Motion_batch_begin(void)
+{
+	gsBatchActive		=	true;
+	gsWaitPending[0]	=	false;
+	gsWaitPending[1]	=	false;
+	RC_batch_begin();
+}
+
+//*************************************************************************
+// Sends the collected commands and does any pending buffer clear waits
+// Returns kSTATUS_OK if all the commands were accepted, kERROR otherwise
+//*************************************************************************
+int Motion_batch_end(void)
+{
+int status;
+
+	status			=	RC_batch_end();
+	gsBatchActive	=	false;
+	if (gsWaitPending[SERVO_RA_AXIS] || gsWaitPending[SERVO_DEC_AXIS])
+	{
+		status	-=	Motion_wait_buffers_clear(gsWaitPending[SERVO_RA_AXIS], gsWaitPending[SERVO_DEC_AXIS]);
+	}
+	gsWaitPending[0]	=	false;
+	gsWaitPending[1]	=	false;
+	return (status == kSTATUS_OK) ? kSTATUS_OK : kERROR;
+}
+
 //*************************************************************************
 // Moves the specified axis by a signed number of steps, can be buffered
 // or unbuffered command depending the latest axis_dis/enable_buffer() call
@@ -445,6 +516,7 @@ int 				status;
 		return kERROR;
 	}
 	// Update the motor state and send move cmd
+	Motion_check_axis_wait(axis);
 	motor->state = MOVING_BY_POS;
 	printf("!!! Motion_move_axis_by_step() motor-addr:%d axis:%d step:%d, motor->vel:%d motor->acc:%d motor->buffered:%d\n", motor->addr, axis, step, motor->vel, motor->acc, motor->buffered);
 	RC_move_by_posva(motor->addr, axis, step, motor->vel, motor->acc, motor->buffered);
@@ -453,6 +525,30 @@ int 				status;
 	return (status == kSTATUS_OK) ? kSTATUS_OK : kERROR;
 }
 
+//*************************************************************************
+// Move the specified axis to step using the velocity and acceleration from
+// a planned slew instead of the axis defaults, can be buffered or unbuffered
+// command depending the latest axis_dis/enable_buffer() call
+//*************************************************************************
+int Motion_move_axis_by_profile(uint8_t axis, int32_t step, int32_t vel, int32_t acc)
+{
+TYPE_MOTION_MOTOR	*motor;
+int					status;
+
+	motor	=	Motion_get_motor_ptr(axis);
+	if (motor == NULL)
+	{
+		return kERROR;
+	}
+	// Update the motor state and send move cmd
+	Motion_check_axis_wait(axis);
+	motor->state	=	MOVING_BY_POS;
+	RC_move_by_posvad(motor->addr, axis, step, vel, acc, acc, motor->buffered);
+	status = Motion_wait_axis_buffer_clear(axis);
+
+	return (status == kSTATUS_OK) ? kSTATUS_OK : kERROR;
+}
+
 //*************************************************************************
 // Start the specified axis moving at a constant velocity after the acceleration
 // ramp and can be buffered or unbuffered command depending the latest
@@ -469,6 +565,7 @@ int					status;
 		return kERROR;
 	}
 	// Update the motor state and send move cmd
+	Motion_check_axis_wait(axis);
 	motor->state	=	MOVING_BY_VEL;
 	RC_move_by_vela(motor->addr, axis, vel, motor->acc, motor->buffered);
 	status = Motion_wait_axis_buffer_clear(axis);
@@ -496,6 +593,7 @@ int					status;
 		return kERROR;
 	}
 	// Update the motor state and send move cmd
+	Motion_check_axis_wait(axis);
 	motor->state	=	MOVING_BY_TIME;
 	Motion_get_axis_trackRate(axis, &startVel);
 	// printf("StartVel = %d\n", startVel);
@@ -28,6 +28,8 @@
 //*	Nov  1,	2022	<RNS> Updated via cproto
 //*	Nov  9,	2022	<RNS> Updated via cproto
 //*	Nov 12,	2022	<RNS> Updated via cproto
+//*	Oct 18,	2026	<MLS> Added Motion_batch_begin() / Motion_batch_end()
+//*	Oct 18,	2026	<MLS> Added Motion_move_axis_by_profile()
 //****************************************************************************
 //#include	"servo_motion.h"
 
@@ -67,7 +69,10 @@ int Motion_set_axis_profile(uint8_t axis);
 int Motion_write_settings(void);
 double Motion_calc_axis_move_time(uint8_t axis, int32_t start, int32_t end);
 int Motion_wait_axis_buffer_clear(uint8_t axis);
+void Motion_batch_begin(void);
+int Motion_batch_end(void);
 int Motion_move_axis_by_step(uint8_t axis, int32_t step);
+int Motion_move_axis_by_profile(uint8_t axis, int32_t step, int32_t vel, int32_t acc);
 int Motion_move_axis_by_vel(uint8_t axis, int32_t vel);
 int Motion_move_axis_by_time(uint8_t axis, int32_t vel, double seconds);
 int Motion_stop_axis(uint8_t axis);
@@ -99,6 +99,8 @@
 //*	Nov 13,	2022	<RNS> Modified _optimal_path to check for RA wrap on FORK mounts
 //*	Nov 15,	2022	<RNS> Rewrote _calc_optimal_path to separate path calc from mount type
 //*	Nov 16,	2022	<RNS> Added Servo_check_german_for_upside_down() + COP check for it;
+//*	Oct 18,	2026	<MLS> Multi-axis moves and tracking starts now use Motion_batch_begin/end()
+//*	Oct 18,	2026	<MLS> Slews with tracking are now planned ahead with Planner_plan_slew()
 //*****************************************************************************
 
 //*****************************************************************************
@@ -124,6 +126,7 @@
 #include "servo_motion_cfg.h"
 #include "servo_mount_cfg.h"
 #include "servo_motion.h"
+#include "servo_planner.h"
 #include "servo_mount.h"
 
 #ifdef _ALPHA_OUT_
@@ -143,6 +146,7 @@ static bool			gParkState		=	true;
 static TYPE_MOVE	gMountAction;
 static char			gDebugInfoSS[]	=	"00";
 static char			gDebugInfoCOP[]	=	"UNDEF";
+static TYPE_SERVO_PLAN	gSlewPlan;
 
 //*****************************************************************************
 // Return values for the COP move type
@@ -547,6 +551,8 @@ int		status;
 		Servo_get_pos(&ra, &dec);
 		Servo_set_pos(ra, dec);
 
+		// Both axes commands go out in one transfer
+		Motion_batch_begin();
 		switch (motor)
 		{
 			case SERVO_BOTH_AXES:
@@ -589,6 +595,10 @@ int		status;
 				status	=	kERROR;
 				break;
 		} // of switch
+		if (Motion_batch_end() != kSTATUS_OK)
+		{
+			status	=	kERROR;
+		}
 	}
 	else
 	{
@@ -1002,86 +1012,66 @@ int			status;
 // or the higher level function Servo_state() looking for STOPPED or TRACKING
 // If the track parameter (velocity coefficient) is non-zero for either axis
 // the routine will start tracking on that axis(axes).
-// TODO: May need to pull the calc_move_time() out of this routine for alt-azi
+// The slew is planned ahead with Planner_plan_slew() and kept in gSlewPlan,
+// the shorter axis is slowed down so both axes arrive together
 // TODO: need to check the logic of using tracking&sign to set alt-azi move time
 //*****************************************************************************
 static int Servo_move_step_track(int32_t raStep, int32_t decStep)
 {
-double	duration;
-int32_t	trackingRate;
-int32_t	currStep;
-uint8_t raState, decState;
-int		status	=	kSTATUS_OK;
-
-	// If RA axis has a tracking value
-	trackingRate	=	Servo_get_axis_trackRate(SERVO_RA_AXIS);
-	if (trackingRate != 0)
+TYPE_PLAN_LIMITS	limits[kPLAN_AXES];
+int32_t				startStep[kPLAN_AXES];
+int32_t				targetStep[kPLAN_AXES];
+double				startVel[kPLAN_AXES];
+int32_t				currVel;
+uint8_t				axis;
+int					status	=	kSTATUS_OK;
+
+	targetStep[SERVO_RA_AXIS]	=	raStep;
+	targetStep[SERVO_DEC_AXIS]	=	decStep;
+	limits[SERVO_RA_AXIS].vel	=	gMountConfig.ra.vel;
+	limits[SERVO_RA_AXIS].acc	=	gMountConfig.ra.acc;
+	limits[SERVO_DEC_AXIS].vel	=	gMountConfig.dec.vel;
+	limits[SERVO_DEC_AXIS].acc	=	gMountConfig.dec.acc;
+
+	// figure out where we are now and how fast we are going
+	for (axis = SERVO_RA_AXIS; axis <= SERVO_DEC_AXIS; axis++)
 	{
-		// figure out where we are now
-		status	-=	Motion_get_axis_curr_step(SERVO_RA_AXIS, &currStep);
-		// calculate the duration of the axis move and convert to step and add to target
-		duration	=	Motion_calc_axis_move_time(SERVO_RA_AXIS, currStep, raStep);
-		// additional steps are add/subract based on the sign of the axis tracking rate
-		raStep		+=	(uint32_t)(duration * (double)trackingRate);
-
-		// make the first slew to time corrected target and buffer a vel cmd for tracking
-		// this first command has to empty any remaining buffered cmds (false)
-
-		Motion_get_pending_cmds(&raState, &decState);
-		printf("S_mst: Before RA M_mabs Qra:%d Qdec:%d\n", raState, decState);
-
-		Motion_set_axis_buffer(SERVO_RA_AXIS, false);
-		status	-=	Motion_move_axis_by_step(SERVO_RA_AXIS, raStep);
-
-		Motion_get_pending_cmds(&raState, &decState);
-		printf("S_mst: After RA M_mabs Qra:%d Qdec%d\n", raState, decState);
-		printf("!!! raStep = %d  vel = %d  acc = %d\n", raStep, gMountConfig.ra.vel, gMountConfig.ra.acc);
-
-		// This velocity command will start when the above pos cmd completes
-		// Buffered move by tracking velocity
-
-		Motion_get_pending_cmds(&raState, &decState);
-		printf("S_mst: Before RA M_mabv Qra:%d Qdec:%d\n", raState, decState);
-
-		Motion_set_axis_buffer(SERVO_RA_AXIS, true);
-		status	-=	Motion_move_axis_by_vel(SERVO_RA_AXIS, trackingRate);
-
-		Motion_get_pending_cmds(&raState, &decState);
-		printf("S_mst:  After RA M_mabv Qra:%d Qdec:%d\n", raState, decState);
+		status					-=	Motion_get_axis_curr_step(axis, &startStep[axis]);
+		status					-=	Motion_get_axis_curr_vel(axis, &currVel);
+		startVel[axis]			=	(double)currVel;
+		limits[axis].trackRate	=	(double)Servo_get_axis_trackRate(axis);
 	}
-	else
+
+	// Plan the whole slew up front, the end points are corrected for the
+	// target moving at the tracking rate while the mount slews
+	if (Planner_plan_slew(&gSlewPlan, startStep, startVel, targetStep, limits) != kSTATUS_OK)
 	{
-		Motion_set_axis_buffer(SERVO_RA_AXIS, false);
-		status	-=	Motion_move_axis_by_step(SERVO_RA_AXIS, raStep);
+		return kERROR;
 	}
-
-	// If Dec axis has a tracking value
-	trackingRate	=	Servo_get_axis_trackRate(SERVO_DEC_AXIS);
-	if (trackingRate != 0)
+	gSlewPlan.startTime	=	Time_get_systime();
+	printf("S_mst: plan RA step:%d vel:%d  Dec step:%d vel:%d  slew:%.2f sec  iter:%d\n",
+			gSlewPlan.axis[SERVO_RA_AXIS].slewStep, gSlewPlan.axis[SERVO_RA_AXIS].slewVel,
+			gSlewPlan.axis[SERVO_DEC_AXIS].slewStep, gSlewPlan.axis[SERVO_DEC_AXIS].slewVel,
+			gSlewPlan.duration, gSlewPlan.iterations);
+
+	// Stream the plan, collect the commands for both axes in one batch
+	Motion_batch_begin();
+	for (axis = SERVO_RA_AXIS; axis <= SERVO_DEC_AXIS; axis++)
 	{
-		// figure out where we are now
-		status		-=	Motion_get_axis_curr_step(SERVO_DEC_AXIS, &currStep);
-		// calculate the duration of the axis move and convert to step and add to target
-		duration	=	Motion_calc_axis_move_time(SERVO_DEC_AXIS, currStep, decStep);
-		// additional steps are add/subract based on the sign of the axis tracking rate
-		decStep		+=	(uint32_t)(duration * (double)trackingRate);
-
-		// make the first slew to time corrected target and buffer a vel cmd for tracking
-		// this first command has to empty any remaining buffered cmds (false)
-		Motion_set_axis_buffer(SERVO_DEC_AXIS, false);
-		status	-=	Motion_move_axis_by_step(SERVO_DEC_AXIS, decStep);
-		printf("!!! decStep = %d  vel = %d  acc = %d\n", raStep, gMountConfig.dec.vel, gMountConfig.dec.acc);
+		// the slew has to empty any remaining buffered cmds (false)
+		Motion_set_axis_buffer(axis, false);
+		status	-=	Motion_move_axis_by_profile(axis,	gSlewPlan.axis[axis].slewStep,
+														gSlewPlan.axis[axis].slewVel,
+														gSlewPlan.axis[axis].acc);
 
 		// This velocity command will start when the above pos cmd completes
-		// Buffered move by tracking velocity
-		Motion_set_axis_buffer(SERVO_DEC_AXIS, true);
-		status	-=	Motion_move_axis_by_vel(SERVO_DEC_AXIS, trackingRate);
-	}
-	else
-	{
-		Motion_set_axis_buffer(SERVO_DEC_AXIS, false);
-		status	-=	Motion_move_axis_by_step(SERVO_DEC_AXIS, decStep);
+		if (gSlewPlan.axis[axis].trackRate != 0)
+		{
+			Motion_set_axis_buffer(axis, true);
+			status	-=	Motion_move_axis_by_vel(axis, gSlewPlan.axis[axis].trackRate);
+		}
 	}
+	status	-=	Motion_batch_end();
 
 	// If status is < zero, return error
 	return (status == kSTATUS_OK) ? kSTATUS_OK : kERROR;
@@ -1105,10 +1095,12 @@ int		status;
 	Motion_set_axis_buffer(SERVO_DEC_AXIS, buffered);
 
 	// Start the RA move and decrement status if error returned
+	Motion_batch_begin();
 	status	=	Motion_move_axis_by_step(SERVO_RA_AXIS, raStep);
 
-	// Start the Dec move
+	// Start the Dec move, both go out in one transfer
 	status	-=	Motion_move_axis_by_step(SERVO_DEC_AXIS, decStep);
+	status	-=	Motion_batch_end();
 
 	// If status is < zero, return error
 	return (status == kSTATUS_OK) ? kSTATUS_OK : kERROR;
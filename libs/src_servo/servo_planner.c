@@ -0,0 +1,490 @@
+//******************************************************************************
+//*	Name:			servo_planner.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description: Precomputed slew trajectories for the servo telescope mount
+//*
+//*	A slew is planned once, ahead of time, as a list of constant acceleration
+//*	segments per axis: accel, cruise and decel to the slew end point, then a
+//*	ramp up to the tracking rate and the tracking segment that runs forever.
+//*	The slew end point is iterated so the axis arrives on the moving target
+//*	(the target moves at the tracking rate while the mount slews) and the
+//*	shorter axis cruises slower so both axes arrive at the same time.
+//*	The plan can be sampled at any time or turned into a time indexed table,
+//*	the offline simulator uses that to check the plans.
+//*
+//*	This file does not talk to the hardware, the caller makes the flip
+//*	decision, converts the target to steps and sends the segments. The RoboClaw
+//*	runs the trapezoid and the tracking velocity itself, so the mount does not
+//*	sample the plan while it moves.
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++ and led by Mark Sproul
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.
+//*	You must determine the suitability of this source code for your use.
+//*
+//*	Redistribution of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*	<RNS>	=	Ron N Story
+//*****************************************************************************
+//*	Oct 18,	2026	<MLS> Created servo_planner.c
+//*	Oct 18,	2026	<MLS> Added _TEST_SERVO_PLANNER_ offline goto simulator
+//*****************************************************************************
+
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <math.h>
+
+#include "servo_std_defs.h"
+#include "servo_planner.h"
+
+//*****************************************************************************
+// INTERNAL ROUTINE: Appends a constant acceleration segment and advances the
+// time, position and velocity to the end of the segment
+//*****************************************************************************
+static void Planner_add_seg(TYPE_PLAN_AXIS *axis, uint8_t type, double acc, double duration,
+							double *time, double *pos, double *vel)
+{
+TYPE_PLAN_SEGMENT	*seg;
+
+	if (axis->segCnt >= kPLAN_MAX_SEGS)
+	{
+		return;
+	}
+	seg				=	&axis->seg[axis->segCnt];
+	seg->type		=	type;
+	seg->startTime	=	*time;
+	seg->duration	=	duration;
+	seg->startPos	=	*pos;
+	seg->startVel	=	*vel;
+	seg->acc		=	acc;
+	axis->segCnt++;
+
+	// the velocity never changes sign inside a segment, so this is the distance
+	if (type != kPLAN_SEG_RAMP && type != kPLAN_SEG_TRACK)
+	{
+		axis->pathLen	+=	fabs((*vel * duration) + (0.5 * acc * duration * duration));
+	}
+	*pos	+=	(*vel * duration) + (0.5 * acc * duration * duration);
+	*vel	+=	acc * duration;
+	*time	+=	duration;
+}
+
+//*****************************************************************************
+// INTERNAL ROUTINE: Builds the segments for one axis from the start position
+// and velocity to axis->slewStep and then up to the tracking rate, cruising
+// at no more than maxVel. If syncTime is later than the fastest possible slew, the cruise velocity is
+// lowered so the slew ends at syncTime
+//*****************************************************************************
+static void Planner_build_axis(TYPE_PLAN_AXIS *axis, double startVel, const TYPE_PLAN_LIMITS *limits, double maxVel, double syncTime)
+{
+double	time, pos, vel;
+double	dist, dir, startSpeed;
+double	cruise, minCruise, peak, budget, b, disc;
+double	accDist, decDist, cruiseDist;
+double	acc;
+
+	axis->segCnt	=	0;
+	axis->pathLen	=	0.0;
+	acc				=	limits->acc;
+	time			=	0.0;
+	pos				=	(double)axis->startStep;
+	vel				=	startVel;
+
+	dist	=	(double)axis->slewStep - pos;
+	dir		=	(dist >= 0.0) ? kFORWARD : kREVERSE;
+
+	// moving away from the target, stop first
+	startSpeed	=	dir * vel;
+	if (startSpeed < 0.0)
+	{
+		Planner_add_seg(axis, kPLAN_SEG_DECEL, dir * acc, -startSpeed / acc, &time, &pos, &vel);
+	}
+
+	// too close to stop on the target, stop past it and come back
+	dist		=	(double)axis->slewStep - pos;
+	startSpeed	=	dir * vel;
+	if ((startSpeed * startSpeed) / (2.0 * acc) > fabs(dist))
+	{
+		Planner_add_seg(axis, kPLAN_SEG_DECEL, -dir * acc, startSpeed / acc, &time, &pos, &vel);
+		vel		=	0.0;
+		dist	=	(double)axis->slewStep - pos;
+		dir		=	(dist >= 0.0) ? kFORWARD : kREVERSE;
+	}
+	startSpeed	=	fabs(vel);
+
+	// slowest cruise velocity that still makes the sync time
+	cruise	=	fmin(limits->vel, maxVel);
+	budget	=	syncTime - time;
+	if (budget > 0.0)
+	{
+		b		=	(acc * budget) + startSpeed;
+		disc	=	(b * b) - (4.0 * ((acc * fabs(dist)) + (startSpeed * startSpeed / 2.0)));
+		if (disc >= 0.0)
+		{
+			cruise	=	fmin(cruise, (b - sqrt(disc)) / 2.0);
+		}
+	}
+	// Do not crawl, a slow axis fights friction and an axis slower than a
+	// few times the tracking rate never converges on the moving target.
+	// The controller takes whole steps/sec
+	minCruise	=	fmax(limits->vel * kPLAN_MIN_SYNC_VEL, kPLAN_MIN_TRACK_MULT * fabs(limits->trackRate));
+	cruise		=	fmax(cruise, fmin(minCruise, limits->vel));
+	cruise		=	fmax(ceil(cruise), fmax(ceil(startSpeed), 1.0));
+
+	// triangle profile if the cruise velocity can not be reached
+	peak	=	sqrt((acc * fabs(dist)) + (startSpeed * startSpeed / 2.0));
+	if (peak < cruise)
+	{
+		cruise	=	peak;
+	}
+	accDist		=	((cruise * cruise) - (startSpeed * startSpeed)) / (2.0 * acc);
+	decDist		=	(cruise * cruise) / (2.0 * acc);
+	cruiseDist	=	fmax(fabs(dist) - accDist - decDist, 0.0);
+	axis->slewVel	=	(int32_t)ceil(cruise);
+
+	if (cruise > startSpeed)
+	{
+		Planner_add_seg(axis, kPLAN_SEG_ACCEL, dir * acc, (cruise - startSpeed) / acc, &time, &pos, &vel);
+	}
+	if (cruiseDist > 0.0)
+	{
+		Planner_add_seg(axis, kPLAN_SEG_CRUISE, 0.0, cruiseDist / cruise, &time, &pos, &vel);
+	}
+	Planner_add_seg(axis, kPLAN_SEG_DECEL, -dir * acc, cruise / acc, &time, &pos, &vel);
+	axis->slewTime	=	time;
+
+	// the controller starts the buffered velocity cmd from a stop
+	vel	=	0.0;
+	pos	=	(double)axis->slewStep;
+	if (limits->trackRate != 0.0)
+	{
+		Planner_add_seg(axis, kPLAN_SEG_RAMP, copysign(acc, limits->trackRate), fabs(limits->trackRate) / acc, &time, &pos, &vel);
+	}
+	axis->settleTime	=	time;
+	Planner_add_seg(axis, kPLAN_SEG_TRACK, 0.0, 0.0, &time, &pos, &vel);
+}
+
+//*****************************************************************************
+// INTERNAL ROUTINE: Builds both axes as fast as they can go, then slows down
+// the faster axis to arrive with the slower one. Returns the cruise velocity
+// picked for each axis in maxVel[]
+//*****************************************************************************
+static void Planner_sync_axes(TYPE_SERVO_PLAN *plan, const double startVel[], const TYPE_PLAN_LIMITS limits[], double maxVel[])
+{
+double	syncTime	=	0.0;
+int		axis;
+
+	for (axis = 0; axis < kPLAN_AXES; axis++)
+	{
+		Planner_build_axis(&plan->axis[axis], startVel[axis], &limits[axis], limits[axis].vel, 0.0);
+		syncTime	=	fmax(syncTime, plan->axis[axis].slewTime);
+	}
+	for (axis = 0; axis < kPLAN_AXES; axis++)
+	{
+		if (plan->axis[axis].slewTime < syncTime)
+		{
+			Planner_build_axis(&plan->axis[axis], startVel[axis], &limits[axis], limits[axis].vel, syncTime);
+		}
+		maxVel[axis]	=	plan->axis[axis].slewVel;
+	}
+}
+
+//*****************************************************************************
+// INTERNAL ROUTINE: Moves the slew end points to where the target will be
+// at the end of the tracking ramp and rebuilds the axes with the velocities
+// from Planner_sync_axes(). The cruise velocity is fixed here so each pass
+// only shrinks the error (by the tracking rate over the cruise velocity).
+// Returns true once the end points stop moving
+//*****************************************************************************
+static bool Planner_chase_target(TYPE_SERVO_PLAN *plan, const double startVel[], const TYPE_PLAN_LIMITS limits[], const double maxVel[])
+{
+TYPE_PLAN_AXIS	*axis;
+double			rate;
+double			exact;
+bool			converged	=	true;
+int				idx;
+
+	for (idx = 0; idx < kPLAN_AXES; idx++)
+	{
+		axis		=	&plan->axis[idx];
+		rate		=	limits[idx].trackRate;
+		exact		=	axis->targetStep + (rate * axis->slewTime) + (rate * fabs(rate) / (2.0 * limits[idx].acc));
+		// a little slack, or rounding to whole steps can flip back and forth
+		if (fabs(exact - axis->slewStep) > 0.6)
+		{
+			axis->slewStep	=	(int32_t)lround(exact);
+			converged		=	false;
+		}
+	}
+	if (converged == false)
+	{
+		for (idx = 0; idx < kPLAN_AXES; idx++)
+		{
+			Planner_build_axis(&plan->axis[idx], startVel[idx], &limits[idx], maxVel[idx], 0.0);
+		}
+	}
+	return converged;
+}
+
+//*****************************************************************************
+// Plans a slew of both axes from startStep moving at startVel (steps/sec) to
+// a target that is at targetStep at plan time zero and moves at the tracking
+// rate in limits[]. After the slew the axes ramp up to the tracking rate and
+// are exactly on the moving target when the ramp ends.
+// Plan times are in seconds from the moment startStep/startVel were read,
+// plan->startTime is left for the caller to fill in
+//*****************************************************************************
+int Planner_plan_slew(TYPE_SERVO_PLAN *plan, const int32_t startStep[], const double startVel[], const int32_t targetStep[], const TYPE_PLAN_LIMITS limits[])
+{
+TYPE_PLAN_AXIS	*axis;
+double			maxVel[kPLAN_AXES];
+bool			converged;
+int				idx;
+int				pass;
+int				iter	=	0;
+
+	memset(plan, 0, sizeof(TYPE_SERVO_PLAN));
+	for (idx = 0; idx < kPLAN_AXES; idx++)
+	{
+		if (limits[idx].vel <= 0.0 || limits[idx].acc <= 0.0)
+		{
+			printf("ERROR!!! Planner_plan_slew() axis:%d has no vel or acc\n", idx);
+			return kERROR;
+		}
+		axis				=	&plan->axis[idx];
+		axis->startStep		=	startStep[idx];
+		axis->targetStep	=	targetStep[idx];
+		axis->slewStep		=	targetStep[idx];
+		axis->acc			=	(int32_t)lround(limits[idx].acc);
+		axis->trackRate		=	(int32_t)lround(limits[idx].trackRate);
+	}
+
+	// The target moves while the mount slews. The second pass picks the sync
+	// velocities again with the corrected end points
+	for (pass = 0; pass < 2; pass++)
+	{
+		Planner_sync_axes(plan, startVel, limits, maxVel);
+		converged	=	false;
+		for (idx = 0; idx < kPLAN_MAX_ITER && converged == false; idx++)
+		{
+			converged	=	Planner_chase_target(plan, startVel, limits, maxVel);
+			iter++;
+		}
+	}
+	plan->iterations	=	iter;
+	plan->duration		=	fmax(plan->axis[SERVO_RA_AXIS].settleTime, plan->axis[SERVO_DEC_AXIS].settleTime);
+
+	return kSTATUS_OK;
+}
+
+//*****************************************************************************
+// Returns the commanded position (steps) and velocity (steps/sec) of the axis
+// at a time in seconds from the start of the plan
+//*****************************************************************************
+int Planner_sample(const TYPE_SERVO_PLAN *plan, uint8_t axis, double time, double *pos, double *vel)
+{
+const TYPE_PLAN_AXIS	*planAxis;
+const TYPE_PLAN_SEGMENT	*seg;
+double					tau;
+int						idx;
+
+	if (axis >= kPLAN_AXES || plan->axis[axis].segCnt == 0)
+	{
+		return kERROR;
+	}
+	planAxis	=	&plan->axis[axis];
+
+	// at most a handful of segments, a linear search is all it needs
+	idx	=	0;
+	while (idx < (planAxis->segCnt - 1) && time >= planAxis->seg[idx + 1].startTime)
+	{
+		idx++;
+	}
+	seg	=	&planAxis->seg[idx];
+	tau	=	fmax(time - seg->startTime, 0.0);
+
+	*pos	=	seg->startPos + (seg->startVel * tau) + (0.5 * seg->acc * tau * tau);
+	*vel	=	seg->startVel + (seg->acc * tau);
+	return kSTATUS_OK;
+}
+
+//*****************************************************************************
+// Fills the table with the commanded positions and velocities of both axes
+// every period seconds up to the time both axes are tracking.
+// Returns the number of points in the table
+//*****************************************************************************
+int Planner_build_table(const TYPE_SERVO_PLAN *plan, double period, TYPE_PLAN_POINT *table, int maxPoints)
+{
+double	time;
+int		count	=	0;
+int		axis;
+
+	if (period <= 0.0)
+	{
+		return 0;
+	}
+	while (count < maxPoints)
+	{
+		time	=	count * period;
+		if (time > (plan->duration - (period * 1.0e-6)))
+		{
+			time	=	plan->duration;
+		}
+		table[count].time	=	time;
+		for (axis = 0; axis < kPLAN_AXES; axis++)
+		{
+			Planner_sample(plan, (uint8_t)axis, time, &table[count].pos[axis], &table[count].vel[axis]);
+		}
+		count++;
+		if (time >= plan->duration)
+		{
+			break;
+		}
+	}
+	return count;
+}
+
+
+#ifdef _TEST_SERVO_PLANNER_
+//*****************************************************************************
+// Offline simulator, replays random gotos on a German equatorial mount and
+// reports planning time, path length and the commanded rate errors.
+// No hardware or config files are needed
+//*****************************************************************************
+#include <time.h>
+
+#define	kSIM_GOTOS			10000
+#define	kSIM_STEP_ARCSEC	10.0		// 18:1 motor gear, 360 tooth main gear, 2000 count encoder
+#define	kSIM_VEL			50000.0
+#define	kSIM_ACC			10000.0
+#define	kSIM_PERIOD			0.01
+#define	kSIM_MAX_POINTS		100000
+
+static TYPE_PLAN_POINT	gsSimTable[kSIM_MAX_POINTS];
+
+//*****************************************************************************
+static double Sim_random(double min, double max)
+{
+	return min + ((max - min) * ((double)rand() / (double)RAND_MAX));
+}
+
+//*****************************************************************************
+static double Sim_elapsed_us(struct timespec *start, struct timespec *end)
+{
+	return ((end->tv_sec - start->tv_sec) * 1.0e6) + ((end->tv_nsec - start->tv_nsec) / 1.0e3);
+}
+
+//*****************************************************************************
+int main(void)
+{
+TYPE_SERVO_PLAN		plan;
+TYPE_PLAN_LIMITS	limits[kPLAN_AXES];
+struct timespec		start, end;
+int32_t				startStep[kPLAN_AXES], targetStep[kPLAN_AXES];
+double				startVel[kPLAN_AXES];
+double				startHA, startDec, targetHA, targetDec;
+double				planUs, sumPlanUs = 0.0, maxPlanUs = 0.0;
+double				pathDeg, sumPathDeg = 0.0, maxPathDeg = 0.0;
+double				sumSlew = 0.0, maxSlew = 0.0;
+double				tableErr = 0.0, limitErr = 0.0, trackPosErr = 0.0, trackRateErr = 0.0;
+double				pos, vel, numVel, target;
+double				sidereal;
+int					flips = 0, maxIter = 0;
+bool				flip;
+int					count, i, pt, axis;
+
+	srand(1234);
+	sidereal	=	kSIDER_RATE_ARCSECS * kSIM_STEP_ARCSEC;
+	for (i = 0; i < kSIM_GOTOS; i++)
+	{
+		// random start and target within 6 hours of the meridian
+		startHA		=	Sim_random(-6.0, 6.0);
+		startDec	=	Sim_random(-30.0, 89.0);
+		targetHA	=	Sim_random(-6.0, 6.0);
+		targetDec	=	Sim_random(-30.0, 89.0);
+
+		// GEM flip when the target is on the other side of the meridian,
+		// RA goes the long way by 12 hours and dec goes over the pole
+		flip	=	((startHA < 0.0) != (targetHA < 0.0));
+		if (flip == true)
+		{
+			targetHA	+=	(targetHA < 0.0) ? 12.0 : -12.0;
+			targetDec	=	180.0 - targetDec;
+			flips++;
+		}
+		startStep[SERVO_RA_AXIS]	=	(int32_t)(startHA * 15.0 * 3600.0 * kSIM_STEP_ARCSEC);
+		startStep[SERVO_DEC_AXIS]	=	(int32_t)(startDec * 3600.0 * kSIM_STEP_ARCSEC);
+		targetStep[SERVO_RA_AXIS]	=	(int32_t)(targetHA * 15.0 * 3600.0 * kSIM_STEP_ARCSEC);
+		targetStep[SERVO_DEC_AXIS]	=	(int32_t)(targetDec * 3600.0 * kSIM_STEP_ARCSEC);
+
+		for (axis = 0; axis < kPLAN_AXES; axis++)
+		{
+			limits[axis].vel		=	kSIM_VEL;
+			limits[axis].acc		=	kSIM_ACC;
+			limits[axis].trackRate	=	0.0;
+			startVel[axis]			=	0.0;
+		}
+		// half of the gotos start while tracking, the other half stopped
+		limits[SERVO_RA_AXIS].trackRate	=	((i % 4) < 2) ? sidereal : -sidereal;
+		startVel[SERVO_RA_AXIS]			=	((i % 2) == 0) ? limits[SERVO_RA_AXIS].trackRate : 0.0;
+
+		clock_gettime(CLOCK_MONOTONIC, &start);
+		Planner_plan_slew(&plan, startStep, startVel, targetStep, limits);
+		clock_gettime(CLOCK_MONOTONIC, &end);
+
+		planUs		=	Sim_elapsed_us(&start, &end);
+		sumPlanUs	+=	planUs;
+		maxPlanUs	=	fmax(maxPlanUs, planUs);
+		pathDeg		=	(plan.axis[SERVO_RA_AXIS].pathLen + plan.axis[SERVO_DEC_AXIS].pathLen) / (3600.0 * kSIM_STEP_ARCSEC);
+		sumPathDeg	+=	pathDeg;
+		maxPathDeg	=	fmax(maxPathDeg, pathDeg);
+		sumSlew		+=	plan.duration;
+		maxSlew		=	fmax(maxSlew, plan.duration);
+		maxIter		=	(plan.iterations > maxIter) ? plan.iterations : maxIter;
+
+		// the table velocity must match the position change and stay in limits
+		count	=	Planner_build_table(&plan, kSIM_PERIOD, gsSimTable, kSIM_MAX_POINTS);
+		for (pt = 1; pt < count; pt++)
+		{
+			for (axis = 0; axis < kPLAN_AXES; axis++)
+			{
+				if (gsSimTable[pt].time > gsSimTable[pt - 1].time)
+				{
+					numVel		=	(gsSimTable[pt].pos[axis] - gsSimTable[pt - 1].pos[axis]) / (gsSimTable[pt].time - gsSimTable[pt - 1].time);
+					tableErr	=	fmax(tableErr, fabs(numVel - ((gsSimTable[pt].vel[axis] + gsSimTable[pt - 1].vel[axis]) / 2.0)));
+				}
+				limitErr	=	fmax(limitErr, fabs(gsSimTable[pt].vel[axis]) - (kSIM_VEL + 1.0));
+			}
+		}
+
+		// once tracking, the commanded position must sit on the moving target
+		for (axis = 0; axis < kPLAN_AXES; axis++)
+		{
+			Planner_sample(&plan, (uint8_t)axis, plan.duration + 60.0, &pos, &vel);
+			target			=	targetStep[axis] + (limits[axis].trackRate * (plan.duration + 60.0));
+			trackPosErr		=	fmax(trackPosErr, fabs(pos - target));
+			trackRateErr	=	fmax(trackRateErr, fabs(vel - limits[axis].trackRate));
+		}
+	}
+
+	printf("Gotos:               %d (%d flips)\n", kSIM_GOTOS, flips);
+	printf("Planning time:       avg %.2f us  max %.2f us  max iterations %d\n", sumPlanUs / kSIM_GOTOS, maxPlanUs, maxIter);
+	printf("Path length:         avg %.2f deg  max %.2f deg\n", sumPathDeg / kSIM_GOTOS, maxPathDeg);
+	printf("Slew time:           avg %.2f sec  max %.2f sec\n", sumSlew / kSIM_GOTOS, maxSlew);
+	printf("Max rate error:      table %.6f steps/sec  over limit %.3f steps/sec  tracking %.6f steps/sec\n", tableErr, fmax(limitErr, 0.0), trackRateErr);
+	printf("Max tracking error:  %.3f steps\n", trackPosErr);
+
+	return 0;
+}
+#endif // _TEST_SERVO_PLANNER_
@@ -0,0 +1,117 @@
+//******************************************************************************
+//*	Name:			servo_planner.h
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description: header defs for the precomputed slew trajectory planner
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++ and led by Mark Sproul
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.
+//*	You must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*	<RNS>	=	Ron N Story
+//*****************************************************************************
+//*	Oct 18,	2026	<MLS> Created servo_planner.h
+//****************************************************************************
+//#include	"servo_planner.h"
+
+#ifndef _SERVO_PLANNER_H_
+#define _SERVO_PLANNER_H_
+
+#include	<stdint.h>
+#include	<stdbool.h>
+
+#ifndef	_INCLUDED_SERVO_STD_DEFS_
+	#include	"servo_std_defs.h"
+#endif
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define	kPLAN_MAX_SEGS		8		// reverse, overshoot, accel, cruise, decel, ramp, track
+#define	kPLAN_MAX_ITER		8		// iterations per pass to converge on the moving target
+#define	kPLAN_AXES			2
+#define	kPLAN_MIN_SYNC_VEL	0.05	// fraction of the slew vel an axis can be slowed to so both arrive together
+#define	kPLAN_MIN_TRACK_MULT	4.0		// and never slower than this times the tracking rate
+
+// Segment types, every segment is a constant acceleration
+enum
+{
+	kPLAN_SEG_ACCEL	=	0,
+	kPLAN_SEG_CRUISE,
+	kPLAN_SEG_DECEL,
+	kPLAN_SEG_RAMP,			// from stopped to the tracking rate
+	kPLAN_SEG_TRACK			// the last segment, runs forever
+};
+
+// Per axis limits for a slew, all in steps and seconds
+typedef struct
+{
+	double		vel;		// max slew velocity, steps/sec
+	double		acc;		// acceleration and deceleration, steps/sec^2
+	double		trackRate;	// signed tracking rate after the slew, steps/sec
+} TYPE_PLAN_LIMITS;
+
+typedef struct
+{
+	uint8_t		type;		// kPLAN_SEG_xxx
+	double		startTime;	// seconds from the start of the plan
+	double		duration;
+	double		startPos;	// steps
+	double		startVel;	// steps/sec
+	double		acc;		// signed steps/sec^2
+} TYPE_PLAN_SEGMENT;
+
+typedef struct
+{
+	int					segCnt;
+	TYPE_PLAN_SEGMENT	seg[kPLAN_MAX_SEGS];
+	int32_t				startStep;
+	int32_t				targetStep;	// target position at plan time zero, it moves at trackRate
+	int32_t				slewStep;	// end point of the position move sent to the controller
+	int32_t				slewVel;	// cruise velocity of the position move
+	int32_t				acc;
+	int32_t				trackRate;
+	double				slewTime;	// the position move is done
+	double				settleTime;	// up to the tracking rate
+	double				pathLen;	// steps travelled during the slew
+} TYPE_PLAN_AXIS;
+
+typedef struct
+{
+	TYPE_PLAN_AXIS		axis[kPLAN_AXES];
+	long double			startTime;	// system time of plan time zero, set by the caller
+	int					iterations;	// iterations used to converge on the moving target
+	double				duration;	// both axes are tracking
+} TYPE_SERVO_PLAN;
+
+// One entry of the time indexed table
+typedef struct
+{
+	double		time;
+	double		pos[kPLAN_AXES];
+	double		vel[kPLAN_AXES];
+} TYPE_PLAN_POINT;
+
+
+int Planner_plan_slew(TYPE_SERVO_PLAN *plan, const int32_t startStep[], const double startVel[], const int32_t targetStep[], const TYPE_PLAN_LIMITS limits[]);
+int Planner_sample(const TYPE_SERVO_PLAN *plan, uint8_t axis, double time, double *pos, double *vel);
+int Planner_build_table(const TYPE_SERVO_PLAN *plan, double period, TYPE_PLAN_POINT *table, int maxPoints);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SERVO_PLANNER_H_
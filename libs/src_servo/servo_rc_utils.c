@@ -60,6 +60,7 @@
 //*	Jul  7,	2022	<RNS> Fixed move_by_pos* bugs with negative vel/acc/decel
 //*	Nov  7,	2022	<RNS> Fixed a duplicate local #define vs include file
 //*	Nov  7,	2022	<RNS> Simplifed move_by_vela routine while debug RC wierdness
+//*	Oct 18,	2026	<MLS> Added RC_batch_begin() / RC_batch_end(), write cmds sent in one transfer
 //*****************************************************************************
 // Notes:   M1 *MUST BE* connected to RA or Azimuth axis, M2 to Dec or Altitude
 //*****************************************************************************
@@ -87,6 +88,83 @@
 static uint8_t gNoteBuf[64];
 static uint8_t gReceiptBuf[64];
 
+// Batch of write commands waiting to be sent, see RC_batch_begin()
+static bool		gsBatchActive	=	false;
+static uint8_t	gsBatchBuf[kRC_BATCH_BUF_LEN];
+static int		gsBatchLen		=	0;
+static int		gsBatchCnt		=	0;
+static int		gsBatchStatus	=	kSTATUS_OK;
+
+//*****************************************************************************
+// Sends the queued write commands as one transfer and checks every ack
+//*****************************************************************************
+static int RC_batch_flush(void)
+{
+uint8_t	ackBuf[kRC_BATCH_BUF_LEN];
+int		len;
+int		iii;
+int		status;
+
+	status	=	kSTATUS_OK;
+	if (gsBatchCnt > 0)
+	{
+		status	=	MC_write_comm(gsBatchBuf, gsBatchLen);
+		if (status == kSTATUS_OK)
+		{
+			// The RC answers each write command with one byte, in order
+			len	=	MC_read_comm(ackBuf, gsBatchCnt);
+			if (len != gsBatchCnt)
+			{
+				printf("RC_batch_flush: got error - len = %d   cmdCnt = %d\n", len, gsBatchCnt);
+				status	=	kERROR;
+			}
+			for (iii = 0; (status == kSTATUS_OK) && (iii < gsBatchCnt); iii++)
+			{
+				if (ackBuf[iii] != kRC_OK)
+				{
+					status	=	kERROR;
+				}
+			}
+		}
+		else
+		{
+			CONSOLE_DEBUG("MC_write_comm() failed");
+		}
+		gsBatchLen	=	0;
+		gsBatchCnt	=	0;
+	}
+	if (status != kSTATUS_OK)
+	{
+		gsBatchStatus	=	kERROR;
+	}
+	return(status);
+} // of RC_batch_flush()
+
+//*****************************************************************************
+// Starts collecting write commands (one byte ack reply) instead of sending each
+// one with its own round trip. A command that returns data sends the batch first
+// so the order on the wire is unchanged. The individual write calls report
+// success, errors are returned by RC_batch_end()
+//*****************************************************************************
+void RC_batch_begin(void)
+{
+	gsBatchActive	=	true;
+	gsBatchLen		=	0;
+	gsBatchCnt		=	0;
+	gsBatchStatus	=	kSTATUS_OK;
+} // of RC_batch_begin()
+
+//*****************************************************************************
+// Sends anything still queued and stops batching
+//	returns kSTATUS_OK if every command in the batch was acked, kERROR otherwise
+//*****************************************************************************
+int RC_batch_end(void)
+{
+	RC_batch_flush();
+	gsBatchActive	=	false;
+	return(gsBatchStatus);
+} // of RC_batch_end()
+
 //*****************************************************************************
 // Handles the messaging between the host the MC. Expect it to be modified to different
 //   MC if they require more than a simple send message and return value pair
@@ -100,6 +178,20 @@ int		writeStatus;
 //	CONSOLE_DEBUG(__FUNCTION__);
 //	CONSOLE_DEBUG_W_LONG("cmdLen\t=", cmdLen);
 //	CONSOLE_DEBUG_W_LONG("retLen\t=", retLen);
+	if (gsBatchActive)
+	{
+		// Write commands are queued, the ack is checked when the batch is sent
+		if ((retLen == 1) && ((gsBatchLen + cmdLen) <= sizeof(gsBatchBuf)))
+		{
+			memcpy(&gsBatchBuf[gsBatchLen], cmdBuf, cmdLen);
+			gsBatchLen	+=	cmdLen;
+			gsBatchCnt++;
+			retBuf[0]	=	kRC_OK;
+			return(kSTATUS_OK);
+		}
+		// Anything else has to go out after what is already queued
+		RC_batch_flush();
+	}
 	writeStatus	=	MC_write_comm(cmdBuf, cmdLen);
 //	CONSOLE_DEBUG_W_NUM("MC_write_comm -> writeStatus\t=", writeStatus);
 	if (writeStatus == kSTATUS_OK)
@@ -37,6 +37,7 @@
 //*	Jul  2,	2022	<RNS> Changed POS_FOREVER to kSTEP_FOREVER and moved here
 //*	Jul  5,	2022	<RNS> Regenerated all headers with cproto
 //*	Jul  7,	2022	<RNS> Changed to signed vel/acc/decel in move_by_pos*
+//*	Oct 18,	2026	<MLS> Added RC_batch_begin() / RC_batch_end()
 //****************************************************************************
 //#include "servo_rc_utils.h"
 
@@ -52,6 +53,7 @@
 #define	kRC_STATUS_ERROR	0xFFFFFFFF
 #define	kRC_CMD_QUEUE_EMPTY	0x80
 #define	kRC_OK				0xFF		//*	RC's successful one byte return status
+#define	kRC_BATCH_BUF_LEN	256			//*	max bytes of write commands sent in one transfer
 
 // This is value used to make a buffered move_by_vel command
 #define	kSTEP_FOREVER		0x3000000
@@ -85,6 +87,8 @@
 
 //* servo_rc_utils.c
 int RC_converse(uint8_t *cmdBuf, size_t cmdLen, uint8_t *retBuf, size_t retLen);
+void RC_batch_begin(void);
+int RC_batch_end(void);
 int RC_get_curr_pos(uint8_t addr, uint8_t motor, int32_t *pos);
 int RC_get_curr_vel(uint8_t addr, uint8_t motor, int32_t *vel);
 int RC_set_home(uint8_t addr, uint8_t motor);
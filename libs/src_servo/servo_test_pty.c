@@ -0,0 +1,256 @@
+//******************************************************************************
+//*	Name:			servo_test_pty.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description: Throughput test of the RoboClaw protocol against a simulated
+//*				controller on a pseudo terminal, no hardware needed
+//*
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++ and led by Mark Sproul
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.
+//*	You must determine the suitability of this source code for your use.
+//*
+//*	Redistributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 18,	2026	<MLS> Created servo_test_pty.c
+//*****************************************************************************
+// Notes:	The simulated RoboClaw checks the CRC of every command, acks the
+//			write commands with 0xFF and answers the read commands with zeros
+//			and a valid CRC. Each byte costs the wire time at 38.4K and every
+//			packet has a turn around delay, so the numbers are comparable
+//			between the unbatched and batched runs, not to real hardware.
+//
+//			make servo_test_pty
+//			./servo_test_pty
+//*****************************************************************************
+#include <stdio.h>
+#include <string.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <unistd.h>
+#include <termios.h>
+#include <pthread.h>
+#include <pty.h>
+#include <time.h>
+
+#include "servo_std_defs.h"
+#include "servo_mc_core.h"
+#include "servo_rc_utils.h"
+#include "servo_motion_cfg.h"
+#include "servo_motion.h"
+
+// the command table is defined in servo_rc_cmds.h, which can only be included once
+typedef struct
+{
+	uint8_t	cmd;
+	uint8_t	in;
+	uint8_t	out;
+} TYPE_RC_CMD;
+extern TYPE_RC_CMD	gRC[];
+#define	kRC_CMD_CNT		72
+
+// 10 bits per byte at 38400 baud, plus the time the controller takes to answer
+#define	kByteTime_us	260
+#define	kTurnAround_us	1000
+
+extern TYPE_MOTION_CONFIG	gMotionConfig;
+
+static int			gsEmuPort;
+static int			gsPacketCnt		=	0;
+static int			gsCrcErrCnt		=	0;
+static volatile bool	gsEmuRun	=	true;
+
+//******************************************************************************
+static double	Get_ms(void)
+{
+struct timespec	timeNow;
+
+	clock_gettime(CLOCK_MONOTONIC, &timeNow);
+	return((timeNow.tv_sec * 1000.0) + (timeNow.tv_nsec / 1000000.0));
+}
+
+//******************************************************************************
+// Simulated RoboClaw, one packet at a time in the order received
+//******************************************************************************
+static void	*RoboClaw_Emulator(void *arg)
+{
+uint8_t		rxBuf[512];
+uint8_t		reply[64];
+uint8_t		ack;
+int			rxCnt;
+int			bytesRead;
+int			cmdIn;
+int			cmdOut;
+int			packetLen;
+int			iii;
+uint16_t	crc;
+
+	(void)arg;
+	rxCnt	=	0;
+	while (gsEmuRun)
+	{
+		bytesRead	=	read(gsEmuPort, (rxBuf + rxCnt), (sizeof(rxBuf) - rxCnt));
+		if (bytesRead <= 0)
+		{
+			break;
+		}
+		rxCnt	+=	bytesRead;
+		while (rxCnt >= 2)
+		{
+			cmdIn	=	0;
+			cmdOut	=	0;
+			for (iii = 0; iii < kRC_CMD_CNT; iii++)
+			{
+				if (gRC[iii].cmd == rxBuf[1])
+				{
+					cmdIn	=	gRC[iii].in;
+					cmdOut	=	gRC[iii].out;
+					break;
+				}
+			}
+			if (cmdIn == 0)
+			{
+				printf("Unknown command %d, resyncing\n", rxBuf[1]);
+				rxCnt	=	0;
+				break;
+			}
+			// write commands carry a CRC, read commands are only address and command
+			packetLen	=	(cmdOut == 1) ? cmdIn : 2;
+			if (rxCnt < packetLen)
+			{
+				break;
+			}
+			usleep((kByteTime_us * packetLen) + kTurnAround_us);
+			gsPacketCnt++;
+			if (cmdOut == 1)
+			{
+				crc	=	MC_calc_crc16(rxBuf, (packetLen - 2), kCLEAR_CRC);
+				if (((crc >> 8) != rxBuf[packetLen - 2]) || ((crc & 0xFF) != rxBuf[packetLen - 1]))
+				{
+					gsCrcErrCnt++;
+				}
+				ack	=	0xFF;
+				usleep(kByteTime_us);
+				if (write(gsEmuPort, &ack, 1) != 1)
+				{
+					perror("RoboClaw_Emulator write: ");
+				}
+			}
+			else
+			{
+				memset(reply, 0, cmdOut);
+				crc					=	MC_calc_crc16(rxBuf, 2, kCLEAR_CRC);
+				crc					=	MC_calc_crc16(reply, (cmdOut - 2), crc);
+				reply[cmdOut - 2]	=	crc >> 8;
+				reply[cmdOut - 1]	=	crc & 0xFF;
+				usleep(kByteTime_us * cmdOut);
+				if (write(gsEmuPort, reply, cmdOut) != cmdOut)
+				{
+					perror("RoboClaw_Emulator write: ");
+				}
+			}
+			memmove(rxBuf, (rxBuf + packetLen), (rxCnt - packetLen));
+			rxCnt	-=	packetLen;
+		}
+	}
+	return(NULL);
+}
+
+//******************************************************************************
+// Two axis step moves, the way Servo_move_step() issues them
+//******************************************************************************
+static int	Run_StepMoves(const bool batched, const int moveCnt)
+{
+int		iii;
+int		status;
+int		failCnt;
+int		startPackets;
+double	startTime_ms;
+double	elapsed_ms;
+
+	failCnt			=	0;
+	startPackets	=	gsPacketCnt;
+	startTime_ms	=	Get_ms();
+	for (iii = 0; iii < moveCnt; iii++)
+	{
+		Motion_set_axis_buffer(0, false);
+		Motion_set_axis_buffer(1, false);
+		if (batched)
+		{
+			Motion_batch_begin();
+		}
+		status	=	Motion_move_axis_by_step(0, (1000 + iii));
+		status	|=	Motion_move_axis_by_step(1, (2000 + iii));
+		if (batched)
+		{
+			status	|=	Motion_batch_end();
+		}
+		if (status != kSTATUS_OK)
+		{
+			failCnt++;
+		}
+	}
+	elapsed_ms	=	Get_ms() - startTime_ms;
+	printf("%-10s %6.2f ms per 2 axis move, %d exchanges per move, %4.0f exchanges/sec\n",
+			(batched ? "batched" : "unbatched"),
+			(elapsed_ms / moveCnt),
+			((gsPacketCnt - startPackets) / moveCnt),
+			((gsPacketCnt - startPackets) / (elapsed_ms / 1000.0)));
+	return(failCnt);
+}
+
+//******************************************************************************
+int main(void)
+{
+int				clientPort;
+char			portName[64];
+struct termios	settings;
+pthread_t		emuThread;
+int				failCnt;
+
+	failCnt	=	0;
+	if (openpty(&gsEmuPort, &clientPort, portName, NULL, NULL) != 0)
+	{
+		perror("openpty: ");
+		return(1);
+	}
+	tcgetattr(gsEmuPort, &settings);
+	cfmakeraw(&settings);
+	tcsetattr(gsEmuPort, TCSANOW, &settings);
+	pthread_create(&emuThread, NULL, RoboClaw_Emulator, NULL);
+
+	if (MC_init_comm(portName, 38400) != kSTATUS_OK)
+	{
+		printf("MC_init_comm failed on %s\n", portName);
+		return(1);
+	}
+	gMotionConfig.motor0.addr	=	0x80;
+	gMotionConfig.motor1.addr	=	0x80;
+	gMotionConfig.motor0.vel	=	1000;
+	gMotionConfig.motor1.vel	=	1000;
+	gMotionConfig.motor0.acc	=	100;
+	gMotionConfig.motor1.acc	=	100;
+
+	failCnt	+=	Run_StepMoves(false, 20);
+	failCnt	+=	Run_StepMoves(true, 20);
+	if (gsCrcErrCnt != 0)
+	{
+		printf("CRC errors = %d\n", gsCrcErrCnt);
+		failCnt++;
+	}
+	printf("Failures = %d\n", failCnt);
+
+	gsEmuRun	=	false;
+	MC_shutdown();
+	close(gsEmuPort);
+	return(failCnt);
+}
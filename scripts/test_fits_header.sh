@@ -0,0 +1,169 @@
+#!/bin/bash
+########################################################
+###	Oct 18,	2026	<MLS> Created test_fits_header.sh
+#	Checks the cached FITS header and a saved FITS file, then times the
+#	fitsheader endpoint. Start alpacapi (built with _ENABLE_FITS_) first,
+#	run this on the same machine so it can read the saved file
+#		./test_fits_header.sh [host:port] [camera#] [request count]
+#	IMAGEDIR=path overrides the image directory from filelist
+#
+#	Header:		whole 2880 byte blocks ending with END, SIMPLE first, the
+#				fits_create_img() cards (SIMPLE, BITPIX, NAXIS, EXTEND and the
+#				COMMENT lines about the FITS standard) only once, no value
+#				keyword twice
+#	Saved file:	the same checks, plus fitsverify if it is installed.
+#				Skipped if no file is saved (saving is turned off in
+#				RunStateMachine_TakingPicture())
+#	Timing:		the first fitsheader of the new frame (the header is generated
+#				unless the save already did it) and the average of the requests
+#				after that (from the cache), connected is timed as the request overhead
+########################################################
+HOST=${1:-127.0.0.1:6800}
+CAMNUM=${2:-0}
+REQCNT=${3:-200}
+URL="http://$HOST/api/v1/camera/$CAMNUM"
+FAILCNT=0
+TMPDIR=$(mktemp -d)
+
+#	returns the "Value" of an alpaca GET
+GetValue()
+{
+	curl -s "$URL/$1" | grep -o '"Value":[^,}]*' | cut -d: -f2 | tr -d ' "'
+}
+
+#	returns the newest FITS file name
+GetNewestFits()
+{
+	curl -s "$URL/filelist?type=fits&limit=1" | grep -o '"[^"]*\.fits"' | head -1 | tr -d '"'
+}
+
+#	the header cards of a FITS file, one per line, up to END
+#	$1 = file
+HeaderCards()
+{
+	fold -b -w 80 "$1" | awk '{print} /^END +$|^END$/ {exit}'
+}
+
+#	$1 = file, $2 = name for the messages
+CheckHeader()
+{
+	CARDS=$TMPDIR/cards.txt
+	HeaderCards "$1" > "$CARDS"
+	HDRSIZE=$(( $(wc -l < "$CARDS") * 80 ))
+	if ! tail -1 "$CARDS" | grep -q '^END'
+	then
+		echo "FAIL: $2, no END card"
+		FAILCNT=$((FAILCNT + 1))
+	fi
+	if ! head -1 "$CARDS" | grep -q '^SIMPLE  =                    T'
+	then
+		echo "FAIL: $2, SIMPLE is not the first card"
+		FAILCNT=$((FAILCNT + 1))
+	fi
+	for KEYWORD in 'SIMPLE  =' 'BITPIX  =' 'NAXIS   =' 'EXTEND  =' 'COMMENT   FITS (Flexible' 'COMMENT   and Astrophysics'
+	do
+		if [ "$(grep -c "^$KEYWORD" "$CARDS")" -gt 1 ]
+		then
+			echo "FAIL: $2, \"$KEYWORD\" is in the header more than once"
+			FAILCNT=$((FAILCNT + 1))
+		fi
+	done
+	DUPLICATES=$(grep '^[A-Z0-9_-]\{1,8\} *=' "$CARDS" | cut -c1-8 | sort | uniq -d | tr '\n' ' ')
+	if [ -n "$DUPLICATES" ]
+	then
+		echo "FAIL: $2, keywords more than once: $DUPLICATES"
+		FAILCNT=$((FAILCNT + 1))
+	fi
+	echo "$2: $(wc -l < "$CARDS") cards, $(( (HDRSIZE + 2879) / 2880 )) blocks"
+}
+
+#	average time of $REQCNT requests, in milliseconds
+#	$1 = url
+TimeRequests()
+{
+	for iii in $(seq 1 "$REQCNT")
+	do
+		echo "url = \"$1\""
+		echo "output = /dev/null"
+	done > "$TMPDIR/curl.cfg"
+	curl -s -K "$TMPDIR/curl.cfg" -w "%{time_total}\n" | awk '{total += $1} END {printf("%.3f", (total * 1000) / NR)}'
+}
+
+#	wait for the driver to come up
+for iii in $(seq 1 20)
+do
+	if [ -n "$(GetValue connected)" ]
+	then
+		break
+	fi
+	sleep 0.5
+done
+curl -s -X PUT -d "Connected=true" "$URL/connected" > /dev/null
+
+#------------------------------------------------------------
+#*	take a picture, startexposure asks for it to be saved
+LASTFITS=$(GetNewestFits)
+curl -s -X PUT -d "Duration=0.1&Light=true" "$URL/startexposure" > /dev/null
+for iii in $(seq 1 100)
+do
+	if [ "$(GetValue imageready)" == "true" ]
+	then
+		break
+	fi
+	sleep 0.1
+done
+FIRST_MS=$(curl -s -o "$TMPDIR/header.fits" -w "%{time_total}" "$URL/fitsheader?format=fits" | awk '{printf("%.3f", $1 * 1000)}')
+
+#------------------------------------------------------------
+#*	the saved file
+for iii in $(seq 1 20)
+do
+	SAVEDFITS=$(GetNewestFits)
+	if [ -n "$SAVEDFITS" ] && [ "$SAVEDFITS" != "$LASTFITS" ]
+	then
+		break
+	fi
+	sleep 0.1
+done
+if [ -z "$IMAGEDIR" ]
+then
+	IMAGEDIR=$(curl -s "$URL/filelist?limit=1" | grep -o '"Directory":"[^"]*"' | cut -d: -f2 | tr -d '"')
+fi
+if [ -n "$SAVEDFITS" ] && [ "$SAVEDFITS" != "$LASTFITS" ] && [ -f "$IMAGEDIR/$SAVEDFITS" ]
+then
+	CheckHeader "$IMAGEDIR/$SAVEDFITS" "saved file $SAVEDFITS"
+	if [ $(( $(stat -c %s "$IMAGEDIR/$SAVEDFITS") % 2880 )) -ne 0 ]
+	then
+		echo "FAIL: saved file is not whole 2880 byte blocks"
+		FAILCNT=$((FAILCNT + 1))
+	fi
+	if command -v fitsverify > /dev/null
+	then
+		if ! fitsverify -q -e "$IMAGEDIR/$SAVEDFITS"
+		then
+			echo "FAIL: fitsverify $SAVEDFITS"
+			FAILCNT=$((FAILCNT + 1))
+		fi
+	else
+		echo "fitsverify is not installed, skipped"
+	fi
+else
+	echo "No FITS file was saved, saved file checks skipped"
+fi
+
+#------------------------------------------------------------
+#*	the header from the cache
+CheckHeader "$TMPDIR/header.fits" "fitsheader format=fits"
+if [ $(( $(stat -c %s "$TMPDIR/header.fits") % 2880 )) -ne 0 ]
+then
+	echo "FAIL: fitsheader format=fits is not whole 2880 byte blocks"
+	FAILCNT=$((FAILCNT + 1))
+fi
+FITS_MS=$(TimeRequests "$URL/fitsheader?format=fits")
+JSON_MS=$(TimeRequests "$URL/fitsheader")
+BASE_MS=$(TimeRequests "$URL/connected")
+echo "fitsheader: first request $FIRST_MS ms, then $REQCNT requests, format=fits $FITS_MS ms, json $JSON_MS ms (connected $BASE_MS ms)"
+
+rm -rf "$TMPDIR"
+echo "Failures = $FAILCNT"
+exit $FAILCNT
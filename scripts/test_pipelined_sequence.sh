@@ -0,0 +1,145 @@
+#!/bin/bash
+########################################################
+###	Oct 18,	2026	<MLS> Created test_pipelined_sequence.sh
+###	Oct 18,	2026	<MLS> Added MinDutyCycle checks
+#	Checks pipelined imaging sequences against the camera simulator
+#	Start alpacapi with the camera simulator first, then run
+#		./test_pipelined_sequence.sh [host:port] [camera#] [min duty cycle %]
+#
+#	Every sequence is run with a MinDutyCycle, every frame must be read
+#	(the sequence is not stopped early), the mode must not change and
+#	sequence-dutycycle-ok must match sequence-dutycycle against MinDutyCycle
+#	Pipelined:	MinDutyCycle (default 10%),
+#				the completed frame must still be downloadable (imageready)
+#				while the sensor is exposing the next frame,
+#				sequence-overlap_us must be > 0,
+#				sequence-dutycycle must be >= MinDutyCycle
+#	Serial:		MinDutyCycle (default 10%), sequence-overlap_us must be 0
+#	Serial:		MinDutyCycle=100, can not be met, sequence-dutycycle-ok must be
+#				false and the sequence must still run to the end as serial
+########################################################
+HOST=${1:-127.0.0.1:6800}
+CAMNUM=${2:-0}
+MINDUTY=${3:-10}
+FRAMECNT=5
+URL="http://$HOST/api/v1/camera/$CAMNUM"
+FAILCNT=0
+
+#	returns the "Value" of an alpaca GET
+GetValue()
+{
+	curl -s "$URL/$1" | grep -o '"Value":[^,}]*' | cut -d: -f2 | tr -d ' "'
+}
+
+#	returns a field from readall
+GetReadAll()
+{
+	curl -s "$URL/readall" | grep -o "\"$1\":[^,}]*" | cut -d: -f2 | tr -d ' "'
+}
+
+#	runs a sequence, watches imageready while the camera is exposing
+#	$1 = true/false (pipelined)
+#	$2 = MinDutyCycle
+RunSequence()
+{
+	READY_WHILE_EXPOSING=0
+	curl -s -X PUT -d "Duration=0.5&Count=$FRAMECNT&Pipelined=$1&MinDutyCycle=$2" "$URL/startsequence" > /dev/null
+	sleep 0.2
+	#	an empty answer means the request was missed, keep going until it is back to Single
+	#	or a minute has gone by
+	for iii in $(seq 1 1200)
+	do
+		if [ "$(GetReadAll image-mode)" == "Single" ]
+		then
+			break
+		fi
+		if [ "$(GetValue camerastate)" == "2" ] && [ "$(GetValue imageready)" == "true" ]
+		then
+			READY_WHILE_EXPOSING=$((READY_WHILE_EXPOSING + 1))
+		fi
+		sleep 0.05
+	done
+	OVERLAP=$(GetReadAll sequence-overlap_us)
+	DUTYCYCLE=$(GetReadAll sequence-dutycycle)
+	DUTYCYCLE_OK=$(GetReadAll sequence-dutycycle-ok)
+	FRAMESREAD=$(GetReadAll sequence-framesread)
+	PIPELINED=$(GetReadAll sequence-pipelined)
+	echo "pipelined=$1 dutycycle=$DUTYCYCLE% (min $2%, ok=$DUTYCYCLE_OK) frames=$FRAMESREAD overlap=$OVERLAP us imageready-while-exposing=$READY_WHILE_EXPOSING"
+}
+
+#	checks that apply to both modes
+#	$1 = true/false (pipelined)
+#	$2 = MinDutyCycle
+CheckSequence()
+{
+	if [ "$FRAMESREAD" != "$FRAMECNT" ]
+	then
+		echo "FAIL: pipelined=$1, $FRAMESREAD of $FRAMECNT frames read, the sequence was stopped early"
+		FAILCNT=$((FAILCNT + 1))
+	fi
+	if [ "$PIPELINED" != "$1" ]
+	then
+		echo "FAIL: pipelined=$1, the sequence mode was changed to pipelined=$PIPELINED"
+		FAILCNT=$((FAILCNT + 1))
+	fi
+	if awk "BEGIN {exit !($DUTYCYCLE < $2)}"
+	then
+		EXPECTED_OK=false
+	else
+		EXPECTED_OK=true
+	fi
+	if [ "$DUTYCYCLE_OK" != "$EXPECTED_OK" ]
+	then
+		echo "FAIL: pipelined=$1, sequence-dutycycle-ok=$DUTYCYCLE_OK with a duty cycle of $DUTYCYCLE% (min $2%)"
+		FAILCNT=$((FAILCNT + 1))
+	fi
+}
+
+#	wait for the driver to come up
+for iii in $(seq 1 20)
+do
+	if [ -n "$(GetValue connected)" ]
+	then
+		break
+	fi
+	sleep 0.5
+done
+curl -s -X PUT -d "Connected=true" "$URL/connected" > /dev/null
+
+RunSequence true "$MINDUTY"
+CheckSequence true "$MINDUTY"
+if awk "BEGIN {exit !($DUTYCYCLE < $MINDUTY)}"
+then
+	echo "FAIL: pipelined, duty cycle $DUTYCYCLE% is below the minimum of $MINDUTY%"
+	FAILCNT=$((FAILCNT + 1))
+fi
+if [ "$READY_WHILE_EXPOSING" -eq 0 ]
+then
+	echo "FAIL: pipelined, frame was not downloadable while the next one was exposing"
+	FAILCNT=$((FAILCNT + 1))
+fi
+if awk "BEGIN {exit !($OVERLAP <= 0)}"
+then
+	echo "FAIL: pipelined, processing did not overlap the next exposure"
+	FAILCNT=$((FAILCNT + 1))
+fi
+
+RunSequence false "$MINDUTY"
+CheckSequence false "$MINDUTY"
+if awk "BEGIN {exit !($OVERLAP != 0)}"
+then
+	echo "FAIL: serial, overlap should be 0"
+	FAILCNT=$((FAILCNT + 1))
+fi
+
+#	a minimum that can not be met is reported, it does not change or stop the sequence
+RunSequence false 100
+CheckSequence false 100
+if [ "$DUTYCYCLE_OK" != "false" ]
+then
+	echo "FAIL: serial, sequence-dutycycle-ok should be false with MinDutyCycle=100"
+	FAILCNT=$((FAILCNT + 1))
+fi
+
+echo "Failures = $FAILCNT"
+exit $FAILCNT
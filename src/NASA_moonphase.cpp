@@ -32,6 +32,12 @@
 //*	May 11,	2024	<MLS> Added CalculateDeclinationAvg()
 //*	Dec 11,	2024	<MLS> Added NASA_DownloadOneMoonPhaseFile()
 //*	Dec 11,	2024	<MLS> Updated NASA Moon downloads for 2025
+//*	Oct 18,	2026	<MLS> Added binary moon phase index (moonphase_index.bin), memory mapped, all years
+//*	Oct 18,	2026	<MLS> The text files are only parsed when the index is missing or out of date
+//*	Oct 18,	2026	<MLS> NASA_GetMoonPhaseInfo() now uses the requested year
+//*	Oct 18,	2026	<MLS> NASA_GetMoonImageFilePath() remembers which images are present
+//*	Oct 18,	2026	<MLS> The index records are checksummed, the index is fsync'd before the rename
+//*	Oct 18,	2026	<MLS> The directory is only read when the index has to be rebuilt
 //*****************************************************************************
 //    # https://skyandtelescope.org/astronomy-resources/native-american-full-moon-names/
 //    JAN = "wolf"
@@ -61,6 +67,10 @@
 #include	<sys/types.h>
 #include	<unistd.h>
 #include	<pthread.h>
+#include	<fcntl.h>
+#include	<stddef.h>
+#include	<stdint.h>
+#include	<sys/mman.h>
 
 #define _ENABLE_CONSOLE_DEBUG_
 #include	"ConsoleDebug.h"
@@ -73,8 +83,57 @@
 
 #define	kNASAmoonPhaseDir	"NASA_MoonInfo/"
 
-TYPE_MoonPhase	gMoonPhaseInfo[kMoonPhaseRecCnt];
-int				gMoonPhaseCnt	=	0;
+//*	the current year, points into the moon phase index
+static TYPE_MoonPhase	gEmptyMoonPhase[kMoonPhaseRecCnt];
+const TYPE_MoonPhase	*gMoonPhaseInfo	=	gEmptyMoonPhase;
+int						gMoonPhaseCnt	=	0;
+
+//*****************************************************************************
+//*	Moon phase index file
+//*		header, then kMoonPhaseRecCnt records for every year from firstYear on.
+//*		Built from the mooninfo_YYYY.txt files the first time and then just mapped.
+//*		It is rebuilt if a source file changes, a new year shows up next to the
+//*		indexed ones, the records do not match the checksum
+//*		or the layout of TYPE_MoonPhase changes.
+//*****************************************************************************
+#define	kMoonIndexFileName		"moonphase_index.bin"
+#define	kMoonIndexMagic			0x584E494D		//*	"MINX"
+#define	kMoonIndexVersion		1
+#define	kMoonIndexMaxYears		16
+#define	kMoonIndexDataOffset	4096
+
+//*****************************************************************************
+typedef struct
+{
+	int32_t		year;
+	int32_t		recordCnt;			//*	0 if there is no file for this year
+	int64_t		srcFileSize;
+	int64_t		srcFileTime;
+} TYPE_MoonIndexYear;
+
+//*****************************************************************************
+typedef struct
+{
+	uint32_t			magic;
+	uint32_t			version;
+	uint32_t			recordSize;		//*	sizeof(TYPE_MoonPhase)
+	uint32_t			recsPerYear;
+	int32_t				firstYear;
+	int32_t				yearCnt;
+	uint32_t			dataChecksum;	//*	everything after kMoonIndexDataOffset
+	TYPE_MoonIndexYear	years[kMoonIndexMaxYears];
+	uint32_t			headerChecksum;	//*	must be last
+} TYPE_MoonIndexHeader;
+
+static const TYPE_MoonIndexHeader	*gMoonIndexHdr		=	NULL;	//*	mapped file, or a malloc copy if it could not be written
+
+//*	images that have been found, so only missing ones are checked again.
+//*	The images are downloaded in the background, so a missing one may show up later.
+#define	kMoonImageCacheYears	4
+static pthread_mutex_t				gMoonImageCacheMutex	=	PTHREAD_MUTEX_INITIALIZER;
+static int							gMoonImageCacheYear[kMoonImageCacheYears];
+static int							gMoonImageCacheNext		=	0;
+static uint32_t						gMoonImagePresent[kMoonImageCacheYears][(kMoonPhaseRecCnt + 31) / 32];
 
 TYPE_MoonInfoFile	gMoonInfoFileList[kMoonFileMax];
 int					gMoonInfoFileCnt	=	0;
@@ -106,6 +165,9 @@ int		iii;
 	return(dayOfTheYear);
 }
 
+//*****************************************************************************
+static const TYPE_MoonPhase	*MoonIndex_GetYear(const int year, int *recordCnt);
+
 //*****************************************************************************
 int	NASA_GetPhaseIndex(int year, int month, int day, int hour)
 {
@@ -138,9 +200,12 @@ bool	NASA_GetMoonPhaseInfo(	int		year,
 								int		second,
 								TYPE_MoonPhase *moonPhaseInfo)
 {
-int		phaseIndex;
-bool	validFlag	=	false;
-double	deltaValue;
+int						phaseIndex;
+bool					validFlag	=	false;
+double					deltaValue;
+const TYPE_MoonPhase	*yearRecords;
+const TYPE_MoonPhase	*nextRecord;
+int						yearRecordCnt;
 
 //	CONSOLE_DEBUG_W_NUM("years  \t=", years);
 //	CONSOLE_DEBUG_W_NUM("months \t=", months);
@@ -148,18 +213,19 @@ double	deltaValue;
 //	CONSOLE_DEBUG_W_NUM("hours  \t=", hours);
 //	CONSOLE_DEBUG_W_NUM("minutes\t=", minutes);
 
-	phaseIndex		=	NASA_GetPhaseIndex(year, month, day, hour);
+	//*	straight index into the records for that year
+	yearRecords		=	MoonIndex_GetYear(year, &yearRecordCnt);
+	phaseIndex		=	(NASA_GetDayOfYear(year, month, day) * 24) + hour;
 //	CONSOLE_DEBUG_W_NUM("phaseIndex\t=", phaseIndex);
-	if (phaseIndex >= 0)
+	if ((yearRecords != NULL) && (phaseIndex >= 0) && (phaseIndex < yearRecordCnt))
 	{
-		*moonPhaseInfo				=	gMoonPhaseInfo[phaseIndex];
+		*moonPhaseInfo				=	yearRecords[phaseIndex];
 		moonPhaseInfo->Time_Minute	=	minute;
 		moonPhaseInfo->Time_Second	=	second;
 
 	#ifdef _ENABLE_INTERPOLATION_
 		if ((minute > 0) || (second > 0))
 		{
-		int		nextValueIndex;
 		double	nextValueAge;
 		double	nextValueDiam;
 		double	nextValueDist;
@@ -169,19 +235,28 @@ double	deltaValue;
 		double	nextValueELon;
 		double	myMinute;
 
-			nextValueIndex	=	phaseIndex + 1;
-			if (nextValueIndex < gMoonPhaseCnt)
+			//*	the last hour of the year interpolates to the first of the next year
+			nextRecord		=	NULL;
+			if ((phaseIndex + 1) < yearRecordCnt)
+			{
+				nextRecord	=	&yearRecords[phaseIndex + 1];
+			}
+			else
+			{
+				nextRecord	=	MoonIndex_GetYear(year + 1, &yearRecordCnt);
+			}
+			if (nextRecord != NULL)
 			{
 				myMinute				=	minute + (second / 60.0);
 //				CONSOLE_DEBUG_W_DBL("myMinute\t=", myMinute);
 				//*	lets interpolate
-				nextValuePhase			=	gMoonPhaseInfo[nextValueIndex].Phase;
-				nextValueAge			=	gMoonPhaseInfo[nextValueIndex].Age;
-				nextValueDiam			=	gMoonPhaseInfo[nextValueIndex].Diam;
-				nextValueDist			=	gMoonPhaseInfo[nextValueIndex].Dist;
-				nextValueAngle			=	gMoonPhaseInfo[nextValueIndex].AxisA;
-				nextValueELat			=	gMoonPhaseInfo[nextValueIndex].ELat;
-				nextValueELon			=	gMoonPhaseInfo[nextValueIndex].ELon;
+				nextValuePhase			=	nextRecord->Phase;
+				nextValueAge			=	nextRecord->Age;
+				nextValueDiam			=	nextRecord->Diam;
+				nextValueDist			=	nextRecord->Dist;
+				nextValueAngle			=	nextRecord->AxisA;
+				nextValueELat			=	nextRecord->ELat;
+				nextValueELon			=	nextRecord->ELon;
 
 				//*	phase
 				deltaValue				=	nextValuePhase - moonPhaseInfo->Phase;
@@ -420,7 +495,7 @@ typedef struct
 //*	this is much more complicated than it seems.
 //*	There can be one or more entries at the lowest point, same for highest point
 //*****************************************************************************
-static void	CalculatePhaseNamesWholeDay(void)
+static void	CalculatePhaseNamesWholeDay(TYPE_MoonPhase *moonPhaseInfo, const int moonPhaseCnt)
 {
 int		iii;
 int		newMoonCnt;
@@ -439,32 +514,32 @@ TYPE_ValuesOfInterest	valuesOfInterest[kMaxVOIcnt];
 	//--------------------------------------------------------
 	//*	compute delta values
 	iii	=	1;
-	while (iii<gMoonPhaseCnt)
+	while (iii<moonPhaseCnt)
 	{
-		gMoonPhaseInfo[iii].PhaseDelta	=	gMoonPhaseInfo[iii].Phase - gMoonPhaseInfo[iii - 1].Phase;
+		moonPhaseInfo[iii].PhaseDelta	=	moonPhaseInfo[iii].Phase - moonPhaseInfo[iii - 1].Phase;
 		iii++;
 	}
 
 	//--------------------------------------------------------
 	//*	now set the intermediate values
 	//*	many of these will get over-written later
-	for (iii=0; iii<gMoonPhaseCnt; iii++)
+	for (iii=0; iii<moonPhaseCnt; iii++)
 	{
-		if (gMoonPhaseInfo[iii].PhaseDelta < 0.0)
+		if (moonPhaseInfo[iii].PhaseDelta < 0.0)
 		{
-			strcpy(gMoonPhaseInfo[iii].PhaseName, "Waning");
+			strcpy(moonPhaseInfo[iii].PhaseName, "Waning");
 		}
 		else
 		{
-			strcpy(gMoonPhaseInfo[iii].PhaseName, "Waxing");
+			strcpy(moonPhaseInfo[iii].PhaseName, "Waxing");
 		}
-		if (gMoonPhaseInfo[iii].Phase < 50.0)
+		if (moonPhaseInfo[iii].Phase < 50.0)
 		{
-			strcat(gMoonPhaseInfo[iii].PhaseName, " crescent");
+			strcat(moonPhaseInfo[iii].PhaseName, " crescent");
 		}
 		else
 		{
-			strcat(gMoonPhaseInfo[iii].PhaseName, " gibbous");
+			strcat(moonPhaseInfo[iii].PhaseName, " gibbous");
 		}
 	}
 
@@ -474,20 +549,20 @@ TYPE_ValuesOfInterest	valuesOfInterest[kMaxVOIcnt];
 	//*	fist go through and find all of the NEW MOON events
 	//*	A new moon event is the lowest point,
 	//*	detected when the values are going down and then back up.
-//	CONSOLE_DEBUG_W_NUM("gMoonPhaseCnt\t=", gMoonPhaseCnt);
+//	CONSOLE_DEBUG_W_NUM("moonPhaseCnt\t=", moonPhaseCnt);
 	iii	=	0;
-	while (iii<gMoonPhaseCnt)
+	while (iii<moonPhaseCnt)
 	{
-		if (gMoonPhaseInfo[iii].Phase < 0.4)
+		if (moonPhaseInfo[iii].Phase < 0.4)
 		{
 			//*	we are now going to collet the values below this
 			jjj	=	0;
-			while (gMoonPhaseInfo[iii].Phase < 0.4)
+			while ((iii < moonPhaseCnt) && (moonPhaseInfo[iii].Phase < 0.4))
 			{
 				if (jjj < kMaxVOIcnt)
 				{
 					valuesOfInterest[jjj].indexNum		=	iii;
-					valuesOfInterest[jjj].phaseValue	=	gMoonPhaseInfo[iii].Phase;
+					valuesOfInterest[jjj].phaseValue	=	moonPhaseInfo[iii].Phase;
 					jjj++;
 				}
 				else
@@ -509,23 +584,23 @@ TYPE_ValuesOfInterest	valuesOfInterest[kMaxVOIcnt];
 					indexOfLowestPhaseValue	=	valuesOfInterest[jjj].indexNum;
 				}
 			}
-			if ((indexOfLowestPhaseValue >= 0) && (indexOfLowestPhaseValue < gMoonPhaseCnt))
+			if ((indexOfLowestPhaseValue >= 0) && (indexOfLowestPhaseValue < moonPhaseCnt))
 			{
-				gMoonPhaseInfo[indexOfLowestPhaseValue].IsNewMoon	=	true;
-				strcpy(gMoonPhaseInfo[indexOfLowestPhaseValue].PhaseName, "New Moon");
+				moonPhaseInfo[indexOfLowestPhaseValue].IsNewMoon	=	true;
+				strcpy(moonPhaseInfo[indexOfLowestPhaseValue].PhaseName, "New Moon");
 				newMoonCnt++;
 //				printf("%5d\tNew  Moon on %s %2d at %2d:00 Illumination=%5.2f\r\n", indexOfLowestPhaseValue,
-//												gMoonPhaseInfo[indexOfLowestPhaseValue].MonthName,
-//												gMoonPhaseInfo[indexOfLowestPhaseValue].Date_DOM,
-//												gMoonPhaseInfo[indexOfLowestPhaseValue].Time_Hour,
-//												gMoonPhaseInfo[indexOfLowestPhaseValue].Phase);
+//												moonPhaseInfo[indexOfLowestPhaseValue].MonthName,
+//												moonPhaseInfo[indexOfLowestPhaseValue].Date_DOM,
+//												moonPhaseInfo[indexOfLowestPhaseValue].Time_Hour,
+//												moonPhaseInfo[indexOfLowestPhaseValue].Phase);
 
 				//*	now we are going to go back and set all of the hours on this day to New Moon
-				currentHour	=	gMoonPhaseInfo[indexOfLowestPhaseValue].Time_Hour;
+				currentHour	=	moonPhaseInfo[indexOfLowestPhaseValue].Time_Hour;
 				jjj			=	indexOfLowestPhaseValue - currentHour;
 				for (hhh=0; hhh<24; hhh++)
 				{
-					strcpy(gMoonPhaseInfo[jjj].PhaseName, "New Moon");
+					strcpy(moonPhaseInfo[jjj].PhaseName, "New Moon");
 					jjj++;
 				}
 			}
@@ -536,18 +611,18 @@ TYPE_ValuesOfInterest	valuesOfInterest[kMaxVOIcnt];
 	//===================================================================================
 	//*	now look for FULL MOON
 	iii	=	0;
-	while (iii<gMoonPhaseCnt)
+	while (iii<moonPhaseCnt)
 	{
-		if (gMoonPhaseInfo[iii].Phase > 99.6)
+		if (moonPhaseInfo[iii].Phase > 99.6)
 		{
 			//*	we are now going to collet the values below this
 			jjj	=	0;
-			while (gMoonPhaseInfo[iii].Phase > 99.6)
+			while ((iii < moonPhaseCnt) && (moonPhaseInfo[iii].Phase > 99.6))
 			{
 				if (jjj < kMaxVOIcnt)
 				{
 					valuesOfInterest[jjj].indexNum		=	iii;
-					valuesOfInterest[jjj].phaseValue	=	gMoonPhaseInfo[iii].Phase;
+					valuesOfInterest[jjj].phaseValue	=	moonPhaseInfo[iii].Phase;
 					jjj++;
 				}
 				else
@@ -569,23 +644,23 @@ TYPE_ValuesOfInterest	valuesOfInterest[kMaxVOIcnt];
 					indexOfHighestPhaseValue	=	valuesOfInterest[jjj].indexNum;
 				}
 			}
-			if ((indexOfHighestPhaseValue >= 0) && (indexOfHighestPhaseValue < gMoonPhaseCnt))
+			if ((indexOfHighestPhaseValue >= 0) && (indexOfHighestPhaseValue < moonPhaseCnt))
 			{
-				gMoonPhaseInfo[indexOfHighestPhaseValue].IsFullMoon	=	true;
-				strcpy(gMoonPhaseInfo[indexOfHighestPhaseValue].PhaseName, "Full Moon");
+				moonPhaseInfo[indexOfHighestPhaseValue].IsFullMoon	=	true;
+				strcpy(moonPhaseInfo[indexOfHighestPhaseValue].PhaseName, "Full Moon");
 				fullMoonCnt++;
 //				printf("%5d\tFull Moon on %s %2d at %2d:00 Illumination=%5.2f\r\n", indexOfHighestPhaseValue,
-//												gMoonPhaseInfo[indexOfHighestPhaseValue].MonthName,
-//												gMoonPhaseInfo[indexOfHighestPhaseValue].Date_DOM,
-//												gMoonPhaseInfo[indexOfHighestPhaseValue].Time_Hour,
-//												gMoonPhaseInfo[indexOfHighestPhaseValue].Phase);
+//												moonPhaseInfo[indexOfHighestPhaseValue].MonthName,
+//												moonPhaseInfo[indexOfHighestPhaseValue].Date_DOM,
+//												moonPhaseInfo[indexOfHighestPhaseValue].Time_Hour,
+//												moonPhaseInfo[indexOfHighestPhaseValue].Phase);
 
 				//*	now we are going to go back and set all of the hours on this day to New Moon
-				currentHour	=	gMoonPhaseInfo[indexOfHighestPhaseValue].Time_Hour;
+				currentHour	=	moonPhaseInfo[indexOfHighestPhaseValue].Time_Hour;
 				jjj			=	indexOfHighestPhaseValue - currentHour;
 				for (hhh=0; hhh<24; hhh++)
 				{
-					strcpy(gMoonPhaseInfo[jjj].PhaseName, "Full Moon");
+					strcpy(moonPhaseInfo[jjj].PhaseName, "Full Moon");
 					jjj++;
 				}
 			}
@@ -597,18 +672,18 @@ TYPE_ValuesOfInterest	valuesOfInterest[kMaxVOIcnt];
 	//===================================================================================
 	//*	now look for Quarters
 	iii	=	0;
-	while (iii < gMoonPhaseCnt)
+	while (iii < moonPhaseCnt)
 	{
-		if ((gMoonPhaseInfo[iii].Phase > 48.0) && (gMoonPhaseInfo[iii].Phase < 52.0))
+		if ((moonPhaseInfo[iii].Phase > 48.0) && (moonPhaseInfo[iii].Phase < 52.0))
 		{
 			//*	we are now going to collet the values below this
 			jjj	=	0;
-			while ((gMoonPhaseInfo[iii].Phase > 48.0) && (gMoonPhaseInfo[iii].Phase < 52.0))
+			while ((iii < moonPhaseCnt) && ((moonPhaseInfo[iii].Phase > 48.0) && (moonPhaseInfo[iii].Phase < 52.0)))
 			{
 				if (jjj < kMaxVOIcnt)
 				{
 					valuesOfInterest[jjj].indexNum		=	iii;
-					valuesOfInterest[jjj].phaseValue	=	fabs(50.0 - gMoonPhaseInfo[iii].Phase);
+					valuesOfInterest[jjj].phaseValue	=	fabs(50.0 - moonPhaseInfo[iii].Phase);
 					jjj++;
 				}
 				else
@@ -630,33 +705,33 @@ TYPE_ValuesOfInterest	valuesOfInterest[kMaxVOIcnt];
 					indexOfLowestPhaseValue	=	valuesOfInterest[jjj].indexNum;
 				}
 			}
-			if ((indexOfLowestPhaseValue >= 0) && (indexOfLowestPhaseValue < gMoonPhaseCnt))
+			if ((indexOfLowestPhaseValue >= 0) && (indexOfLowestPhaseValue < moonPhaseCnt))
 			{
 			char	quarterString[32];
 
-				if (gMoonPhaseInfo[indexOfLowestPhaseValue].PhaseDelta > 0.0)
+				if (moonPhaseInfo[indexOfLowestPhaseValue].PhaseDelta > 0.0)
 				{
-					gMoonPhaseInfo[indexOfLowestPhaseValue].IsFirstQuater	=	true;
+					moonPhaseInfo[indexOfLowestPhaseValue].IsFirstQuater	=	true;
 					strcpy(quarterString, "First Quarter");
 				}
 				else
 				{
-					gMoonPhaseInfo[indexOfLowestPhaseValue].IsThirdQuater	=	true;
+					moonPhaseInfo[indexOfLowestPhaseValue].IsThirdQuater	=	true;
 					strcpy(quarterString, "Third Quarter");
 				}
-				strcpy(gMoonPhaseInfo[indexOfLowestPhaseValue].PhaseName, quarterString);
+				strcpy(moonPhaseInfo[indexOfLowestPhaseValue].PhaseName, quarterString);
 //				printf("%5d\tQuarter Moon on %s %2d at %2d:00 Illumination=%5.2f\r\n", indexOfLowestPhaseValue,
-//												gMoonPhaseInfo[indexOfLowestPhaseValue].MonthName,
-//												gMoonPhaseInfo[indexOfLowestPhaseValue].Date_DOM,
-//												gMoonPhaseInfo[indexOfLowestPhaseValue].Time_Hour,
-//												gMoonPhaseInfo[indexOfLowestPhaseValue].Phase);
+//												moonPhaseInfo[indexOfLowestPhaseValue].MonthName,
+//												moonPhaseInfo[indexOfLowestPhaseValue].Date_DOM,
+//												moonPhaseInfo[indexOfLowestPhaseValue].Time_Hour,
+//												moonPhaseInfo[indexOfLowestPhaseValue].Phase);
 
 				//*	now we are going to go back and set all of the hours on this day to New Moon
-				currentHour	=	gMoonPhaseInfo[indexOfLowestPhaseValue].Time_Hour;
+				currentHour	=	moonPhaseInfo[indexOfLowestPhaseValue].Time_Hour;
 				jjj			=	indexOfLowestPhaseValue - currentHour;
 				for (hhh=0; hhh<24; hhh++)
 				{
-					strcpy(gMoonPhaseInfo[jjj].PhaseName, quarterString);
+					strcpy(moonPhaseInfo[jjj].PhaseName, quarterString);
 					jjj++;
 				}
 			}
@@ -670,13 +745,13 @@ TYPE_ValuesOfInterest	valuesOfInterest[kMaxVOIcnt];
 
 	//--------------------------------------------------------------------------------------
 	//*	this is not quit correct, but any phase that is above 99% I am going to label as full
-	for (iii=0; iii < gMoonPhaseCnt; iii++)
+	for (iii=0; iii < moonPhaseCnt; iii++)
 	{
-		if ((gMoonPhaseInfo[iii].Phase >= 99.0) && (gMoonPhaseInfo[iii].IsFullMoon == false))
+		if ((moonPhaseInfo[iii].Phase >= 99.0) && (moonPhaseInfo[iii].IsFullMoon == false))
 		{
-			if (strncmp(gMoonPhaseInfo[iii].PhaseName, "Full", 4) != 0)
+			if (strncmp(moonPhaseInfo[iii].PhaseName, "Full", 4) != 0)
 			{
-				strcpy(gMoonPhaseInfo[iii].PhaseName, "Full Moon~");
+				strcpy(moonPhaseInfo[iii].PhaseName, "Full Moon~");
 			}
 		}
 	}
@@ -732,7 +807,7 @@ double	previousPhase;
 #endif // 0
 
 //*****************************************************************************
-static void	CalculateDeclinationAvg(void)
+static void	CalculateDeclinationAvg(const TYPE_MoonPhase *moonPhaseInfo, const int moonPhaseCnt)
 {
 int		iii;
 double	decDelta;
@@ -745,9 +820,9 @@ double	decDeltaTotal;
 	decDetlta_Max	=	0.0;
 	decDeltaTotal	=	0.0;
 
-	for (iii=1; iii<gMoonPhaseCnt; iii++)
+	for (iii=1; iii<moonPhaseCnt; iii++)
 	{
-		decDelta	=	fabs(gMoonPhaseInfo[iii].Dec - gMoonPhaseInfo[iii-1].Dec);
+		decDelta	=	fabs(moonPhaseInfo[iii].Dec - moonPhaseInfo[iii-1].Dec);
 		if (decDelta > decDetlta_Max)
 		{
 			decDetlta_Max	=	decDelta;
@@ -758,7 +833,7 @@ double	decDeltaTotal;
 		}
 		decDeltaTotal	+=	decDelta;
 	}
-//	decDetlta_Avg	=	decDeltaTotal / (gMoonPhaseCnt -1);
+//	decDetlta_Avg	=	decDeltaTotal / (moonPhaseCnt -1);
 //	CONSOLE_DEBUG_W_DBL("decDetlta_Min\t=",	decDetlta_Min);
 //	CONSOLE_DEBUG_W_DBL("decDetlta_Max\t=",	decDetlta_Max);
 //	CONSOLE_DEBUG_W_DBL("decDetlta_Avg\t=",	decDetlta_Avg);
@@ -766,59 +841,390 @@ double	decDeltaTotal;
 
 
 //*****************************************************************************
-int	NASA_ReadMoonPhaseData(void)
+//*	FNV-1a, used to make sure the index header and records are intact
+//*****************************************************************************
+static uint32_t	MoonIndex_Checksum(const unsigned char *dataPtr, const size_t dataLen)
 {
-FILE		*filePointer;
-char		fileName[128];
-char		filePath[128];
-char		lineBuff[256];
-int			recordCount;
-int			ignoredCount;
-int			currentYear;
+uint32_t	checkSum;
+size_t		iii;
 
-//	CONSOLE_DEBUG(__FUNCTION__);
+	checkSum	=	2166136261u;
+	for (iii=0; iii<dataLen; iii++)
+	{
+		checkSum	^=	dataPtr[iii];
+		checkSum	*=	16777619u;
+	}
+	return(checkSum);
+}
 
-	memset(gMoonPhaseInfo, 0, (sizeof(TYPE_MoonPhase) * kMoonPhaseRecCnt));
-	currentYear	=	GetCurrentYear();
+//*****************************************************************************
+static uint32_t	MoonIndex_HeaderChecksum(const TYPE_MoonIndexHeader *indexHdr)
+{
+	return(MoonIndex_Checksum((const unsigned char *)indexHdr, offsetof(TYPE_MoonIndexHeader, headerChecksum)));
+}
 
-	sprintf(fileName, "mooninfo_%4d.txt", currentYear);
-//	CONSOLE_DEBUG_W_NUM("currentYear\t=", currentYear);
-//	CONSOLE_DEBUG_W_STR("fileName   \t=", fileName);
-//	CONSOLE_ABORT(__FUNCTION__);
+//*****************************************************************************
+static size_t	MoonIndex_FileSize(const int yearCnt)
+{
+	return(kMoonIndexDataOffset + ((size_t)yearCnt * kMoonPhaseRecCnt * sizeof(TYPE_MoonPhase)));
+}
 
-	strcpy(filePath, kNASAmoonPhaseDir);
-//	strcat(filePath, "mooninfo_2024.txt");
-	strcat(filePath, fileName);
+//*****************************************************************************
+static uint32_t	MoonIndex_DataChecksum(const TYPE_MoonIndexHeader *indexHdr)
+{
+	return(MoonIndex_Checksum(	(const unsigned char *)indexHdr + kMoonIndexDataOffset,
+								(MoonIndex_FileSize(indexHdr->yearCnt) - kMoonIndexDataOffset)));
+}
+
+//*****************************************************************************
+static void	MoonIndex_GetSourcePath(const int year, char *filePath)
+{
+	sprintf(filePath, "%smooninfo_%4d.txt", kNASAmoonPhaseDir, year);
+}
+
+//*****************************************************************************
+//*	returns NULL if there is no data for that year
+//*****************************************************************************
+static const TYPE_MoonPhase	*MoonIndex_GetYear(const int year, int *recordCnt)
+{
+const TYPE_MoonIndexHeader	*indexHdr;
+const TYPE_MoonPhase		*yearRecords;
+int							yearIdx;
+
+	*recordCnt	=	0;
+	yearRecords	=	NULL;
+	indexHdr	=	gMoonIndexHdr;
+	if (indexHdr != NULL)
+	{
+		yearIdx	=	year - indexHdr->firstYear;
+		if ((yearIdx >= 0) && (yearIdx < indexHdr->yearCnt) && (indexHdr->years[yearIdx].recordCnt > 0))
+		{
+			yearRecords	=	(const TYPE_MoonPhase *)((const unsigned char *)indexHdr + kMoonIndexDataOffset);
+			yearRecords	+=	(yearIdx * kMoonPhaseRecCnt);
+			*recordCnt	=	indexHdr->years[yearIdx].recordCnt;
+		}
+	}
+	return(yearRecords);
+}
+
+//*****************************************************************************
+//*	checks that the index matches the mooninfo_YYYY.txt files on disk.
+//*	Only the years around the index are looked at, the directory is not read.
+//*****************************************************************************
+static bool	MoonIndex_IsCurrent(const TYPE_MoonIndexHeader *indexHdr, const size_t fileSize)
+{
+bool		isCurrent;
+int			year;
+int			yearIdx;
+int			sourceCnt;
+char		filePath[128];
+struct stat	fileStatus;
+
+	isCurrent	=	false;
+	if ((fileSize >= sizeof(TYPE_MoonIndexHeader)) &&
+		(indexHdr->magic			==	kMoonIndexMagic) &&
+		(indexHdr->version			==	kMoonIndexVersion) &&
+		(indexHdr->recordSize		==	sizeof(TYPE_MoonPhase)) &&
+		(indexHdr->recsPerYear		==	kMoonPhaseRecCnt) &&
+		(indexHdr->headerChecksum	==	MoonIndex_HeaderChecksum(indexHdr)) &&
+		(indexHdr->yearCnt > 0) && (indexHdr->yearCnt <= kMoonIndexMaxYears) &&
+		(fileSize == MoonIndex_FileSize(indexHdr->yearCnt)))
+	{
+		isCurrent	=	true;
+		//*	every year in the index has to have the same source file it was built from,
+		//*	and a year that had no file can not have one now
+		sourceCnt	=	0;
+		for (yearIdx=0; yearIdx < indexHdr->yearCnt; yearIdx++)
+		{
+			MoonIndex_GetSourcePath(indexHdr->years[yearIdx].year, filePath);
+			if (indexHdr->years[yearIdx].srcFileTime != 0)
+			{
+				if ((stat(filePath, &fileStatus) != 0) ||
+					(fileStatus.st_size != indexHdr->years[yearIdx].srcFileSize) ||
+					(fileStatus.st_mtime != indexHdr->years[yearIdx].srcFileTime))
+				{
+					CONSOLE_DEBUG_W_STR("Moon phase index out of date for", filePath);
+					isCurrent	=	false;
+				}
+				if (indexHdr->years[yearIdx].recordCnt > 0)
+				{
+					sourceCnt++;
+				}
+			}
+			else if (stat(filePath, &fileStatus) == 0)
+			{
+				CONSOLE_DEBUG_W_STR("Moon phase index missing", filePath);
+				isCurrent	=	false;
+			}
+		}
+		//*	new years are downloaded after the last one, older ones are only
+		//*	left out when the index is full
+		year	=	indexHdr->firstYear + indexHdr->yearCnt;
+		MoonIndex_GetSourcePath(year, filePath);
+		if (stat(filePath, &fileStatus) == 0)
+		{
+			CONSOLE_DEBUG_W_STR("Moon phase index missing", filePath);
+			isCurrent	=	false;
+		}
+		if (indexHdr->yearCnt < kMoonIndexMaxYears)
+		{
+			MoonIndex_GetSourcePath((indexHdr->firstYear - 1), filePath);
+			if (stat(filePath, &fileStatus) == 0)
+			{
+				CONSOLE_DEBUG_W_STR("Moon phase index missing", filePath);
+				isCurrent	=	false;
+			}
+		}
+		if (sourceCnt == 0)
+		{
+			isCurrent	=	false;
+		}
+		//*	last, it reads the whole file
+		if (isCurrent && (indexHdr->dataChecksum != MoonIndex_DataChecksum(indexHdr)))
+		{
+			CONSOLE_DEBUG("Moon phase index records do not match the checksum");
+			isCurrent	=	false;
+		}
+	}
+	return(isCurrent);
+}
+
+//*****************************************************************************
+//*	reads one mooninfo_YYYY.txt file into its slot of the index
+//*****************************************************************************
+static int	MoonIndex_ParseYear(const char *filePath, TYPE_MoonPhase *moonPhaseInfo)
+{
+FILE		*filePointer;
+char		lineBuff[256];
+int			recordCount;
+int			ignoredCount;
 
 	recordCount		=	0;
 	ignoredCount	=	0;
 	filePointer		=	fopen(filePath, "r");
 	if (filePointer != NULL)
 	{
-		while (fgets(lineBuff, 200, filePointer) && (recordCount < 9000))
+		while (fgets(lineBuff, 200, filePointer) && (recordCount < kMoonPhaseRecCnt))
 		{
 			if (isdigit(lineBuff[0]) && isdigit(lineBuff[1]) && (lineBuff[2] == 0x20))
 			{
-				ParseNASAmoonPhaseLine(lineBuff, &gMoonPhaseInfo[recordCount]);
+				ParseNASAmoonPhaseLine(lineBuff, &moonPhaseInfo[recordCount]);
 				recordCount++;
 			}
 			else
 			{
-//				printf("%s\r\n", lineBuff);
 				ignoredCount++;
 			}
 		}
+		fclose(filePointer);
 //		CONSOLE_DEBUG_W_NUM("recordCount \t=",	recordCount);
 //		CONSOLE_DEBUG_W_NUM("ignoredCount\t=",	ignoredCount);
+		if (recordCount > 0)
+		{
+			CalculatePhaseNamesWholeDay(moonPhaseInfo, recordCount);
+			CalculateDeclinationAvg(moonPhaseInfo, recordCount);
+		}
+	}
+	return(recordCount);
+}
+
+//*****************************************************************************
+//*	parses all of the text files and writes the index.
+//*	If the index can not be written, the buffer is used as is.
+//*****************************************************************************
+static unsigned char	*MoonIndex_Build(void)
+{
+unsigned char			*indexBuff;
+unsigned char			*mapPtr;
+TYPE_MoonIndexHeader	*indexHdr;
+TYPE_MoonPhase			*yearRecords;
+int						firstYear;
+int						lastYear;
+int						yearCnt;
+int						yearIdx;
+int						iii;
+size_t					buffSize;
+char					filePath[128];
+char					indexPath[128];
+char					tempPath[128];
+struct stat				fileStatus;
+int						fileDesc;
+ssize_t					bytesWritten;
+
+	if (gMoonInfoFileCnt <= 0)
+	{
+		return(NULL);
+	}
+	//*	keep the newest years if there are too many
+	firstYear	=	9999;
+	lastYear	=	0;
+	for (iii=0; iii<gMoonInfoFileCnt; iii++)
+	{
+		if ((gMoonInfoFileList[iii].year > 0) && (gMoonInfoFileList[iii].year < firstYear))
+		{
+			firstYear	=	gMoonInfoFileList[iii].year;
+		}
+		if (gMoonInfoFileList[iii].year > lastYear)
+		{
+			lastYear	=	gMoonInfoFileList[iii].year;
+		}
+	}
+	if (lastYear == 0)
+	{
+		return(NULL);
+	}
+	if ((lastYear - firstYear) >= kMoonIndexMaxYears)
+	{
+		firstYear	=	lastYear - kMoonIndexMaxYears + 1;
+	}
+	yearCnt		=	lastYear - firstYear + 1;
+	buffSize	=	MoonIndex_FileSize(yearCnt);
+	indexBuff	=	(unsigned char *)calloc(1, buffSize);
+	if (indexBuff == NULL)
+	{
+		CONSOLE_DEBUG("Failed to allocate moon phase index");
+		return(NULL);
+	}
+	indexHdr				=	(TYPE_MoonIndexHeader *)indexBuff;
+	indexHdr->magic			=	kMoonIndexMagic;
+	indexHdr->version		=	kMoonIndexVersion;
+	indexHdr->recordSize	=	sizeof(TYPE_MoonPhase);
+	indexHdr->recsPerYear	=	kMoonPhaseRecCnt;
+	indexHdr->firstYear		=	firstYear;
+	indexHdr->yearCnt		=	yearCnt;
+	for (yearIdx=0; yearIdx < yearCnt; yearIdx++)
+	{
+		indexHdr->years[yearIdx].year	=	firstYear + yearIdx;
+	}
+	for (iii=0; iii<gMoonInfoFileCnt; iii++)
+	{
+		yearIdx	=	gMoonInfoFileList[iii].year - firstYear;
+		if ((gMoonInfoFileList[iii].year > 0) && (yearIdx >= 0))
+		{
+			MoonIndex_GetSourcePath(gMoonInfoFileList[iii].year, filePath);
+			if (stat(filePath, &fileStatus) == 0)
+			{
+				yearRecords	=	(TYPE_MoonPhase *)(indexBuff + kMoonIndexDataOffset) + (yearIdx * kMoonPhaseRecCnt);
+				indexHdr->years[yearIdx].recordCnt		=	MoonIndex_ParseYear(filePath, yearRecords);
+				indexHdr->years[yearIdx].srcFileSize	=	fileStatus.st_size;
+				indexHdr->years[yearIdx].srcFileTime	=	fileStatus.st_mtime;
+			}
+		}
+	}
+	indexHdr->dataChecksum		=	MoonIndex_DataChecksum(indexHdr);
+	indexHdr->headerChecksum	=	MoonIndex_HeaderChecksum(indexHdr);
+
+	//*	write it to a temp file and rename it so a reader never sees half a file,
+	//*	the data has to be on the disk before the rename or a power loss can leave
+	//*	the new name on an empty file
+	sprintf(indexPath,	"%s%s",		kNASAmoonPhaseDir, kMoonIndexFileName);
+	sprintf(tempPath,	"%s%s.tmp",	kNASAmoonPhaseDir, kMoonIndexFileName);
+	fileDesc	=	open(tempPath, (O_RDWR | O_CREAT | O_TRUNC), 0644);
+	if (fileDesc >= 0)
+	{
+		bytesWritten	=	write(fileDesc, indexBuff, buffSize);
+		if ((bytesWritten == (ssize_t)buffSize) && (fsync(fileDesc) != 0))
+		{
+			CONSOLE_DEBUG_W_STR("fsync failed on", tempPath);
+			bytesWritten	=	-1;
+		}
+		close(fileDesc);
+		if ((bytesWritten == (ssize_t)buffSize) && (rename(tempPath, indexPath) == 0))
+		{
+			fileDesc	=	open(indexPath, O_RDONLY);
+			if (fileDesc >= 0)
+			{
+				mapPtr	=	(unsigned char *)mmap(NULL, buffSize, PROT_READ, MAP_SHARED, fileDesc, 0);
+				close(fileDesc);
+				if (mapPtr != MAP_FAILED)
+				{
+					free(indexBuff);
+					indexBuff	=	mapPtr;
+				}
+			}
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_STR("Failed to write", tempPath);
+			unlink(tempPath);
+		}
+	}
+	else
+	{
+		CONSOLE_DEBUG_W_STR("Failed to create", tempPath);
+	}
+	return(indexBuff);
+}
+
+//*****************************************************************************
+//*	Maps the moon phase index, builds it first if it is missing or out of date.
+//*	gMoonPhaseInfo is pointed at the current year.
+//*	gMoonInfoFileList is only filled in when the index is rebuilt.
+//*
+//*	A previous index is left in memory, a reader may still have a pointer into it.
+//*	This only happens when new data has been downloaded.
+//*****************************************************************************
+int	NASA_ReadMoonPhaseData(void)
+{
+unsigned char				*indexPtr;
+size_t						indexSize;
+char						indexPath[128];
+struct stat					fileStatus;
+int							fileDesc;
+int							currentYear;
+int							recordCnt;
+const TYPE_MoonPhase		*yearRecords;
+
+//	CONSOLE_DEBUG(__FUNCTION__);
+	currentYear	=	GetCurrentYear();
+
+	indexPtr	=	NULL;
+	sprintf(indexPath, "%s%s", kNASAmoonPhaseDir, kMoonIndexFileName);
+	fileDesc	=	open(indexPath, O_RDONLY);
+	if (fileDesc >= 0)
+	{
+		if ((fstat(fileDesc, &fileStatus) == 0) && (fileStatus.st_size >= (off_t)sizeof(TYPE_MoonIndexHeader)))
+		{
+			indexSize	=	fileStatus.st_size;
+			indexPtr	=	(unsigned char *)mmap(NULL, indexSize, PROT_READ, MAP_SHARED, fileDesc, 0);
+			if (indexPtr == MAP_FAILED)
+			{
+				CONSOLE_DEBUG_W_STR("mmap failed on", indexPath);
+				indexPtr	=	NULL;
+			}
+			else if (MoonIndex_IsCurrent((TYPE_MoonIndexHeader *)indexPtr, indexSize) == false)
+			{
+				munmap(indexPtr, indexSize);
+				indexPtr	=	NULL;
+			}
+		}
+		close(fileDesc);
+	}
+
+	if (indexPtr == NULL)
+	{
+		CONSOLE_DEBUG_W_STR("Building moon phase index", indexPath);
+		NASA_ReadMoonPhaseDirectory();
+		indexPtr	=	MoonIndex_Build();
+	}
 
-		gMoonPhaseCnt	=	recordCount;
-//		CalculatePhaseNames();
-		CalculatePhaseNamesWholeDay();
-		CalculateDeclinationAvg();
+	if (indexPtr != NULL)
+	{
+		//*	the old one is not released, see above
+		gMoonIndexHdr	=	(const TYPE_MoonIndexHeader *)indexPtr;
+	}
+
+	yearRecords	=	MoonIndex_GetYear(currentYear, &recordCnt);
+	if (yearRecords != NULL)
+	{
+		gMoonPhaseInfo	=	yearRecords;
+		gMoonPhaseCnt	=	recordCnt;
 	}
 	else
 	{
-		CONSOLE_DEBUG_W_STR("NASA Moon Phase info not found, looking for:", filePath);
+		CONSOLE_DEBUG_W_NUM("NASA Moon Phase info not found for", currentYear);
+		gMoonPhaseInfo	=	gEmptyMoonPhase;
+		gMoonPhaseCnt	=	0;
 	}
 	return(gMoonPhaseCnt);
 }
@@ -871,6 +1277,11 @@ int				fileIndex;
 					if (fileIndex < kMoonFileMax)
 					{
 						strcpy(gMoonInfoFileList[fileIndex].FileName,	curFileName);
+						//*	mooninfo_2024.txt, anything else gets year 0 and is not indexed
+						if (sscanf(curFileName, "mooninfo_%d.txt", &gMoonInfoFileList[fileIndex].year) != 1)
+						{
+							gMoonInfoFileList[fileIndex].year	=	0;
+						}
 						fileIndex++;
 					}
 					else
@@ -902,6 +1313,7 @@ int				fileIndex;
 	{
 		CONSOLE_DEBUG_W_STR("Failed to open directory\t=",	kNASAmoonPhaseDir);
 	}
+	gMoonInfoFileCnt	=	fileIndex;
 	return(fileIndex);
 
 }
@@ -953,6 +1365,28 @@ bool			keepGoing;
 	return(imageCount);
 }
 
+//*****************************************************************************
+//*	returns true if the file exists
+//*****************************************************************************
+static uint32_t	*GetMoonImageCacheBits(const int year)
+{
+int		iii;
+
+	for (iii=0; iii<kMoonImageCacheYears; iii++)
+	{
+		if (gMoonImageCacheYear[iii] == year)
+		{
+			return(gMoonImagePresent[iii]);
+		}
+	}
+	//*	reuse the oldest one
+	iii							=	gMoonImageCacheNext;
+	gMoonImageCacheNext			=	(gMoonImageCacheNext + 1) % kMoonImageCacheYears;
+	gMoonImageCacheYear[iii]	=	year;
+	memset(gMoonImagePresent[iii], 0, sizeof(gMoonImagePresent[iii]));
+	return(gMoonImagePresent[iii]);
+}
+
 //*****************************************************************************
 //*	returns true if the file exists
 //*****************************************************************************
@@ -964,6 +1398,8 @@ char		yearString[32];
 struct stat	fileStatus;
 int			returnCode;
 bool		fileExists	=	false;
+uint32_t	*presentBits;
+uint32_t	bitMask;
 
 	phaseIndex	=	NASA_GetPhaseIndex(year, month, day, hour);
 //	CONSOLE_DEBUG_W_NUM("phaseIndex\t=", phaseIndex);
@@ -978,10 +1414,28 @@ bool		fileExists	=	false;
 		strcpy(imagePath, kNASAmoonPhaseDir);
 		strcat(imagePath, yearString);
 		strcat(imagePath, imageFileName);
-		returnCode	=	stat(imagePath, &fileStatus);
-		if (returnCode == 0)
+		if (phaseIndex < kMoonPhaseRecCnt)
+		{
+			bitMask	=	1u << (phaseIndex & 31);
+			pthread_mutex_lock(&gMoonImageCacheMutex);
+			presentBits	=	GetMoonImageCacheBits(year);
+			fileExists	=	((presentBits[phaseIndex / 32] & bitMask) != 0);
+			pthread_mutex_unlock(&gMoonImageCacheMutex);
+		}
+		if (fileExists == false)
 		{
-			fileExists	=	true;
+			returnCode	=	stat(imagePath, &fileStatus);
+			if (returnCode == 0)
+			{
+				fileExists	=	true;
+				if (phaseIndex < kMoonPhaseRecCnt)
+				{
+					pthread_mutex_lock(&gMoonImageCacheMutex);
+					presentBits	=	GetMoonImageCacheBits(year);
+					presentBits[phaseIndex / 32]	|=	bitMask;
+					pthread_mutex_unlock(&gMoonImageCacheMutex);
+				}
+			}
 		}
 	}
 	return(fileExists);
@@ -1216,6 +1670,7 @@ void	NASA_DownloadMoonPhaseData(void)
 	NASA_DownloadOneMoonPhaseFile("https://svs.gsfc.nasa.gov/vis/a000000/a005400/a005415/mooninfo_2025.txt");
 
 
+	//*	a new file is not in the index yet, this rebuilds it
 	NASA_ReadMoonPhaseData();
 //	CONSOLE_ABORT(__FUNCTION__);
 }
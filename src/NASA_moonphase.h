@@ -75,7 +75,7 @@ typedef struct
 
 
 #define	kMoonPhaseRecCnt	((366 * 24) + 10)
-extern	TYPE_MoonPhase		gMoonPhaseInfo[];
+extern	const TYPE_MoonPhase	*gMoonPhaseInfo;		//*	current year, kMoonPhaseRecCnt records
 extern	int					gMoonPhaseCnt;
 
 #define	kMoonFileMax		15
@@ -200,6 +200,20 @@
 //*	Jan  4,	2025	<MLS> Added Supported Devices Table
 //*	Jan  4,	2025	<MLS> Added AddSupportedDevice() & DumpSupportedDeviceList()
 //*	Jan 10,	2025	<MLS> Added _ENABLE_CPU_NANOSECS_DISPLAY_
+//*	Oct 18,	2026	<MLS> Added PublishStateSnapshot(), called after each state machine pass
+//*	Oct 18,	2026	<MLS> Added snapshot version and age to Get_Readall_Common()
+//*	Oct 18,	2026	<MLS> Added kCmd_Common_TimeSeries
+//*	Oct 18,	2026	<MLS> Device probes at startup run in parallel, see startup_probes.c
+//*	Oct 18,	2026	<MLS> Added AddToDeviceList(), devices made by a probe are staged first
+//*	Oct 18,	2026	<MLS> Added -y option to delay the simulator probes (testing startup)
+//*	Oct 18,	2026	<MLS> SendFileToSocket() now uses sendfile()
+//*	Oct 18,	2026	<MLS> Static files go through StaticFile_Send(), ETag and 304 support
+//*	Oct 18,	2026	<MLS> Added -m option to set the time series store file
+//*	Oct 18,	2026	<MLS> The IMU background thread is started once the IMU is found
+//*	Oct 18,	2026	<MLS> The switch state store path is made absolute at startup
+//*	Oct 18,	2026	<MLS> Each camera vendor is its own startup probe, ATIK and ASI stay together
+//*	Oct 18,	2026	<MLS> Late startup probes are registered from the main loop
+//*	Oct 18,	2026	<MLS> USB table and serial/USB port drivers are port probes, run in the old order
 //*****************************************************************************
 //*	to install code blocks 20
 //*	Step 1: sudo add-apt-repository ppa:codeblocks-devs/release
@@ -223,6 +237,7 @@
 #include	<sys/stat.h>
 #include	<sys/types.h>
 #include	<unistd.h>
+#include	<fcntl.h>
 
 #ifdef _ENABLE_FITS_
 	#ifndef _FITSIO_H
@@ -237,6 +252,7 @@
 #include <pthread.h>
 
 #define _DEBUG_TIMING_
+#define	_ENABLE_PARALLEL_STARTUP_	//*	run the device probes at startup in parallel, see startup_probes.c
 #define _ENABLE_CONSOLE_DEBUG_
 #include	"ConsoleDebug.h"
 
@@ -254,6 +270,10 @@
 #include	"obsconditions_globals.h"
 #include	"cpu_stats.h"
 #include	"usbmanager.h"
+#include	"devicestate_snapshot.h"
+#include	"startup_probes.h"
+#include	"static_files.h"
+#include	"timeseries_store.h"
 
 //#define _DEBUG_CONFORM_
 //#define	_SHOW_HTTP_DATA_
@@ -264,6 +284,33 @@
 
 #ifdef _ENABLE_CAMERA_
 	#include	"cameradriver.h"
+	#ifdef _ENABLE_FLIR_
+		#include	"cameradriver_FLIR.h"
+	#endif
+	#ifdef	_ENABLE_OGMA_
+		#include	"cameradriver_OGMA.h"
+	#endif
+	#ifdef _ENABLE_PHASEONE_
+		#include	"cameradriver_PhaseOne.h"
+	#endif
+	#ifdef _ENABLE_CAMERA_PLAYERONE_
+		#include	"cameradriver_PlayerOne.h"
+	#endif
+	#ifdef _ENABLE_QHY_
+		#include	"cameradriver_QHY.h"
+	#endif
+	#ifdef _ENABLE_QSI_
+		#include	"cameradriver_QSI.h"
+	#endif
+	#ifdef _ENABLE_CAMERA_SIMULATOR_
+		#include	"cameradriver_sim.h"
+	#endif
+	#ifdef _ENABLE_SONY_
+		#include	"cameradriver_SONY.h"
+	#endif
+	#ifdef _ENABLE_TOUP_
+		#include	"cameradriver_TOUP.h"
+	#endif
 #endif
 
 #ifdef	_ENABLE_DOME_
@@ -284,6 +331,7 @@
 #endif
 #ifdef _ENABLE_SWITCH_
 	#include	"switchdriver.h"
+	#include	"state_store.h"
 	#ifdef _ENABLE_SWITCH_RPI_
 		#include	"switchdriver_rpi.h"
 	#endif
@@ -345,6 +393,7 @@ bool			gDisplayImage								=	false;
 bool			gSimulateCameraImage						=	false;
 bool			gVerbose									=	false;
 bool			gDebugDiscovery								=	false;
+int				gSimulatedProbeDelay_ms						=	0;		//*	-y option, random delay added to each startup probe
 bool			gObservatorySettingsOK						=	false;
 const char		gValueString[]								=	"Value";
 char			gDefaultTelescopeRefID[kDefaultRefIdMaxLen]	=	"";
@@ -388,11 +437,13 @@ typedef struct	//	TYPE_SUPPORTED_DEV
 
 TYPE_SUPPORTED_DEV	gSupportedDevices[kMaxSupportedDevices];
 int					gSupportedDevCnt	=	0;
+static pthread_mutex_t	gSupportedDevMutex	=	PTHREAD_MUTEX_INITIALIZER;	//*	called from the startup probe threads
 
 
 //*****************************************************************************
 void	AddSupportedDevice(TYPE_DEVICETYPE argDeviceType, const char *manufacturer, const char *model, const char *libraryVer)
 {
+	pthread_mutex_lock(&gSupportedDevMutex);
 	if (gSupportedDevCnt < kMaxSupportedDevices)
 	{
 		gSupportedDevices[gSupportedDevCnt].deviceType	=			argDeviceType;
@@ -402,6 +453,7 @@ void	AddSupportedDevice(TYPE_DEVICETYPE argDeviceType, const char *manufacturer,
 
 		gSupportedDevCnt++;
 	}
+	pthread_mutex_unlock(&gSupportedDevMutex);
 }
 
 //*****************************************************************************
@@ -466,7 +518,7 @@ bool	foundIt;
 //*****************************************************************************
 AlpacaDriver::AlpacaDriver(TYPE_DEVICETYPE argDeviceType)
 {
-int		alpacaDeviceNum;
+int		stagedSameType;
 int		iii;
 
 //	CONSOLE_DEBUG("---------------------------------------");
@@ -548,31 +600,17 @@ int		iii;
 	//==========================================================================================
 	//*	add the device to the list
 	cDeviceType	=	argDeviceType;
-	//*	we have to figure out which index this devices is for this device type
-	alpacaDeviceNum	=	0;
-	for (iii=0; iii<gDeviceCnt; iii++)
-	{
-		//*	check to see if there are any other devices of this type
-		if (argDeviceType == gAlpacaDeviceList[iii]->cDeviceType)
-		{
-			alpacaDeviceNum++;
-		}
-	}
-	cAlpacaDeviceNum		=	alpacaDeviceNum;
-//	CONSOLE_DEBUG_W_NUM("cAlpacaDeviceNum\t=", cAlpacaDeviceNum);
-
-
-	if (gDeviceCnt < kMaxDevices)
+	//*	if we are being created by a startup probe, the device gets added to the list
+	//*	when all of the probes are done so the order is always the same.
+	//*	The device number is needed now by the derived constructors (config files etc)
+	cAlpacaDeviceNum	=	-1;
+	if (StartupProbe_StageDevice(this, argDeviceType, &stagedSameType))
 	{
-		gAlpacaDeviceList[gDeviceCnt]	=	this;
-		gDeviceCnt++;
+		cAlpacaDeviceNum	=	CountDevicesByType(argDeviceType) + stagedSameType;
 	}
 	else
 	{
-		CONSOLE_DEBUG("!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!");
-		CONSOLE_DEBUG("Exceed the maximum number of device objects");
-		CONSOLE_DEBUG_W_NUM("Current max is (kMaxDevices)\t=", kMaxDevices);
-		CONSOLE_ABORT(__FUNCTION__);
+		AddToDeviceList();
 	}
 
 	//*	command statistics
@@ -627,6 +665,50 @@ int	iii;
 	}
 }
 
+//*****************************************************************************
+//*	called from the constructor, or by StartupProbe_RunAll() for devices
+//*	that were created by a startup probe
+//*****************************************************************************
+void	AlpacaDriver::AddToDeviceList(void)
+{
+int		alpacaDeviceNum;
+int		iii;
+
+	//*	we have to figure out which index this devices is for this device type
+	alpacaDeviceNum	=	0;
+	for (iii=0; iii<gDeviceCnt; iii++)
+	{
+		//*	check to see if there are any other devices of this type
+		if ((gAlpacaDeviceList[iii] != NULL) && (cDeviceType == gAlpacaDeviceList[iii]->cDeviceType))
+		{
+			alpacaDeviceNum++;
+		}
+	}
+	if ((cAlpacaDeviceNum >= 0) && (cAlpacaDeviceNum != alpacaDeviceNum))
+	{
+		//*	only happens to devices from a probe that timed out, they are added last
+		CONSOLE_DEBUG_W_STR("Device number changed at registration for", cAlpacaName);
+		CONSOLE_DEBUG_W_NUM("Was\t=", cAlpacaDeviceNum);
+		CONSOLE_DEBUG_W_NUM("Now\t=", alpacaDeviceNum);
+	}
+	cAlpacaDeviceNum		=	alpacaDeviceNum;
+	cUUID.part4				=	gDeviceCnt;
+//	CONSOLE_DEBUG_W_NUM("cAlpacaDeviceNum\t=", cAlpacaDeviceNum);
+
+	if (gDeviceCnt < kMaxDevices)
+	{
+		gAlpacaDeviceList[gDeviceCnt]	=	this;
+		gDeviceCnt++;
+	}
+	else
+	{
+		CONSOLE_DEBUG("!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!!");
+		CONSOLE_DEBUG("Exceed the maximum number of device objects");
+		CONSOLE_DEBUG_W_NUM("Current max is (kMaxDevices)\t=", kMaxDevices);
+		CONSOLE_ABORT(__FUNCTION__);
+	}
+}
+
 
 
 
@@ -655,6 +737,16 @@ int32_t				delayMicroSeconds;
 	return(delayMicroSeconds);
 }
 
+//*****************************************************************************
+//*	called by the main loop after each state machine pass,
+//*	drivers that have state other devices need should over-ride this
+//*	and call DeviceSnapshot_Publish()
+//*****************************************************************************
+void	AlpacaDriver::PublishStateSnapshot(void)
+{
+	//*	do nothing, this routine should be overridden
+}
+
 //*****************************************************************************
 //*	return value 0 = OK
 //*****************************************************************************
@@ -811,6 +903,10 @@ char				tempString[64];
 			alpacaErrCode	=	Get_TemperatureLog(reqData, alpacaErrMsg, gValueString);
 			break;
 
+		case kCmd_Common_TimeSeries:
+			alpacaErrCode	=	Get_TimeSeries(reqData, alpacaErrMsg);
+			break;
+
 		default:
 			alpacaErrCode	=	kASCOM_Err_InvalidOperation;
 			strcpy(tempString,	"Unrecognized command:");
@@ -953,6 +1049,8 @@ TYPE_ASCOM_STATUS		alpacaErrCode	=	kASCOM_Err_Success;
 //*****************************************************************************
 TYPE_ASCOM_STATUS	AlpacaDriver::Get_Readall_Common(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
 {
+TYPE_DeviceSnapshot	stateSnapshot;
+
 //	CONSOLE_DEBUG(__FUNCTION__);
 	Get_Connected(			reqData, alpacaErrMsg, "connected");
 	Get_Description(		reqData, alpacaErrMsg, "description");
@@ -1004,7 +1102,23 @@ TYPE_ASCOM_STATUS	AlpacaDriver::Get_Readall_Common(TYPE_GetPutRequestData *reqDa
 									cDeviceFirmwareVersStr,
 									INCLUDE_COMMA);
 
+	//*	state snapshot, only devices that publish one
+	if (DeviceSnapshot_Read(cDeviceType, cAlpacaDeviceNum, &stateSnapshot))
+	{
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Uint32(reqData->socket,
+										reqData->jsonTextBuffer,
+										kMaxJsonBuffLen,
+										"snapshot-version",
+										stateSnapshot.version,
+										INCLUDE_COMMA);
 
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(reqData->socket,
+										reqData->jsonTextBuffer,
+										kMaxJsonBuffLen,
+										"snapshot-age_ms",
+										DeviceSnapshot_GetAge_ms(&stateSnapshot),
+										INCLUDE_COMMA);
+	}
 
 //	CONSOLE_DEBUG("exit");
 	return(kASCOM_Err_Success);
@@ -1602,6 +1716,10 @@ bool	foundFlag	=	true;
 			strcpy(agumentString, "returns 24 hour temperature log (24 * 60) entries");	break;
 			break;
 
+		case kCmd_Common_TimeSeries:
+			strcpy(agumentString, "channel=STR, start=SECS, end=SECS, level=raw/1s/1m/15m, no channel returns the channel list");
+			break;
+
 		default:
 			strcpy(agumentString, "");
 			foundFlag	=	false;
@@ -3084,86 +3202,30 @@ char	lineBuffer[256];
 	SocketWriteData(socketFD,	"</ul>\r\n");
 }
 
-//*****************************************************************************
-const char	gHTML_HeaderJpeg[]	=
-{
-	"HTTP/1.0 200 ok\r\n"
-//	"Server: alpaca\r\n"
-	"Mime-Version: 1.0\r\n"
-	"Content-Type: image/jpeg\r\n"
-	"Connection: close\r\n"
-	"\r\n"
-
-};
-
-
-//*****************************************************************************
-const char	gHTML_HeaderPNG[]	=
-{
-	"HTTP/1.0 200 ok\r\n"
-//	"Server: alpaca\r\n"
-	"Mime-Version: 1.0\r\n"
-	"Content-Type: image/png\r\n"
-	"Connection: close\r\n"
-	"\r\n"
-
-};
-
 //*****************************************************************************
 //*	Open and sends fileName to socket as a binary stream
 //*	returns bytes sent
 //*****************************************************************************
 int	SendFileToSocket(int socket, const char *fileName)
 {
-FILE			*filePointer;
-int				numRead;
-int				retCode;
-int				bytesWritten;
-int				totalBytesWritten;
-bool			keepGoing;
-char			dataBuffer[1600];
-
-	CONSOLE_DEBUG_W_STR("Sending file:", fileName);
+int				fileDesc;
+struct stat		fileStatus;
+int64_t			totalBytesWritten;
+
 	totalBytesWritten	=	0;
-	filePointer	=	fopen(fileName, "r");
-	if (filePointer != NULL)
+	fileDesc			=	open(fileName, O_RDONLY);
+	if (fileDesc >= 0)
 	{
-//		CONSOLE_DEBUG_W_STR("File is open:", fileName);
-		keepGoing			=	true;
-		while (keepGoing)
+		if (fstat(fileDesc, &fileStatus) == 0)
 		{
-			numRead	=	fread(dataBuffer, 1, 1500, filePointer);
-//			if ((numRead > 0) || (feof(filePointer)))
-			if (numRead > 0)
-			{
-//				CONSOLE_DEBUG_W_NUM("numRead=", numRead);
-				bytesWritten		=	write(socket, dataBuffer, numRead);
-				totalBytesWritten	+=	bytesWritten;
-			}
-			else
-			{
-				keepGoing	=	false;
-			}
-
-			if (feof(filePointer))
-			{
-				keepGoing	=	false;
-			}
+			totalBytesWritten	=	StaticFile_SendFileData(socket, fileDesc, 0, fileStatus.st_size);
 		}
-		retCode	=	fclose(filePointer);
-		if (retCode != 0)
-		{
-			CONSOLE_DEBUG_W_NUM("fclose(filePointer) failed with rc\t=",	retCode);
-
-		}
-		CONSOLE_DEBUG_W_STR("File is closed   \t=", fileName);
-		CONSOLE_DEBUG_W_NUM("totalBytesWritten\t=",	totalBytesWritten);
+		close(fileDesc);
 	}
 	else
 	{
-		CONSOLE_DEBUG("Failed to open file");
+		CONSOLE_DEBUG_W_STR("Failed to open file", fileName);
 	}
-//	CONSOLE_DEBUG_W_STR(__FUNCTION__, "Exit");
 	return(totalBytesWritten);
 }
 
@@ -3182,9 +3244,10 @@ int		iii;
 }
 
 //*****************************************************************************
-static void	SendJpegResponse(int socket, const char *jpegFileName)
+//*	httpRequest is passed so If-None-Match / If-Modified-Since can be answered with a 304
+//*****************************************************************************
+static void	SendJpegResponse(int socket, const char *jpegFileName, const char *httpRequest)
 {
-int				totalBytesWritten;
 char			myJpegFileName[256];
 char			altJpegFileName[256];
 char			*myFilenamePtr;
@@ -3193,16 +3256,6 @@ int				returnCode;
 
 //	CONSOLE_DEBUG(__FUNCTION__);
 
-	if (strcasestr(jpegFileName, ".png") != NULL)
-	{
-//		CONSOLE_DEBUG("Sending PNG file!!!!!!!!!!!!!!");
-		SocketWriteData(socket,	gHTML_HeaderPNG);
-	}
-	else
-	{
-//		CONSOLE_DEBUG("Sending JPEG file!!!!!!!!!!!!!!");
-		SocketWriteData(socket,	gHTML_HeaderJpeg);
-	}
 	if (jpegFileName != NULL)
 	{
 //		CONSOLE_DEBUG_W_STR("jpegFileName\t=", jpegFileName);
@@ -3250,12 +3303,8 @@ int				returnCode;
 		strcpy(myJpegFileName, "image.jpg");
 	}
 //	CONSOLE_DEBUG_W_STR("myJpegFileName=", myJpegFileName);
-	totalBytesWritten	=	SendFileToSocket(socket, myJpegFileName);
-	if (totalBytesWritten <= 0)
-	{
-		CONSOLE_DEBUG_W_STR("Failed to send file:", myJpegFileName);
-	}
-	CONSOLE_DEBUG_W_STR(__FUNCTION__, "Exit");
+	//*	sends the header with the content type, length and ETag
+	StaticFile_Send(socket, myJpegFileName, httpRequest);
 }
 
 //*****************************************************************************
@@ -4441,25 +4490,25 @@ int	iii;
 			if (strncasecmp(parseChrPtr,	"/favicon.ico", 12) == 0)
 			{
 //				CONSOLE_DEBUG("favicon.ico");
-				SendJpegResponse(socket, "favicon.ico");
+				SendJpegResponse(socket, "favicon.ico", htmlData);
 			}
 			//-------------------------------------------------------------------
 			else if (strncasecmp(parseChrPtr,	"/image.jpg", 10) == 0)
 			{
 //				CONSOLE_DEBUG("image.jpg");
-				SendJpegResponse(socket, NULL);
+				SendJpegResponse(socket, NULL, htmlData);
 			}
 			//-------------------------------------------------------------------
 			else if (strstr(parseChrPtr, ".jpg") != NULL)
 			{
 //				CONSOLE_DEBUG(".....jpg");
-				SendJpegResponse(socket, parseChrPtr);
+				SendJpegResponse(socket, parseChrPtr, htmlData);
 			}
 			//-------------------------------------------------------------------
 			else if (strstr(parseChrPtr, ".png") != NULL)
 			{
 //				CONSOLE_DEBUG(".....png");
-				SendJpegResponse(socket, parseChrPtr);
+				SendJpegResponse(socket, parseChrPtr, htmlData);
 			}
 			else
 			{
@@ -4587,11 +4636,13 @@ static void	PrintHelp(const char *appName)
 #endif
 	printf("\t%-20s\t%s\r\n",	"-h",				"This help message");
 	printf("\t%-20s\t%s\r\n",	"-l",				"Live mode");
+	printf("\t%-20s\t%s\r\n",	"-m <file>",		"time series store file (default " kTS_FileName ")");
 	printf("\t%-20s\t%s\r\n",	"-p <port>",		"what port to use (default 6800)");
 	printf("\t%-20s\t%s\r\n",	"-q",				"quiet (less console messages)");
 	printf("\t%-20s\t%s\r\n",	"-s",				"Simulate camera image");
 	printf("\t%-20s\t%s\r\n",	"-t <profile>",		"Which telescope profile to use");
 	printf("\t%-20s\t%s\r\n",	"-v",				"verbose (more console messages default)");
+	printf("\t%-20s\t%s\r\n",	"-y <msecs>",		"Add a random delay up to <msecs> to each startup probe (testing)");
 }
 
 #ifdef _ENABLE_GLOBAL_GPS_
@@ -4699,6 +4750,20 @@ int		newListenPort;
 					}
 					break;
 
+				//	"-m" means time series store file, either -m/path/file or -m /path/file
+				case 'm':
+					if (strlen(argv[iii]) > 2)
+					{
+						TimeSeries_SetFilePath(&argv[iii][2]);
+					}
+					else if (iii < (argc -1))
+					{
+						iii++;
+						TimeSeries_SetFilePath(argv[iii]);
+					}
+					CONSOLE_DEBUG_W_STR("Time series store\t=", TimeSeries_GetFilePath());
+					break;
+
 				//	"-q" means quiet
 				case 'q':
 					gVerbose	=	false;
@@ -4732,6 +4797,20 @@ int		newListenPort;
 				case 'v':
 					gVerbose	=	true;
 					break;
+
+				//	"-y" means delay the startup probes, either -y500 or -y 500
+				case 'y':
+					if (isdigit(argv[iii][2]))
+					{
+						gSimulatedProbeDelay_ms	=	atoi(&argv[iii][2]);
+					}
+					else if (iii < (argc -1))
+					{
+						iii++;
+						gSimulatedProbeDelay_ms	=	atoi(argv[iii]);
+					}
+					CONSOLE_DEBUG_W_NUM("gSimulatedProbeDelay_ms\t=", gSimulatedProbeDelay_ms);
+					break;
 			}
 		}
 	}
@@ -4849,108 +4928,221 @@ void	AlpacaDriver::ComputeCPUusage(void)
 }
 
 
+#ifdef _ENABLE_PARALLEL_STARTUP_
 //*****************************************************************************
-static void	CreateDriverObjects()
+//*	called by StartupProbe_RunAll() in the order the probes were added
+//*****************************************************************************
+static void	RegisterProbedDevice(void *device)
 {
-	SETUP_TIMING();
-
-//------------------------------------------------------
-//*	Cameras
-#ifdef _ENABLE_CAMERA_
-int		cameraCnt	=	0;
-	cameraCnt	=	CreateCameraObjects();
-	CONSOLE_DEBUG_W_NUM("total cameras created\t=", cameraCnt);
-	DEBUG_TIMING("Time to create camera objects (ms)=");
-#endif
+	((AlpacaDriver *)device)->AddToDeviceList();
+}
+#endif // _ENABLE_PARALLEL_STARTUP_
 
+//*****************************************************************************
+//*	-y option, used to test the startup probes with the simulator drivers
+//*****************************************************************************
+static void	SimulatedProbeDelay(void)
+{
+int		delay_ms;
 
-//------------------------------------------------------
-//*	Multicam
-#ifdef _ENABLE_MULTICAM_
-	cameraCnt	=	CountDevicesByType(kDeviceType_Camera);
-	if (cameraCnt > 1)
+	if (gSimulatedProbeDelay_ms > 0)
 	{
-		CreateMultiCamObject();
+		delay_ms	=	random() % gSimulatedProbeDelay_ms;
+		usleep(delay_ms * 1000);
 	}
-	DEBUG_TIMING("Time to create multicam objects (ms)=");
-#endif
+}
 
-//------------------------------------------------------
+//*****************************************************************************
+//*	Probe functions for the startup probes, each one has to be independent of the others
+//*****************************************************************************
+static int	Probe_USB(void)					{	SimulatedProbeDelay();	return(USB_InitTable());				}
+#ifdef _ENABLE_CAMERA_
+	//*	ATIK needs to be before ASI so they share a probe, the other vendors each get their own
+	static int	Probe_Cameras_ATIK_ASI(void)	{	SimulatedProbeDelay();	return(CreateCameraObjects_ATIK_ASI());	}
+	#ifdef _ENABLE_FLIR_
+	static int	Probe_Camera_FLIR(void)			{	SimulatedProbeDelay();	return(CreateCameraObjects_FLIR());		}
+	#endif
+	#ifdef _ENABLE_PHASEONE_
+	static int	Probe_Camera_PhaseOne(void)		{	SimulatedProbeDelay();	return(CreateCameraObjects_PhaseOne());	}
+	#endif
+	#ifdef _ENABLE_CAMERA_PLAYERONE_
+	static int	Probe_Camera_PlayerOne(void)	{	SimulatedProbeDelay();	return(CreateCameraObjects_PlayerOne());	}
+	#endif
+	#ifdef _ENABLE_QHY_
+	static int	Probe_Camera_QHY(void)			{	SimulatedProbeDelay();	return(CreateCameraObjects_QHY());		}
+	#endif
+	#ifdef _ENABLE_QSI_
+	static int	Probe_Camera_QSI(void)			{	SimulatedProbeDelay();	return(CreateCameraObjects_QSI());		}
+	#endif
+	#ifdef _ENABLE_TOUP_
+	static int	Probe_Camera_TOUP(void)			{	SimulatedProbeDelay();	return(CreateCameraObjects_TOUP());		}
+	#endif
+	#ifdef	_ENABLE_OGMA_
+	static int	Probe_Camera_OGMA(void)			{	SimulatedProbeDelay();	return(CreateCameraObjects_OGMA());		}
+	#endif
+	#ifdef _ENABLE_SONY_
+	static int	Probe_Camera_SONY(void)			{	SimulatedProbeDelay();	return(CreateCameraObjects_SONY());		}
+	#endif
+	#ifdef _ENABLE_CAMERA_SIMULATOR_
+	static int	Probe_Camera_Sim(void)			{	SimulatedProbeDelay();	return(CreateCameraObjects_Sim());		}
+	#endif
+#endif
 #if _ENABLE_CALIBRATION_
-	CreateCalibrationObjects();
-	DEBUG_TIMING("Time to create calibration objects (ms)=");
-#endif // _ENABLE_CALIBRATION_
-
-//------------------------------------------------------
-//*	Dome
+	static int	Probe_Calibration(void)		{	SimulatedProbeDelay();	CreateCalibrationObjects();		return(0);	}
+#endif
 #ifdef _ENABLE_DOME_
-	CreateDomeObjects();
-	DEBUG_TIMING("Time to create dome objects (ms)=");
+	static int	Probe_Dome(void)			{	SimulatedProbeDelay();	CreateDomeObjects();			return(0);	}
 #endif
-
-//------------------------------------------------------
-//*	Filter wheel
 #ifdef _ENABLE_FILTERWHEEL_
-	CreateFilterWheelObjects();
-	DEBUG_TIMING("Time to create filterhweel objects (ms)=");
+	static int	Probe_FilterWheel(void)		{	SimulatedProbeDelay();	CreateFilterWheelObjects();		return(0);	}
 #endif
-
-//------------------------------------------------------
-//*	Focuser
 #ifdef _ENABLE_FOCUSER_
-	CreateFocuserObjects();
-	DEBUG_TIMING("Time to create focuser objects (ms)=");
+	static int	Probe_Focuser(void)			{	SimulatedProbeDelay();	return(CreateFocuserObjects());			}
 #endif
-
-//------------------------------------------------------
-//*	Observing conditions
 #if defined(_ENABLE_OBSERVINGCONDITIONS_)
-	CreateObsConditionObjects();
-//	CreateObsConditionRpiObjects();
-	DEBUG_TIMING("Time to create obs-condition objects (ms)=");
+	static int	Probe_ObsConditions(void)	{	SimulatedProbeDelay();	CreateObsConditionObjects();	return(0);	}
 #endif
-
-//------------------------------------------------------
-//*	rotator objects
 #ifdef _ENABLE_ROTATOR_
-	CreateRotatorObjects();
-	DEBUG_TIMING("Time to create rotator objects (ms)=");
+	static int	Probe_Rotator(void)			{	SimulatedProbeDelay();	CreateRotatorObjects();			return(0);	}
 #endif
+#ifdef _ENABLE_SHUTTER_
+	static int	Probe_Shutter(void)			{	SimulatedProbeDelay();	CreateShuterArduinoObjects();	return(0);	}
+#endif
+#ifdef _ENABLE_SLIT_TRACKER_
+	static int	Probe_SlitTracker(void)		{	SimulatedProbeDelay();	CreateSlitTrackerObjects();		return(0);	}
+#endif
+#if defined(_ENABLE_SWITCH_)
+	static int	Probe_Switch(void)			{	SimulatedProbeDelay();	CreateSwitchObjects();			return(0);	}
+#endif
+#ifdef _ENABLE_TELESCOPE_
+	static int	Probe_Telescope(void)		{	SimulatedProbeDelay();	return(CreateTelescopeObjects());		}
+#endif
+#ifdef _ENABLE_SPECTROGRAPH_
+	static int	Probe_Spectrograph(void)	{	SimulatedProbeDelay();	CreateSpectrographObjects();	return(0);	}
+#endif
+
+//*****************************************************************************
+//*	claimsPorts = the probe opens serial/USB ports, these run one at a time
+//*	in the order they are added so they always get the same ports
+//*****************************************************************************
+static void	AddStartupProbe(const char *probeName, PROBE_FUNCTION probeFunc, const int timeout_ms, const bool claimsPorts=false)
+{
+#ifdef _ENABLE_PARALLEL_STARTUP_
+	if (claimsPorts)
+	{
+		StartupProbe_AddPortProbe(probeName, probeFunc, timeout_ms);
+	}
+	else
+	{
+		StartupProbe_Add(probeName, probeFunc, timeout_ms);
+	}
+#else
+int		returnValue;
 
+	(void)claimsPorts;
+	returnValue	=	probeFunc();
+	CONSOLE_DEBUG_W_NUM(probeName, returnValue);
+#endif // _ENABLE_PARALLEL_STARTUP_
+}
 
-//------------------------------------------------------
-//*	Shutter
+//*****************************************************************************
+//*	The probes are independent of each other and run at the same time,
+//*	the devices they create are added to the device list in the order the
+//*	probes are added here, no matter which one finishes first.
+//*	The USB table and the drivers that open serial/USB ports are port probes,
+//*	they run one after another in this order, the same as before the probes
+//*	were run in parallel
+//*****************************************************************************
+static void	CreateDriverObjects()
+{
+	SETUP_TIMING();
+
+	AddStartupProbe("USB table",		Probe_USB,				kProbeDefaultTimeout_ms,	true);
+#ifdef _ENABLE_CAMERA_
+	CreateCameraObjects_Begin();
+	AddStartupProbe("Cameras ATIK/ASI",	Probe_Cameras_ATIK_ASI,	(2 * kProbeDefaultTimeout_ms));
+	#ifdef _ENABLE_FLIR_
+	AddStartupProbe("Camera FLIR",		Probe_Camera_FLIR,		kProbeDefaultTimeout_ms);
+	#endif
+	#ifdef _ENABLE_PHASEONE_
+	AddStartupProbe("Camera PhaseOne",	Probe_Camera_PhaseOne,	kProbeDefaultTimeout_ms);
+	#endif
+	#ifdef _ENABLE_CAMERA_PLAYERONE_
+	AddStartupProbe("Camera PlayerOne",	Probe_Camera_PlayerOne,	kProbeDefaultTimeout_ms);
+	#endif
+	#ifdef _ENABLE_QHY_
+	AddStartupProbe("Camera QHY",		Probe_Camera_QHY,		kProbeDefaultTimeout_ms);
+	#endif
+	#ifdef _ENABLE_QSI_
+	AddStartupProbe("Camera QSI",		Probe_Camera_QSI,		kProbeDefaultTimeout_ms);
+	#endif
+	#ifdef _ENABLE_TOUP_
+	AddStartupProbe("Camera TOUP",		Probe_Camera_TOUP,		kProbeDefaultTimeout_ms);
+	#endif
+	#ifdef	_ENABLE_OGMA_
+	AddStartupProbe("Camera OGMA",		Probe_Camera_OGMA,		kProbeDefaultTimeout_ms);
+	#endif
+	#ifdef _ENABLE_SONY_
+	AddStartupProbe("Camera SONY",		Probe_Camera_SONY,		kProbeDefaultTimeout_ms);
+	#endif
+	#ifdef _ENABLE_CAMERA_SIMULATOR_
+	AddStartupProbe("Camera simulator",	Probe_Camera_Sim,		kProbeDefaultTimeout_ms);
+	#endif
+#endif
+#if _ENABLE_CALIBRATION_
+	AddStartupProbe("Calibration",		Probe_Calibration,		kProbeDefaultTimeout_ms,	true);
+#endif
+#ifdef _ENABLE_DOME_
+	AddStartupProbe("Dome",				Probe_Dome,				kProbeDefaultTimeout_ms);
+#endif
+#ifdef _ENABLE_FILTERWHEEL_
+	AddStartupProbe("Filter wheel",		Probe_FilterWheel,		kProbeDefaultTimeout_ms,	true);
+#endif
+#ifdef _ENABLE_FOCUSER_
+	AddStartupProbe("Focuser",			Probe_Focuser,			kProbeDefaultTimeout_ms,	true);
+#endif
+#if defined(_ENABLE_OBSERVINGCONDITIONS_)
+	AddStartupProbe("Obs conditions",	Probe_ObsConditions,	kProbeDefaultTimeout_ms);
+#endif
+#ifdef _ENABLE_ROTATOR_
+	AddStartupProbe("Rotator",			Probe_Rotator,			kProbeDefaultTimeout_ms,	true);
+#endif
 #ifdef _ENABLE_SHUTTER_
-//	CreateShutterObjects();
-	CreateShuterArduinoObjects();
-	DEBUG_TIMING("Time to create shutter objects (ms)=");
+	AddStartupProbe("Shutter",			Probe_Shutter,			kProbeDefaultTimeout_ms,	true);
 #endif
-
-//------------------------------------------------------
-//*	Slit tacker
 #ifdef _ENABLE_SLIT_TRACKER_
-	CreateSlitTrackerObjects();
-	DEBUG_TIMING("Time to create slit-tracker objects (ms)=");
-#endif // _ENABLE_SLIT_TRACKER_
-
-//------------------------------------------------------
-//*	Switch
+	AddStartupProbe("Slit tracker",		Probe_SlitTracker,		kProbeDefaultTimeout_ms,	true);
+#endif
 #if defined(_ENABLE_SWITCH_)
-	CreateSwitchObjects();
-	DEBUG_TIMING("Time to create switch objects (ms)=");
+	AddStartupProbe("Switch",			Probe_Switch,			kProbeDefaultTimeout_ms);
 #endif
-
-//------------------------------------------------------
-//*	Telescope
 #ifdef _ENABLE_TELESCOPE_
-	CreateTelescopeObjects();
-	DEBUG_TIMING("Time to create telescope objects (ms)=");
-#endif // _ENABLE_TELESCOPE_
+	AddStartupProbe("Telescope",		Probe_Telescope,		kProbeDefaultTimeout_ms,	true);
+#endif
+#ifdef _ENABLE_SPECTROGRAPH_
+	AddStartupProbe("Spectrograph",		Probe_Spectrograph,		kProbeDefaultTimeout_ms);
+#endif
+
+#ifdef _ENABLE_PARALLEL_STARTUP_
+	StartupProbe_RunAll(RegisterProbedDevice);
+	StartupProbe_PrintReport();
+#endif // _ENABLE_PARALLEL_STARTUP_
+#ifdef _ENABLE_CAMERA_
+	CreateCameraObjects_End();
+#endif
+	DEBUG_TIMING("Time to run startup probes (ms)=");
 
 //------------------------------------------------------
-#ifdef _ENABLE_SPECTROGRAPH_
-	CreateSpectrographObjects();
-	DEBUG_TIMING("Time to create spectrograph objects (ms)=");
+//*	Multicam, needs to know how many cameras there are
+#ifdef _ENABLE_MULTICAM_
+int		cameraCnt	=	0;
+	cameraCnt	=	CountDevicesByType(kDeviceType_Camera);
+	CONSOLE_DEBUG_W_NUM("total cameras created\t=", cameraCnt);
+	if (cameraCnt > 1)
+	{
+		CreateMultiCamObject();
+	}
+	DEBUG_TIMING("Time to create multicam objects (ms)=");
 #endif
 
 //------------------------------------------------------
@@ -5102,6 +5294,11 @@ float	fitsVersion;
 
 	InitObsConditionGloblas();
 	ProcessCmdLineArgs(argc, argv);
+	//*	resolve the time series and state store paths before anything changes directory
+	CONSOLE_DEBUG_W_STR("Time series store\t=", TimeSeries_GetFilePath());
+#ifdef _ENABLE_SWITCH_
+	CONSOLE_DEBUG_W_STR("Switch state store\t=", StateStore_GetFilePath());
+#endif
 
 //	CONSOLE_DEBUG_W_INT32("sizeof(int)\t=",		(long)sizeof(int));
 //	CONSOLE_DEBUG_W_INT32("sizeof(long)\t=",	(long)sizeof(long));
@@ -5136,6 +5333,8 @@ int	imu_ReturnCode;
 		IMU_Print_Calibration();
 		IMU_SetDebug(false);
 		gIMUisOnLine	=	true;
+		//*	the drivers read the averages, not the sensor
+		IMU_StartBackgroundThread(NULL);
 	}
 	else
 	{
@@ -5212,6 +5411,11 @@ int	imu_ReturnCode;
 	while (gKeepRunning)
 	{
 		mainLoopCntr++;
+	#ifdef _ENABLE_PARALLEL_STARTUP_
+		//*	devices from probes that finished after their time out,
+		//*	added here so the list never changes while this loop is walking it
+		StartupProbe_RegisterLate();
+	#endif // _ENABLE_PARALLEL_STARTUP_
 		delayTime_microSecs	=	(1000000 / 2);		//*	default to 1/2 second
 		for (iii=0; iii<gDeviceCnt; iii++)
 		{
@@ -5227,6 +5431,7 @@ int	imu_ReturnCode;
 					startNanoSecs			=	MSecTimer_getNanoSecs();
 
 					delayTimeForThisTask	=	gAlpacaDeviceList[iii]->RunStateMachine();
+					gAlpacaDeviceList[iii]->PublishStateSnapshot();
 					endNanoSecs				=	MSecTimer_getNanoSecs();
 					deltaNanoSecs			=	endNanoSecs - startNanoSecs;
 
@@ -5900,31 +6105,14 @@ int			returnCode;
 			//*	determine the extension
 			ExtractFileExtension(filePath, fileExtension);
 			CONSOLE_DEBUG_W_STR("fileExtension\t=", fileExtension);
-			if (strcasecmp(fileExtension, ".jpg") == 0)
+			if ((strcasecmp(fileExtension, ".jpg") == 0) || (strcasecmp(fileExtension, ".png") == 0))
 			{
-				SendJpegResponse(mySocketFD, filePath);
-			}
-			else if (strcasecmp(fileExtension, ".png") == 0)
-			{
-				SendJpegResponse(mySocketFD, filePath);
+				SendJpegResponse(mySocketFD, filePath, reqData->htmlData);
 			}
 			else
 			{
-				//*	check the file type and send the appropriate header
-				if (strcasecmp(fileExtension, ".js") == 0)
-				{
-					SocketWriteData(mySocketFD,	gHtmlHeader_js);
-				}
-				else if (strcasecmp(fileExtension, ".css") == 0)
-				{
-					SocketWriteData(mySocketFD,	gHtmlHeader_css);
-				}
-				else
-				{
-					SocketWriteData(mySocketFD,	gHtmlHeader_html);
-				}
-				//*	send the file to the socket
-				SendFileToSocket(mySocketFD, filePath);
+				//*	the content type comes from the extension
+				StaticFile_Send(mySocketFD, filePath, reqData->htmlData);
 			}
 		}
 		else
@@ -32,6 +32,9 @@
 //*	Nov 28,	2022	<MLS> Added cLastDeviceErrMsg
 //*	Sep 20,	2023	<MLS> Moved camera read thread to base class
 //*	Apr 29,	2024	<MLS> Added cSendJSONresponse to handle setupdialog
+//*	Oct 18,	2026	<MLS> Added PublishStateSnapshot()
+//*	Oct 18,	2026	<MLS> Added TimeSeries_Log() and Get_TimeSeries()
+//*	Oct 18,	2026	<MLS> Added AddToDeviceList()
 //*****************************************************************************
 //#include	"alpacadriver.h"
 
@@ -184,6 +187,8 @@ class AlpacaDriver
 
 		virtual	int32_t	RunStateMachine(void);	//*	returns delay time in micro-seconds
 		virtual int		UpdateProperties(void);
+		virtual	void	PublishStateSnapshot(void);	//*	see devicestate_snapshot.c
+				void	AddToDeviceList(void);		//*	see startup_probes.c
 
 
 		virtual	bool	AlpacaConnect(void);	//*	Connect and Disconnect names conflicted with other libraries
@@ -342,6 +347,12 @@ class AlpacaDriver
 				char				cTempLogDescription[32];
 				double				cTemperatureLog[kTemperatureLogEntries + 10];
 				uint32_t			cLastTempUpdate_Secs;
+				int					cTempLogChannel;		//*	time series channel handle
+
+		//-------------------------------------------------------------------------
+		//*	time series store, see timeseries_store.c
+				void				TimeSeries_Log(int *channelHandle, const char *channelName, const double value);
+				TYPE_ASCOM_STATUS	Get_TimeSeries(			TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
 
 
 
@@ -27,6 +27,10 @@
 //*	Oct 16,	2022	<MLS> Added TemperatureLog_Init()
 //*	Oct 16,	2022	<MLS> Added TemperatureLog_AddEntry()
 //*	Oct 16,	2022	<MLS> Added Get_TemperatureLog()
+//*	Oct 18,	2026	<MLS> Get_TemperatureLog() no longer uses strcat/strlen for each entry
+//*	Oct 18,	2026	<MLS> Added TimeSeries_Log() and Get_TimeSeries()
+//*	Oct 18,	2026	<MLS> TimeSeries_Log() resolves the channel once and keeps the handle
+//*	Oct 18,	2026	<MLS> Get_TemperatureLog() clamps to the buffer, no blank line at the end
 //*****************************************************************************
 
 #include	<stdio.h>
@@ -38,6 +42,7 @@
 #include	"JsonResponse.h"
 #include	"alpacadriver.h"
 #include	"alpacadriver_helper.h"
+#include	"timeseries_store.h"
 
 #define _ENABLE_CONSOLE_DEBUG_
 #include	"ConsoleDebug.h"
@@ -53,6 +58,7 @@ void	AlpacaDriver::TemperatureLog_Init(void)
 
 	memset((void *)cTemperatureLog, 0, sizeof(cTemperatureLog));
 	strcpy(cTempLogDescription, "unknown");
+	cTempLogChannel	=	kTS_NotRegistered;
 
 	cLastTempUpdate_Secs	=	GetSecondsSinceEpoch();
 }
@@ -61,6 +67,7 @@ void	AlpacaDriver::TemperatureLog_Init(void)
 void	AlpacaDriver::TemperatureLog_SetDescription(const char *description)
 {
 	strcpy(cTempLogDescription, description);
+	cTempLogChannel	=	kTS_NotRegistered;
 }
 
 //*****************************************************************************
@@ -75,6 +82,7 @@ int		minutesSinceMidnight;
 	{
 		cTemperatureLog[minutesSinceMidnight]	=	temperatureEntry;
 	}
+	TimeSeries_Log(&cTempLogChannel, cTempLogDescription, temperatureEntry);
 }
 
 //*****************************************************************************
@@ -87,6 +95,7 @@ char				longBuffer[2048];
 char				lineBuff[128];
 int					bytesWritten;
 int					bufLen;
+int					entryLen;
 int					dataElementCnt;
 char				httpHeader[500];
 
@@ -109,34 +118,33 @@ char				httpHeader[500];
 	//*	Flush the json buffer
 	JsonResponse_SendTextBuffer(mySocket, reqData->jsonTextBuffer);
 
-	strcpy(longBuffer, "\n");
+	longBuffer[0]	=	'\n';
+	bufLen			=	1;
 
-	//*	stop at n-1 so we can do the last one without a comma
+	//*	keep track of the length as we go instead of strcat/strlen on each entry
 	dataElementCnt	=	0;
-	for (iii =0; iii< (kTemperatureLogEntries - 1); iii++)
+	for (iii =0; iii< kTemperatureLogEntries; iii++)
 	{
-		sprintf(lineBuff, "%3.2f,", cTemperatureLog[iii]);
-		strcat(longBuffer, lineBuff);
+		entryLen	=	snprintf(&longBuffer[bufLen], (sizeof(longBuffer) - bufLen), "%3.2f%s",
+								cTemperatureLog[iii],
+								((iii < (kTemperatureLogEntries - 1)) ? "," : "\n"));
+		//*	snprintf returns the length it wanted, not what fit
+		if ((entryLen > 0) && (entryLen < (int)(sizeof(longBuffer) - bufLen)))
+		{
+			bufLen	+=	entryLen;
+		}
 		dataElementCnt++;
-		if (dataElementCnt > 25)
+		if ((dataElementCnt > 25) && (iii < (kTemperatureLogEntries - 1)) && (bufLen < (int)sizeof(longBuffer)))
 		{
-			strcat(longBuffer, "\n");
-			dataElementCnt	=	0;
+			longBuffer[bufLen++]	=	'\n';
+			dataElementCnt			=	0;
 		}
-		bufLen	=	strlen(longBuffer);
-
 		if (bufLen > 1800)
 		{
-			bufLen			=	strlen(longBuffer);
 			bytesWritten	=	write(mySocket, longBuffer, bufLen);
-			longBuffer[0]	=	0;
+			bufLen			=	0;
 		}
 	}
-	//*	now do the last one WITHOUT the comma
-	sprintf(lineBuff, "%3.2f", cTemperatureLog[iii]);
-	strcat(lineBuff, "\n");
-	strcat(longBuffer, lineBuff);
-	bufLen			=	strlen(longBuffer);
 	bytesWritten	=	write(mySocket, longBuffer, bufLen);
 	if (bytesWritten <= 0)
 	{
@@ -148,3 +156,180 @@ char				httpHeader[500];
 															INCLUDE_COMMA);
 	return(alpacaErrCode);
 }
+
+//*****************************************************************************
+//*	channels are named by device, i.e. "camera0-CoolerPower"
+//*	channelHandle starts out as kTS_NotRegistered, the channel table is only
+//*	searched the first time, after that the sample goes straight to the ring
+//*****************************************************************************
+void	AlpacaDriver::TimeSeries_Log(int *channelHandle, const char *channelName, const double value)
+{
+char	fullChannelName[kTS_ChannelNameLen];
+
+	if (*channelHandle == kTS_NotRegistered)
+	{
+		snprintf(fullChannelName, sizeof(fullChannelName), "%s%d-%s", cAlpacaDeviceString, cAlpacaDeviceNum, channelName);
+		*channelHandle	=	TimeSeries_GetChannel(fullChannelName);
+	}
+	TimeSeries_Append(*channelHandle, value);
+}
+
+//*****************************************************************************
+static int	GetTimeSeriesLevel(const char *levelString)
+{
+int		level;
+
+	level	=	-1;
+	if (strcasecmp(levelString, "raw") == 0)
+	{
+		level	=	kTS_Level_Raw;
+	}
+	else if (strcasecmp(levelString, "1s") == 0)
+	{
+		level	=	kTS_Level_1Sec;
+	}
+	else if (strcasecmp(levelString, "1m") == 0)
+	{
+		level	=	kTS_Level_1Min;
+	}
+	else if (strcasecmp(levelString, "15m") == 0)
+	{
+		level	=	kTS_Level_15Min;
+	}
+	return(level);
+}
+
+//*****************************************************************************
+//*	without a channel, returns the list of channels as json
+//*	with a channel, returns a binary TYPE_TS_QueryHdr followed by TYPE_TS_Point entries
+//*		channel=camera0-CoolerPower&start=<secs>&end=<secs>&level=raw|1s|1m|15m
+//*	start defaults to 1 hour ago, end defaults to now, level defaults to the finest
+//*	level that covers the start time
+//*****************************************************************************
+TYPE_ASCOM_STATUS	AlpacaDriver::Get_TimeSeries(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
+{
+TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_Success;
+int					mySocket;
+char				channelName[kTS_ChannelNameLen];
+char				argumentString[64];
+char				lineBuff[256];
+char				httpHeader[500];
+int					channelIdx;
+int					channelCnt;
+int					level;
+int					iii;
+int64_t				currentTime_us;
+TYPE_TS_QueryHdr	queryHdr;
+TYPE_TS_Point		*pointBuffer;
+int					pointCnt;
+int					maxPoints;
+int					headerLen;
+ssize_t				bytesWritten;
+
+	mySocket	=	reqData->socket;
+	if (GetKeyWordArgument(reqData->contentData, "channel", channelName, sizeof(channelName)) == false)
+	{
+		//*	no channel specified, return the list of channels
+		channelCnt	=	TimeSeries_GetChannelCount();
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_ArrayStart(	mySocket,
+																	reqData->jsonTextBuffer,
+																	kMaxJsonBuffLen,
+																	gValueString);
+		for (iii=0; iii<channelCnt; iii++)
+		{
+			if (TimeSeries_GetChannelName(iii, channelName))
+			{
+				snprintf(lineBuff, sizeof(lineBuff), "\t\t\t{\"channel\":\"%s\",\"samples\":%llu}%s\r\n",
+														channelName,
+														(unsigned long long)TimeSeries_GetSampleCount(iii),
+														((iii < (channelCnt - 1)) ? "," : ""));
+				cBytesWrittenForThisCmd	+=	JsonResponse_Add_RawText(	mySocket,
+																		reqData->jsonTextBuffer,
+																		kMaxJsonBuffLen,
+																		lineBuff);
+			}
+		}
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_ArrayEnd(	mySocket,
+																reqData->jsonTextBuffer,
+																kMaxJsonBuffLen,
+																INCLUDE_COMMA);
+		return(alpacaErrCode);
+	}
+
+	channelIdx	=	-1;
+	channelCnt	=	TimeSeries_GetChannelCount();
+	for (iii=0; iii<channelCnt; iii++)
+	{
+		if (TimeSeries_GetChannelName(iii, argumentString) && (strcasecmp(argumentString, channelName) == 0))
+		{
+			channelIdx	=	iii;
+			break;
+		}
+	}
+	if (channelIdx < 0)
+	{
+		alpacaErrCode	=	kASCOM_Err_InvalidValue;
+		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Unknown channel");
+		return(alpacaErrCode);
+	}
+
+	memset(&queryHdr, 0, sizeof(TYPE_TS_QueryHdr));
+	currentTime_us		=	TimeSeries_GetTime_us();
+	queryHdr.end_us		=	currentTime_us;
+	queryHdr.start_us	=	currentTime_us - (3600LL * 1000000LL);
+	if (GetKeyWordArgument(reqData->contentData, "start", argumentString, sizeof(argumentString)))
+	{
+		queryHdr.start_us	=	(int64_t)(atof(argumentString) * 1000000.0);
+	}
+	if (GetKeyWordArgument(reqData->contentData, "end", argumentString, sizeof(argumentString)))
+	{
+		queryHdr.end_us	=	(int64_t)(atof(argumentString) * 1000000.0);
+	}
+	level	=	TimeSeries_GetBestLevel(channelIdx, queryHdr.start_us);
+	if (GetKeyWordArgument(reqData->contentData, "level", argumentString, sizeof(argumentString)))
+	{
+		level	=	GetTimeSeriesLevel(argumentString);
+		if (level < 0)
+		{
+			alpacaErrCode	=	kASCOM_Err_InvalidValue;
+			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "level must be raw, 1s, 1m or 15m");
+			return(alpacaErrCode);
+		}
+	}
+
+	maxPoints	=	(level == kTS_Level_Raw) ? kTS_RawEntries : (kTS_RollupEntries + 1);
+	pointBuffer	=	(TYPE_TS_Point *)malloc(maxPoints * sizeof(TYPE_TS_Point));
+	if (pointBuffer == NULL)
+	{
+		alpacaErrCode	=	kASCOM_Err_FailedUnknown;
+		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Failed to allocate memory");
+		return(alpacaErrCode);
+	}
+	pointCnt	=	TimeSeries_Query(channelIdx, level, queryHdr.start_us, queryHdr.end_us, pointBuffer, maxPoints);
+
+	queryHdr.magic		=	kTS_Magic;
+	queryHdr.version	=	kTS_Version;
+	queryHdr.headerSize	=	sizeof(TYPE_TS_QueryHdr);
+	queryHdr.pointSize	=	sizeof(TYPE_TS_Point);
+	queryHdr.level		=	level;
+	queryHdr.pointCnt	=	pointCnt;
+
+	//*	the response is binary, no json
+	cSendJSONresponse	=	false;
+	cHttpHeaderSent		=	true;
+	headerLen	=	snprintf(httpHeader, sizeof(httpHeader),	"HTTP/1.0 200 OK\r\n"
+																"Content-Length: %d\r\n"
+																"Content-type: application/octet-stream\r\n"
+																"Server: AlpacaPi\r\n"
+																"\r\n",
+										(int)(sizeof(TYPE_TS_QueryHdr) + (pointCnt * sizeof(TYPE_TS_Point))));
+	bytesWritten	=	write(mySocket, httpHeader, headerLen);
+	bytesWritten	+=	write(mySocket, &queryHdr, sizeof(TYPE_TS_QueryHdr));
+	if (pointCnt > 0)
+	{
+		bytesWritten	+=	write(mySocket, pointBuffer, (pointCnt * sizeof(TYPE_TS_Point)));
+	}
+	cBytesWrittenForThisCmd	+=	bytesWritten;
+	free(pointBuffer);
+	return(alpacaErrCode);
+}
@@ -94,6 +94,12 @@ TYPE_CmdEntry	gCameraCmdTable[]	=
 	{	"flip",						kCmd_Camera_flip,					kCmdType_BOTH	},
 	{	"framerate",				kCmd_Camera_framerate,				kCmdType_GET	},
 	{	"livemode",					kCmd_Camera_livemode,				kCmdType_BOTH	},
+#ifdef _ENABLE_MJPEG_STREAM_
+	{	"mjpegstream",				kCmd_Camera_mjpegstream,			kCmdType_GET	},
+#endif
+#ifdef _ENABLE_PREVIEW_PYRAMID_
+	{	"preview",					kCmd_Camera_preview,				kCmdType_GET	},
+#endif
 	{	"rgbarray",					kCmd_Camera_rgbarray,				kCmdType_GET	},
 	{	"saveallimages",			kCmd_Camera_saveallimages,			kCmdType_BOTH	},
 
@@ -113,6 +113,12 @@ enum
 	kCmd_Camera_flip,
 	kCmd_Camera_framerate,
 	kCmd_Camera_livemode,
+#ifdef _ENABLE_MJPEG_STREAM_
+	kCmd_Camera_mjpegstream,
+#endif
+#ifdef _ENABLE_PREVIEW_PYRAMID_
+	kCmd_Camera_preview,
+#endif
 	kCmd_Camera_rgbarray,
 	kCmd_Camera_settelescopeinfo,
 	kCmd_Camera_saveallimages,
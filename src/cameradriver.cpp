@@ -220,6 +220,38 @@
 //*	Jun 28,	2024	<MLS> Removed all "if (reqData != NULL)" from cameradriver.cpp
 //*	Jul  6,	2024	<EZT> Several fixes dealing with tranmitted data size of binary image data
 //*	Nov 22,	2024	<MLS> Reverted back to 8 bit RGB binary images, need 32 bit official simulator to fully test
+//*	Oct 18,	2026	<MLS> Added SyncExposure_Arm() & SyncExposure_Trigger() for multicam synchronized start
+//*	Oct 18,	2026	<MLS> SyncExposure_Arm() removed, sync start time is taken after the SDK start returns
+//*	Oct 18,	2026	<MLS> SyncExposure_Arm() is back, all setup is done before the start gate
+//*	Oct 18,	2026	<MLS> Added pipelined (zero gap) sequences, sensor is re-armed as soon as readout is done
+//*	Oct 18,	2026	<MLS> Added sequence duty cycle reporting (Sequence_UpdateDutyCycle())
+//*	Oct 18,	2026	<MLS> GenerateFileNameRoot() gets the filter name from the filter wheel snapshot
+//*	Oct 18,	2026	<MLS> Added PublishSharedMemoryFrame() (_ENABLE_SHM_FRAMES_)
+//*	Oct 18,	2026	<MLS> Cooler power is logged to the time series store
+//*	Oct 18,	2026	<MLS> Exposure start time is also taken from the GPS PPS when available
+//*	Oct 18,	2026	<MLS> Added mjpegstream command and PublishMJPEGframe() (_ENABLE_MJPEG_STREAM_)
+//*	Oct 18,	2026	<MLS> Added preview command and BuildPreviewPyramid() (_ENABLE_PREVIEW_PYRAMID_)
+//*	Oct 18,	2026	<MLS> Added imagearray x,y,width,height,bin subframe download (GetImageWindow())
+//*	Oct 18,	2026	<MLS> imagearray ImageBytes supports Range / If-Range, 206 responses
+//*	Oct 18,	2026	<MLS> rgbarray honors Accept: application/imagebytes (Get_RGBarray_Binary())
+//*	Oct 18,	2026	<MLS> BuildBinaryImage_xxx() use the pixel_convert SIMD conversions
+//*	Oct 18,	2026	<MLS> Added opencv-allocs & opencv-bytescopied to readall
+//*	Oct 18,	2026	<MLS> filelist is served from the file index, added cursor, limit, type, start, end & detail
+//*	Oct 18,	2026	<MLS> fitsheader is served from the FITS header cache, added frame & format
+//*	Oct 18,	2026	<MLS> Web page shows the FITS header of the current frame
+//*	Oct 18,	2026	<MLS> Pipelined sequences keep ImageReady, per frame exposure info, MinDutyCycle is enforced
+//*	Oct 18,	2026	<MLS> MinDutyCycle only sets sequence-dutycycle-ok, no more mode switch or early stop
+//*	Oct 18,	2026	<MLS> Frame publishing after the re-arm, the preview pyramid is built after the first preview request
+//*	Oct 18,	2026	<MLS> Get_RGBarray_Binary() uses the frame geometry (cFrameExpInfo), it is in the ETag
+//*	Oct 18,	2026	<MLS> Shared memory ring creation backs off after a failure
+//*	Oct 18,	2026	<MLS> Added TemperatureLog_Update(), one place logs temperature and cooler power
+//*	Oct 18,	2026	<MLS> readall IMU values come from the IMU background averages
+//*	Oct 18,	2026	<MLS> Split CreateCameraObjects() so each vendor can be its own startup probe
+//*	Oct 18,	2026	<MLS> rgbarray ImageBytes: standard layout only, 16 bit stays 16 bit, cached for Range requests
+//*	Oct 18,	2026	<MLS> Added opencv-frame_us & opencv-save_us to readall
+//*	Oct 18,	2026	<MLS> Indexed filelist is newest first, order=oldest, json escaped detail strings
+//*	Oct 18,	2026	<MLS> The ImageBytes cache is freed when the next exposure starts
+//*	Oct 18,	2026	<MLS> Get_Imagearray_Binary() reports a short send as kASCOM_Err_DataFailure
 //*****************************************************************************
 //*	Jan  1,	2119	<TODO> ----------------------------------------
 //*	Jun 26,	2119	<TODO> Add support for sub frames
@@ -271,6 +303,10 @@
 	#include "imu_lib_bno055.h"
 #endif
 
+#ifdef _ENABLE_GLOBAL_GPS_
+	#include	"gps_data.h"
+#endif
+
 #include	"JsonResponse.h"
 #include	"eventlogging.h"
 #include	"helper_functions.h"
@@ -282,6 +318,8 @@
 #include	"alpacadriver.h"
 #include	"alpacadriver_helper.h"
 #include	"cameradriver.h"
+#include	"devicestate_snapshot.h"
+#include	"timeseries_store.h"
 #ifdef _ENABLE_FITS_
 	#include	"cameradriver_auxinfo.h"
 #endif // _ENABLE_FITS_
@@ -334,6 +372,11 @@
 
 #include	"camera_AlpacaCmds.h"
 #include	"camera_AlpacaCmds.cpp"
+#ifdef _ENABLE_MJPEG_STREAM_
+	#include	"socket_listen.h"
+#endif
+#include	"static_files.h"
+#include	"pixel_convert.h"
 #include	"NASA_moonphase.h"
 
 
@@ -341,24 +384,51 @@ char	gImageDataDir[256]		=	kImageDataDir_Default;
 
 
 //*****************************************************************************
-//*	returns number of camera objects created
+//*	The startup probes run each camera vendor in its own thread,
+//*	CreateCameraObjects_Begin() is called before them and CreateCameraObjects_End() after
 //*****************************************************************************
-int	CreateCameraObjects(void)
+void	CreateCameraObjects_Begin(void)
+{
+	NASA_ReadMoonPhaseData();
+}
+
+//*****************************************************************************
+void	CreateCameraObjects_End(void)
+{
+#ifdef _ENABLE_FITS_
+	AuxInfo_StartThread();
+#endif // _ENABLE_FITS_
+}
+
+//*****************************************************************************
+//*	ATIK needs to be before ASI for multiple camera starts, they stay together
+//*****************************************************************************
+int	CreateCameraObjects_ATIK_ASI(void)
 {
 int	cameraCnt;
 
-	NASA_ReadMoonPhaseData();
 	cameraCnt	=	0;
-
-//-----------------------------------------------------------
-//*	ATIK needs to be before ASI for multiple camera starts
 #ifdef _ENABLE_ATIK_
 	cameraCnt	+=	CreateCameraObjects_ATIK();
 #endif
-//-----------------------------------------------------------
 #ifdef _ENABLE_ASI_
 	cameraCnt	+=	CreateCameraObjects_ASI();
 #endif
+	return(cameraCnt);
+}
+
+//*****************************************************************************
+//*	returns number of camera objects created
+//*****************************************************************************
+int	CreateCameraObjects(void)
+{
+int	cameraCnt;
+
+	CreateCameraObjects_Begin();
+	cameraCnt	=	0;
+
+//-----------------------------------------------------------
+	cameraCnt	+=	CreateCameraObjects_ATIK_ASI();
 //-----------------------------------------------------------
 //#ifdef _ENABLE_FLIR_) && (__GNUC__ > 5)
 #ifdef _ENABLE_FLIR_
@@ -397,9 +467,7 @@ int	cameraCnt;
 	cameraCnt	+=	CreateCameraObjects_Sim();
 #endif
 
-#ifdef _ENABLE_FITS_
-	AuxInfo_StartThread();
-#endif // _ENABLE_FITS_
+	CreateCameraObjects_End();
 	return(cameraCnt);
 }
 
@@ -491,6 +559,7 @@ char		myImageDataDir[]	=	"/media/pi/rpdata/imagedata";
 	cCameraIsSiumlated				=	false;
 	cUpdateOtherDevices				=	true;
 	cTempReadSupported				=	false;
+	cCoolerPowerChannel				=	kTS_NotRegistered;
 	cOffsetSupported				=	false;
 	cSubDurationSupported			=	false;
 	cLastCameraErrMsg[0]			=	0;
@@ -537,6 +606,16 @@ char		myImageDataDir[]	=	"/media/pi/rpdata/imagedata";
 	cAutoAdjustStepSz_us			=	5;
 	cSequenceDelay_us				=	0;
 	cSeqDeltaExposure_us			=	0;
+	cSeqPipelined					=	false;
+	cSeqMinDutyCycle				=	0.0;
+	cSeqDutyCycleOK					=	true;
+	cSeqDutyCycle					=	0.0;
+	cSeqExposing_us					=	0;
+	cSeqWall_us						=	0;
+	memset(&cSeqStartTime, 0, sizeof(struct timeval));
+	cSeqDutyFrameCnt				=	0;
+	cSeqOverlap_us					=	0;
+	memset(&cFrameExpInfo, 0, sizeof(TYPE_FRAME_EXPOSURE_INFO));
 	cCameraAutoExposure				=	false;
 	cCurrentExposure_us				=	1000;
 	cExposureFailureCnt				=	0;
@@ -544,6 +623,29 @@ char		myImageDataDir[]	=	"/media/pi/rpdata/imagedata";
 	cSaveAllImages					=	false;
 	cSaveNextImage					=	false;
 	cNewImageReadyToDisplay			=	false;
+	cSyncStartValid					=	false;
+	cExposureStartPPSvalid			=	false;
+	cSyncStartOffset_us				=	0;
+	cSyncSkew_us					=	0;
+	cSyncLatency_us					=	0;
+#ifdef _ENABLE_SHM_FRAMES_
+	cShmFrameRing					=	NULL;
+	cShmFramesPublished				=	0;
+	cShmRingFailTime_ms				=	0;
+#endif
+#ifdef _ENABLE_MJPEG_STREAM_
+	cMJPEGstream					=	NULL;
+#endif
+#ifdef _ENABLE_PREVIEW_PYRAMID_
+	cPreviewPyramid					=	NULL;
+#endif
+	cImageBytesCache				=	NULL;
+	cImageBytesCacheLen				=	0;
+	cImageBytesETag[0]				=	0;
+	cImageBytesFrameNum				=	0;
+	cImageBytesSending				=	false;
+	memset(&cImageBytesExpStart, 0, sizeof(struct timeval));
+	pthread_mutex_init(&cImageBytesMutex, NULL);
 	cWorkingLoopCnt					=	0;
 
 
@@ -554,6 +656,14 @@ char		myImageDataDir[]	=	"/media/pi/rpdata/imagedata";
 	cOpenCV_Histogram				=	NULL;
 	cCreateHistogramWindow			=	true;
 	cOpenCV_videoWriter				=	NULL;
+#if !defined(_USE_OPENCV_CPP_) && (CV_MAJOR_VERSION < 4)
+	cOpenCV_LiveSmallPtr			=	NULL;
+#endif
+	cOpenCV_ImageWrapsBuffer		=	false;
+	cOpenCV_FrameAllocCnt			=	0;
+	cOpenCV_FrameBytesCopied		=	0;
+	cOpenCV_FrameTime_us			=	0;
+	cOpenCV_SaveTime_us				=	0;
 	strcpy(cOpenCV_ImgWindowName, "opencv");	//*	this gets overwritten by the sub class
 	cOpenCV_ImgWindowValid			=	false;
 	cDisplayCrossHairs				=	false;
@@ -649,12 +759,7 @@ char		myImageDataDir[]	=	"/media/pi/rpdata/imagedata";
 	cFilterWheelInfoValid	=	false;
 
 #ifdef _ENABLE_FITS_
-int	iii;
-	//*	initialize the fits header data
-	for (iii = 0; iii < kMaxFitsRecords; iii++)
-	{
-		strcpy(cFitsHeader[iii].fitsRec, "");
-	}
+	cFitsHdrCache	=	FitsHdrCache_Create();
 #endif // _ENABLE_FITS_
 
 	mkdirErrCode	=	mkdir(kImageDataDir_Default, 0744);
@@ -673,6 +778,10 @@ int	iii;
 		GetLinuxErrorString(errno, linexErrString);
 		CONSOLE_DEBUG_W_STR("mkdir returned error:", linexErrString);
 	}
+#ifdef _ENABLE_FILE_INDEX_
+	//*	all of the cameras share one index, opening it again does nothing
+	FileIndex_Open(gImageDataDir);
+#endif
 
 	//========================================
 	//*	Setup support
@@ -699,6 +808,28 @@ CameraDriver::~CameraDriver(void)
 	//*	this really never gets called since we dont really have an exit command
 	CONSOLE_DEBUG(__FUNCTION__);
 	Cooler_TurnOff();
+#ifdef _ENABLE_SHM_FRAMES_
+	ShmFrame_Close(cShmFrameRing);
+	cShmFrameRing	=	NULL;
+#endif
+#ifdef _ENABLE_MJPEG_STREAM_
+	MJPEG_DeleteStream(cMJPEGstream);
+	cMJPEGstream	=	NULL;
+#endif
+#ifdef _ENABLE_PREVIEW_PYRAMID_
+	Pyramid_Delete(cPreviewPyramid);
+	cPreviewPyramid	=	NULL;
+#endif
+#ifdef _ENABLE_FITS_
+	FitsHdrCache_Delete(cFitsHdrCache);
+	cFitsHdrCache	=	NULL;
+#endif
+	if (cImageBytesCache != NULL)
+	{
+		free(cImageBytesCache);
+		cImageBytesCache	=	NULL;
+	}
+	pthread_mutex_destroy(&cImageBytesMutex);
 }
 
 //*****************************************************************************
@@ -1402,6 +1533,36 @@ char				httpHeader[500];
 			}
 			break;
 
+#ifdef _ENABLE_MJPEG_STREAM_
+		case kCmd_Camera_mjpegstream:
+			if (reqData->get_putIndicator == 'G')
+			{
+				alpacaErrCode	=	Get_MJPEGstream(reqData, alpacaErrMsg);
+			}
+			else
+			{
+				alpacaErrCode	=	kASCOM_Err_InvalidOperation;
+				GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Put not supported");
+				CONSOLE_DEBUG(alpacaErrMsg);
+			}
+			break;
+#endif
+
+#ifdef _ENABLE_PREVIEW_PYRAMID_
+		case kCmd_Camera_preview:
+			if (reqData->get_putIndicator == 'G')
+			{
+				alpacaErrCode	=	Get_Preview(reqData, alpacaErrMsg);
+			}
+			else
+			{
+				alpacaErrCode	=	kASCOM_Err_InvalidOperation;
+				GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Put not supported");
+				CONSOLE_DEBUG(alpacaErrMsg);
+			}
+			break;
+#endif
+
 		case kCmd_Camera_saveallimages:
 			if (reqData->get_putIndicator == 'P')
 			{
@@ -1597,9 +1758,7 @@ char				httpHeader[500];
 		case kCmd_Camera_rgbarray:
 			if (reqData->get_putIndicator == 'G')
 			{
-				JsonResponse_FinishHeader(200, httpHeader, "");
-				JsonResponse_SendTextBuffer(mySocket, httpHeader);
-//				CONSOLE_DEBUG_W_STR("httpHeader\t=", httpHeader);
+				//*	Get_RGBarray() sends the header, JSON or ImageBytes
 				cHttpHeaderSent	=	true;
 				alpacaErrCode	=	Get_RGBarray(reqData, alpacaErrMsg);
 			}
@@ -3582,9 +3741,371 @@ void	CameraDriver::SetLastExposureInfo(void)
 
 	cCameraProp.Lastexposure_duration_us	=	cCurrentExposure_us;
 	gettimeofday(&cCameraProp.Lastexposure_StartTime, NULL);	//*	save the time we started the exposure
+	cSyncStartValid							=	false;		//*	MultiCam sets this after the trigger
+#ifdef _ENABLE_GLOBAL_GPS_
+	//*	sub-millisecond UTC start time if the GPS has a PPS line
+	cExposureStartPPS						=	cCameraProp.Lastexposure_StartTime;
+	cExposureStartPPSvalid					=	PPS_CorrectTimeval(&gPPSdata, &cExposureStartPPS);
+#endif
+}
+
+
+
+#ifdef _ENABLE_SHM_FRAMES_
+//*****************************************************************************
+//*	copy the frame that was just read into the shared memory ring
+//*	so that local tools can get it without http or a saved file
+//*****************************************************************************
+void	CameraDriver::PublishSharedMemoryFrame(void)
+{
+TYPE_ShmFrameSlot	frameInfo;
+int					bytesPerPixel;
+
+	switch(cFrameExpInfo.roiInfo.currentROIimageType)
+	{
+		case kImageType_RAW16:	bytesPerPixel	=	2;	break;
+		case kImageType_RGB24:	bytesPerPixel	=	3;	break;
+		default:				bytesPerPixel	=	1;	break;
+	}
+	memset(&frameInfo, 0, sizeof(TYPE_ShmFrameSlot));
+	frameInfo.width				=	cFrameExpInfo.roiInfo.currentROIwidth;
+	frameInfo.height			=	cFrameExpInfo.roiInfo.currentROIheight;
+	frameInfo.bytesPerPixel		=	bytesPerPixel;
+	frameInfo.imageType			=	cFrameExpInfo.roiInfo.currentROIimageType;
+	frameInfo.dataLen			=	frameInfo.width * frameInfo.height * bytesPerPixel;
+	frameInfo.exposure_us		=	cFrameExpInfo.duration_us;
+	frameInfo.exposureStart_us	=	(cFrameExpInfo.startTime.tv_sec * 1000000LL) +
+									cFrameExpInfo.startTime.tv_usec;
+	frameInfo.readoutEnd_us		=	(cFrameExpInfo.endTime.tv_sec * 1000000LL) +
+									cFrameExpInfo.endTime.tv_usec;
+
+	if ((cCameraDataBuffer == NULL) || (frameInfo.dataLen == 0) || (frameInfo.dataLen > (uint32_t)cCameraDataBuffLen))
+	{
+		CONSOLE_DEBUG_W_NUM("Invalid frame size, not published	=", frameInfo.dataLen);
+		return;
+	}
+
+	//*	the slots are the size of the image buffer, if the buffer grew, start over
+	if ((cShmFrameRing != NULL) && (cShmFrameRing->header->slotSize < (uint32_t)cCameraDataBuffLen))
+	{
+		ShmFrame_Close(cShmFrameRing);
+		cShmFrameRing	=	NULL;
+	}
+	if (cShmFrameRing == NULL)
+	{
+		//*	if /dev/shm is full or not there, don't try again on every frame
+		if ((cShmRingFailTime_ms == 0) || ((millis() - cShmRingFailTime_ms) > (60 * 1000)))
+		{
+			cShmFrameRing	=	ShmFrame_CreateRing(cAlpacaDeviceNum, cCameraDataBuffLen);
+			if (cShmFrameRing == NULL)
+			{
+				cShmRingFailTime_ms	=	millis() | 1;
+				strcpy(cLastCameraErrMsg, "Failed to create the shared memory frame ring, will retry in 60 seconds");
+				LogEvent(	"camera",
+							__FUNCTION__,
+							NULL,
+							kASCOM_Err_Success,
+							cLastCameraErrMsg);
+			}
+			else
+			{
+				cShmRingFailTime_ms	=	0;
+			}
+		}
+	}
+	if (ShmFrame_Publish(cShmFrameRing, cCameraDataBuffer, &frameInfo))
+	{
+		cShmFramesPublished++;
+	}
+}
+#endif // _ENABLE_SHM_FRAMES_
+
+#ifdef _ENABLE_MJPEG_STREAM_
+//*****************************************************************************
+//*	hand the frame that was just read to the live view stream,
+//*	this only copies the data, the encoding is done on the stream's own thread
+//*****************************************************************************
+void	CameraDriver::PublishMJPEGframe(void)
+{
+int		pixelType;
+int		bytesPerPixel;
+int		imageWidth;
+int		imageHeight;
+
+	if (MJPEG_HasViewers(cMJPEGstream) == false)
+	{
+		return;
+	}
+	switch(cFrameExpInfo.roiInfo.currentROIimageType)
+	{
+		case kImageType_RAW8:
+		case kImageType_Y8:
+		case kImageType_MONO8:
+			pixelType		=	kMJPEG_Pixel_Gray8;
+			bytesPerPixel	=	1;
+			break;
+
+		case kImageType_RAW16:
+			pixelType		=	kMJPEG_Pixel_Gray16;
+			bytesPerPixel	=	2;
+			break;
+
+		case kImageType_RGB24:
+			pixelType		=	kMJPEG_Pixel_BGR24;
+			bytesPerPixel	=	3;
+			break;
+
+		default:
+			return;
+	}
+	imageWidth	=	cFrameExpInfo.roiInfo.currentROIwidth;
+	imageHeight	=	cFrameExpInfo.roiInfo.currentROIheight;
+	if ((cCameraDataBuffer != NULL) && (((long)imageWidth * imageHeight * bytesPerPixel) <= (long)cCameraDataBuffLen))
+	{
+		MJPEG_SubmitFrame(cMJPEGstream, cCameraDataBuffer, imageWidth, imageHeight, pixelType);
+	}
+}
+
+//*****************************************************************************
+//*	mjpegstream?maxfps=5&maxwidth=640
+//*	the http response is a never ending multipart/x-mixed-replace stream,
+//*	the socket is handed to the stream and no json is sent
+//*****************************************************************************
+TYPE_ASCOM_STATUS	CameraDriver::Get_MJPEGstream(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
+{
+TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_Success;
+char				argumentString[32];
+int					maxWidth;
+double				maxFPS;
+
+	maxWidth	=	0;
+	maxFPS		=	kMJPEG_DefaultMaxFPS;
+	if (GetKeyWordArgument(	reqData->contentData,
+							"maxwidth",
+							argumentString,
+							(sizeof(argumentString) -1),
+							kIgnoreCase,
+							kArgumentIsNumeric))
+	{
+		maxWidth	=	atoi(argumentString);
+	}
+	if (GetKeyWordArgument(	reqData->contentData,
+							"maxfps",
+							argumentString,
+							(sizeof(argumentString) -1),
+							kIgnoreCase,
+							kArgumentIsNumeric))
+	{
+		maxFPS	=	AsciiToDouble(argumentString);
+	}
+	if ((maxWidth < 0) || (maxFPS < 0.0))
+	{
+		alpacaErrCode	=	kASCOM_Err_InvalidValue;
+		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "maxwidth and maxfps must be positive");
+		return(alpacaErrCode);
+	}
+
+	if (cMJPEGstream == NULL)
+	{
+		cMJPEGstream	=	MJPEG_CreateStream();
+	}
+	if (MJPEG_AddViewer(cMJPEGstream, reqData->socket, maxWidth, maxFPS, reqData->clientIPaddr))
+	{
+		SocketListen_DetachSocket(reqData->socket);
+		cSendJSONresponse	=	false;
+		CONSOLE_DEBUG_W_STR("MJPEG viewer connected", reqData->clientIPaddr);
+	}
+	else
+	{
+		alpacaErrCode	=	kASCOM_Err_InvalidOperation;
+		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Unable to start mjpeg stream (too many viewers?)");
+	}
+	return(alpacaErrCode);
+}
+#endif // _ENABLE_MJPEG_STREAM_
+
+#ifdef _ENABLE_PREVIEW_PYRAMID_
+//*****************************************************************************
+//*	2x, 4x and 8x previews of the frame that was just read
+//*	returns false if the frame can not be used for a preview
+//*****************************************************************************
+bool	CameraDriver::BuildPreviewPyramid(TYPE_PREVIEW_PYRAMID *pyramid)
+{
+int		pixelType;
+int		bytesPerPixel;
+int		imageWidth;
+int		imageHeight;
+
+	switch(cFrameExpInfo.roiInfo.currentROIimageType)
+	{
+		case kImageType_RAW8:
+		case kImageType_Y8:
+		case kImageType_MONO8:
+			pixelType		=	kPyramid_Pixel_Gray8;
+			bytesPerPixel	=	1;
+			break;
+
+		case kImageType_RAW16:
+			pixelType		=	kPyramid_Pixel_Gray16;
+			bytesPerPixel	=	2;
+			break;
+
+		case kImageType_RGB24:
+			pixelType		=	kPyramid_Pixel_BGR24;
+			bytesPerPixel	=	3;
+			break;
+
+		default:
+			return(false);
+	}
+	imageWidth	=	cFrameExpInfo.roiInfo.currentROIwidth;
+	imageHeight	=	cFrameExpInfo.roiInfo.currentROIheight;
+	if ((cCameraDataBuffer == NULL) || (((long)imageWidth * imageHeight * bytesPerPixel) > (long)cCameraDataBuffLen))
+	{
+		return(false);
+	}
+	return(Pyramid_Build(pyramid, cCameraDataBuffer, imageWidth, imageHeight, pixelType, cFrameExpInfo.frameNum));
 }
 
+//*****************************************************************************
+//*	preview?level=8&format=jpeg
+//*		level	2, 4 or 8 (default 4)
+//*		format	jpeg (default) or imagebytes, imagebytes is also used if the
+//*				client sends "Accept: application/imagebytes"
+//*****************************************************************************
+TYPE_ASCOM_STATUS	CameraDriver::Get_Preview(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
+{
+TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_Success;
+TYPE_PYRAMID_OUTPUT	preview;
+TYPE_BinaryImageHdr	binaryImageHdr;
+char				argumentString[32];
+char				acceptString[128];
+char				httpHeader[512];
+unsigned char		*responseBuffer;
+size_t				headerLen;
+size_t				responseLen;
+size_t				totalWritten;
+ssize_t				bytesWritten;
+int					scaleFactor;
+int					levelIdx;
+int					outputFormat;
+
+	scaleFactor		=	4;
+	outputFormat	=	kPyramid_Format_JPEG;
+	if (GetKeyWordArgument(	reqData->contentData,
+							"level",
+							argumentString,
+							(sizeof(argumentString) -1),
+							kIgnoreCase,
+							kArgumentIsNumeric))
+	{
+		scaleFactor	=	atoi(argumentString);
+	}
+	if (GetKeyWordArgument(reqData->contentData, "format", argumentString, (sizeof(argumentString) -1), kIgnoreCase))
+	{
+		if (strcasecmp(argumentString, "imagebytes") == 0)
+		{
+			outputFormat	=	kPyramid_Format_ImageBytes;
+		}
+	}
+	else if (StaticFile_GetHeaderValue(reqData->htmlData, "Accept", acceptString, sizeof(acceptString)) &&
+			(strcasestr(acceptString, "application/imagebytes") != NULL))
+	{
+		outputFormat	=	kPyramid_Format_ImageBytes;
+	}
+	levelIdx	=	Pyramid_LevelFromScale(scaleFactor);
+	if (levelIdx < 0)
+	{
+		alpacaErrCode	=	kASCOM_Err_InvalidValue;
+		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "level must be 2, 4 or 8");
+		return(alpacaErrCode);
+	}
+	//*	the first request builds the pyramid for the current frame, from then on
+	//*	the state machine builds it for every frame. The pointer is only set
+	//*	once the build is done, the state machine does not touch it before that
+	if ((cPreviewPyramid == NULL) && cCameraProp.ImageReady)
+	{
+	TYPE_PREVIEW_PYRAMID	*newPyramid;
 
+		newPyramid	=	Pyramid_Create();
+		if (newPyramid != NULL)
+		{
+			if (BuildPreviewPyramid(newPyramid))
+			{
+				cPreviewPyramid	=	newPyramid;
+			}
+			else
+			{
+				Pyramid_Delete(newPyramid);
+			}
+		}
+	}
+	if (Pyramid_GetLevel(cPreviewPyramid, levelIdx, outputFormat, &preview) == false)
+	{
+		alpacaErrCode	=	kASCOM_Err_InvalidOperation;
+		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "No preview available, no image has been taken");
+		return(alpacaErrCode);
+	}
+
+	headerLen	=	0;
+	if (outputFormat == kPyramid_Format_ImageBytes)
+	{
+		memset((void *)&binaryImageHdr, 0, sizeof(TYPE_BinaryImageHdr));
+		binaryImageHdr.MetadataVersion			=	1;
+		binaryImageHdr.ClientTransactionID		=	reqData->ClientTransactionID;
+		binaryImageHdr.ServerTransactionID		=	gServerTransactionID;
+		binaryImageHdr.DataStart				=	sizeof(TYPE_BinaryImageHdr);
+		binaryImageHdr.ImageElementType			=	kAlpacaImageData_Byte;
+		binaryImageHdr.TransmissionElementType	=	kAlpacaImageData_Byte;
+		binaryImageHdr.Rank						=	(preview.channels == 3) ? 3 : 2;
+		binaryImageHdr.Dimension1				=	preview.width;
+		binaryImageHdr.Dimension2				=	preview.height;
+		binaryImageHdr.Dimension3				=	(preview.channels == 3) ? 3 : 0;
+		headerLen								=	sizeof(TYPE_BinaryImageHdr);
+	}
+	snprintf(httpHeader, sizeof(httpHeader),	"HTTP/1.0 200 OK\r\n"
+												"Content-Type: %s\r\n"
+												"Content-Length: %lu\r\n"
+												"Cache-Control: no-cache\r\n"
+												"Access-Control-Allow-Origin: *\r\n"
+												"X-Frame-Number: %u\r\n"
+												"Server: AlpacaPi\r\n"
+												"\r\n",
+												((outputFormat == kPyramid_Format_JPEG) ? "image/jpeg" : "application/imagebytes"),
+												(unsigned long)(headerLen + preview.dataLen),
+												preview.frameNum);
+
+	//*	one buffer, one write (the same as Get_Imagearray_Binary)
+	responseLen		=	strlen(httpHeader) + headerLen + preview.dataLen;
+	responseBuffer	=	(unsigned char *)malloc(responseLen);
+	if (responseBuffer != NULL)
+	{
+		memcpy(responseBuffer, httpHeader, strlen(httpHeader));
+		memcpy(&responseBuffer[strlen(httpHeader)], &binaryImageHdr, headerLen);
+		memcpy(&responseBuffer[strlen(httpHeader) + headerLen], preview.data, preview.dataLen);
+		totalWritten	=	0;
+		while (totalWritten < responseLen)
+		{
+			bytesWritten	=	write(reqData->socket, &responseBuffer[totalWritten], (responseLen - totalWritten));
+			if (bytesWritten <= 0)
+			{
+				CONSOLE_DEBUG("Failed to send preview");
+				break;
+			}
+			totalWritten	+=	bytesWritten;
+		}
+		free(responseBuffer);
+		cSendJSONresponse	=	false;
+	}
+	else
+	{
+		alpacaErrCode	=	kASCOM_Err_InternalError;
+		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Failed to allocate preview buffer");
+	}
+	free(preview.data);
+	return(alpacaErrCode);
+}
+#endif // _ENABLE_PREVIEW_PYRAMID_
 
 //*****************************************************************************
 //*	Start Exposure
@@ -4030,28 +4551,27 @@ TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_NotImplemented;
 //*****************************************************************************
 int	CameraDriver::BuildBinaryImage_Raw8(	unsigned char 	*binaryDataBuffer,
 											int				startOffset,
-											int				bufferSize)
+											int				bufferSize,
+											const TYPE_IMAGE_WINDOW	*imgWindow)
 {
-int		xxx;
-int		yyy;
 int		ccc;
-int		pixelIndex;
+int		valueCnt;
 
 	CONSOLE_DEBUG(__FUNCTION__);
 	ccc	=	startOffset;
-	if (cCameraDataBuffer != NULL)
+	if (imgWindow->pixelPtr != NULL)
 	{
-		for (xxx=0; xxx<cLastExposure_ROIinfo.currentROIwidth; xxx++)
+		valueCnt	=	imgWindow->outWidth * imgWindow->outHeight;
+		if ((ccc + valueCnt) <= bufferSize)
 		{
-			pixelIndex	=	xxx;
-			for (yyy=0; yyy < cLastExposure_ROIinfo.currentROIheight; yyy++)
-			{
-				if (ccc < bufferSize)
-				{
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex] & 0x00ff);
-				}
-				pixelIndex	+=	cLastExposure_ROIinfo.currentROIwidth;
-			}
+			PixConv_ToImageBytes(	&binaryDataBuffer[startOffset], 1, 0,
+									imgWindow->pixelPtr, 1, 1,
+									imgWindow->outWidth, imgWindow->outHeight);
+			ccc	+=	valueCnt;
+		}
+		else
+		{
+			CONSOLE_DEBUG("Binary data buffer overflow");
 		}
 	}
 	else
@@ -4063,37 +4583,31 @@ int		pixelIndex;
 
 //*****************************************************************************
 //*	returns byte count
+//*	its little endian, the 8 bit value is the high byte of 16
 //*****************************************************************************
 int	CameraDriver::BuildBinaryImage_Raw8_16bit(	unsigned char	*binaryDataBuffer,
 												int				startOffset,
-												int				bufferSize)
+												int				bufferSize,
+												const TYPE_IMAGE_WINDOW	*imgWindow)
 {
-int		xxx;
-int		yyy;
 int		ccc;
-int		pixelIndex;
+int		valueCnt;
 
 	CONSOLE_DEBUG(__FUNCTION__);
 	ccc	=	startOffset;
-	if (cCameraDataBuffer != NULL)
+	if (imgWindow->pixelPtr != NULL)
 	{
-		for (xxx=0; xxx<cLastExposure_ROIinfo.currentROIwidth; xxx++)
+		valueCnt	=	imgWindow->outWidth * imgWindow->outHeight;
+		if ((ccc + (valueCnt * 2)) <= bufferSize)
 		{
-			pixelIndex	=	xxx;
-			for (yyy=0; yyy < cLastExposure_ROIinfo.currentROIheight; yyy++)
-			{
-				if (ccc < bufferSize)
-				{
-					//*	its little endian, 16 bit
-					binaryDataBuffer[ccc++]	=	0;
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex] & 0x00ff);
-				}
-				else
-				{
-					CONSOLE_DEBUG("Binary data buffer overflow");
-				}
-				pixelIndex	+=	cLastExposure_ROIinfo.currentROIwidth;
-			}
+			PixConv_ToImageBytes(	&binaryDataBuffer[startOffset], 2, 8,
+									imgWindow->pixelPtr, 1, 1,
+									imgWindow->outWidth, imgWindow->outHeight);
+			ccc	+=	valueCnt * 2;
+		}
+		else
+		{
+			CONSOLE_DEBUG("Binary data buffer overflow");
 		}
 	}
 	else
@@ -4105,39 +4619,31 @@ int		pixelIndex;
 
 //*****************************************************************************
 //*	returns byte count
+//*	its little endian, the 8 bit value is the second byte of 32
 //*****************************************************************************
 int	CameraDriver::BuildBinaryImage_Raw8_32bit(	unsigned char	*binaryDataBuffer,
 												int				startOffset,
-												int				bufferSize)
+												int				bufferSize,
+												const TYPE_IMAGE_WINDOW	*imgWindow)
 {
-int		xxx;
-int		yyy;
 int		ccc;
-int		pixelIndex;
+int		valueCnt;
 
 	CONSOLE_DEBUG(__FUNCTION__);
 	ccc	=	startOffset;
-	if (cCameraDataBuffer != NULL)
+	if (imgWindow->pixelPtr != NULL)
 	{
-		for (xxx=0; xxx<cLastExposure_ROIinfo.currentROIwidth; xxx++)
+		valueCnt	=	imgWindow->outWidth * imgWindow->outHeight;
+		if ((ccc + (valueCnt * 4)) <= bufferSize)
 		{
-			pixelIndex	=	xxx;
-			for (yyy=0; yyy < cLastExposure_ROIinfo.currentROIheight; yyy++)
-			{
-				if (ccc < bufferSize)
-				{
-					//*	its little endian, 16 bit value in 32 bit word
-					binaryDataBuffer[ccc++]	=	0;
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex] & 0x00ff);
-					binaryDataBuffer[ccc++]	=	0;
-					binaryDataBuffer[ccc++]	=	0;
-				}
-				else
-				{
-					CONSOLE_DEBUG("Binary data buffer overflow");
-				}
-				pixelIndex	+=	cLastExposure_ROIinfo.currentROIwidth;
-			}
+			PixConv_ToImageBytes(	&binaryDataBuffer[startOffset], 4, 8,
+									imgWindow->pixelPtr, 1, 1,
+									imgWindow->outWidth, imgWindow->outHeight);
+			ccc	+=	valueCnt * 4;
+		}
+		else
+		{
+			CONSOLE_DEBUG("Binary data buffer overflow");
 		}
 	}
 	else
@@ -4160,33 +4666,27 @@ int		pixelIndex;
 //*****************************************************************************
 int	CameraDriver::BuildBinaryImage_Raw16(	unsigned char 	*binaryDataBuffer,
 											int				startOffset,
-											int				bufferSize)
+											int				bufferSize,
+											const TYPE_IMAGE_WINDOW	*imgWindow)
 {
-int		xxx;
-int		yyy;
 int		ccc;
-int		pixelIndex;
+int		valueCnt;
 
 	CONSOLE_DEBUG(__FUNCTION__);
 	ccc	=	startOffset;
-	if (cCameraDataBuffer != NULL)
+	if (imgWindow->pixelPtr != NULL)
 	{
-		for (xxx=0; xxx<cLastExposure_ROIinfo.currentROIwidth; xxx++)
+		valueCnt	=	imgWindow->outWidth * imgWindow->outHeight;
+		if ((ccc + (valueCnt * 2)) <= bufferSize)
 		{
-			for (yyy=0; yyy<cLastExposure_ROIinfo.currentROIheight; yyy++)
-			{
-				pixelIndex	=	yyy * cLastExposure_ROIinfo.currentROIwidth * 2;
-				pixelIndex	+=	xxx * 2;
-				if (ccc < bufferSize)
-				{
-					//*	the outgoing data is little-endian 16 bit
-					//*	we are converting an 8 bit value to a 16 bit value, unsigned
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex++] & 0x00ff);
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex++] & 0x00ff);
-				}
-
-			//	pixelIndex++;
-			}
+			PixConv_ToImageBytes(	&binaryDataBuffer[startOffset], 2, 0,
+									imgWindow->pixelPtr, 2, 1,
+									imgWindow->outWidth, imgWindow->outHeight);
+			ccc	+=	valueCnt * 2;
+		}
+		else
+		{
+			CONSOLE_DEBUG("Binary data buffer overflow");
 		}
 	}
 	else
@@ -4198,38 +4698,31 @@ int		pixelIndex;
 
 //*****************************************************************************
 //*	returns byte count
+//*	the 16 bit value is the high half of 32
 //*****************************************************************************
 int	CameraDriver::BuildBinaryImage_Raw32(	unsigned char 	*binaryDataBuffer,
 											int				startOffset,
-											int				bufferSize)
+											int				bufferSize,
+											const TYPE_IMAGE_WINDOW	*imgWindow)
 {
-int		xxx;
-int		yyy;
 int		ccc;
-int		pixelIndex;
+int		valueCnt;
 
 	CONSOLE_DEBUG(__FUNCTION__);
 	ccc	=	startOffset;
-	if (cCameraDataBuffer != NULL)
+	if (imgWindow->pixelPtr != NULL)
 	{
-		for (xxx=0; xxx<cLastExposure_ROIinfo.currentROIwidth; xxx++)
+		valueCnt	=	imgWindow->outWidth * imgWindow->outHeight;
+		if ((ccc + (valueCnt * 4)) <= bufferSize)
 		{
-			for (yyy=0; yyy<cLastExposure_ROIinfo.currentROIheight; yyy++)
-			{
-				pixelIndex	=	yyy * cLastExposure_ROIinfo.currentROIwidth * 2;
-				pixelIndex	+=	xxx * 2;
-				if (ccc < bufferSize)
-				{
-					//*	the outgoing data is little-endian 32 bit
-					//*	we are converting a 16 bit value to a 32 bit value, unsigned
-					binaryDataBuffer[ccc++]	=	0;
-					binaryDataBuffer[ccc++]	=	0;
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex++] & 0x00ff);
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex++] & 0x00ff);
-				}
-
-			//	pixelIndex++;
-			}
+			PixConv_ToImageBytes(	&binaryDataBuffer[startOffset], 4, 16,
+									imgWindow->pixelPtr, 2, 1,
+									imgWindow->outWidth, imgWindow->outHeight);
+			ccc	+=	valueCnt * 4;
+		}
+		else
+		{
+			CONSOLE_DEBUG("Binary data buffer overflow");
 		}
 	}
 	else
@@ -4241,39 +4734,31 @@ int		pixelIndex;
 
 //*****************************************************************************
 //*	returns byte count
+//*	the camera buffer is BGR, ImageBytes is RGB
 //*****************************************************************************
 int	CameraDriver::BuildBinaryImage_RGB24(	unsigned char 	*binaryDataBuffer,
 											int				startOffset,
-											int				bufferSize)
+											int				bufferSize,
+											const TYPE_IMAGE_WINDOW	*imgWindow)
 {
-int		xxx;
-int		yyy;
 int		ccc;
-int		pixelIndex;
+int		valueCnt;
 
 	CONSOLE_DEBUG(__FUNCTION__);
-
 	ccc	=	startOffset;
-	if (cCameraDataBuffer != NULL)
+	if (imgWindow->pixelPtr != NULL)
 	{
-		for (xxx=0; xxx<cLastExposure_ROIinfo.currentROIwidth; xxx++)
+		valueCnt	=	imgWindow->outWidth * imgWindow->outHeight * 3;
+		if ((ccc + valueCnt) <= bufferSize)
 		{
-			pixelIndex	=	xxx * 3;
-			for (yyy=0; yyy < cLastExposure_ROIinfo.currentROIheight; yyy++)
-			{
-				if (ccc < bufferSize)
-				{
-					//*	red data
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex + 2] & 0x00ff);
-
-					//*	green data
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex + 1] & 0x00ff);
-
-					//*	blue data
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex] & 0x00ff);
-				}
-				pixelIndex	+=	cLastExposure_ROIinfo.currentROIwidth * 3;
-			}
+			PixConv_ToImageBytes(	&binaryDataBuffer[startOffset], 1, 0,
+									imgWindow->pixelPtr, 1, 3,
+									imgWindow->outWidth, imgWindow->outHeight);
+			ccc	+=	valueCnt;
+		}
+		else
+		{
+			CONSOLE_DEBUG("Binary data buffer overflow");
 		}
 	}
 	else
@@ -4284,43 +4769,32 @@ int		pixelIndex;
 }
 
 //*****************************************************************************
-//*	returns byte count
+//*	returns the uint32 count
+//*	each color is the top byte of a 32 bit value
 //*****************************************************************************
 int	CameraDriver::BuildBinaryImage_RGB24_32bit(	uint32_t 	*binaryDataBuffer,
 												int			startOffset,
-												int			bufferSize)
+												int			bufferSize,
+												const TYPE_IMAGE_WINDOW	*imgWindow)
 {
-int		xxx;
-int		yyy;
 int		ccc;
-int		pixelIndex;
-int		pixelCntMax;
+int		valueCnt;
 
 	CONSOLE_DEBUG(__FUNCTION__);
-
 	ccc	=	startOffset;
-	if (cCameraDataBuffer != NULL)
+	if (imgWindow->pixelPtr != NULL)
 	{
-		pixelCntMax	=	bufferSize / 4;
-		for (xxx=0; xxx<cLastExposure_ROIinfo.currentROIwidth; xxx++)
+		valueCnt	=	imgWindow->outWidth * imgWindow->outHeight * 3;
+		if ((ccc + valueCnt) <= (bufferSize / 4))
 		{
-			pixelIndex	=	xxx * 3;
-			for (yyy=0; yyy < cLastExposure_ROIinfo.currentROIheight; yyy++)
-			{
-				if (ccc < pixelCntMax)
-				{
-					//*	openCV uses BGR instead of RGB
-					//*	red data
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex + 2] & 0x00ff) << 24;
-
-					//*	green data
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex + 1] & 0x00ff) << 24;
-
-					//*	blue data
-					binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex] & 0x00ff) << 24;
-				}
-				pixelIndex	+=	cLastExposure_ROIinfo.currentROIwidth * 3;
-			}
+			PixConv_ToImageBytes(	&binaryDataBuffer[startOffset], 4, 24,
+									imgWindow->pixelPtr, 1, 3,
+									imgWindow->outWidth, imgWindow->outHeight);
+			ccc	+=	valueCnt;
+		}
+		else
+		{
+			CONSOLE_DEBUG("Binary data buffer overflow");
 		}
 	}
 	else
@@ -4332,42 +4806,37 @@ int		pixelCntMax;
 
 //*****************************************************************************
 //*	returns byte count
+//*	output data is 16 bit, little endian, we have BGR 24 bit (3 bytes)
 //*****************************************************************************
 int	CameraDriver::BuildBinaryImage_RGBx16(	unsigned char 	*binaryDataBuffer,
 											int				startOffset,
-											int				bufferSize)
+											int				bufferSize,
+											const TYPE_IMAGE_WINDOW	*imgWindow)
 {
-int		xxx;
-int		yyy;
 int		ccc;
-int		pixelIndex;
+int		valueCnt;
 
 	CONSOLE_DEBUG(__FUNCTION__);
-
 	ccc	=	startOffset;
-	for (xxx=0; xxx<cLastExposure_ROIinfo.currentROIwidth; xxx++)
+	if (imgWindow->pixelPtr != NULL)
 	{
-		pixelIndex	=	xxx * 3;
-		for (yyy=0; yyy < cLastExposure_ROIinfo.currentROIheight; yyy++)
+		valueCnt	=	imgWindow->outWidth * imgWindow->outHeight * 3;
+		if ((ccc + (valueCnt * 2)) <= bufferSize)
 		{
-			if (ccc < bufferSize)
-			{
-				//*	output data is 16 bit, little endian, we have RGB 24 bit (3 bytes)
-				//*	red data
-				binaryDataBuffer[ccc++]	=	0;
-				binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex + 2] & 0x00ff);
-
-				//*	green data
-				binaryDataBuffer[ccc++]	=	0;
-				binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex + 1] & 0x00ff);
-
-				//*	blue data
-				binaryDataBuffer[ccc++]	=	0;
-				binaryDataBuffer[ccc++]	=	(cCameraDataBuffer[pixelIndex] & 0x00ff);
-			}
-			pixelIndex	+=	cLastExposure_ROIinfo.currentROIwidth * 3;
+			PixConv_ToImageBytes(	&binaryDataBuffer[startOffset], 2, 8,
+									imgWindow->pixelPtr, 1, 3,
+									imgWindow->outWidth, imgWindow->outHeight);
+			ccc	+=	valueCnt * 2;
+		}
+		else
+		{
+			CONSOLE_DEBUG("Binary data buffer overflow");
 		}
 	}
+	else
+	{
+		CONSOLE_DEBUG("cCameraDataBuffer is NULL");
+	}
 	return(ccc);
 }
 
@@ -4389,10 +4858,131 @@ static void	GetAlpacaImageDataTypeString(int dataType, char *dataTypeString)
 	}
 }
 
+//*****************************************************************************
+//*	The ETag is the frame number, the exposure start time and the window, it is
+//*	what keeps the pieces of a resumed or parallel (Range) download from coming
+//*	from different exposures
+//*****************************************************************************
+void	CameraDriver::FormatImageBytesETag(const TYPE_IMAGE_WINDOW *imgWindow, char *eTag)
+{
+	sprintf(eTag,	"\"%ld-%ld.%06ld-%d-%d-%d-%d-%d\"",
+					cFramesRead,
+					(long)cFrameExpInfo.startTime.tv_sec,
+					(long)cFrameExpInfo.startTime.tv_usec,
+					imgWindow->xStart,
+					imgWindow->yStart,
+					imgWindow->width,
+					imgWindow->height,
+					imgWindow->bin);
+}
+
+//*****************************************************************************
+//*	called from the main loop, the cached ImageBytes can be 100mb so they
+//*	are freed as soon as the next exposure starts
+//*****************************************************************************
+void	CameraDriver::FreeStaleImageBytes(void)
+{
+	pthread_mutex_lock(&cImageBytesMutex);
+	if ((cImageBytesCache != NULL) && (cImageBytesSending == false) &&
+		timercmp(&cCameraProp.Lastexposure_StartTime, &cImageBytesExpStart, !=))
+	{
+		CONSOLE_DEBUG_W_STR("New exposure, freeing cached ImageBytes, ETag=", cImageBytesETag);
+		free(cImageBytesCache);
+		cImageBytesCache	=	NULL;
+		cImageBytesCacheLen	=	0;
+		cImageBytesETag[0]	=	0;
+	}
+	pthread_mutex_unlock(&cImageBytesMutex);
+}
+
+//*****************************************************************************
+//*	true if the request can be answered from the cached ImageBytes, the same
+//*	ETag or a Range request with If-Range set to the cached ETag.
+//*	On a hit cImageBytesSending is set, the caller has to SendImageBytesCache()
+//*****************************************************************************
+bool	CameraDriver::CheckImageBytesCache(TYPE_GetPutRequestData *reqData, const char *eTag)
+{
+char	ifRangeString[80];
+bool	cacheHit;
+
+	if (StaticFile_GetHeaderValue(reqData->htmlData, "If-Range", ifRangeString, sizeof(ifRangeString)) == false)
+	{
+		ifRangeString[0]	=	0;
+	}
+	pthread_mutex_lock(&cImageBytesMutex);
+	cacheHit	=	(cImageBytesCache != NULL) &&
+					((strcmp(eTag, cImageBytesETag) == 0) || (strcmp(ifRangeString, cImageBytesETag) == 0));
+	cImageBytesSending	=	cacheHit;
+	pthread_mutex_unlock(&cImageBytesMutex);
+	if (cacheHit)
+	{
+		CONSOLE_DEBUG_W_STR("Sending cached ImageBytes, ETag=", cImageBytesETag);
+	}
+	return(cacheHit);
+}
+
+//*****************************************************************************
+//*	replaces the cached ImageBytes, the buffer now belongs to the cache.
+//*	cImageBytesSending is set, the caller has to SendImageBytesCache()
+//*****************************************************************************
+void	CameraDriver::StoreImageBytesCache(unsigned char *binaryDataBuffer, const size_t bufferSize, const char *eTag)
+{
+	pthread_mutex_lock(&cImageBytesMutex);
+	if (cImageBytesCache != NULL)
+	{
+		free(cImageBytesCache);
+	}
+	cImageBytesCache		=	binaryDataBuffer;
+	cImageBytesCacheLen		=	bufferSize;
+	cImageBytesFrameNum		=	cFramesRead;
+	cImageBytesExpStart		=	cCameraProp.Lastexposure_StartTime;
+	cImageBytesSending		=	true;
+	strcpy(cImageBytesETag, eTag);
+	pthread_mutex_unlock(&cImageBytesMutex);
+}
+
+//*****************************************************************************
+//*	cImageBytesSending has to be set by the caller (under cImageBytesMutex)
+//*	so the main loop leaves the cache alone until the send is done
+//*****************************************************************************
+int	CameraDriver::SendImageBytesCache(TYPE_GetPutRequestData *reqData)
+{
+TYPE_BinaryImageHdr	*cachedHdrPtr;
+char				extraHeaders[128];
+int					httpStatus;
+
+	//*	the transaction IDs are per request, they are not part of the image
+	cachedHdrPtr						=	(TYPE_BinaryImageHdr *)cImageBytesCache;
+	cachedHdrPtr->ClientTransactionID	=	reqData->ClientTransactionID;
+	cachedHdrPtr->ServerTransactionID	=	gServerTransactionID;
+	sprintf(extraHeaders, "Server: AlpacaPi\r\nX-Frame-Number: %ld\r\n", cImageBytesFrameNum);
+	httpStatus	=	StaticFile_SendBuffer(	reqData->socket,
+											cImageBytesCache,
+											cImageBytesCacheLen,
+											"application/imagebytes",
+											cImageBytesETag,
+											extraHeaders,
+											reqData->htmlData);
+	CONSOLE_DEBUG_W_NUM("httpStatus\t=", httpStatus);
+
+	pthread_mutex_lock(&cImageBytesMutex);
+	cImageBytesSending	=	false;
+	pthread_mutex_unlock(&cImageBytesMutex);
+	return(httpStatus);
+}
+
 //*****************************************************************************
 //*	https://ascom-standards.org/Developer/AlpacaImageBytes.pdf
+//*
+//*	The encoded image is kept in cImageBytesCache. A request with the same ETag,
+//*	or a Range request with If-Range set to the cached ETag, is answered from
+//*	the cache even if a newer frame has been read since, a 100mb download can
+//*	be resumed or fetched in parallel pieces without the image being rebuilt.
+//*	The cache is freed when the next exposure starts, FreeStaleImageBytes().
 //*****************************************************************************
-TYPE_ASCOM_STATUS	CameraDriver::Get_Imagearray_Binary(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
+TYPE_ASCOM_STATUS	CameraDriver::Get_Imagearray_Binary(TYPE_GetPutRequestData	*reqData,
+														char					*alpacaErrMsg,
+														TYPE_IMAGE_WINDOW		*imgWindow)
 {
 TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_InvalidOperation;
 TYPE_BinaryImageHdr	binaryImageHdr;
@@ -4402,18 +4992,30 @@ int					dataPayloadSize;
 size_t				bufferSize;
 unsigned char 		*binaryDataBuffer;
 int					imgDataOffset;
-size_t				bytesWritten;
-char				httpHeader[1024];
-char				lineBuff[128];
-size_t				httpHeaderSize;
 int					returnedDataLen;
+int					httpStatus;
 char				dataTypeString[32];
+char				eTag[80];
 bool				xmit16BitAs32Bit	=	false;
 
 	CONSOLE_DEBUG(__FUNCTION__);
 
 	cSendJSONresponse	=	false;
 
+	//*	the same frame (and window) as last time, or the piece of an older one
+	//*	that a client is resuming
+	FormatImageBytesETag(imgWindow, eTag);
+	if (CheckImageBytesCache(reqData, eTag))
+	{
+		httpStatus	=	SendImageBytesCache(reqData);
+		if (httpStatus == kSF_ShortSend)
+		{
+			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Failed to send all of the image data");
+			return(kASCOM_Err_DataFailure);
+		}
+		return(kASCOM_Err_Success);
+	}
+
 	memset((void *)&binaryImageHdr, 0, sizeof(TYPE_BinaryImageHdr));
 
 	//*	set default values, the image types may change
@@ -4425,21 +5027,23 @@ bool				xmit16BitAs32Bit	=	false;
 	binaryImageHdr.ImageElementType			=	kAlpacaImageData_Int32;					//	Element type of the source image array
 	binaryImageHdr.TransmissionElementType	=	kAlpacaImageData_UInt16;				//	Element type as sent over the network
 	binaryImageHdr.Rank						=	2;										//	Image array rank
-	binaryImageHdr.Dimension1				=	cLastExposure_ROIinfo.currentROIwidth;	//	Length of image array first dimension
-	binaryImageHdr.Dimension2				=	cLastExposure_ROIinfo.currentROIheight;	//	Length of image array second dimension
+	binaryImageHdr.Dimension1				=	imgWindow->outWidth;					//	Length of image array first dimension
+	binaryImageHdr.Dimension2				=	imgWindow->outHeight;					//	Length of image array second dimension
 	binaryImageHdr.Dimension3				=	0;										//	Length of image array third dimension (0 for 2D array)
 
 
 	binaryImageHdr.ClientTransactionID		=	reqData->ClientTransactionID;
 	binaryImageHdr.ServerTransactionID		=	gServerTransactionID;
 
-	CONSOLE_DEBUG_W_NUM("cLastExposure_ROIinfo.currentROIimageType\t=",		cLastExposure_ROIinfo.currentROIimageType);
-	CONSOLE_DEBUG_W_NUM("cLastExposure_ROIinfo.currentROIwidth\t=",		cLastExposure_ROIinfo.currentROIwidth);
-	CONSOLE_DEBUG_W_NUM("cLastExposure_ROIinfo.currentROIheight\t=",	cLastExposure_ROIinfo.currentROIheight);
-	totalPixels		=	cLastExposure_ROIinfo.currentROIwidth * cLastExposure_ROIinfo.currentROIheight;
+	CONSOLE_DEBUG_W_NUM("cFrameExpInfo.roiInfo.currentROIimageType\t=",		cFrameExpInfo.roiInfo.currentROIimageType);
+	CONSOLE_DEBUG_W_NUM("cFrameExpInfo.roiInfo.currentROIwidth\t=",		cFrameExpInfo.roiInfo.currentROIwidth);
+	CONSOLE_DEBUG_W_NUM("cFrameExpInfo.roiInfo.currentROIheight\t=",	cFrameExpInfo.roiInfo.currentROIheight);
+	CONSOLE_DEBUG_W_NUM("imgWindow->outWidth\t\t=",	imgWindow->outWidth);
+	CONSOLE_DEBUG_W_NUM("imgWindow->outHeight\t=",	imgWindow->outHeight);
+	totalPixels		=	imgWindow->outWidth * imgWindow->outHeight;
 	bytesPerPixel	=	6;
 
-	switch(cLastExposure_ROIinfo.currentROIimageType)
+	switch(cFrameExpInfo.roiInfo.currentROIimageType)
 	{
 		case kImageType_RAW8:
 		case kImageType_Y8:
@@ -4531,50 +5135,32 @@ bool				xmit16BitAs32Bit	=	false;
 	CONSOLE_DEBUG_W_NUM("totalPixels\t\t=",				totalPixels);
 	CONSOLE_DEBUG_W_NUM("dataPayloadSize\t\t=",			dataPayloadSize);
 
-	//*	time to build the HTTP header
-	strcpy(httpHeader,	"HTTP/1.0 200 OK\r\n");
-	sprintf(lineBuff,	"Content-Length: %d\r\n", dataPayloadSize);
-	strcat(httpHeader,	lineBuff);
-	//*	fix by EZT 7/6/2024
-	strcat(httpHeader,	"Content-type: application/imagebytes\r\n");
-//	strcat(httpHeader,	"Content-type: application/imagebytes; charset=utf-8\r\n");
-
-	strcat(httpHeader,	"Server: AlpacaPi\r\n");
-	strcat(httpHeader, "\r\n");
-
-	httpHeaderSize	=	strlen(httpHeader);
-
-	bufferSize		=	httpHeaderSize + dataPayloadSize;
+	//*	the HTTP header is built by StaticFile_SendBuffer(), the buffer is just the ImageBytes
+	bufferSize		=	dataPayloadSize;
 
 	//--------------------------------------------------------------------
 	//*	make sure we have valid data
-	if ((cCameraDataBuffer != NULL) && (totalPixels > 0))
+	if ((imgWindow->pixelPtr != NULL) && (totalPixels > 0))
 	{
 		//*	allocate one big buffer and put the entire image into it
 		binaryDataBuffer	=	(unsigned char *)calloc((bufferSize + 1000), 1);
 		if (binaryDataBuffer != NULL)
 		{
-			//*	copy the HTTP header
-			memcpy(binaryDataBuffer, httpHeader, httpHeaderSize);
-
-//			CONSOLE_DEBUG_W_STR("binaryDataBuffer\t=",			binaryDataBuffer);
 			//*	copy over the header
-			memcpy(&binaryDataBuffer[httpHeaderSize], &binaryImageHdr, sizeof(TYPE_BinaryImageHdr));
+			memcpy(binaryDataBuffer, &binaryImageHdr, sizeof(TYPE_BinaryImageHdr));
 
 			//*	imgDataOffset is the index to put the image data
-			imgDataOffset		=	httpHeaderSize;
-			imgDataOffset		+=	sizeof(TYPE_BinaryImageHdr);
+			imgDataOffset		=	sizeof(TYPE_BinaryImageHdr);
 
-			CONSOLE_DEBUG_W_SIZE("httpHeaderSize             \t=",	httpHeaderSize);
 			CONSOLE_DEBUG_W_SIZE("sizeof(TYPE_BinaryImageHdr)\t=",	sizeof(TYPE_BinaryImageHdr));
 			CONSOLE_DEBUG_W_NUM("imgDataOffset               \t=",	imgDataOffset);
 
 			//*	now copy the image over
 			returnedDataLen	=	0;
-			CONSOLE_DEBUG_W_NUM("currentROIimageType    \t=",	cLastExposure_ROIinfo.currentROIimageType);
+			CONSOLE_DEBUG_W_NUM("currentROIimageType    \t=",	cFrameExpInfo.roiInfo.currentROIimageType);
 			CONSOLE_DEBUG_W_NUM("TransmissionElementType\t=",	binaryImageHdr.TransmissionElementType);
 
-			switch(cLastExposure_ROIinfo.currentROIimageType)
+			switch(cFrameExpInfo.roiInfo.currentROIimageType)
 			{
 				case kImageType_RAW8:
 				case kImageType_Y8:
@@ -4583,15 +5169,15 @@ bool				xmit16BitAs32Bit	=	false;
 					switch (binaryImageHdr.TransmissionElementType)
 					{
 						case kAlpacaImageData_Byte:
-							returnedDataLen	=	BuildBinaryImage_Raw8(binaryDataBuffer, imgDataOffset, bufferSize);
+							returnedDataLen	=	BuildBinaryImage_Raw8(binaryDataBuffer, imgDataOffset, bufferSize, imgWindow);
 							break;
 
 						case kAlpacaImageData_Int16:
-							returnedDataLen	=	BuildBinaryImage_Raw8_16bit(binaryDataBuffer, imgDataOffset, bufferSize);
+							returnedDataLen	=	BuildBinaryImage_Raw8_16bit(binaryDataBuffer, imgDataOffset, bufferSize, imgWindow);
 							break;
 
 						case kAlpacaImageData_Int32:
-							returnedDataLen	=	BuildBinaryImage_Raw8_32bit(binaryDataBuffer, imgDataOffset, bufferSize);
+							returnedDataLen	=	BuildBinaryImage_Raw8_32bit(binaryDataBuffer, imgDataOffset, bufferSize, imgWindow);
 							break;
 
 						default:
@@ -4607,11 +5193,11 @@ bool				xmit16BitAs32Bit	=	false;
 					CONSOLE_DEBUG("kImageType_RAW16");
 					if (xmit16BitAs32Bit)
 					{
-						returnedDataLen	=	BuildBinaryImage_Raw32(binaryDataBuffer, imgDataOffset, bufferSize);
+						returnedDataLen	=	BuildBinaryImage_Raw32(binaryDataBuffer, imgDataOffset, bufferSize, imgWindow);
 					}
 					else
 					{
-						returnedDataLen	=	BuildBinaryImage_Raw16(binaryDataBuffer, imgDataOffset, bufferSize);
+						returnedDataLen	=	BuildBinaryImage_Raw16(binaryDataBuffer, imgDataOffset, bufferSize, imgWindow);
 					}
 					break;
 
@@ -4620,74 +5206,40 @@ bool				xmit16BitAs32Bit	=	false;
 					CONSOLE_DEBUG("kImageType_RGB24");
 					//if (bytesPerPixel == 3)
 					//{
-					//	returnedDataLen	=	BuildBinaryImage_RGB24(binaryDataBuffer, imgDataOffset, bufferSize);
+					//	returnedDataLen	=	BuildBinaryImage_RGB24(binaryDataBuffer, imgDataOffset, bufferSize, imgWindow);
 					//}
 					//else
 					//{
 					//+	binaryImageHdr.TransmissionElementType	=	kAlpacaImageData_Int32;	//	Element type as sent over the network
-					//+	returnedDataLen	=	BuildBinaryImage_RGB24_32bit((uint32_t *)binaryDataBuffer, imgDataOffset, bufferSize);
-						returnedDataLen	=	BuildBinaryImage_RGB24(binaryDataBuffer, imgDataOffset, bufferSize);
+					//+	returnedDataLen	=	BuildBinaryImage_RGB24_32bit((uint32_t *)binaryDataBuffer, imgDataOffset, bufferSize, imgWindow);
+						returnedDataLen	=	BuildBinaryImage_RGB24(binaryDataBuffer, imgDataOffset, bufferSize, imgWindow);
 					//}
 					break;
 
 				default:
-					CONSOLE_DEBUG_W_NUM("cLastExposure_ROIinfo.currentROIimageType\t=",	cLastExposure_ROIinfo.currentROIimageType);
-					CONSOLE_DEBUG_W_NUM("cLastExposure_ROIinfo.currentROIwidth    \t=",	cLastExposure_ROIinfo.currentROIwidth);
-					CONSOLE_DEBUG_W_NUM("cLastExposure_ROIinfo.currentROIheight   \t=",	cLastExposure_ROIinfo.currentROIheight);
+					CONSOLE_DEBUG_W_NUM("cFrameExpInfo.roiInfo.currentROIimageType\t=",	cFrameExpInfo.roiInfo.currentROIimageType);
+					CONSOLE_DEBUG_W_NUM("cFrameExpInfo.roiInfo.currentROIwidth    \t=",	cFrameExpInfo.roiInfo.currentROIwidth);
+					CONSOLE_DEBUG_W_NUM("cFrameExpInfo.roiInfo.currentROIheight   \t=",	cFrameExpInfo.roiInfo.currentROIheight);
 				//	CONSOLE_ABORT(__FUNCTION__);
 					returnedDataLen	=	0;
 					break;
 			}
 
 			CONSOLE_DEBUG_W_SIZE("bufferSize\t\t=", bufferSize);
-			//*	if the data buffer is small, send it as one block
-		//	if (bufferSize < (20 * 1000000))
-			if (1)
+
+			//*	replace the cached one, this buffer now belongs to the cache
+			StoreImageBytesCache(binaryDataBuffer, bufferSize, eTag);
+
+			httpStatus	=	SendImageBytesCache(reqData);
+			if (httpStatus == kSF_ShortSend)
 			{
-				CONSOLE_DEBUG_W_SIZE("Writting to TCP socket, bufferSize\t=", bufferSize);
-				bytesWritten	=	write(reqData->socket, binaryDataBuffer, bufferSize);
-				CONSOLE_DEBUG_W_SIZE("bytesWritten\t\t=", bytesWritten);
-				if (bytesWritten < bufferSize)
-				{
-					CONSOLE_DEBUG("FAILED!!! to transmit entire data block!!!!!!!!!!!!!!!");
-				}
-				else
-				{
-					alpacaErrCode	=	kASCOM_Err_Success;
-				}
+				GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Failed to send all of the image data");
+				alpacaErrCode	=	kASCOM_Err_DataFailure;
 			}
 			else
 			{
-			//*	send the data as multiple blocks
-			size_t			totalBytesWritten;
-			size_t			bytesPerBlock;
-			size_t			dataLeftToSend;
-			unsigned char 	*dataPointer;
-
-				CONSOLE_DEBUG("transmitting image data in blocks");
-			#define		kXmitBlockSize	(2 * 1000000)
-				totalBytesWritten	=	0;
-				dataPointer			=	binaryDataBuffer;
-				while (totalBytesWritten < bufferSize)
-				{
-					dataLeftToSend		=	bufferSize - totalBytesWritten;
-					if (dataLeftToSend > kXmitBlockSize)
-					{
-						bytesPerBlock	=	kXmitBlockSize;
-					}
-					else
-					{
-						bytesPerBlock	=	dataLeftToSend;
-					}
-					CONSOLE_DEBUG_W_SIZE("write() bytesPerBlock\t\t=", bytesPerBlock);
-					bytesWritten		=	write(reqData->socket, dataPointer, bytesPerBlock);
-					totalBytesWritten	+=	bytesWritten;
-					dataPointer			+=	bytesWritten;
-
-					CONSOLE_DEBUG_W_SIZE("bytesWritten\t\t=", bytesWritten);
-				}
+				alpacaErrCode	=	kASCOM_Err_Success;
 			}
-			free(binaryDataBuffer);
 		}
 		else
 		{
@@ -4702,7 +5254,9 @@ bool				xmit16BitAs32Bit	=	false;
 }
 
 //*****************************************************************************
-TYPE_ASCOM_STATUS	CameraDriver::Get_Imagearray_JSON(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
+TYPE_ASCOM_STATUS	CameraDriver::Get_Imagearray_JSON(	TYPE_GetPutRequestData	*reqData,
+														char					*alpacaErrMsg,
+														TYPE_IMAGE_WINDOW		*imgWindow)
 {
 TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_Success;
 TYPE_ASCOM_STATUS	tempErrCode;
@@ -4726,7 +5280,7 @@ char				httpHeader[500];
 
 	//========================================================================================
 	//*	record the time the image was taken
-	FormatTimeString_time_t(&cCameraProp.Lastexposure_StartTime.tv_sec, imageTimeString);
+	FormatTimeString_time_t(&cFrameExpInfo.startTime.tv_sec, imageTimeString);
 	cBytesWrittenForThisCmd	+=	JsonResponse_Add_String(mySocket,
 									reqData->jsonTextBuffer,
 									kMaxJsonBuffLen,
@@ -4736,7 +5290,7 @@ char				httpHeader[500];
 
 	//========================================================================================
 	//*	record the exposure time
-	exposureTimeSecs	=	(cCameraProp.Lastexposure_duration_us * 1.0) /
+	exposureTimeSecs	=	(cFrameExpInfo.duration_us * 1.0) /
 							1000000.0;
 	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
 									reqData->jsonTextBuffer,
@@ -4764,19 +5318,19 @@ char				httpHeader[500];
 
 	//*	get the ROI information which has the current image type
 //	GetImage_ROI_info();
-	pixelCount	=	cLastExposure_ROIinfo.currentROIwidth * cLastExposure_ROIinfo.currentROIheight;
-	CONSOLE_DEBUG_W_NUM("cLastExposure_ROIinfo.currentROIwidth\t=",		cLastExposure_ROIinfo.currentROIwidth);
-	CONSOLE_DEBUG_W_NUM("cLastExposure_ROIinfo.currentROIheight\t=",	cLastExposure_ROIinfo.currentROIheight);
+	pixelCount	=	imgWindow->outWidth * imgWindow->outHeight;
+	CONSOLE_DEBUG_W_NUM("imgWindow->outWidth\t=",		imgWindow->outWidth);
+	CONSOLE_DEBUG_W_NUM("imgWindow->outHeight\t=",	imgWindow->outHeight);
 	CONSOLE_DEBUG_W_NUM("pixelCount\t=", pixelCount);
 
 	CONSOLE_DEBUG_W_NUM("cCameraProp.ImageReady\t=", cCameraProp.ImageReady);
 //	CONSOLE_DEBUG_W_HEX("cCameraDataBuffer\t=", cCameraDataBuffer);
-	if (cCameraProp.ImageReady && (cCameraDataBuffer != NULL))
+	if (cCameraProp.ImageReady && (imgWindow->pixelPtr != NULL))
 	{
 		alpacaErrCode	=	kASCOM_Err_Success;
 		//========================================================================================
 		//*	record the image type
-//+			Read_ImageTypeString(cLastExposure_ROIinfo.currentROIimageType, asiImageTypeString);
+//+			Read_ImageTypeString(cFrameExpInfo.roiInfo.currentROIimageType, asiImageTypeString);
 //+			cBytesWrittenForThisCmd	+=	JsonResponse_Add_String(mySocket,
 //+									reqData->jsonTextBuffer,
 //+									kMaxJsonBuffLen,
@@ -4788,16 +5342,39 @@ char				httpHeader[500];
 										reqData->jsonTextBuffer,
 										kMaxJsonBuffLen,
 										"xsize",
-										cLastExposure_ROIinfo.currentROIwidth,
+										imgWindow->outWidth,
 										INCLUDE_COMMA);
 
 		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(mySocket,
 										reqData->jsonTextBuffer,
 										kMaxJsonBuffLen,
 										"ysize",
-										cLastExposure_ROIinfo.currentROIheight,
+										imgWindow->outHeight,
 										INCLUDE_COMMA);
 
+		//*	if this is a subframe, say where it came from
+		if (imgWindow->ownsBuffer)
+		{
+			cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(mySocket,
+											reqData->jsonTextBuffer,
+											kMaxJsonBuffLen,
+											"xstart",
+											imgWindow->xStart,
+											INCLUDE_COMMA);
+			cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(mySocket,
+											reqData->jsonTextBuffer,
+											kMaxJsonBuffLen,
+											"ystart",
+											imgWindow->yStart,
+											INCLUDE_COMMA);
+			cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(mySocket,
+											reqData->jsonTextBuffer,
+											kMaxJsonBuffLen,
+											"bin",
+											imgWindow->bin,
+											INCLUDE_COMMA);
+		}
+
 //		CONSOLE_DEBUG(__FUNCTION__);
 		//*	Type = 2  >> 32 bit interger
 		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	mySocket,
@@ -4808,7 +5385,7 @@ char				httpHeader[500];
 										INCLUDE_COMMA);
 
 		//*	determine the RANK of the image we are about to send.
-		switch(cLastExposure_ROIinfo.currentROIimageType)
+		switch(cFrameExpInfo.roiInfo.currentROIimageType)
 		{
 			case kImageType_RGB24:
 				imgRank	=	3;
@@ -4838,25 +5415,25 @@ char				httpHeader[500];
 		JsonResponse_SendTextBuffer(mySocket, reqData->jsonTextBuffer);
 
 		CONSOLE_DEBUG_W_NUM("pixelCount\t=", pixelCount);
-		switch(cLastExposure_ROIinfo.currentROIimageType)
+		switch(cFrameExpInfo.roiInfo.currentROIimageType)
 		{
 			case kImageType_RAW8:
 			case kImageType_Y8:
 			case kImageType_MONO8:
 				CONSOLE_DEBUG("kImageType_RAW8");
 				Send_imagearray_raw8(	mySocket,
-										cCameraDataBuffer,
-										cLastExposure_ROIinfo.currentROIheight,		//*	# of rows
-										cLastExposure_ROIinfo.currentROIwidth,		//*	# of columns
+										imgWindow->pixelPtr,
+										imgWindow->outHeight,						//*	# of rows
+										imgWindow->outWidth,						//*	# of columns
 										pixelCount);
 				break;
 
 			case kImageType_RAW16:
 				CONSOLE_DEBUG("kImageType_RAW16");
 				Send_imagearray_raw16(	mySocket,
-										(uint16_t *)cCameraDataBuffer,
-										cLastExposure_ROIinfo.currentROIheight,		//*	# of rows
-										cLastExposure_ROIinfo.currentROIwidth,		//*	# of columns
+										(uint16_t *)imgWindow->pixelPtr,
+										imgWindow->outHeight,						//*	# of rows
+										imgWindow->outWidth,						//*	# of columns
 										pixelCount);
 				break;
 
@@ -4864,9 +5441,9 @@ char				httpHeader[500];
 				CONSOLE_DEBUG("kImageType_RGB24");
 
 				Send_imagearray_rgb24(	mySocket,
-										cCameraDataBuffer,
-										cLastExposure_ROIinfo.currentROIheight,		//*	# of rows
-										cLastExposure_ROIinfo.currentROIwidth,		//*	# of columns
+										imgWindow->pixelPtr,
+										imgWindow->outHeight,						//*	# of rows
+										imgWindow->outWidth,						//*	# of columns
 										pixelCount);
 				break;
 
@@ -4897,23 +5474,124 @@ char				httpHeader[500];
 	return(alpacaErrCode);
 }
 
+//*****************************************************************************
+//*	imagearray?x=1000&y=800&width=512&height=512&bin=2
+//*		all of the window arguments are optional, the default is the whole
+//*		frame. The window is cut out of the last image, it does not change the
+//*		camera ROI (startx/starty/numx/numy)
+//*****************************************************************************
+TYPE_ASCOM_STATUS	CameraDriver::GetImageWindow(	TYPE_GetPutRequestData	*reqData,
+													TYPE_IMAGE_WINDOW		*imgWindow,
+													char					*alpacaErrMsg)
+{
+TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_Success;
+char				argumentString[32];
+int					srcWidth;
+int					srcHeight;
+int					channels;
+int					bytesPerValue;
+bool				widthFound;
+bool				heightFound;
+
+	srcWidth	=	cFrameExpInfo.roiInfo.currentROIwidth;
+	srcHeight	=	cFrameExpInfo.roiInfo.currentROIheight;
+	ImageWindow_Init(imgWindow, srcWidth, srcHeight);
+
+	if (GetKeyWordArgument(reqData->contentData, "x", argumentString, (sizeof(argumentString) -1), kIgnoreCase, kArgumentIsNumeric))
+	{
+		imgWindow->xStart	=	atoi(argumentString);
+	}
+	if (GetKeyWordArgument(reqData->contentData, "y", argumentString, (sizeof(argumentString) -1), kIgnoreCase, kArgumentIsNumeric))
+	{
+		imgWindow->yStart	=	atoi(argumentString);
+	}
+	widthFound	=	GetKeyWordArgument(reqData->contentData, "width", argumentString, (sizeof(argumentString) -1), kIgnoreCase, kArgumentIsNumeric);
+	if (widthFound)
+	{
+		imgWindow->width	=	atoi(argumentString);
+	}
+	heightFound	=	GetKeyWordArgument(reqData->contentData, "height", argumentString, (sizeof(argumentString) -1), kIgnoreCase, kArgumentIsNumeric);
+	if (heightFound)
+	{
+		imgWindow->height	=	atoi(argumentString);
+	}
+	if (GetKeyWordArgument(reqData->contentData, "bin", argumentString, (sizeof(argumentString) -1), kIgnoreCase, kArgumentIsNumeric))
+	{
+		imgWindow->bin	=	atoi(argumentString);
+	}
+	//*	x without a width means "to the right hand edge"
+	if (widthFound == false)
+	{
+		imgWindow->width	=	srcWidth - imgWindow->xStart;
+	}
+	if (heightFound == false)
+	{
+		imgWindow->height	=	srcHeight - imgWindow->yStart;
+	}
+
+	switch(cFrameExpInfo.roiInfo.currentROIimageType)
+	{
+		case kImageType_RAW16:
+			channels		=	1;
+			bytesPerValue	=	2;
+			break;
+
+		case kImageType_RGB24:
+			channels		=	3;
+			bytesPerValue	=	1;
+			break;
+
+		case kImageType_RAW8:
+		case kImageType_Y8:
+		case kImageType_MONO8:
+		default:
+			channels		=	1;
+			bytesPerValue	=	1;
+			break;
+	}
+
+	if (cCameraDataBuffer == NULL)
+	{
+		alpacaErrCode	=	kASCOM_Err_InvalidOperation;
+		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "No image available");
+	}
+	else if (ImageWindow_Extract(imgWindow, cCameraDataBuffer, srcWidth, srcHeight, channels, bytesPerValue) == false)
+	{
+		alpacaErrCode	=	kASCOM_Err_InvalidValue;
+		sprintf(alpacaErrMsg,	"x,y,width,height must be inside %dx%d, bin 1-%d",
+								srcWidth,
+								srcHeight,
+								kImageWindow_MaxBin);
+		CONSOLE_DEBUG(alpacaErrMsg);
+	}
+	return(alpacaErrCode);
+}
+
 //*****************************************************************************
 TYPE_ASCOM_STATUS	CameraDriver::Get_Imagearray(	TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
 {
 TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_Success;
+TYPE_IMAGE_WINDOW	imgWindow;
 
 	CONSOLE_DEBUG(__FUNCTION__);
 
 	if (cCameraProp.ImageReady)
 	{
-		if (strcasestr(reqData->htmlData, "application/imagebytes") != NULL)
+		alpacaErrCode	=	GetImageWindow(reqData, &imgWindow, alpacaErrMsg);
+		if (alpacaErrCode != kASCOM_Err_Success)
+		{
+			//*	nothing has been sent yet, let the error response have a header
+			cHttpHeaderSent	=	false;
+		}
+		else if (strcasestr(reqData->htmlData, "application/imagebytes") != NULL)
 		{
-			alpacaErrCode	=	Get_Imagearray_Binary(reqData, alpacaErrMsg);
+			alpacaErrCode	=	Get_Imagearray_Binary(reqData, alpacaErrMsg, &imgWindow);
 		}
 		else
 		{
-			alpacaErrCode	=	Get_Imagearray_JSON(reqData, alpacaErrMsg);
+			alpacaErrCode	=	Get_Imagearray_JSON(reqData, alpacaErrMsg, &imgWindow);
 		}
+		ImageWindow_Release(&imgWindow);
 	}
 	else
 	{
@@ -5189,11 +5867,169 @@ int				totalValuesWritten;
 }
 
 
+//*****************************************************************************
+//*	same as imagearray, "Accept: application/imagebytes" gets the binary version
+//*****************************************************************************
+TYPE_ASCOM_STATUS	CameraDriver::Get_RGBarray(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
+{
+TYPE_ASCOM_STATUS	alpacaErrCode;
+
+	CONSOLE_DEBUG(__FUNCTION__);
+	if (strcasestr(reqData->htmlData, "application/imagebytes") != NULL)
+	{
+		alpacaErrCode	=	Get_RGBarray_Binary(reqData, alpacaErrMsg);
+	}
+	else
+	{
+		alpacaErrCode	=	Get_RGBarray_JSON(reqData, alpacaErrMsg);
+	}
+	return(alpacaErrCode);
+}
+
+//*****************************************************************************
+//*	converts straight from the camera buffer, see ImageWindow_BuildRGB()
+//*	RAW16 is sent as 16 bit values, everything else as bytes
+//*	returns byte count
+//*****************************************************************************
+int	CameraDriver::BuildBinaryImage_RGBarray(	unsigned char	*binaryDataBuffer,
+												const int		width,
+												const int		height,
+												const int		imageType)
+{
+int		channels;
+int		bytesPerValue;
+
+	switch(imageType)
+	{
+		case kImageType_RGB24:
+			channels		=	3;
+			bytesPerValue	=	1;
+			break;
+
+		case kImageType_RAW16:
+			channels		=	1;
+			bytesPerValue	=	2;
+			break;
+
+		case kImageType_RAW8:
+		case kImageType_Y8:
+		case kImageType_MONO8:
+			channels		=	1;
+			bytesPerValue	=	1;
+			break;
+
+		default:
+			CONSOLE_DEBUG_W_NUM("Image type not handled:", imageType);
+			return(0);
+	}
+	ImageWindow_BuildRGB(binaryDataBuffer, cCameraDataBuffer, width, height, channels, bytesPerValue);
+	return(width * height * 3 * bytesPerValue);
+}
+
+//*****************************************************************************
+//*	rgbarray as ImageBytes, the standard rank 3 layout [width][height][3]
+//*	No JSON text at all, 3 (or 6 for RAW16) bytes per pixel instead of ~9 characters.
+//*	It shares the ImageBytes cache with imagearray, the Range pieces of one
+//*	download are all sent from the same buffer instead of being rebuilt.
+//*****************************************************************************
+TYPE_ASCOM_STATUS	CameraDriver::Get_RGBarray_Binary(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
+{
+TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_Success;
+TYPE_BinaryImageHdr	*binaryImageHdr;
+unsigned char		*binaryDataBuffer;
+size_t				bufferSize;
+int					imgWidth;
+int					imgHeight;
+int					imageType;
+int					bytesPerValue;
+int					httpStatus;
+char				eTag[96];
+
+	CONSOLE_DEBUG(__FUNCTION__);
+
+	//*	the geometry of the frame in the buffer, the camera ROI may have changed since
+	imgWidth	=	cFrameExpInfo.roiInfo.currentROIwidth;
+	imgHeight	=	cFrameExpInfo.roiInfo.currentROIheight;
+	imageType	=	cFrameExpInfo.roiInfo.currentROIimageType;
+	if ((cCameraProp.ImageReady == false) || (cCameraDataBuffer == NULL) || (imgWidth <= 0) || (imgHeight <= 0))
+	{
+		//*	nothing has been sent yet, let the error response have a header
+		cHttpHeaderSent	=	false;
+		alpacaErrCode	=	kASCOM_Err_InvalidOperation;
+		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "No image available");
+		return(alpacaErrCode);
+	}
+
+	sprintf(eTag,	"\"%ld-%ld.%06ld-rgb-%d-%d-%d\"",
+					cFrameExpInfo.frameNum,
+					(long)cFrameExpInfo.startTime.tv_sec,
+					(long)cFrameExpInfo.startTime.tv_usec,
+					imgWidth,
+					imgHeight,
+					imageType);
+	if (CheckImageBytesCache(reqData, eTag))
+	{
+		cSendJSONresponse	=	false;
+		httpStatus			=	SendImageBytesCache(reqData);
+		if (httpStatus == kSF_ShortSend)
+		{
+			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Failed to send all of the image data");
+			return(kASCOM_Err_DataFailure);
+		}
+		return(kASCOM_Err_Success);
+	}
+
+	bytesPerValue		=	(imageType == kImageType_RAW16) ? 2 : 1;
+	bufferSize			=	sizeof(TYPE_BinaryImageHdr) + ((size_t)imgWidth * imgHeight * 3 * bytesPerValue);
+	binaryDataBuffer	=	(unsigned char *)malloc(bufferSize);
+	if (binaryDataBuffer == NULL)
+	{
+		cHttpHeaderSent	=	false;
+		alpacaErrCode	=	kASCOM_Err_FailedUnknown;
+		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Failed to allocate data buffer");
+		return(alpacaErrCode);
+	}
+	gImageDownloadInProgress	=	true;
+	cSendJSONresponse			=	false;
+
+	binaryImageHdr	=	(TYPE_BinaryImageHdr *)binaryDataBuffer;
+	memset((void *)binaryImageHdr, 0, sizeof(TYPE_BinaryImageHdr));
+	binaryImageHdr->MetadataVersion			=	1;
+	binaryImageHdr->ErrorNumber				=	0;
+	binaryImageHdr->DataStart				=	sizeof(TYPE_BinaryImageHdr);
+	if (bytesPerValue == 2)
+	{
+		binaryImageHdr->ImageElementType		=	kAlpacaImageData_UInt16;
+		binaryImageHdr->TransmissionElementType	=	kAlpacaImageData_UInt16;
+	}
+	else
+	{
+		binaryImageHdr->ImageElementType		=	kAlpacaImageData_Byte;
+		binaryImageHdr->TransmissionElementType	=	kAlpacaImageData_Byte;
+	}
+	binaryImageHdr->Rank					=	3;
+	binaryImageHdr->Dimension1				=	imgWidth;
+	binaryImageHdr->Dimension2				=	imgHeight;
+	binaryImageHdr->Dimension3				=	3;
+	BuildBinaryImage_RGBarray(&binaryDataBuffer[sizeof(TYPE_BinaryImageHdr)], imgWidth, imgHeight, imageType);
+
+	//*	the buffer now belongs to the cache, the transaction IDs are filled in when it is sent
+	StoreImageBytesCache(binaryDataBuffer, bufferSize, eTag);
+	httpStatus	=	SendImageBytesCache(reqData);
+	if (httpStatus == kSF_ShortSend)
+	{
+		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Failed to send all of the image data");
+		alpacaErrCode	=	kASCOM_Err_DataFailure;
+	}
+	gImageDownloadInProgress	=	false;
+	return(alpacaErrCode);
+}
+
 //*****************************************************************************
 //*	this always returns 24 bit pixels, in hex they are 0x00RRGGBB
 //*	if the image is b/w, it converts the pixel to the RGB grey scale equivalent
 //*****************************************************************************
-TYPE_ASCOM_STATUS	CameraDriver::Get_RGBarray(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
+TYPE_ASCOM_STATUS	CameraDriver::Get_RGBarray_JSON(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
 {
 TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_Success;
 int					pixelCount;
@@ -5206,6 +6042,7 @@ char				lineBuff[256];
 char				imageTimeString[256];
 double				exposureTimeSecs;
 TYPE_ASCOM_STATUS	tempSensorErr;
+char				httpHeader[500];
 
 	CONSOLE_DEBUG(__FUNCTION__);
 	gImageDownloadInProgress	=	true;
@@ -5216,9 +6053,12 @@ TYPE_ASCOM_STATUS	tempSensorErr;
 
 	mySocket	=	reqData->socket;
 
+	JsonResponse_FinishHeader(200, httpHeader, "");
+	JsonResponse_SendTextBuffer(mySocket, httpHeader);
+
 	//========================================================================================
 	//*	record the time the image was taken
-	FormatTimeString_time_t(&cCameraProp.Lastexposure_StartTime.tv_sec, imageTimeString);
+	FormatTimeString_time_t(&cFrameExpInfo.startTime.tv_sec, imageTimeString);
 	cBytesWrittenForThisCmd	+=	JsonResponse_Add_String(mySocket,
 									reqData->jsonTextBuffer,
 									kBuffSize_MaxSpeed,
@@ -5228,7 +6068,7 @@ TYPE_ASCOM_STATUS	tempSensorErr;
 
 	//========================================================================================
 	//*	record the exposure time
-	exposureTimeSecs	=	(cCameraProp.Lastexposure_duration_us * 1.0) /
+	exposureTimeSecs	=	(cFrameExpInfo.duration_us * 1.0) /
 							1000000.0;
 	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
 									reqData->jsonTextBuffer,
@@ -6180,6 +7020,11 @@ TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_InternalError;
 //*		Count				Number of frames to to take		Defaults to 5
 //*		Delay				Seconds between frames			Defaults to 0
 //*		DeltaDuration		Seconds between frames			Defaults to 0
+//*		Pipelined			true/false						Defaults to false
+//*							re-arm the sensor as soon as readout is done,
+//*							the frame is processed while the next one is exposing
+//*		MinDutyCycle		Percent (exposing / wall time)	Defaults to 0 (no check)
+//*							below it, sequence-dutycycle-ok in readall is false
 //*
 //*****************************************************************************
 TYPE_ASCOM_STATUS	CameraDriver::Put_StartSequence(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
@@ -6188,9 +7033,13 @@ TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_InternalError;
 bool				sequenceCntFound;
 bool				delayFound;
 bool				deltaDurationFound;
+bool				pipelinedFound;
+bool				minDutyCycleFound;
 char				countString[32];
 char				delayString[32];
 char				deltaDurationString[32];
+char				pipelinedString[32];
+char				minDutyCycleString[32];
 int					sequenceCnt;
 double				delay_secs;
 double				deltaExp_secs;
@@ -6220,6 +7069,17 @@ double				deltaExp_secs;
 												deltaDurationString,
 												(sizeof(deltaDurationString) -1),
 												kArgumentIsNumeric);
+
+	pipelinedFound		=	GetKeyWordArgument(	reqData->contentData,
+												"Pipelined",
+												pipelinedString,
+												(sizeof(pipelinedString) -1));
+
+	minDutyCycleFound	=	GetKeyWordArgument(	reqData->contentData,
+												"MinDutyCycle",
+												minDutyCycleString,
+												(sizeof(minDutyCycleString) -1),
+												kArgumentIsNumeric);
 	//==============================================
 	if (sequenceCntFound)
 	{
@@ -6249,7 +7109,35 @@ double				deltaExp_secs;
 	{
 		cSeqDeltaExposure_us	=	0;
 	}
+	//==============================================
+	cSeqPipelined		=	false;
+	if (pipelinedFound)
+	{
+		if (IsValidTrueFalseString(pipelinedString))
+		{
+			cSeqPipelined	=	IsTrueFalse(pipelinedString);
+		}
+		else
+		{
+			alpacaErrCode	=	kASCOM_Err_InvalidValue;
+			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Pipelined must be true or false");
+			return(alpacaErrCode);
+		}
+	}
+	//==============================================
+	cSeqMinDutyCycle	=	0.0;
+	if (minDutyCycleFound)
+	{
+		cSeqMinDutyCycle	=	AsciiToDouble(minDutyCycleString);
+	}
 
+	//*	reset the duty cycle statistics
+	cSeqDutyCycleOK				=	true;
+	cSeqDutyCycle				=	0.0;
+	cSeqExposing_us				=	0;
+	cSeqWall_us					=	0;
+	cSeqDutyFrameCnt			=	0;
+	cSeqOverlap_us				=	0;
 
 	cNumFramesRequested			=	sequenceCnt;
 	cNumFramesToSave			=	sequenceCnt;
@@ -6292,6 +7180,10 @@ bool		successFlag;
 		if (cCameraDataBuffer != NULL)
 		{
 			CONSOLE_DEBUG("Freeing existing buffer");
+		#ifdef _USE_OPENCV_
+			//*	the openCV image may be pointing at this buffer
+			ReleaseOpenCVImage();
+		#endif
 			//*	buffer is not big enough, free it so we can allocate a new one
 			free(cCameraDataBuffer);
 			cCameraDataBuffer	=	NULL;
@@ -6554,10 +7446,48 @@ TYPE_ASCOM_STATUS		alpacaErrCode;
 }
 
 //*****************************************************************************
-TYPE_ASCOM_STATUS		CameraDriver::Abort_Exposure(void)
+//*	Called by each multicam thread before it waits at the start gate.
+//*	Everything that can be done before the shutter opens is done here,
+//*	the save flag, the ROI lookup (slow on some SDKs) and the exposure info.
+//*****************************************************************************
+void	CameraDriver::SyncExposure_Arm(const int32_t exposureMicrosecs)
 {
-TYPE_ASCOM_STATUS		alpacaErrCode	=	kASCOM_Err_NotImplemented;
-
+	cCurrentExposure_us		=	exposureMicrosecs;
+	cCameraProp.ImageReady	=	false;
+	SaveNextImage();
+	SetLastExposureInfo();
+}
+
+//*****************************************************************************
+//*	Called by each multicam thread as soon as it is released from the start gate.
+//*	Only the SDK start call is left, the start time is taken when it returns,
+//*	that is the first time we know the exposure is running.
+//*	The SDK latency is part of the skew.
+//*****************************************************************************
+TYPE_ASCOM_STATUS	CameraDriver::SyncExposure_Trigger(void)
+{
+TYPE_ASCOM_STATUS	alpacaErrCode;
+
+	gettimeofday(&cSyncTriggerTime, NULL);
+	alpacaErrCode		=	Start_CameraExposure(cCurrentExposure_us);
+	gettimeofday(&cSyncStartTime, NULL);
+
+	//*	SetLastExposureInfo() took the time before the gate opened
+	cCameraProp.Lastexposure_StartTime	=	cSyncStartTime;
+#ifdef _ENABLE_GLOBAL_GPS_
+	cExposureStartPPS		=	cSyncStartTime;
+	cExposureStartPPSvalid	=	PPS_CorrectTimeval(&gPPSdata, &cExposureStartPPS);
+#endif
+	cSyncLatency_us		=	((cSyncStartTime.tv_sec - cSyncTriggerTime.tv_sec) * 1000000) +
+							(cSyncStartTime.tv_usec - cSyncTriggerTime.tv_usec);
+	return(alpacaErrCode);
+}
+
+//*****************************************************************************
+TYPE_ASCOM_STATUS		CameraDriver::Abort_Exposure(void)
+{
+TYPE_ASCOM_STATUS		alpacaErrCode	=	kASCOM_Err_NotImplemented;
+
 	//*	this should be over ridden
 	strcpy(cLastCameraErrMsg, "Not finished-");
 	strcat(cLastCameraErrMsg, __FILE__);
@@ -6825,6 +7755,46 @@ char	lineBuffer[512];
 		SocketWriteData(reqData->socket,	lineBuffer);
 		SocketWriteData(reqData->socket,	"</CENTER>\r\n");
 	}
+
+#ifdef _ENABLE_FITS_
+TYPE_FITS_HDR	*fitsHdr;
+char			cardText[kFitsHdr_CardLen + 1];
+char			*outPtr;
+int				cardIdx;
+int				ccc;
+
+	//===============================================================
+	//*	the FITS header of the current frame, from the header cache
+	if (cFramesRead > 0)
+	{
+		BuildFitsHeaderCache();
+	}
+	fitsHdr	=	FitsHdrCache_Acquire(cFitsHdrCache, kFitsHdr_Newest);
+	if (fitsHdr != NULL)
+	{
+		sprintf(lineBuffer,	"<CENTER><H3>FITS header, frame %u</H3></CENTER>\r\n<PRE>\r\n",	fitsHdr->frameNum);
+		SocketWriteData(reqData->socket,	lineBuffer);
+		for (cardIdx=0; cardIdx < fitsHdr->cardCnt; cardIdx++)
+		{
+			FitsHdr_GetCard(fitsHdr, cardIdx, cardText);
+			outPtr	=	lineBuffer;
+			for (ccc=0; cardText[ccc] != 0; ccc++)
+			{
+				switch(cardText[ccc])
+				{
+					case '<':	strcpy(outPtr, "&lt;");		outPtr	+=	4;	break;
+					case '>':	strcpy(outPtr, "&gt;");		outPtr	+=	4;	break;
+					case '&':	strcpy(outPtr, "&amp;");	outPtr	+=	5;	break;
+					default:	*outPtr++	=	cardText[ccc];				break;
+				}
+			}
+			strcpy(outPtr, "\r\n");
+			SocketWriteData(reqData->socket,	lineBuffer);
+		}
+		SocketWriteData(reqData->socket,	"</PRE>\r\n");
+		FitsHdrCache_Release(cFitsHdrCache, fitsHdr);
+	}
+#endif // _ENABLE_FITS_
 }
 
 #pragma mark -
@@ -7307,11 +8277,6 @@ int32_t	CameraDriver::RunStateMachine_Idle(void)
 {
 TYPE_ASCOM_STATUS	alpacaErrCode;
 int32_t				delayMicroSecs;
-bool				startNextFrame;
-struct timeval		currentTime;
-uint32_t			currentMilliSecs;
-uint32_t			startofLastExp;
-uint32_t			elapsedMilliSecs;
 
 	if (cUpdateOtherDevices)
 	{
@@ -7343,30 +8308,10 @@ uint32_t			elapsedMilliSecs;
 			//*	prepare for the next image
 			if (cNumFramesToSave > 0)
 			{
-				startNextFrame		=	false;
-
-				//*	calculate time since last picture was STARTED
-				gettimeofday(&currentTime, NULL);
-				currentMilliSecs	=	Calc_millisFromTimeStruct(&currentTime);
-				startofLastExp		=	Calc_millisFromTimeStruct(&cCameraProp.Lastexposure_StartTime);
-				elapsedMilliSecs	=	currentMilliSecs - startofLastExp;
-
 				//*	is it time to start the next image?
-				if (elapsedMilliSecs > (cSequenceDelay_us / 1000))
-				{
-					startNextFrame	=	true;
-				}
-
-				if (startNextFrame)
+				if (Sequence_ReadyForNextFrame())
 				{
-					CONSOLE_DEBUG_W_NUM("Starting next image in sequence", cNumFramesToSave);
-					//*	start next image
-					cCurrentExposure_us	+=	cSeqDeltaExposure_us;
-					SaveNextImage();
-					alpacaErrCode		=	Start_CameraExposure(cCurrentExposure_us);
-					GenerateFileNameRoot();
-					cImageSeqNumber++;
-					cNumFramesToSave--;
+					alpacaErrCode	=	Sequence_StartNextFrame();
 				}
 			}
 			else
@@ -7407,11 +8352,137 @@ uint32_t			elapsedMilliSecs;
 	return(delayMicroSecs);
 }
 
+//*****************************************************************************
+//*	returns true if the delay since the last frame of the sequence was STARTED has expired
+//*****************************************************************************
+bool	CameraDriver::Sequence_ReadyForNextFrame(void)
+{
+bool				startNextFrame;
+struct timeval		currentTime;
+uint32_t			currentMilliSecs;
+uint32_t			startofLastExp;
+uint32_t			elapsedMilliSecs;
+
+	startNextFrame	=	false;
+	if ((cImageMode == kImageMode_Sequence) && (cNumFramesToSave > 0))
+	{
+		//*	calculate time since last picture was STARTED
+		gettimeofday(&currentTime, NULL);
+		currentMilliSecs	=	Calc_millisFromTimeStruct(&currentTime);
+		startofLastExp		=	Calc_millisFromTimeStruct(&cCameraProp.Lastexposure_StartTime);
+		elapsedMilliSecs	=	currentMilliSecs - startofLastExp;
+
+		if (elapsedMilliSecs > (cSequenceDelay_us / 1000))
+		{
+			startNextFrame	=	true;
+		}
+	}
+	return(startNextFrame);
+}
+
+//*****************************************************************************
+TYPE_ASCOM_STATUS	CameraDriver::Sequence_StartNextFrame(void)
+{
+TYPE_ASCOM_STATUS	alpacaErrCode;
+
+	CONSOLE_DEBUG_W_NUM("Starting next image in sequence", cNumFramesToSave);
+	if (cImageSeqNumber == 0)
+	{
+		//*	first frame, this is the start of the duty cycle measurement
+		gettimeofday(&cSeqStartTime, NULL);
+	}
+	//*	start next image
+	cCurrentExposure_us	+=	cSeqDeltaExposure_us;
+	cSyncStartValid		=	false;
+	SaveNextImage();
+	alpacaErrCode		=	Start_CameraExposure(cCurrentExposure_us);
+	GenerateFileNameRoot();
+	cImageSeqNumber++;
+	cNumFramesToSave--;
+	return(alpacaErrCode);
+}
+
+//*****************************************************************************
+//*	called each time a sequence frame has been read out
+//*	duty cycle = time the sensor was exposing / wall time
+//*	if the duty cycle is below cSeqMinDutyCycle, cSeqDutyCycleOK is cleared,
+//*	the sequence keeps going in the mode the client asked for.
+//*	The client checks sequence-dutycycle-ok in readall
+//*****************************************************************************
+void	CameraDriver::Sequence_UpdateDutyCycle(void)
+{
+int64_t		frameBusy_us;
+int64_t		frameExposing_us;
+bool		dutyCycleOK;
+char		dutyCycleMsg[160];
+
+	//*	readout is not exposing, only count the exposure time
+	frameBusy_us		=	((cFrameExpInfo.endTime.tv_sec - cFrameExpInfo.startTime.tv_sec) * 1000000LL) +
+							(cFrameExpInfo.endTime.tv_usec - cFrameExpInfo.startTime.tv_usec);
+	frameExposing_us	=	cFrameExpInfo.duration_us;
+	if (frameExposing_us > frameBusy_us)
+	{
+		frameExposing_us	=	frameBusy_us;
+	}
+	cSeqWall_us		=	((cFrameExpInfo.endTime.tv_sec - cSeqStartTime.tv_sec) * 1000000LL) +
+						(cFrameExpInfo.endTime.tv_usec - cSeqStartTime.tv_usec);
+	if (frameExposing_us > 0)
+	{
+		cSeqExposing_us	+=	frameExposing_us;
+	}
+	cSeqDutyFrameCnt++;
+	if (cSeqWall_us > 0)
+	{
+		cSeqDutyCycle	=	(100.0 * cSeqExposing_us) / cSeqWall_us;
+	}
+
+	//*	one frame says nothing about the gaps between frames
+	dutyCycleOK	=	true;
+	if ((cSeqMinDutyCycle > 0.0) && (cSeqDutyFrameCnt >= 2) && (cSeqDutyCycle < cSeqMinDutyCycle))
+	{
+		dutyCycleOK	=	false;
+	}
+	if (dutyCycleOK != cSeqDutyCycleOK)
+	{
+		sprintf(dutyCycleMsg, "Sequence (%s) duty cycle %1.2f%% is %s the minimum of %1.2f%%",
+								(cSeqPipelined ? "pipelined" : "serial"),
+								cSeqDutyCycle,
+								(dutyCycleOK ? "back above" : "below"),
+								cSeqMinDutyCycle);
+		CONSOLE_DEBUG(dutyCycleMsg);
+		LogEvent(	"camera",
+					__FUNCTION__,
+					NULL,
+					kASCOM_Err_Success,
+					dutyCycleMsg);
+	}
+	cSeqDutyCycleOK	=	dutyCycleOK;
+
+	//*	was that the last frame?
+	if (cNumFramesToSave <= 0)
+	{
+		sprintf(dutyCycleMsg, "Sequence of %d frames (%s), duty cycle=%1.2f%%, exposing=%lld us, wall=%lld us, overlap=%lld us",
+								cSeqDutyFrameCnt,
+								(cSeqPipelined ? "pipelined" : "serial"),
+								cSeqDutyCycle,
+								(long long)cSeqExposing_us,
+								(long long)cSeqWall_us,
+								(long long)cSeqOverlap_us);
+		CONSOLE_DEBUG(dutyCycleMsg);
+	}
+}
+
 //*****************************************************************************
 int	CameraDriver::RunStateMachine_TakingPicture(void)
 {
 int					exposureState;
 TYPE_ASCOM_STATUS	alpacaErrCode;
+bool				sensorReArmed;
+struct timeval		processingDone;
+#ifdef _USE_OPENCV_
+struct timeval		openCVstart;
+struct timeval		openCVdone;
+#endif
 
 //	CONSOLE_DEBUG(__FUNCTION__);
 
@@ -7454,16 +8525,72 @@ TYPE_ASCOM_STATUS	alpacaErrCode;
 			}
 
 			cWorkingLoopCnt		=	0;
+			sensorReArmed		=	false;
+			if (cImageMode == kImageMode_Sequence)
+			{
+				//*	in a pipelined sequence the previous frame was still available,
+				//*	it is about to be replaced
+				cCameraProp.ImageReady	=	false;
+			}
 			//*	Extract Image
 			alpacaErrCode		=	Read_ImageData();
 			if (alpacaErrCode == kASCOM_Err_Success)
 			{
 				//*	record the time the exposure ended
 				gettimeofday(&cCameraProp.Lastexposure_EndTime, NULL);
+				//*	from here on, everything that works on this frame uses cFrameExpInfo,
+				//*	the Lastexposure info changes as soon as the next exposure starts
+				cFrameExpInfo.roiInfo		=	cLastExposure_ROIinfo;
+				cFrameExpInfo.startTime		=	cCameraProp.Lastexposure_StartTime;
+				cFrameExpInfo.endTime		=	cCameraProp.Lastexposure_EndTime;
+				cFrameExpInfo.duration_us	=	cCameraProp.Lastexposure_duration_us;
+				cFrameExpInfo.frameNum		=	cFramesRead;
 				cNewImageReadyToDisplay		=	true;
 				cCameraProp.ImageReady		=	true;
 //				CONSOLE_DEBUG("cCameraProp.ImageReady set to TRUE!!!!!!!!!!!!!!");
 
+				if (cImageMode == kImageMode_Sequence)
+				{
+					Sequence_UpdateDutyCycle();
+
+					//*	pipelined sequence, the frame is in the data buffer, re-arm the sensor
+					//*	now and do the processing below while the next frame is exposing.
+					//*	The data buffer is not touched again until the next Read_ImageData()
+					//*	The processing still runs on this thread, there is no worker queue,
+					//*	if it takes longer than the exposure the next readout waits for it
+					if (cSeqPipelined && Sequence_ReadyForNextFrame())
+					{
+						if (Sequence_StartNextFrame() == kASCOM_Err_Success)
+						{
+							sensorReArmed			=	true;
+							//*	some drivers clear ImageReady when they start an exposure,
+							//*	the completed frame stays downloadable until it is replaced
+							cCameraProp.ImageReady	=	true;
+						}
+						else
+						{
+							CONSOLE_DEBUG("Failed to re-arm sensor, resetting to single image mode");
+							cImageMode	=	kImageMode_Single;
+						}
+					}
+				}
+
+				//*	after the re-arm, these work on the frame in the data buffer
+				//*	while the next one is exposing
+			#ifdef _ENABLE_SHM_FRAMES_
+				PublishSharedMemoryFrame();
+			#endif
+			#ifdef _ENABLE_MJPEG_STREAM_
+				PublishMJPEGframe();
+			#endif
+			#ifdef _ENABLE_PREVIEW_PYRAMID_
+				//*	nothing is built until a client asks for a preview, see Get_Preview()
+				if (cPreviewPyramid != NULL)
+				{
+					BuildPreviewPyramid(cPreviewPyramid);
+				}
+			#endif
+
 				if (cImageMode == kImageMode_Live)
 				{
 				double	secondsOfExposure;
@@ -7476,6 +8603,7 @@ TYPE_ASCOM_STATUS	alpacaErrCode;
 					cFrameRate	=	(cFramesRead * 1.0) / secondsOfExposure;
 				}
 		#ifdef _USE_OPENCV_
+				gettimeofday(&openCVstart, NULL);
 				CreateOpenCVImage(cCameraDataBuffer);
 			#ifdef _IMAGE_OVERLAY_
 				if (cOverlayMode)
@@ -7483,6 +8611,9 @@ TYPE_ASCOM_STATUS	alpacaErrCode;
 					DrawOverlayOntoImage();
 				}
 			#endif
+				gettimeofday(&openCVdone, NULL);
+				cOpenCV_FrameTime_us	=	((openCVdone.tv_sec - openCVstart.tv_sec) * 1000000) +
+											(openCVdone.tv_usec - openCVstart.tv_usec);
 		#endif
 
 				//*	Image saving disabled - images are no longer automatically saved
@@ -7505,9 +8636,20 @@ TYPE_ASCOM_STATUS	alpacaErrCode;
 				//*	check for live window
 				if (cLiveController != NULL)
 				{
+					gettimeofday(&openCVstart, NULL);
 					UpdateLiveWindow();
+					gettimeofday(&openCVdone, NULL);
+					cOpenCV_FrameTime_us	+=	((openCVdone.tv_sec - openCVstart.tv_sec) * 1000000) +
+												(openCVdone.tv_usec - openCVstart.tv_usec);
 				}
 			#endif
+				if (sensorReArmed)
+				{
+					//*	all of the processing above was done while the next frame was exposing
+					gettimeofday(&processingDone, NULL);
+					cSeqOverlap_us	+=	((processingDone.tv_sec - cCameraProp.Lastexposure_StartTime.tv_sec) * 1000000LL) +
+										(processingDone.tv_usec - cCameraProp.Lastexposure_StartTime.tv_usec);
+				}
 			}
 			else
 			{
@@ -7516,7 +8658,10 @@ TYPE_ASCOM_STATUS	alpacaErrCode;
 				cImageMode				=	kImageMode_Single;
 			}
 
-			cInternalCameraState	=	kCameraState_Idle;
+			if (sensorReArmed == false)
+			{
+				cInternalCameraState	=	kCameraState_Idle;
+			}
 			break;
 
 		case kExposure_Failed:
@@ -7535,6 +8680,40 @@ TYPE_ASCOM_STATUS	alpacaErrCode;
 	return(exposureState);
 }
 
+//*****************************************************************************
+//*	if we support camera temperature, log it every 30 seconds
+//*	called from RunStateMachine() or from the read thread, never both
+//*****************************************************************************
+void	CameraDriver::TemperatureLog_Update(void)
+{
+time_t				deltaSeconds;
+time_t				currentSeconds;
+TYPE_ASCOM_STATUS	alpacaErrCode;
+
+	if (cTempReadSupported)
+	{
+		currentSeconds	=   GetSecondsSinceEpoch();
+		deltaSeconds	=	currentSeconds - cLastTempUpdate_Secs;
+		if (deltaSeconds >= 30)
+		{
+			alpacaErrCode	=	Read_SensorTemp();
+			if (alpacaErrCode == kASCOM_Err_Success)
+			{
+				TemperatureLog_AddEntry(cCameraProp.CCDtemperature);
+				if (cCameraProp.CanGetCoolerPower && (Read_CoolerPowerLevel() == kASCOM_Err_Success))
+				{
+					TimeSeries_Log(&cCoolerPowerChannel, "CoolerPower", cCameraProp.CoolerPower);
+				}
+			}
+			else
+			{
+				CONSOLE_DEBUG_W_NUM("Read_SensorTemp() failed,  alpacaErrCode\t=",	alpacaErrCode);
+			}
+			cLastTempUpdate_Secs	=	currentSeconds;
+		}
+	}
+}
+
 //*****************************************************************************
 int32_t	CameraDriver::RunStateMachine(void)
 {
@@ -7603,33 +8782,10 @@ int32_t		delayMicroSecs;
 
 #ifndef _USE_CAMERA_READ_THREAD_
 	//*	if the read thread is enabled, this operation is handled there
-	if (cTempReadSupported)
-	{
-	time_t		deltaSeconds;
-	time_t		currentSeconds;
-
-		//*	if we support camera temperature, log it every 30 seconds
-		currentSeconds	=   GetSecondsSinceEpoch();
-		deltaSeconds	=	currentSeconds - cLastTempUpdate_Secs;
-		if (deltaSeconds >= 30)
-		{
-		TYPE_ASCOM_STATUS	alpacaErrCode;
-
-			alpacaErrCode	=	Read_SensorTemp();
-			if (alpacaErrCode == kASCOM_Err_Success)
-			{
-				CONSOLE_DEBUG_W_DBL("cCameraProp.CCDtemperature\t=",	cCameraProp.CCDtemperature);
-				TemperatureLog_AddEntry(cCameraProp.CCDtemperature);
-			}
-			else
-			{
-				CONSOLE_DEBUG_W_NUM("Read_SensorTemp() failed,  alpacaErrCode\t=",	alpacaErrCode);
-			}
-			cLastTempUpdate_Secs	=	currentSeconds;
-		}
-	}
+	TemperatureLog_Update();
 #endif // _USE_CAMERA_READ_THREAD_
 
+	FreeStaleImageBytes();
 	CheckPulseGuiding();
 	RunStateMachine_Device();
 	return(delayMicroSecs);
@@ -7736,15 +8892,17 @@ char		fileNameDateString[64];
 	//*	are we suppose to include the filter name
 	if (cFN.IncludeFilter)
 	{
-	char	filterName1stChar[8];
-	bool	addFilterName;
+	char				filterName1stChar[8];
+	bool				addFilterName;
+	TYPE_DeviceSnapshot	fwSnapshot;
 
 //		CONSOLE_DEBUG("cFN.IncludeFilter");
 
-		if (cConnectedFilterWheel != NULL)
+		//*	use the state published by the filter wheel
+		if (DeviceSnapshot_Read(kDeviceType_Filterwheel, cAlpacaDeviceNum, &fwSnapshot))
 		{
-			cFilterWheelCurrPos			=	cConnectedFilterWheel->cFilterWheelProp.Position;
-			strcpy(cFilterWheelCurrName,	cConnectedFilterWheel->cFilterWheelCurrName);
+			cFilterWheelCurrPos			=	fwSnapshot.dev.filterwheel.Position;
+			strcpy(cFilterWheelCurrName,	fwSnapshot.dev.filterwheel.FilterName);
 		}
 
 		if ((cFilterWheelCurrPos >= 0) && (strlen(cFilterWheelCurrName) > 0))
@@ -7822,6 +8980,12 @@ int					iii;
 	CONSOLE_DEBUG_W_STR(__FUNCTION__, gImageDataDir);
 //	DumpRequestStructure(__FUNCTION__, reqData);
 
+#ifdef _ENABLE_FILE_INDEX_
+	if (FileIndex_IsOpen())
+	{
+		return(Get_FilelistIndexed(reqData, alpacaErrMsg));
+	}
+#endif
 	mySocketFD	=	reqData->socket;
 
 	directory	=	opendir(gImageDataDir);
@@ -7971,6 +9135,190 @@ int					iii;
 }
 
 
+#ifdef _ENABLE_FILE_INDEX_
+//*****************************************************************************
+//*	copies a string with " and \ escaped and control characters dropped,
+//*	jsonText has to be at least (2 * strlen(srcText)) + 1
+//*****************************************************************************
+static void	CopyJsonEscaped(char *jsonText, const char *srcText)
+{
+int		ccc;
+
+	for (ccc=0; srcText[ccc] != 0; ccc++)
+	{
+		if ((srcText[ccc] == '"') || (srcText[ccc] == '\\'))
+		{
+			*jsonText++	=	'\\';
+		}
+		if ((unsigned char)srcText[ccc] >= 0x20)
+		{
+			*jsonText++	=	srcText[ccc];
+		}
+	}
+	*jsonText	=	0;
+}
+
+//*****************************************************************************
+//*	filelist from the file index, no directory scan.
+//*		cursor	NextCursor from the previous page, 0 or missing for the first page
+//*		limit	files per page, default 100, max kFileIndex_MaxPageSize
+//*		type	fits, jpeg, png, csv, video, text or other
+//*		start	only files newer than this (unix time)
+//*		end		only files older than this (unix time)
+//*		order	newest (default) or oldest
+//*		detail	true returns an object for each file instead of just the name
+//*	NextCursor is 0 on the last page.
+//*	Without detail the names end with "END" the same as the old filelist.
+//*****************************************************************************
+TYPE_ASCOM_STATUS	CameraDriver::Get_FilelistIndexed(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
+{
+TYPE_ASCOM_STATUS		alpacaErrCode	=	kASCOM_Err_Success;
+TYPE_FILE_INDEX_QUERY	query;
+TYPE_FILE_INDEX_ENTRY	*entries;
+struct timeval			fileTimeVal;
+char					argumentString[64];
+char					timeString[64];
+char					fileName[(2 * kFileIndex_MaxNameLen) + 1];
+char					comment[(2 * kFileIndex_MaxCommentLen) + 1];
+char					summary[(2 * kFileIndex_MaxSummaryLen) + 1];
+char					lineBuff[1024];
+bool					detailMode;
+int						mySocketFD;
+int						entryCnt;
+int						iii;
+
+	mySocketFD		=	reqData->socket;
+	memset(&query, 0, sizeof(TYPE_FILE_INDEX_QUERY));
+	query.fileType	=	kFileType_Any;
+	query.limit		=	100;
+	detailMode		=	false;
+	if (GetKeyWordArgument(reqData->contentData, "cursor", argumentString, (sizeof(argumentString) -1), kIgnoreCase, kArgumentIsNumeric))
+	{
+		query.cursor	=	strtoul(argumentString, NULL, 10);
+	}
+	if (GetKeyWordArgument(reqData->contentData, "limit", argumentString, (sizeof(argumentString) -1), kIgnoreCase, kArgumentIsNumeric))
+	{
+		query.limit	=	atoi(argumentString);
+	}
+	if (GetKeyWordArgument(reqData->contentData, "start", argumentString, (sizeof(argumentString) -1), kIgnoreCase, kArgumentIsNumeric))
+	{
+		query.startTime	=	strtol(argumentString, NULL, 10);
+	}
+	if (GetKeyWordArgument(reqData->contentData, "end", argumentString, (sizeof(argumentString) -1), kIgnoreCase, kArgumentIsNumeric))
+	{
+		query.endTime	=	strtol(argumentString, NULL, 10);
+	}
+	if (GetKeyWordArgument(reqData->contentData, "detail", argumentString, (sizeof(argumentString) -1), kIgnoreCase))
+	{
+		detailMode	=	IsTrueFalse(argumentString);
+	}
+	if (GetKeyWordArgument(reqData->contentData, "order", argumentString, (sizeof(argumentString) -1), kIgnoreCase))
+	{
+		if (strcasecmp(argumentString, "oldest") == 0)
+		{
+			query.oldestFirst	=	true;
+		}
+		else if (strcasecmp(argumentString, "newest") != 0)
+		{
+			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "order must be newest or oldest");
+			return(kASCOM_Err_InvalidValue);
+		}
+	}
+	if (GetKeyWordArgument(reqData->contentData, "type", argumentString, (sizeof(argumentString) -1), kIgnoreCase))
+	{
+		query.fileType	=	FileIndex_GetTypeFromString(argumentString);
+		if (query.fileType < kFileType_Any)
+		{
+			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "type must be fits, jpeg, png, csv, video, text or other");
+			return(kASCOM_Err_InvalidValue);
+		}
+	}
+	if ((query.limit <= 0) || (query.limit > kFileIndex_MaxPageSize))
+	{
+		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "limit out of range");
+		return(kASCOM_Err_InvalidValue);
+	}
+
+	entries	=	(TYPE_FILE_INDEX_ENTRY *)malloc(query.limit * sizeof(TYPE_FILE_INDEX_ENTRY));
+	if (entries == NULL)
+	{
+		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Failed to allocate memory");
+		return(kASCOM_Err_FailedUnknown);
+	}
+	entryCnt	=	FileIndex_Query(&query, entries, query.limit);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_String(mySocketFD,
+									reqData->jsonTextBuffer,
+									kMaxJsonBuffLen,
+									"Directory",
+									gImageDataDir,
+									INCLUDE_COMMA);
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	mySocketFD,
+									reqData->jsonTextBuffer,
+									kMaxJsonBuffLen,
+									"TotalCount",
+									query.totalCnt,
+									INCLUDE_COMMA);
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Uint32(mySocketFD,
+									reqData->jsonTextBuffer,
+									kMaxJsonBuffLen,
+									"NextCursor",
+									query.nextCursor,
+									INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_ArrayStart(	mySocketFD,
+									reqData->jsonTextBuffer,
+									kMaxJsonBuffLen,
+									gValueString);
+	for (iii=0; iii<entryCnt; iii++)
+	{
+		CopyJsonEscaped(fileName, entries[iii].fileName);
+		if (detailMode)
+		{
+			CopyJsonEscaped(comment, entries[iii].comment);
+			CopyJsonEscaped(summary, entries[iii].summary);
+			fileTimeVal.tv_sec	=	entries[iii].fileTime;
+			fileTimeVal.tv_usec	=	0;
+			FormatTimeStringISO8601_UTC(&fileTimeVal, timeString);
+			snprintf(lineBuff, sizeof(lineBuff),
+					"%s\t\t\t{\"name\":\"%s\",\"type\":\"%s\",\"size\":%lld,\"time\":\"%s\",\"unixtime\":%ld,"
+					"\"cursor\":%u,\"comment\":\"%s\",\"summary\":\"%s\"}%s\r\n",
+					((iii == 0) ? "\r\n" : ""),
+					fileName,
+					FileIndex_GetTypeName(entries[iii].fileType),
+					(long long)entries[iii].fileSize,
+					timeString,
+					(long)entries[iii].fileTime,
+					entries[iii].seq,
+					comment,
+					summary,
+					((iii < (entryCnt - 1)) ? "," : ""));
+		}
+		else
+		{
+			snprintf(lineBuff, sizeof(lineBuff), "%s\t\t\t\"%s\",\r\n", ((iii == 0) ? "\r\n" : ""), fileName);
+		}
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_RawText(	mySocketFD,
+										reqData->jsonTextBuffer,
+										kMaxJsonBuffLen,
+										lineBuff);
+	}
+	if (detailMode == false)
+	{
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_RawText(	mySocketFD,
+										reqData->jsonTextBuffer,
+										kMaxJsonBuffLen,
+										"\t\t\t\"END\"\r\n");
+	}
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_ArrayEnd(	mySocketFD,
+									reqData->jsonTextBuffer,
+									kMaxJsonBuffLen,
+									INCLUDE_COMMA);
+	free(entries);
+	return(alpacaErrCode);
+}
+#endif // _ENABLE_FILE_INDEX_
+
 //*****************************************************************************
 TYPE_ASCOM_STATUS	CameraDriver::Get_AutoExposure(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg, const char *responseString)
 {
@@ -8113,51 +9461,147 @@ bool				foundKeyWord;
 
 #ifdef _ENABLE_FITS_
 //*****************************************************************************
+//*	fitsheader?frame=123&format=fits
+//*		frame	one of the recent frames (default is the current frame)
+//*		format	json (default) or fits, fits returns the 2880 byte header blocks
+//*
+//*	The header is generated once per frame, after that this is just a copy
+//*****************************************************************************
 TYPE_ASCOM_STATUS	CameraDriver::Get_FitsHeader(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
 {
 TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_Success;
+TYPE_FITS_HDR		*fitsHdr;
 int					mySocketFD;
-char				lineBuff[128];
-int					fitsHdrIdx;
+char				argumentString[32];
+char				httpHeader[512];
+char				jsonChunk[4000 + 1];
+unsigned char		*responseBuffer;
+uint32_t			frameNum;
+bool				sendBlocks;
+size_t				offset;
+size_t				chunkLen;
+size_t				responseLen;
+size_t				totalWritten;
+ssize_t				bytesWritten;
 
 	mySocketFD	=	reqData->socket;
+	frameNum	=	kFitsHdr_Newest;
+	sendBlocks	=	false;
+	if (GetKeyWordArgument(	reqData->contentData,
+							"frame",
+							argumentString,
+							(sizeof(argumentString) -1),
+							kIgnoreCase,
+							kArgumentIsNumeric))
+	{
+		frameNum	=	atol(argumentString);
+	}
+	if (GetKeyWordArgument(reqData->contentData, "format", argumentString, (sizeof(argumentString) -1), kIgnoreCase))
+	{
+		if (strcasecmp(argumentString, "fits") == 0)
+		{
+			sendBlocks	=	true;
+		}
+		else if (strcasecmp(argumentString, "json") != 0)
+		{
+			alpacaErrCode	=	kASCOM_Err_InvalidValue;
+			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "format must be json or fits");
+			return(alpacaErrCode);
+		}
+	}
+	if ((frameNum == kFitsHdr_Newest) || (frameNum == (uint32_t)cFramesRead))
+	{
+		//*	does nothing if the current frame is already there
+		BuildFitsHeaderCache();
+	}
+	fitsHdr	=	FitsHdrCache_Acquire(cFitsHdrCache, frameNum);
+	if (fitsHdr == NULL)
+	{
+		alpacaErrCode	=	kASCOM_Err_InvalidValue;
+		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "FITS header for that frame is no longer available");
+		return(alpacaErrCode);
+	}
 
-	cBytesWrittenForThisCmd	+=	JsonResponse_Add_ArrayStart(mySocketFD,
-									reqData->jsonTextBuffer,
-									kMaxJsonBuffLen,
-									gValueString);
-
-	cBytesWrittenForThisCmd	+=	JsonResponse_Add_RawText(	mySocketFD,
-									reqData->jsonTextBuffer,
-									kMaxJsonBuffLen,
-									"\n");
+	if (sendBlocks)
+	{
+		snprintf(httpHeader, sizeof(httpHeader),	"HTTP/1.0 200 OK\r\n"
+													"Content-Type: application/octet-stream\r\n"
+													"Content-Length: %lu\r\n"
+													"Cache-Control: no-cache\r\n"
+													"Access-Control-Allow-Origin: *\r\n"
+													"X-Frame-Number: %u\r\n"
+													"Server: AlpacaPi\r\n"
+													"\r\n",
+													(unsigned long)fitsHdr->blockLen,
+													fitsHdr->frameNum);
 
-	fitsHdrIdx	=	0;
-	while (cFitsHeader[fitsHdrIdx].fitsRec[0] != 0)
+		//*	one buffer, one write (the same as Get_Preview)
+		responseLen		=	strlen(httpHeader) + fitsHdr->blockLen;
+		responseBuffer	=	(unsigned char *)malloc(responseLen);
+		if (responseBuffer != NULL)
+		{
+			memcpy(responseBuffer, httpHeader, strlen(httpHeader));
+			memcpy(&responseBuffer[strlen(httpHeader)], fitsHdr->blocks, fitsHdr->blockLen);
+			totalWritten	=	0;
+			while (totalWritten < responseLen)
+			{
+				bytesWritten	=	write(mySocketFD, &responseBuffer[totalWritten], (responseLen - totalWritten));
+				if (bytesWritten <= 0)
+				{
+					CONSOLE_DEBUG("Failed to send FITS header");
+					break;
+				}
+				totalWritten	+=	bytesWritten;
+			}
+			free(responseBuffer);
+			cSendJSONresponse	=	false;
+		}
+		else
+		{
+			alpacaErrCode	=	kASCOM_Err_InternalError;
+			GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Failed to allocate FITS header buffer");
+		}
+	}
+	else if (fitsHdr->jsonText != NULL)
 	{
-		strcpy(lineBuff, "\"");
-		strcat(lineBuff, cFitsHeader[fitsHdrIdx].fitsRec);
-		strcat(lineBuff, "\",\n");
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_ArrayStart(mySocketFD,
+										reqData->jsonTextBuffer,
+										kMaxJsonBuffLen,
+										gValueString);
 
-		cBytesWrittenForThisCmd	+=	JsonResponse_Add_RawText(	mySocketFD,
+		//*	the json is already made, it just has to go out in pieces that fit the json buffer
+		offset	=	0;
+		while (offset < fitsHdr->jsonLen)
+		{
+			chunkLen	=	fitsHdr->jsonLen - offset;
+			if (chunkLen > (sizeof(jsonChunk) - 1))
+			{
+				chunkLen	=	sizeof(jsonChunk) - 1;
+			}
+			memcpy(jsonChunk, &fitsHdr->jsonText[offset], chunkLen);
+			jsonChunk[chunkLen]	=	0;
+			cBytesWrittenForThisCmd	+=	JsonResponse_Add_RawText(	mySocketFD,
+											reqData->jsonTextBuffer,
+											kMaxJsonBuffLen,
+											jsonChunk);
+			offset	+=	chunkLen;
+		}
+
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_ArrayEnd(	mySocketFD,
 										reqData->jsonTextBuffer,
 										kMaxJsonBuffLen,
-										lineBuff);
-		fitsHdrIdx++;
-	}
-	cBytesWrittenForThisCmd	+=	JsonResponse_Add_RawText(	mySocketFD,
-									reqData->jsonTextBuffer,
-									kMaxJsonBuffLen,
-									"\"----------\"\n");
+										INCLUDE_COMMA);
 
-	cBytesWrittenForThisCmd	+=	JsonResponse_Add_ArrayEnd(	mySocketFD,
-									reqData->jsonTextBuffer,
-									kMaxJsonBuffLen,
-									INCLUDE_COMMA);
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(		mySocketFD,
+										reqData->jsonTextBuffer,
+										kMaxJsonBuffLen,
+										"FrameNumber",
+										fitsHdr->frameNum,
+										INCLUDE_COMMA);
+	}
+	FitsHdrCache_Release(cFitsHdrCache, fitsHdr);
 	return(alpacaErrCode);
-
 }
-
 #endif
 
 //*****************************************************************************
@@ -8667,7 +10111,8 @@ char				textBuffer[128];
 	double	imuRoll;
 	double	imuPitch;
 
-		imuRetCode	=	IMU_BNO055_Read_Euler(&imuHeading, &imuRoll, &imuPitch);
+		//*	the background thread owns the I2C bus, take the averages from it
+		imuRetCode	=	IMU_GetAverageRoll_Pitch_Yaw(&imuRoll, &imuPitch, &imuHeading);
 		if (imuRetCode == 0)
 		{
 			cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(	mySocket,
@@ -8755,6 +10200,129 @@ char				textBuffer[128];
 														cameraStateString,
 														INCLUDE_COMMA);
 
+#ifdef _ENABLE_SHM_FRAMES_
+	//*	shared memory frame ring
+	if (cShmFrameRing != NULL)
+	{
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_String(mySocket,
+															reqData->jsonTextBuffer,
+															kMaxJsonBuffLen,
+															"shmframe-path",
+															cShmFrameRing->path,
+															INCLUDE_COMMA);
+
+		//*	64 bit counter, a double holds it exactly up to 2^53
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+															reqData->jsonTextBuffer,
+															kMaxJsonBuffLen,
+															"shmframe-count",
+															(double)cShmFramesPublished,
+															INCLUDE_COMMA);
+	}
+#endif // _ENABLE_SHM_FRAMES_
+
+#ifdef _ENABLE_MJPEG_STREAM_
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"mjpeg-viewers",
+														((cMJPEGstream != NULL) ? cMJPEGstream->viewerCnt : 0),
+														INCLUDE_COMMA);
+#endif // _ENABLE_MJPEG_STREAM_
+
+#ifdef _ENABLE_PREVIEW_PYRAMID_
+	if (cPreviewPyramid != NULL)
+	{
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+															reqData->jsonTextBuffer,
+															kMaxJsonBuffLen,
+															"preview-buildtime-ms",
+															cPreviewPyramid->buildTime_ms,
+															INCLUDE_COMMA);
+	}
+#endif // _ENABLE_PREVIEW_PYRAMID_
+
+	//*	sequence duty cycle, time exposing / wall time
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Bool(	mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"sequence-pipelined",
+														cSeqPipelined,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"sequence-dutycycle",
+														cSeqDutyCycle,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"sequence-mindutycycle",
+														cSeqMinDutyCycle,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Bool(	mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"sequence-dutycycle-ok",
+														cSeqDutyCycleOK,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"sequence-framesrequested",
+														cNumFramesRequested,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"sequence-framesread",
+														cSeqDutyFrameCnt,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Double(mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"sequence-overlap_us",
+														cSeqOverlap_us,
+														INCLUDE_COMMA);
+
+#ifdef _USE_OPENCV_
+	//*	what the last frame cost on its way to the openCV image
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"opencv-allocs",
+														cOpenCV_FrameAllocCnt,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"opencv-bytescopied",
+														cOpenCV_FrameBytesCopied,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"opencv-frame_us",
+														cOpenCV_FrameTime_us,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	mySocket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"opencv-save_us",
+														cOpenCV_SaveTime_us,
+														INCLUDE_COMMA);
+#endif // _USE_OPENCV_
+
 	//*	write errors to log file if true
 	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Bool(	mySocket,
 														reqData->jsonTextBuffer,
@@ -9152,7 +10720,6 @@ bool	foundFlag	=	true;
 		case kCmd_Camera_gains:					//*	Gains supported by the camera
 		case kCmd_Camera_hasshutter:			//*	Indicates whether the camera has a mechanical shutter
 		case kCmd_Camera_heatsinktemperature:	//*	Returns the current heat sink temperature.
-		case kCmd_Camera_imagearray:			//*	Returns an array of integers containing the exposure pixel values
 		case kCmd_Camera_imagearrayvariant:		//*	Returns an array of int containing the exposure pixel values
 		case kCmd_Camera_imageready:			//*	Indicates that an image is ready to be downloaded
 		case kCmd_Camera_IsPulseGuiding:		//*	Indicates that the camera is pulse guideing.
@@ -9192,6 +10759,10 @@ bool	foundFlag	=	true;
 			strcpy(agumentString, "");
 			break;
 
+		case kCmd_Camera_imagearray:			//*	Returns an array of integers containing the exposure pixel values
+			strcpy(agumentString, "x=INT, y=INT, width=INT, height=INT, bin=INT (1-16), all optional");
+			break;
+
 		//=================================================================
 		//*	commands added that are not part of Alpaca
 		case kCmd_Camera_autoexposure:		strcpy(agumentString, "autoexposure=BOOL");		break;
@@ -9200,22 +10771,33 @@ bool	foundFlag	=	true;
 		case kCmd_Camera_filenameoptions:	strcpy(agumentString, "includecamera=BOOL");	break;
 		case kCmd_Camera_flip:				strcpy(agumentString, "flip=INT (0,1,2,3)");	break;
 		case kCmd_Camera_livemode:			strcpy(agumentString, "livemode=BOOL");			break;
+#ifdef _ENABLE_MJPEG_STREAM_
+		case kCmd_Camera_mjpegstream:		strcpy(agumentString, "maxfps=FLOAT, maxwidth=INT");	break;
+#endif
+#ifdef _ENABLE_PREVIEW_PYRAMID_
+		case kCmd_Camera_preview:			strcpy(agumentString, "level=INT (2,4,8), format=STR (jpeg,imagebytes)");	break;
+#endif
 		case kCmd_Camera_settelescopeinfo:	strcpy(agumentString, "RefID,Telescope,Focuser,Filterwheel,Object,Prefix,Suffix,auxtext");			break;
 		case kCmd_Camera_saveallimages:		strcpy(agumentString, "saveallimages=BOOL");						break;
 		case kCmd_Camera_saveasFITS:		strcpy(agumentString, "saveasfits=BOOL");							break;
 		case kCmd_Camera_saveasJPEG:		strcpy(agumentString, "saveasjpeg=BOOL");							break;
 		case kCmd_Camera_saveasPNG:			strcpy(agumentString, "saveaspng=BOOL");							break;
 		case kCmd_Camera_saveasRAW:			strcpy(agumentString, "saveasraw=BOOL");							break;
-		case kCmd_Camera_startsequence:		strcpy(agumentString, "count=INT, delay=FLOAT, deltaduration=FLOAT");	break;
+		case kCmd_Camera_startsequence:		strcpy(agumentString, "count=INT, delay=FLOAT, deltaduration=FLOAT, pipelined=BOOL, mindutycycle=FLOAT");	break;
 		case kCmd_Camera_startvideo:		strcpy(agumentString, "recordtime=FLOAT");								break;
-
-
+		case kCmd_Camera_rgbarray:			strcpy(agumentString, "Accept: application/imagebytes for binary");	break;
+#ifdef _ENABLE_FILE_INDEX_
+		case kCmd_Camera_filelist:			strcpy(agumentString, "cursor=INT, limit=INT, type=STR (fits,jpeg,png,csv,video,text,other), start=INT, end=INT (unix time), detail=BOOL");	break;
+#endif
 #ifdef _ENABLE_FITS_
-		case kCmd_Camera_fitsheader:
+		case kCmd_Camera_fitsheader:		strcpy(agumentString, "frame=INT, format=STR (json,fits)");		break;
 #endif
+
+
 		case kCmd_Camera_framerate:
+#ifndef _ENABLE_FILE_INDEX_
 		case kCmd_Camera_filelist:
-		case kCmd_Camera_rgbarray:
+#endif
 		case kCmd_Camera_savedimages:
 		case kCmd_Camera_savenextimage:
 		case kCmd_Camera_stopvideo:
@@ -29,6 +29,26 @@
 //*	Jun  4,	2023	<MLS> Added cSaveAsFITS, cSaveAsJPEG, cSaveAsPNG, cSaveAsRAW
 //*	Aug 31,	2023	<MLS> Adding support for GPS, specifically the QHY174-GPS
 //*	Apr 19,	2024	<MLS> Added kImageType_MONO8
+//*	Oct 18,	2026	<MLS> Added pipelined sequence support and duty cycle statistics
+//*	Oct 18,	2026	<MLS> Added _ENABLE_SHM_FRAMES_, shared memory frame ring
+//*	Oct 18,	2026	<MLS> Added cExposureStartPPS, exposure start from the GPS PPS
+//*	Oct 18,	2026	<MLS> Added _ENABLE_MJPEG_STREAM_, multipart jpeg live view
+//*	Oct 18,	2026	<MLS> Added _ENABLE_PREVIEW_PYRAMID_, 2x/4x/8x previews of the last frame
+//*	Oct 18,	2026	<MLS> Added GetImageWindow(), imagearray x/y/width/height/bin subframes
+//*	Oct 18,	2026	<MLS> Added cImageBytesCache, imagearray Range requests
+//*	Oct 18,	2026	<MLS> Added Get_RGBarray_Binary(), rgbarray as ImageBytes
+//*	Oct 18,	2026	<MLS> Added ReleaseOpenCVImage(), GetLiveSmallImage(), cOpenCV_ImageWrapsBuffer, cOpenCV_FrameAllocCnt
+//*	Oct 18,	2026	<MLS> Added _ENABLE_FILE_INDEX_, Get_FilelistIndexed()
+//*	Oct 18,	2026	<MLS> Added cFitsHdrCache, BuildFitsHeaderCache(), WriteFITS_Header(), cFitsHeader[] removed
+//*	Oct 18,	2026	<MLS> Added TYPE_FRAME_EXPOSURE_INFO, cFrameExpInfo, the exposure info of the frame in the buffer
+//*	Oct 18,	2026	<MLS> Added cImageBytesMutex, the ImageBytes cache is freed when the next exposure starts
+//*	Oct 18,	2026	<MLS> Added CheckImageBytesCache(), StoreImageBytesCache(), rgbarray uses the cache too
+//*	Oct 18,	2026	<MLS> Added cOpenCV_FrameTime_us, cOpenCV_SaveTime_us
+//*	Oct 18,	2026	<MLS> Added requiredCnt to ExtractFitsHeader()
+//*	Oct 18,	2026	<MLS> SyncExposure_Arm() is back, SyncExposure_Trigger() only starts the SDK
+//*	Oct 18,	2026	<MLS> cSeqDutyCycleOK follows the duty cycle, readall has the frame counts
+//*	Oct 18,	2026	<MLS> BuildPreviewPyramid() builds into the pyramid it is given
+//*	Oct 18,	2026	<MLS> BuildBinaryImage_RGBarray() takes the image type of the frame
 //*****************************************************************************
 //#include	"cameradriver.h"
 
@@ -58,14 +78,7 @@
 	#ifndef _FITSIO_H
 		#include <fitsio.h>
 	#endif // _FITSIO_H
-	#define	kMaxFitsRecLen	90
-	#define	kMaxFitsRecords	200
-	//*****************************************************************************
-	typedef struct	//	TYPE_FITS_RECORD
-	{
-		char	fitsRec[kMaxFitsRecLen];
-	} TYPE_FITS_RECORD;
-
+	#include	"fits_hdrcache.h"
 #endif // _ENABLE_FITS_
 
 
@@ -90,8 +103,25 @@
 	#include	"gps_data.h"
 #endif
 
+#ifdef _ENABLE_SHM_FRAMES_
+	#include	"shmframe_lib.h"
+#endif
+
+#ifdef _ENABLE_MJPEG_STREAM_
+	#include	"mjpeg_stream.h"
+#endif
+
+#ifdef _ENABLE_PREVIEW_PYRAMID_
+	#include	"preview_pyramid.h"
+#endif
+
+#ifdef _ENABLE_FILE_INDEX_
+	#include	"file_index.h"
+#endif
+
 
 #include	"observatory_settings.h"
+#include	"image_window.h"
 
 #include	"camera_defs.h"
 
@@ -185,6 +215,18 @@ typedef struct	//	TYPE_IMAGE_ROI_Info
 	int				currentROIbin;
 } TYPE_IMAGE_ROI_Info;
 
+//*****************************************************************************
+//*	the exposure info that goes with the frame that is in the image data buffer.
+//*	In a pipelined sequence the Lastexposure info is already for the next frame
+typedef struct	//	TYPE_FRAME_EXPOSURE_INFO
+{
+	TYPE_IMAGE_ROI_Info	roiInfo;
+	struct timeval		startTime;
+	struct timeval		endTime;		//*	end of readout
+	int32_t				duration_us;
+	long				frameNum;
+} TYPE_FRAME_EXPOSURE_INFO;
+
 
 //*****************************************************************************
 //*	this is for keeping track of other saved data for the FITS header
@@ -243,6 +285,9 @@ class CameraDriver: public AlpacaDriver
 		virtual	int32_t	RunStateMachine(void);
 				int32_t	RunStateMachine_Idle(void);
 				int		RunStateMachine_TakingPicture(void);
+				bool	Sequence_ReadyForNextFrame(void);
+	TYPE_ASCOM_STATUS	Sequence_StartNextFrame(void);
+				void	Sequence_UpdateDutyCycle(void);
 		virtual	void	RunStateMachine_Device(void);
 
 		virtual	bool	DeviceState_Add_Content(const int socketFD, char *jsonTextBuffer, const int maxLen);
@@ -359,16 +404,17 @@ class CameraDriver: public AlpacaDriver
 		TYPE_ASCOM_STATUS	Put_SubExposureDuration(	TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
 
 
-		TYPE_ASCOM_STATUS	Get_Imagearray_JSON(	TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
-		TYPE_ASCOM_STATUS	Get_Imagearray_Binary(	TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
-		int					BuildBinaryImage_Raw8(			unsigned char	*binaryDataBuffer, int startOffset, int bufferSize);
-		int					BuildBinaryImage_Raw8_16bit(	unsigned char	*binaryDataBuffer, int startOffset, int bufferSize);
-		int					BuildBinaryImage_Raw8_32bit(	unsigned char	*binaryDataBuffer, int startOffset, int bufferSize);
-		int					BuildBinaryImage_Raw16(			unsigned char	*binaryDataBuffer, int startOffset, int bufferSize);
-		int					BuildBinaryImage_Raw32(			unsigned char	*binaryDataBuffer, int startOffset, int bufferSize);
-		int					BuildBinaryImage_RGB24(			unsigned char	*binaryDataBuffer, int startOffset, int bufferSize);
-		int					BuildBinaryImage_RGB24_32bit(	uint32_t		*binaryDataBuffer, int startOffset, int bufferSize);
-		int					BuildBinaryImage_RGBx16(		unsigned char	*binaryDataBuffer, int startOffset, int bufferSize);
+		TYPE_ASCOM_STATUS	GetImageWindow(			TYPE_GetPutRequestData *reqData, TYPE_IMAGE_WINDOW *imgWindow, char *alpacaErrMsg);
+		TYPE_ASCOM_STATUS	Get_Imagearray_JSON(	TYPE_GetPutRequestData *reqData, char *alpacaErrMsg, TYPE_IMAGE_WINDOW *imgWindow);
+		TYPE_ASCOM_STATUS	Get_Imagearray_Binary(	TYPE_GetPutRequestData *reqData, char *alpacaErrMsg, TYPE_IMAGE_WINDOW *imgWindow);
+		int					BuildBinaryImage_Raw8(			unsigned char	*binaryDataBuffer, int startOffset, int bufferSize, const TYPE_IMAGE_WINDOW *imgWindow);
+		int					BuildBinaryImage_Raw8_16bit(	unsigned char	*binaryDataBuffer, int startOffset, int bufferSize, const TYPE_IMAGE_WINDOW *imgWindow);
+		int					BuildBinaryImage_Raw8_32bit(	unsigned char	*binaryDataBuffer, int startOffset, int bufferSize, const TYPE_IMAGE_WINDOW *imgWindow);
+		int					BuildBinaryImage_Raw16(			unsigned char	*binaryDataBuffer, int startOffset, int bufferSize, const TYPE_IMAGE_WINDOW *imgWindow);
+		int					BuildBinaryImage_Raw32(			unsigned char	*binaryDataBuffer, int startOffset, int bufferSize, const TYPE_IMAGE_WINDOW *imgWindow);
+		int					BuildBinaryImage_RGB24(			unsigned char	*binaryDataBuffer, int startOffset, int bufferSize, const TYPE_IMAGE_WINDOW *imgWindow);
+		int					BuildBinaryImage_RGB24_32bit(	uint32_t		*binaryDataBuffer, int startOffset, int bufferSize, const TYPE_IMAGE_WINDOW *imgWindow);
+		int					BuildBinaryImage_RGBx16(		unsigned char	*binaryDataBuffer, int startOffset, int bufferSize, const TYPE_IMAGE_WINDOW *imgWindow);
 
 		//-------------------------------------------------------------------------------------------------
 		//*	Added by MLS
@@ -425,6 +471,12 @@ class CameraDriver: public AlpacaDriver
 		TYPE_ASCOM_STATUS	Put_Filenameoptions(	TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
 
 		TYPE_ASCOM_STATUS	Get_RGBarray(			TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
+		TYPE_ASCOM_STATUS	Get_RGBarray_JSON(		TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
+		TYPE_ASCOM_STATUS	Get_RGBarray_Binary(	TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
+		int					BuildBinaryImage_RGBarray(	unsigned char	*binaryDataBuffer,
+														const int		width,
+														const int		height,
+														const int		imageType);
 virtual	TYPE_ASCOM_STATUS	Get_Readall(			TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
 
 		//*	these are borrowed from the telescope device
@@ -464,6 +516,9 @@ virtual	TYPE_ASCOM_STATUS	Get_Readall(			TYPE_GetPutRequestData *reqData, char *
 				int		SaveImageAsFITS(bool headerOnly=false);
 				void	CreateFitsBGRimage(void);
 				void	WriteFITS_Seperator(fitsfile *fitsFilePtr, const char *blockName);
+				void	WriteFITS_Header(			fitsfile *fitsFilePtr, bool includeAnalysis, double bscale, double bzero);
+				void	GetFITS_ImageFormat(int *fits_bitpix, int *fitsDataType, double *bzero, int *axisCnt);
+				bool	BuildFitsHeaderCache(void);
 
 				void	WriteFITS_CameraInfo(		fitsfile *fitsFilePtr);
 				void	WriteFITS_EnvironmentInfo(	fitsfile *fitsFilePtr);
@@ -485,8 +540,8 @@ virtual	TYPE_ASCOM_STATUS	Get_Readall(			TYPE_GetPutRequestData *reqData, char *
 			#endif
 
 				TYPE_ASCOM_STATUS	Get_FitsHeader(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
-				int					ExtractFitsHeader(fitsfile *fitsFilePtr);
-				TYPE_FITS_RECORD	cFitsHeader[kMaxFitsRecords];
+				int					ExtractFitsHeader(fitsfile *fitsFilePtr, bool fromSavedFile=true, int requiredCnt=0);
+				TYPE_FITS_HDR_CACHE	*cFitsHdrCache;		//*	the generated headers for the recent frames
 
 			#endif // _ENABLE_FITS_
 			#ifdef _ENABLE_IMU_
@@ -529,6 +584,7 @@ virtual	TYPE_ASCOM_STATUS	Get_Readall(			TYPE_GetPutRequestData *reqData, char *
 		void			DisplayLiveImage(void);
 		void			DisplayLiveImage_wSideBar(void);
 		int				CreateOpenCVImage(const unsigned char *imageDataPtr);
+		void			ReleaseOpenCVImage(void);
 		int				SaveOpenCVImage(void);
 		void			SetOpenCVcallbackFunction(const char *windowName);
 		void			ProcessMouseEvent(int event, int xxx, int yyy, int flags);
@@ -544,6 +600,7 @@ virtual	TYPE_ASCOM_STATUS	Get_Readall(			TYPE_GetPutRequestData *reqData, char *
 		void			CreateHistogramGraph(	IplImage *imageDisplay);
 		void			SetOpenCVcolors(		IplImage *imageDisplay);
 		void			Draw3TextStrings(		IplImage *theImage, const char *textStr1, const char *textStr2, const char *textStr3);
+		IplImage		*GetLiveSmallImage(		const int imageDepth);
 	#endif // _USE_OPENCV_CPP_
 
 	#endif	//	_USE_OPENCV_
@@ -607,6 +664,7 @@ virtual	TYPE_ASCOM_STATUS	Get_Readall(			TYPE_GetPutRequestData *reqData, char *
 
 		virtual	TYPE_ASCOM_STATUS		Read_CoolerState(bool *coolerOnOff);
 		virtual	TYPE_ASCOM_STATUS		Read_CoolerPowerLevel(void);
+				void					TemperatureLog_Update(void);
 		virtual	TYPE_ASCOM_STATUS		Read_Fastreadout(void);
 		virtual	TYPE_ASCOM_STATUS		Read_ImageData(void);
 
@@ -637,6 +695,61 @@ public:
 //-	char					cSensorName[kMaxSensorNameLen];	//*	obtained from my table lookup
 	char		cLastCameraErrMsg[128];
 
+	//*	synchronized multicam start, see MultiCam::Put_StartExposure()
+	void				SyncExposure_Arm(const int32_t exposureMicrosecs);
+	TYPE_ASCOM_STATUS	SyncExposure_Trigger(void);
+	bool				cSyncStartValid;
+	struct timeval		cSyncTriggerTime;		//*	time this camera was released from the start gate
+	struct timeval		cSyncStartTime;			//*	when the SDK start call returned
+	int32_t				cSyncStartOffset_us;	//*	offset from the first camera to start
+	int32_t				cSyncSkew_us;			//*	spread of the start times across all cameras
+	int32_t				cSyncLatency_us;		//*	time spent in the SDK start call
+
+	bool				cExposureStartPPSvalid;
+	struct timeval		cExposureStartPPS;		//*	UTC exposure start from the GPS PPS (gps_data.cpp)
+
+#ifdef _ENABLE_SHM_FRAMES_
+	//*	shared memory frame ring for local tools, see shmframe_lib.c
+	void				PublishSharedMemoryFrame(void);
+	TYPE_ShmFrameRing	*cShmFrameRing;
+	uint64_t			cShmFramesPublished;
+	uint32_t			cShmRingFailTime_ms;		//*	last time creating the ring failed, 0 = never
+#endif
+
+#ifdef _ENABLE_MJPEG_STREAM_
+	//*	multipart jpeg live view, see mjpeg_stream.c
+	void				PublishMJPEGframe(void);
+	TYPE_ASCOM_STATUS	Get_MJPEGstream(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
+	TYPE_MJPEG_STREAM	*cMJPEGstream;
+#endif
+
+#ifdef _ENABLE_PREVIEW_PYRAMID_
+	//*	downsampled previews of the last frame, see preview_pyramid.c
+	bool					BuildPreviewPyramid(TYPE_PREVIEW_PYRAMID *pyramid);
+	TYPE_ASCOM_STATUS		Get_Preview(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
+	TYPE_PREVIEW_PYRAMID	*cPreviewPyramid;		//*	NULL until the first preview request
+#endif
+
+#ifdef _ENABLE_FILE_INDEX_
+	//*	filelist served from the inotify index of gImageDataDir, see file_index.c
+	TYPE_ASCOM_STATUS		Get_FilelistIndexed(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
+#endif
+
+	//*	the last ImageBytes response, kept so Range requests for the pieces of a
+	//*	download all come from the same frame (see Get_Imagearray_Binary())
+	void				FormatImageBytesETag(const TYPE_IMAGE_WINDOW *imgWindow, char *eTag);
+	bool				CheckImageBytesCache(TYPE_GetPutRequestData *reqData, const char *eTag);
+	void				StoreImageBytesCache(unsigned char *binaryDataBuffer, const size_t bufferSize, const char *eTag);
+	int					SendImageBytesCache(TYPE_GetPutRequestData *reqData);
+	void				FreeStaleImageBytes(void);
+	pthread_mutex_t		cImageBytesMutex;
+	unsigned char		*cImageBytesCache;
+	size_t				cImageBytesCacheLen;
+	char				cImageBytesETag[80];
+	long				cImageBytesFrameNum;
+	struct timeval		cImageBytesExpStart;		//*	the exposure start time when it was cached
+	bool				cImageBytesSending;			//*	the http thread is sending it, do not free it
+
 	//*****************************************************************************
 protected:
 	//*	ASCOM camera properties
@@ -645,6 +758,7 @@ protected:
 
 	//*****************************************************************************
 	TYPE_IMAGE_ROI_Info		cLastExposure_ROIinfo;
+	TYPE_FRAME_EXPOSURE_INFO	cFrameExpInfo;			//*	info for the frame in cCameraDataBuffer
 
 	//=========================================================================================
 	//=========================================================================================
@@ -660,6 +774,7 @@ protected:
 	long		cExposureDefault_us;	//*	micro-seconds
 	//=========================================================================================
 	bool		cTempReadSupported;		//*	true if temperature can be read from device
+	int			cCoolerPowerChannel;	//*	time series channel handle
 	bool		cOffsetSupported;		//*	true pixel value offset is supported
 	bool		cSubDurationSupported;
 	long		cCoolerState;
@@ -713,6 +828,15 @@ protected:
 	uint32_t			cSequenceDelay_us;			//*	sequence delay in microseconds
 	int32_t				cSeqDeltaExposure_us;
 	int					cImageSeqNumber;
+	bool				cSeqPipelined;				//*	re-arm the sensor as soon as readout is done
+	double				cSeqMinDutyCycle;			//*	percent, 0 = no check
+	bool				cSeqDutyCycleOK;			//*	false while the duty cycle is below cSeqMinDutyCycle
+	double				cSeqDutyCycle;				//*	percent, time exposing / wall time
+	int64_t				cSeqExposing_us;			//*	total time the sensor was busy during the sequence
+	int64_t				cSeqWall_us;				//*	wall time since the sequence started
+	struct timeval		cSeqStartTime;				//*	start time of the first frame of the sequence
+	int					cSeqDutyFrameCnt;			//*	frames read in this sequence
+	int64_t				cSeqOverlap_us;				//*	processing time that overlapped the next exposure
 	bool				cDisplayImage;
 	bool				cSaveNextImage;				//*	this will get reset each time an image is taken
 	bool				cSaveAllImages;
@@ -772,7 +896,13 @@ protected:
 	IplImage			*cOpenCV_LiveDisplayPtr;
 	IplImage			*cOpenCV_Histogram;
 	CvVideoWriter		*cOpenCV_videoWriter;
+	IplImage			*cOpenCV_LiveSmallPtr;		//*	reduced size gray image for the live window
 #endif // _USE_OPENCV_CPP_
+	bool				cOpenCV_ImageWrapsBuffer;	//*	cOpenCV_ImagePtr is only a header over cCameraDataBuffer
+	uint32_t			cOpenCV_FrameAllocCnt;		//*	image allocations for the last frame
+	uint32_t			cOpenCV_FrameBytesCopied;	//*	image bytes copied for the last frame
+	uint32_t			cOpenCV_FrameTime_us;		//*	CreateOpenCVImage(), overlay and live window for the last frame
+	uint32_t			cOpenCV_SaveTime_us;		//*	SaveOpenCVImage() for the last saved frame
 #ifdef _ENABLE_CVFONT_
 	CvFont				cTextFont;
 	CvFont				cOverlayTextFont;
@@ -899,6 +1029,9 @@ typedef struct	//	TYPE_SensorName
 }	TYPE_SensorName;
 
 int		CreateCameraObjects(void);
+void	CreateCameraObjects_Begin(void);
+int		CreateCameraObjects_ATIK_ASI(void);
+void	CreateCameraObjects_End(void);
 
 //extern	const TYPE_CmdEntry	gCameraCmdTable[];
 extern	const char			*gCameraStateStrings[];
@@ -106,6 +106,17 @@
 //*	Apr 22,	2024	<MLS> Added support for kImageType_MONO8 (8 bit image type)
 //*	Nov 18,	2024	<MLS> Added local path option for saving file in case specified path fails
 //*	Dec  2,	2024	<MLS> Added COPYRGHT to FITS header
+//*	Oct 18,	2026	<MLS> Added SYNCSTRT, SYNCOFFS & SYNCSKEW for synchronized multicam exposures
+//*	Oct 18,	2026	<MLS> Added SYNCLAT, SYNCSTRT is now when the SDK start call returned
+//*	Oct 18,	2026	<MLS> WriteFITS_xxxInfo() now use the device state snapshots (devicestate_snapshot.c)
+//*	Oct 18,	2026	<MLS> Added RA, DEC, CENTALT & CENTAZ from the telescope snapshot
+//*	Oct 18,	2026	<MLS> Added DATE-PPS, exposure start from the GPS PPS in microseconds
+//*	Oct 18,	2026	<MLS> CreateFitsBGRimage() uses PixConv_Deinterleave24(), NEON_Deinterleave_RGB() moved there
+//*	Oct 18,	2026	<MLS> Added GetFitsSummary(), saved FITS files get a summary in the file index
+//*	Oct 18,	2026	<MLS> Added WriteFITS_Header(), GetFITS_ImageFormat() & BuildFitsHeaderCache()
+//*	Oct 18,	2026	<MLS> SaveImageAsFITS() writes the header from the FITS header cache
+//*	Oct 18,	2026	<MLS> ExtractFitsHeader() now puts the saved header in the FITS header cache
+//*	Oct 18,	2026	<MLS> Cached cards are copied after the fits_create_img() cards by position, not by keyword
 //*****************************************************************************
 //*	https://heasarc.gsfc.nasa.gov/docs/software/fitsio/c/c_user/cfitsio.html
 //*****************************************************************************
@@ -118,6 +129,8 @@
 #include	<stdio.h>
 #include	<stdlib.h>
 #include	<string.h>
+#include	<pthread.h>
+#include	<sys/time.h>
 
 #if defined(__arm__)
 	#include <wiringPi.h>
@@ -153,6 +166,9 @@
 #include	"julianTime.h"
 #include	"cpu_stats.h"
 #include	"NASA_moonphase.h"
+#include	"devicestate_snapshot.h"
+#include	"pixel_convert.h"
+#include	"fits_hdrcache.h"
 
 #ifdef _ENABLE_IMU_
 	#include "imu_lib.h"
@@ -322,6 +338,65 @@ double	fov_arcSeconds;
 	return(fov_arcSeconds);
 }
 
+#ifdef _ENABLE_FILE_INDEX_
+//*****************************************************************************
+//*	a one line summary of the header for the file index (filelist detail=true)
+//*	quotes are changed so the string can go into json as is
+//*****************************************************************************
+static void	GetFitsSummary(fitsfile *fitsFilePtr, char *summary, const size_t maxLen)
+{
+int		fitsStatus;
+long	naxis1;
+long	naxis2;
+int		bitpix;
+double	exposureTime;
+char	objectName[FLEN_VALUE];
+char	filterName[FLEN_VALUE];
+char	dateObs[FLEN_VALUE];
+int		iii;
+
+	naxis1			=	0;
+	naxis2			=	0;
+	bitpix			=	0;
+	exposureTime	=	0.0;
+	objectName[0]	=	0;
+	filterName[0]	=	0;
+	dateObs[0]		=	0;
+
+	//*	cfitsio skips the call if the status is not 0, so each one starts over
+	fitsStatus	=	0;
+	fits_read_key(fitsFilePtr, TLONG,	"NAXIS1",	&naxis1,		NULL, &fitsStatus);
+	fitsStatus	=	0;
+	fits_read_key(fitsFilePtr, TLONG,	"NAXIS2",	&naxis2,		NULL, &fitsStatus);
+	fitsStatus	=	0;
+	fits_read_key(fitsFilePtr, TINT,	"BITPIX",	&bitpix,		NULL, &fitsStatus);
+	fitsStatus	=	0;
+	fits_read_key(fitsFilePtr, TDOUBLE,	"EXPTIME",	&exposureTime,	NULL, &fitsStatus);
+	fitsStatus	=	0;
+	fits_read_key(fitsFilePtr, TSTRING,	"OBJECT",	objectName,		NULL, &fitsStatus);
+	fitsStatus	=	0;
+	fits_read_key(fitsFilePtr, TSTRING,	"FILTER",	filterName,		NULL, &fitsStatus);
+	fitsStatus	=	0;
+	fits_read_key(fitsFilePtr, TSTRING,	"DATE-OBS",	dateObs,		NULL, &fitsStatus);
+
+	snprintf(summary, maxLen, "%ldx%ld BITPIX=%d EXPTIME=%1.3f OBJECT=%s FILTER=%s DATE-OBS=%s",
+								naxis1,
+								naxis2,
+								bitpix,
+								exposureTime,
+								objectName,
+								filterName,
+								dateObs);
+	for (iii=0; summary[iii] != 0; iii++)
+	{
+		if ((summary[iii] == '"') || (summary[iii] == '\\') || ((unsigned char)summary[iii] < 0x20))
+		{
+			summary[iii]	=	'\'';
+		}
+	}
+}
+#endif // _ENABLE_FILE_INDEX_
+
 
 #if defined(_ENABLE_FILTERWHEEL_) || defined(_ENABLE_FILTERWHEEL_ZWO_) || defined(_ENABLE_FILTERWHEEL_ATIK_)
 //*****************************************************************************
@@ -376,6 +451,219 @@ void	CameraDriver::UpdateRotatorLink(void)
 
 #define	_INCLUDE_FITS_SEPARATOR_
 
+//*****************************************************************************
+void	CameraDriver::GetFITS_ImageFormat(int *fits_bitpix, int *fitsDataType, double *bzero, int *axisCnt)
+{
+	*axisCnt		=	2;				//*	for all formats except RGB
+	*fits_bitpix	=	SHORT_IMG;
+	*bzero			=	32768.0;
+
+	//*	for information about the BZERO data element, refer to
+	//*		https://docs.astropy.org/en/stable/io/fits/usage/image.html
+
+	switch(cROIinfo.currentROIimageType)
+	{
+		case kImageType_RAW8:
+		case kImageType_MONO8:
+//			CONSOLE_DEBUG("kImageType_RAW8");
+			*fits_bitpix	=	BYTE_IMG;
+			*fitsDataType	=	TBYTE;
+			*bzero			=	0.0;
+			break;
+
+		case kImageType_RAW16:
+//			CONSOLE_DEBUG("kImageType_RAW16");
+			*fits_bitpix	=	SHORT_IMG;
+			*fitsDataType	=	TUSHORT;
+			*bzero			=	32768.0;
+			break;
+
+		//	Fits doesnt support RGB, it has to be 3 arrays, R, G, B
+		case kImageType_RGB24:
+//			CONSOLE_DEBUG("kImageType_RGB24");
+			*fits_bitpix	=	8;
+			*fitsDataType	=	TBYTE;
+			*bzero			=	0.0;
+			*axisCnt		=	3;
+			break;
+
+		case kImageType_Y8:
+//			CONSOLE_DEBUG("kImageType_Y8");
+			*fits_bitpix	=	BYTE_IMG;
+			*fitsDataType	=	TUSHORT;
+			*bzero			=	0.0;
+			break;
+
+		default:
+			*fits_bitpix	=	16;
+			*fitsDataType	=	TUSHORT;
+			break;
+	}
+}
+
+//*****************************************************************************
+//*	everything after the required keywords that describes this frame,
+//*	the things that are different for each file (FILENAME etc) are not in here
+//*****************************************************************************
+void	CameraDriver::WriteFITS_Header(fitsfile *fitsFilePtr, bool includeAnalysis, double bscale, double bzero)
+{
+int		fitsStatus;
+
+	WriteFITS_Seperator(fitsFilePtr, "");
+
+	fitsStatus	=	0;
+	fits_write_key(fitsFilePtr, TDOUBLE,	"BSCALE",		&bscale,		NULL, &fitsStatus);
+
+	fitsStatus	=	0;
+	fits_write_key(fitsFilePtr, TDOUBLE,	"BZERO",		&bzero,			NULL, &fitsStatus);
+
+	fitsStatus	=	0;
+	fits_write_key(fitsFilePtr, TSTRING,	"TIMESYS",
+											(char *)"UTC approximate",
+											"Default time system", &fitsStatus);
+
+	//============================================================
+	//*	output info about the observation
+	WriteFITS_ObservationInfo(fitsFilePtr, includeAnalysis);
+
+	//*	https://free-astro.org/index.php?title=Siril:FITS_orientation
+	//*	https://siril.readthedocs.io/en/latest/file-formats/FITS.html#orientation-of-fits-images
+	fitsStatus	=	0;
+	fits_write_key(fitsFilePtr, TSTRING,	"ROWORDER",
+											(char *)"BOTTOM-UP",
+											NULL, &fitsStatus);
+
+	//============================================================
+	//*	Camera info
+	WriteFITS_CameraInfo(fitsFilePtr);
+
+	//============================================================
+	//*	Telescope info
+	WriteFITS_TelescopeInfo(fitsFilePtr);
+
+#ifdef _ENABLE_IMU_
+	//============================================================
+	//*	Telescope info
+	if (IMU_IsAvailable())
+	{
+		WriteFITS_IMUinfo(fitsFilePtr);
+	}
+#endif
+
+	//============================================================
+	//*	Focuser info
+	WriteFITS_FocuserInfo(fitsFilePtr);
+
+	//============================================================
+	//*	Rotator info
+	WriteFITS_RotatorInfo(fitsFilePtr);
+
+	//============================================================
+	//*	Filterwheel info
+	WriteFITS_FilterwheelInfo(fitsFilePtr);
+
+	//============================================================
+	//*	Observatory info
+	WriteFITS_ObservatoryInfo(fitsFilePtr);
+
+	//============================================================
+	//*	Environment/weather info
+	WriteFITS_EnvironmentInfo(fitsFilePtr);
+
+	//============================================================
+	//*	Moon information
+	WriteFITS_MoonInfo(fitsFilePtr);
+
+	//============================================================
+	//*	GPS information
+	//*	does not write anything if no GPS present
+	WriteFITS_GPSinfo(fitsFilePtr);
+
+	//============================================================
+	//*	Software info
+	WriteFITS_SoftwareInfo(fitsFilePtr);
+
+	//============================================================
+	//*	FITS version info
+	WriteFITS_VersionInfo(fitsFilePtr);
+
+
+	WriteFITS_Seperator(fitsFilePtr, "");
+}
+
+//*****************************************************************************
+//*	Generates the header for the current frame and puts it in the header cache.
+//*	It goes into a memory file so the WriteFITS_xxx() routines can be used as is.
+//*	Does nothing if the current frame is already in the cache.
+//*****************************************************************************
+bool	CameraDriver::BuildFitsHeaderCache(void)
+{
+fitsfile		*fitsFilePtr;
+long			naxes[3];
+int				axisCnt;
+int				fits_bitpix;
+int				fitsDataType;
+double			bzero;
+int				fitsStatus;
+int				cardCnt;
+int				requiredCnt;
+bool			headerOK;
+struct timeval	startTime;
+struct timeval	stopTime;
+
+	if (cFitsHdrCache == NULL)
+	{
+		return(false);
+	}
+	if (FitsHdrCache_HasFrame(cFitsHdrCache, cFramesRead))
+	{
+		return(true);
+	}
+	pthread_mutex_lock(&cFitsHdrCache->buildMutex);
+	//*	check again, it may have been made while we were waiting
+	headerOK	=	FitsHdrCache_HasFrame(cFitsHdrCache, cFramesRead);
+	if (headerOK == false)
+	{
+		gettimeofday(&startTime, NULL);
+		naxes[0]	=	cCameraProp.CameraXsize;
+		naxes[1]	=	cCameraProp.CameraYsize;
+		naxes[2]	=	3;
+		GetFITS_ImageFormat(&fits_bitpix, &fitsDataType, &bzero, &axisCnt);
+
+		fitsStatus	=	0;
+		if (fits_create_file(&fitsFilePtr, "mem://", &fitsStatus) == 0)
+		{
+			fitsStatus	=	0;
+			fits_create_img(fitsFilePtr, fits_bitpix, axisCnt, naxes, &fitsStatus);
+			//*	SIMPLE, BITPIX, NAXISn, EXTEND and the COMMENT lines about the FITS standard,
+			//*	SaveImageAsFITS() gets the same cards from its own fits_create_img()
+			requiredCnt	=	0;
+			fitsStatus	=	0;
+			fits_get_hdrspace(fitsFilePtr, &requiredCnt, NULL, &fitsStatus);
+			WriteFITS_Header(fitsFilePtr, ((cCameraDataBuffer != NULL) && (cFramesRead > 0)), 1.0, bzero);
+
+			cardCnt		=	ExtractFitsHeader(fitsFilePtr, false, requiredCnt);
+			headerOK	=	(cardCnt > 0);
+
+			//*	take the image back out so closing does not write a whole image of zeros
+			fitsStatus	=	0;
+			fits_resize_img(fitsFilePtr, fits_bitpix, 0, naxes, &fitsStatus);
+			fitsStatus	=	0;
+			fits_close_file(fitsFilePtr, &fitsStatus);
+
+			gettimeofday(&stopTime, NULL);
+			CONSOLE_DEBUG_W_LONG("Time to generate FITS header (microseconds)\t=",
+								(long)(((stopTime.tv_sec - startTime.tv_sec) * 1000000) + (stopTime.tv_usec - startTime.tv_usec)));
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_NUM("fits_create_file(mem://) failed, fitsStatus\t=", fitsStatus);
+		}
+	}
+	pthread_mutex_unlock(&cFitsHdrCache->buildMutex);
+	return(headerOK);
+}
+
 //*****************************************************************************
 //	https://software.cfht.hawaii.edu/cfitsio/node32.html
 //	 Creating a new FITS file
@@ -418,6 +706,12 @@ char			localFilePath[128];		//*	this is on the local directory in case the speci
 char			errorString[64];
 int				fits_bitpix;
 int				fitsDataType;
+#ifdef _ENABLE_FILE_INDEX_
+char			fitsSummary[kFileIndex_MaxSummaryLen];
+#endif
+TYPE_FITS_HDR	*fitsHdr;
+char			cardText[kFitsHdr_CardLen + 1];
+int				cardIdx;
 uint32_t		startMillisecs;
 uint32_t		stopMillisecs;
 uint32_t		deltaMillisecs;
@@ -446,52 +740,8 @@ int				iii;
 	naxes[0]		=	cCameraProp.CameraXsize;
 	naxes[1]		=	cCameraProp.CameraYsize;
 	naxes[2]		=	3;				//*	only used for color RGB images (3 planes)
-	axisCnt			=	2;				//*	for all formats except RGB
-	fits_bitpix		=	SHORT_IMG;
 	bscale			=	1.0;
-	bzero			=	32768.0;
-
-	//*	for information about the BZERO data element, refer to
-	//*		https://docs.astropy.org/en/stable/io/fits/usage/image.html
-
-	switch(cROIinfo.currentROIimageType)
-	{
-		case kImageType_RAW8:
-		case kImageType_MONO8:
-//			CONSOLE_DEBUG("kImageType_RAW8");
-			fits_bitpix		=	BYTE_IMG;
-			fitsDataType	=	TBYTE;
-			bzero			=	0.0;
-			break;
-
-		case kImageType_RAW16:
-//			CONSOLE_DEBUG("kImageType_RAW16");
-			fits_bitpix		=	SHORT_IMG;
-			fitsDataType	=	TUSHORT;
-			bzero			=	32768.0;
-			break;
-
-		//	Fits doesnt support RGB, it has to be 3 arrays, R, G, B
-		case kImageType_RGB24:
-//			CONSOLE_DEBUG("kImageType_RGB24");
-			fits_bitpix		=	8;
-			fitsDataType	=	TBYTE;
-			bzero			=	0.0;
-			axisCnt			=	3;
-			break;
-
-		case kImageType_Y8:
-//			CONSOLE_DEBUG("kImageType_Y8");
-			fits_bitpix		=	BYTE_IMG;
-			fitsDataType	=	TUSHORT;
-			bzero			=	0.0;
-			break;
-
-		default:
-			fits_bitpix		=	16;
-			fitsDataType	=	TUSHORT;
-			break;
-	}
+	GetFITS_ImageFormat(&fits_bitpix, &fitsDataType, &bzero, &axisCnt);
 
 	//*	if we are saving for AVI, then we are only saving the header data
 	if (headerOnly)
@@ -501,6 +751,20 @@ int				iii;
 		axisCnt			=	0;
 	}
 
+	//*	the header for this frame comes from the header cache,
+	//*	it only gets generated here if nobody has asked for it yet
+	fitsHdr	=	NULL;
+	if (headerOnly == false)
+	{
+		BuildFitsHeaderCache();
+		fitsHdr	=	FitsHdrCache_Acquire(cFitsHdrCache, cFramesRead);
+		//*	this frame has been saved before, that header already has FILENAME etc
+		if ((fitsHdr != NULL) && fitsHdr->fromSavedFile)
+		{
+			FitsHdrCache_Release(cFitsHdrCache, fitsHdr);
+			fitsHdr	=	NULL;
+		}
+	}
 
 	fitsStatus	=	0;
 	fitsRetCode	=	fits_create_file(&fitsFilePtr, imageFilePath, &fitsStatus);
@@ -531,22 +795,20 @@ int				iii;
 			CONSOLE_DEBUG_W_NUM("fits_create_img returned:", fitsRetCode);
 			CONSOLE_DEBUG_W_NUM("fitsStatus:", fitsStatus);
 		}
-		WriteFITS_Seperator(fitsFilePtr, "");
-
-		fitsStatus	=	0;
-		fits_write_key(fitsFilePtr, TDOUBLE,	"BSCALE",		&bscale,		NULL, &fitsStatus);
-
-		fitsStatus	=	0;
-		fits_write_key(fitsFilePtr, TDOUBLE,	"BZERO",		&bzero,			NULL, &fitsStatus);
-
-		fitsStatus	=	0;
-		fits_write_key(fitsFilePtr, TSTRING,	"TIMESYS",
-												(char *)"UTC approximate",
-												"Default time system", &fitsStatus);
-
-		//============================================================
-		//*	output info about the observation
-		WriteFITS_ObservationInfo(fitsFilePtr, (headerOnly == false));
+		if (fitsHdr != NULL)
+		{
+			//*	fits_create_img() has already written the required cards, the last one is END
+			for (cardIdx=fitsHdr->requiredCnt; cardIdx < (fitsHdr->cardCnt - 1); cardIdx++)
+			{
+				FitsHdr_GetCard(fitsHdr, cardIdx, cardText);
+				fitsStatus	=	0;
+				fits_write_record(fitsFilePtr, cardText, &fitsStatus);
+			}
+		}
+		else
+		{
+			WriteFITS_Header(fitsFilePtr, (headerOnly == false), bscale, bzero);
+		}
 
 		//*	leave FILENAME here so we dont have to pass the filename to the routine
 		fitsStatus	=	0;
@@ -573,13 +835,6 @@ int				iii;
 			}
 		}
 
-		//*	https://free-astro.org/index.php?title=Siril:FITS_orientation
-		//*	https://siril.readthedocs.io/en/latest/file-formats/FITS.html#orientation-of-fits-images
-		fitsStatus	=	0;
-		fits_write_key(fitsFilePtr, TSTRING,	"ROWORDER",
-												(char *)"BOTTOM-UP",
-												NULL, &fitsStatus);
-
 		if (headerOnly)
 		{
 			strcpy(aviFileName, cFileNameRoot);
@@ -592,62 +847,6 @@ int				iii;
 													"Filename of .avi data", &fitsStatus);
 		}
 
-		//============================================================
-		//*	Camera info
-		WriteFITS_CameraInfo(fitsFilePtr);
-
-		//============================================================
-		//*	Telescope info
-		WriteFITS_TelescopeInfo(fitsFilePtr);
-
-#ifdef _ENABLE_IMU_
-		//============================================================
-		//*	Telescope info
-		if (IMU_IsAvailable())
-		{
-			WriteFITS_IMUinfo(fitsFilePtr);
-		}
-#endif
-
-		//============================================================
-		//*	Focuser info
-		WriteFITS_FocuserInfo(fitsFilePtr);
-
-		//============================================================
-		//*	Rotator info
-		WriteFITS_RotatorInfo(fitsFilePtr);
-
-		//============================================================
-		//*	Filterwheel info
-		WriteFITS_FilterwheelInfo(fitsFilePtr);
-
-		//============================================================
-		//*	Observatory info
-		WriteFITS_ObservatoryInfo(fitsFilePtr);
-
-		//============================================================
-		//*	Environment/weather info
-		WriteFITS_EnvironmentInfo(fitsFilePtr);
-
-		//============================================================
-		//*	Moon information
-		WriteFITS_MoonInfo(fitsFilePtr);
-
-		//============================================================
-		//*	GPS information
-		//*	does not write anything if no GPS present
-		WriteFITS_GPSinfo(fitsFilePtr);
-
-		//============================================================
-		//*	Software info
-		WriteFITS_SoftwareInfo(fitsFilePtr);
-
-		//============================================================
-		//*	FITS version info
-		WriteFITS_VersionInfo(fitsFilePtr);
-
-
-		WriteFITS_Seperator(fitsFilePtr, "");
 		//------------------------------------------------------------------------
 		//*	now deal with the image data
 		if ((cCameraDataBuffer != NULL) && (headerOnly == false))
@@ -756,13 +955,22 @@ int				iii;
 		fitsStatus	=	0;
 		fits_write_chksum(fitsFilePtr, &fitsStatus);
 
-		ExtractFitsHeader(fitsFilePtr);
+		if (headerOnly == false)
+		{
+			ExtractFitsHeader(fitsFilePtr);
+		}
+	#ifdef _ENABLE_FILE_INDEX_
+		GetFitsSummary(fitsFilePtr, fitsSummary, sizeof(fitsSummary));
+	#endif
 
 		fitsStatus	=	0;
 		fitsRetCode	=	fits_close_file(fitsFilePtr, &fitsStatus);
 		if (fitsRetCode == 0)
 		{
 //			CONSOLE_DEBUG("fits_close_file = SUCCESS");
+		#ifdef _ENABLE_FILE_INDEX_
+			FileIndex_SetInfo(imageFileName, "FITS image", fitsSummary);
+		#endif
 		}
 		else
 		{
@@ -783,6 +991,7 @@ int				iii;
 		CONSOLE_DEBUG_W_STR("Linux errno:", errorString);
 
 	}
+	FitsHdrCache_Release(cFitsHdrCache, fitsHdr);
 
 //	CONSOLE_DEBUG_W_STR(__FUNCTION__, "Exit");
 
@@ -795,49 +1004,48 @@ int				iii;
 }
 
 //*****************************************************************************
+//*	the header goes into the header cache as the header for the current frame,
+//*	requiredCnt is how many cards at the start came from fits_create_img().
 //*	returns the number of lines extracted
 //*****************************************************************************
-int	CameraDriver::ExtractFitsHeader(fitsfile *fitsFilePtr)
+int	CameraDriver::ExtractFitsHeader(fitsfile *fitsFilePtr, bool fromSavedFile, int requiredCnt)
 {
-char		card[FLEN_CARD];
-int			nkeys;
-int			fitsStatus;
-int			iii;
-int			fitsHdrIdx;
+TYPE_FITS_HDR	*fitsHdr;
+char			card[FLEN_CARD];
+int				nkeys;
+int				fitsStatus;
+int				iii;
+int				fitsHdrIdx;
 
 //	CONSOLE_DEBUG(__FUNCTION__);
-	//*	wipe out any previous data
-	for (iii = 0; iii < kMaxFitsRecords; iii++)
-	{
-		cFitsHeader[iii].fitsRec[0]	=	0;
-	}
-
-	fitsStatus	=	0;	//* MUST initialize status
-	fits_get_hdrspace(fitsFilePtr, &nkeys, NULL, &fitsStatus);
 	fitsHdrIdx	=	0;
-	for (iii = 1; iii <= nkeys; iii++)
-	{
-		card[0]		=	0;
-		fitsStatus	=	0;
-		fits_read_record(fitsFilePtr, iii, card, &fitsStatus);	//* read keyword
-		if ((strlen(card) > 0) && (fitsHdrIdx < kMaxFitsRecords))
+	fitsHdr		=	FitsHdr_New(cFramesRead);
+	if (fitsHdr != NULL)
+	{
+		fitsHdr->fromSavedFile	=	fromSavedFile;
+		fitsHdr->requiredCnt	=	requiredCnt;
+		fitsStatus	=	0;	//* MUST initialize status
+		fits_get_hdrspace(fitsFilePtr, &nkeys, NULL, &fitsStatus);
+		for (iii = 1; iii <= nkeys; iii++)
 		{
-//			CONSOLE_DEBUG(card);
-			strcpy(cFitsHeader[fitsHdrIdx].fitsRec, card);
-			fitsHdrIdx++;
+			card[0]		=	0;
+			fitsStatus	=	0;
+			fits_read_record(fitsFilePtr, iii, card, &fitsStatus);	//* read keyword
+			if (strlen(card) > 0)
+			{
+				if (FitsHdr_AddCard(fitsHdr, card) == false)
+				{
+					CONSOLE_DEBUG("Ran out of room in fits header buffer");
+					break;
+				}
+				fitsHdrIdx++;
+			}
 		}
-	}
-	if (fitsHdrIdx < kMaxFitsRecords)
-	{
-		strcpy(cFitsHeader[fitsHdrIdx].fitsRec, "END");
-	}
-	else
-	{
-		CONSOLE_DEBUG("Ran out of room in fits header buffer");
+		FitsHdr_Finish(fitsHdr);
+		FitsHdrCache_Publish(cFitsHdrCache, fitsHdr);
 	}
 	return(fitsHdrIdx);
 }
-				TYPE_FITS_RECORD	cFitsHeader[kMaxFitsRecords];
 
 #pragma mark -
 
@@ -1190,7 +1398,7 @@ char	instrumentString[128];
 	fits_write_key(fitsFilePtr, TSTRING, "COMMENT",	stringBuf,		NULL, &fitsStatus);
 
 	//-------------------------------------------------------------------------------
-	sprintf(stringBuf, "Image Shutter: %d microseconds ", cCameraProp.Lastexposure_duration_us);
+	sprintf(stringBuf, "Image Shutter: %d microseconds ", cFrameExpInfo.duration_us);
 	fitsStatus	=	0;
 	fits_write_key(fitsFilePtr, TSTRING, "COMMENT",	stringBuf,		NULL, &fitsStatus);
 
@@ -1344,44 +1552,30 @@ bool		printDomeDataSrc;
 //*****************************************************************************
 void	CameraDriver::WriteFITS_FilterwheelInfo(fitsfile *fitsFilePtr)
 {
-int		fitsStatus;
+int					fitsStatus;
+TYPE_DeviceSnapshot	fwSnapshot;
+bool				fwSnapshotValid;
 
 //	CONSOLE_DEBUG(__FUNCTION__);
 
-#ifdef _ENABLE_FILTERWHEEL_
-	if (cConnectedFilterWheel == NULL)
+	//*	use the state published by the filter wheel, not the live driver
+	fwSnapshotValid	=	DeviceSnapshot_Read(kDeviceType_Filterwheel, cAlpacaDeviceNum, &fwSnapshot);
+	if (fwSnapshotValid)
 	{
-		UpdateFilterwheelLink();
+		cFilterWheelInfoValid	=	true;
 	}
-#endif	//	_ENABLE_FILTERWHEEL_
 
 	if (cFilterWheelInfoValid || cTS_info.hasFilterwheel)
 	{
 		WriteFITS_Seperator(fitsFilePtr, "Filter wheel Info");
 
-	#ifdef _ENABLE_FILTERWHEEL_
-		if (cFilterWheelInfoValid && (cConnectedFilterWheel != NULL))
-		{
-		int		fwAlpacaErr;		//*	filter wheel alpaca error code
-		int		filterPosition;
-		char	filterPositionName[48];
-
-//			CONSOLE_DEBUG("We have valid filterwheel info");
-//			CONSOLE_DEBUG("Calling Read_CurrentFilterPositon");
-//			CONSOLE_DEBUG_W_STR("cAlpacaName           \t=", cConnectedFilterWheel->cAlpacaName);
-//			CONSOLE_DEBUG_W_STR("cDeviceModel          \t=", cConnectedFilterWheel->cDeviceModel);
-//			CONSOLE_DEBUG_W_STR("cDeviceManufAbrev     \t=", cConnectedFilterWheel->cDeviceManufAbrev);
-//			CONSOLE_DEBUG_W_STR("cDeviceManufAbrev     \t=", cConnectedFilterWheel->cDeviceManufAbrev);
-//			CONSOLE_DEBUG_W_STR("cDeviceSerialNum      \t=", cConnectedFilterWheel->cDeviceSerialNum);
-//			CONSOLE_DEBUG_W_STR("cDeviceVersion        \t=", cConnectedFilterWheel->cDeviceVersion);
-//			CONSOLE_DEBUG_W_STR("cDeviceFirmwareVersStr\t=", cConnectedFilterWheel->cDeviceFirmwareVersStr);
-//			CONSOLE_DEBUG_W_STR("cCommonProp.Name      \t=", cConnectedFilterWheel->cCommonProp.Name);
-
-			if (strlen(cConnectedFilterWheel->cCommonProp.Name) > 0)
+		if (fwSnapshotValid)
+		{
+			if (strlen(fwSnapshot.dev.filterwheel.Name) > 0)
 			{
 				fitsStatus	=	0;
 				fits_write_key(fitsFilePtr, TSTRING,	"FILTWHL",
-														cConnectedFilterWheel->cCommonProp.Name,
+														fwSnapshot.dev.filterwheel.Name,
 														"Filter wheel used", &fitsStatus);
 			}
 			else if (strlen(cTS_info.filterwheel) > 0)
@@ -1393,43 +1587,35 @@ int		fitsStatus;
 			}
 
 			//----------------------------------------------------------------------
-			if (strlen(cConnectedFilterWheel->cDeviceSerialNum) > 0)
+			if (strlen(fwSnapshot.dev.filterwheel.SerialNumber) > 0)
 			{
 				fitsStatus	=	0;
 				fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
-														cConnectedFilterWheel->cDeviceSerialNum,
+														fwSnapshot.dev.filterwheel.SerialNumber,
 														"Serial Number", &fitsStatus);
 			}
 
-			fwAlpacaErr	=	cConnectedFilterWheel->Read_CurrentFilterPositon(&filterPosition);
-			if (fwAlpacaErr == kASCOM_Err_Success)
+			//*	the position is not valid while the wheel is moving
+			if ((fwSnapshot.dev.filterwheel.IsMoving == false) && (fwSnapshot.dev.filterwheel.Position >= 0))
 			{
 				fitsStatus	=	0;
 				fits_write_key(fitsFilePtr, TINT,		"FILPOS",
-														&filterPosition,
+														&fwSnapshot.dev.filterwheel.Position,
 														"Filter wheel position", &fitsStatus);
+				if (strlen(fwSnapshot.dev.filterwheel.FilterName) > 0)
+				{
+					fitsStatus	=	0;
+					fits_write_key(fitsFilePtr, TSTRING,	"FILTER",
+															fwSnapshot.dev.filterwheel.FilterName,
+															"Name of current filter", &fitsStatus);
+				}
 			}
 			else
 			{
-				CONSOLE_DEBUG_W_NUM("cConnectedFilterWheel->Read_CurrentFilterPositon returned ERROR:", fwAlpacaErr);
-			}
-//			CONSOLE_DEBUG("Calling Read_CurrentFilterName");
-			fwAlpacaErr	=	cConnectedFilterWheel->Read_CurrentFilterName(filterPositionName);
-			if (fwAlpacaErr == kASCOM_Err_Success)
-			{
-				fitsStatus	=	0;
-				fits_write_key(fitsFilePtr, TSTRING,	"FILTER",
-														filterPositionName,
-														"Name of current filter", &fitsStatus);
-			}
-			else
-			{
-				CONSOLE_DEBUG_W_NUM("cConnectedFilterWheel->Read_CurrentFilterName returned ERROR:", fwAlpacaErr);
+				CONSOLE_DEBUG("Filter wheel is moving, position not recorded");
 			}
-//			CONSOLE_DEBUG("Done with filter wheel stuff");
 		}
 		else
-	#endif // _ENABLE_FILTERWHEEL_
 		{
 			if (strlen(cTS_info.filterwheel) > 0)
 			{
@@ -1453,18 +1639,24 @@ int		fitsStatus;
 //*****************************************************************************
 void	CameraDriver::WriteFITS_FocuserInfo(fitsfile *fitsFilePtr)
 {
-//int		fitsRetCode;
-int		fitsStatus;
+int					fitsStatus;
+TYPE_DeviceSnapshot	focuserSnapshot;
+bool				focuserSnapshotValid;
 
 //	CONSOLE_DEBUG(__FUNCTION__);
 
-#ifdef _ENABLE_FOCUSER_
-
-	if (cConnectedFocuser == NULL)
+	//*	use the state published by the focuser, not the live driver
+	focuserSnapshotValid	=	DeviceSnapshot_Read(kDeviceType_Focuser, -1, &focuserSnapshot);
+	if (focuserSnapshotValid)
 	{
-		UpdateFocuserLink();
+		//*	if there is no focuser specified, get the name from the focuser
+		if (strlen(cTS_info.focuser) == 0)
+		{
+			strncpy(cTS_info.focuser, focuserSnapshot.dev.focuser.Model, (kTelescopeDefMaxStrLen - 1));
+			cTS_info.focuser[kTelescopeDefMaxStrLen - 1]	=	0;
+		}
+		cFocuserInfoValid	=	true;
 	}
-#endif	//	_ENABLE_FOCUSER_
 
 	if (cFocuserInfoValid || (strlen(cTS_info.focuser) > 0))
 	{
@@ -1478,26 +1670,29 @@ int		fitsStatus;
 													"Focuser used", &fitsStatus);
 		}
 
-	#ifdef _ENABLE_FOCUSER_
-		if (cConnectedFocuser != NULL)
+		if (focuserSnapshotValid)
 		{
-		long	focuserPosition;
-		char	dataBuff[128];
 		char	lineBuff[128];
 		double	dblValue;
 
-			focuserPosition	=	cConnectedFocuser->GetFocuserPosition();
 			fitsStatus	=	0;
 			fits_write_key(fitsFilePtr, TINT,		"TELFOCUS",
-													&focuserPosition,
+													&focuserSnapshot.dev.focuser.Position,
 													"Telescope Focuser position", &fitsStatus);
+			if (focuserSnapshot.dev.focuser.IsMoving)
+			{
+				strcpy(lineBuff, "Focuser was moving");
+				fitsStatus	=	0;
+				fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
+														lineBuff,
+														NULL, &fitsStatus);
+			}
 
 			//*	manufacturer
-			cConnectedFocuser->GetFocuserManufacturer(dataBuff);
-			if (strlen(dataBuff) > 0)
+			if (strlen(focuserSnapshot.dev.focuser.Manufacturer) > 0)
 			{
 				strcpy(lineBuff, "Focuser Manufacturer: ");
-				strcat(lineBuff, dataBuff);
+				strcat(lineBuff, focuserSnapshot.dev.focuser.Manufacturer);
 				fitsStatus	=	0;
 				fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
 														lineBuff,
@@ -1506,11 +1701,10 @@ int		fitsStatus;
 			}
 
 			//*	model
-			cConnectedFocuser->GetFocuserModel(dataBuff);
-			if (strlen(dataBuff) > 0)
+			if (strlen(focuserSnapshot.dev.focuser.Model) > 0)
 			{
 				strcpy(lineBuff, "Focuser Model: ");
-				strcat(lineBuff, dataBuff);
+				strcat(lineBuff, focuserSnapshot.dev.focuser.Model);
 				fitsStatus	=	0;
 				fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
 														lineBuff,
@@ -1518,11 +1712,10 @@ int		fitsStatus;
 			}
 
 			//*	version
-			cConnectedFocuser->GetFocuserVersion(dataBuff);
-			if (strlen(dataBuff) > 0)
+			if (strlen(focuserSnapshot.dev.focuser.Version) > 0)
 			{
 				strcpy(lineBuff, "Focuser Version: ");
-				strcat(lineBuff, dataBuff);
+				strcat(lineBuff, focuserSnapshot.dev.focuser.Version);
 				fitsStatus	=	0;
 				fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
 														lineBuff,
@@ -1530,11 +1723,10 @@ int		fitsStatus;
 			}
 
 			//*	serial number
-			cConnectedFocuser->GetFocuserSerialNumber(dataBuff);
-			if (strlen(dataBuff) > 0)
+			if (strlen(focuserSnapshot.dev.focuser.SerialNumber) > 0)
 			{
 				strcpy(lineBuff, "Focuser Serial Number: ");
-				strcat(lineBuff, dataBuff);
+				strcat(lineBuff, focuserSnapshot.dev.focuser.SerialNumber);
 				fitsStatus	=	0;
 				fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
 														lineBuff,
@@ -1542,7 +1734,7 @@ int		fitsStatus;
 			}
 
 			//*	Temperature
-			dblValue	=	cConnectedFocuser->GetFocuserTemperature();
+			dblValue	=	focuserSnapshot.dev.focuser.Temperature_DegC;
 			if (dblValue != 0.0)
 			{
 
@@ -1558,7 +1750,7 @@ int		fitsStatus;
 			}
 
 			//*	Voltage
-			dblValue	=	cConnectedFocuser->GetFocuserVoltage();
+			dblValue	=	focuserSnapshot.dev.focuser.Voltage;
 			if (dblValue > 1.0)
 			{
 				sprintf(lineBuff, "Focuser Voltage: %1.1f", dblValue);
@@ -1572,7 +1764,6 @@ int		fitsStatus;
 														"Voltage at the focuser", &fitsStatus);
 			}
 		}
-	#endif // _ENABLE_FOCUSER_
 	}
 }
 
@@ -1746,12 +1937,12 @@ struct tm		myLocalTime;
 	}
 
 	//*	format the time of exposure start
-	FormatTimeStringISO8601(&cCameraProp.Lastexposure_StartTime, stringBuf);
+	FormatTimeStringISO8601(&cFrameExpInfo.startTime, stringBuf);
 //	CONSOLE_DEBUG_W_STR("stringBuf:", stringBuf);
 	fitsStatus	=	0;
 	fits_write_key(fitsFilePtr, TSTRING, "DATE-OBS",	stringBuf,		"UTC date of observation", &fitsStatus);
 
-	gmtime_r(&cCameraProp.Lastexposure_StartTime.tv_sec, &utcTime);
+	gmtime_r(&cFrameExpInfo.startTime.tv_sec, &utcTime);
 	CalcSiderealTime(&utcTime, &siderealTime, gObseratorySettings.Longitude_deg);
 	FormatTimeString_TM(&siderealTime, stringBuf);
 	fitsStatus	=	0;
@@ -1761,7 +1952,7 @@ struct tm		myLocalTime;
 
 	//==============================================================
 	//*	include the local time as well
-	localTime		=	localtime(&cCameraProp.Lastexposure_StartTime.tv_sec);
+	localTime		=	localtime(&cFrameExpInfo.startTime.tv_sec);
 	FormatTimeString_TM(localTime, stringBuf);
 
 	fitsStatus	=	0;
@@ -1779,21 +1970,75 @@ struct tm		myLocalTime;
 											&fitsStatus);
 
 	//==============================================================
-	modifiedJulianDate	=	Julian_CalcMJD(&cCameraProp.Lastexposure_StartTime);
+	modifiedJulianDate	=	Julian_CalcMJD(&cFrameExpInfo.startTime);
 	fitsStatus			=	0;
 	fits_write_key(fitsFilePtr, TDOUBLE,	"MJD-OBS",
 											&modifiedJulianDate,
 											"MJD of observation", &fitsStatus);
 
-	modifiedJulianDate	=	Julian_CalcMJD(&cCameraProp.Lastexposure_EndTime);
+	modifiedJulianDate	=	Julian_CalcMJD(&cFrameExpInfo.endTime);
 	fitsStatus	=	0;
 	fits_write_key(fitsFilePtr, TDOUBLE,	"MJDEND",
 											&modifiedJulianDate,
 											"MJD at end of exposure", &fitsStatus);
 
+	//==============================================================
+	//*	synchronized multicam start, DATE-OBS only has milliseconds
+	if (cSyncStartValid)
+	{
+	struct tm	*syncTime;
+
+		syncTime	=	gmtime(&cSyncStartTime.tv_sec);
+		sprintf(stringBuf, "%d-%02d-%02dT%02d:%02d:%02d.%06ld",
+								(1900 + syncTime->tm_year),
+								(1 + syncTime->tm_mon),
+								syncTime->tm_mday,
+								syncTime->tm_hour,
+								syncTime->tm_min,
+								syncTime->tm_sec,
+								(long)cSyncStartTime.tv_usec);
+		fitsStatus	=	0;
+		fits_write_key(fitsFilePtr, TSTRING,	"SYNCSTRT",
+												stringBuf,
+												"UTC start of synchronized exposure", &fitsStatus);
+		fitsStatus	=	0;
+		fits_write_key(fitsFilePtr, TINT,		"SYNCOFFS",
+												&cSyncStartOffset_us,
+												"Start offset from first camera (usecs)", &fitsStatus);
+		fitsStatus	=	0;
+		fits_write_key(fitsFilePtr, TINT,		"SYNCSKEW",
+												&cSyncSkew_us,
+												"Start skew across all cameras (usecs)", &fitsStatus);
+		fitsStatus	=	0;
+		fits_write_key(fitsFilePtr, TINT,		"SYNCLAT",
+												&cSyncLatency_us,
+												"SDK start call latency (usecs)", &fitsStatus);
+	}
+
+	//==============================================================
+	//*	GPS PPS start time, DATE-OBS only has milliseconds and comes from the system clock
+	if (cExposureStartPPSvalid)
+	{
+	struct tm	ppsTime;
+
+		gmtime_r(&cExposureStartPPS.tv_sec, &ppsTime);
+		sprintf(stringBuf, "%d-%02d-%02dT%02d:%02d:%02d.%06ld",
+								(1900 + ppsTime.tm_year),
+								(1 + ppsTime.tm_mon),
+								ppsTime.tm_mday,
+								ppsTime.tm_hour,
+								ppsTime.tm_min,
+								ppsTime.tm_sec,
+								(long)cExposureStartPPS.tv_usec);
+		fitsStatus	=	0;
+		fits_write_key(fitsFilePtr, TSTRING,	"DATE-PPS",
+												stringBuf,
+												"UTC start of exposure from GPS PPS", &fitsStatus);
+	}
+
 	//==============================================================
 	fitsStatus	=	0;
-	exposureTime_Secs	=	(cCameraProp.Lastexposure_duration_us * 1.0) / 1000000.0;
+	exposureTime_Secs	=	(cFrameExpInfo.duration_us * 1.0) / 1000000.0;
 	fits_write_key(fitsFilePtr, TDOUBLE,	"EXPTIME",
 											&exposureTime_Secs,
 											"Exposure time (seconds)", &fitsStatus);
@@ -1917,75 +2162,59 @@ struct tm		myLocalTime;
 //*****************************************************************************
 void	CameraDriver::WriteFITS_RotatorInfo(fitsfile *fitsFilePtr)
 {
+int					fitsStatus;
+TYPE_DeviceSnapshot	rotatorSnapshot;
+char				lineBuff[128];
 
 //	CONSOLE_DEBUG(__FUNCTION__);
 
-#ifdef _ENABLE_ROTATOR_
-	if (cConnectedRotator == NULL)
+	//*	use the state published by the rotator, not the live driver
+	if (DeviceSnapshot_Read(kDeviceType_Rotator, -1, &rotatorSnapshot))
 	{
-		UpdateRotatorLink();
-	}
-#endif // _ENABLE_ROTATOR_
+		cRotatorInfoValid	=	true;
+		WriteFITS_Seperator(fitsFilePtr, "Rotator Info");
 
-	if (cRotatorInfoValid)
-	{
-	#ifdef _ENABLE_ROTATOR_
-		if (cConnectedRotator != NULL)
+		//*	manufacturer
+		if (strlen(rotatorSnapshot.dev.rotator.Manufacturer) > 0)
 		{
-		int		fitsStatus;
-		long	currentRotatorPos;
-		char	lineBuff[128];
-		char	dataBuff[128];
-
-			WriteFITS_Seperator(fitsFilePtr, "Rotator Info");
-			currentRotatorPos	=	cConnectedRotator->ReadCurrentPoisiton_steps();
-
-			//*	manufacturer
-			cConnectedRotator->GetRotatorManufacturer(dataBuff);
-			if (strlen(dataBuff) > 0)
-			{
-				strcpy(lineBuff, "Rotator Manufacturer: ");
-				strcat(lineBuff, dataBuff);
-				fitsStatus	=	0;
-				fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
-														lineBuff,
-														NULL, &fitsStatus);
-
-			}
+			strcpy(lineBuff, "Rotator Manufacturer: ");
+			strcat(lineBuff, rotatorSnapshot.dev.rotator.Manufacturer);
+			fitsStatus	=	0;
+			fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
+													lineBuff,
+													NULL, &fitsStatus);
 
-			//*	model
-			cConnectedRotator->GetRotatorModel(dataBuff);
-			if (strlen(dataBuff) > 0)
-			{
-				strcpy(lineBuff, "Rotator Model: ");
-				strcat(lineBuff, dataBuff);
-				fitsStatus	=	0;
-				fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
-														lineBuff,
-														NULL, &fitsStatus);
-			}
+		}
 
-			//*	serial number
-			cConnectedRotator->GetRotatorSerialNumber(dataBuff);
-			if (strlen(dataBuff) > 0)
-			{
-				strcpy(lineBuff, "Rotator Serial Number: ");
-				strcat(lineBuff, dataBuff);
-				fitsStatus	=	0;
-				fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
-														lineBuff,
-														NULL, &fitsStatus);
-			}
+		//*	model
+		if (strlen(rotatorSnapshot.dev.rotator.Model) > 0)
+		{
+			strcpy(lineBuff, "Rotator Model: ");
+			strcat(lineBuff, rotatorSnapshot.dev.rotator.Model);
+			fitsStatus	=	0;
+			fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
+													lineBuff,
+													NULL, &fitsStatus);
+		}
 
-			sprintf(lineBuff, "Rotator position: %ld", currentRotatorPos);
+		//*	serial number
+		if (strlen(rotatorSnapshot.dev.rotator.SerialNumber) > 0)
+		{
+			strcpy(lineBuff, "Rotator Serial Number: ");
+			strcat(lineBuff, rotatorSnapshot.dev.rotator.SerialNumber);
 			fitsStatus	=	0;
 			fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
 													lineBuff,
 													NULL, &fitsStatus);
 		}
-	#endif // _ENABLE_ROTATOR_
-	}
 
+		sprintf(lineBuff, "Rotator position: %d%s",	rotatorSnapshot.dev.rotator.Position_steps,
+													(rotatorSnapshot.dev.rotator.IsMoving ? " (moving)" : ""));
+		fitsStatus	=	0;
+		fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
+												lineBuff,
+												NULL, &fitsStatus);
+	}
 }
 
 //*****************************************************************************
@@ -2109,6 +2338,8 @@ double	angularResolution_perPixel;
 double	fov_arcSeconds_X;
 double	fov_arcSeconds_Y;
 double	f_ratio;
+TYPE_DeviceSnapshot	mountSnapshot;
+double	raDegrees;
 
 //	CONSOLE_DEBUG(__FUNCTION__);
 
@@ -2122,6 +2353,37 @@ double	f_ratio;
 													cTelescopeModel,
 													"Telescope", &fitsStatus);
 
+		//-----------------------------------------------------------
+		//*	mount position, from the state published by the telescope driver
+		if (DeviceSnapshot_Read(kDeviceType_Telescope, -1, &mountSnapshot))
+		{
+			raDegrees	=	mountSnapshot.dev.telescope.RightAscension * 15.0;
+			fitsStatus	=	0;
+			fits_write_key(fitsFilePtr, TDOUBLE,	"RA",
+													&raDegrees,
+													"Telescope RA (degrees)", &fitsStatus);
+			fitsStatus	=	0;
+			fits_write_key(fitsFilePtr, TDOUBLE,	"DEC",
+													&mountSnapshot.dev.telescope.Declination,
+													"Telescope DEC (degrees)", &fitsStatus);
+			fitsStatus	=	0;
+			fits_write_key(fitsFilePtr, TDOUBLE,	"CENTALT",
+													&mountSnapshot.dev.telescope.Altitude,
+													"Telescope altitude (degrees)", &fitsStatus);
+			fitsStatus	=	0;
+			fits_write_key(fitsFilePtr, TDOUBLE,	"CENTAZ",
+													&mountSnapshot.dev.telescope.Azimuth,
+													"Telescope azimuth (degrees)", &fitsStatus);
+			if (mountSnapshot.dev.telescope.Slewing)
+			{
+				strcpy(stringBuf, "Telescope was slewing");
+				fitsStatus	=	0;
+				fits_write_key(fitsFilePtr, TSTRING,	"COMMENT",
+														stringBuf,
+														NULL, &fitsStatus);
+			}
+		}
+
 		//-----------------------------------------------------------
 		//*	this is from the observatory config file
 		if (cTS_info.focalLen_mm > 0)
@@ -2311,8 +2573,8 @@ TYPE_MoonPhase	moonPhaseInfo;
 	WriteFITS_Seperator(fitsFilePtr, "Moon Info");
 	//-------------------------------------------------------------
 	//*	use the start of exposure time
-	linuxTime		=	gmtime(&cCameraProp.Lastexposure_StartTime.tv_sec);
-	FormatTimeStringISO8601(&cCameraProp.Lastexposure_StartTime, timeString);
+	linuxTime		=	gmtime(&cFrameExpInfo.startTime.tv_sec);
+	FormatTimeStringISO8601(&cFrameExpInfo.startTime, timeString);
 
 	currentYear		=	(1900 + linuxTime->tm_year);
 	currentMonth	=	(1 + linuxTime->tm_mon);
@@ -2637,68 +2899,10 @@ char	lineBuff[80];
 
 #pragma mark -
 
-#ifdef __ARM_NEON
-
-//	define the Neon intrinsics.
-#include <arm_neon.h>
-
-//*****************************************************************************
-//*	some testing of advanced ARM NEON cpu options
-//	https://developer.arm.com/documentation/101028/0012/3--C-language-extensions?lang=en
-//	https://developer.arm.com/architectures/instruction-sets/simd-isas/neon/intrinsics
-//	https://developer.arm.com/architectures/instruction-sets/simd-isas/neon/neon-programmers-guide-for-armv8-a/optimizing-c-code-with-neon-intrinsics/rgb-deinterleaving
-//	https://fits.gsfc.nasa.gov/fits_dictionary.html
-//*****************************************************************************
-//*****************************************************************************
-//*	this routine uses ARM NEON SIMD instructions to do the interleaving of the RGB image
-//*	to the bbbb...... ggggg..... rrrrr.... buffer required by FITS
-//*	In testing with a ZWO-120MC camera (1.2 megapixles) it reduced the time
-//*	from 9 millisces to 5 millisecs.  Not much, but should be a lot on the bigger cameras.
-//*	This only works on 64 bit ARM such as Jetson or Raspbian64.
-//*
-//*	This is a first stepping stone to take advantage of the NEON SIMD instructions
-//*****************************************************************************
-void NEON_Deinterleave_RGB(	uint8_t	*rgb,
-							uint8_t	*r,
-							uint8_t	*g,
-							uint8_t	*b,
-							int		len_color)
-{
-int				num8x16;
-uint8x16x3_t	intlv_rgb;
-int				iii;
-int				leftOverCount;
-
-//	CONSOLE_DEBUG(__FUNCTION__);
-	//*
-	//*	Take the elements of "rgb" and store the individual colors "r", "g", and "b"
-	//*
-	SETUP_TIMING();
-	num8x16	=	len_color / 16;
-//	CONSOLE_DEBUG_W_NUM("len_color\t=", len_color);
-//	CONSOLE_DEBUG_W_NUM("num8x16  \t=",	num8x16);
-	for (iii = 0; iii < num8x16; iii++)
-	{
-		intlv_rgb	=	vld3q_u8(rgb + (3 * 16 * iii));
-		vst1q_u8(r + (16 * iii), intlv_rgb.val[0]);
-		vst1q_u8(g + (16 * iii), intlv_rgb.val[1]);
-		vst1q_u8(b + (16 * iii), intlv_rgb.val[2]);
-	}
-	leftOverCount	=	len_color % 16;
-	if (leftOverCount > 0)
-	{
-
-	}
-	DEBUG_TIMING("Using NEON to Deinterleave");
-}
-#endif
-
 //*****************************************************************************
 void		CameraDriver::CreateFitsBGRimage(void)
 {
 long			frameBufSize;
-long			iii;
-long			ppp;
 unsigned char	*redBufPtr;
 unsigned char	*grnBufPtr;
 unsigned char	*bluBufPtr;
@@ -2718,37 +2922,11 @@ unsigned char	*bluBufPtr;
 			bluBufPtr	=	cCameraBGRbuffer;
 			grnBufPtr	=	cCameraBGRbuffer + frameBufSize;
 			redBufPtr	=	cCameraBGRbuffer + frameBufSize + frameBufSize;
-		#ifdef __ARM_NEON
-			//:2379 [CreateFitsBGRimage  ] CreateFitsBGRimage
-			//:2402 [CreateFitsBGRimage  ] Using CPU to Deinterleave 307
-			//:2410 [CreateFitsBGRimage  ] NEON instructions set is available
-			//:2345 [NEON_Deinterleave_RGB] NEON_Deinterleave_RGB
-			//:2351 [NEON_Deinterleave_RGB] len_color	= 16389120
-			//:2352 [NEON_Deinterleave_RGB] num8x16  	= 1024320
-			//:2365 [NEON_Deinterleave_RGB] Using NEON to Deinterleave 136
-			//:2429 [CreateFitsBGRimage  ] NEON diff count	= 0
-			//-----------------------------------------------------------
-			//*	determine the number of NEON opperations
-			//*	For now, it must be an even multiple of 16
-			if ((frameBufSize % 16) == 0)
-			{
-				CONSOLE_DEBUG("Using NEON instructions for de-interleave");
 
-				NEON_Deinterleave_RGB(cCameraDataBuffer, redBufPtr, grnBufPtr, bluBufPtr, frameBufSize);
-			}
-			else
-		#endif // __ARM_NEON
-			{
-				SETUP_TIMING();
-				iii	=	0;
-				for (ppp=0; ppp<frameBufSize; ppp++)
-				{
-					redBufPtr[ppp]	=	cCameraDataBuffer[iii++];
-					grnBufPtr[ppp]	=	cCameraDataBuffer[iii++];
-					bluBufPtr[ppp]	=	cCameraDataBuffer[iii++];
-				}
-				DEBUG_TIMING("Using CPU to Deinterleave");
-			}
+			//*	NEON on the Pi, SSSE3 on x86, any size, the left over pixels are done one at a time
+			SETUP_TIMING();
+			PixConv_Deinterleave24(redBufPtr, grnBufPtr, bluBufPtr, cCameraDataBuffer, frameBufSize);
+			DEBUG_TIMING("Deinterleave");
 		}
 		else
 		{
@@ -40,6 +40,7 @@
 //*	Apr 19,	2020	<MLS> Fixed cross hair location when using sidebar
 //*	Feb 21,	2021	<MLS> Added CloseLiveImage(), live window now closes properly
 //*	Feb 23,	2022	<MLS> Working on converting C++ versions of opencv
+//*	Oct 18,	2026	<MLS> Added GetLiveSmallImage(), live view no longer allocates every frame
 //*****************************************************************************
 
 #if defined(_ENABLE_CAMERA_) && defined(_USE_OPENCV_)
@@ -327,6 +328,11 @@ int	iii;
 	{
 		CONSOLE_DEBUG("No window to close, (cOpenCV_LiveDispla NULL");
 	}
+	if (cOpenCV_LiveSmallPtr != NULL)
+	{
+		cvReleaseImage(&cOpenCV_LiveSmallPtr);
+		cOpenCV_LiveSmallPtr	=	NULL;
+	}
 	CONSOLE_DEBUG("Calling cvDestroyWindow(cOpenCV_ImgWindowName)");
 	cvDestroyWindow(cOpenCV_ImgWindowName);
 #endif // _USE_OPENCV_CPP_
@@ -480,6 +486,28 @@ void	CameraDriver::DisplayLiveImage_wSideBar(void)
 //	CONSOLE_DEBUG_W_STR(__FUNCTION__, "OpenCV++ not finished");
 }
 #else
+//*****************************************************************************
+//*	returns the reduced size gray scale image used by the live view,
+//*	it is only re-created when the live display size or the depth changes
+//*****************************************************************************
+IplImage	*CameraDriver::GetLiveSmallImage(const int imageDepth)
+{
+	if ((cOpenCV_LiveSmallPtr != NULL) &&
+		((cOpenCV_LiveSmallPtr->width != cLiveDisplayWidth) ||
+		(cOpenCV_LiveSmallPtr->height != cLiveDisplayHeight) ||
+		(cOpenCV_LiveSmallPtr->depth != imageDepth)))
+	{
+		cvReleaseImage(&cOpenCV_LiveSmallPtr);
+		cOpenCV_LiveSmallPtr	=	NULL;
+	}
+	if (cOpenCV_LiveSmallPtr == NULL)
+	{
+		cOpenCV_LiveSmallPtr	=	cvCreateImage(cvSize(cLiveDisplayWidth, cLiveDisplayHeight), imageDepth, 1);
+		cOpenCV_FrameAllocCnt++;
+	}
+	return(cOpenCV_LiveSmallPtr);
+}
+
 //*****************************************************************************
 void	CameraDriver::DisplayLiveImage_wSideBar(void)
 {
@@ -563,6 +591,7 @@ CvRect		myCVrect;
 
 				}
 				CONSOLE_DEBUG("New display image created");
+				cOpenCV_FrameAllocCnt++;
 				SetOpenCVcolors(cOpenCV_LiveDisplayPtr);
 			}
 
@@ -617,8 +646,8 @@ CvRect		myCVrect;
 
 					//CONSOLE_DEBUG_W_STR(__FUNCTION__, "chan = 1 and depth = 8");
 
-					//*	create a small image (8 bit)
-					smallImg	=	cvCreateImage(cvSize(cLiveDisplayWidth, cLiveDisplayHeight), IPL_DEPTH_8U, 1);
+					//*	the small image (8 bit) is kept from frame to frame
+					smallImg	=	GetLiveSmallImage(IPL_DEPTH_8U);
 					if (smallImg != NULL)
 					{
 						cvResize(cOpenCV_ImagePtr, smallImg, CV_INTER_LINEAR);
@@ -633,7 +662,6 @@ CvRect		myCVrect;
 					#endif // _ENABLE_STAR_SEARCH_
 
 						cvCvtColor(smallImg, cOpenCV_LiveDisplayPtr, CV_GRAY2RGB);
-						cvReleaseImage(&smallImg);
 					}
 					else
 					{
@@ -646,14 +674,13 @@ CvRect		myCVrect;
 
 					CONSOLE_DEBUG_W_STR(__FUNCTION__, "chan = 1 and depth = 16");
 
-					//*	create a small image (16 bit)
-					smallImg	=	cvCreateImage(cvSize(cLiveDisplayWidth, cLiveDisplayHeight), IPL_DEPTH_16U, 1);
+					//*	the small image (16 bit) is kept from frame to frame
+					smallImg	=	GetLiveSmallImage(IPL_DEPTH_16U);
 					if (smallImg != NULL)
 					{
 						cvResize(cOpenCV_ImagePtr, smallImg, CV_INTER_LINEAR);
 
 						cvCvtColor(smallImg, cOpenCV_LiveDisplayPtr, CV_GRAY2RGB);
-						cvReleaseImage(&smallImg);
 					}
 					else
 					{
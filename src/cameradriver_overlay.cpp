@@ -72,12 +72,12 @@ cv::Scalar	textColor;
 				strcat(overlayString, " GPS=");
 				strcat(overlayString, cGPS.ShutterStartTimeStr);
 			}
-			FormatTimeStringISO8601(&cCameraProp.Lastexposure_StartTime, timeString);
+			FormatTimeStringISO8601(&cFrameExpInfo.startTime, timeString);
 			strcat(overlayString, " SYS=");
 			strcat(overlayString, timeString);
 
 			//*	compute the exposure time in seconds
-			exposureTimeSecs	=	(cCameraProp.Lastexposure_duration_us * 1.0) / 1000000.0;
+			exposureTimeSecs	=	(cFrameExpInfo.duration_us * 1.0) / 1000000.0;
 
 			sprintf(timeString, " EXP=%3.6f (seconds)", exposureTimeSecs);
 			strcat(overlayString, timeString);
@@ -25,6 +25,8 @@
 //*	Sep  9,	2023	<MLS> Created cameradriver_readthread.cpp
 //*	Sep 23,	2023	<MLS> Moved camera temp logging to CameraDriver::RunThread_Loop()
 //*	Apr 22,	2024	<MLS> Added RunThread_CheckPictureStatus()
+//*	Oct 18,	2026	<MLS> Cooler power is logged to the time series store
+//*	Oct 18,	2026	<MLS> Temperature logging moved to TemperatureLog_Update()
 //*****************************************************************************
 
 #ifdef _ENABLE_CAMERA_
@@ -56,9 +58,6 @@ void	CameraDriver::RunThread_Startup(void)
 //*****************************************************************************
 void	CameraDriver::RunThread_Loop(void)
 {
-time_t		deltaSeconds;
-time_t		currentSeconds;
-
 //	CONSOLE_DEBUG_W_STR(__FUNCTION__, "Camera");
 	switch(cInternalCameraState)
 	{
@@ -83,23 +82,7 @@ time_t		currentSeconds;
 			//*	we should never get here
 			break;
 	}
-	if (cTempReadSupported)
-	{
-		//*	if we support camera temperature, log it every 30 seconds
-		currentSeconds	=   GetSecondsSinceEpoch();
-		deltaSeconds	=	currentSeconds - cLastTempUpdate_Secs;
-		if (deltaSeconds >= 30)
-		{
-		TYPE_ASCOM_STATUS	alpacaErrCode;
-
-			alpacaErrCode	=	Read_SensorTemp();
-			if (alpacaErrCode == kASCOM_Err_Success)
-			{
-				TemperatureLog_AddEntry(cCameraProp.CCDtemperature);
-			}
-			cLastTempUpdate_Secs	=	currentSeconds;
-		}
-	}
+	TemperatureLog_Update();
 	usleep(25000);
 }
 
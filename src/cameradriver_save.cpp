@@ -37,6 +37,11 @@
 //*	Jul 25,	2022	<MLS> Increased # of decimal points in WriteIMUtextFile()
 //*	Oct  5,	2022	<MLS> Added ReadIMUdata()
 //*	Jun 13,	2023	<MLS> Added checking for valid IMU
+//*	Oct 18,	2026	<MLS> CreateOpenCVImage() wraps cCameraDataBuffer instead of copying it
+//*	Oct 18,	2026	<MLS> Added ReleaseOpenCVImage(), images are only re-created when the format changes
+//*	Oct 18,	2026	<MLS> AddToDataProductsList() passes the comment to the file index
+//*	Oct 18,	2026	<MLS> ReadIMUdata() takes Euler angles from the IMU background averages
+//*	Oct 18,	2026	<MLS> SaveImageData() times SaveOpenCVImage(), opencv-save_us in readall
 //*****************************************************************************
 
 #ifdef _ENABLE_CAMERA_
@@ -75,7 +80,11 @@
 //*****************************************************************************
 void	CameraDriver::SaveImageData(void)
 {
-int		iii;
+int				iii;
+#ifdef _USE_OPENCV_
+struct timeval	saveStart;
+struct timeval	saveDone;
+#endif
 
 
 	CONSOLE_DEBUG_W_NUM("cSaveNextImage\t=", cSaveNextImage);
@@ -112,7 +121,11 @@ int		iii;
 	#ifdef _USE_OPENCV_
 		if (cSaveAsJPEG || cSaveAsPNG)
 		{
+			gettimeofday(&saveStart, NULL);
 			SaveOpenCVImage();
+			gettimeofday(&saveDone, NULL);
+			cOpenCV_SaveTime_us	=	((saveDone.tv_sec - saveStart.tv_sec) * 1000000) +
+									(saveDone.tv_usec - saveStart.tv_usec);
 		}
 	#endif	//	_USE_OPENCV_
 
@@ -195,6 +208,9 @@ int		fileNameLen;
 	{
 		CONSOLE_DEBUG("cOtherDataProducts list is full");
 	}
+#ifdef _ENABLE_FILE_INDEX_
+	FileIndex_SetInfo(newDataProductName, newDatacomment, NULL);
+#endif
 }
 
 
@@ -202,6 +218,9 @@ int		fileNameLen;
 #if defined(_USE_OPENCV_CPP_) || (CV_MAJOR_VERSION >= 4)
 //*****************************************************************************
 //*	using "C++" interface
+//*	The image is a cv::Mat header over cCameraDataBuffer, nothing is allocated
+//*	or copied per frame. The overlay draws into the image so when it is on the
+//*	image gets its own buffer, which is only re-allocated if the size changes.
 //*****************************************************************************
 int	CameraDriver::CreateOpenCVImage(const unsigned char *imageDataPtr)
 {
@@ -209,25 +228,14 @@ int				returnCode	=	0;
 int				width;
 int				height;
 int				imageDataLen;
-
-//	CONSOLE_DEBUG("++++++++++++++++++++++++++++++++++++++++++++++++++++++++");
-//	CONSOLE_DEBUG("+++++           OpenCV++ not finished              +++++");
-//	CONSOLE_DEBUG("+++++           Finish this NEXT!!!!!!             +++++");
-//	CONSOLE_DEBUG("++++++++++++++++++++++++++++++++++++++++++++++++++++++++");
+int				openCVtype;
+bool			wrapBuffer;
 
 	CONSOLE_DEBUG(__FUNCTION__);
 
 	GenerateFileNameRoot();
-	if (cOpenCV_ImagePtr != NULL)
-	{
-		delete cOpenCV_ImagePtr;
-		cOpenCV_ImagePtr	=	NULL;
-	}
-	if (cOpenCV_LiveDisplayPtr != NULL)
-	{
-		delete cOpenCV_LiveDisplayPtr;
-		cOpenCV_LiveDisplayPtr	=	NULL;
-	}
+	cOpenCV_FrameAllocCnt		=	0;
+	cOpenCV_FrameBytesCopied	=	0;
 	width			=	cCameraProp.CameraXsize;
 	height			=	cCameraProp.CameraYsize;
 	GetImage_ROI_info();
@@ -236,99 +244,94 @@ int				imageDataLen;
 	{
 		case kImageType_RAW8:
 		case kImageType_MONO8:
-			CONSOLE_DEBUG("kImageType_RAW8");
-			//	9/20/2022
-			//cOpenCV_ImagePtr	=	new cv::Mat(height, width, CV_8UC3);
-			cOpenCV_ImagePtr	=	new cv::Mat(height, width, CV_8UC1);
-			imageDataLen		=	width * height;
+			openCVtype		=	CV_8UC1;
+			imageDataLen	=	width * height;
 			break;
 
 		case kImageType_RAW16:
-			CONSOLE_DEBUG("kImageType_RAW16");
-			cOpenCV_ImagePtr	=	new cv::Mat(height, width, CV_16UC1);
-			imageDataLen		=	width * height * 2;
+			openCVtype		=	CV_16UC1;
+			imageDataLen	=	width * height * 2;
 			break;
 
-
 		case kImageType_RGB24:
-			CONSOLE_DEBUG("kImageType_RGB24");
-			cOpenCV_ImagePtr	=	new cv::Mat(height, width, CV_8UC3);
-			imageDataLen		=	width * height * 3;
+			openCVtype		=	CV_8UC3;
+			imageDataLen	=	width * height * 3;
 			break;
 
 		case kImageType_Y8:
 		default:
-			cOpenCV_ImagePtr	=	new cv::Mat(height, width, CV_8UC1);
-			imageDataLen		=	width * height;
+			openCVtype		=	CV_8UC1;
+			imageDataLen	=	width * height;
 			break;
 	}
+	wrapBuffer	=	((imageDataPtr != NULL) && (cOverlayMode == 0));
 
-	if (imageDataPtr != NULL)
+	//*	if the format changed, the live display has to be re-created
+	if ((cOpenCV_ImagePtr != NULL) &&
+		((cOpenCV_ImagePtr->cols != width) || (cOpenCV_ImagePtr->rows != height) ||
+		(cOpenCV_ImagePtr->type() != openCVtype)))
 	{
-		if (cOpenCV_ImagePtr != NULL)
-		{
-			//*	what size did openCV make the image
-//			CONSOLE_DEBUG_W_NUM("width \t=",	cOpenCV_ImagePtr->cols);
-//			CONSOLE_DEBUG_W_NUM("height\t=",	cOpenCV_ImagePtr->rows);
-//			CONSOLE_DEBUG_W_LONG("step[0]\t=",	cOpenCV_ImagePtr->step[0]);
-//			CONSOLE_DEBUG_W_LONG("step[1]\t=",	cOpenCV_ImagePtr->step[1]);
-//			CONSOLE_DEBUG_W_LONG("step[2]\t=",	cOpenCV_ImagePtr->step[2]);
-
-			if (cOpenCV_ImagePtr->data != NULL)
-			{
-				memcpy(cOpenCV_ImagePtr->data, imageDataPtr, imageDataLen);
-			}
-			else
-			{
-				CONSOLE_DEBUG_W_NUM("did NOT copy image data into cOpenCV_ImagePtr, imageDataLen\t\t=",	imageDataLen);
-				CONSOLE_ABORT(__FUNCTION__);
-			}
-
-//			CONSOLE_DEBUG_W_LONG("imageDataLen\t\t=",			imageDataLen);
+		ReleaseOpenCVImage();
+	}
+	if (cOpenCV_ImagePtr == NULL)
+	{
+		cOpenCV_ImagePtr	=	new cv::Mat();
+	}
 
-//			if (openCVimageWidth == cOpenCV_ImagePtr->width)
-//			{
-//			//	CONSOLE_DEBUG("Normal image data !!!!!!!!!!!!!!");
-//				memcpy(cOpenCV_ImagePtr->imageData, imageDataPtr, imageDataLen);
-//			}
-//			else
-//			{
-//			char	*ocv_rowPtr;
-//			char	*img_rowPtr;
-//			int		rowLength;
-//
-//				//*	we have to copy over the image a line at a time
-////				CONSOLE_DEBUG("Miss match image data !!!!!!!!!!!!!!");
-//				ocv_rowPtr	=	cOpenCV_ImagePtr->imageData;
-//				img_rowPtr	=	(char *)imageDataPtr;
-//				rowLength	=	cOpenCV_ImagePtr->width * bytesPerPixel;
-//				for (ii=0; ii<cOpenCV_ImagePtr->height; ii++)
-//				{
-//					memcpy(ocv_rowPtr, img_rowPtr, rowLength);
-//
-//					ocv_rowPtr	+=	cOpenCV_ImagePtr->widthStep;
-//					img_rowPtr	+=	rowLength;
-//				}
-//
-//			}
-//			//CONSOLE_DEBUG("Copy SUCCESS!!!!!!!!!!!!!!");
-//			DEBUG_TIMING("Stop point 2 (milliseconds)\t=");
-//
+	if (wrapBuffer)
+	{
+		//*	just the header, the pixels stay in the camera buffer
+		*cOpenCV_ImagePtr			=	cv::Mat(height, width, openCVtype, (void *)imageDataPtr);
+		cOpenCV_ImageWrapsBuffer	=	true;
+	}
+	else
+	{
+		if (cOpenCV_ImageWrapsBuffer || (cOpenCV_ImagePtr->data == NULL))
+		{
+			//*	create() would keep pointing at the camera buffer
+			cOpenCV_ImagePtr->release();
+			cOpenCV_ImagePtr->create(height, width, openCVtype);
+			cOpenCV_ImageWrapsBuffer	=	false;
+			cOpenCV_FrameAllocCnt++;
 		}
-		else
+		if (cOpenCV_ImagePtr->data == NULL)
 		{
 			CONSOLE_DEBUG("Failed to allocate openCV image");
 			CONSOLE_ABORT(__FUNCTION__);
 		}
+		else if (imageDataPtr != NULL)
+		{
+			memcpy(cOpenCV_ImagePtr->data, imageDataPtr, imageDataLen);
+			cOpenCV_FrameBytesCopied	+=	imageDataLen;
+		}
+		else
+		{
+			CONSOLE_DEBUG("Image data is NULL (imageDataPtr)");
+		}
 	}
-	else
+	return(returnCode);
+}
+
+//*****************************************************************************
+//*	using "C++" interface
+//*	deletes the image and the live display, the next CreateOpenCVImage()
+//*	starts over. Has to be called before cCameraDataBuffer is freed.
+//*****************************************************************************
+void	CameraDriver::ReleaseOpenCVImage(void)
+{
+	if (cOpenCV_ImagePtr != NULL)
 	{
-		CONSOLE_DEBUG("Image data is NULL (imageDataPtr)");
-//		CONSOLE_ABORT(__FUNCTION__);
+		delete cOpenCV_ImagePtr;
+		cOpenCV_ImagePtr	=	NULL;
 	}
-//
-	return(returnCode);
+	if (cOpenCV_LiveDisplayPtr != NULL)
+	{
+		delete cOpenCV_LiveDisplayPtr;
+		cOpenCV_LiveDisplayPtr	=	NULL;
+	}
+	cOpenCV_ImageWrapsBuffer	=	false;
 }
+
 //*****************************************************************************
 //*	using "C++" interface
 //*****************************************************************************
@@ -422,6 +425,8 @@ char		imageFilePath[128];
 //*	wget http://192.168.0.201:6800/api/v1.0.0-oas3/camera/0/imagearray
 //*****************************************************************************
 //*	using "C" interface
+//*	same as the C++ version, an image header over cCameraDataBuffer unless
+//*	the overlay is on, and the images are only re-created when the format changes
 //*****************************************************************************
 int	CameraDriver::CreateOpenCVImage(const unsigned char *imageDataPtr)
 {
@@ -433,23 +438,18 @@ int				imageDataLen;
 int				openCVimageWidth;
 int				bytesPerPixel;
 int				bytesPerPixel2;	//*	calculated 2 different ways
+int				imageDepth;
+int				imageChannels;
+bool			wrapBuffer;
 
 	CONSOLE_DEBUG(__FUNCTION__);
 
 	SETUP_TIMING();
 
 	GenerateFileNameRoot();
+	cOpenCV_FrameAllocCnt		=	0;
+	cOpenCV_FrameBytesCopied	=	0;
 
-	if (cOpenCV_ImagePtr != NULL)
-	{
-		cvReleaseImage(&cOpenCV_ImagePtr);
-		cOpenCV_ImagePtr	=	NULL;
-	}
-	if (cOpenCV_LiveDisplayPtr != NULL)
-	{
-		cvReleaseImage(&cOpenCV_LiveDisplayPtr);
-		cOpenCV_LiveDisplayPtr	=	NULL;
-	}
 	width			=	cCameraProp.CameraXsize;
 	height			=	cCameraProp.CameraYsize;
 	GetImage_ROI_info();
@@ -459,38 +459,76 @@ int				bytesPerPixel2;	//*	calculated 2 different ways
 //	CONSOLE_DEBUG_W_NUM("height\t=",	height);
 //	CONSOLE_DEBUG_W_NUM("w * h\t=",		(width * height));
 
+	imageDepth		=	0;
+	imageChannels	=	0;
+	imageDataLen	=	0;
 	switch(cROIinfo.currentROIimageType)
 	{
 		case kImageType_RAW8:
 		//	CONSOLE_DEBUG("kImageType_RAW8");
-			cOpenCV_ImagePtr	=	cvCreateImage(cvSize(width, height), IPL_DEPTH_8U, 1);
-			imageDataLen		=	width * height;
+			imageDepth		=	IPL_DEPTH_8U;
+			imageChannels	=	1;
+			imageDataLen	=	width * height;
 			break;
 
 		case kImageType_RAW16:
 		//	CONSOLE_DEBUG("kImageType_RAW16");
-			cOpenCV_ImagePtr	=	cvCreateImage(cvSize(width, height), IPL_DEPTH_16U, 1);
-			imageDataLen		=	width * height * 2;
+			imageDepth		=	IPL_DEPTH_16U;
+			imageChannels	=	1;
+			imageDataLen	=	width * height * 2;
 			break;
 
 
 		case kImageType_RGB24:
 		//	CONSOLE_DEBUG("kImageType_RGB24");
-			cOpenCV_ImagePtr	=	cvCreateImage(cvSize(width, height), IPL_DEPTH_8U, 3);
-			imageDataLen		=	width * height * 3;
+			imageDepth		=	IPL_DEPTH_8U;
+			imageChannels	=	3;
+			imageDataLen	=	width * height * 3;
 			break;
 
 		case kImageType_Y8:
 		default:
-			cOpenCV_ImagePtr	=	NULL;
 			break;
 
 	}
+	wrapBuffer	=	((imageDataPtr != NULL) && (cOverlayMode == 0));
+
+	//*	keep the existing image if nothing changed
+	if ((cOpenCV_ImagePtr != NULL) &&
+		((cOpenCV_ImagePtr->width != width) || (cOpenCV_ImagePtr->height != height) ||
+		(cOpenCV_ImagePtr->depth != imageDepth) || (cOpenCV_ImagePtr->nChannels != imageChannels) ||
+		(cOpenCV_ImageWrapsBuffer != wrapBuffer)))
+	{
+		ReleaseOpenCVImage();
+	}
+	if ((cOpenCV_ImagePtr == NULL) && (imageDepth != 0))
+	{
+		if (wrapBuffer)
+		{
+			cOpenCV_ImagePtr	=	cvCreateImageHeader(cvSize(width, height), imageDepth, imageChannels);
+		}
+		else
+		{
+			cOpenCV_ImagePtr	=	cvCreateImage(cvSize(width, height), imageDepth, imageChannels);
+		}
+		cOpenCV_ImageWrapsBuffer	=	wrapBuffer;
+		cOpenCV_FrameAllocCnt++;
+	}
 	DEBUG_TIMING("Stop point 1 (milliseconds)\t=");
 
 	if (imageDataPtr != NULL)
 	{
-		if (cOpenCV_ImagePtr != NULL)
+		if (cOpenCV_ImagePtr == NULL)
+		{
+			CONSOLE_DEBUG("Failed to allocate openCV image");
+		}
+		else if (wrapBuffer)
+		{
+			//*	the camera buffer rows are packed, no padding
+			bytesPerPixel	=	(imageDepth / 8) * imageChannels;
+			cvSetData(cOpenCV_ImagePtr, (void *)imageDataPtr, width * bytesPerPixel);
+		}
+		else
 		{
 			//*	what size did openCV make the image
 	//		cvShowImage(cOpenCV_ImgWindowName, cOpenCV_ImagePtr);
@@ -540,13 +578,9 @@ int				bytesPerPixel2;	//*	calculated 2 different ways
 					img_rowPtr	+=	rowLength;
 				}
 			}
-			//CONSOLE_DEBUG("Copy SUCCESS!!!!!!!!!!!!!!");
+			cOpenCV_FrameBytesCopied	+=	imageDataLen;
 			DEBUG_TIMING("Stop point 2 (milliseconds)\t=");
 		}
-		else
-		{
-			CONSOLE_DEBUG("Failed to allocate openCV image");
-		}
 	}
 	else
 	{
@@ -557,6 +591,38 @@ int				bytesPerPixel2;	//*	calculated 2 different ways
 	return(returnCode);
 }
 
+//*****************************************************************************
+//*	using "C" interface
+//*	releases the image and the live display images, the next CreateOpenCVImage()
+//*	starts over. Has to be called before cCameraDataBuffer is freed.
+//*****************************************************************************
+void	CameraDriver::ReleaseOpenCVImage(void)
+{
+	if (cOpenCV_ImagePtr != NULL)
+	{
+		if (cOpenCV_ImageWrapsBuffer)
+		{
+			cvReleaseImageHeader(&cOpenCV_ImagePtr);
+		}
+		else
+		{
+			cvReleaseImage(&cOpenCV_ImagePtr);
+		}
+		cOpenCV_ImagePtr	=	NULL;
+	}
+	if (cOpenCV_LiveDisplayPtr != NULL)
+	{
+		cvReleaseImage(&cOpenCV_LiveDisplayPtr);
+		cOpenCV_LiveDisplayPtr	=	NULL;
+	}
+	if (cOpenCV_LiveSmallPtr != NULL)
+	{
+		cvReleaseImage(&cOpenCV_LiveSmallPtr);
+		cOpenCV_LiveSmallPtr	=	NULL;
+	}
+	cOpenCV_ImageWrapsBuffer	=	false;
+}
+
 //*****************************************************************************
 //*	using "C" interface
 //*****************************************************************************
@@ -727,7 +793,7 @@ int		gainPercent;
 		fprintf(filePointer, "FireCapture v2.6  Settings\r\n");
 		fprintf(filePointer, "------------------------------------\r\n");
 
-		exposureTim_ms	=	(cCameraProp.Lastexposure_duration_us * 1.0) / 1000.0;
+		exposureTim_ms	=	(cFrameExpInfo.duration_us * 1.0) / 1000.0;
 
 		fprintf(filePointer, "Camera=%s\r\n",					cCommonProp.Name);
 //		fprintf(filePointer, "Filter=%s\r\n",					foo);L
@@ -738,15 +804,15 @@ int		gainPercent;
 //		fprintf(filePointer, "Mid=%s\r\n",						foo);134141.422
 //		fprintf(filePointer, "End=%s\r\n",						foo);134156.435
 
-		FormatTimeStringISO8601(&cCameraProp.Lastexposure_StartTime, timeStampString);
+		FormatTimeStringISO8601(&cFrameExpInfo.startTime, timeStampString);
 		fprintf(filePointer, "Start(UT)=%s\r\n",				timeStampString);	//	174126.410
 
 //		fprintf(filePointer, "Mid(UT)=%s\r\n",					foo);174141.422
 
-		FormatTimeStringISO8601(&cCameraProp.Lastexposure_EndTime, timeStampString);
+		FormatTimeStringISO8601(&cFrameExpInfo.endTime, timeStampString);
 		fprintf(filePointer, "End(UT)=%s\r\n",					timeStampString);	//	174156.435
 
-		imageDuration_secs	=	cCameraProp.Lastexposure_EndTime.tv_sec - cCameraProp.Lastexposure_StartTime.tv_sec;
+		imageDuration_secs	=	cFrameExpInfo.endTime.tv_sec - cFrameExpInfo.startTime.tv_sec;
 		fprintf(filePointer, "Duration=%3.3fs\r\n",				imageDuration_secs);	//	30.025s
 
 //		fprintf(filePointer, "Date_format=%s\r\n",				foo);ddMMyy
@@ -827,7 +893,8 @@ int		imuRetCode;
 	cIMU_xxx		=	0.0;
 	cIMU_yyy		=	0.0;
 	cIMU_zzz		=	0.0;
-	imuRetCode		=	IMU_BNO055_Read_Euler(&imuHeading, &imuRoll, &imuPitch);
+	//*	roll, pitch and heading all from the same update of the background average
+	imuRetCode		=	IMU_GetAverageRoll_Pitch_Yaw(&imuRoll, &imuPitch, &imuHeading);
 	if (imuRetCode == 0)
 	{
 		cIMU_EulerValid	=	true;
@@ -5,6 +5,7 @@
 //*	Jul  1,	2023	<MLS> Created common_AlpacaCmds.cpp
 //*	Jul  1,	2023	<MLS> Added gExtrasCmdTable
 //*	Apr 29,	2024	<MLS> Added "setupdialog" command
+//*	Oct 18,	2026	<MLS> Added "timeseries" command
 //*****************************************************************************
 
 
@@ -50,6 +51,7 @@ TYPE_CmdEntry	gCommonCmdTable[]	=
 	{	"details",				kCmd_Common_Details,			kCmdType_GET	},
 	{	"livewindow",			kCmd_Common_LiveWindow,			kCmdType_PUT	},
 	{	"temperaturelog",		kCmd_Common_TemperatureLog,		kCmdType_GET	},
+	{	"timeseries",			kCmd_Common_TimeSeries,			kCmdType_GET	},
 	{	"restart",				kCmd_Common_Restart,			kCmdType_PUT	},
 
 #ifdef _INCLUDE_EXIT_COMMAND_
@@ -1,5 +1,6 @@
 //*****************************************************************************
 //*	Jun 26,	2023	<MLS> Created common_AlpacaCmds.h
+//*	Oct 18,	2026	<MLS> Added kCmd_Common_TimeSeries
 //*****************************************************************************
 //#include	"common_AlpacaCmds.h"
 
@@ -43,6 +44,7 @@ enum
 	kCmd_Common_Details,
 	kCmd_Common_LiveWindow,
 	kCmd_Common_TemperatureLog,
+	kCmd_Common_TimeSeries,
 	kCmd_Common_Restart,			//*	cause the driver to be destroyed and re-created
 
 	kCmd_Common_last
@@ -26,6 +26,11 @@
 //*	May 18,	2022	<MLS> Added AlpacaGetImageArray_Binary_Int32()
 //*	Feb 19,	2023	<MLS> Added AlpacaGetImageArray_Binary_Int16()
 //*	Feb 19,	2023	<MLS> Changed byte order in 32 bit integer image read
+//*	Oct 18,	2026	<MLS> Added AlpacaGetImageBytes(), buffered ImageBytes download engine
+//*	Oct 18,	2026	<MLS> Added parallel ranged requests when server sends "Accept-Ranges: bytes"
+//*	Oct 18,	2026	<MLS> Added DecodeImageBytes(), decodes straight into the cv::Mat
+//*	Oct 18,	2026	<MLS> DecodeImageBytes() picks the cv::Mat depth from ImageElementType
+//*	Oct 18,	2026	<MLS> Added DownloadImage_Benchmark() (_ENABLE_DOWNLOAD_BENCHMARK_)
 //*****************************************************************************
 
 #include	<string.h>
@@ -34,6 +39,8 @@
 #include	<unistd.h>
 #include	<sys/time.h>
 #include	<errno.h>
+#include	<pthread.h>
+#include	<sys/socket.h>
 
 
 
@@ -154,6 +161,41 @@ char	*argumentPtr;
 			strcpy(httpHdrStruct->ContentLengthStr, argumentPtr);
 			httpHdrStruct->contentLength	=	atoi(argumentPtr);
 		}
+		else if (strncasecmp(httpHeaderLine,	"HTTP/", 5) == 0)
+		{
+			//*	HTTP/1.0 206 Partial Content
+			argumentPtr	=	strchr(httpHeaderLine, 0x20);
+			if (argumentPtr != NULL)
+			{
+				httpHdrStruct->httpStatusCode	=	atoi(argumentPtr);
+			}
+		}
+		else if (strncasecmp(httpHeaderLine,	"Accept-Ranges:", 14) == 0)
+		{
+			if (strncasecmp(argumentPtr, "bytes", 5) == 0)
+			{
+				httpHdrStruct->acceptRanges	=	true;
+			}
+		}
+		else if (strncasecmp(httpHeaderLine,	"Content-Range:", 14) == 0)
+		{
+			//*	Content-Range: bytes 0-1048575/24883244
+			if (strncasecmp(argumentPtr, "bytes", 5) == 0)
+			{
+				argumentPtr	+=	5;
+			}
+			httpHdrStruct->contentRangeStart	=	atoi(argumentPtr);
+			argumentPtr	=	strchr(argumentPtr, '/');
+			if (argumentPtr != NULL)
+			{
+				httpHdrStruct->contentRangeTotal	=	atoi(argumentPtr + 1);
+			}
+		}
+		else if (strncasecmp(httpHeaderLine,	"ETag:", 5) == 0)
+		{
+			strncpy(httpHdrStruct->ETagStr, argumentPtr, (sizeof(httpHdrStruct->ETagStr) - 1));
+			httpHdrStruct->ETagStr[sizeof(httpHdrStruct->ETagStr) - 1]	=	0;
+		}
 	}
 	else
 	{
@@ -1309,3 +1351,692 @@ int				ccc;
 	}
 	return(imgRank);
 }
+
+#pragma mark -
+//*****************************************************************************
+//*	ImageBytes download engine
+//*
+//*	The stream parsers above work on kReadBuffLen (5000) byte reads and move the data
+//*	through a TYPE_ImageArray (12 bytes per pixel) before it ever gets to the cv::Mat.
+//*	This engine reads the entire ImageBytes payload into one buffer using large reads
+//*	and then decodes it directly into the display image.
+//*
+//*	If the server advertises "Accept-Ranges: bytes" the payload is split into several
+//*	ranged requests that are read in parallel on separate sockets.
+//*	The first request is always a ranged request, servers that do not support ranges
+//*	simply ignore the Range: header and send the entire image (200 instead of 206)
+//*****************************************************************************
+#define	kImageBytesReadSize		(256 * 1024)
+#define	kImageBytesFirstChunk	(1024 * 1024)
+#define	kImageBytesMinChunk		(1024 * 1024)
+#define	kImageBytesMaxThreads	4
+
+//*****************************************************************************
+typedef struct
+{
+	struct sockaddr_in	deviceAddress;
+	int					port;
+	char				alpacaString[128];
+	char				ETagStr[64];
+	unsigned char		*imageBytes;		//*	start of the entire image buffer
+	int					startByte;
+	int					endByte;			//*	inclusive, same as the HTTP Range header
+	volatile int		bytesRead;
+	volatile bool		chunkDone;
+	bool				chunkOK;
+	pthread_t			threadID;
+} TYPE_ImageChunk;
+
+//*****************************************************************************
+//*	reads the HTTP header using large reads
+//*	any data past the header is left in readBuffer starting at *dataStart
+//*	returns the number of bytes in readBuffer, -1 on error
+//*****************************************************************************
+static int	RecvHTTPresponseHeader(	int				socketDesc,
+									TYPE_HTTPheader	*httpHdr,
+									char			*readBuffer,
+									int				readBufferSize,
+									int				*dataStart)
+{
+int		bytesInBuffer;
+int		recvByteCnt;
+char	*endOfHeader;
+char	*linePtr;
+char	*eolPtr;
+
+	memset(httpHdr, 0, sizeof(TYPE_HTTPheader));
+	bytesInBuffer	=	0;
+	endOfHeader		=	NULL;
+	while ((endOfHeader == NULL) && (bytesInBuffer < (readBufferSize - 1)))
+	{
+		recvByteCnt	=	recv(socketDesc, &readBuffer[bytesInBuffer], (readBufferSize - 1 - bytesInBuffer), 0);
+		if (recvByteCnt <= 0)
+		{
+			return(-1);
+		}
+		bytesInBuffer				+=	recvByteCnt;
+		readBuffer[bytesInBuffer]	=	0;
+		//*	the binary data may contain nulls, but the header cannot
+		endOfHeader	=	strstr(readBuffer, "\r\n\r\n");
+	}
+	if (endOfHeader == NULL)
+	{
+		CONSOLE_DEBUG("HTTP header not found");
+		return(-1);
+	}
+	*endOfHeader	=	0;
+	*dataStart		=	(endOfHeader - readBuffer) + 4;
+
+	//*	now process the header one line at a time
+	linePtr	=	readBuffer;
+	while (linePtr != NULL)
+	{
+		eolPtr	=	strstr(linePtr, "\r\n");
+		if (eolPtr != NULL)
+		{
+			*eolPtr	=	0;
+		}
+		if (strlen(linePtr) > 0)
+		{
+			ProcessHTTPheaderLine(linePtr, httpHdr);
+		}
+		linePtr	=	(eolPtr != NULL) ? (eolPtr + 2) : NULL;
+	}
+	return(bytesInBuffer);
+}
+
+//*****************************************************************************
+//*	reads directly into the image buffer until the byte range is complete
+//*****************************************************************************
+static int	RecvIntoBuffer(int socketDesc, unsigned char *destPtr, int byteCount, volatile int *bytesRead)
+{
+int		recvByteCnt;
+int		readSize;
+int		readCnt;
+
+	readCnt	=	0;
+	while (*bytesRead < byteCount)
+	{
+		readSize	=	byteCount - *bytesRead;
+		if (readSize > kImageBytesReadSize)
+		{
+			readSize	=	kImageBytesReadSize;
+		}
+		recvByteCnt	=	recv(socketDesc, &destPtr[*bytesRead], readSize, 0);
+		if (recvByteCnt <= 0)
+		{
+			break;
+		}
+		*bytesRead	+=	recvByteCnt;
+		readCnt++;
+	}
+	return(readCnt);
+}
+
+//*****************************************************************************
+static void	CloseImageSocket(int socketDesc)
+{
+	shutdown(socketDesc, SHUT_RDWR);
+	if (close(socketDesc) != 0)
+	{
+		CONSOLE_DEBUG("Close error");
+	}
+}
+
+//*****************************************************************************
+static void	*ImageBytesChunkThread(void *arg)
+{
+TYPE_ImageChunk	*chunk;
+TYPE_HTTPheader	httpHdr;
+int				socketDesc;
+char			headerLines[256];
+char			lineBuff[128];
+char			*readBuffer;
+int				bytesInBuffer;
+int				dataStart;
+int				chunkLen;
+int				leftOver;
+
+	chunk			=	(TYPE_ImageChunk *)arg;
+	chunk->chunkOK	=	false;
+	chunkLen		=	chunk->endByte - chunk->startByte + 1;
+
+	sprintf(headerLines, "Range: bytes=%d-%d\r\n", chunk->startByte, chunk->endByte);
+	if (strlen(chunk->ETagStr) > 0)
+	{
+		//*	make sure we are still getting pieces of the same frame
+		sprintf(lineBuff, "If-Range: %s\r\n", chunk->ETagStr);
+		strcat(headerLines, lineBuff);
+	}
+	readBuffer	=	(char *)malloc(kReadBuffLen + 10);
+	if (readBuffer != NULL)
+	{
+		socketDesc	=	OpenSocketAndSendRequest_Hdr(	&chunk->deviceAddress,
+														chunk->port,
+														"GET",
+														chunk->alpacaString,
+														"",
+														READ_BINARY_IMAGE,
+														headerLines);
+		if (socketDesc >= 0)
+		{
+			bytesInBuffer	=	RecvHTTPresponseHeader(socketDesc, &httpHdr, readBuffer, kReadBuffLen, &dataStart);
+			if ((bytesInBuffer > 0) &&
+				(httpHdr.httpStatusCode == 206) &&
+				(httpHdr.contentRangeStart == chunk->startByte))
+			{
+				leftOver	=	bytesInBuffer - dataStart;
+				if (leftOver > chunkLen)
+				{
+					leftOver	=	chunkLen;
+				}
+				memcpy(&chunk->imageBytes[chunk->startByte], &readBuffer[dataStart], leftOver);
+				chunk->bytesRead	=	leftOver;
+				RecvIntoBuffer(socketDesc, &chunk->imageBytes[chunk->startByte], chunkLen, &chunk->bytesRead);
+				chunk->chunkOK	=	(chunk->bytesRead == chunkLen);
+			}
+			else
+			{
+				//*	a 200 here means the frame changed (If-Range did not match)
+				CONSOLE_DEBUG_W_NUM("Ranged request refused, status\t=", httpHdr.httpStatusCode);
+			}
+			CloseImageSocket(socketDesc);
+		}
+		free(readBuffer);
+	}
+	chunk->chunkDone	=	true;
+	return(NULL);
+}
+
+//*****************************************************************************
+//*	Downloads the entire ImageBytes payload (including the 44 byte binary header)
+//*	into a single malloc'd buffer, caller must free *imageBytesPtr
+//*
+//*	returns false if the server does not send ImageBytes, the caller should
+//*	then fall back to AlpacaGetImageArray()
+//*****************************************************************************
+bool	ControllerCamera::AlpacaGetImageBytes(	const char		*alpacaDevice,
+												const int		alpacaDevNum,
+												const char		*alpacaCmd,
+												unsigned char	**imageBytesPtr,
+												int				*imageBytesLen)
+{
+bool			validData;
+char			alpacaString[128];
+char			headerLines[64];
+char			readBuffer[kReadBuffLen + 10];
+int				bytesInBuffer;
+int				dataStart;
+int				leftOver;
+int				totalBytes;
+int				firstChunkLen;
+volatile int	firstBytesRead;
+unsigned char	*imageBytes;
+TYPE_ImageChunk	chunkList[kImageBytesMaxThreads];
+int				chunkCnt;
+int				chunkSize;
+int				nextStart;
+int				bytesReceived;
+int				threadErr;
+int				iii;
+bool			chunksOK;
+bool			allChunksDone;
+double			downLoadSeconds;
+
+	CONSOLE_DEBUG(__FUNCTION__);
+
+	validData			=	false;
+	imageBytes			=	NULL;
+	*imageBytesPtr		=	NULL;
+	*imageBytesLen		=	0;
+	cDownloadChunkCnt	=	0;
+	cSocketReadCnt		=	0;
+	cTotalBytesRead		=	0;
+	cImageArrayIndex	=	0;
+	tStartMillisecs			=	millis();
+	tLastUpdateMillisecs	=	tStartMillisecs;
+
+	sprintf(alpacaString,	"/api/v1/%s/%d/%s", alpacaDevice, alpacaDevNum, alpacaCmd);
+	strcpy(cLastAlpacaCmdString, alpacaString);
+
+	SETUP_TIMING();
+	START_TIMING();
+	sprintf(headerLines, "Range: bytes=0-%d\r\n", (kImageBytesFirstChunk - 1));
+	cSocket_desc	=	OpenSocketAndSendRequest_Hdr(	&cDeviceAddress,
+														cPort,
+														"GET",
+														alpacaString,
+														"",
+														READ_BINARY_IMAGE,
+														headerLines);
+	if (cSocket_desc < 0)
+	{
+		CONSOLE_DEBUG("Failed");
+		cReadFailureCnt++;
+		return(false);
+	}
+	bytesInBuffer	=	RecvHTTPresponseHeader(cSocket_desc, &cHttpHdrStruct, readBuffer, kReadBuffLen, &dataStart);
+	if ((bytesInBuffer <= 0) || (cHttpHdrStruct.dataIsBinary == false))
+	{
+		//*	JSON or no response, let the stream parser deal with it
+		CONSOLE_DEBUG("Response is not imagebytes");
+		CloseImageSocket(cSocket_desc);
+		return(false);
+	}
+	leftOver	=	bytesInBuffer - dataStart;
+
+	//*	206 means the server honored the range, otherwise we are getting the whole thing
+	if ((cHttpHdrStruct.httpStatusCode == 206) && (cHttpHdrStruct.contentRangeTotal > 0))
+	{
+		totalBytes		=	cHttpHdrStruct.contentRangeTotal;
+		firstChunkLen	=	cHttpHdrStruct.contentLength;
+	}
+	else
+	{
+		totalBytes		=	cHttpHdrStruct.contentLength;
+		firstChunkLen	=	totalBytes;
+	}
+	CONSOLE_DEBUG_W_NUM("httpStatusCode\t=",	cHttpHdrStruct.httpStatusCode);
+	CONSOLE_DEBUG_W_NUM("totalBytes    \t=",	totalBytes);
+	if ((totalBytes <= (int)sizeof(TYPE_BinaryImageHdr)) || (firstChunkLen <= 0) || (firstChunkLen > totalBytes))
+	{
+		CONSOLE_DEBUG("Content-Length missing or invalid");
+		CloseImageSocket(cSocket_desc);
+		return(false);
+	}
+
+	imageBytes	=	(unsigned char *)malloc(totalBytes + 16);
+	if (imageBytes == NULL)
+	{
+		CONSOLE_DEBUG_W_NUM("Failed to allocate image buffer, totalBytes\t=", totalBytes);
+		CloseImageSocket(cSocket_desc);
+		return(false);
+	}
+
+	//*	set up the remaining ranges before reading the first one so they all run together
+	chunkCnt	=	0;
+	nextStart	=	firstChunkLen;
+	if ((firstChunkLen < totalBytes) && cHttpHdrStruct.acceptRanges)
+	{
+		chunkCnt	=	(totalBytes - firstChunkLen) / kImageBytesMinChunk;
+		if (chunkCnt < 1)
+		{
+			chunkCnt	=	1;
+		}
+		if (chunkCnt > kImageBytesMaxThreads)
+		{
+			chunkCnt	=	kImageBytesMaxThreads;
+		}
+		chunkSize	=	(totalBytes - firstChunkLen + chunkCnt - 1) / chunkCnt;
+		for (iii=0; iii<chunkCnt; iii++)
+		{
+			memset(&chunkList[iii], 0, sizeof(TYPE_ImageChunk));
+			chunkList[iii].deviceAddress	=	cDeviceAddress;
+			chunkList[iii].port				=	cPort;
+			chunkList[iii].imageBytes		=	imageBytes;
+			chunkList[iii].startByte		=	nextStart;
+			chunkList[iii].endByte			=	nextStart + chunkSize - 1;
+			if (chunkList[iii].endByte >= totalBytes)
+			{
+				chunkList[iii].endByte	=	totalBytes - 1;
+			}
+			strcpy(chunkList[iii].alpacaString,	alpacaString);
+			strcpy(chunkList[iii].ETagStr,		cHttpHdrStruct.ETagStr);
+
+			threadErr	=	pthread_create(	&chunkList[iii].threadID,
+											NULL,
+											&ImageBytesChunkThread,
+											&chunkList[iii]);
+			if (threadErr != 0)
+			{
+				CONSOLE_DEBUG_W_NUM("pthread_create() failed, errno\t=", threadErr);
+				break;
+			}
+			nextStart	=	chunkList[iii].endByte + 1;
+		}
+		chunkCnt	=	iii;
+	}
+	cDownloadChunkCnt	=	chunkCnt + 1;
+	CONSOLE_DEBUG_W_NUM("cDownloadChunkCnt\t=", cDownloadChunkCnt);
+
+	//*	now read the first (or only) part on this thread
+	if (leftOver > firstChunkLen)
+	{
+		leftOver	=	firstChunkLen;
+	}
+	memcpy(imageBytes, &readBuffer[dataStart], leftOver);
+	firstBytesRead	=	leftOver;
+	while (firstBytesRead < firstChunkLen)
+	{
+		//*	read in pieces so the progress bar keeps moving
+		iii	=	firstBytesRead + kImageBytesMinChunk;
+		if (iii > firstChunkLen)
+		{
+			iii	=	firstChunkLen;
+		}
+		cSocketReadCnt	+=	RecvIntoBuffer(cSocket_desc, imageBytes, iii, &firstBytesRead);
+		if (firstBytesRead < iii)
+		{
+			break;
+		}
+		cImageArrayIndex	=	firstBytesRead;
+		UpdateImageProgressBar(totalBytes);
+	}
+	CloseImageSocket(cSocket_desc);
+
+	//*	wait for the other parts, updating the progress bar from this thread only
+	allChunksDone	=	false;
+	while ((chunkCnt > 0) && (allChunksDone == false))
+	{
+		bytesReceived	=	firstBytesRead;
+		allChunksDone	=	true;
+		for (iii=0; iii<chunkCnt; iii++)
+		{
+			bytesReceived	+=	chunkList[iii].bytesRead;
+			if (chunkList[iii].chunkDone == false)
+			{
+				allChunksDone	=	false;
+			}
+		}
+		cImageArrayIndex	=	bytesReceived;
+		UpdateImageProgressBar(totalBytes);
+		if (allChunksDone == false)
+		{
+			usleep(20000);
+		}
+	}
+	chunksOK		=	true;
+	bytesReceived	=	firstBytesRead;
+	for (iii=0; iii<chunkCnt; iii++)
+	{
+		pthread_join(chunkList[iii].threadID, NULL);
+		bytesReceived	+=	chunkList[iii].bytesRead;
+		if (chunkList[iii].chunkOK == false)
+		{
+			chunksOK	=	false;
+		}
+	}
+	cTotalBytesRead		=	bytesReceived;
+	cImageArrayIndex	=	bytesReceived;
+
+	if ((firstBytesRead == firstChunkLen) && chunksOK && (nextStart == totalBytes))
+	{
+		validData		=	true;
+		*imageBytesPtr	=	imageBytes;
+		*imageBytesLen	=	totalBytes;
+	}
+	else
+	{
+		CONSOLE_DEBUG_W_NUM("Incomplete image, bytes received\t=", bytesReceived);
+		free(imageBytes);
+		cReadFailureCnt++;
+	}
+	//*	one last time to show we are done
+	UpdateDownloadProgress(cImageArrayIndex, totalBytes);
+	DEBUG_TIMING("Time to download imagebytes (ms)");
+
+	tDeltaMillisecs					=	millis() - tStartMillisecs;
+	cLastDownload_Bytes				=	cTotalBytesRead;
+	cLastDownload_Millisecs			=	tDeltaMillisecs;
+	downLoadSeconds					=	tDeltaMillisecs / 1000.0;
+	cLastDownload_MegaBytesPerSec	=	0.0;
+	if (downLoadSeconds > 0)
+	{
+		cLastDownload_MegaBytesPerSec	=	1.0 * cTotalBytesRead / downLoadSeconds;
+	}
+	CONSOLE_DEBUG_W_NUM("cTotalBytesRead  \t=",	cTotalBytesRead);
+	CONSOLE_DEBUG_W_NUM("cSocketReadCnt   \t=",	cSocketReadCnt);
+	return(validData);
+}
+
+#if defined(_USE_OPENCV_CPP_) || (CV_MAJOR_VERSION >= 4)
+//*****************************************************************************
+//*	Int32 elements hold ADU values (the same as imagearray), not 32 bit data,
+//*	anything over 16 bits is clipped
+//*****************************************************************************
+static inline int	GetImageBytesValue16(	const unsigned char	*dataPtr,
+											const int			transmissionType)
+{
+uint32_t	value32;
+int			value16;
+
+	switch(transmissionType)
+	{
+		case kAlpacaImageData_Byte:
+			value16	=	dataPtr[0] << 8;
+			break;
+
+		case kAlpacaImageData_Int16:
+		case kAlpacaImageData_UInt16:
+			value16	=	dataPtr[0] + (dataPtr[1] << 8);
+			break;
+
+		case kAlpacaImageData_Int32:
+			//*	ImageBytes is always little endian
+			value32	=	dataPtr[0] + (dataPtr[1] << 8) + (dataPtr[2] << 16) + ((uint32_t)dataPtr[3] << 24);
+			if (value32 > 0x00ffff)
+			{
+				value32	=	0x00ffff;
+			}
+			value16	=	value32;
+			break;
+
+		default:
+			value16	=	0;
+			break;
+	}
+	return(value16);
+}
+
+//*****************************************************************************
+//*	decodes the ImageBytes payload directly into a new cv::Mat
+//*	the data is in column order (x outer, y inner, color plane innermost)
+//*	The cv::Mat depth comes from ImageElementType (what the camera produced), not from
+//*	the transmission size. Monochrome 16 bit (Int16, UInt16 or Int32 elements) goes
+//*	into a CV_16UC1, everything else into a CV_8UC3 (BGR)
+//*****************************************************************************
+cv::Mat	*ControllerCamera::DecodeImageBytes(	const unsigned char	*imageBytes,
+												const int			imageBytesLen,
+												const bool			force8BitRead)
+{
+cv::Mat				*myOpenCVimage	=	NULL;
+int					bytesPerElement;
+int					planeCnt;
+int					imgWidth;
+int					imgHeight;
+int					xxx;
+int					yyy;
+int					ppp;
+int					value16;
+int					rgbValue[3];
+int					imageWidthStep;
+const unsigned char	*dataPtr;
+unsigned char		*pixelPtr;
+int					transmissionType;
+int					imageElementType;
+
+	CONSOLE_DEBUG(__FUNCTION__);
+	memcpy(&cBinaryImageHdr, imageBytes, sizeof(TYPE_BinaryImageHdr));
+	cImgArrayType		=	cBinaryImageHdr.TransmissionElementType;
+	transmissionType	=	cBinaryImageHdr.TransmissionElementType;
+	imageElementType	=	cBinaryImageHdr.ImageElementType;
+	imgWidth			=	cBinaryImageHdr.Dimension1;
+	imgHeight			=	cBinaryImageHdr.Dimension2;
+	planeCnt			=	(cBinaryImageHdr.Rank == 3) ? 3 : 1;
+
+	switch(transmissionType)
+	{
+		case kAlpacaImageData_Byte:		bytesPerElement	=	1;	break;
+		case kAlpacaImageData_Int16:
+		case kAlpacaImageData_UInt16:	bytesPerElement	=	2;	break;
+		case kAlpacaImageData_Int32:	bytesPerElement	=	4;	break;
+		default:						bytesPerElement	=	0;	break;
+	}
+
+	//*	make sure the header makes sense before we trust it
+	if ((cBinaryImageHdr.ErrorNumber != 0) ||
+		(bytesPerElement == 0) ||
+		(imgWidth <= 0) || (imgHeight <= 0) ||
+		((cBinaryImageHdr.Rank != 2) && (cBinaryImageHdr.Rank != 3)) ||
+		((cBinaryImageHdr.Rank == 3) && (cBinaryImageHdr.Dimension3 != 3)) ||
+		(cBinaryImageHdr.DataStart < (int)sizeof(TYPE_BinaryImageHdr)) ||
+		((cBinaryImageHdr.DataStart + (1LL * imgWidth * imgHeight * planeCnt * bytesPerElement)) > imageBytesLen))
+	{
+		CONSOLE_DEBUG_W_NUM("ErrorNumber            \t=",	cBinaryImageHdr.ErrorNumber);
+		CONSOLE_DEBUG_W_NUM("TransmissionElementType\t=",	transmissionType);
+		CONSOLE_DEBUG_W_NUM("Rank                   \t=",	cBinaryImageHdr.Rank);
+		CONSOLE_DEBUG_W_NUM("imageBytesLen          \t=",	imageBytesLen);
+		CONSOLE_DEBUG("Invalid imagebytes header");
+		return(NULL);
+	}
+
+	SETUP_TIMING();
+	START_TIMING();
+	dataPtr	=	&imageBytes[cBinaryImageHdr.DataStart];
+	if ((planeCnt == 1) &&	((imageElementType == kAlpacaImageData_Int16) ||
+							(imageElementType == kAlpacaImageData_UInt16) ||
+							(imageElementType == kAlpacaImageData_Int32)))
+	{
+		myOpenCVimage	=	new cv::Mat(imgHeight, imgWidth, CV_16UC1);		//*	Note, Height is FIRST
+		imageWidthStep	=	myOpenCVimage->step[0];
+		for (xxx=0; xxx<imgWidth; xxx++)
+		{
+			//*	stepping DOWN the column
+			pixelPtr	=	myOpenCVimage->data + (xxx * 2);
+			for (yyy=0; yyy<imgHeight; yyy++)
+			{
+				if (transmissionType == kAlpacaImageData_UInt16)
+				{
+					//*	ImageBytes and the cv::Mat are both little endian
+					pixelPtr[0]	=	dataPtr[0];
+					pixelPtr[1]	=	dataPtr[1];
+				}
+				else
+				{
+					*((uint16_t *)pixelPtr)	=	GetImageBytesValue16(dataPtr, transmissionType);
+				}
+				dataPtr		+=	bytesPerElement;
+				pixelPtr	+=	imageWidthStep;
+			}
+		}
+	}
+	else
+	{
+		myOpenCVimage	=	new cv::Mat(imgHeight, imgWidth, CV_8UC3);
+		imageWidthStep	=	myOpenCVimage->step[0];
+		for (xxx=0; xxx<imgWidth; xxx++)
+		{
+			pixelPtr	=	myOpenCVimage->data + (xxx * 3);
+			for (yyy=0; yyy<imgHeight; yyy++)
+			{
+				for (ppp=0; ppp<planeCnt; ppp++)
+				{
+					value16	=	GetImageBytesValue16(dataPtr, transmissionType);
+					if (force8BitRead && (transmissionType != kAlpacaImageData_Byte))
+					{
+						rgbValue[ppp]	=	value16 & 0x00ff;
+					}
+					else
+					{
+						rgbValue[ppp]	=	(value16 >> 8) & 0x00ff;
+					}
+					dataPtr	+=	bytesPerElement;
+				}
+				if (planeCnt == 1)
+				{
+					rgbValue[1]	=	rgbValue[0];
+					rgbValue[2]	=	rgbValue[0];
+				}
+				//*	openCV uses BGR instead of RGB
+				pixelPtr[0]	=	rgbValue[2];
+				pixelPtr[1]	=	rgbValue[1];
+				pixelPtr[2]	=	rgbValue[0];
+				pixelPtr	+=	imageWidthStep;
+			}
+		}
+	}
+	DEBUG_TIMING("Image decoding (ms)");
+	cImageArrayIndex	=	imgWidth * imgHeight;
+	return(myOpenCVimage);
+}
+
+//*****************************************************************************
+//*	returns NULL if the imagebytes download failed,
+//*	the caller should then fall back to the JSON/stream path
+//*****************************************************************************
+cv::Mat	*ControllerCamera::DownloadImage_ImageBytes(const bool force8BitRead)
+{
+cv::Mat			*myOpenCVimage	=	NULL;
+unsigned char	*imageBytes;
+int				imageBytesLen;
+bool			validData;
+
+	CONSOLE_DEBUG(__FUNCTION__);
+	validData	=	AlpacaGetImageBytes(	"camera",
+											cAlpacaDevNum,
+											"imagearray",
+											&imageBytes,
+											&imageBytesLen);
+	if (validData && (imageBytes != NULL))
+	{
+		myOpenCVimage	=	DecodeImageBytes(imageBytes, imageBytesLen, force8BitRead);
+		free(imageBytes);
+	}
+	return(myOpenCVimage);
+}
+
+#ifdef _ENABLE_DOWNLOAD_BENCHMARK_
+//*****************************************************************************
+//*	compares the ImageBytes engine with the original stream parser
+//*	run this against a server on the loopback address to take the network out of it
+//*****************************************************************************
+void	ControllerCamera::DownloadImage_Benchmark(const int passCount)
+{
+cv::Mat		*myOpenCVimage;
+int			passNum;
+uint32_t	startMillisecs;
+uint32_t	engineMillisecs;
+uint32_t	streamMillisecs;
+double		engineMBperSec;
+double		streamMBperSec;
+
+	CONSOLE_DEBUG(__FUNCTION__);
+	engineMillisecs	=	0;
+	streamMillisecs	=	0;
+	engineMBperSec	=	0.0;
+	streamMBperSec	=	0.0;
+	for (passNum=0; passNum < passCount; passNum++)
+	{
+		startMillisecs	=	millis();
+		myOpenCVimage	=	DownloadImage_ImageBytes(false);
+		engineMillisecs	+=	millis() - startMillisecs;
+		engineMBperSec	+=	cLastDownload_MegaBytesPerSec / 1000000.0;
+		if (myOpenCVimage != NULL)
+		{
+			delete myOpenCVimage;
+		}
+
+		//*	DownloadImage_imagearray() tries the engine first, turn it off for the stream parser
+		cUseImageBytesEngine	=	false;
+		startMillisecs			=	millis();
+		myOpenCVimage			=	DownloadImage_imagearray(false, true);
+		streamMillisecs			+=	millis() - startMillisecs;
+		cUseImageBytesEngine	=	true;
+		streamMBperSec	+=	cLastDownload_MegaBytesPerSec / 1000000.0;
+		if (myOpenCVimage != NULL)
+		{
+			delete myOpenCVimage;
+		}
+	}
+	if (passCount > 0)
+	{
+		printf("Download benchmark, %d passes\r\n", passCount);
+		printf("ImageBytes engine  \t%6d ms\t%8.2f MB/sec\tranges=%d\r\n",	(engineMillisecs / passCount),
+																			(engineMBperSec / passCount),
+																			cDownloadChunkCnt);
+		printf("Stream parser      \t%6d ms\t%8.2f MB/sec\r\n",				(streamMillisecs / passCount),
+																			(streamMBperSec / passCount));
+	}
+}
+#endif // _ENABLE_DOWNLOAD_BENCHMARK_
+#endif // defined(_USE_OPENCV_CPP_) || (CV_MAJOR_VERSION >= 4)
@@ -73,6 +73,7 @@
 //*	Jun 25,	2023	<ADD> Add readoutmode to DeviceState
 //*	Jun 25,	2023	<ADD> Add startx and starty to DeviceState
 //*	Jul  1,	2023	<MLS> Added GetStatus_SubClass() to camera controller
+//*	Oct 18,	2026	<MLS> DownloadImage_imagearray() now tries the ImageBytes engine first
 //*****************************************************************************
 //*	Jan  1,	2121	<TODO> control key for different step size.
 //*	Jan  1,	2121	<TODO> add error list window
@@ -156,6 +157,8 @@ int		iii;
 	cProgressReDraws		=	0;
 
 	cReadData8Bit			=	false;
+	cUseImageBytesEngine	=	true;
+	cDownloadChunkCnt		=	0;
 
 	//*	clear list of readout modes
 	for (iii=0; iii<kMaxReadOutModes; iii++)
@@ -2006,6 +2009,17 @@ int				imageWidthStep;
 	CONSOLE_DEBUG_W_BOOL(	"force8BitRead          \t=",	force8BitRead);
 	CONSOLE_DEBUG_W_BOOL(	"allowBinary            \t=",	allowBinary);
 
+	//*	the ImageBytes engine decodes straight into the cv::Mat,
+	//*	if the server does not send imagebytes, fall through to the stream parser
+	if (allowBinary && cUseImageBytesEngine)
+	{
+		myOpenCVimage	=	DownloadImage_ImageBytes(force8BitRead);
+		if (myOpenCVimage != NULL)
+		{
+			return(myOpenCVimage);
+		}
+	}
+
 	//*	set up default values for the binary image header in case we use JSON
 	memset((void *)&cBinaryImageHdr, 0, sizeof(TYPE_BinaryImageHdr));
 	cBinaryImageHdr.MetadataVersion			=	-1;
@@ -45,6 +45,11 @@ typedef struct
 	bool	dataIsBinary;
 	bool	dataIsJson;
 	int		contentLength;
+	int		httpStatusCode;		//*	200, 206 etc
+	bool	acceptRanges;		//*	server advertised "Accept-Ranges: bytes"
+	int		contentRangeStart;	//*	from "Content-Range: bytes start-end/total"
+	int		contentRangeTotal;
+	char	ETagStr[64];
 
 } TYPE_HTTPheader;
 
@@ -251,6 +256,26 @@ class ControllerCamera: public Controller
 
 				void	UpdateImageProgressBar(int maxArrayLength);
 
+				//==========================================================
+				//*	ImageBytes download engine, large buffered reads,
+				//*	optionally split into parallel ranged requests
+				bool	AlpacaGetImageBytes(	const char		*alpacaDevice,
+												const int		alpacaDevNum,
+												const char		*alpacaCmd,
+												unsigned char	**imageBytesPtr,
+												int				*imageBytesLen);
+			#if defined(_USE_OPENCV_CPP_) || (CV_MAJOR_VERSION >= 4)
+				cv::Mat	*DecodeImageBytes(		const unsigned char	*imageBytes,
+												const int			imageBytesLen,
+												const bool			force8BitRead);
+				cv::Mat	*DownloadImage_ImageBytes(const bool force8BitRead);
+			#ifdef _ENABLE_DOWNLOAD_BENCHMARK_
+				void	DownloadImage_Benchmark(const int passCount);
+			#endif
+			#endif
+				bool					cUseImageBytesEngine;
+				int						cDownloadChunkCnt;		//*	number of ranged requests used on the last download
+
 				//*	these variables are ONLY for image download
 				TYPE_HTTPheader 		cHttpHdrStruct;
 				TYPE_BinaryImageHdr		cBinaryImageHdr;
@@ -0,0 +1,187 @@
+//*****************************************************************************
+//*	Name:			devicestate_snapshot.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Versioned, lock free registry of device state snapshots
+//*
+//*	A driver publishes an immutable record of its state after each state machine pass.
+//*	Other drivers (i.e. the camera writing FITS headers) read a consistent copy of
+//*	that record instead of reaching into the live members of the other driver.
+//*
+//*	Only the drivers the camera needs publish: focuser, rotator, filter wheel and
+//*	telescope. The camera (FITS header and file name) is the only reader of the
+//*	device state. Readall, the management driver and the web pages still read the
+//*	live members of their own driver, readall only adds snapshot-version/age.
+//*
+//*	There is only one writer per slot (the main loop), readers use a sequence count.
+//*	The sequence count is odd while the record is being written, if it changes
+//*	while the reader is copying the record, the reader tries again.
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Re-distributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 18,	2026	<MLS> Created devicestate_snapshot.c
+//*	Oct 18,	2026	<MLS> Description lists which drivers publish and who reads
+//*****************************************************************************
+
+#include	<stdbool.h>
+#include	<stdint.h>
+#include	<stdio.h>
+#include	<string.h>
+#include	<pthread.h>
+#include	<sys/time.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"devicestate_snapshot.h"
+
+//*	the maximum number of times a reader will retry if the record is being updated
+#define	kMaxSnapshotReadRetries		100
+
+//*****************************************************************************
+typedef struct	//	TYPE_SnapshotSlot
+{
+	uint32_t			sequence;		//*	odd while the record is being written
+	bool				inUse;
+	int					deviceType;
+	int					alpacaDevNum;
+	TYPE_DeviceSnapshot	record;
+} TYPE_SnapshotSlot;
+
+static TYPE_SnapshotSlot	gSnapshotSlots[kMaxSnapshotDevices];
+static int					gSnapshotSlotCnt		=	0;
+static pthread_mutex_t		gSnapshotSlotMutex		=	PTHREAD_MUTEX_INITIALIZER;
+
+//*****************************************************************************
+static TYPE_SnapshotSlot	*FindSnapshotSlot(const int deviceType, const int alpacaDevNum)
+{
+TYPE_SnapshotSlot	*slotPtr;
+int					slotCnt;
+int					iii;
+
+	slotPtr	=	NULL;
+	slotCnt	=	__atomic_load_n(&gSnapshotSlotCnt, __ATOMIC_ACQUIRE);
+	for (iii=0; iii<slotCnt; iii++)
+	{
+		if (__atomic_load_n(&gSnapshotSlots[iii].inUse, __ATOMIC_ACQUIRE) &&
+			(gSnapshotSlots[iii].deviceType == deviceType) &&
+			((alpacaDevNum < 0) || (gSnapshotSlots[iii].alpacaDevNum == alpacaDevNum)))
+		{
+			slotPtr	=	&gSnapshotSlots[iii];
+			break;
+		}
+	}
+	return(slotPtr);
+}
+
+//*****************************************************************************
+//*	the caller fills in deviceType, alpacaDevNum and the device data,
+//*	the version and time stamp are filled in here
+//*****************************************************************************
+void	DeviceSnapshot_Publish(TYPE_DeviceSnapshot *newSnapshot)
+{
+TYPE_SnapshotSlot	*slotPtr;
+
+	slotPtr	=	FindSnapshotSlot(newSnapshot->deviceType, newSnapshot->alpacaDevNum);
+	if (slotPtr == NULL)
+	{
+		//*	first time for this device, allocate a slot
+		pthread_mutex_lock(&gSnapshotSlotMutex);
+		if (gSnapshotSlotCnt < kMaxSnapshotDevices)
+		{
+			slotPtr					=	&gSnapshotSlots[gSnapshotSlotCnt];
+			memset(slotPtr, 0, sizeof(TYPE_SnapshotSlot));
+			slotPtr->deviceType		=	newSnapshot->deviceType;
+			slotPtr->alpacaDevNum	=	newSnapshot->alpacaDevNum;
+			__atomic_store_n(&gSnapshotSlotCnt, (gSnapshotSlotCnt + 1), __ATOMIC_RELEASE);
+		}
+		else
+		{
+			CONSOLE_DEBUG("Snapshot registry is full");
+		}
+		pthread_mutex_unlock(&gSnapshotSlotMutex);
+	}
+
+	if (slotPtr != NULL)
+	{
+		gettimeofday(&newSnapshot->timeStamp, NULL);
+		newSnapshot->version	=	slotPtr->record.version + 1;
+
+		//*	odd sequence number while writing
+		__atomic_store_n(&slotPtr->sequence, (slotPtr->sequence + 1), __ATOMIC_RELAXED);
+		__atomic_thread_fence(__ATOMIC_RELEASE);
+
+		slotPtr->record	=	*newSnapshot;
+
+		//*	back to even, the new record is visible
+		__atomic_store_n(&slotPtr->sequence, (slotPtr->sequence + 1), __ATOMIC_RELEASE);
+		__atomic_store_n(&slotPtr->inUse, true, __ATOMIC_RELEASE);
+	}
+}
+
+//*****************************************************************************
+//*	alpacaDevNum < 0 returns the first device of that type
+//*	returns false if there is no snapshot for that device
+//*****************************************************************************
+bool	DeviceSnapshot_Read(const int deviceType, const int alpacaDevNum, TYPE_DeviceSnapshot *snapshot)
+{
+TYPE_SnapshotSlot	*slotPtr;
+uint32_t			seqBefore;
+uint32_t			seqAfter;
+int					retryCnt;
+bool				validFlag;
+
+	validFlag	=	false;
+	slotPtr		=	FindSnapshotSlot(deviceType, alpacaDevNum);
+	if (slotPtr != NULL)
+	{
+		retryCnt	=	0;
+		while ((validFlag == false) && (retryCnt < kMaxSnapshotReadRetries))
+		{
+			seqBefore	=	__atomic_load_n(&slotPtr->sequence, __ATOMIC_ACQUIRE);
+			if ((seqBefore & 0x01) == 0)
+			{
+				*snapshot	=	slotPtr->record;
+				__atomic_thread_fence(__ATOMIC_ACQUIRE);
+				seqAfter	=	__atomic_load_n(&slotPtr->sequence, __ATOMIC_RELAXED);
+				if (seqAfter == seqBefore)
+				{
+					validFlag	=	true;
+				}
+			}
+			retryCnt++;
+		}
+		if (validFlag == false)
+		{
+			CONSOLE_DEBUG_W_NUM("Failed to get consistent snapshot, deviceType\t=", deviceType);
+		}
+	}
+	return(validFlag);
+}
+
+//*****************************************************************************
+int32_t	DeviceSnapshot_GetAge_ms(const TYPE_DeviceSnapshot *snapshot)
+{
+struct timeval	currentTime;
+int32_t			age_ms;
+
+	gettimeofday(&currentTime, NULL);
+	age_ms	=	((currentTime.tv_sec - snapshot->timeStamp.tv_sec) * 1000) +
+				((currentTime.tv_usec - snapshot->timeStamp.tv_usec) / 1000);
+	return(age_ms);
+}
@@ -0,0 +1,98 @@
+//*****************************************************************************
+//#include	"devicestate_snapshot.h"
+
+#ifndef _DEVICESTATE_SNAPSHOT_H_
+#define	_DEVICESTATE_SNAPSHOT_H_
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+#ifndef	_SYS_TIME_H
+	#include	<sys/time.h>
+#endif
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define	kMaxSnapshotDevices		30
+#define	kSnapshotStrLen			64
+
+//*****************************************************************************
+typedef struct	//	TYPE_FocuserSnapshot
+{
+	int32_t		Position;
+	bool		IsMoving;
+	double		Temperature_DegC;
+	double		Voltage;
+	char		Manufacturer[kSnapshotStrLen];
+	char		Model[kSnapshotStrLen];
+	char		Version[kSnapshotStrLen];
+	char		SerialNumber[kSnapshotStrLen];
+} TYPE_FocuserSnapshot;
+
+//*****************************************************************************
+typedef struct	//	TYPE_RotatorSnapshot
+{
+	int32_t		Position_steps;
+	double		Position_degs;
+	bool		IsMoving;
+	char		Manufacturer[kSnapshotStrLen];
+	char		Model[kSnapshotStrLen];
+	char		SerialNumber[kSnapshotStrLen];
+} TYPE_RotatorSnapshot;
+
+//*****************************************************************************
+typedef struct	//	TYPE_FilterwheelSnapshot
+{
+	int			Position;
+	bool		IsMoving;
+	char		FilterName[kSnapshotStrLen];
+	char		Name[kSnapshotStrLen];
+	char		SerialNumber[kSnapshotStrLen];
+} TYPE_FilterwheelSnapshot;
+
+//*****************************************************************************
+typedef struct	//	TYPE_TelescopeSnapshot
+{
+	double		RightAscension;		//*	hours
+	double		Declination;		//*	degrees
+	double		Altitude;			//*	degrees
+	double		Azimuth;			//*	degrees
+	bool		Tracking;
+	bool		Slewing;
+	bool		AtPark;
+} TYPE_TelescopeSnapshot;
+
+//*****************************************************************************
+//*	an immutable, point in time record of a device
+//*****************************************************************************
+typedef struct	//	TYPE_DeviceSnapshot
+{
+	int					deviceType;		//*	TYPE_DEVICETYPE
+	int					alpacaDevNum;
+	uint32_t			version;		//*	incremented by each publish
+	struct timeval		timeStamp;		//*	time the record was published
+	union
+	{
+		TYPE_FocuserSnapshot		focuser;
+		TYPE_RotatorSnapshot		rotator;
+		TYPE_FilterwheelSnapshot	filterwheel;
+		TYPE_TelescopeSnapshot		telescope;
+	} dev;
+} TYPE_DeviceSnapshot;
+
+
+void	DeviceSnapshot_Publish(TYPE_DeviceSnapshot *newSnapshot);
+bool	DeviceSnapshot_Read(const int deviceType, const int alpacaDevNum, TYPE_DeviceSnapshot *snapshot);
+int32_t	DeviceSnapshot_GetAge_ms(const TYPE_DeviceSnapshot *snapshot);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _DEVICESTATE_SNAPSHOT_H_
@@ -86,6 +86,7 @@
 //*	May 17,	2024	<MLS> Added http error 400 processing to dome driver
 //*	Aug 17,	2024	<MLS> Added StopShutter()
 //*	Sep 20,	2024	<MLS> Zoom meeting with Mike Bradshaw, discussed dome control and 2 door option
+//*	Oct 18,	2026	<MLS> Dome azimuth is logged to the time series store when it changes
 //*****************************************************************************
 //*	cd /home/pi/dev-mark/alpaca
 //*	LOGFILE=logfile.txt
@@ -138,6 +139,7 @@
 
 #include	"json_parse.h"
 #include	"sendrequest_lib.h"
+#include	"timeseries_store.h"
 
 #include	"dome_AlpacaCmds.h"
 #include	"dome_AlpacaCmds.cpp"
@@ -189,6 +191,8 @@ DomeDriver::DomeDriver(const int argDevNum)
 
 	cDomeConfig						=	kIsDome;
 	cAzimuth_Destination			=	-1.0;		//*	must be >= to 0 to be valid
+	cLastLoggedAzimuth				=	-1.0;
+	cAzimuthChannel					=	kTS_NotRegistered;
 	cParkAzimuth					=	0.0;
 	cHomeAzimuth					=	0.0;
 	cCurrentPWM						=	0;
@@ -705,6 +709,11 @@ uint32_t	timeSinceLastWhatever;
 int			isAtMax;
 
 	UpdateDomePosition();
+	if (fabs(cDomeProp.Azimuth - cLastLoggedAzimuth) >= 0.1)
+	{
+		TimeSeries_Log(&cAzimuthChannel, "Azimuth", cDomeProp.Azimuth);
+		cLastLoggedAzimuth	=	cDomeProp.Azimuth;
+	}
 
 	minDealy_microSecs		=	1000;		//*	default to 1 millisecond
 	currentMilliSecs		=	millis();
@@ -19,6 +19,7 @@
 //*****************************************************************************
 //*	Sep  4,	2019	<MLS> Started on C++ version of dome driver
 //*	Nov 28,	2020	<MLS> Updated return values to TYPE_ASCOM_STATUS
+//*	Oct 18,	2026	<MLS> Added cLastLoggedAzimuth
 //*****************************************************************************
 //#include	"domedriver.h"
 
@@ -189,6 +190,8 @@ class DomeDriver: public AlpacaDriver
 
 		//		int32_t			cShutterstatus;
 				double			cAzimuth_Destination;		//*	were we want to go to, must be >= to 0 to be valid
+				double			cLastLoggedAzimuth;			//*	last value written to the time series store
+				int				cAzimuthChannel;			//*	time series channel handle
 
 
 	protected:
@@ -19,6 +19,7 @@
 //*****************************************************************************
 //*	May 21,	2019	<MLS> Created eventlogging.c
 //*	May 22,	2019	<MLS> Added SendHtmlLog()
+//*	Oct 18,	2026	<MLS> Added mutex to LogEvent(), startup probes log from their own threads
 //*****************************************************************************
 
 
@@ -30,6 +31,7 @@
 //#include	<stdint.h>
 #include	<time.h>
 //#include	<unistd.h>
+#include	<pthread.h>
 
 
 
@@ -62,6 +64,7 @@ typedef struct
 
 TYPE_EVENTLOG	gEventLog[kMaxLogEntries];
 int				gLogIndex	=	0;
+static pthread_mutex_t	gEventLogMutex	=	PTHREAD_MUTEX_INITIALIZER;
 
 //**************************************************************************
 //*	if the log files up, we will dump the first half and continue
@@ -86,6 +89,7 @@ void	LogEvent(	const char				*eventName,
 					const TYPE_ASCOM_STATUS	alpacaErrCode,
 					const char				*errorString)
 {
+	pthread_mutex_lock(&gEventLogMutex);
 	if (gLogIndex < kMaxLogEntries)
 	{
 		memset(&gEventLog[gLogIndex], 0, sizeof(TYPE_EVENTLOG));
@@ -117,6 +121,7 @@ void	LogEvent(	const char				*eventName,
 			FlushHalfLog();
 		}
 	}
+	pthread_mutex_unlock(&gEventLogMutex);
 }
 
 //**************************************************************************
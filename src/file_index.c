@@ -0,0 +1,1326 @@
+//*****************************************************************************
+//*	Name:			file_index.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	In memory index of the files in the image data directory
+//*
+//*	The directory is scanned once when the index is opened, after that a thread
+//*	keeps the index up to date from inotify events, nobody has to call readdir()
+//*	again no matter how many files are saved during the night.
+//*
+//*	Every file gets a sequence number when it is added, the entries are kept in
+//*	that order (oldest first), there is one list of all of them and one per file
+//*	type. A page is found with a binary search on the sequence number (the cursor)
+//*	or on the time, then the entries are copied out, so the cost of a page does
+//*	not depend on the number of files. A file name hash table is used for the
+//*	inotify updates and FileIndex_SetInfo().
+//*
+//*	Deleted files are only marked, the slots are squeezed out when more than half
+//*	of them are deleted. A file that is re-written gets a new sequence number.
+//*
+//*	The time range search uses the time the file was added to the index, which is
+//*	the modification time for files that were there when the index was opened.
+//*	A file copied in later with an old time stamp is found where it was added.
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Re-distributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 18,	2026	<MLS> Created file_index.c
+//*	Oct 18,	2026	<MLS> Added paging and update test (_INCLUDE_FILE_INDEX_MAIN_)
+//*	Oct 18,	2026	<MLS> FileIndex_Query() returns newest first unless oldestFirst is set
+//*****************************************************************************
+
+#ifdef _INCLUDE_FILE_INDEX_MAIN_
+	#define	_ENABLE_FILE_INDEX_
+#endif
+
+#ifdef _ENABLE_FILE_INDEX_
+
+#include	<stdbool.h>
+#include	<stdint.h>
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	<strings.h>
+#include	<unistd.h>
+#include	<errno.h>
+#include	<time.h>
+#include	<poll.h>
+#include	<dirent.h>
+#include	<pthread.h>
+#include	<sys/stat.h>
+#include	<sys/inotify.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"file_index.h"
+
+#define	kFI_EventMask		(IN_CLOSE_WRITE | IN_MOVED_TO | IN_DELETE | IN_MOVED_FROM | IN_DELETE_SELF)
+#define	kFI_EventBuffSize	(16 * 1024)
+#define	kFI_PollTimeout_ms	500			//*	how long FileIndex_Close() may have to wait
+#define	kFI_MinCompactCnt	1024
+#define	kFI_AllList			kFileType_Cnt
+
+#define	kFI_HashEmpty		(-1)
+#define	kFI_HashRemoved		(-2)
+
+//*****************************************************************************
+typedef struct	//	TYPE_FI_Slot
+{
+	TYPE_FILE_INDEX_ENTRY	entry;
+	time_t					sortTime;		//*	never goes backwards, for the time range search
+	uint32_t				scanGen;		//*	used to find files that went away during a rescan
+	bool					deleted;
+} TYPE_FI_Slot;
+
+//*****************************************************************************
+//*	slot numbers in sequence order
+typedef struct	//	TYPE_FI_List
+{
+	int			*slotIdx;
+	int			count;
+	int			allocCnt;
+} TYPE_FI_List;
+
+//*****************************************************************************
+typedef struct	//	TYPE_FI_ScanEntry
+{
+	char		fileName[kFileIndex_MaxNameLen];
+	int64_t		fileSize;
+	time_t		fileTime;
+} TYPE_FI_ScanEntry;
+
+static pthread_mutex_t	gFImutex			=	PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t	gFIopenMutex		=	PTHREAD_MUTEX_INITIALIZER;
+static pthread_t		gFIthreadID;
+static bool				gFIisOpen			=	false;
+static bool				gFIrunning			=	false;
+static int				gFInotifyFD			=	-1;
+static char				gFIdirPath[256];
+
+static TYPE_FI_Slot		*gFIslots			=	NULL;
+static int				gFIslotCnt			=	0;
+static int				gFIslotAlloc		=	0;
+static int				gFIdeletedCnt		=	0;
+static uint32_t			gFInextSeq			=	1;
+static uint32_t			gFIscanGen			=	0;
+static time_t			gFIlastSortTime		=	0;
+
+static TYPE_FI_List		gFIlists[kFileType_Cnt + 1];		//*	the last one has all of the types
+static int				gFIliveCnt[kFileType_Cnt + 1];
+
+static int				*gFIhashTable		=	NULL;
+static uint32_t			gFIhashSize			=	0;			//*	always a power of 2
+static int				gFIhashUsed			=	0;			//*	includes the removed markers
+
+static const char		*gFileTypeNames[]	=
+{
+	"fits",
+	"jpeg",
+	"png",
+	"csv",
+	"video",
+	"text",
+	"other"
+};
+
+//*****************************************************************************
+static void	FI_CopyString(char *dst, const char *src, const size_t maxLen)
+{
+size_t	stringLen;
+
+	stringLen	=	strnlen(src, (maxLen - 1));
+	memcpy(dst, src, stringLen);
+	dst[stringLen]	=	0;
+}
+
+//*****************************************************************************
+int	FileIndex_GetTypeFromName(const char *fileName)
+{
+const char	*extPtr;
+int			fileType;
+
+	fileType	=	kFileType_Other;
+	extPtr		=	strrchr(fileName, '.');
+	if (extPtr != NULL)
+	{
+		extPtr++;
+		if ((strcasecmp(extPtr, "fits") == 0) || (strcasecmp(extPtr, "fit") == 0) || (strcasecmp(extPtr, "fts") == 0))
+		{
+			fileType	=	kFileType_FITS;
+		}
+		else if ((strcasecmp(extPtr, "jpg") == 0) || (strcasecmp(extPtr, "jpeg") == 0))
+		{
+			fileType	=	kFileType_JPEG;
+		}
+		else if (strcasecmp(extPtr, "png") == 0)
+		{
+			fileType	=	kFileType_PNG;
+		}
+		else if (strcasecmp(extPtr, "csv") == 0)
+		{
+			fileType	=	kFileType_CSV;
+		}
+		else if ((strcasecmp(extPtr, "avi") == 0) || (strcasecmp(extPtr, "mp4") == 0) || (strcasecmp(extPtr, "ser") == 0))
+		{
+			fileType	=	kFileType_Video;
+		}
+		else if (strcasecmp(extPtr, "txt") == 0)
+		{
+			fileType	=	kFileType_Text;
+		}
+	}
+	return(fileType);
+}
+
+//*****************************************************************************
+//*	returns kFileType_Any for "all" or an empty string, -2 if it is not valid
+//*****************************************************************************
+int	FileIndex_GetTypeFromString(const char *typeString)
+{
+int		iii;
+
+	if ((typeString[0] == 0) || (strcasecmp(typeString, "all") == 0))
+	{
+		return(kFileType_Any);
+	}
+	for (iii=0; iii<kFileType_Cnt; iii++)
+	{
+		if (strcasecmp(typeString, gFileTypeNames[iii]) == 0)
+		{
+			return(iii);
+		}
+	}
+	return(-2);
+}
+
+//*****************************************************************************
+const char	*FileIndex_GetTypeName(const int fileType)
+{
+	if ((fileType >= 0) && (fileType < kFileType_Cnt))
+	{
+		return(gFileTypeNames[fileType]);
+	}
+	return("all");
+}
+
+//*****************************************************************************
+//*	FNV-1a
+//*****************************************************************************
+static uint32_t	FI_HashName(const char *fileName)
+{
+uint32_t	hashValue;
+
+	hashValue	=	2166136261u;
+	while (*fileName != 0)
+	{
+		hashValue	^=	(unsigned char)*fileName;
+		hashValue	*=	16777619u;
+		fileName++;
+	}
+	return(hashValue);
+}
+
+//*****************************************************************************
+//*	returns the slot number or -1, the mutex has to be locked
+//*****************************************************************************
+static int	FI_HashFind(const char *fileName)
+{
+uint32_t	hashIdx;
+int			slotIdx;
+
+	if (gFIhashSize == 0)
+	{
+		return(-1);
+	}
+	hashIdx	=	FI_HashName(fileName) & (gFIhashSize - 1);
+	while (gFIhashTable[hashIdx] != kFI_HashEmpty)
+	{
+		slotIdx	=	gFIhashTable[hashIdx];
+		if ((slotIdx >= 0) && (strcmp(gFIslots[slotIdx].entry.fileName, fileName) == 0))
+		{
+			return(slotIdx);
+		}
+		hashIdx	=	(hashIdx + 1) & (gFIhashSize - 1);
+	}
+	return(-1);
+}
+
+//*****************************************************************************
+static void	FI_HashPut(const int slotIdx)
+{
+uint32_t	hashIdx;
+
+	hashIdx	=	FI_HashName(gFIslots[slotIdx].entry.fileName) & (gFIhashSize - 1);
+	while (gFIhashTable[hashIdx] >= 0)
+	{
+		hashIdx	=	(hashIdx + 1) & (gFIhashSize - 1);
+	}
+	if (gFIhashTable[hashIdx] == kFI_HashEmpty)
+	{
+		gFIhashUsed++;
+	}
+	gFIhashTable[hashIdx]	=	slotIdx;
+}
+
+//*****************************************************************************
+//*	the table is re-built with only the live slots, this also gets rid of the
+//*	removed markers
+//*****************************************************************************
+static bool	FI_HashRebuild(void)
+{
+uint32_t	newSize;
+int			*newTable;
+int			iii;
+int			liveCnt;
+
+	liveCnt	=	gFIliveCnt[kFI_AllList];
+	newSize	=	1024;
+	while (newSize < (uint32_t)(liveCnt * 4))
+	{
+		newSize	=	newSize * 2;
+	}
+	newTable	=	(int *)malloc(newSize * sizeof(int));
+	if (newTable == NULL)
+	{
+		CONSOLE_DEBUG("Failed to allocate hash table");
+		return(false);
+	}
+	for (iii=0; iii<(int)newSize; iii++)
+	{
+		newTable[iii]	=	kFI_HashEmpty;
+	}
+	if (gFIhashTable != NULL)
+	{
+		free(gFIhashTable);
+	}
+	gFIhashTable	=	newTable;
+	gFIhashSize		=	newSize;
+	gFIhashUsed		=	0;
+	for (iii=0; iii<gFIslotCnt; iii++)
+	{
+		if (gFIslots[iii].deleted == false)
+		{
+			FI_HashPut(iii);
+		}
+	}
+	return(true);
+}
+
+//*****************************************************************************
+static void	FI_HashRemove(const char *fileName)
+{
+uint32_t	hashIdx;
+int			slotIdx;
+
+	hashIdx	=	FI_HashName(fileName) & (gFIhashSize - 1);
+	while (gFIhashTable[hashIdx] != kFI_HashEmpty)
+	{
+		slotIdx	=	gFIhashTable[hashIdx];
+		if ((slotIdx >= 0) && (strcmp(gFIslots[slotIdx].entry.fileName, fileName) == 0))
+		{
+			gFIhashTable[hashIdx]	=	kFI_HashRemoved;
+			return;
+		}
+		hashIdx	=	(hashIdx + 1) & (gFIhashSize - 1);
+	}
+}
+
+//*****************************************************************************
+static bool	FI_ListAppend(TYPE_FI_List *list, const int slotIdx)
+{
+int		*newPtr;
+int		newAllocCnt;
+
+	if (list->count >= list->allocCnt)
+	{
+		newAllocCnt	=	(list->allocCnt > 0) ? (list->allocCnt * 2) : 1024;
+		newPtr		=	(int *)realloc(list->slotIdx, newAllocCnt * sizeof(int));
+		if (newPtr == NULL)
+		{
+			return(false);
+		}
+		list->slotIdx	=	newPtr;
+		list->allocCnt	=	newAllocCnt;
+	}
+	list->slotIdx[list->count]	=	slotIdx;
+	list->count++;
+	return(true);
+}
+
+//*****************************************************************************
+//*	squeezes out the deleted slots, the sequence numbers do not change so
+//*	cursors that the clients have are still good
+//*****************************************************************************
+static void	FI_Compact(void)
+{
+int		srcIdx;
+int		dstIdx;
+int		fileType;
+
+	CONSOLE_DEBUG_W_NUM("Removing deleted entries\t=", gFIdeletedCnt);
+	for (fileType=0; fileType <= kFileType_Cnt; fileType++)
+	{
+		gFIlists[fileType].count	=	0;
+	}
+	dstIdx	=	0;
+	for (srcIdx=0; srcIdx<gFIslotCnt; srcIdx++)
+	{
+		if (gFIslots[srcIdx].deleted == false)
+		{
+			if (dstIdx != srcIdx)
+			{
+				gFIslots[dstIdx]	=	gFIslots[srcIdx];
+			}
+			//*	the lists only get shorter, they can not fail
+			FI_ListAppend(&gFIlists[gFIslots[dstIdx].entry.fileType], dstIdx);
+			FI_ListAppend(&gFIlists[kFI_AllList], dstIdx);
+			dstIdx++;
+		}
+	}
+	gFIslotCnt		=	dstIdx;
+	gFIdeletedCnt	=	0;
+	FI_HashRebuild();
+}
+
+//*****************************************************************************
+static void	FI_DeleteSlot(const int slotIdx)
+{
+TYPE_FI_Slot	*slot;
+
+	slot	=	&gFIslots[slotIdx];
+	FI_HashRemove(slot->entry.fileName);
+	slot->deleted	=	true;
+	gFIliveCnt[slot->entry.fileType]--;
+	gFIliveCnt[kFI_AllList]--;
+	gFIdeletedCnt++;
+}
+
+//*****************************************************************************
+//*	the slot numbers change, nobody can be holding one when this is called
+//*****************************************************************************
+static void	FI_CheckCompact(void)
+{
+	if ((gFIdeletedCnt > kFI_MinCompactCnt) && (gFIdeletedCnt > (gFIslotCnt / 2)))
+	{
+		FI_Compact();
+	}
+}
+
+//*****************************************************************************
+//*	adds or updates a file, the mutex has to be locked
+//*	returns the slot number or -1
+//*****************************************************************************
+static int	FI_AddFile(const char *fileName, const int64_t fileSize, const time_t fileTime)
+{
+TYPE_FI_Slot	*slot;
+TYPE_FI_Slot	*newSlots;
+int				slotIdx;
+int				newAllocCnt;
+int				fileType;
+
+	slotIdx	=	FI_HashFind(fileName);
+	if (slotIdx >= 0)
+	{
+		slot			=	&gFIslots[slotIdx];
+		slot->scanGen	=	gFIscanGen;
+		if ((slot->entry.fileSize == fileSize) && (slot->entry.fileTime == fileTime))
+		{
+			return(slotIdx);
+		}
+		//*	it was re-written, it goes to the end
+		FI_DeleteSlot(slotIdx);
+	}
+
+	if (gFIslotCnt >= gFIslotAlloc)
+	{
+		newAllocCnt	=	(gFIslotAlloc > 0) ? (gFIslotAlloc * 2) : 1024;
+		newSlots	=	(TYPE_FI_Slot *)realloc(gFIslots, newAllocCnt * sizeof(TYPE_FI_Slot));
+		if (newSlots == NULL)
+		{
+			CONSOLE_DEBUG("Failed to allocate file index slots");
+			return(-1);
+		}
+		gFIslots		=	newSlots;
+		gFIslotAlloc	=	newAllocCnt;
+	}
+	fileType	=	FileIndex_GetTypeFromName(fileName);
+	slotIdx		=	gFIslotCnt;
+	if ((FI_ListAppend(&gFIlists[fileType], slotIdx) == false) ||
+		(FI_ListAppend(&gFIlists[kFI_AllList], slotIdx) == false))
+	{
+		CONSOLE_DEBUG("Failed to allocate file index list");
+		return(-1);
+	}
+	slot	=	&gFIslots[slotIdx];
+	memset(slot, 0, sizeof(TYPE_FI_Slot));
+	FI_CopyString(slot->entry.fileName, fileName, kFileIndex_MaxNameLen);
+	slot->entry.seq			=	gFInextSeq++;
+	slot->entry.fileType	=	fileType;
+	slot->entry.fileSize	=	fileSize;
+	slot->entry.fileTime	=	fileTime;
+	if (fileTime > gFIlastSortTime)
+	{
+		gFIlastSortTime	=	fileTime;
+	}
+	slot->sortTime	=	gFIlastSortTime;
+	slot->scanGen	=	gFIscanGen;
+	gFIslotCnt++;
+	gFIliveCnt[fileType]++;
+	gFIliveCnt[kFI_AllList]++;
+
+	//*	keep the hash table at most half full
+	if (((gFIhashUsed + 1) * 2) > (int)gFIhashSize)
+	{
+		FI_HashRebuild();
+	}
+	else
+	{
+		FI_HashPut(slotIdx);
+	}
+	return(slotIdx);
+}
+
+//*****************************************************************************
+static void	FI_RemoveFile(const char *fileName)
+{
+int		slotIdx;
+
+	pthread_mutex_lock(&gFImutex);
+	slotIdx	=	FI_HashFind(fileName);
+	if (slotIdx >= 0)
+	{
+		FI_DeleteSlot(slotIdx);
+		FI_CheckCompact();
+	}
+	pthread_mutex_unlock(&gFImutex);
+}
+
+//*****************************************************************************
+//*	the stat is done without the mutex
+//*****************************************************************************
+static bool	FI_StatFile(const char *fileName, int64_t *fileSize, time_t *fileTime)
+{
+char		filePath[512];
+struct stat	fileStatus;
+
+	if ((fileName[0] == '.') || (strlen(fileName) >= kFileIndex_MaxNameLen))
+	{
+		return(false);
+	}
+	snprintf(filePath, sizeof(filePath), "%s/%s", gFIdirPath, fileName);
+	if ((stat(filePath, &fileStatus) != 0) || (S_ISREG(fileStatus.st_mode) == false))
+	{
+		return(false);
+	}
+	*fileSize	=	fileStatus.st_size;
+	*fileTime	=	fileStatus.st_mtime;
+	return(true);
+}
+
+//*****************************************************************************
+static void	FI_UpdateFile(const char *fileName)
+{
+int64_t		fileSize;
+time_t		fileTime;
+
+	if (FI_StatFile(fileName, &fileSize, &fileTime))
+	{
+		pthread_mutex_lock(&gFImutex);
+		FI_AddFile(fileName, fileSize, fileTime);
+		FI_CheckCompact();
+		pthread_mutex_unlock(&gFImutex);
+	}
+}
+
+//*****************************************************************************
+static int	FI_ScanSort(const void *e1, const void *e2)
+{
+const TYPE_FI_ScanEntry	*file1;
+const TYPE_FI_ScanEntry	*file2;
+
+	file1	=	(const TYPE_FI_ScanEntry *)e1;
+	file2	=	(const TYPE_FI_ScanEntry *)e2;
+	if (file1->fileTime != file2->fileTime)
+	{
+		return((file1->fileTime < file2->fileTime) ? -1 : 1);
+	}
+	return(strcmp(file1->fileName, file2->fileName));
+}
+
+//*****************************************************************************
+//*	adds everything in the directory oldest first and removes entries for
+//*	files that are not there any more.
+//*	Used when the index is opened and if inotify drops events.
+//*****************************************************************************
+static bool	FI_ScanDirectory(void)
+{
+DIR					*directory;
+struct dirent		*dir;
+TYPE_FI_ScanEntry	*scanList;
+TYPE_FI_ScanEntry	*newList;
+int					scanCnt;
+int					scanAlloc;
+int					iii;
+
+	directory	=	opendir(gFIdirPath);
+	if (directory == NULL)
+	{
+		CONSOLE_DEBUG_W_STR("Failed to open", gFIdirPath);
+		return(false);
+	}
+	scanList	=	NULL;
+	scanCnt		=	0;
+	scanAlloc	=	0;
+	while ((dir = readdir(directory)) != NULL)
+	{
+		if (scanCnt >= scanAlloc)
+		{
+			scanAlloc	=	(scanAlloc > 0) ? (scanAlloc * 2) : 1024;
+			newList		=	(TYPE_FI_ScanEntry *)realloc(scanList, scanAlloc * sizeof(TYPE_FI_ScanEntry));
+			if (newList == NULL)
+			{
+				break;
+			}
+			scanList	=	newList;
+		}
+		if (FI_StatFile(dir->d_name, &scanList[scanCnt].fileSize, &scanList[scanCnt].fileTime))
+		{
+			FI_CopyString(scanList[scanCnt].fileName, dir->d_name, kFileIndex_MaxNameLen);
+			scanCnt++;
+		}
+	}
+	closedir(directory);
+
+	qsort(scanList, scanCnt, sizeof(TYPE_FI_ScanEntry), FI_ScanSort);
+
+	pthread_mutex_lock(&gFImutex);
+	gFIscanGen++;
+	for (iii=0; iii<scanCnt; iii++)
+	{
+		FI_AddFile(scanList[iii].fileName, scanList[iii].fileSize, scanList[iii].fileTime);
+	}
+	for (iii=0; iii<gFIslotCnt; iii++)
+	{
+		if ((gFIslots[iii].deleted == false) && (gFIslots[iii].scanGen != gFIscanGen))
+		{
+			FI_DeleteSlot(iii);
+		}
+	}
+	FI_CheckCompact();
+	pthread_mutex_unlock(&gFImutex);
+
+	if (scanList != NULL)
+	{
+		free(scanList);
+	}
+	return(true);
+}
+
+//*****************************************************************************
+static void	*FileIndex_Thread(void *arg)
+{
+struct pollfd				pollData;
+const struct inotify_event	*event;
+char						*eventBuff;
+ssize_t						readCnt;
+ssize_t						offset;
+int							pollRetCode;
+
+	(void)arg;
+	eventBuff	=	(char *)malloc(kFI_EventBuffSize);
+	if (eventBuff == NULL)
+	{
+		CONSOLE_DEBUG("Failed to allocate inotify buffer");
+		return(NULL);
+	}
+	pollData.fd		=	gFInotifyFD;
+	pollData.events	=	POLLIN;
+	while (gFIrunning)
+	{
+		pollData.revents	=	0;
+		pollRetCode			=	poll(&pollData, 1, kFI_PollTimeout_ms);
+		if ((pollRetCode <= 0) || ((pollData.revents & POLLIN) == 0))
+		{
+			continue;
+		}
+		readCnt	=	read(gFInotifyFD, eventBuff, kFI_EventBuffSize);
+		offset	=	0;
+		while ((readCnt > 0) && ((offset + (ssize_t)sizeof(struct inotify_event)) <= readCnt))
+		{
+			event	=	(const struct inotify_event *)(eventBuff + offset);
+			if (event->mask & IN_Q_OVERFLOW)
+			{
+				CONSOLE_DEBUG("inotify queue overflow, re-scanning directory");
+				FI_ScanDirectory();
+			}
+			else if (event->mask & IN_DELETE_SELF)
+			{
+				CONSOLE_DEBUG_W_STR("Image directory was deleted", gFIdirPath);
+			}
+			else if ((event->len > 0) && ((event->mask & IN_ISDIR) == 0))
+			{
+				if (event->mask & (IN_CLOSE_WRITE | IN_MOVED_TO))
+				{
+					FI_UpdateFile(event->name);
+				}
+				else if (event->mask & (IN_DELETE | IN_MOVED_FROM))
+				{
+					FI_RemoveFile(event->name);
+				}
+			}
+			offset	+=	sizeof(struct inotify_event) + event->len;
+		}
+	}
+	free(eventBuff);
+	return(NULL);
+}
+
+//*****************************************************************************
+static void	FI_FreeAll(void)
+{
+int		iii;
+
+	if (gFIslots != NULL)
+	{
+		free(gFIslots);
+	}
+	if (gFIhashTable != NULL)
+	{
+		free(gFIhashTable);
+	}
+	for (iii=0; iii <= kFileType_Cnt; iii++)
+	{
+		if (gFIlists[iii].slotIdx != NULL)
+		{
+			free(gFIlists[iii].slotIdx);
+		}
+	}
+	memset(gFIlists,	0,	sizeof(gFIlists));
+	memset(gFIliveCnt,	0,	sizeof(gFIliveCnt));
+	gFIslots		=	NULL;
+	gFIslotCnt		=	0;
+	gFIslotAlloc	=	0;
+	gFIdeletedCnt	=	0;
+	gFIhashTable	=	NULL;
+	gFIhashSize		=	0;
+	gFIhashUsed		=	0;
+	gFIlastSortTime	=	0;
+}
+
+//*****************************************************************************
+//*	Opening the same directory again does nothing, a different directory
+//*	closes the old index first.
+//*	Returns false if inotify is not available, the caller has to use readdir()
+//*****************************************************************************
+bool	FileIndex_Open(const char *dirPath)
+{
+bool	openOK;
+int		threadErr;
+
+	pthread_mutex_lock(&gFIopenMutex);
+	if (gFIisOpen && (strcmp(gFIdirPath, dirPath) == 0))
+	{
+		pthread_mutex_unlock(&gFIopenMutex);
+		return(true);
+	}
+	pthread_mutex_unlock(&gFIopenMutex);
+
+	FileIndex_Close();
+
+	pthread_mutex_lock(&gFIopenMutex);
+	CONSOLE_DEBUG_W_STR(__FUNCTION__, dirPath);
+	openOK	=	false;
+	FI_CopyString(gFIdirPath, dirPath, sizeof(gFIdirPath));
+	gFInotifyFD	=	inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (gFInotifyFD >= 0)
+	{
+		//*	the watch goes on before the scan so nothing is missed in between
+		if (inotify_add_watch(gFInotifyFD, gFIdirPath, kFI_EventMask) >= 0)
+		{
+			if (FI_HashRebuild() && FI_ScanDirectory())
+			{
+				gFIrunning	=	true;
+				threadErr	=	pthread_create(&gFIthreadID, NULL, &FileIndex_Thread, NULL);
+				if (threadErr == 0)
+				{
+					openOK	=	true;
+				}
+				else
+				{
+					CONSOLE_DEBUG_W_NUM("pthread_create returned\t=", threadErr);
+					gFIrunning	=	false;
+				}
+			}
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_NUM("inotify_add_watch failed, errno\t=", errno);
+		}
+	}
+	else
+	{
+		CONSOLE_DEBUG_W_NUM("inotify_init1 failed, errno\t=", errno);
+	}
+	if (openOK)
+	{
+		CONSOLE_DEBUG_W_NUM("Files in the index\t=", gFIliveCnt[kFI_AllList]);
+	}
+	else
+	{
+		if (gFInotifyFD >= 0)
+		{
+			close(gFInotifyFD);
+			gFInotifyFD	=	-1;
+		}
+		pthread_mutex_lock(&gFImutex);
+		FI_FreeAll();
+		pthread_mutex_unlock(&gFImutex);
+	}
+	gFIisOpen	=	openOK;
+	pthread_mutex_unlock(&gFIopenMutex);
+	return(openOK);
+}
+
+//*****************************************************************************
+void	FileIndex_Close(void)
+{
+	pthread_mutex_lock(&gFIopenMutex);
+	if (gFIisOpen)
+	{
+		gFIrunning	=	false;
+		pthread_join(gFIthreadID, NULL);
+		close(gFInotifyFD);
+		gFInotifyFD	=	-1;
+
+		pthread_mutex_lock(&gFImutex);
+		FI_FreeAll();
+		pthread_mutex_unlock(&gFImutex);
+		gFIisOpen	=	false;
+	}
+	pthread_mutex_unlock(&gFIopenMutex);
+}
+
+//*****************************************************************************
+bool	FileIndex_IsOpen(void)
+{
+	return(gFIisOpen);
+}
+
+//*****************************************************************************
+//*	attaches the data product comment and/or the FITS summary to a file,
+//*	NULL leaves that one alone. The file is added if inotify has not got to it yet.
+//*****************************************************************************
+void	FileIndex_SetInfo(const char *fileName, const char *comment, const char *summary)
+{
+const char	*namePtr;
+int64_t		fileSize;
+time_t		fileTime;
+int			slotIdx;
+
+	if (gFIisOpen == false)
+	{
+		return;
+	}
+	namePtr	=	strrchr(fileName, '/');
+	namePtr	=	(namePtr != NULL) ? (namePtr + 1) : fileName;
+
+	pthread_mutex_lock(&gFImutex);
+	slotIdx	=	FI_HashFind(namePtr);
+	pthread_mutex_unlock(&gFImutex);
+	if ((slotIdx < 0) && FI_StatFile(namePtr, &fileSize, &fileTime))
+	{
+		pthread_mutex_lock(&gFImutex);
+		FI_AddFile(namePtr, fileSize, fileTime);
+		pthread_mutex_unlock(&gFImutex);
+	}
+
+	pthread_mutex_lock(&gFImutex);
+	//*	look it up again, the slots may have moved while the mutex was not held
+	slotIdx	=	FI_HashFind(namePtr);
+	if (slotIdx >= 0)
+	{
+		if (comment != NULL)
+		{
+			FI_CopyString(gFIslots[slotIdx].entry.comment, comment, kFileIndex_MaxCommentLen);
+		}
+		if (summary != NULL)
+		{
+			FI_CopyString(gFIslots[slotIdx].entry.summary, summary, kFileIndex_MaxSummaryLen);
+		}
+	}
+	pthread_mutex_unlock(&gFImutex);
+}
+
+//*****************************************************************************
+//*	first position in the list with a sequence number >= cursor
+//*****************************************************************************
+static int	FI_FindCursor(const TYPE_FI_List *list, const uint32_t cursor)
+{
+int		lowIdx;
+int		highIdx;
+int		midIdx;
+
+	lowIdx	=	0;
+	highIdx	=	list->count;
+	while (lowIdx < highIdx)
+	{
+		midIdx	=	(lowIdx + highIdx) / 2;
+		if (gFIslots[list->slotIdx[midIdx]].entry.seq < cursor)
+		{
+			lowIdx	=	midIdx + 1;
+		}
+		else
+		{
+			highIdx	=	midIdx;
+		}
+	}
+	return(lowIdx);
+}
+
+//*****************************************************************************
+//*	first position in the list with a sort time >= startTime
+//*****************************************************************************
+static int	FI_FindTime(const TYPE_FI_List *list, const time_t startTime)
+{
+int		lowIdx;
+int		highIdx;
+int		midIdx;
+
+	lowIdx	=	0;
+	highIdx	=	list->count;
+	while (lowIdx < highIdx)
+	{
+		midIdx	=	(lowIdx + highIdx) / 2;
+		if (gFIslots[list->slotIdx[midIdx]].sortTime < startTime)
+		{
+			lowIdx	=	midIdx + 1;
+		}
+		else
+		{
+			highIdx	=	midIdx;
+		}
+	}
+	return(lowIdx);
+}
+
+//*****************************************************************************
+//*	copies one page of entries out, returns how many.
+//*	query->nextCursor is set to 0 when there are no more.
+//*	sortTime never goes backwards, so the scan stops at the first one outside
+//*	of the time range, going forward it is endTime, going back it is startTime
+//*****************************************************************************
+int	FileIndex_Query(TYPE_FILE_INDEX_QUERY *query, TYPE_FILE_INDEX_ENTRY *entries, const int maxEntries)
+{
+TYPE_FI_List	*list;
+TYPE_FI_Slot	*slot;
+int				listIdx;
+int				posIdx;
+int				timeIdx;
+int				limit;
+int				entryCnt;
+int				posStep;
+
+	query->nextCursor	=	0;
+	query->totalCnt		=	0;
+	if ((gFIisOpen == false) || (query->fileType < kFileType_Any) || (query->fileType >= kFileType_Cnt))
+	{
+		return(0);
+	}
+	limit	=	query->limit;
+	if ((limit <= 0) || (limit > maxEntries))
+	{
+		limit	=	maxEntries;
+	}
+	if (limit > kFileIndex_MaxPageSize)
+	{
+		limit	=	kFileIndex_MaxPageSize;
+	}
+	listIdx		=	(query->fileType == kFileType_Any) ? kFI_AllList : query->fileType;
+	entryCnt	=	0;
+
+	pthread_mutex_lock(&gFImutex);
+	list			=	&gFIlists[listIdx];
+	query->totalCnt	=	gFIliveCnt[listIdx];
+	if (query->oldestFirst)
+	{
+		//*	first file with a seq >= cursor
+		posStep	=	1;
+		posIdx	=	FI_FindCursor(list, query->cursor);
+		if (query->startTime > 0)
+		{
+			timeIdx	=	FI_FindTime(list, query->startTime);
+			if (timeIdx > posIdx)
+			{
+				posIdx	=	timeIdx;
+			}
+		}
+	}
+	else
+	{
+		//*	last file with a seq <= cursor
+		posStep	=	-1;
+		posIdx	=	list->count - 1;
+		if (query->cursor > 0)
+		{
+			posIdx	=	FI_FindCursor(list, query->cursor + 1) - 1;
+		}
+		if (query->endTime > 0)
+		{
+			timeIdx	=	FI_FindTime(list, query->endTime + 1) - 1;
+			if (timeIdx < posIdx)
+			{
+				posIdx	=	timeIdx;
+			}
+		}
+	}
+	while ((posIdx >= 0) && (posIdx < list->count))
+	{
+		slot	=	&gFIslots[list->slotIdx[posIdx]];
+		if (query->oldestFirst && (query->endTime > 0) && (slot->sortTime > query->endTime))
+		{
+			break;
+		}
+		if ((query->oldestFirst == false) && (slot->sortTime < query->startTime))
+		{
+			break;
+		}
+		if ((slot->deleted == false) &&
+			(slot->entry.fileTime >= query->startTime) &&
+			((query->endTime == 0) || (slot->entry.fileTime <= query->endTime)))
+		{
+			if (entryCnt >= limit)
+			{
+				query->nextCursor	=	slot->entry.seq;
+				break;
+			}
+			entries[entryCnt]	=	slot->entry;
+			entryCnt++;
+		}
+		posIdx	+=	posStep;
+	}
+	pthread_mutex_unlock(&gFImutex);
+	return(entryCnt);
+}
+
+//*****************************************************************************
+int	FileIndex_GetCount(const int fileType)
+{
+int		fileCnt;
+
+	fileCnt	=	0;
+	if ((fileType >= kFileType_Any) && (fileType < kFileType_Cnt))
+	{
+		pthread_mutex_lock(&gFImutex);
+		fileCnt	=	gFIliveCnt[(fileType == kFileType_Any) ? kFI_AllList : fileType];
+		pthread_mutex_unlock(&gFImutex);
+	}
+	return(fileCnt);
+}
+
+#endif // _ENABLE_FILE_INDEX_
+
+
+#ifdef _INCLUDE_FILE_INDEX_MAIN_
+//*****************************************************************************
+//*	Fills a directory with files, then checks
+//*		- paging through everything returns every file once, in both directions
+//*		- type and time range filters
+//*		- files added, re-written and deleted after the open show up
+//*		- FileIndex_SetInfo()
+//*		- the time for one page does not change with the directory size
+//*
+//*	g++ -O2 -x c++ -D_INCLUDE_FILE_INDEX_MAIN_ -I../libs/src_mlsLib file_index.c -lpthread -o fileindextest
+//*****************************************************************************
+#include	<fcntl.h>
+#include	<sys/time.h>
+
+#define	kTestDir		"/tmp/fileindex_test"
+#define	kTestPageSize	100
+
+static int	gFailures	=	0;
+
+//*****************************************************************************
+static void	Check(const bool condition, const char *message)
+{
+	if (condition == false)
+	{
+		printf("FAILED: %s\r\n", message);
+		gFailures++;
+	}
+}
+
+//*****************************************************************************
+static double	GetMicroSecs(void)
+{
+struct timeval	timeValue;
+
+	gettimeofday(&timeValue, NULL);
+	return((timeValue.tv_sec * 1000000.0) + timeValue.tv_usec);
+}
+
+//*****************************************************************************
+static void	MakeFile(const char *fileName, const int fileSize, const time_t fileTime)
+{
+char			filePath[256];
+FILE			*filePointer;
+struct timespec	fileTimes[2];
+
+	sprintf(filePath, "%s/%s", kTestDir, fileName);
+	filePointer	=	fopen(filePath, "w");
+	if (filePointer != NULL)
+	{
+		fprintf(filePointer, "%*s", fileSize, "x");
+		fclose(filePointer);
+	}
+	if (fileTime > 0)
+	{
+		fileTimes[0].tv_sec		=	fileTime;
+		fileTimes[0].tv_nsec	=	0;
+		fileTimes[1]			=	fileTimes[0];
+		utimensat(AT_FDCWD, filePath, fileTimes, 0);
+	}
+}
+
+//*****************************************************************************
+static void	EmptyDirectory(void)
+{
+DIR				*directory;
+struct dirent	*dir;
+char			filePath[512];
+
+	directory	=	opendir(kTestDir);
+	if (directory != NULL)
+	{
+		while ((dir = readdir(directory)) != NULL)
+		{
+			if (dir->d_name[0] != '.')
+			{
+				sprintf(filePath, "%s/%s", kTestDir, dir->d_name);
+				unlink(filePath);
+			}
+		}
+		closedir(directory);
+	}
+}
+
+//*****************************************************************************
+//*	waits for the inotify thread to catch up
+//*****************************************************************************
+static bool	WaitForCount(const int fileType, const int expectedCnt)
+{
+int		iii;
+
+	for (iii=0; iii<500; iii++)
+	{
+		if (FileIndex_GetCount(fileType) == expectedCnt)
+		{
+			return(true);
+		}
+		usleep(10000);
+	}
+	return(false);
+}
+
+//*****************************************************************************
+//*	pages through everything, returns the number of files
+//*****************************************************************************
+static int	PageThrough(TYPE_FILE_INDEX_QUERY *query, bool *inOrder)
+{
+TYPE_FILE_INDEX_ENTRY	entries[kTestPageSize];
+int						entryCnt;
+int						fileCnt;
+int						iii;
+uint32_t				lastSeq;
+
+	fileCnt			=	0;
+	lastSeq			=	query->oldestFirst ? 0 : UINT32_MAX;
+	*inOrder		=	true;
+	query->cursor	=	0;
+	query->limit	=	kTestPageSize;
+	do
+	{
+		entryCnt	=	FileIndex_Query(query, entries, kTestPageSize);
+		for (iii=0; iii<entryCnt; iii++)
+		{
+			if ((query->oldestFirst && (entries[iii].seq <= lastSeq)) ||
+				((query->oldestFirst == false) && (entries[iii].seq >= lastSeq)))
+			{
+				*inOrder	=	false;
+			}
+			lastSeq	=	entries[iii].seq;
+		}
+		fileCnt			+=	entryCnt;
+		query->cursor	=	query->nextCursor;
+	} while (query->nextCursor != 0);
+	return(fileCnt);
+}
+
+//*****************************************************************************
+//*	average time for one page at the start and at the end of the index
+//*****************************************************************************
+static void	TimePages(const int fileCnt)
+{
+TYPE_FILE_INDEX_QUERY	query;
+TYPE_FILE_INDEX_ENTRY	entries[kTestPageSize];
+double					startMicroSecs;
+double					firstPage_us;
+double					lastPage_us;
+int						iii;
+
+	memset(&query, 0, sizeof(query));
+	query.fileType	=	kFileType_FITS;
+	query.limit		=	kTestPageSize;
+
+	startMicroSecs	=	GetMicroSecs();
+	for (iii=0; iii<1000; iii++)
+	{
+		query.cursor	=	0;
+		FileIndex_Query(&query, entries, kTestPageSize);
+	}
+	firstPage_us	=	(GetMicroSecs() - startMicroSecs) / 1000;
+
+	startMicroSecs	=	GetMicroSecs();
+	for (iii=0; iii<1000; iii++)
+	{
+		query.cursor	=	gFInextSeq - (kTestPageSize * 2);
+		FileIndex_Query(&query, entries, kTestPageSize);
+	}
+	lastPage_us		=	(GetMicroSecs() - startMicroSecs) / 1000;
+	printf("%6d files, FITS page of %d: first %6.1f us, last %6.1f us\r\n", fileCnt, kTestPageSize, firstPage_us, lastPage_us);
+}
+
+//*****************************************************************************
+int main(void)
+{
+TYPE_FILE_INDEX_QUERY	query;
+TYPE_FILE_INDEX_ENTRY	entries[kTestPageSize];
+char					fileName[64];
+time_t					baseTime;
+double					startMicroSecs;
+int						fileCnt;
+int						entryCnt;
+int						testSize;
+int						fitsCnt;
+int						pngCnt;
+int						iii;
+bool					inOrder;
+const char				*extensions[]	=	{"fits", "fits", "fits", "jpg", "png", "csv"};
+
+	mkdir(kTestDir, 0755);
+	baseTime	=	time(NULL) - 100000;
+
+	for (testSize=1000; testSize<=64000; testSize *= 4)
+	{
+		EmptyDirectory();
+		fitsCnt	=	0;
+		pngCnt	=	0;
+		//*	created in the opposite order of their time stamps, the index has to sort them
+		for (iii=testSize - 1; iii>=0; iii--)
+		{
+			sprintf(fileName, "img%06d.%s", iii, extensions[iii % 6]);
+			fitsCnt	+=	((iii % 6) < 3) ? 1 : 0;
+			pngCnt	+=	((iii % 6) == 4) ? 1 : 0;
+			MakeFile(fileName, 10 + (iii % 7), baseTime + iii);
+		}
+		startMicroSecs	=	GetMicroSecs();
+		Check(FileIndex_Open(kTestDir), "FileIndex_Open");
+		printf("%6d files, open (scan) %8.1f ms\r\n", testSize, (GetMicroSecs() - startMicroSecs) / 1000.0);
+
+		//*	everything, newest first (the default)
+		memset(&query, 0, sizeof(query));
+		query.fileType	=	kFileType_Any;
+		fileCnt			=	PageThrough(&query, &inOrder);
+		Check(fileCnt == testSize,				"paging newest first returned every file");
+		Check(inOrder,							"paging newest first order");
+		query.cursor	=	0;
+		query.limit		=	1;
+		FileIndex_Query(&query, entries, 1);
+		sprintf(fileName, "img%06d.%s", (testSize - 1), extensions[(testSize - 1) % 6]);
+		Check(strcmp(entries[0].fileName, fileName) == 0, "newest file first");
+
+		//*	newest first time range, files 100 to 299
+		query.startTime	=	baseTime + 100;
+		query.endTime	=	baseTime + 299;
+		fileCnt			=	PageThrough(&query, &inOrder);
+		Check(fileCnt == 200,					"newest first time range");
+		query.startTime	=	0;
+		query.endTime	=	0;
+
+		//*	everything, oldest first
+		query.oldestFirst	=	true;
+		fileCnt			=	PageThrough(&query, &inOrder);
+		Check(fileCnt == testSize,				"paging returned every file");
+		Check(inOrder,							"paging order");
+		Check(query.totalCnt == testSize,		"totalCnt");
+		query.cursor	=	0;
+		query.limit		=	1;
+		FileIndex_Query(&query, entries, 1);
+		Check(strcmp(entries[0].fileName, "img000000.fits") == 0, "oldest file first");
+
+		//*	type filter
+		query.fileType	=	kFileType_FITS;
+		fileCnt			=	PageThrough(&query, &inOrder);
+		Check(fileCnt == fitsCnt,				"fits filter");
+		query.fileType	=	kFileType_PNG;
+		fileCnt			=	PageThrough(&query, &inOrder);
+		Check(fileCnt == pngCnt,				"png filter");
+
+		//*	time range, files 100 to 299
+		query.fileType	=	kFileType_Any;
+		query.startTime	=	baseTime + 100;
+		query.endTime	=	baseTime + 299;
+		fileCnt			=	PageThrough(&query, &inOrder);
+		Check(fileCnt == 200,					"time range");
+		query.startTime	=	0;
+		query.endTime	=	0;
+
+		TimePages(testSize);
+
+		//*	new, re-written and deleted files
+		MakeFile("new.fits", 100, 0);
+		Check(WaitForCount(kFileType_Any, testSize + 1), "new file seen");
+		FileIndex_SetInfo("new.fits", "test", "100x100 RAW16");
+		query.fileType	=	kFileType_FITS;
+		query.cursor	=	gFInextSeq - 1;
+		query.limit		=	kTestPageSize;
+		entryCnt		=	FileIndex_Query(&query, entries, kTestPageSize);
+		Check((entryCnt == 1) && (strcmp(entries[0].summary, "100x100 RAW16") == 0), "summary");
+
+		MakeFile("img000000.fits", 500, 0);
+		usleep(100000);
+		query.fileType	=	kFileType_Any;
+		query.cursor	=	0;
+		query.limit		=	1;
+		FileIndex_Query(&query, entries, 1);
+		Check(strcmp(entries[0].fileName, "img000001.fits") == 0, "re-written file moved to the end");
+		Check(FileIndex_GetCount(kFileType_Any) == (testSize + 1), "re-written file counted once");
+
+		EmptyDirectory();
+		Check(WaitForCount(kFileType_Any, 0), "deleted files removed");
+		query.cursor	=	0;
+		query.limit		=	kTestPageSize;
+		Check(FileIndex_Query(&query, entries, kTestPageSize) == 0, "empty after delete");
+
+		FileIndex_Close();
+	}
+	rmdir(kTestDir);
+	printf("Failures = %d\r\n", gFailures);
+	return(gFailures);
+}
+#endif // _INCLUDE_FILE_INDEX_MAIN_
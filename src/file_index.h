@@ -0,0 +1,89 @@
+//*****************************************************************************
+//#include	"file_index.h"
+
+#ifndef _FILE_INDEX_H_
+#define	_FILE_INDEX_H_
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+#include	<time.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define	kFileIndex_MaxNameLen		128
+#define	kFileIndex_MaxCommentLen	48
+#define	kFileIndex_MaxSummaryLen	160
+#define	kFileIndex_MaxPageSize		1000
+
+//*****************************************************************************
+enum
+{
+	kFileType_FITS	=	0,
+	kFileType_JPEG,
+	kFileType_PNG,
+	kFileType_CSV,
+	kFileType_Video,
+	kFileType_Text,
+	kFileType_Other,
+
+	kFileType_Cnt
+};
+#define	kFileType_Any	(-1)
+
+//*****************************************************************************
+typedef struct	//	TYPE_FILE_INDEX_ENTRY
+{
+	uint32_t	seq;								//*	the order files were added, used as the cursor
+	int			fileType;
+	int64_t		fileSize;
+	time_t		fileTime;							//*	modification time
+	char		fileName[kFileIndex_MaxNameLen];
+	char		comment[kFileIndex_MaxCommentLen];	//*	from AddToDataProductsList()
+	char		summary[kFileIndex_MaxSummaryLen];	//*	FITS header summary
+} TYPE_FILE_INDEX_ENTRY;
+
+//*****************************************************************************
+//*	files are returned newest first, a page starts at the last file with a
+//*	seq <= cursor. With oldestFirst a page starts at the first file with a
+//*	seq >= cursor. Pass nextCursor back in to get the next page.
+typedef struct	//	TYPE_FILE_INDEX_QUERY
+{
+	uint32_t	cursor;			//*	0 = from the newest (or oldest) file
+	bool		oldestFirst;	//*	false = newest first
+	int			fileType;		//*	kFileType_Any for all types
+	time_t		startTime;		//*	0 = no limit
+	time_t		endTime;		//*	0 = no limit
+	int			limit;			//*	max entries to return
+
+	//*	returned
+	uint32_t	nextCursor;		//*	0 if this was the last page
+	int			totalCnt;		//*	files of this type in the index (ignores the time range)
+} TYPE_FILE_INDEX_QUERY;
+
+
+bool		FileIndex_Open(const char *dirPath);
+void		FileIndex_Close(void);
+bool		FileIndex_IsOpen(void);
+void		FileIndex_SetInfo(		const char				*fileName,
+									const char				*comment,
+									const char				*summary);
+int			FileIndex_Query(		TYPE_FILE_INDEX_QUERY	*query,
+									TYPE_FILE_INDEX_ENTRY	*entries,
+									const int				maxEntries);
+int			FileIndex_GetCount(const int fileType);
+int			FileIndex_GetTypeFromName(const char *fileName);
+int			FileIndex_GetTypeFromString(const char *typeString);
+const char	*FileIndex_GetTypeName(const int fileType);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _FILE_INDEX_H_
@@ -48,6 +48,8 @@
 //*	May 17,	2024	<MLS> Added http error 400 to Put_Position()
 //*	May 17,	2024	<MLS> CONFORMU-filterwheel -> PASSED!!!!!!!!!!!!!!
 //*	Jun 28,	2024	<MLS> Removed all "if (reqData != NULL)" from filterwheeldriver.cpp
+//*	Oct 18,	2026	<MLS> RunStateMachine() now keeps the position current for PublishStateSnapshot()
+//*	Oct 18,	2026	<MLS> The hardware is only polled while the wheel is moving
 //*****************************************************************************
 
 #if defined(_ENABLE_FILTERWHEEL_) || defined(_ENABLE_FILTERWHEEL_ZWO_) || defined(_ENABLE_FILTERWHEEL_ATIK_)
@@ -64,6 +66,7 @@
 
 #include	"alpaca_defs.h"
 #include	"alpacadriver.h"
+#include	"devicestate_snapshot.h"
 #include	"alpacadriver_helper.h"
 #include	"helper_functions.h"
 #include	"JsonResponse.h"
@@ -474,7 +477,8 @@ int					curState;
 int					myFilterPosition;
 
 //	CONSOLE_DEBUG(__FUNCTION__);
-	curState		=	Read_CurrentFWstate();
+	curState					=	Read_CurrentFWstate();
+	cFilterWheelProp.IsMoving	=	(curState == kFilterWheelState_Moving);
 	if (curState == kFilterWheelState_Moving)
 	{
 		//*	https://ascom-standards.org/Help/Developer/html/P_ASCOM_DriverAccess_FilterWheel_Position.htm
@@ -559,6 +563,9 @@ char				commentString[128];
 				if (alpacaErrCode == 0)
 				{
 					cFilterWheelProp.Position	=	newPosition;
+					//*	RunStateMachine() follows the move until the wheel stops
+					cFilterWheelProp.IsMoving	=	true;
+					cLastUpdate_milliSecs		=	millis();
 				}
 				else
 				{
@@ -719,7 +726,53 @@ bool		isConnected;
 //*****************************************************************************
 int32_t	FilterwheelDriver::RunStateMachine(void)
 {
-	return(5 * 1000 * 1000);
+uint32_t	currentMilliSecs;
+uint32_t	deltaMilliSecs;
+int32_t		delayMicroSecs;
+
+	//*	keep the position current for the state snapshot.
+	//*	The wheel only moves when we tell it to, so there is nothing to poll
+	//*	unless a move is in progress, that keeps the USB traffic down
+	delayMicroSecs	=	5 * 1000 * 1000;
+	if (cFilterWheelProp.IsMoving)
+	{
+		currentMilliSecs	=	millis();
+		deltaMilliSecs		=	currentMilliSecs - cLastUpdate_milliSecs;
+		if (deltaMilliSecs > 500)
+		{
+			cFilterWheelProp.IsMoving	=	(Read_CurrentFWstate() == kFilterWheelState_Moving);
+			if (cFilterWheelProp.IsMoving == false)
+			{
+				Read_CurrentFilterPositon();
+			}
+			cLastUpdate_milliSecs	=	currentMilliSecs;
+		}
+		delayMicroSecs	=	100 * 1000;
+	}
+	return(delayMicroSecs);
+}
+
+//*****************************************************************************
+//*	publish the current state for other devices, see devicestate_snapshot.c
+//*****************************************************************************
+void	FilterwheelDriver::PublishStateSnapshot(void)
+{
+TYPE_DeviceSnapshot	fwSnapshot;
+int					filterPosition;
+
+	memset(&fwSnapshot, 0, sizeof(TYPE_DeviceSnapshot));
+	filterPosition							=	cFilterWheelProp.Position;
+	fwSnapshot.deviceType					=	kDeviceType_Filterwheel;
+	fwSnapshot.alpacaDevNum					=	cAlpacaDeviceNum;
+	fwSnapshot.dev.filterwheel.Position		=	filterPosition;
+	fwSnapshot.dev.filterwheel.IsMoving		=	cFilterWheelProp.IsMoving;
+	if ((filterPosition >= 0) && (filterPosition < kMaxFiltersPerWheel))
+	{
+		strncpy(fwSnapshot.dev.filterwheel.FilterName,	cFilterWheelProp.Names[filterPosition].FilterName,	(kSnapshotStrLen - 1));
+	}
+	strncpy(fwSnapshot.dev.filterwheel.Name,			cCommonProp.Name,	(kSnapshotStrLen - 1));
+	strncpy(fwSnapshot.dev.filterwheel.SerialNumber,	cDeviceSerialNum,	(kSnapshotStrLen - 1));
+	DeviceSnapshot_Publish(&fwSnapshot);
 }
 
 //*****************************************************************************
@@ -51,6 +51,7 @@ class FilterwheelDriver: public AlpacaDriver
 		virtual	void				OutputHTML(TYPE_GetPutRequestData *reqData);
 //		virtual	void				OutputHTML_Part2(TYPE_GetPutRequestData *reqData);
 		virtual	int32_t				RunStateMachine(void);
+		virtual	void				PublishStateSnapshot(void);
 		virtual bool				GetCmdNameFromMyCmdTable(const int cmdNumber, char *comandName, char *getPut);
 
 
@@ -0,0 +1,463 @@
+//*****************************************************************************
+//*	Name:			fits_hdrcache.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Cache of generated FITS headers for the recent frames
+//*
+//*	Generating a header goes through cfitsio and all of the WriteFITS_xxx()
+//*	routines, that is done once per frame and the result is kept here as the
+//*	2880 byte blocks that go into the file (80 character cards, END, padded
+//*	with spaces). The json for the fitsheader command is made at the same time.
+//*
+//*	The fitsheader command, the FITS writer and the web page all get the header
+//*	from here. A header is reference counted, a reader can keep using it after a
+//*	newer frame pushes it out of the cache.
+//*
+//*	This file does not use cfitsio, the camera driver fills in the cards.
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Re-distributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 18,	2026	<MLS> Created fits_hdrcache.c
+//*	Oct 18,	2026	<MLS> Added block format and serve time test (_INCLUDE_FITS_HDRCACHE_MAIN_)
+//*	Oct 18,	2026	<MLS> Added requiredCnt to TYPE_FITS_HDR
+//*****************************************************************************
+
+#ifdef _INCLUDE_FITS_HDRCACHE_MAIN_
+	#define	_ENABLE_FITS_
+#endif
+
+#ifdef _ENABLE_FITS_
+
+#include	<stdbool.h>
+#include	<stdint.h>
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	<pthread.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"fits_hdrcache.h"
+
+//*****************************************************************************
+TYPE_FITS_HDR_CACHE	*FitsHdrCache_Create(void)
+{
+TYPE_FITS_HDR_CACHE	*hdrCache;
+
+	hdrCache	=	(TYPE_FITS_HDR_CACHE *)calloc(1, sizeof(TYPE_FITS_HDR_CACHE));
+	if (hdrCache != NULL)
+	{
+		pthread_mutex_init(&hdrCache->mutex, NULL);
+		pthread_mutex_init(&hdrCache->buildMutex, NULL);
+	}
+	return(hdrCache);
+}
+
+//*****************************************************************************
+static void	FitsHdr_Free(TYPE_FITS_HDR *fitsHdr)
+{
+	if (fitsHdr->jsonText != NULL)
+	{
+		free(fitsHdr->jsonText);
+	}
+	free(fitsHdr);
+}
+
+//*****************************************************************************
+//*	the mutex has to be locked
+//*****************************************************************************
+static void	FitsHdr_Unref(TYPE_FITS_HDR *fitsHdr)
+{
+	fitsHdr->refCnt--;
+	if (fitsHdr->refCnt <= 0)
+	{
+		FitsHdr_Free(fitsHdr);
+	}
+}
+
+//*****************************************************************************
+void	FitsHdrCache_Delete(TYPE_FITS_HDR_CACHE *hdrCache)
+{
+int		iii;
+
+	if (hdrCache != NULL)
+	{
+		pthread_mutex_lock(&hdrCache->mutex);
+		for (iii=0; iii<kFitsHdrCache_FrameCnt; iii++)
+		{
+			if (hdrCache->frames[iii] != NULL)
+			{
+				FitsHdr_Unref(hdrCache->frames[iii]);
+				hdrCache->frames[iii]	=	NULL;
+			}
+		}
+		pthread_mutex_unlock(&hdrCache->mutex);
+		pthread_mutex_destroy(&hdrCache->mutex);
+		pthread_mutex_destroy(&hdrCache->buildMutex);
+		free(hdrCache);
+	}
+}
+
+//*****************************************************************************
+bool	FitsHdrCache_HasFrame(TYPE_FITS_HDR_CACHE *hdrCache, const uint32_t frameNum)
+{
+bool	hasFrame;
+int		iii;
+
+	hasFrame	=	false;
+	pthread_mutex_lock(&hdrCache->mutex);
+	for (iii=0; iii<kFitsHdrCache_FrameCnt; iii++)
+	{
+		if ((hdrCache->frames[iii] != NULL) && (hdrCache->frames[iii]->frameNum == frameNum))
+		{
+			hasFrame	=	true;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&hdrCache->mutex);
+	return(hasFrame);
+}
+
+//*****************************************************************************
+//*	the cache takes over the reference from FitsHdr_New().
+//*	A header for a frame that is already there replaces it.
+//*****************************************************************************
+void	FitsHdrCache_Publish(TYPE_FITS_HDR_CACHE *hdrCache, TYPE_FITS_HDR *fitsHdr)
+{
+int		iii;
+int		slotIdx;
+
+	pthread_mutex_lock(&hdrCache->mutex);
+	hdrCache->buildCnt++;
+	slotIdx	=	kFitsHdrCache_FrameCnt - 1;
+	for (iii=0; iii<kFitsHdrCache_FrameCnt; iii++)
+	{
+		if ((hdrCache->frames[iii] != NULL) && (hdrCache->frames[iii]->frameNum == fitsHdr->frameNum))
+		{
+			slotIdx	=	iii;
+			break;
+		}
+	}
+	if (hdrCache->frames[slotIdx] != NULL)
+	{
+		FitsHdr_Unref(hdrCache->frames[slotIdx]);
+	}
+	//*	slide the older ones down, the new one goes in front
+	for (iii=slotIdx; iii>0; iii--)
+	{
+		hdrCache->frames[iii]	=	hdrCache->frames[iii - 1];
+	}
+	hdrCache->frames[0]	=	fitsHdr;
+	pthread_mutex_unlock(&hdrCache->mutex);
+}
+
+//*****************************************************************************
+//*	returns NULL if the frame is not in the cache,
+//*	FitsHdrCache_Release() has to be called when done with it
+//*****************************************************************************
+TYPE_FITS_HDR	*FitsHdrCache_Acquire(TYPE_FITS_HDR_CACHE *hdrCache, const uint32_t frameNum)
+{
+TYPE_FITS_HDR	*fitsHdr;
+int				iii;
+
+	fitsHdr	=	NULL;
+	pthread_mutex_lock(&hdrCache->mutex);
+	for (iii=0; iii<kFitsHdrCache_FrameCnt; iii++)
+	{
+		if ((hdrCache->frames[iii] != NULL) &&
+			((frameNum == kFitsHdr_Newest) || (hdrCache->frames[iii]->frameNum == frameNum)))
+		{
+			fitsHdr	=	hdrCache->frames[iii];
+			fitsHdr->refCnt++;
+			hdrCache->hitCnt++;
+			break;
+		}
+	}
+	pthread_mutex_unlock(&hdrCache->mutex);
+	return(fitsHdr);
+}
+
+//*****************************************************************************
+void	FitsHdrCache_Release(TYPE_FITS_HDR_CACHE *hdrCache, TYPE_FITS_HDR *fitsHdr)
+{
+	if (fitsHdr != NULL)
+	{
+		pthread_mutex_lock(&hdrCache->mutex);
+		FitsHdr_Unref(fitsHdr);
+		pthread_mutex_unlock(&hdrCache->mutex);
+	}
+}
+
+//*****************************************************************************
+TYPE_FITS_HDR	*FitsHdr_New(const uint32_t frameNum)
+{
+TYPE_FITS_HDR	*fitsHdr;
+
+	fitsHdr	=	(TYPE_FITS_HDR *)calloc(1, sizeof(TYPE_FITS_HDR));
+	if (fitsHdr != NULL)
+	{
+		fitsHdr->frameNum	=	frameNum;
+		fitsHdr->refCnt		=	1;
+	}
+	return(fitsHdr);
+}
+
+//*****************************************************************************
+//*	the card is padded with spaces to 80 characters, END is added by FitsHdr_Finish()
+//*****************************************************************************
+bool	FitsHdr_AddCard(TYPE_FITS_HDR *fitsHdr, const char *cardText)
+{
+char	*cardPtr;
+size_t	cardLen;
+
+	if (strcmp(cardText, "END") == 0)
+	{
+		return(true);
+	}
+	//*	leave room for END
+	if (fitsHdr->cardCnt >= (kFitsHdr_MaxCards - 1))
+	{
+		CONSOLE_DEBUG("Too many FITS header cards");
+		return(false);
+	}
+	cardPtr	=	&fitsHdr->blocks[fitsHdr->cardCnt * kFitsHdr_CardLen];
+	cardLen	=	strnlen(cardText, kFitsHdr_CardLen);
+	memcpy(cardPtr, cardText, cardLen);
+	memset(&cardPtr[cardLen], ' ', (kFitsHdr_CardLen - cardLen));
+	fitsHdr->cardCnt++;
+	return(true);
+}
+
+//*****************************************************************************
+//*	card text without the trailing spaces, cardText has to hold kFitsHdr_CardLen + 1
+//*****************************************************************************
+void	FitsHdr_GetCard(const TYPE_FITS_HDR *fitsHdr, const int cardIdx, char *cardText)
+{
+int		cardLen;
+
+	cardLen	=	0;
+	if ((cardIdx >= 0) && (cardIdx < fitsHdr->cardCnt))
+	{
+		memcpy(cardText, &fitsHdr->blocks[cardIdx * kFitsHdr_CardLen], kFitsHdr_CardLen);
+		cardLen	=	kFitsHdr_CardLen;
+		while ((cardLen > 0) && (cardText[cardLen - 1] == ' '))
+		{
+			cardLen--;
+		}
+	}
+	cardText[cardLen]	=	0;
+}
+
+//*****************************************************************************
+//*	adds END, pads out the last block and makes the json,
+//*	the same lines Get_FitsHeader() always sent
+//*****************************************************************************
+void	FitsHdr_Finish(TYPE_FITS_HDR *fitsHdr)
+{
+char	cardText[kFitsHdr_CardLen + 1];
+char	*jsonPtr;
+size_t	usedLen;
+int		cardIdx;
+int		ccc;
+
+	FitsHdr_AddCard(fitsHdr, "END   ");
+	usedLen				=	fitsHdr->cardCnt * kFitsHdr_CardLen;
+	fitsHdr->blockLen	=	((usedLen + kFitsHdr_BlockLen - 1) / kFitsHdr_BlockLen) * kFitsHdr_BlockLen;
+	memset(&fitsHdr->blocks[usedLen], ' ', (fitsHdr->blockLen - usedLen));
+
+	//*	worst case every character is escaped
+	fitsHdr->jsonText	=	(char *)malloc((fitsHdr->cardCnt * ((kFitsHdr_CardLen * 2) + 4)) + 32);
+	if (fitsHdr->jsonText != NULL)
+	{
+		jsonPtr		=	fitsHdr->jsonText;
+		*jsonPtr++	=	'\n';
+		//*	END is not in the json, the old code did not have it either
+		for (cardIdx=0; cardIdx < (fitsHdr->cardCnt - 1); cardIdx++)
+		{
+			FitsHdr_GetCard(fitsHdr, cardIdx, cardText);
+			*jsonPtr++	=	'"';
+			for (ccc=0; cardText[ccc] != 0; ccc++)
+			{
+				if ((cardText[ccc] == '"') || (cardText[ccc] == '\\'))
+				{
+					*jsonPtr++	=	'\\';
+				}
+				*jsonPtr++	=	cardText[ccc];
+			}
+			*jsonPtr++	=	'"';
+			*jsonPtr++	=	',';
+			*jsonPtr++	=	'\n';
+		}
+		strcpy(jsonPtr, "\"----------\"\n");
+		fitsHdr->jsonLen	=	strlen(fitsHdr->jsonText);
+	}
+}
+
+#endif // _ENABLE_FITS_
+
+
+#ifdef _INCLUDE_FITS_HDRCACHE_MAIN_
+//*****************************************************************************
+//*	Checks the block layout and the cache, then times what the fitsheader
+//*	command does for each request: acquire, copy the json out in pieces the
+//*	way JsonResponse_Add_RawText() gets them, release.
+//*
+//*	gcc -O2 -D_INCLUDE_FITS_HDRCACHE_MAIN_ -I../src_mlsLib fits_hdrcache.c -lpthread -o fitshdrtest
+//*****************************************************************************
+#include	<sys/time.h>
+
+#define	kTestCardCnt	180
+#define	kTestRequests	100000
+#define	kJsonChunkLen	4000
+#define	kJsonBuffLen	(10 * 1024)
+
+static int	gFailures	=	0;
+
+//*****************************************************************************
+static void	Check(const bool condition, const char *message)
+{
+	if (condition == false)
+	{
+		printf("FAILED: %s\r\n", message);
+		gFailures++;
+	}
+}
+
+//*****************************************************************************
+static double	GetMicroSecs(void)
+{
+struct timeval	timeValue;
+
+	gettimeofday(&timeValue, NULL);
+	return((timeValue.tv_sec * 1000000.0) + timeValue.tv_usec);
+}
+
+//*****************************************************************************
+static TYPE_FITS_HDR	*MakeHeader(const uint32_t frameNum)
+{
+TYPE_FITS_HDR	*fitsHdr;
+char			cardText[128];
+int				iii;
+
+	fitsHdr	=	FitsHdr_New(frameNum);
+	FitsHdr_AddCard(fitsHdr, "SIMPLE  =                    T / file does conform to FITS standard");
+	for (iii=1; iii<kTestCardCnt; iii++)
+	{
+		sprintf(cardText, "KEY%-5d= %20u / frame \"%u\" card %d", iii, frameNum, frameNum, iii);
+		FitsHdr_AddCard(fitsHdr, cardText);
+	}
+	FitsHdr_Finish(fitsHdr);
+	return(fitsHdr);
+}
+
+//*****************************************************************************
+int main(void)
+{
+TYPE_FITS_HDR_CACHE	*hdrCache;
+TYPE_FITS_HDR		*fitsHdr;
+char				cardText[kFitsHdr_CardLen + 1];
+char				chunkBuff[kJsonChunkLen + 1];
+char				*jsonBuff;
+double				startMicroSecs;
+double				serve_us;
+size_t				offset;
+size_t				chunkLen;
+uint32_t			frameNum;
+int					iii;
+
+	hdrCache	=	FitsHdrCache_Create();
+	jsonBuff	=	(char *)malloc(kJsonBuffLen);
+
+	//*	block layout
+	fitsHdr	=	MakeHeader(1);
+	Check(fitsHdr->cardCnt == (kTestCardCnt + 1),						"card count includes END");
+	Check((fitsHdr->blockLen % kFitsHdr_BlockLen) == 0,				"whole blocks");
+	Check(fitsHdr->blockLen == (6 * kFitsHdr_BlockLen),				"181 cards is 6 blocks");
+	Check(memcmp(&fitsHdr->blocks[kTestCardCnt * kFitsHdr_CardLen], "END     ", 8) == 0, "END card");
+	Check(fitsHdr->blocks[fitsHdr->blockLen - 1] == ' ',				"padded with spaces");
+	Check(memchr(fitsHdr->blocks, 0, fitsHdr->blockLen) == NULL,		"no nulls in the blocks");
+	FitsHdr_GetCard(fitsHdr, 0, cardText);
+	Check(strcmp(cardText, "SIMPLE  =                    T / file does conform to FITS standard") == 0, "card text");
+	Check(strstr(fitsHdr->jsonText, "\\\"1\\\"") != NULL,				"quotes escaped in json");
+	Check(strstr(fitsHdr->jsonText, "END") == NULL,						"no END in json");
+	FitsHdrCache_Publish(hdrCache, fitsHdr);
+
+	//*	the cache keeps the last kFitsHdrCache_FrameCnt frames
+	for (frameNum=2; frameNum<=6; frameNum++)
+	{
+		FitsHdrCache_Publish(hdrCache, MakeHeader(frameNum));
+	}
+	Check(FitsHdrCache_HasFrame(hdrCache, 2) == false,	"oldest frame dropped");
+	Check(FitsHdrCache_HasFrame(hdrCache, 3),			"frame 3 kept");
+	fitsHdr	=	FitsHdrCache_Acquire(hdrCache, kFitsHdr_Newest);
+	Check((fitsHdr != NULL) && (fitsHdr->frameNum == 6),	"newest frame");
+
+	//*	a reader keeps its header after it is pushed out
+	for (frameNum=7; frameNum<=12; frameNum++)
+	{
+		FitsHdrCache_Publish(hdrCache, MakeHeader(frameNum));
+	}
+	Check(FitsHdrCache_HasFrame(hdrCache, 6) == false,	"frame 6 dropped");
+	FitsHdr_GetCard(fitsHdr, 1, cardText);
+	Check(strstr(cardText, "\"6\"") != NULL,				"acquired header still good");
+	FitsHdrCache_Release(hdrCache, fitsHdr);
+
+	//*	replacing a frame
+	FitsHdrCache_Publish(hdrCache, MakeHeader(11));
+	Check(FitsHdrCache_HasFrame(hdrCache, 9),			"replace did not drop a frame");
+
+	//*	serve time
+	startMicroSecs	=	GetMicroSecs();
+	for (iii=0; iii<kTestRequests; iii++)
+	{
+		fitsHdr		=	FitsHdrCache_Acquire(hdrCache, kFitsHdr_Newest);
+		jsonBuff[0]	=	0;
+		offset		=	0;
+		while (offset < fitsHdr->jsonLen)
+		{
+			chunkLen	=	fitsHdr->jsonLen - offset;
+			if (chunkLen > kJsonChunkLen)
+			{
+				chunkLen	=	kJsonChunkLen;
+			}
+			memcpy(chunkBuff, &fitsHdr->jsonText[offset], chunkLen);
+			chunkBuff[chunkLen]	=	0;
+			if ((strlen(jsonBuff) + chunkLen) >= kJsonBuffLen)
+			{
+				jsonBuff[0]	=	0;		//*	this is where it would be sent
+			}
+			strcat(jsonBuff, chunkBuff);
+			offset	+=	chunkLen;
+		}
+		FitsHdrCache_Release(hdrCache, fitsHdr);
+	}
+	serve_us	=	(GetMicroSecs() - startMicroSecs) / kTestRequests;
+	printf("%d cards, %lu bytes of blocks, %lu bytes of json, %1.2f us per request\r\n",
+								(kTestCardCnt + 1),
+								(unsigned long)hdrCache->frames[0]->blockLen,
+								(unsigned long)strlen(hdrCache->frames[0]->jsonText),
+								serve_us);
+	Check(serve_us < 50.0, "served in microseconds");
+
+	FitsHdrCache_Delete(hdrCache);
+	free(jsonBuff);
+	printf("Failures = %d\r\n", gFailures);
+	return(gFailures);
+}
+#endif // _INCLUDE_FITS_HDRCACHE_MAIN_
@@ -0,0 +1,72 @@
+//*****************************************************************************
+//#include	"fits_hdrcache.h"
+
+#ifndef _FITS_HDRCACHE_H_
+#define	_FITS_HDRCACHE_H_
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+#include	<stddef.h>
+#include	<pthread.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define	kFitsHdr_CardLen			80
+#define	kFitsHdr_BlockLen			2880
+#define	kFitsHdr_CardsPerBlock		(kFitsHdr_BlockLen / kFitsHdr_CardLen)
+#define	kFitsHdr_MaxBlocks			10
+#define	kFitsHdr_MaxCards			(kFitsHdr_MaxBlocks * kFitsHdr_CardsPerBlock)
+#define	kFitsHdrCache_FrameCnt		4				//*	the current frame and the ones before it
+#define	kFitsHdr_Newest				0xFFFFFFFF		//*	frameNum for FitsHdrCache_Acquire()
+
+//*****************************************************************************
+//*	one header, exactly the way it goes into the file, plus the json for the
+//*	fitsheader command. Nothing in it changes after FitsHdr_Finish()
+typedef struct	//	TYPE_FITS_HDR
+{
+	uint32_t	frameNum;
+	int			cardCnt;						//*	including END
+	int			requiredCnt;					//*	the cards from fits_create_img() at the start, a new file already has them
+	int			refCnt;
+	bool		fromSavedFile;					//*	read back from a saved file, has FILENAME, CHECKSUM etc
+	size_t		blockLen;						//*	multiple of kFitsHdr_BlockLen
+	char		blocks[kFitsHdr_MaxBlocks * kFitsHdr_BlockLen];
+	char		*jsonText;						//*	the card strings, json array contents
+	size_t		jsonLen;
+} TYPE_FITS_HDR;
+
+//*****************************************************************************
+typedef struct	//	TYPE_FITS_HDR_CACHE
+{
+	pthread_mutex_t	mutex;
+	pthread_mutex_t	buildMutex;					//*	one header generated at a time
+	TYPE_FITS_HDR	*frames[kFitsHdrCache_FrameCnt];	//*	[0] is the newest
+	uint32_t		hitCnt;
+	uint32_t		buildCnt;
+} TYPE_FITS_HDR_CACHE;
+
+
+TYPE_FITS_HDR_CACHE	*FitsHdrCache_Create(void);
+void				FitsHdrCache_Delete(	TYPE_FITS_HDR_CACHE *hdrCache);
+bool				FitsHdrCache_HasFrame(	TYPE_FITS_HDR_CACHE *hdrCache, const uint32_t frameNum);
+void				FitsHdrCache_Publish(	TYPE_FITS_HDR_CACHE *hdrCache, TYPE_FITS_HDR *fitsHdr);
+TYPE_FITS_HDR		*FitsHdrCache_Acquire(	TYPE_FITS_HDR_CACHE *hdrCache, const uint32_t frameNum);
+void				FitsHdrCache_Release(	TYPE_FITS_HDR_CACHE *hdrCache, TYPE_FITS_HDR *fitsHdr);
+
+TYPE_FITS_HDR		*FitsHdr_New(			const uint32_t frameNum);
+bool				FitsHdr_AddCard(		TYPE_FITS_HDR *fitsHdr, const char *cardText);
+void				FitsHdr_Finish(			TYPE_FITS_HDR *fitsHdr);
+void				FitsHdr_GetCard(		const TYPE_FITS_HDR *fitsHdr, const int cardIdx, char *cardText);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _FITS_HDRCACHE_H_
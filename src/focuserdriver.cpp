@@ -42,9 +42,11 @@
 //*	Oct 20,	2022	<MLS> Added DumpFocuserProperties()
 //*	Nov  4,	2022	<MLS> Added GetCommandArgumentString()
 //*	Nov  8,	2022	<MLS> Fixed bug in JSON for temperatureLog in all drivers.
+//*	Oct 18,	2026	<MLS> Added PublishStateSnapshot()
 //*	Jun 18,	2023	<MLS> Added DeviceState_Add_Content() to focuser driver
 //*	May 17,	2024	<MLS> Added http error 400 processing to focuser driver
 //*	Jun 28,	2024	<MLS> Removed all "if (reqData != NULL)" from focuserdriver.cpp
+//*	Oct 18,	2026	<MLS> Temperature and position are logged to the time series store when they change
 //*****************************************************************************
 
 #ifdef _ENABLE_FOCUSER_
@@ -65,12 +67,14 @@
 #include	"ConsoleDebug.h"
 
 #include	"alpacadriver.h"
+#include	"devicestate_snapshot.h"
 #include	"alpacadriver_helper.h"
 #include	"helper_functions.h"
 
 
 #include	"JsonResponse.h"
 #include	"focuserdriver.h"
+#include	"timeseries_store.h"
 
 #ifdef _ENABLE_FOCUSER_MOONLITE_
 	#include	"focuserdriver_nc.h"
@@ -153,6 +157,8 @@ FocuserDriver::FocuserDriver(void)
 	cFocuserVoltage					=	0.0;
 	cFocuserHasTemperature			=	false;
 	cFocuserProp.Temperature_DegC	=	0.0;
+	cTemperatureChannel				=	kTS_NotRegistered;
+	cPositionChannel				=	kTS_NotRegistered;
 
 	cSwitchIN						=	false;
 	cSwitchOUT						=	false;
@@ -177,6 +183,39 @@ int32_t	FocuserDriver::RunStateMachine(void)
 	return(1000 * 1000);
 }
 
+//*****************************************************************************
+//*	publish the current state for other devices, see devicestate_snapshot.c
+//*****************************************************************************
+void	FocuserDriver::PublishStateSnapshot(void)
+{
+TYPE_DeviceSnapshot	focuserSnapshot;
+bool				prevValid;
+
+	//*	use the previous snapshot to only log values that changed
+	prevValid	=	DeviceSnapshot_Read(kDeviceType_Focuser, cAlpacaDeviceNum, &focuserSnapshot);
+	if ((prevValid == false) || (focuserSnapshot.dev.focuser.Temperature_DegC != cFocuserProp.Temperature_DegC))
+	{
+		TimeSeries_Log(&cTemperatureChannel, "Temperature", cFocuserProp.Temperature_DegC);
+	}
+	if ((prevValid == false) || (focuserSnapshot.dev.focuser.Position != cFocuserProp.Position))
+	{
+		TimeSeries_Log(&cPositionChannel, "Position", cFocuserProp.Position);
+	}
+
+	memset(&focuserSnapshot, 0, sizeof(TYPE_DeviceSnapshot));
+	focuserSnapshot.deviceType						=	kDeviceType_Focuser;
+	focuserSnapshot.alpacaDevNum					=	cAlpacaDeviceNum;
+	focuserSnapshot.dev.focuser.Position			=	cFocuserProp.Position;
+	focuserSnapshot.dev.focuser.IsMoving			=	cFocuserProp.IsMoving;
+	focuserSnapshot.dev.focuser.Temperature_DegC	=	cFocuserProp.Temperature_DegC;
+	focuserSnapshot.dev.focuser.Voltage				=	cFocuserVoltage;
+	strncpy(focuserSnapshot.dev.focuser.Manufacturer,	cDeviceManufacturer,	(kSnapshotStrLen - 1));
+	strncpy(focuserSnapshot.dev.focuser.Model,			cDeviceModel,			(kSnapshotStrLen - 1));
+	strncpy(focuserSnapshot.dev.focuser.Version,		cDeviceVersion,			(kSnapshotStrLen - 1));
+	strncpy(focuserSnapshot.dev.focuser.SerialNumber,	cDeviceSerialNum,		(kSnapshotStrLen - 1));
+	DeviceSnapshot_Publish(&focuserSnapshot);
+}
+
 
 //*****************************************************************************
 bool	FocuserDriver::GetCmdNameFromMyCmdTable(const int cmdNumber, char *comandName, char *getPut)
@@ -41,6 +41,7 @@ class FocuserDriver: public AlpacaDriver
 		virtual	void				OutputHTML(TYPE_GetPutRequestData *reqData);
 		virtual	void				OutputHTML_Part2(TYPE_GetPutRequestData *reqData);
 		virtual	int32_t				RunStateMachine(void);
+		virtual	void				PublishStateSnapshot(void);
 		virtual bool				GetCmdNameFromMyCmdTable(const int cmdNumber, char *comandName, char *getPut);
 		virtual bool				GetCommandArgumentString(const int cmdNumber, char *agumentString, char *commentString);
 
@@ -122,6 +123,8 @@ class FocuserDriver: public AlpacaDriver
 
 
 		bool			cFocuserHasTemperature;
+		int				cTemperatureChannel;	//*	time series channel handles
+		int				cPositionChannel;
 //		double			cFocuserTemp;			//*	degrees C
 		bool			cHasTempComp;
 
@@ -11,6 +11,7 @@
 //*	Apr  9,	2024	<MLS> Created gps_data.cpp
 //*	Apr 26,	2024	<MLS> Started working on gps graph support
 //*	Apr 27,	2024	<MLS> GPS graph working from alpacapi driver
+//*	Oct 18,	2026	<MLS> Added PPS time keeping (GPS_PPS.c), NMEA time labels the PPS edges
 //*****************************************************************************
 
 //#define _ENABLE_GLOBAL_GPS_
@@ -41,6 +42,7 @@
 
 #include	"ParseNMEA.h"
 #include	"NMEA_helper.h"
+#include	"GPS_PPS.h"
 
 #include	"serialport.h"
 #include	"gps_data.h"
@@ -53,6 +55,7 @@
 //===========================================================================
 //*	GPS info
 TYPE_NMEAInfoStruct		gNMEAdata;		//*	from ParseNMEA.h
+TYPE_PPS_STATE			gPPSdata;		//*	from GPS_PPS.h
 
 static pthread_t		gGPSdataThreadID;
 static char				gSerialPortPath[64];
@@ -73,6 +76,8 @@ char		nmeaLineBuff[256];
 struct stat	fileStatus;
 int			returnCode;
 int			gpsSpeed;
+int64_t		readTime_ns;
+long		lastGpsTime;
 //uint32_t	lastGrapicsSave_ms;
 //uint32_t	current_ms;
 //uint32_t	delta_ms;
@@ -124,9 +129,11 @@ int			gpsSpeed;
 	Serial_Set_Blocking(serialFD, true);
 	nmeaSentenceCnt	=	0;
 	ccc				=	0;
+	lastGpsTime		=	-1;
 	while (1)				// receive 25:  approx 100 uS per char transmit
 	{
 		readCnt			=	read(serialFD, buf, kBuffSize);  // read up to 100 characters if ready to read
+		readTime_ns		=	PPS_GetSystemTime_ns();
 		if (readCnt > 0)
 		{
 			buf[readCnt]	=	0;
@@ -148,6 +155,13 @@ int			gpsSpeed;
 						{
 							ParseNMEA_TimeString(&gNMEAdata, nmeaLineBuff, false);
 							ParseNMEAstring(&gNMEAdata, nmeaLineBuff);
+
+							//*	the first sentence with a new time says which second the last PPS edge started
+							if (gNMEAdata.validTime && ((long)gNMEAdata.gpsTime != lastGpsTime))
+							{
+								lastGpsTime	=	gNMEAdata.gpsTime;
+								PPS_LabelSecond(&gPPSdata, readTime_ns, lastGpsTime);
+							}
 						}
 					}
 					ccc	=	0;
@@ -201,6 +215,13 @@ int		threadErr;
 	}
 	//*	save the baud rate indicator
 	gSerialPortSpeedChar	=	baudRateChar;
+
+	//*	the PPS is optional, without it the times come from the system clock
+	PPS_Init(&gPPSdata);
+	if (PPS_StartThread(&gPPSdata, kPPS_DefaultDevice))
+	{
+		CONSOLE_DEBUG_W_STR("PPS time keeping started on", kPPS_DefaultDevice);
+	}
 	threadErr				=	pthread_create(&gGPSdataThreadID, NULL, &GPS_Thread, NULL);
 	if (threadErr != 0)
 	{
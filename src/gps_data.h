@@ -9,6 +9,7 @@
 //*	<MLS>	=	Mark L Sproul
 //*****************************************************************************
 //*	Apr  9,	2024	<MLS> Created gps_data.h
+//*	Oct 18,	2026	<MLS> Added gPPSdata
 //*****************************************************************************
 //#include	"gps_data.h"
 
@@ -18,6 +19,9 @@
 #ifndef _PARSE_NMEA_H_
 	#include	"ParseNMEA.h"
 #endif
+#ifndef _GPS_PPS_H_
+	#include	"GPS_PPS.h"
+#endif
 
 
 void	CreateGPSgraphics(void);
@@ -26,6 +30,7 @@ void	CreateGPSgraphics(void);
 #define		kGPSimageDirectory	"graphs-gps"
 
 extern TYPE_NMEAInfoStruct	gNMEAdata;
+extern TYPE_PPS_STATE		gPPSdata;
 
 #define	kMaxNMEAlen	80
 
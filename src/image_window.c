@@ -0,0 +1,633 @@
+//*****************************************************************************
+//*	Name:			image_window.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	cuts a region of interest out of the last image, with optional
+//*					software binning, so imagearray can send just the part a
+//*					focus/centering/guiding tool asked for.
+//*
+//*	The window is copied a row at a time, each row of the window is contiguous
+//*	in the source so it is one memcpy (bin 1) or one sequential pass per source
+//*	row (binning). The column-major reordering that imagearray needs is then
+//*	done on the small buffer, which fits in cache, instead of striding down the
+//*	columns of the whole sensor.
+//*
+//*	Binning averages the bin x bin block so the result keeps the source data type.
+//*
+//*	ImageWindow_BuildRGB() is the binary rgbarray conversion, it does the
+//*	row major to column major reordering in small tiles.
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Re-distributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 18,	2026	<MLS> Created image_window.c
+//*	Oct 18,	2026	<MLS> Added ImageWindow_BuildRGB()
+//*	Oct 18,	2026	<MLS> ImageWindow_BuildRGB() interleaved color uses PixConv_Transpose24()
+//*	Oct 18,	2026	<MLS> ImageWindow_BuildRGB() dropped planar, 16 bit data stays 16 bits
+//*****************************************************************************
+
+#include	<stdbool.h>
+#include	<stdint.h>
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"image_window.h"
+#include	"pixel_convert.h"
+
+//*****************************************************************************
+//*	defaults to the whole image, no binning
+//*****************************************************************************
+void	ImageWindow_Init(TYPE_IMAGE_WINDOW *imgWindow, const int srcWidth, const int srcHeight)
+{
+	memset(imgWindow, 0, sizeof(TYPE_IMAGE_WINDOW));
+	imgWindow->width		=	srcWidth;
+	imgWindow->height		=	srcHeight;
+	imgWindow->bin			=	1;
+	imgWindow->outWidth		=	srcWidth;
+	imgWindow->outHeight	=	srcHeight;
+}
+
+//*****************************************************************************
+static void	AccumulateRow8(	const uint8_t	*srcRow,
+							uint32_t		*accumRow,
+							const int		outWidth,
+							const int		bin,
+							const int		channels)
+{
+int		xxx;
+int		bbb;
+int		ccc;
+
+	for (xxx=0; xxx<outWidth; xxx++)
+	{
+		for (bbb=0; bbb<bin; bbb++)
+		{
+			for (ccc=0; ccc<channels; ccc++)
+			{
+				accumRow[ccc]	+=	*srcRow++;
+			}
+		}
+		accumRow	+=	channels;
+	}
+}
+
+//*****************************************************************************
+static void	AccumulateRow16(const uint16_t	*srcRow,
+							uint32_t		*accumRow,
+							const int		outWidth,
+							const int		bin,
+							const int		channels)
+{
+int		xxx;
+int		bbb;
+int		ccc;
+
+	for (xxx=0; xxx<outWidth; xxx++)
+	{
+		for (bbb=0; bbb<bin; bbb++)
+		{
+			for (ccc=0; ccc<channels; ccc++)
+			{
+				accumRow[ccc]	+=	*srcRow++;
+			}
+		}
+		accumRow	+=	channels;
+	}
+}
+
+//*****************************************************************************
+//*	imgWindow has the requested xStart, yStart, width, height and bin,
+//*	returns false if the window does not fit in the image
+//*****************************************************************************
+bool	ImageWindow_Extract(	TYPE_IMAGE_WINDOW		*imgWindow,
+								const unsigned char		*srcPtr,
+								const int				srcWidth,
+								const int				srcHeight,
+								const int				channels,
+								const int				bytesPerValue)
+{
+const unsigned char	*srcRowPtr;
+unsigned char		*dstRowPtr;
+uint32_t			*accumRow;
+size_t				bytesPerPixel;
+size_t				outRowBytes;
+uint32_t			blockSize;
+int					yyy;
+int					bbb;
+int					iii;
+int					valuesPerRow;
+
+	imgWindow->pixelPtr		=	NULL;
+	imgWindow->ownsBuffer	=	false;
+	imgWindow->channels		=	channels;
+	imgWindow->bytesPerValue	=	bytesPerValue;
+	if ((srcPtr == NULL) ||
+		(imgWindow->bin < 1) || (imgWindow->bin > kImageWindow_MaxBin) ||
+		(imgWindow->xStart < 0) || (imgWindow->yStart < 0) ||
+		(imgWindow->width <= 0) || (imgWindow->height <= 0) ||
+		((imgWindow->xStart + imgWindow->width) > srcWidth) ||
+		((imgWindow->yStart + imgWindow->height) > srcHeight))
+	{
+		return(false);
+	}
+	imgWindow->outWidth		=	imgWindow->width / imgWindow->bin;
+	imgWindow->outHeight	=	imgWindow->height / imgWindow->bin;
+	if ((imgWindow->outWidth <= 0) || (imgWindow->outHeight <= 0))
+	{
+		return(false);
+	}
+
+	//*	the whole frame, nothing to copy
+	if ((imgWindow->xStart == 0) && (imgWindow->yStart == 0) &&
+		(imgWindow->width == srcWidth) && (imgWindow->height == srcHeight) &&
+		(imgWindow->bin == 1))
+	{
+		imgWindow->pixelPtr	=	(unsigned char *)srcPtr;
+		return(true);
+	}
+
+	bytesPerPixel			=	channels * bytesPerValue;
+	outRowBytes				=	imgWindow->outWidth * bytesPerPixel;
+	imgWindow->pixelPtr		=	(unsigned char *)malloc(outRowBytes * imgWindow->outHeight);
+	if (imgWindow->pixelPtr == NULL)
+	{
+		CONSOLE_DEBUG("Failed to allocate image window");
+		return(false);
+	}
+	imgWindow->ownsBuffer	=	true;
+
+	srcRowPtr	=	srcPtr + ((((size_t)imgWindow->yStart * srcWidth) + imgWindow->xStart) * bytesPerPixel);
+	dstRowPtr	=	imgWindow->pixelPtr;
+	if (imgWindow->bin == 1)
+	{
+		for (yyy=0; yyy<imgWindow->outHeight; yyy++)
+		{
+			memcpy(dstRowPtr, srcRowPtr, outRowBytes);
+			srcRowPtr	+=	(size_t)srcWidth * bytesPerPixel;
+			dstRowPtr	+=	outRowBytes;
+		}
+	}
+	else
+	{
+		valuesPerRow	=	imgWindow->outWidth * channels;
+		blockSize		=	imgWindow->bin * imgWindow->bin;
+		accumRow		=	(uint32_t *)malloc(valuesPerRow * sizeof(uint32_t));
+		if (accumRow == NULL)
+		{
+			ImageWindow_Release(imgWindow);
+			return(false);
+		}
+		for (yyy=0; yyy<imgWindow->outHeight; yyy++)
+		{
+			memset(accumRow, 0, valuesPerRow * sizeof(uint32_t));
+			for (bbb=0; bbb<imgWindow->bin; bbb++)
+			{
+				if (bytesPerValue == 2)
+				{
+					AccumulateRow16((const uint16_t *)srcRowPtr, accumRow, imgWindow->outWidth, imgWindow->bin, channels);
+				}
+				else
+				{
+					AccumulateRow8(srcRowPtr, accumRow, imgWindow->outWidth, imgWindow->bin, channels);
+				}
+				srcRowPtr	+=	(size_t)srcWidth * bytesPerPixel;
+			}
+			for (iii=0; iii<valuesPerRow; iii++)
+			{
+				if (bytesPerValue == 2)
+				{
+					((uint16_t *)dstRowPtr)[iii]	=	(accumRow[iii] + (blockSize / 2)) / blockSize;
+				}
+				else
+				{
+					dstRowPtr[iii]	=	(accumRow[iii] + (blockSize / 2)) / blockSize;
+				}
+			}
+			dstRowPtr	+=	outRowBytes;
+		}
+		free(accumRow);
+	}
+	return(true);
+}
+
+//*****************************************************************************
+void	ImageWindow_Release(TYPE_IMAGE_WINDOW *imgWindow)
+{
+	if (imgWindow->ownsBuffer)
+	{
+		free(imgWindow->pixelPtr);
+	}
+	imgWindow->pixelPtr		=	NULL;
+	imgWindow->ownsBuffer	=	false;
+}
+
+//*****************************************************************************
+//*	RGB in ImageBytes (column major) order, [width][height][3], the same
+//*	layout imagearray uses for RGB24.
+//*	channels 3 is the camera BGR buffer, 8 bits per color.
+//*	channels 1 is copied to all 3 colors, 16 bit data stays 16 bits
+//*	(uint16_t out, 6 bytes per pixel).
+//*	A 32x32 tile is 3k of source and 3k of output, so the strided side of the
+//*	transpose stays in L1 instead of missing on every pixel.
+//*****************************************************************************
+void	ImageWindow_BuildRGB(	unsigned char			*outPtr,
+								const unsigned char		*srcPtr,
+								const int				width,
+								const int				height,
+								const int				channels,
+								const int				bytesPerValue)
+{
+const unsigned char	*pixelPtr;
+const uint16_t		*pixel16Ptr;
+unsigned char		*dstPtr;
+uint16_t			*dst16Ptr;
+int					bytesPerPixel;
+int					srcRowBytes;
+int					redOffset;
+int					grnOffset;
+int					bluOffset;
+int					xBlock;
+int					yBlock;
+int					xEnd;
+int					yEnd;
+int					xxx;
+int					yyy;
+
+	if ((channels == 3) && (bytesPerValue == 1))
+	{
+		PixConv_Transpose24(outPtr, srcPtr, width, height, true);
+		return;
+	}
+	bytesPerPixel	=	channels * bytesPerValue;
+	if (channels == 3)
+	{
+		redOffset	=	2;
+		grnOffset	=	1;
+		bluOffset	=	0;
+	}
+	else
+	{
+		redOffset	=	0;
+		grnOffset	=	0;
+		bluOffset	=	0;
+	}
+	srcRowBytes	=	width * bytesPerPixel;
+	for (yBlock=0; yBlock < height; yBlock += kImageWindow_TileSize)
+	{
+		yEnd	=	((yBlock + kImageWindow_TileSize) < height) ? (yBlock + kImageWindow_TileSize) : height;
+		for (xBlock=0; xBlock < width; xBlock += kImageWindow_TileSize)
+		{
+			xEnd	=	((xBlock + kImageWindow_TileSize) < width) ? (xBlock + kImageWindow_TileSize) : width;
+			for (xxx=xBlock; xxx < xEnd; xxx++)
+			{
+				pixelPtr	=	srcPtr + ((size_t)yBlock * srcRowBytes) + ((size_t)xxx * bytesPerPixel);
+				if (bytesPerValue == 2)
+				{
+					dst16Ptr	=	(uint16_t *)outPtr + ((((size_t)xxx * height) + yBlock) * 3);
+					for (yyy=yBlock; yyy < yEnd; yyy++)
+					{
+						pixel16Ptr	=	(const uint16_t *)pixelPtr;
+						dst16Ptr[0]	=	pixel16Ptr[0];
+						dst16Ptr[1]	=	pixel16Ptr[0];
+						dst16Ptr[2]	=	pixel16Ptr[0];
+						dst16Ptr	+=	3;
+						pixelPtr	+=	srcRowBytes;
+					}
+				}
+				else
+				{
+					dstPtr	=	outPtr + ((((size_t)xxx * height) + yBlock) * 3);
+					for (yyy=yBlock; yyy < yEnd; yyy++)
+					{
+						dstPtr[0]	=	pixelPtr[redOffset];
+						dstPtr[1]	=	pixelPtr[grnOffset];
+						dstPtr[2]	=	pixelPtr[bluOffset];
+						dstPtr		+=	3;
+						pixelPtr	+=	srcRowBytes;
+					}
+				}
+			}
+		}
+	}
+}
+
+
+#ifdef _INCLUDE_IMAGE_WINDOW_MAIN_
+//*****************************************************************************
+//*	Download time against ROI size for a 5496x3672 16 bit frame.
+//*	Each case is extract + the column major imagebytes / JSON encoding that
+//*	imagearray does + sending it over a loopback TCP socket.
+//*
+//*	g++ -O2 -x c++ -D_INCLUDE_IMAGE_WINDOW_MAIN_ -I../libs/src_mlsLib image_window.c pixel_convert.c -lpthread -o windowtest
+//*****************************************************************************
+#include	<math.h>
+#include	<time.h>
+#include	<unistd.h>
+#include	<pthread.h>
+#include	<sys/socket.h>
+#include	<netinet/in.h>
+#include	<arpa/inet.h>
+
+#define	kTestWidth		5496
+#define	kTestHeight		3672
+#define	kLinkMbits		100.0
+
+//*****************************************************************************
+static double	GetMilliSecs(void)
+{
+struct timespec	currentTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &currentTime);
+	return((currentTime.tv_sec * 1000.0) + (currentTime.tv_nsec / 1000000.0));
+}
+
+//*****************************************************************************
+static void	*ReaderThread(void *arg)
+{
+int		listenSocket	=	*(int *)arg;
+int		clientSocket;
+char	readBuf[256 * 1024];
+
+	while ((clientSocket = accept(listenSocket, NULL, NULL)) >= 0)
+	{
+		while (read(clientSocket, readBuf, sizeof(readBuf)) > 0)
+		{
+		}
+		close(clientSocket);
+	}
+	return(NULL);
+}
+
+//*****************************************************************************
+static int	OpenLoopback(const int portNum)
+{
+struct sockaddr_in	serverAddr;
+int					sendSocket;
+
+	sendSocket	=	socket(AF_INET, SOCK_STREAM, 0);
+	memset(&serverAddr, 0, sizeof(serverAddr));
+	serverAddr.sin_family		=	AF_INET;
+	serverAddr.sin_port			=	htons(portNum);
+	serverAddr.sin_addr.s_addr	=	htonl(INADDR_LOOPBACK);
+	connect(sendSocket, (struct sockaddr *)&serverAddr, sizeof(serverAddr));
+	return(sendSocket);
+}
+
+//*****************************************************************************
+static void	SendBuffer(const int sendSocket, const char *buffer, size_t bufLen)
+{
+ssize_t	bytesWritten;
+
+	while (bufLen > 0)
+	{
+		bytesWritten	=	write(sendSocket, buffer, bufLen);
+		if (bytesWritten <= 0)
+		{
+			break;
+		}
+		buffer	+=	bytesWritten;
+		bufLen	-=	bytesWritten;
+	}
+}
+
+//*****************************************************************************
+int main(int argc, char *argv[])
+{
+TYPE_IMAGE_WINDOW	imgWindow;
+uint16_t			*image16;
+uint16_t			*window16;
+uint16_t			*binaryData;
+char				*jsonData;
+size_t				jsonLen;
+int					listenSocket;
+int					sendSocket;
+int					portNum;
+int					socketOption;
+struct sockaddr_in	serverAddr;
+socklen_t			addrLen;
+pthread_t			readerThread;
+int					iii;
+int					xxx;
+int					yyy;
+int					ccc;
+int					failCnt;
+uint32_t			blockSum;
+double				startTime_ms;
+double				extract_ms;
+double				binary_ms;
+double				json_ms;
+unsigned char		*imageBGR;
+unsigned char		*rgbRef;
+unsigned char		*rgbOut;
+uint16_t			*rgb16Out;
+size_t				pixelCnt;
+size_t				pixelIdx;
+char				textBuff[32];
+static const int	roiSizes[][2]	=	{	{kTestWidth, 1}, {kTestWidth, 2}, {kTestWidth, 4},
+											{2048, 1}, {1024, 1}, {512, 1}, {256, 1}, {64, 1}	};
+
+	(void)argc;
+	(void)argv;
+	failCnt	=	0;
+	image16	=	(uint16_t *)malloc((size_t)kTestWidth * kTestHeight * sizeof(uint16_t));
+	for (iii=0; iii<(kTestWidth * kTestHeight); iii++)
+	{
+		image16[iii]	=	(uint16_t)((iii * 2654435761U) >> 20);
+	}
+
+	//*	correctness, a 100x80 window at 1001,2002 and a bin 3 window
+	ImageWindow_Init(&imgWindow, kTestWidth, kTestHeight);
+	imgWindow.xStart	=	1001;
+	imgWindow.yStart	=	2002;
+	imgWindow.width		=	100;
+	imgWindow.height	=	80;
+	ImageWindow_Extract(&imgWindow, (unsigned char *)image16, kTestWidth, kTestHeight, 1, 2);
+	window16	=	(uint16_t *)imgWindow.pixelPtr;
+	if ((window16[0] != image16[(2002 * kTestWidth) + 1001]) ||
+		(window16[(79 * 100) + 99] != image16[((2002 + 79) * kTestWidth) + 1001 + 99]))
+	{
+		printf("FAIL: window contents\r\n");
+		failCnt++;
+	}
+	ImageWindow_Release(&imgWindow);
+
+	imgWindow.bin	=	3;
+	ImageWindow_Extract(&imgWindow, (unsigned char *)image16, kTestWidth, kTestHeight, 1, 2);
+	window16	=	(uint16_t *)imgWindow.pixelPtr;
+	blockSum	=	0;
+	for (iii=0; iii<9; iii++)
+	{
+		blockSum	+=	image16[((2002 + 3 + (iii / 3)) * kTestWidth) + 1001 + 6 + (iii % 3)];
+	}
+	if ((imgWindow.outWidth != 33) || (window16[(1 * 33) + 2] != ((blockSum + 4) / 9)))
+	{
+		printf("FAIL: bin 3 average\r\n");
+		failCnt++;
+	}
+	ImageWindow_Release(&imgWindow);
+
+	//*	out of bounds has to be rejected
+	imgWindow.xStart	=	kTestWidth - 50;
+	imgWindow.bin		=	1;
+	if (ImageWindow_Extract(&imgWindow, (unsigned char *)image16, kTestWidth, kTestHeight, 1, 2))
+	{
+		printf("FAIL: window outside the image was accepted\r\n");
+		failCnt++;
+	}
+
+	//*	binary rgbarray against the straight column loop and the JSON text
+	pixelCnt	=	(size_t)kTestWidth * kTestHeight;
+	imageBGR	=	(unsigned char *)malloc(pixelCnt * 3);
+	rgbRef		=	(unsigned char *)malloc(pixelCnt * 3);
+	rgbOut		=	(unsigned char *)malloc(pixelCnt * 6);
+	for (pixelIdx=0; pixelIdx<(pixelCnt * 3); pixelIdx++)
+	{
+		imageBGR[pixelIdx]	=	(unsigned char)((pixelIdx * 2654435761U) >> 24);
+	}
+	startTime_ms	=	GetMilliSecs();
+	ccc				=	0;
+	for (xxx=0; xxx<kTestWidth; xxx++)
+	{
+		for (yyy=0; yyy<kTestHeight; yyy++)
+		{
+			pixelIdx		=	(((size_t)yyy * kTestWidth) + xxx) * 3;
+			rgbRef[ccc++]	=	imageBGR[pixelIdx + 2];
+			rgbRef[ccc++]	=	imageBGR[pixelIdx + 1];
+			rgbRef[ccc++]	=	imageBGR[pixelIdx + 0];
+		}
+	}
+	binary_ms		=	GetMilliSecs() - startTime_ms;
+	startTime_ms	=	GetMilliSecs();
+	ImageWindow_BuildRGB(rgbOut, imageBGR, kTestWidth, kTestHeight, 3, 1);
+	extract_ms		=	GetMilliSecs() - startTime_ms;
+	if (memcmp(rgbOut, rgbRef, pixelCnt * 3) != 0)
+	{
+		printf("FAIL: interleaved rgb\r\n");
+		failCnt++;
+	}
+	printf("rgb %dx%d: column loop %.1fms, tiled %.1fms, %lu bytes\r\n",
+											kTestWidth, kTestHeight, binary_ms, extract_ms,
+											(unsigned long)(pixelCnt * 3));
+	//*	what Send_RGBarray_rgb24() does per pixel
+	startTime_ms	=	GetMilliSecs();
+	jsonLen			=	0;
+	for (pixelIdx=0; pixelIdx<pixelCnt; pixelIdx++)
+	{
+		jsonLen	+=	sprintf(textBuff, "%d,\n", (imageBGR[pixelIdx * 3] << 16) + (imageBGR[(pixelIdx * 3) + 1] << 8) + imageBGR[(pixelIdx * 3) + 2]);
+	}
+	json_ms			=	GetMilliSecs() - startTime_ms;
+	printf("rgb JSON text %.1fms, %lu bytes\r\n", json_ms, (unsigned long)jsonLen);
+	ImageWindow_BuildRGB(rgbOut, (unsigned char *)image16, kTestWidth, kTestHeight, 1, 2);
+	rgb16Out	=	(uint16_t *)rgbOut;
+	if ((rgb16Out[0] != image16[0]) || (rgb16Out[2] != image16[0]) ||
+		(rgb16Out[3] != image16[kTestWidth]) ||
+		(rgb16Out[(pixelCnt * 3) - 1] != image16[pixelCnt - 1]))
+	{
+		printf("FAIL: 16 bit grey rgb\r\n");
+		failCnt++;
+	}
+	free(imageBGR);
+	free(rgbRef);
+	free(rgbOut);
+
+	//*	benchmark
+	listenSocket	=	socket(AF_INET, SOCK_STREAM, 0);
+	socketOption	=	1;
+	setsockopt(listenSocket, SOL_SOCKET, SO_REUSEADDR, &socketOption, sizeof(socketOption));
+	memset(&serverAddr, 0, sizeof(serverAddr));
+	serverAddr.sin_family		=	AF_INET;
+	serverAddr.sin_addr.s_addr	=	htonl(INADDR_LOOPBACK);
+	bind(listenSocket, (struct sockaddr *)&serverAddr, sizeof(serverAddr));
+	addrLen	=	sizeof(serverAddr);
+	getsockname(listenSocket, (struct sockaddr *)&serverAddr, &addrLen);
+	portNum	=	ntohs(serverAddr.sin_port);
+	listen(listenSocket, 5);
+	pthread_create(&readerThread, NULL, &ReaderThread, &listenSocket);
+
+	printf("%-16s %10s %8s %9s %9s %12s %9s %12s\r\n",	"ROI", "bytes", "extract",
+														"binary", "json", "json bytes",
+														"@100Mbit", "json@100Mbit");
+	for (iii=0; iii<(int)(sizeof(roiSizes) / sizeof(roiSizes[0])); iii++)
+	{
+		ImageWindow_Init(&imgWindow, kTestWidth, kTestHeight);
+		if (roiSizes[iii][0] < kTestWidth)
+		{
+			imgWindow.width		=	roiSizes[iii][0];
+			imgWindow.height	=	roiSizes[iii][0];
+			imgWindow.xStart	=	(kTestWidth - imgWindow.width) / 2;
+			imgWindow.yStart	=	(kTestHeight - imgWindow.height) / 2;
+		}
+		imgWindow.bin	=	roiSizes[iii][1];
+
+		startTime_ms	=	GetMilliSecs();
+		ImageWindow_Extract(&imgWindow, (unsigned char *)image16, kTestWidth, kTestHeight, 1, 2);
+		extract_ms		=	GetMilliSecs() - startTime_ms;
+		window16		=	(uint16_t *)imgWindow.pixelPtr;
+
+		//*	imagebytes, column major, then send
+		startTime_ms	=	GetMilliSecs();
+		binaryData		=	(uint16_t *)malloc((size_t)imgWindow.outWidth * imgWindow.outHeight * 2);
+		ccc				=	0;
+		for (xxx=0; xxx<imgWindow.outWidth; xxx++)
+		{
+			for (yyy=0; yyy<imgWindow.outHeight; yyy++)
+			{
+				binaryData[ccc++]	=	window16[(yyy * imgWindow.outWidth) + xxx];
+			}
+		}
+		sendSocket	=	OpenLoopback(portNum);
+		SendBuffer(sendSocket, (char *)binaryData, (size_t)ccc * 2);
+		close(sendSocket);
+		binary_ms	=	GetMilliSecs() - startTime_ms;
+		free(binaryData);
+
+		//*	JSON, the same column major order as a text list
+		startTime_ms	=	GetMilliSecs();
+		jsonData		=	(char *)malloc((size_t)imgWindow.outWidth * imgWindow.outHeight * 7 + 16);
+		jsonLen			=	0;
+		for (xxx=0; xxx<imgWindow.outWidth; xxx++)
+		{
+			for (yyy=0; yyy<imgWindow.outHeight; yyy++)
+			{
+				jsonLen	+=	sprintf(&jsonData[jsonLen], "%u,", window16[(yyy * imgWindow.outWidth) + xxx]);
+			}
+		}
+		sendSocket	=	OpenLoopback(portNum);
+		SendBuffer(sendSocket, jsonData, jsonLen);
+		close(sendSocket);
+		json_ms		=	GetMilliSecs() - startTime_ms;
+		free(jsonData);
+
+		printf("%4dx%-4d bin %d  %10d %7.2fms %7.1fms %7.1fms %12lu %7.0fms %10.0fms\r\n",
+											imgWindow.width, imgWindow.height, imgWindow.bin,
+											ccc * 2, extract_ms, binary_ms, json_ms,
+											(unsigned long)jsonLen,
+											(ccc * 16.0) / (kLinkMbits * 1000.0),
+											(jsonLen * 8.0) / (kLinkMbits * 1000.0));
+		ImageWindow_Release(&imgWindow);
+	}
+	shutdown(listenSocket, SHUT_RDWR);
+	close(listenSocket);
+	free(image16);
+	printf("Failures = %d\r\n", failCnt);
+	return(failCnt == 0 ? 0 : 1);
+}
+#endif // _INCLUDE_IMAGE_WINDOW_MAIN_
@@ -0,0 +1,61 @@
+//*****************************************************************************
+//#include	"image_window.h"
+
+#ifndef _IMAGE_WINDOW_H_
+#define	_IMAGE_WINDOW_H_
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define	kImageWindow_MaxBin		16
+#define	kImageWindow_TileSize	32			//*	ImageWindow_BuildRGB() transpose tile
+
+//*****************************************************************************
+//*	the part of an image that is going to be downloaded
+typedef struct	//	TYPE_IMAGE_WINDOW
+{
+	int				xStart;				//*	in source pixels
+	int				yStart;
+	int				width;
+	int				height;
+	int				bin;
+	int				outWidth;			//*	width / bin
+	int				outHeight;			//*	height / bin
+	int				channels;			//*	1 or 3
+	int				bytesPerValue;		//*	1 or 2
+	unsigned char	*pixelPtr;			//*	row major, same pixel format as the source
+	bool			ownsBuffer;			//*	false if pixelPtr is the source (whole frame, no bin)
+} TYPE_IMAGE_WINDOW;
+
+
+void	ImageWindow_Init(		TYPE_IMAGE_WINDOW		*imgWindow,
+								const int				srcWidth,
+								const int				srcHeight);
+bool	ImageWindow_Extract(	TYPE_IMAGE_WINDOW		*imgWindow,
+								const unsigned char		*srcPtr,
+								const int				srcWidth,
+								const int				srcHeight,
+								const int				channels,
+								const int				bytesPerValue);
+void	ImageWindow_Release(	TYPE_IMAGE_WINDOW		*imgWindow);
+void	ImageWindow_BuildRGB(	unsigned char			*outPtr,
+								const unsigned char		*srcPtr,
+								const int				width,
+								const int				height,
+								const int				channels,
+								const int				bytesPerValue);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _IMAGE_WINDOW_H_
@@ -0,0 +1,928 @@
+//*****************************************************************************
+//*	Name:			mjpeg_stream.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	multipart/x-mixed-replace (MJPEG) live view stream
+//*
+//*	The camera thread hands each new frame to MJPEG_SubmitFrame(), it gets copied
+//*	into one of two raw buffers and the call returns. It never waits on the
+//*	encoder or on a client. If the encoder is still busy when the next frame
+//*	comes, the frame that was waiting is replaced (skipped).
+//*
+//*	The encoder thread makes one jpeg for each output size the viewers asked for.
+//*	The jpeg is reference counted and shared by all of the viewers of that size.
+//*
+//*	Each viewer has its own thread because the socket write can block. When it
+//*	is ready for another frame it takes the newest one, anything it missed is
+//*	dropped for that viewer only. maxfps is enforced the same way.
+//*
+//*	The stretch and the jpeg encoder are the ones from preview_pyramid.c
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Re-distributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 18,	2026	<MLS> Created mjpeg_stream.c
+//*	Oct 18,	2026	<MLS> Added simulated camera test (_INCLUDE_MJPEG_STREAM_MAIN_)
+//*	Oct 18,	2026	<MLS> 16 bit frames use the preview pyramid percentile stretch
+//*	Oct 18,	2026	<MLS> Encoding goes through Pyramid_EncodeJPEG(), libjpeg errors no longer exit
+//*****************************************************************************
+
+#if defined(_INCLUDE_MJPEG_STREAM_MAIN_) && !defined(_ENABLE_MJPEG_STREAM_)
+	#define	_ENABLE_MJPEG_STREAM_
+#endif
+
+#ifdef _ENABLE_MJPEG_STREAM_
+
+#include	<stdbool.h>
+#include	<stdint.h>
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	<time.h>
+#include	<errno.h>
+#include	<unistd.h>
+#include	<pthread.h>
+#include	<sys/types.h>
+#include	<sys/socket.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"preview_pyramid.h"
+#include	"mjpeg_stream.h"
+
+//*****************************************************************************
+static double	GetMilliSecs(void)
+{
+struct timespec	currentTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &currentTime);
+	return((currentTime.tv_sec * 1000.0) + (currentTime.tv_nsec / 1000000.0));
+}
+
+//*****************************************************************************
+static void	MillisecsToTimespec(const double waitTime_ms, struct timespec *waitUntil)
+{
+long	nanoSecs;
+
+	clock_gettime(CLOCK_REALTIME, waitUntil);
+	nanoSecs			=	waitUntil->tv_nsec + (long)((waitTime_ms - (long)(waitTime_ms / 1000) * 1000) * 1000000.0);
+	waitUntil->tv_sec	+=	(time_t)(waitTime_ms / 1000) + (nanoSecs / 1000000000L);
+	waitUntil->tv_nsec	=	nanoSecs % 1000000000L;
+}
+
+//*****************************************************************************
+static int	BytesPerPixel(const int pixelType)
+{
+	switch(pixelType)
+	{
+		case kMJPEG_Pixel_Gray16:	return(2);
+		case kMJPEG_Pixel_BGR24:	return(3);
+		default:					return(1);
+	}
+}
+
+//*****************************************************************************
+//*	must be called with the mutex locked
+//*****************************************************************************
+static void	ReleaseFrame(TYPE_MJPEG_FRAME *frame)
+{
+	if (frame != NULL)
+	{
+		frame->refCnt--;
+		if (frame->refCnt <= 0)
+		{
+			free(frame->jpegData);
+			free(frame);
+		}
+	}
+}
+
+//*****************************************************************************
+static int	CalcScaleFactor(const int sourceWidth, const int maxWidth)
+{
+int		scaleFactor;
+
+	scaleFactor	=	1;
+	if ((maxWidth > 0) && (sourceWidth > maxWidth))
+	{
+		scaleFactor	=	(sourceWidth + maxWidth - 1) / maxWidth;
+	}
+	return(scaleFactor);
+}
+
+//*****************************************************************************
+//*	decimates by scaleFactor and encodes, 16 bit data gets the same
+//*	percentile stretch as the preview pyramid
+//*****************************************************************************
+static TYPE_MJPEG_FRAME	*EncodeFrame(	TYPE_MJPEG_STREAM	*stream,
+										const int			rawIdx,
+										const int			scaleFactor)
+{
+TYPE_MJPEG_FRAME	*frame;
+const uint8_t		*rawPtr;
+const uint16_t		*raw16Ptr;
+uint8_t				*outPtr;
+int					srcWidth;
+int					outWidth;
+int					outHeight;
+int					channels;
+int					pixelType;
+int					xxx;
+int					yyy;
+int					srcIdx;
+uint32_t			blackLevel;
+uint32_t			whiteLevel;
+unsigned char		*jpegBuffer;
+unsigned long		jpegLen;
+
+	srcWidth	=	stream->rawWidth[rawIdx];
+	pixelType	=	stream->rawPixelType[rawIdx];
+	outWidth	=	srcWidth / scaleFactor;
+	outHeight	=	stream->rawHeight[rawIdx] / scaleFactor;
+	if ((outWidth <= 0) || (outHeight <= 0))
+	{
+		return(NULL);
+	}
+	channels	=	(pixelType == kMJPEG_Pixel_BGR24) ? 3 : 1;
+	rawPtr		=	stream->rawBuffer[rawIdx];
+	raw16Ptr	=	(const uint16_t *)rawPtr;
+
+	//*	16 bit, histogram of the pixels we are going to use
+	if (pixelType == kMJPEG_Pixel_Gray16)
+	{
+		memset(stream->histogram, 0, 65536 * sizeof(uint32_t));
+		for (yyy=0; yyy<outHeight; yyy++)
+		{
+			srcIdx	=	(yyy * scaleFactor) * srcWidth;
+			for (xxx=0; xxx<outWidth; xxx++)
+			{
+				stream->histogram[raw16Ptr[srcIdx]]++;
+				srcIdx	+=	scaleFactor;
+			}
+		}
+		Pyramid_StretchLUT(	stream->histogram,
+							65535,
+							(outWidth * outHeight),
+							true,
+							stream->stretchLUT,
+							&blackLevel,
+							&whiteLevel);
+	}
+
+	outPtr	=	stream->outBuffer;
+	for (yyy=0; yyy<outHeight; yyy++)
+	{
+		srcIdx	=	(yyy * scaleFactor) * srcWidth;
+		switch(pixelType)
+		{
+			case kMJPEG_Pixel_Gray8:
+				for (xxx=0; xxx<outWidth; xxx++)
+				{
+					*outPtr++	=	rawPtr[srcIdx];
+					srcIdx		+=	scaleFactor;
+				}
+				break;
+
+			case kMJPEG_Pixel_Gray16:
+				for (xxx=0; xxx<outWidth; xxx++)
+				{
+					*outPtr++	=	stream->stretchLUT[raw16Ptr[srcIdx]];
+					srcIdx		+=	scaleFactor;
+				}
+				break;
+
+			case kMJPEG_Pixel_BGR24:
+				for (xxx=0; xxx<outWidth; xxx++)
+				{
+					*outPtr++	=	rawPtr[(srcIdx * 3) + 2];
+					*outPtr++	=	rawPtr[(srcIdx * 3) + 1];
+					*outPtr++	=	rawPtr[(srcIdx * 3)];
+					srcIdx		+=	scaleFactor;
+				}
+				break;
+		}
+	}
+	if (Pyramid_EncodeJPEG(stream->outBuffer, outWidth, outHeight, channels, kMJPEG_Quality, &jpegBuffer, &jpegLen) == false)
+	{
+		return(NULL);
+	}
+
+	frame	=	(TYPE_MJPEG_FRAME *)calloc(1, sizeof(TYPE_MJPEG_FRAME));
+	if (frame != NULL)
+	{
+		frame->refCnt		=	1;
+		frame->frameNum		=	stream->rawFrameNum[rawIdx];
+		frame->scaleFactor	=	scaleFactor;
+		frame->width		=	outWidth;
+		frame->height		=	outHeight;
+		frame->jpegData		=	jpegBuffer;
+		frame->jpegLen		=	jpegLen;
+	}
+	else
+	{
+		free(jpegBuffer);
+	}
+	return(frame);
+}
+
+//*****************************************************************************
+static void	*MJPEG_EncoderThread(void *arg)
+{
+TYPE_MJPEG_STREAM	*stream	=	(TYPE_MJPEG_STREAM *)arg;
+TYPE_MJPEG_FRAME	*frame;
+int					scaleFactors[kMJPEG_MaxSizes];
+int					sizeCnt;
+int					rawIdx;
+int					iii;
+int					sss;
+size_t				outSize;
+double				startTime_ms;
+
+	pthread_mutex_lock(&stream->mutex);
+	while (stream->keepRunning)
+	{
+		if (stream->pendingIdx < 0)
+		{
+			pthread_cond_wait(&stream->rawReadyCond, &stream->mutex);
+			continue;
+		}
+		rawIdx				=	stream->pendingIdx;
+		stream->pendingIdx	=	-1;
+		stream->encodingIdx	=	rawIdx;
+
+		//*	one jpeg for each size the viewers want
+		sizeCnt	=	0;
+		for (iii=0; iii<kMJPEG_MaxViewers; iii++)
+		{
+			if (stream->viewers[iii].active)
+			{
+				stream->viewers[iii].scaleFactor	=	CalcScaleFactor(stream->rawWidth[rawIdx], stream->viewers[iii].maxWidth);
+				for (sss=0; sss<sizeCnt; sss++)
+				{
+					if (scaleFactors[sss] == stream->viewers[iii].scaleFactor)
+					{
+						break;
+					}
+				}
+				if (sss == sizeCnt)
+				{
+					if (sizeCnt < kMJPEG_MaxSizes)
+					{
+						scaleFactors[sizeCnt++]	=	stream->viewers[iii].scaleFactor;
+					}
+					else
+					{
+						//*	too many sizes, this one gets the first size
+						stream->viewers[iii].scaleFactor	=	scaleFactors[0];
+					}
+				}
+			}
+		}
+		//*	the full size output is the biggest
+		outSize	=	(size_t)stream->rawWidth[rawIdx] * stream->rawHeight[rawIdx] * 3;
+		if (outSize > stream->outBufferSize)
+		{
+			free(stream->outBuffer);
+			stream->outBuffer		=	(unsigned char *)malloc(outSize);
+			stream->outBufferSize	=	(stream->outBuffer != NULL) ? outSize : 0;
+		}
+		pthread_mutex_unlock(&stream->mutex);
+
+		startTime_ms	=	GetMilliSecs();
+		for (sss=0; sss<sizeCnt; sss++)
+		{
+			frame	=	(stream->outBuffer != NULL) ? EncodeFrame(stream, rawIdx, scaleFactors[sss]) : NULL;
+			if (frame != NULL)
+			{
+				pthread_mutex_lock(&stream->mutex);
+				//*	replace the one that is this size, or the oldest
+				iii	=	0;
+				while ((iii < (kMJPEG_MaxSizes - 1)) &&
+						(stream->latest[iii] != NULL) &&
+						(stream->latest[iii]->scaleFactor != frame->scaleFactor))
+				{
+					iii++;
+				}
+				ReleaseFrame(stream->latest[iii]);
+				stream->latest[iii]	=	frame;
+				stream->jpegsEncoded++;
+				pthread_mutex_unlock(&stream->mutex);
+			}
+		}
+
+		pthread_mutex_lock(&stream->mutex);
+		stream->encodeTime_ms	+=	GetMilliSecs() - startTime_ms;
+		stream->encodingIdx		=	-1;
+		stream->framesEncoded++;
+		pthread_cond_broadcast(&stream->newFrameCond);
+	}
+	pthread_mutex_unlock(&stream->mutex);
+	return(NULL);
+}
+
+//*****************************************************************************
+static bool	SendAll(const int socket, const void *data, size_t dataLen)
+{
+const char	*dataPtr	=	(const char *)data;
+ssize_t		bytesSent;
+
+	while (dataLen > 0)
+	{
+		//*	MSG_NOSIGNAL, a viewer closing the window must not SIGPIPE the server
+		bytesSent	=	send(socket, dataPtr, dataLen, MSG_NOSIGNAL);
+		if (bytesSent <= 0)
+		{
+			if ((bytesSent < 0) && (errno == EINTR))
+			{
+				continue;
+			}
+			return(false);
+		}
+		dataPtr	+=	bytesSent;
+		dataLen	-=	bytesSent;
+	}
+	return(true);
+}
+
+//*****************************************************************************
+//*	must be called with the mutex locked
+//*****************************************************************************
+static TYPE_MJPEG_FRAME	*FindLatestFrame(TYPE_MJPEG_STREAM *stream, const int scaleFactor)
+{
+int		iii;
+
+	for (iii=0; iii<kMJPEG_MaxSizes; iii++)
+	{
+		if ((stream->latest[iii] != NULL) && (stream->latest[iii]->scaleFactor == scaleFactor))
+		{
+			return(stream->latest[iii]);
+		}
+	}
+	return(NULL);
+}
+
+//*****************************************************************************
+static void	*MJPEG_ViewerThread(void *arg)
+{
+TYPE_MJPEG_VIEWER	*viewer	=	(TYPE_MJPEG_VIEWER *)arg;
+TYPE_MJPEG_STREAM	*stream	=	(TYPE_MJPEG_STREAM *)viewer->stream;
+TYPE_MJPEG_FRAME	*frame;
+struct timespec		waitUntil;
+char				partHeader[256];
+int					partHeaderLen;
+uint32_t			lastFrameNum;
+double				nextDue_ms;
+double				now_ms;
+double				elapsed_secs;
+bool				sentOK;
+
+	lastFrameNum	=	0;
+	nextDue_ms		=	0.0;
+	pthread_mutex_lock(&stream->mutex);
+	while (stream->keepRunning && viewer->keepRunning)
+	{
+		frame	=	FindLatestFrame(stream, viewer->scaleFactor);
+		now_ms	=	GetMilliSecs();
+		if ((frame == NULL) || (frame->frameNum == lastFrameNum))
+		{
+			//*	nothing new, wake up once a second to check keepRunning
+			MillisecsToTimespec(1000.0, &waitUntil);
+			pthread_cond_timedwait(&stream->newFrameCond, &stream->mutex, &waitUntil);
+		}
+		else if (now_ms < nextDue_ms)
+		{
+			//*	max frame rate, wait and then take whatever is newest
+			MillisecsToTimespec((nextDue_ms - now_ms), &waitUntil);
+			pthread_cond_timedwait(&stream->viewerExitCond, &stream->mutex, &waitUntil);
+		}
+		else
+		{
+			if ((lastFrameNum != 0) && (frame->frameNum > (lastFrameNum + 1)))
+			{
+				viewer->framesDropped	+=	frame->frameNum - lastFrameNum - 1;
+			}
+			lastFrameNum	=	frame->frameNum;
+			frame->refCnt++;
+			pthread_mutex_unlock(&stream->mutex);
+
+			partHeaderLen	=	snprintf(partHeader, sizeof(partHeader),	"--" kMJPEG_Boundary "\r\n"
+																			"Content-Type: image/jpeg\r\n"
+																			"Content-Length: %lu\r\n"
+																			"\r\n",
+																			frame->jpegLen);
+			sentOK	=	SendAll(viewer->socket, partHeader, partHeaderLen)		&&
+						SendAll(viewer->socket, frame->jpegData, frame->jpegLen)	&&
+						SendAll(viewer->socket, "\r\n", 2);
+
+			pthread_mutex_lock(&stream->mutex);
+			if (sentOK)
+			{
+				viewer->framesSent++;
+				viewer->bytesSent	+=	partHeaderLen + frame->jpegLen + 2;
+			}
+			else
+			{
+				viewer->keepRunning	=	false;
+			}
+			ReleaseFrame(frame);
+			if (viewer->maxFPS > 0.0)
+			{
+				//*	from when it was due, not when it finished, so the rate does not drift
+				nextDue_ms	=	((nextDue_ms > 0.0) && ((now_ms - nextDue_ms) < (1000.0 / viewer->maxFPS))) ? nextDue_ms : now_ms;
+				nextDue_ms	+=	1000.0 / viewer->maxFPS;
+			}
+		}
+	}
+	elapsed_secs	=	(GetMilliSecs() - viewer->startTime_ms) / 1000.0;
+	CONSOLE_DEBUG_W_STR("MJPEG viewer disconnected", viewer->clientIP);
+	CONSOLE_DEBUG_W_DBL("Frames per second\t=", (elapsed_secs > 0.0) ? (viewer->framesSent / elapsed_secs) : 0.0);
+	close(viewer->socket);
+	viewer->active	=	false;
+	stream->viewerCnt--;
+	pthread_cond_broadcast(&stream->viewerExitCond);
+	pthread_mutex_unlock(&stream->mutex);
+	return(NULL);
+}
+
+//*****************************************************************************
+TYPE_MJPEG_STREAM	*MJPEG_CreateStream(void)
+{
+TYPE_MJPEG_STREAM	*stream;
+int					threadErr;
+
+	stream	=	(TYPE_MJPEG_STREAM *)calloc(1, sizeof(TYPE_MJPEG_STREAM));
+	if (stream != NULL)
+	{
+		stream->histogram	=	(uint32_t *)malloc(65536 * sizeof(uint32_t));
+		stream->stretchLUT	=	(uint8_t *)malloc(65536);
+		if ((stream->histogram == NULL) || (stream->stretchLUT == NULL))
+		{
+			free(stream->histogram);
+			free(stream->stretchLUT);
+			free(stream);
+			return(NULL);
+		}
+		pthread_mutex_init(&stream->mutex, NULL);
+		pthread_cond_init(&stream->rawReadyCond, NULL);
+		pthread_cond_init(&stream->newFrameCond, NULL);
+		pthread_cond_init(&stream->viewerExitCond, NULL);
+		stream->pendingIdx	=	-1;
+		stream->encodingIdx	=	-1;
+		stream->keepRunning	=	true;
+		threadErr			=	pthread_create(&stream->encoderThreadID, NULL, &MJPEG_EncoderThread, stream);
+		if (threadErr != 0)
+		{
+			CONSOLE_DEBUG_W_NUM("Failed to start MJPEG encoder thread, err=", threadErr);
+			free(stream->histogram);
+			free(stream->stretchLUT);
+			free(stream);
+			stream	=	NULL;
+		}
+	}
+	return(stream);
+}
+
+//*****************************************************************************
+void	MJPEG_DeleteStream(TYPE_MJPEG_STREAM *stream)
+{
+int		iii;
+
+	if (stream == NULL)
+	{
+		return;
+	}
+	pthread_mutex_lock(&stream->mutex);
+	stream->keepRunning	=	false;
+	for (iii=0; iii<kMJPEG_MaxViewers; iii++)
+	{
+		if (stream->viewers[iii].active)
+		{
+			//*	unblocks a viewer that is stuck in send()
+			shutdown(stream->viewers[iii].socket, SHUT_RDWR);
+		}
+	}
+	pthread_cond_broadcast(&stream->rawReadyCond);
+	pthread_cond_broadcast(&stream->newFrameCond);
+	pthread_cond_broadcast(&stream->viewerExitCond);
+	while (stream->viewerCnt > 0)
+	{
+		pthread_cond_wait(&stream->viewerExitCond, &stream->mutex);
+	}
+	pthread_mutex_unlock(&stream->mutex);
+	pthread_join(stream->encoderThreadID, NULL);
+
+	for (iii=0; iii<kMJPEG_MaxSizes; iii++)
+	{
+		ReleaseFrame(stream->latest[iii]);
+	}
+	free(stream->rawBuffer[0]);
+	free(stream->rawBuffer[1]);
+	free(stream->outBuffer);
+	free(stream->histogram);
+	free(stream->stretchLUT);
+	pthread_mutex_destroy(&stream->mutex);
+	pthread_cond_destroy(&stream->rawReadyCond);
+	pthread_cond_destroy(&stream->newFrameCond);
+	pthread_cond_destroy(&stream->viewerExitCond);
+	free(stream);
+}
+
+//*****************************************************************************
+//*	lets the camera skip the work when nobody is watching
+//*****************************************************************************
+bool	MJPEG_HasViewers(TYPE_MJPEG_STREAM *stream)
+{
+	return((stream != NULL) && (stream->viewerCnt > 0));
+}
+
+//*****************************************************************************
+//*	copies the frame and returns, returns false if nobody is watching
+//*****************************************************************************
+bool	MJPEG_SubmitFrame(	TYPE_MJPEG_STREAM	*stream,
+							const void			*pixelData,
+							const int			width,
+							const int			height,
+							const int			pixelType)
+{
+int			writeIdx;
+size_t		dataLen;
+
+	if ((stream == NULL) || (pixelData == NULL) || (width <= 0) || (height <= 0))
+	{
+		return(false);
+	}
+	pthread_mutex_lock(&stream->mutex);
+	if (stream->viewerCnt == 0)
+	{
+		pthread_mutex_unlock(&stream->mutex);
+		return(false);
+	}
+	stream->framesSubmitted++;
+	if (stream->pendingIdx >= 0)
+	{
+		//*	the encoder never got to the last one, replace it
+		writeIdx			=	stream->pendingIdx;
+		stream->pendingIdx	=	-1;
+		stream->framesSkipped++;
+	}
+	else
+	{
+		writeIdx	=	(stream->encodingIdx == 0) ? 1 : 0;
+	}
+	pthread_mutex_unlock(&stream->mutex);
+
+	//*	the encoder does not touch this buffer until it is pending, copy it without the lock
+	dataLen	=	(size_t)width * height * BytesPerPixel(pixelType);
+	if (dataLen > stream->rawBufferSize[writeIdx])
+	{
+		free(stream->rawBuffer[writeIdx]);
+		stream->rawBuffer[writeIdx]		=	(unsigned char *)malloc(dataLen);
+		stream->rawBufferSize[writeIdx]	=	(stream->rawBuffer[writeIdx] != NULL) ? dataLen : 0;
+		if (stream->rawBuffer[writeIdx] == NULL)
+		{
+			CONSOLE_DEBUG("Failed to allocate MJPEG raw buffer");
+			return(false);
+		}
+	}
+	memcpy(stream->rawBuffer[writeIdx], pixelData, dataLen);
+
+	pthread_mutex_lock(&stream->mutex);
+	stream->rawWidth[writeIdx]		=	width;
+	stream->rawHeight[writeIdx]		=	height;
+	stream->rawPixelType[writeIdx]	=	pixelType;
+	stream->rawFrameNum[writeIdx]	=	stream->framesSubmitted;
+	stream->pendingIdx				=	writeIdx;
+	pthread_cond_signal(&stream->rawReadyCond);
+	pthread_mutex_unlock(&stream->mutex);
+	return(true);
+}
+
+//*****************************************************************************
+//*	sends the http header and starts the viewer thread, the stream owns the
+//*	socket from here on and closes it when the viewer goes away
+//*****************************************************************************
+bool	MJPEG_AddViewer(	TYPE_MJPEG_STREAM	*stream,
+							const int			socket,
+							const int			maxWidth,
+							const double		maxFPS,
+							const char			*clientIP)
+{
+static const char	httpHeader[]	=	"HTTP/1.0 200 OK\r\n"
+										"Content-Type: multipart/x-mixed-replace; boundary=" kMJPEG_Boundary "\r\n"
+										"Cache-Control: no-cache, no-store\r\n"
+										"Pragma: no-cache\r\n"
+										"Access-Control-Allow-Origin: *\r\n"
+										"Connection: close\r\n"
+										"\r\n";
+TYPE_MJPEG_VIEWER	*viewer;
+pthread_t			threadID;
+pthread_attr_t		threadAttr;
+struct timeval		sendTimeout;
+int					iii;
+bool				addedOK;
+
+	if (stream == NULL)
+	{
+		return(false);
+	}
+	pthread_mutex_lock(&stream->mutex);
+	viewer	=	NULL;
+	for (iii=0; iii<kMJPEG_MaxViewers; iii++)
+	{
+		if (stream->viewers[iii].active == false)
+		{
+			viewer	=	&stream->viewers[iii];
+			break;
+		}
+	}
+	if (viewer == NULL)
+	{
+		pthread_mutex_unlock(&stream->mutex);
+		CONSOLE_DEBUG("Too many MJPEG viewers");
+		return(false);
+	}
+	memset(viewer, 0, sizeof(TYPE_MJPEG_VIEWER));
+	viewer->active			=	true;
+	viewer->keepRunning		=	true;
+	viewer->socket			=	socket;
+	viewer->maxWidth		=	maxWidth;
+	viewer->maxFPS			=	(maxFPS > 0.0) ? maxFPS : kMJPEG_DefaultMaxFPS;
+	viewer->scaleFactor		=	CalcScaleFactor(stream->rawWidth[0], maxWidth);
+	viewer->startTime_ms	=	GetMilliSecs();
+	viewer->stream			=	stream;
+	strncpy(viewer->clientIP, ((clientIP != NULL) ? clientIP : ""), (sizeof(viewer->clientIP) - 1));
+	stream->viewerCnt++;
+	pthread_mutex_unlock(&stream->mutex);
+
+	sendTimeout.tv_sec	=	kMJPEG_SendTimeout_secs;
+	sendTimeout.tv_usec	=	0;
+	setsockopt(socket, SOL_SOCKET, SO_SNDTIMEO, &sendTimeout, sizeof(sendTimeout));
+
+	addedOK	=	SendAll(socket, httpHeader, strlen(httpHeader));
+	if (addedOK)
+	{
+		pthread_attr_init(&threadAttr);
+		pthread_attr_setdetachstate(&threadAttr, PTHREAD_CREATE_DETACHED);
+		addedOK	=	(pthread_create(&threadID, &threadAttr, &MJPEG_ViewerThread, viewer) == 0);
+		pthread_attr_destroy(&threadAttr);
+	}
+	if (addedOK == false)
+	{
+		pthread_mutex_lock(&stream->mutex);
+		viewer->active	=	false;
+		stream->viewerCnt--;
+		pthread_mutex_unlock(&stream->mutex);
+	}
+	return(addedOK);
+}
+
+
+#ifdef _INCLUDE_MJPEG_STREAM_MAIN_
+//*****************************************************************************
+//*	Simulated camera, 1280x960 RGB at 30 fps, with viewers of different
+//*	speeds and sizes. The camera must never be held up by a slow viewer.
+//*
+//*	g++ -O2 -x c++ -D_ENABLE_MJPEG_STREAM_ -D_INCLUDE_MJPEG_STREAM_MAIN_ -I../libs/src_mlsLib mjpeg_stream.c preview_pyramid.c -ljpeg -lpthread -o mjpegtest
+//*****************************************************************************
+#include	<math.h>
+
+#define	kSimWidth		1280
+#define	kSimHeight		960
+#define	kSimFPS			30
+#define	kTestSecs		5
+
+//*****************************************************************************
+typedef struct
+{
+	const char	*name;
+	int			maxWidth;
+	double		maxFPS;
+	int			readDelay_us;		//*	per 64K read, to make a slow client
+	int			socket;
+	uint64_t	bytesRead;
+	int			boundaryCnt;
+} TYPE_TEST_CLIENT;
+
+//*****************************************************************************
+static void	*TestClientThread(void *arg)
+{
+TYPE_TEST_CLIENT	*client	=	(TYPE_TEST_CLIENT *)arg;
+char				readBuf[65536];
+ssize_t				bytesRead;
+char				*searchPtr;
+
+	while ((bytesRead = read(client->socket, readBuf, sizeof(readBuf) - 1)) > 0)
+	{
+		client->bytesRead	+=	bytesRead;
+		readBuf[bytesRead]	=	0;
+		searchPtr			=	readBuf;
+		while ((searchPtr = (char *)memmem(searchPtr, (readBuf + bytesRead) - searchPtr, "--" kMJPEG_Boundary, strlen("--" kMJPEG_Boundary))) != NULL)
+		{
+			client->boundaryCnt++;
+			searchPtr++;
+		}
+		if (client->readDelay_us > 0)
+		{
+			usleep(client->readDelay_us);
+		}
+	}
+	return(NULL);
+}
+
+//*****************************************************************************
+//*	sky background from 1000 to 1063 with 20 hot pixels at 65535,
+//*	the stretch comes from the percentiles, not the brightest pixel
+//*****************************************************************************
+static bool	Test_Stretch16(void)
+{
+TYPE_MJPEG_STREAM	*stream;
+TYPE_MJPEG_FRAME	*frame;
+uint16_t			*image16;
+int					iii;
+bool				passed;
+
+	stream	=	MJPEG_CreateStream();
+	image16	=	(uint16_t *)malloc(320 * 240 * sizeof(uint16_t));
+	for (iii=0; iii<(320 * 240); iii++)
+	{
+		image16[iii]	=	1000 + (iii % 64);
+	}
+	for (iii=0; iii<20; iii++)
+	{
+		image16[iii * 3001]	=	65535;
+	}
+	//*	no viewers, so the encoder thread never touches the raw buffers
+	pthread_mutex_lock(&stream->mutex);
+	stream->rawBuffer[0]		=	(unsigned char *)image16;
+	stream->rawWidth[0]			=	320;
+	stream->rawHeight[0]		=	240;
+	stream->rawPixelType[0]		=	kMJPEG_Pixel_Gray16;
+	stream->outBuffer			=	(unsigned char *)malloc(320 * 240 * 3);
+	stream->outBufferSize		=	320 * 240 * 3;
+	frame						=	EncodeFrame(stream, 0, 1);
+	printf("16 bit stretch: 1000->%d 1032->%d 1063->%d 65535->%d\r\n",	stream->stretchLUT[1000],
+																		stream->stretchLUT[1032],
+																		stream->stretchLUT[1063],
+																		stream->stretchLUT[65535]);
+	passed	=	(frame != NULL) &&
+				(stream->stretchLUT[1000] == 0) &&
+				(stream->stretchLUT[1032] > 128) &&
+				(stream->stretchLUT[1063] == 255);
+	ReleaseFrame(frame);
+	stream->rawBuffer[0]		=	NULL;
+	pthread_mutex_unlock(&stream->mutex);
+	free(image16);
+	MJPEG_DeleteStream(stream);
+	return(passed);
+}
+
+//*****************************************************************************
+int main(int argc, char *argv[])
+{
+TYPE_MJPEG_STREAM	*stream;
+TYPE_TEST_CLIENT	clients[]	=
+{
+	{	"full size",	0,		0.0,	0,		-1, 0, 0	},
+	{	"640 wide",		640,	0.0,	0,		-1, 0, 0	},
+	{	"640 @ 5fps",	640,	5.0,	0,		-1, 0, 0	},
+	{	"320 wide",		320,	0.0,	0,		-1, 0, 0	},
+	{	"slow client",	0,		0.0,	200000,	-1, 0, 0	},
+};
+int					clientCnt	=	sizeof(clients) / sizeof(TYPE_TEST_CLIENT);
+pthread_t			clientThreads[8];
+int					sockets[2];
+uint8_t				*imageData;
+int					frameCnt;
+int					iii;
+int					xxx;
+int					yyy;
+double				startTime_ms;
+double				submitStart_ms;
+double				worstSubmit_ms;
+double				elapsed_ms;
+int					failCnt;
+
+	(void)argc;
+	(void)argv;
+	failCnt		=	0;
+	stream		=	MJPEG_CreateStream();
+	imageData	=	(uint8_t *)malloc(kSimWidth * kSimHeight * 3);
+
+	for (iii=0; iii<clientCnt; iii++)
+	{
+		socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+		clients[iii].socket	=	sockets[0];
+		//*	small socket buffer so the slow client really backs up
+		xxx	=	64 * 1024;
+		setsockopt(sockets[1], SOL_SOCKET, SO_SNDBUF, &xxx, sizeof(xxx));
+		MJPEG_AddViewer(stream, sockets[1], clients[iii].maxWidth, ((clients[iii].maxFPS > 0.0) ? clients[iii].maxFPS : 1000.0), clients[iii].name);
+		pthread_create(&clientThreads[iii], NULL, &TestClientThread, &clients[iii]);
+	}
+
+	//*	the simulated camera
+	frameCnt		=	0;
+	worstSubmit_ms	=	0.0;
+	startTime_ms	=	GetMilliSecs();
+	while ((GetMilliSecs() - startTime_ms) < (kTestSecs * 1000.0))
+	{
+		for (yyy=0; yyy<kSimHeight; yyy++)
+		{
+			for (xxx=0; xxx<kSimWidth; xxx++)
+			{
+				imageData[((yyy * kSimWidth) + xxx) * 3]		=	xxx + frameCnt;
+				imageData[((yyy * kSimWidth) + xxx) * 3 + 1]	=	yyy;
+				imageData[((yyy * kSimWidth) + xxx) * 3 + 2]	=	frameCnt * 4;
+			}
+		}
+		submitStart_ms	=	GetMilliSecs();
+		MJPEG_SubmitFrame(stream, imageData, kSimWidth, kSimHeight, kMJPEG_Pixel_BGR24);
+		elapsed_ms		=	GetMilliSecs() - submitStart_ms;
+		if (elapsed_ms > worstSubmit_ms)
+		{
+			worstSubmit_ms	=	elapsed_ms;
+		}
+		frameCnt++;
+		elapsed_ms	=	(frameCnt * 1000.0 / kSimFPS) - (GetMilliSecs() - startTime_ms);
+		if (elapsed_ms > 0)
+		{
+			usleep(elapsed_ms * 1000);
+		}
+	}
+	elapsed_ms	=	GetMilliSecs() - startTime_ms;
+
+	printf("Camera: %d frames in %1.0f ms = %1.1f fps, slowest submit %1.2f ms\r\n",	frameCnt, elapsed_ms,
+																						frameCnt * 1000.0 / elapsed_ms,
+																						worstSubmit_ms);
+	printf("Encoder: %u frames, %u jpegs, %u skipped, %1.2f ms per frame\r\n",	stream->framesEncoded,
+																				stream->jpegsEncoded,
+																				stream->framesSkipped,
+																				stream->encodeTime_ms / ((stream->framesEncoded > 0) ? stream->framesEncoded : 1));
+	printf("%-14s %8s %8s %8s %10s\r\n", "Viewer", "Frames", "Dropped", "FPS", "KBytes");
+	for (iii=0; iii<clientCnt; iii++)
+	{
+		printf("%-14s %8u %8u %8.1f %10llu\r\n",	clients[iii].name,
+													stream->viewers[iii].framesSent,
+													stream->viewers[iii].framesDropped,
+													stream->viewers[iii].framesSent * 1000.0 / elapsed_ms,
+													(unsigned long long)(stream->viewers[iii].bytesSent / 1024));
+	}
+	//*	5 fps viewer has to be close to 5
+	if (fabs((stream->viewers[2].framesSent * 1000.0 / elapsed_ms) - 5.0) > 0.5)
+	{
+		printf("FAIL: max fps not honored\r\n");
+		failCnt++;
+	}
+	//*	the camera can never wait on the slow client
+	if (worstSubmit_ms > 20.0)
+	{
+		printf("FAIL: the camera was held up\r\n");
+		failCnt++;
+	}
+	//*	the slow client gets fewer frames, but it still gets frames
+	if ((stream->viewers[4].framesSent == 0) || (stream->viewers[4].framesSent >= stream->viewers[0].framesSent))
+	{
+		printf("FAIL: slow client\r\n");
+		failCnt++;
+	}
+	//*	full size viewers share the same jpeg, 3 sizes plus full = 4 jpegs per frame at most
+	if (stream->jpegsEncoded > (stream->framesEncoded * 4))
+	{
+		printf("FAIL: frames encoded more than once per size\r\n");
+		failCnt++;
+	}
+
+	MJPEG_DeleteStream(stream);
+	for (iii=0; iii<clientCnt; iii++)
+	{
+		pthread_join(clientThreads[iii], NULL);
+		close(clients[iii].socket);
+	}
+
+	//*	16 bit, a few hot pixels must not turn the sky black
+	if (Test_Stretch16() == false)
+	{
+		printf("FAIL: 16 bit stretch\r\n");
+		failCnt++;
+	}
+	free(imageData);
+	printf("Failures = %d\r\n", failCnt);
+	return(failCnt == 0 ? 0 : 1);
+}
+#endif // _INCLUDE_MJPEG_STREAM_MAIN_
+
+#endif // _ENABLE_MJPEG_STREAM_
@@ -0,0 +1,122 @@
+//*****************************************************************************
+//#include	"mjpeg_stream.h"
+
+#ifndef _MJPEG_STREAM_H_
+#define	_MJPEG_STREAM_H_
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+#include	<stddef.h>
+#include	<pthread.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define	kMJPEG_MaxViewers			8
+#define	kMJPEG_MaxSizes				4			//*	different output sizes encoded per frame
+#define	kMJPEG_Quality				75
+#define	kMJPEG_DefaultMaxFPS		10.0
+#define	kMJPEG_SendTimeout_secs		10			//*	a client that stops reading gets dropped
+#define	kMJPEG_Boundary				"alpacapi-mjpeg-frame"
+
+//*****************************************************************************
+enum
+{
+	kMJPEG_Pixel_Gray8	=	0,
+	kMJPEG_Pixel_Gray16,
+	kMJPEG_Pixel_BGR24			//*	same order as the camera RGB24 buffer and OpenCV
+};
+
+//*****************************************************************************
+//*	one encoded frame, shared by all of the viewers that want this size
+typedef struct	//	TYPE_MJPEG_FRAME
+{
+	int				refCnt;
+	uint32_t		frameNum;
+	int				scaleFactor;
+	int				width;
+	int				height;
+	unsigned long	jpegLen;
+	unsigned char	*jpegData;
+} TYPE_MJPEG_FRAME;
+
+//*****************************************************************************
+typedef struct	//	TYPE_MJPEG_VIEWER
+{
+	bool			active;
+	bool			keepRunning;
+	int				socket;
+	char			clientIP[48];
+	int				maxWidth;			//*	0 = full size
+	double			maxFPS;
+	int				scaleFactor;		//*	set by the encoder from maxWidth
+	uint32_t		framesSent;
+	uint32_t		framesDropped;
+	uint64_t		bytesSent;
+	double			startTime_ms;
+	void			*stream;
+} TYPE_MJPEG_VIEWER;
+
+//*****************************************************************************
+typedef struct	//	TYPE_MJPEG_STREAM
+{
+	pthread_mutex_t		mutex;
+	pthread_cond_t		rawReadyCond;
+	pthread_cond_t		newFrameCond;
+	pthread_cond_t		viewerExitCond;
+	pthread_t			encoderThreadID;
+	bool				keepRunning;
+
+	//*	two raw buffers, the camera fills one while the other is being encoded
+	unsigned char		*rawBuffer[2];
+	size_t				rawBufferSize[2];
+	int					rawWidth[2];
+	int					rawHeight[2];
+	int					rawPixelType[2];
+	uint32_t			rawFrameNum[2];
+	int					pendingIdx;			//*	-1 if nothing waiting
+	int					encodingIdx;		//*	-1 if the encoder is idle
+
+	TYPE_MJPEG_FRAME	*latest[kMJPEG_MaxSizes];
+	unsigned char		*outBuffer;			//*	decimated 8 bit image for the encoder
+	size_t				outBufferSize;
+	uint32_t			*histogram;			//*	16 bit stretch
+	uint8_t				*stretchLUT;
+
+	TYPE_MJPEG_VIEWER	viewers[kMJPEG_MaxViewers];
+	int					viewerCnt;
+
+	//*	statistics
+	uint32_t			framesSubmitted;
+	uint32_t			framesSkipped;		//*	replaced before the encoder got to them
+	uint32_t			framesEncoded;
+	uint32_t			jpegsEncoded;
+	double				encodeTime_ms;
+} TYPE_MJPEG_STREAM;
+
+
+TYPE_MJPEG_STREAM	*MJPEG_CreateStream(void);
+void				MJPEG_DeleteStream(TYPE_MJPEG_STREAM *stream);
+bool				MJPEG_HasViewers(TYPE_MJPEG_STREAM *stream);
+bool				MJPEG_SubmitFrame(	TYPE_MJPEG_STREAM	*stream,
+										const void			*pixelData,
+										const int			width,
+										const int			height,
+										const int			pixelType);
+bool				MJPEG_AddViewer(	TYPE_MJPEG_STREAM	*stream,
+										const int			socket,
+										const int			maxWidth,
+										const double		maxFPS,
+										const char			*clientIP);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _MJPEG_STREAM_H_
@@ -33,6 +33,7 @@
 //*	Nov 27,	2022	<MLS> Added more debugging to USB_SendCommand()
 //*	Nov 28,	2022	<MLS> Added MoonLite_GetMovingState()
 //*	Dec 11,	2022	<MLS> Fixed sign error for HiRes in MoonLite_GetTemperature()
+//*	Oct 18,	2026	<MLS> Switched to serial_transport, ReadUntilChar() no longer polls 1 byte at a time
 //*****************************************************************************
 
 #if defined(_ENABLE_FOCUSER_MOONLITE_) || defined(_ENABLE_ROTATOR_NITECRAWLER_) || defined(_ENABLE_CTRL_FOCUSERS_)
@@ -60,6 +61,7 @@
 #define	_DEBUG_NITECRAWLER_DETECTION_
 
 #include	"serialport.h"
+#include	"serial_transport.h"
 
 #include	"moonlite_com.h"
 
@@ -67,7 +69,9 @@
 char	gLastCmdSent[48]	=	"";
 
 static int	USB_SendCommand(TYPE_MOONLITECOM *moonliteCom, const char *theCommand);
-static int	ReadUntilChar(const int fileDesc, char *readBuff, const int maxChars, const char terminator);
+static int	ReadUntilChar(TYPE_MOONLITECOM *moonliteCom, char *readBuff, const int maxChars, const char terminator);
+
+#define	kMoonLiteReadTimeout_ms	1000
 static int	gMoonLiteReadFailureCnt	=	0;
 
 //*****************************************************************************
@@ -207,7 +211,7 @@ int		readCnt;
 	{
 		//*	get the model
 		USB_SendCommand(moonliteCom, "PF");
-		readCnt	=	ReadUntilChar(moonliteCom->fileDesc, readBuffer, 40, '#');
+		readCnt	=	ReadUntilChar(moonliteCom, readBuffer, 40, '#');
 		if (readCnt > 3)
 		{
 		//	CONSOLE_DEBUG_W_NUM("readCnt\t=",	readCnt);
@@ -239,7 +243,7 @@ int		readCnt;
 		//	CONSOLE_DEBUG("Failed to read NiteCrawler model");
 		}
 		//*	read again because it gives out 2 "#"
-		readCnt	=	ReadUntilChar(moonliteCom->fileDesc, readBuffer, 40, '#');
+		readCnt	=	ReadUntilChar(moonliteCom, readBuffer, 40, '#');
 
 		tryCounter++;
 	}
@@ -255,7 +259,7 @@ int		readCnt;
 	}
 	//*	get the version
 	USB_SendCommand(moonliteCom, "PV");
-	readCnt	=	ReadUntilChar(moonliteCom->fileDesc, readBuffer, 40, '#');
+	readCnt	=	ReadUntilChar(moonliteCom, readBuffer, 40, '#');
 	if (readCnt > 0)
 	{
 		readBuffer[readCnt -1]	=	0;	//*	get rid of the trailing "#"
@@ -266,11 +270,11 @@ int		readCnt;
 	{
 		failureCnt++;
 	}
-	readCnt	=	ReadUntilChar(moonliteCom->fileDesc, readBuffer, 40, '#');
+	readCnt	=	ReadUntilChar(moonliteCom, readBuffer, 40, '#');
 
 	//*	get the serial number
 	USB_SendCommand(moonliteCom, "PS");
-	readCnt	=	ReadUntilChar(moonliteCom->fileDesc, readBuffer, 40, '#');
+	readCnt	=	ReadUntilChar(moonliteCom, readBuffer, 40, '#');
 	if (readCnt > 0)
 	{
 		readBuffer[readCnt -1]	=	0;	//*	get rid of the trailing "#"
@@ -281,7 +285,7 @@ int		readCnt;
 	{
 		failureCnt++;
 	}
-	readCnt	=	ReadUntilChar(moonliteCom->fileDesc, readBuffer, 40, '#');
+	readCnt	=	ReadUntilChar(moonliteCom, readBuffer, 40, '#');
 
 //		USB_SendCommand(moonliteCom, "GH");
 //		USB_SendCommand(moonliteCom, "GI");
@@ -325,7 +329,7 @@ int		readCnt;
 		//*	get the model
 		USB_SendCommand(moonliteCom, "GV");
 //		sleep(1);
-		readCnt	=	ReadUntilChar(moonliteCom->fileDesc, readBuffer, 40, '#');
+		readCnt	=	ReadUntilChar(moonliteCom, readBuffer, 40, '#');
 //		CONSOLE_DEBUG_W_NUM("readCnt\t=",	readCnt);
 		if (readCnt > 2)
 		{
@@ -377,6 +381,8 @@ bool	isHighRes;
 	moonliteCom->fileDesc	=	open(moonliteCom->usbPortPath, O_RDWR);	//* connect to port
 	if (moonliteCom->fileDesc >= 0)
 	{
+		SerialTransport_Init(&moonliteCom->transport, moonliteCom->fileDesc);
+		SerialTransport_SetTerminator(&moonliteCom->transport, '#');
 		if (checkForNiteCrawler)
 		{
 			isNiteCrawler	=	MoonLite_CheckIfNiteCrawler(moonliteCom);
@@ -414,6 +420,7 @@ bool	closeOK;
 	closeOK	=	false;
 	if (moonliteCom->fileDesc >= 0)
 	{
+		SerialTransport_Close(&moonliteCom->transport);
 		returnCode	=	close(moonliteCom->fileDesc);
 		if (returnCode == 0)
 		{
@@ -438,19 +445,14 @@ bool	MoonLite_FlushReadBuffer(TYPE_MOONLITECOM *moonliteCom)
 {
 bool	successFlag	=	false;
 #if 1
-int		tcReturnCode;
 //int		readCnt;
 //char	databuffer[50];
 
 //	CONSOLE_DEBUG(__FUNCTION__);
 	if (moonliteCom != NULL)
 	{
-		tcReturnCode	=	tcflush(moonliteCom->fileDesc, TCIFLUSH);
-		if (tcReturnCode == 0)
-		{
-			successFlag	=	true;
-		}
-		else
+		successFlag	=	SerialTransport_Flush(&moonliteCom->transport);
+		if (successFlag == false)
 		{
 			CONSOLE_DEBUG_W_NUM("tcflush had an error, errno=", errno);
 		}
@@ -468,8 +470,8 @@ char	readBuffer[48];
 
 	if (moonliteCom != NULL)
 	{
-		ReadUntilChar(moonliteCom->fileDesc, readBuffer, 40, '#');
-		ReadUntilChar(moonliteCom->fileDesc, readBuffer, 40, '#');
+		ReadUntilChar(moonliteCom, readBuffer, 40, '#');
+		ReadUntilChar(moonliteCom, readBuffer, 40, '#');
 		successFlag	=	true;
 	}
 #endif // 1
@@ -499,7 +501,7 @@ int		ii;
 			USB_SendCommand(moonliteCom, commandString);
 
 			memset(readBuffer, 0, sizeof(readBuffer));
-			readCnt	=	ReadUntilChar(moonliteCom->fileDesc, readBuffer, 40, '#');
+			readCnt	=	ReadUntilChar(moonliteCom, readBuffer, 40, '#');
 			if (readCnt > 0)
 			{
 				readBuffer[readCnt]	=	0;
@@ -764,14 +766,14 @@ bool	successFlag;
 					USB_SendCommand(moonliteCom, cmdBuffer);
 					usleep(1000);
 
-					readCnt	=	ReadUntilChar(moonliteCom->fileDesc, readBuffer, 40, '#');
+					readCnt	=	ReadUntilChar(moonliteCom, readBuffer, 40, '#');
 
 
 					sprintf(cmdBuffer, "%dSM", axisNumber);
 					USB_SendCommand(moonliteCom, cmdBuffer);
 
 					usleep(1000);
-					readCnt			=	ReadUntilChar(moonliteCom->fileDesc, readBuffer, 40, '#');
+					readCnt			=	ReadUntilChar(moonliteCom, readBuffer, 40, '#');
 					if (readCnt > 0)
 					{
 						successFlag	=	true;
@@ -787,7 +789,7 @@ bool	successFlag;
 				USB_SendCommand(moonliteCom, cmdBuffer);
 				usleep(1000);
 
-				readCnt	=	ReadUntilChar(moonliteCom->fileDesc, readBuffer, 40, '#');
+				readCnt	=	ReadUntilChar(moonliteCom, readBuffer, 40, '#');
 				if (readCnt > 0)
 				{
 					successFlag	=	true;
@@ -797,7 +799,7 @@ bool	successFlag;
 				USB_SendCommand(moonliteCom, "FG");
 				usleep(1000);
 
-				readCnt	=	ReadUntilChar(moonliteCom->fileDesc, readBuffer, 40, '#');
+				readCnt	=	ReadUntilChar(moonliteCom, readBuffer, 40, '#');
 				if (readCnt > 0)
 				{
 					successFlag	=	true;
@@ -836,7 +838,7 @@ bool	successFlag;
 				{
 					sprintf(cmdBuffer, "%dSP %d", axisNumber, newPosition);
 					USB_SendCommand(moonliteCom, cmdBuffer);
-					readCnt	=	ReadUntilChar(moonliteCom->fileDesc, readBuffer, 40, '#');
+					readCnt	=	ReadUntilChar(moonliteCom, readBuffer, 40, '#');
 
 					if (readCnt > 0)
 					{
@@ -1161,14 +1163,12 @@ int				bytesWritten;
 		sLen			=	strlen(cmdBuffer);
 
 //		CONSOLE_DEBUG_W_STR("sending:", cmdBuffer);
-		bytesWritten	=	write(moonliteCom->fileDesc, cmdBuffer, sLen);
+		//*	the response is waited for by ReadUntilChar(), no need to delay here
+		bytesWritten	=	SerialTransport_Write(&moonliteCom->transport, cmdBuffer, sLen, kMoonLiteReadTimeout_ms);
 		if (bytesWritten < 0)
 		{
 			CONSOLE_DEBUG_W_NUM("Error occurred on write, errno=", errno);
 		}
-
-
-		usleep(1000);
 //		CONSOLE_DEBUG_W_NUM("bytesWritten=", bytesWritten);
 	}
 	else
@@ -1180,41 +1180,32 @@ int				bytesWritten;
 
 
 //**************************************************************************
-//*	returns # chars read
+//*	returns # chars read, the terminator is included in the returned string
+//*	waits up to kMoonLiteReadTimeout_ms for the complete response
 //**************************************************************************
-static int	ReadUntilChar(const int fileDesc, char *readBuff, const int maxChars, const char terminator)
+static int	ReadUntilChar(TYPE_MOONLITECOM *moonliteCom, char *readBuff, const int maxChars, const char terminator)
 {
-int		readCnt;
-char	oneCharBuff[4];
-char	theChar;
+int		frameLen;
 int		ccc;
-int		noDataCnt;
-bool	keepGoing;
 
 	memset(readBuff, 0, maxChars);	//*	null out the response first
-	ccc			=	0;
-	noDataCnt	=	0;
-	keepGoing	=	true;
-	while (keepGoing && (ccc < maxChars) && (noDataCnt < 5))
+	ccc	=	0;
+	if (moonliteCom->transport.terminator != terminator)
 	{
-		readCnt	=	read(fileDesc, oneCharBuff, 1);
-		if (readCnt > 0)
-		{
-			theChar			=	oneCharBuff[0];
-			readBuff[ccc++]	=	theChar;
-			readBuff[ccc]	=	0;		//*	always terminate the string
-			if (theChar == terminator)
-			{
-				keepGoing	=	false;
-			}
-			noDataCnt	=	0;
-		}
-		else
-		{
-			noDataCnt++;
-			//*	Nov 28,	2022	<MLS> increased time delay from 25 to 50 ns
-			usleep(50);
-		}
+		SerialTransport_SetTerminator(&moonliteCom->transport, terminator);
+	}
+	//*	leave room for the terminator to be put back on the end
+	frameLen	=	SerialTransport_ReadFrame(&moonliteCom->transport, readBuff, (maxChars - 1), kMoonLiteReadTimeout_ms);
+	if (frameLen >= 0)
+	{
+		readBuff[frameLen]		=	terminator;
+		readBuff[frameLen + 1]	=	0;
+		ccc						=	frameLen + 1;
+	}
+	else
+	{
+		//*	throw away any partial response so it does not get attached to the next one
+		SerialTransport_Flush(&moonliteCom->transport);
 	}
 	if (strncmp(readBuff, "NAK", 3) == 0)
 	{
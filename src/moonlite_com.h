@@ -6,6 +6,9 @@
 #ifndef _STDBOOL_H
 	#include	<stdbool.h>
 #endif
+#ifndef _SERIAL_TRANSPORT_H_
+	#include	"serial_transport.h"
+#endif
 #ifdef __cplusplus
 	extern "C" {
 #endif
@@ -29,6 +32,7 @@ typedef struct
 	char			usbPortPath[48];
 	int				model;
 	int				fileDesc;				//*	port file descriptor
+	TYPE_SerialTransport	transport;
 	char			deviceModelString[64];
 	char			deviceVersion[64];
 	char			deviceSerialNum[64];
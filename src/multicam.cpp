@@ -23,6 +23,11 @@
 //*	Jun 16,	2023	<MLS> Added readall to multicam
 //*	Jun 23,	2023	<MLS> Added GetCmdNameFromMyCmdTable() to multicam
 //*	Jun 28,	2024	<MLS> Removed all "if (reqData != NULL)" from multicam.cpp
+//*	Oct 18,	2026	<MLS> Added synchronized trigger mode (synctrigger command)
+//*	Oct 18,	2026	<MLS> Added StartExposure_Synchronized(), per camera threads with a start gate
+//*	Oct 18,	2026	<MLS> Start skew is now reported in startexposure and readall
+//*	Oct 18,	2026	<MLS> Sync durations indexed by camera, a failed thread calls off the whole trigger
+//*	Oct 18,	2026	<MLS> Camera threads arm (SyncExposure_Arm()) before they wait at the start gate
 //*****************************************************************************
 
 #ifdef _ENABLE_MULTICAM_
@@ -33,6 +38,8 @@
 #include	<stdbool.h>
 #include	<ctype.h>
 #include	<stdint.h>
+#include	<pthread.h>
+#include	<sys/time.h>
 
 #define _ENABLE_CONSOLE_DEBUG_
 #include	"ConsoleDebug.h"
@@ -40,6 +47,7 @@
 #include	"RequestData.h"
 #include	"JsonResponse.h"
 #include	"eventlogging.h"
+#include	"helper_functions.h"
 
 #include	"alpacadriver.h"
 #include	"alpacadriver_helper.h"
@@ -75,7 +83,7 @@ enum
 	kCmd_MultiCam_exposuretime,
 	kCmd_MultiCam_livemode,
 	kCmd_MultiCam_readall,
-
+	kCmd_MultiCam_synctrigger,
 
 	kCmd_MultiCam_last
 };
@@ -91,6 +99,7 @@ static TYPE_CmdEntry	gMultiCamCmdTable[]	=
 	{	"exposuretime",			kCmd_MultiCam_exposuretime,		kCmdType_BOTH	},
 	{	"livemode",				kCmd_MultiCam_livemode,			kCmdType_BOTH	},
 	{	"readall",				kCmd_MultiCam_readall,			kCmdType_GET	},
+	{	"synctrigger",			kCmd_MultiCam_synctrigger,		kCmdType_BOTH	},
 
 
 
@@ -107,6 +116,12 @@ MultiCam::MultiCam(const int argDevNum)
 	strcpy(cCommonProp.Name, "MultiCam");
 	cDriverCmdTablePtr	=	gMultiCamCmdTable;
 
+	cSyncTrigger		=	false;
+	cSyncTriggerCnt		=	0;
+	cSyncSkew_us		=	0;
+	cSyncSkewMax_us		=	0;
+	cSyncGateWait_us	=	0;
+
 }
 
 //**************************************************************************************
@@ -231,6 +246,22 @@ int					mySocket;
 			alpacaErrCode	=	Get_Readall(reqData, alpacaErrMsg);
 			break;
 
+		case kCmd_MultiCam_synctrigger:
+			if (reqData->get_putIndicator == 'P')
+			{
+				alpacaErrCode	=	Put_SyncTrigger(reqData, alpacaErrMsg);
+			}
+			else
+			{
+				cBytesWrittenForThisCmd	+=	JsonResponse_Add_Bool(	mySocket,
+																	reqData->jsonTextBuffer,
+																	kMaxJsonBuffLen,
+																	gValueString,
+																	cSyncTrigger,
+																	INCLUDE_COMMA);
+			}
+			break;
+
 		//----------------------------------------------------------------------------------------
 		//*	let anything undefined go to the common command processor
 		//----------------------------------------------------------------------------------------
@@ -486,6 +517,18 @@ char				myFileNameSuffix[kFileNamePrefixMaxLen];
 		}
 	}
 
+	if (cSyncTrigger)
+	{
+		alpacaErrCode	=	StartExposure_Synchronized(expDurationValues_secs, alpacaErrMsg);
+		cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	reqData->socket,
+															reqData->jsonTextBuffer,
+															kMaxJsonBuffLen,
+															"syncskew_us",
+															cSyncSkew_us,
+															INCLUDE_COMMA);
+		return(alpacaErrCode);
+	}
+
 	//****************************************************
 	//*	sit here and waste time until we change millisecs
 	//*	this way, the 2 images will have the same time stamp
@@ -533,6 +576,233 @@ char				myFileNameSuffix[kFileNamePrefixMaxLen];
 	return(alpacaErrCode);
 }
 
+//*****************************************************************************
+//*	Synchronized trigger
+//*
+//*	Start_CameraExposure() latency varies a lot between SDKs, starting the cameras
+//*	one after another puts the last one tens to hundreds of milliseconds behind.
+//*	Instead each camera gets its own thread that does all of the setup
+//*	(SyncExposure_Arm()), then waits at the start gate. When every camera is
+//*	armed the gate opens and they all call the SDK start at the same time. If any thread fails to start, the gate is
+//*	opened with abortFlag set and none of the cameras are started.
+//*****************************************************************************
+typedef struct
+{
+	CameraDriver		*cameraObj;
+	int32_t				exposure_us;
+	TYPE_ASCOM_STATUS	alpacaErrCode;
+	pthread_t			threadID;
+} TYPE_SyncCamera;
+
+//*****************************************************************************
+typedef struct
+{
+	pthread_mutex_t		mutex;
+	pthread_cond_t		readyCond;
+	pthread_cond_t		goCond;
+	int					readyCnt;
+	bool				goFlag;
+	bool				abortFlag;
+} TYPE_SyncGate;
+
+static TYPE_SyncGate	gSyncGate;
+
+//*****************************************************************************
+static void	*SyncExposureThread(void *arg)
+{
+TYPE_SyncCamera	*syncCam;
+bool			abortFlag;
+
+	syncCam	=	(TYPE_SyncCamera *)arg;
+
+	//*	do all of the setup before the gate, only the SDK start call is left after it
+	syncCam->cameraObj->SyncExposure_Arm(syncCam->exposure_us);
+
+	//*	tell the trigger thread we are ready and wait for the gate to open
+	pthread_mutex_lock(&gSyncGate.mutex);
+	gSyncGate.readyCnt++;
+	pthread_cond_signal(&gSyncGate.readyCond);
+	while (gSyncGate.goFlag == false)
+	{
+		pthread_cond_wait(&gSyncGate.goCond, &gSyncGate.mutex);
+	}
+	abortFlag	=	gSyncGate.abortFlag;
+	pthread_mutex_unlock(&gSyncGate.mutex);
+
+	if (abortFlag)
+	{
+		syncCam->alpacaErrCode	=	kASCOM_Err_FailedUnknown;
+	}
+	else
+	{
+		syncCam->alpacaErrCode	=	syncCam->cameraObj->SyncExposure_Trigger();
+	}
+	return(NULL);
+}
+
+//*****************************************************************************
+static int32_t	DeltaMicroSecs(struct timeval *startTime, struct timeval *endTime)
+{
+int32_t	deltaMicroSecs;
+
+	deltaMicroSecs	=	((endTime->tv_sec - startTime->tv_sec) * 1000000) +
+						(endTime->tv_usec - startTime->tv_usec);
+	return(deltaMicroSecs);
+}
+
+//*****************************************************************************
+TYPE_ASCOM_STATUS	MultiCam::StartExposure_Synchronized(const double *expDurationValues_secs, char *alpacaErrMsg)
+{
+TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_Success;
+TYPE_SyncCamera		syncCamList[kMaxDevices];
+int					syncCamCnt;
+int					iii;
+int					ccc;
+int					threadErr;
+bool				threadFailed;
+struct timeval		readyStartTime;
+struct timeval		gateOpenTime;
+struct timeval		firstStart;
+struct timeval		lastStart;
+CameraDriver		*cameraObj;
+
+	CONSOLE_DEBUG(__FUNCTION__);
+
+	pthread_mutex_init(&gSyncGate.mutex, NULL);
+	pthread_cond_init(&gSyncGate.readyCond, NULL);
+	pthread_cond_init(&gSyncGate.goCond, NULL);
+	gSyncGate.readyCnt	=	0;
+	gSyncGate.goFlag	=	false;
+	gSyncGate.abortFlag	=	false;
+
+	//*	one thread per camera
+	gettimeofday(&readyStartTime, NULL);
+	syncCamCnt		=	0;
+	threadFailed	=	false;
+	ccc				=	0;		//*	camera order, the same as the duration list
+	for (iii=0; iii<gDeviceCnt; iii++)
+	{
+		if ((gAlpacaDeviceList[iii] != NULL) && (gAlpacaDeviceList[iii]->cDeviceType == kDeviceType_Camera))
+		{
+			syncCamList[syncCamCnt].cameraObj		=	(CameraDriver *)gAlpacaDeviceList[iii];
+			syncCamList[syncCamCnt].cameraObj->cSyncStartValid	=	false;
+			syncCamList[syncCamCnt].exposure_us		=	expDurationValues_secs[ccc] * 1000 * 1000;
+			syncCamList[syncCamCnt].alpacaErrCode	=	kASCOM_Err_Success;
+			threadErr	=	pthread_create(	&syncCamList[syncCamCnt].threadID,
+											NULL,
+											&SyncExposureThread,
+											&syncCamList[syncCamCnt]);
+			if (threadErr != 0)
+			{
+				CONSOLE_DEBUG_W_NUM("pthread_create() failed, errno\t=", threadErr);
+				threadFailed	=	true;
+				break;
+			}
+			syncCamCnt++;
+			ccc++;
+		}
+	}
+
+	//*	wait for every thread to get to the gate, then open it.
+	//*	If a thread did not start, the whole group is called off
+	pthread_mutex_lock(&gSyncGate.mutex);
+	while (gSyncGate.readyCnt < syncCamCnt)
+	{
+		pthread_cond_wait(&gSyncGate.readyCond, &gSyncGate.mutex);
+	}
+	gettimeofday(&gateOpenTime, NULL);
+	gSyncGate.abortFlag	=	threadFailed;
+	gSyncGate.goFlag	=	true;
+	pthread_cond_broadcast(&gSyncGate.goCond);
+	pthread_mutex_unlock(&gSyncGate.mutex);
+
+	for (iii=0; iii<syncCamCnt; iii++)
+	{
+		pthread_join(syncCamList[iii].threadID, NULL);
+	}
+	pthread_cond_destroy(&gSyncGate.goCond);
+	pthread_cond_destroy(&gSyncGate.readyCond);
+	pthread_mutex_destroy(&gSyncGate.mutex);
+
+	if (threadFailed)
+	{
+		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "Failed to create camera thread, no cameras were started");
+		return(kASCOM_Err_FailedUnknown);
+	}
+
+	//*	figure out the spread of the actual start times
+	if (syncCamCnt > 0)
+	{
+		firstStart	=	syncCamList[0].cameraObj->cSyncStartTime;
+		lastStart	=	firstStart;
+		for (iii=1; iii<syncCamCnt; iii++)
+		{
+			cameraObj	=	syncCamList[iii].cameraObj;
+			if (timercmp(&cameraObj->cSyncStartTime, &firstStart, <))
+			{
+				firstStart	=	cameraObj->cSyncStartTime;
+			}
+			if (timercmp(&cameraObj->cSyncStartTime, &lastStart, >))
+			{
+				lastStart	=	cameraObj->cSyncStartTime;
+			}
+		}
+		cSyncSkew_us		=	DeltaMicroSecs(&firstStart, &lastStart);
+		cSyncGateWait_us	=	DeltaMicroSecs(&readyStartTime, &gateOpenTime);
+		if (cSyncSkew_us > cSyncSkewMax_us)
+		{
+			cSyncSkewMax_us	=	cSyncSkew_us;
+		}
+		cSyncTriggerCnt++;
+
+		for (iii=0; iii<syncCamCnt; iii++)
+		{
+			cameraObj						=	syncCamList[iii].cameraObj;
+			cameraObj->cSyncStartOffset_us	=	DeltaMicroSecs(&firstStart, &cameraObj->cSyncStartTime);
+			cameraObj->cSyncSkew_us			=	cSyncSkew_us;
+			cameraObj->cSyncStartValid		=	(syncCamList[iii].alpacaErrCode == kASCOM_Err_Success);
+
+			CONSOLE_DEBUG_W_STR("Camera          \t=",	cameraObj->cCommonProp.Name);
+			CONSOLE_DEBUG_W_NUM("Start offset(us)\t=",	cameraObj->cSyncStartOffset_us);
+			CONSOLE_DEBUG_W_NUM("SDK latency(us) \t=",	cameraObj->cSyncLatency_us);
+			if (syncCamList[iii].alpacaErrCode != kASCOM_Err_Success)
+			{
+				alpacaErrCode	=	syncCamList[iii].alpacaErrCode;
+				GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, cameraObj->cLastCameraErrMsg);
+				CONSOLE_DEBUG(alpacaErrMsg);
+			}
+		}
+		CONSOLE_DEBUG_W_NUM("syncCamCnt      \t=",	syncCamCnt);
+		CONSOLE_DEBUG_W_NUM("cSyncGateWait_us\t=",	cSyncGateWait_us);
+		CONSOLE_DEBUG_W_NUM("cSyncSkew_us    \t=",	cSyncSkew_us);
+	}
+	return(alpacaErrCode);
+}
+
+//*****************************************************************************
+TYPE_ASCOM_STATUS	MultiCam::Put_SyncTrigger(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
+{
+TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_Success;
+bool				syncFound;
+char				syncString[32];
+
+	syncFound	=	GetKeyWordArgument(	reqData->contentData,
+										"SyncTrigger",
+										syncString,
+										(sizeof(syncString) - 1));
+	if (syncFound && IsValidTrueFalseString(syncString))
+	{
+		cSyncTrigger	=	IsTrueFalse(syncString);
+	}
+	else
+	{
+		alpacaErrCode			=	kASCOM_Err_InvalidValue;
+		reqData->httpRetCode	=	400;
+		GENERATE_ALPACAPI_ERRMSG(alpacaErrMsg, "SyncTrigger is missing or not true/false");
+	}
+	return(alpacaErrCode);
+}
+
 //*****************************************************************************
 TYPE_ASCOM_STATUS	MultiCam::Put_ExposureTime(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
 {
@@ -647,6 +917,7 @@ bool	foundFlag	=	true;
 			break;
 
 		case kCmd_MultiCam_exposuretime:	strcpy(agumentString, "Duration=FLOAT");		break;
+		case kCmd_MultiCam_synctrigger:		strcpy(agumentString, "SyncTrigger=BOOL");		break;
 		case kCmd_MultiCam_livemode:		strcpy(agumentString, "Livemode=BOOL");			break;
 
 		default:
@@ -688,6 +959,23 @@ CameraDriver		*cameraObj;
 																	cameraSring,
 																	cameraObj->cCommonProp.Name,
 																	INCLUDE_COMMA);
+				if (cameraObj->cSyncStartValid)
+				{
+					sprintf(cameraSring, "camera-%d-syncoffset_us", ccc);
+					cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	reqData->socket,
+																		reqData->jsonTextBuffer,
+																		kMaxJsonBuffLen,
+																		cameraSring,
+																		cameraObj->cSyncStartOffset_us,
+																		INCLUDE_COMMA);
+					sprintf(cameraSring, "camera-%d-synclatency_us", ccc);
+					cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	reqData->socket,
+																		reqData->jsonTextBuffer,
+																		kMaxJsonBuffLen,
+																		cameraSring,
+																		cameraObj->cSyncLatency_us,
+																		INCLUDE_COMMA);
+				}
 
 				ccc++;
 			}
@@ -695,6 +983,43 @@ CameraDriver		*cameraObj;
 	}
 
 
+	//===============================================================
+	//*	synchronized trigger statistics
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Bool(	reqData->socket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"synctrigger",
+														cSyncTrigger,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	reqData->socket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"synctriggercount",
+														cSyncTriggerCnt,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	reqData->socket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"syncskew_us",
+														cSyncSkew_us,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	reqData->socket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"syncskewmax_us",
+														cSyncSkewMax_us,
+														INCLUDE_COMMA);
+
+	cBytesWrittenForThisCmd	+=	JsonResponse_Add_Int32(	reqData->socket,
+														reqData->jsonTextBuffer,
+														kMaxJsonBuffLen,
+														"syncgatewait_us",
+														cSyncGateWait_us,
+														INCLUDE_COMMA);
+
 	//===============================================================
 	cBytesWrittenForThisCmd	+=	JsonResponse_Add_String(reqData->socket,
 														reqData->jsonTextBuffer,
@@ -49,10 +49,19 @@ class MultiCam: public AlpacaDriver
 			TYPE_ASCOM_STATUS		Put_StartExposure(	TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
 			TYPE_ASCOM_STATUS		Put_ExposureTime(	TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
 			TYPE_ASCOM_STATUS		Get_Readall(		TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
+			TYPE_ASCOM_STATUS		Put_SyncTrigger(	TYPE_GetPutRequestData *reqData, char *alpacaErrMsg);
+			TYPE_ASCOM_STATUS		StartExposure_Synchronized(const double *expDurationValues_secs, char *alpacaErrMsg);
 
 	protected:
 				int		cCameraCnt;
 				int		cMultiCamState;
+
+				//*	synchronized trigger mode
+				bool	cSyncTrigger;
+				int		cSyncTriggerCnt;
+				int32_t	cSyncSkew_us;			//*	skew of the last trigger
+				int32_t	cSyncSkewMax_us;		//*	worst skew seen since startup
+				int32_t	cSyncGateWait_us;		//*	how long it took all of the camera threads to get to the gate
 };
 
 
@@ -0,0 +1,482 @@
+//*****************************************************************************
+//*	Name:			obscond_stats.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Sliding window statistics for observing conditions sensors
+//*
+//*	The samples are kept in a ring buffer with a running sum and sum of squares
+//*	so the mean and variance do not require going through the window.
+//*	Min and max use monotonic queues (sequence numbers into the ring),
+//*	each sample is added and removed from each queue at most once.
+//*
+//*	The window is time based, so the same code handles a sensor read every
+//*	10 seconds or several times a second. The ring doubles in size when it is full
+//*	and the oldest sample is still inside the window, up to kObsStatsMaxCapacity.
+//*
+//*	The sequence numbers are uint32_t and wrap, the ring size is a power of 2
+//*	so (seq & ringMask) stays continuous across the wrap.
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Re-distributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 18,	2026	<MLS> Created obscond_stats.c
+//*	Oct 18,	2026	<MLS> Ring size is a power of 2 so the index is correct when the sequence wraps
+//*	Oct 18,	2026	<MLS> Ring grows up to kObsStatsMaxCapacity to cover the window
+//*	Oct 18,	2026	<MLS> Added _INCLUDE_OBSCOND_STATS_MAIN_ self test
+//*****************************************************************************
+
+#include	<stdbool.h>
+#include	<stdint.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	<math.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"obscond_stats.h"
+
+#define	RING_IDX(stats, seq)	((seq) & (stats)->ringMask)
+
+//*****************************************************************************
+static int	RoundUpToPowerOf2(const int requestedSize)
+{
+int		ringSize;
+
+	ringSize	=	1;
+	while ((ringSize < requestedSize) && (ringSize < kObsStatsMaxCapacity))
+	{
+		ringSize	=	ringSize * 2;
+	}
+	return(ringSize);
+}
+
+//*****************************************************************************
+bool	ObsStats_Init(TYPE_ObsStats *stats, const int capacity, const double window_secs)
+{
+bool	validFlag;
+
+	memset(stats, 0, sizeof(TYPE_ObsStats));
+	stats->capacity		=	RoundUpToPowerOf2(capacity);
+	stats->ringMask		=	stats->capacity - 1;
+	stats->window_secs	=	window_secs;
+	stats->timeStamp	=	(double *)calloc(stats->capacity, sizeof(double));
+	stats->value		=	(double *)calloc(stats->capacity, sizeof(double));
+	stats->minDeque		=	(uint32_t *)calloc(stats->capacity, sizeof(uint32_t));
+	stats->maxDeque		=	(uint32_t *)calloc(stats->capacity, sizeof(uint32_t));
+	validFlag			=	(stats->timeStamp != NULL) && (stats->value != NULL) &&
+							(stats->minDeque != NULL) && (stats->maxDeque != NULL);
+	if (validFlag == false)
+	{
+		CONSOLE_DEBUG("Failed to allocate memory");
+		ObsStats_Free(stats);
+	}
+	return(validFlag);
+}
+
+//*****************************************************************************
+void	ObsStats_Free(TYPE_ObsStats *stats)
+{
+	free(stats->timeStamp);
+	free(stats->value);
+	free(stats->minDeque);
+	free(stats->maxDeque);
+	stats->timeStamp	=	NULL;
+	stats->value		=	NULL;
+	stats->minDeque		=	NULL;
+	stats->maxDeque		=	NULL;
+	stats->capacity		=	0;
+	stats->ringMask		=	0;
+}
+
+//*****************************************************************************
+//*	doubles the ring, each entry stays at (seq & ringMask) with the new mask
+//*	returns false if the ring is at the max size or the memory is not available
+//*****************************************************************************
+static bool	GrowRing(TYPE_ObsStats *stats)
+{
+int			newCapacity;
+uint32_t	newMask;
+double		*newTimeStamp;
+double		*newValue;
+uint32_t	*newMinDeque;
+uint32_t	*newMaxDeque;
+uint32_t	seq;
+bool		grewOK;
+
+	grewOK		=	false;
+	newCapacity	=	stats->capacity * 2;
+	if (newCapacity <= kObsStatsMaxCapacity)
+	{
+		newMask			=	newCapacity - 1;
+		newTimeStamp	=	(double *)calloc(newCapacity, sizeof(double));
+		newValue		=	(double *)calloc(newCapacity, sizeof(double));
+		newMinDeque		=	(uint32_t *)calloc(newCapacity, sizeof(uint32_t));
+		newMaxDeque		=	(uint32_t *)calloc(newCapacity, sizeof(uint32_t));
+		if ((newTimeStamp != NULL) && (newValue != NULL) && (newMinDeque != NULL) && (newMaxDeque != NULL))
+		{
+			for (seq=stats->oldestSeq; seq != stats->nextSeq; seq++)
+			{
+				newTimeStamp[seq & newMask]	=	stats->timeStamp[RING_IDX(stats, seq)];
+				newValue[seq & newMask]		=	stats->value[RING_IDX(stats, seq)];
+			}
+			for (seq=stats->minHead; seq != stats->minTail; seq++)
+			{
+				newMinDeque[seq & newMask]	=	stats->minDeque[RING_IDX(stats, seq)];
+			}
+			for (seq=stats->maxHead; seq != stats->maxTail; seq++)
+			{
+				newMaxDeque[seq & newMask]	=	stats->maxDeque[RING_IDX(stats, seq)];
+			}
+			free(stats->timeStamp);
+			free(stats->value);
+			free(stats->minDeque);
+			free(stats->maxDeque);
+			stats->timeStamp	=	newTimeStamp;
+			stats->value		=	newValue;
+			stats->minDeque		=	newMinDeque;
+			stats->maxDeque		=	newMaxDeque;
+			stats->capacity		=	newCapacity;
+			stats->ringMask		=	newMask;
+			grewOK				=	true;
+		}
+		else
+		{
+			CONSOLE_DEBUG("Failed to allocate memory");
+			free(newTimeStamp);
+			free(newValue);
+			free(newMinDeque);
+			free(newMaxDeque);
+		}
+	}
+	return(grewOK);
+}
+
+//*****************************************************************************
+static void	RemoveOldest(TYPE_ObsStats *stats)
+{
+double	oldValue;
+
+	oldValue			=	stats->value[RING_IDX(stats, stats->oldestSeq)];
+	stats->sum			-=	oldValue;
+	stats->sumSquares	-=	oldValue * oldValue;
+	if ((stats->minHead != stats->minTail) && (stats->minDeque[RING_IDX(stats, stats->minHead)] == stats->oldestSeq))
+	{
+		stats->minHead++;
+	}
+	if ((stats->maxHead != stats->maxTail) && (stats->maxDeque[RING_IDX(stats, stats->maxHead)] == stats->oldestSeq))
+	{
+		stats->maxHead++;
+	}
+	stats->oldestSeq++;
+}
+
+//*****************************************************************************
+//*	drop everything older than the window, always keep the newest sample
+//*****************************************************************************
+static void	RemoveExpired(TYPE_ObsStats *stats)
+{
+double	newestTime;
+
+	if (stats->nextSeq != stats->oldestSeq)
+	{
+		newestTime	=	stats->timeStamp[RING_IDX(stats, stats->nextSeq - 1)];
+		while (((stats->nextSeq - stats->oldestSeq) > 1) &&
+				(stats->timeStamp[RING_IDX(stats, stats->oldestSeq)] <= (newestTime - stats->window_secs)))
+		{
+			RemoveOldest(stats);
+		}
+	}
+}
+
+//*****************************************************************************
+static void	Resum(TYPE_ObsStats *stats)
+{
+uint32_t	seq;
+double		value;
+
+	stats->sum			=	0.0;
+	stats->sumSquares	=	0.0;
+	for (seq=stats->oldestSeq; seq != stats->nextSeq; seq++)
+	{
+		value				=	stats->value[RING_IDX(stats, seq)];
+		stats->sum			+=	value;
+		stats->sumSquares	+=	value * value;
+	}
+	stats->addsSinceResum	=	0;
+}
+
+//*****************************************************************************
+void	ObsStats_SetWindow(TYPE_ObsStats *stats, const double window_secs)
+{
+	stats->window_secs	=	window_secs;
+	if (stats->capacity > 0)
+	{
+		RemoveExpired(stats);
+	}
+}
+
+//*****************************************************************************
+void	ObsStats_AddSample(TYPE_ObsStats *stats, const double time_secs, const double value)
+{
+uint32_t	ringIdx;
+
+	if (stats->capacity <= 0)
+	{
+		return;
+	}
+	if ((int)(stats->nextSeq - stats->oldestSeq) >= stats->capacity)
+	{
+		//*	the window needs more samples than the ring holds
+		if (GrowRing(stats) == false)
+		{
+			RemoveOldest(stats);
+			stats->droppedForCapacity++;
+		}
+	}
+
+	ringIdx						=	RING_IDX(stats, stats->nextSeq);
+	stats->timeStamp[ringIdx]	=	time_secs;
+	stats->value[ringIdx]		=	value;
+	stats->sum					+=	value;
+	stats->sumSquares			+=	value * value;
+
+	//*	anything larger than the new value can never be the minimum again
+	while ((stats->minTail != stats->minHead) &&
+			(stats->value[RING_IDX(stats, stats->minDeque[RING_IDX(stats, stats->minTail - 1)])] >= value))
+	{
+		stats->minTail--;
+	}
+	stats->minDeque[RING_IDX(stats, stats->minTail)]	=	stats->nextSeq;
+	stats->minTail++;
+
+	while ((stats->maxTail != stats->maxHead) &&
+			(stats->value[RING_IDX(stats, stats->maxDeque[RING_IDX(stats, stats->maxTail - 1)])] <= value))
+	{
+		stats->maxTail--;
+	}
+	stats->maxDeque[RING_IDX(stats, stats->maxTail)]	=	stats->nextSeq;
+	stats->maxTail++;
+
+	stats->nextSeq++;
+	RemoveExpired(stats);
+
+	stats->addsSinceResum++;
+	if ((int)stats->addsSinceResum >= stats->capacity)
+	{
+		Resum(stats);
+	}
+}
+
+//*****************************************************************************
+int	ObsStats_GetCount(const TYPE_ObsStats *stats)
+{
+	return(stats->nextSeq - stats->oldestSeq);
+}
+
+//*****************************************************************************
+double	ObsStats_GetMean(const TYPE_ObsStats *stats)
+{
+int		count;
+
+	count	=	ObsStats_GetCount(stats);
+	return((count > 0) ? (stats->sum / count) : 0.0);
+}
+
+//*****************************************************************************
+double	ObsStats_GetMin(const TYPE_ObsStats *stats)
+{
+	if (stats->minHead == stats->minTail)
+	{
+		return(0.0);
+	}
+	return(stats->value[RING_IDX(stats, stats->minDeque[RING_IDX(stats, stats->minHead)])]);
+}
+
+//*****************************************************************************
+double	ObsStats_GetMax(const TYPE_ObsStats *stats)
+{
+	if (stats->maxHead == stats->maxTail)
+	{
+		return(0.0);
+	}
+	return(stats->value[RING_IDX(stats, stats->maxDeque[RING_IDX(stats, stats->maxHead)])]);
+}
+
+//*****************************************************************************
+//*	population variance of the samples in the window
+//*****************************************************************************
+double	ObsStats_GetVariance(const TYPE_ObsStats *stats)
+{
+int		count;
+double	mean;
+double	variance;
+
+	variance	=	0.0;
+	count		=	ObsStats_GetCount(stats);
+	if (count > 1)
+	{
+		mean		=	stats->sum / count;
+		variance	=	(stats->sumSquares / count) - (mean * mean);
+		if (variance < 0.0)
+		{
+			//*	rounding error when all the values are the same
+			variance	=	0.0;
+		}
+	}
+	return(variance);
+}
+
+//*****************************************************************************
+double	ObsStats_GetStdDev(const TYPE_ObsStats *stats)
+{
+	return(sqrt(ObsStats_GetVariance(stats)));
+}
+
+//*****************************************************************************
+double	ObsStats_GetLatest(const TYPE_ObsStats *stats)
+{
+	if (stats->nextSeq == stats->oldestSeq)
+	{
+		return(0.0);
+	}
+	return(stats->value[RING_IDX(stats, stats->nextSeq - 1)]);
+}
+
+//*****************************************************************************
+//*	the time covered by the samples in the window
+//*****************************************************************************
+double	ObsStats_GetSpan_secs(const TYPE_ObsStats *stats)
+{
+	if (stats->nextSeq == stats->oldestSeq)
+	{
+		return(0.0);
+	}
+	return(stats->timeStamp[RING_IDX(stats, stats->nextSeq - 1)] - stats->timeStamp[RING_IDX(stats, stats->oldestSeq)]);
+}
+
+#ifdef _INCLUDE_OBSCOND_STATS_MAIN_
+//*****************************************************************************
+//*	self test, checks the sliding window against a brute force computation
+//*
+//*	gcc -O2 -D_INCLUDE_OBSCOND_STATS_MAIN_ -I../libs/src_mlsLib obscond_stats.c -lm -o obscond_stats
+//*****************************************************************************
+#include	<stdio.h>
+
+#define	kTestSampleCnt	20000
+
+static double	gTestTime[kTestSampleCnt];
+static double	gTestValue[kTestSampleCnt];
+
+//*****************************************************************************
+//*	adds kTestSampleCnt samples and compares the stats after each one
+//*****************************************************************************
+static int	RunWindowTest(const char *testName, TYPE_ObsStats *stats, const double window_secs, const double sampleInterval)
+{
+int		iii;
+int		jjj;
+int		oldestIdx;
+int		failCnt;
+double	sum;
+double	minValue;
+double	maxValue;
+
+	failCnt	=	0;
+	for (iii=0; iii<kTestSampleCnt; iii++)
+	{
+		gTestTime[iii]	=	iii * sampleInterval;
+		gTestValue[iii]	=	(random() % 10000) / 100.0;
+		ObsStats_AddSample(stats, gTestTime[iii], gTestValue[iii]);
+
+		//*	same rule as RemoveExpired(), the newest sample is always kept
+		oldestIdx	=	iii;
+		while ((oldestIdx > 0) && (gTestTime[oldestIdx - 1] > (gTestTime[iii] - window_secs)))
+		{
+			oldestIdx--;
+		}
+		sum			=	0.0;
+		minValue	=	gTestValue[iii];
+		maxValue	=	gTestValue[iii];
+		for (jjj=oldestIdx; jjj<=iii; jjj++)
+		{
+			sum			+=	gTestValue[jjj];
+			minValue	=	(gTestValue[jjj] < minValue) ? gTestValue[jjj] : minValue;
+			maxValue	=	(gTestValue[jjj] > maxValue) ? gTestValue[jjj] : maxValue;
+		}
+		if ((ObsStats_GetCount(stats) != (iii - oldestIdx + 1)) ||
+			(fabs(ObsStats_GetMean(stats) - (sum / (iii - oldestIdx + 1))) > 1.0e-6) ||
+			(ObsStats_GetMin(stats) != minValue) ||
+			(ObsStats_GetMax(stats) != maxValue))
+		{
+			printf("FAIL: %s, sample %d count=%d expected %d\r\n", testName, iii, ObsStats_GetCount(stats), (iii - oldestIdx + 1));
+			failCnt++;
+			break;
+		}
+	}
+	printf("%-20s ring size=%d, samples in window=%d, dropped=%u\r\n",
+				testName, stats->capacity, ObsStats_GetCount(stats), stats->droppedForCapacity);
+	return(failCnt);
+}
+
+//*****************************************************************************
+int	main(void)
+{
+TYPE_ObsStats	stats;
+int				failCnt;
+
+	failCnt	=	0;
+
+	//*	a capacity that is not a power of 2 is rounded up
+	ObsStats_Init(&stats, 1000, 100.0);
+	if (stats.capacity != 1024)
+	{
+		printf("FAIL: capacity %d is not a power of 2\r\n", stats.capacity);
+		failCnt++;
+	}
+	failCnt	+=	RunWindowTest("small window", &stats, 100.0, 1.0);
+	ObsStats_Free(&stats);
+
+	//*	the sequence numbers wrap around in the middle of the test
+	ObsStats_Init(&stats, 1000, 100.0);
+	stats.oldestSeq	=	0xFFFFFFFF - (kTestSampleCnt / 2);
+	stats.nextSeq	=	stats.oldestSeq;
+	stats.minHead	=	stats.oldestSeq;
+	stats.minTail	=	stats.oldestSeq;
+	stats.maxHead	=	stats.oldestSeq;
+	stats.maxTail	=	stats.oldestSeq;
+	failCnt	+=	RunWindowTest("sequence wrap", &stats, 100.0, 1.0);
+	ObsStats_Free(&stats);
+
+	//*	2 hours at 1 Hz does not fit in the starting ring, it has to grow
+	ObsStats_Init(&stats, kObsStatsDefaultCapacity, 7200.0);
+	failCnt	+=	RunWindowTest("ring grows", &stats, 7200.0, 1.0);
+	if ((stats.capacity <= kObsStatsDefaultCapacity) || (stats.droppedForCapacity != 0))
+	{
+		printf("FAIL: ring did not grow to cover the window\r\n");
+		failCnt++;
+	}
+	ObsStats_Free(&stats);
+
+	//*	window of 0 is the latest reading only
+	ObsStats_Init(&stats, 16, 0.0);
+	failCnt	+=	RunWindowTest("latest only", &stats, 0.0, 1.0);
+	ObsStats_Free(&stats);
+
+	printf("Failures = %d\r\n", failCnt);
+	return(failCnt);
+}
+#endif // _INCLUDE_OBSCOND_STATS_MAIN_
@@ -0,0 +1,65 @@
+//*****************************************************************************
+//#include	"obscond_stats.h"
+
+#ifndef _OBSCOND_STATS_H_
+#define	_OBSCOND_STATS_H_
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define	kObsStatsDefaultCapacity	4096		//*	starting size, must be a power of 2
+#define	kObsStatsMaxCapacity		(256 * 1024)	//*	about 72 hours at 1 sample per second
+
+//*****************************************************************************
+//*	sliding time window statistics, all operations are O(1) (amortized)
+//*	samples older than the window are dropped as new samples arrive
+//*****************************************************************************
+typedef struct	//	TYPE_ObsStats
+{
+	int			capacity;			//*	ring size, always a power of 2
+	uint32_t	ringMask;			//*	capacity - 1
+	double		window_secs;		//*	0 = only the most recent sample
+	double		*timeStamp;			//*	[capacity], seconds
+	double		*value;				//*	[capacity]
+	uint32_t	*minDeque;			//*	[capacity], sample sequence numbers, values increasing
+	uint32_t	*maxDeque;			//*	[capacity], sample sequence numbers, values decreasing
+	uint32_t	oldestSeq;			//*	sequence number of the oldest sample in the window
+	uint32_t	nextSeq;			//*	sequence number of the next sample
+	uint32_t	minHead;
+	uint32_t	minTail;
+	uint32_t	maxHead;
+	uint32_t	maxTail;
+	double		sum;
+	double		sumSquares;
+	uint32_t	addsSinceResum;		//*	the sums are recomputed once per capacity adds to limit drift
+	uint32_t	droppedForCapacity;	//*	samples dropped because the ring was full at kObsStatsMaxCapacity, not because of age
+} TYPE_ObsStats;
+
+
+bool	ObsStats_Init(			TYPE_ObsStats *stats, const int capacity, const double window_secs);
+void	ObsStats_Free(			TYPE_ObsStats *stats);
+void	ObsStats_SetWindow(		TYPE_ObsStats *stats, const double window_secs);
+void	ObsStats_AddSample(		TYPE_ObsStats *stats, const double time_secs, const double value);
+int		ObsStats_GetCount(		const TYPE_ObsStats *stats);
+double	ObsStats_GetMean(		const TYPE_ObsStats *stats);
+double	ObsStats_GetMin(		const TYPE_ObsStats *stats);
+double	ObsStats_GetMax(		const TYPE_ObsStats *stats);
+double	ObsStats_GetVariance(	const TYPE_ObsStats *stats);
+double	ObsStats_GetStdDev(		const TYPE_ObsStats *stats);
+double	ObsStats_GetLatest(		const TYPE_ObsStats *stats);
+double	ObsStats_GetSpan_secs(	const TYPE_ObsStats *stats);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _OBSCOND_STATS_H_
@@ -44,6 +44,10 @@
 //*	Jun 18,	2023	<MLS> Added DeviceState_Add_Content() to obsConditions driver
 //*	May 17,	2024	<MLS> Added http error 400 processing to obsConditions driver
 //*	Jun 28,	2024	<MLS> Removed all "if (reqData != NULL)" from observingconditions.cpp
+//*	Oct 18,	2026	<MLS> Sensor readings are logged to the time series store
+//*	Oct 18,	2026	<MLS> Averaging uses TYPE_ObsStats, window is set by averageperiod
+//*	Oct 18,	2026	<MLS> Time series logging is not gated on IsSupported, pressure stays in kPa
+//*	Oct 18,	2026	<MLS> readall adds <sensor>-span_secs
 //*****************************************************************************
 
 
@@ -79,8 +83,10 @@
 
 #include	"alpacadriver.h"
 #include	"alpacadriver_helper.h"
+#include	"helper_functions.h"
 #include	"obsconditionsdriver.h"
 #include	"obsconditions_globals.h"
+#include	"timeseries_store.h"
 
 #ifndef _OBSERVINGCONDITIONSDRIVER_RPI_H_
 	#include	"obsconditionsdriver_rpi.h"
@@ -139,14 +145,13 @@ int	ii;
 	cSuccesfullReadCnt						=	0;		//*	used to know if we have active sensors
 	cTimeOfLastUpdate_secs					=	0;		//*	time in seconds
 	cObservCondState						=	kObservCondState_Startup;
+	cSampleInterval_secs					=	kSampleDetlaSecs;
 
-
-	//*	zero out the averaging arrays
-	for (ii=0; ii<kAvgSampleCount; ii++)
+	//*	set up the averaging window for each sensor
+	for (ii=0; ii<kSensor_last; ii++)
 	{
-		cPressureArray[ii]		=	0.0;
-		cTemperatureArray[ii]	=	0.0;
-		cHumidityArray[ii]		=	0.0;
+		ObsStats_Init(&cSensorStats[ii], kObsStatsDefaultCapacity, (cObsConditionProp.Averageperiod.Value * 3600.0));
+		cSensorChannel[ii]	=	kTS_NotRegistered;
 	}
 }
 
@@ -156,7 +161,13 @@ int	ii;
 //**************************************************************************************
 ObsConditionsDriver::~ObsConditionsDriver(void)
 {
+int	ii;
+
 	CONSOLE_DEBUG(__FUNCTION__);
+	for (ii=0; ii<kSensor_last; ii++)
+	{
+		ObsStats_Free(&cSensorStats[ii]);
+	}
 }
 
 
@@ -353,7 +364,6 @@ int					mySocket;
 int32_t	ObsConditionsDriver::RunStateMachine(void)
 {
 time_t	currentTimeSecs;
-int		ii;
 
 //	CONSOLE_DEBUG(__FUNCTION__);
 
@@ -361,18 +371,15 @@ int		ii;
 
 	switch(cObservCondState)
 	{
-		//*	the first time thru we are going to read multiple times to fill the buffers
+		//*	the average is over the samples that are in the window, one is enough to start
 		case kObservCondState_Startup:
-			for (ii=0; ii<kAvgSampleCount; ii++)
-			{
-				UpdateSensorsReadings();
-			}
+			UpdateSensorsReadings();
 			cTimeOfLastUpdate_secs	=	time(NULL);
 			cObservCondState		=	kObservCondState_Idle;
 			break;
 
 		case kObservCondState_Idle:
-			if ((currentTimeSecs - cTimeOfLastUpdate_secs) >= kSampleDetlaSecs)
+			if ((currentTimeSecs - cTimeOfLastUpdate_secs) >= cSampleInterval_secs)
 			{
 				UpdateSensorsReadings();
 
@@ -384,45 +391,19 @@ int		ii;
 			break;
 	}
 
-	return(10 * 1000 * 1000);	//*	10 seconds
+	return(cSampleInterval_secs * 1000 * 1000);
 }
 
 //*****************************************************************************
 void	ObsConditionsDriver::UpdateSensorsReadings(void)
 {
-int		ii;
-double	pressureTotal;
-double	temperatureTotal;
-double	humidityTotal;
-
 //	CONSOLE_DEBUG(__FUNCTION__);
-	//*	move everything up in the array
-	for (ii=0; ii< (kAvgSampleCount - 1); ii++)
-	{
-		cPressureArray[ii]		=	cPressureArray[ii + 1];
-		cTemperatureArray[ii]	=	cTemperatureArray[ii + 1];
-		cHumidityArray[ii]		=	cHumidityArray[ii + 1];
-	}
-	//*	read the new values
-	cPressureArray[kAvgSampleCount - 1]		=	ReadPressure_kPa();
-	cTemperatureArray[kAvgSampleCount - 1]	=	ReadTemperature();
-	cHumidityArray[kAvgSampleCount - 1]		=	ReadHumidity();
-
-	//*	now average them
-	pressureTotal		=	0.0;
-	temperatureTotal	=	0.0;
-	humidityTotal		=	0.0;
-	for (ii=0; ii< kAvgSampleCount; ii++)
-	{
-		pressureTotal		+=	cPressureArray[ii];
-		temperatureTotal	+=	cTemperatureArray[ii];
-		humidityTotal		+=	cHumidityArray[ii];
-	}
-	cCurrentPressure_kPa				=	pressureTotal / kAvgSampleCount;
-	cObsConditionProp.Pressure.Value	=	cCurrentPressure_kPa * 10;
-	cObsConditionProp.Temperature.Value	=	temperatureTotal / kAvgSampleCount;
-	cObsConditionProp.Humidity.Value	=	humidityTotal / kAvgSampleCount;
+	//*	pressure is kept in hectoPascals, that is what ASCOM uses
+	AddSensorSample(kSensor_Pressure,		(ReadPressure_kPa() * 10.0));
+	AddSensorSample(kSensor_Temperature,	ReadTemperature());
+	AddSensorSample(kSensor_Humidity,		ReadHumidity());
 
+	cCurrentPressure_kPa	=	cObsConditionProp.Pressure.Value / 10.0;
 
 	//*	update the global copy
 
@@ -508,7 +489,16 @@ double					avgPeriodValue;
 		avgPeriodValue	=	atof(avgPeriodString);
 		if (avgPeriodValue >= 0.0)
 		{
+		int		ii;
+
 			cObsConditionProp.Averageperiod.Value	=	avgPeriodValue;
+			//*	samples older than the new window are dropped right away,
+			//*	a longer window fills in as new samples arrive
+			for (ii=0; ii<kSensor_last; ii++)
+			{
+				ObsStats_SetWindow(&cSensorStats[ii], (avgPeriodValue * 3600.0));
+			}
+			UpdateAveragedValues();
 		}
 		else
 		{
@@ -944,6 +934,86 @@ int						iii;
 	return(mySensorType);
 }
 
+//*****************************************************************************
+TYPE_InstSensor	*ObsConditionsDriver::GetSensorProp(TYPE_ObsConSensorType sensorType)
+{
+TYPE_InstSensor	*sensorPtr;
+
+	switch(sensorType)
+	{
+		case kSensor_CloudCover:		sensorPtr	=	&cObsConditionProp.CloudCover;		break;
+		case kSensor_DewPoint:			sensorPtr	=	&cObsConditionProp.DewPoint;		break;
+		case kSensor_Humidity:			sensorPtr	=	&cObsConditionProp.Humidity;		break;
+		case kSensor_Pressure:			sensorPtr	=	&cObsConditionProp.Pressure;		break;
+		case kSensor_RainRate:			sensorPtr	=	&cObsConditionProp.RainRate;		break;
+		case kSensor_SkyBrightness:		sensorPtr	=	&cObsConditionProp.SkyBrightness;	break;
+		case kSensor_SkyQuality:		sensorPtr	=	&cObsConditionProp.SkyQuality;		break;
+		case kSensor_StarFWHM:			sensorPtr	=	&cObsConditionProp.StarFWHM;		break;
+		case kSensor_SkyTemperature:	sensorPtr	=	&cObsConditionProp.SkyTemperature;	break;
+		case kSensor_Temperature:		sensorPtr	=	&cObsConditionProp.Temperature;		break;
+		case kSensor_WindDirection:		sensorPtr	=	&cObsConditionProp.WindDirection;	break;
+		case kSensor_WindGust:			sensorPtr	=	&cObsConditionProp.WindGust;		break;
+		case kSensor_WindSpeed:			sensorPtr	=	&cObsConditionProp.WindSpeed;		break;
+		default:						sensorPtr	=	NULL;								break;
+	}
+	return(sensorPtr);
+}
+
+//*****************************************************************************
+//*	sub classes can call this at whatever rate the sensor supports,
+//*	the reported value is the average over the average period
+//*****************************************************************************
+void	ObsConditionsDriver::AddSensorSample(TYPE_ObsConSensorType sensorType, const double value)
+{
+TYPE_InstSensor	*sensorPtr;
+struct timeval	currentTime;
+int				iii;
+
+	sensorPtr	=	GetSensorProp(sensorType);
+	if (sensorPtr != NULL)
+	{
+		gettimeofday(&currentTime, NULL);
+		ObsStats_AddSample(	&cSensorStats[sensorType],
+							(currentTime.tv_sec + (currentTime.tv_usec / 1000000.0)),
+							value);
+		sensorPtr->Value		=	ObsStats_GetMean(&cSensorStats[sensorType]);
+		sensorPtr->ValidData	=	true;
+		sensorPtr->LastRead		=	millis();
+
+		//*	log the raw reading, the channel names are the same as the sensor names
+		for (iii=0; gSensorNames[iii].senrsorEnum > kSensor_Invalid; iii++)
+		{
+			if (gSensorNames[iii].senrsorEnum == sensorType)
+			{
+				//*	pressure has always been logged in kPa
+				TimeSeries_Log(	&cSensorChannel[sensorType],
+								gSensorNames[iii].sensorName,
+								((sensorType == kSensor_Pressure) ? (value / 10.0) : value));
+				break;
+			}
+		}
+	}
+}
+
+//*****************************************************************************
+//*	called when the window changes
+//*****************************************************************************
+void	ObsConditionsDriver::UpdateAveragedValues(void)
+{
+TYPE_InstSensor	*sensorPtr;
+int				ii;
+
+	for (ii=0; ii<kSensor_last; ii++)
+	{
+		sensorPtr	=	GetSensorProp((TYPE_ObsConSensorType)ii);
+		if ((sensorPtr != NULL) && (ObsStats_GetCount(&cSensorStats[ii]) > 0))
+		{
+			sensorPtr->Value	=	ObsStats_GetMean(&cSensorStats[ii]);
+		}
+	}
+	cCurrentPressure_kPa	=	cObsConditionProp.Pressure.Value / 10.0;
+}
+
 //*****************************************************************************
 //*	curl -X GET "https://virtserver.swaggerhub.com/ASCOMInitiative/api/v1/observingconditions/0/sensordescription?
 //*		SensorName=Pressure&ClientID=1&ClientTransactionID=1234"
@@ -1197,6 +1267,8 @@ bool	ObsConditionsDriver::DeviceState_Add_Content(const int socketFD, char *json
 TYPE_ASCOM_STATUS	ObsConditionsDriver::Get_Readall(TYPE_GetPutRequestData *reqData, char *alpacaErrMsg)
 {
 TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_Success;
+int					iii;
+char				fieldName[48];
 
 	CONSOLE_DEBUG(__FUNCTION__);
 	//*	do the common ones first
@@ -1214,6 +1286,33 @@ TYPE_ASCOM_STATUS	alpacaErrCode	=	kASCOM_Err_Success;
 	Get_Temperature(		reqData, alpacaErrMsg, "temperature");
 //	Get_TimeSinceLastUpdate(reqData, alpacaErrMsg, "timesincelastupdate");
 
+	//*	statistics over the average period for the sensors that have data
+	for (iii=0; gSensorNames[iii].senrsorEnum > kSensor_Invalid; iii++)
+	{
+	TYPE_ObsStats	*statsPtr;
+
+		statsPtr	=	&cSensorStats[gSensorNames[iii].senrsorEnum];
+		if (ObsStats_GetCount(statsPtr) > 0)
+		{
+			sprintf(fieldName, "%s-min", gSensorNames[iii].sensorName);
+			JsonResponse_Add_Double(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen,
+									fieldName,	ObsStats_GetMin(statsPtr),		INCLUDE_COMMA);
+			sprintf(fieldName, "%s-max", gSensorNames[iii].sensorName);
+			JsonResponse_Add_Double(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen,
+									fieldName,	ObsStats_GetMax(statsPtr),		INCLUDE_COMMA);
+			sprintf(fieldName, "%s-stddev", gSensorNames[iii].sensorName);
+			JsonResponse_Add_Double(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen,
+									fieldName,	ObsStats_GetStdDev(statsPtr),	INCLUDE_COMMA);
+			sprintf(fieldName, "%s-samples", gSensorNames[iii].sensorName);
+			JsonResponse_Add_Int32(	reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen,
+									fieldName,	ObsStats_GetCount(statsPtr),	INCLUDE_COMMA);
+			//*	less than the average period if the ring is at kObsStatsMaxCapacity
+			sprintf(fieldName, "%s-span_secs", gSensorNames[iii].sensorName);
+			JsonResponse_Add_Double(reqData->socket, reqData->jsonTextBuffer, kMaxJsonBuffLen,
+									fieldName,	ObsStats_GetSpan_secs(statsPtr),	INCLUDE_COMMA);
+		}
+	}
+
 	strcpy(alpacaErrMsg, "");
 	return(alpacaErrCode);
 }
@@ -8,6 +8,7 @@
 //*****************************************************************************
 //*	<MLS>	=	Mark L Sproul
 //*****************************************************************************
+//*	Oct 18,	2026	<MLS> Replaced averaging arrays with TYPE_ObsStats for each sensor
 //*****************************************************************************
 //#include	"obsconditionsdriver.h"
 
@@ -23,6 +24,10 @@
 	#include	"alpacadriver.h"
 #endif
 
+#ifndef _OBSCOND_STATS_H_
+	#include	"obscond_stats.h"
+#endif
+
 void	CreateObsConditionObjects(void);
 
 //*****************************************************************************
@@ -54,11 +59,13 @@ enum TYPE_ObsConSensorType
 	kSensor_Temperature,
 	kSensor_WindDirection,
 	kSensor_WindGust,
-	kSensor_WindSpeed
+	kSensor_WindSpeed,
+
+	kSensor_last
 };
 
 
-#define	kAvgSampleCount		20
+#define	kAvgSampleCount		20		//*	default average period is kAvgSampleCount * kSampleDetlaSecs
 #define	kSampleDetlaSecs	10
 //**************************************************************************************
 class ObsConditionsDriver: public AlpacaDriver
@@ -109,6 +116,9 @@ virtual	TYPE_ASCOM_STATUS	GetSensorInfo(			TYPE_ObsConSensorType sensorType,
 		TYPE_ObsConSensorType		GetSensorEnum(const char *sensorName);
 
 				void	UpdateSensorsReadings(void);
+				void	AddSensorSample(TYPE_ObsConSensorType sensorType, const double value);
+				void	UpdateAveragedValues(void);
+		TYPE_InstSensor	*GetSensorProp(TYPE_ObsConSensorType sensorType);
 		virtual	double	ReadPressure_kPa(void);
 		virtual	double	ReadTemperature(void);
 		virtual	double	ReadHumidity(void);
@@ -122,10 +132,10 @@ virtual	TYPE_ASCOM_STATUS	GetSensorInfo(			TYPE_ObsConSensorType sensorType,
 //		bool		cHasHumidSensor;
 
 
-		//*	these arrays are for averaging
-		double		cPressureArray[kAvgSampleCount];
-		double		cTemperatureArray[kAvgSampleCount];
-		double		cHumidityArray[kAvgSampleCount];
+		//*	sliding window statistics for each sensor, the window is the average period
+		TYPE_ObsStats	cSensorStats[kSensor_last];
+		int				cSensorChannel[kSensor_last];		//*	time series channel handles
+		double			cSampleInterval_secs;	//*	how often UpdateSensorsReadings() is called
 
 
 		double		cCurrentPressure_kPa;		//*	kilo Pascals
@@ -13,6 +13,8 @@
 //*	<MLS>	=	Mark L Sproul
 //*****************************************************************************
 //*	Mar  2,	2023	<MLS> Created obsconditionsdriver_sim.cpp
+//*	Oct 18,	2026	<MLS> Simulator now generates temperature, humidity and pressure
+//*	Oct 18,	2026	<MLS> Simulator samples once a second to exercise the averaging window
 //*****************************************************************************
 
 #ifdef _ENABLE_OBSERVINGCONDITIONS_SIMULATOR_
@@ -25,6 +27,8 @@
 #include	<ctype.h>
 #include	<stdint.h>
 #include	<time.h>
+#include	<math.h>
+#include	<sys/time.h>
 
 #define _ENABLE_CONSOLE_DEBUG_
 #include	"ConsoleDebug.h"
@@ -57,6 +61,13 @@ ObsConditionsDriverSIM::ObsConditionsDriverSIM(const int argDevNum)
 	strcpy(gEnvData.siteDataSource,	"AlpacaPi ObsCond Simulator");
 	strcpy(gEnvData.domeDataSource,	"AlpacaPi ObsCond Simulator");
 
+	cObsConditionProp.DewPoint.IsSupported		=	true;
+	cObsConditionProp.Humidity.IsSupported		=	true;
+	cObsConditionProp.Pressure.IsSupported		=	true;
+	cObsConditionProp.Temperature.IsSupported	=	true;
+
+	//*	sample faster than a real sensor so the averaging has something to do
+	cSampleInterval_secs	=	1.0;
 }
 
 //**************************************************************************************
@@ -91,11 +102,13 @@ TYPE_ASCOM_STATUS		alpacaErrCode	=	kASCOM_Err_Success;
 			break;
 
 		case kSensor_Humidity:
-			alpacaErrCode	=	kASCOM_Err_MethodNotImplemented;
+			alpacaErrCode	=	kASCOM_Err_Success;
+			strcpy(description, "AlpacaPi: Simulated humidity");
 			break;
 
 		case kSensor_Pressure:
-			alpacaErrCode	=	kASCOM_Err_MethodNotImplemented;
+			alpacaErrCode	=	kASCOM_Err_Success;
+			strcpy(description, "AlpacaPi: Simulated pressure");
 			break;
 
 		case kSensor_RainRate:
@@ -119,7 +132,8 @@ TYPE_ASCOM_STATUS		alpacaErrCode	=	kASCOM_Err_Success;
 			break;
 
 		case kSensor_Temperature:
-			alpacaErrCode	=	kASCOM_Err_MethodNotImplemented;
+			alpacaErrCode	=	kASCOM_Err_Success;
+			strcpy(description, "AlpacaPi: Simulated temperature");
 			break;
 
 		case kSensor_WindDirection:
@@ -142,6 +156,37 @@ TYPE_ASCOM_STATUS		alpacaErrCode	=	kASCOM_Err_Success;
 
 }
 
+//*****************************************************************************
+//*	0.0 -> 1.0 over the day
+//*****************************************************************************
+double	ObsConditionsDriverSIM::GetDayFraction(void)
+{
+struct timeval	currentTime;
+
+	gettimeofday(&currentTime, NULL);
+	return((currentTime.tv_sec % (24 * 60 * 60)) / (24.0 * 60.0 * 60.0));
+}
+
+//*****************************************************************************
+//*	simulated readings follow a daily cycle plus some noise
+//*****************************************************************************
+double	ObsConditionsDriverSIM::ReadPressure_kPa(void)
+{
+	return(101.3 + (0.3 * sin(2.0 * M_PI * GetDayFraction())) + ((rand() % 100) / 2000.0));
+}
+
+//*****************************************************************************
+double	ObsConditionsDriverSIM::ReadTemperature(void)
+{
+	return(10.0 + (5.0 * sin(2.0 * M_PI * GetDayFraction())) + ((rand() % 100) / 250.0));
+}
+
+//*****************************************************************************
+double	ObsConditionsDriverSIM::ReadHumidity(void)
+{
+	return(60.0 - (20.0 * sin(2.0 * M_PI * GetDayFraction())) + ((rand() % 100) / 50.0));
+}
+
 
 #endif	//	_ENABLE_OBSERVINGCONDITIONS_SIMULATOR_
 
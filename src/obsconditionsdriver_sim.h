@@ -9,6 +9,7 @@
 //*	<MLS>	=	Mark L Sproul
 //*****************************************************************************
 //*	Mar  2,	2023	<MLS> Created obsconditionsdriver_sim.h
+//*	Oct 18,	2026	<MLS> Simulator now generates temperature, humidity and pressure
 //*****************************************************************************
 //#include	"obsconditionsdriver_sim.h"
 
@@ -40,9 +41,10 @@ class ObsConditionsDriverSIM: public ObsConditionsDriver
 
 
 	protected:
-//		virtual	double	ReadPressure_kPa(void);
-//		virtual	double	ReadTemperature(void);
-//		virtual	double	ReadHumidity(void);
+		virtual	double	ReadPressure_kPa(void);
+		virtual	double	ReadTemperature(void);
+		virtual	double	ReadHumidity(void);
+				double	GetDayFraction(void);
 
 virtual	TYPE_ASCOM_STATUS	GetSensorInfo(			TYPE_ObsConSensorType sensorType,
 													char	*description,
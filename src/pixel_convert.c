@@ -0,0 +1,1929 @@
+//*****************************************************************************
+//*	Name:			pixel_convert.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	pixel format conversions for the camera pipeline,
+//*					widen / narrow, byte swap, BGR <-> RGB, planar <-> interleaved
+//*					and the row major to column major transposes that imagearray,
+//*					rgbarray and the FITS color save need.
+//*
+//*	Each kernel has a plain C version and SSE2 / SSSE3 / AVX2 (x86) or NEON (ARM)
+//*	versions. The x86 versions are picked at run time from what the cpu says it
+//*	supports, so one binary runs everywhere. The NEON versions have not been built
+//*	or run through pixconvtest on ARM yet, they are only compiled in when
+//*	_ENABLE_PIXCONV_NEON_ is defined, otherwise ARM uses the plain C code.
+//*	Every SIMD loop finishes the left over pixels with the plain C code.
+//*
+//*	The transposes work on 64x64 tiles so the strided side stays in cache,
+//*	the 8 and 16 bit ones transpose 16x16 / 8x8 blocks in SSE2 or NEON registers.
+//*
+//*	This file is compiled with -O3, cameradriver.cpp is not optimized.
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Re-distributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 18,	2026	<MLS> Created pixel_convert.c
+//*	Oct 18,	2026	<MLS> Moved the NEON deinterleave here from cameradriver_fits.cpp
+//*	Oct 18,	2026	<MLS> Added NEON 8 and 16 bit transposes
+//*	Oct 18,	2026	<MLS> NEON is opt in (_ENABLE_PIXCONV_NEON_) until it has been tested on ARM
+//*****************************************************************************
+
+#include	<stdbool.h>
+#include	<stdint.h>
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"pixel_convert.h"
+
+#if defined(__x86_64__) || defined(__i386__)
+	#define	_PIXCONV_X86_
+	#include	<immintrin.h>
+	#define	PIXCONV_SSE2	__attribute__((target("sse2")))
+	#define	PIXCONV_SSSE3	__attribute__((target("ssse3")))
+	#define	PIXCONV_AVX2	__attribute__((target("avx2")))
+#endif
+
+#if defined(__ARM_NEON) && defined(_ENABLE_PIXCONV_NEON_)
+	#define	_PIXCONV_NEON_
+	#include	<arm_neon.h>
+#endif
+
+static int	gPixConvMaxLevel	=	-1;		//*	-1 = not checked yet
+static int	gPixConvLevel		=	-1;
+#ifdef _PIXCONV_X86_
+static uint8_t	gDeinterleaveMasks[3][3][16];
+static uint8_t	gInterleaveMasks[3][3][16];
+static void		BuildShuffleMasks(void);
+#endif
+
+static const char	*gPixConvLevelNames[]	=
+{
+	"Scalar",
+	"SSE2",
+	"SSSE3",
+	"AVX2",
+	"NEON"
+};
+
+//*****************************************************************************
+static void	PixConv_Detect(void)
+{
+int		maxLevel;
+
+	maxLevel	=	kPixConv_Scalar;
+#if defined(_PIXCONV_NEON_)
+	maxLevel	=	kPixConv_NEON;
+#elif defined(_PIXCONV_X86_)
+	BuildShuffleMasks();
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2"))
+	{
+		maxLevel	=	kPixConv_AVX2;
+	}
+	else if (__builtin_cpu_supports("ssse3"))
+	{
+		maxLevel	=	kPixConv_SSSE3;
+	}
+	else if (__builtin_cpu_supports("sse2"))
+	{
+		maxLevel	=	kPixConv_SSE2;
+	}
+#endif
+	gPixConvMaxLevel	=	maxLevel;
+	if (gPixConvLevel < 0)
+	{
+		gPixConvLevel	=	maxLevel;
+	}
+}
+
+//*****************************************************************************
+int	PixConv_GetLevel(void)
+{
+	if (gPixConvMaxLevel < 0)
+	{
+		PixConv_Detect();
+	}
+	return(gPixConvLevel);
+}
+
+//*****************************************************************************
+//*	for testing, returns the level actually in use,
+//*	asking for more than the cpu has gives the best it has
+//*****************************************************************************
+int	PixConv_SetLevel(const int level)
+{
+	if (gPixConvMaxLevel < 0)
+	{
+		PixConv_Detect();
+	}
+	if ((level < kPixConv_Scalar) || (level > gPixConvMaxLevel))
+	{
+		gPixConvLevel	=	gPixConvMaxLevel;
+	}
+	else if ((gPixConvMaxLevel == kPixConv_NEON) && (level != kPixConv_Scalar))
+	{
+		gPixConvLevel	=	kPixConv_NEON;
+	}
+	else
+	{
+		gPixConvLevel	=	level;
+	}
+	return(gPixConvLevel);
+}
+
+//*****************************************************************************
+const char	*PixConv_GetLevelName(const int level)
+{
+	if ((level >= kPixConv_Scalar) && (level < kPixConv_LevelCnt))
+	{
+		return(gPixConvLevelNames[level]);
+	}
+	return("unknown");
+}
+
+#pragma mark -
+//*****************************************************************************
+//*	plain C versions, also used for the left over pixels of the SIMD loops
+//*****************************************************************************
+static void	Widen8to16_C(uint16_t *dst, const uint8_t *src, const size_t count, const int shift)
+{
+size_t	iii;
+
+	for (iii=0; iii<count; iii++)
+	{
+		dst[iii]	=	(uint16_t)(src[iii] << shift);
+	}
+}
+
+//*****************************************************************************
+static void	Widen8to32_C(uint32_t *dst, const uint8_t *src, const size_t count, const int shift)
+{
+size_t	iii;
+
+	for (iii=0; iii<count; iii++)
+	{
+		dst[iii]	=	(uint32_t)src[iii] << shift;
+	}
+}
+
+//*****************************************************************************
+static void	Widen16to32_C(uint32_t *dst, const uint16_t *src, const size_t count, const int shift)
+{
+size_t	iii;
+
+	for (iii=0; iii<count; iii++)
+	{
+		dst[iii]	=	(uint32_t)src[iii] << shift;
+	}
+}
+
+//*****************************************************************************
+static void	Narrow16to8_C(uint8_t *dst, const uint16_t *src, const size_t count)
+{
+size_t	iii;
+
+	for (iii=0; iii<count; iii++)
+	{
+		dst[iii]	=	(uint8_t)(src[iii] >> 8);
+	}
+}
+
+//*****************************************************************************
+static void	ByteSwap16_C(uint16_t *dst, const uint16_t *src, const size_t count)
+{
+size_t	iii;
+
+	for (iii=0; iii<count; iii++)
+	{
+		dst[iii]	=	(uint16_t)((src[iii] << 8) | (src[iii] >> 8));
+	}
+}
+
+//*****************************************************************************
+static void	SwapRB24_C(uint8_t *dst, const uint8_t *src, const size_t pixelCount)
+{
+size_t	iii;
+uint8_t	firstByte;
+
+	for (iii=0; iii<pixelCount; iii++)
+	{
+		firstByte	=	src[0];		//*	dst and src can be the same buffer
+		dst[0]		=	src[2];
+		dst[1]		=	src[1];
+		dst[2]		=	firstByte;
+		dst			+=	3;
+		src			+=	3;
+	}
+}
+
+//*****************************************************************************
+static void	Deinterleave24_C(	uint8_t			*plane0,
+								uint8_t			*plane1,
+								uint8_t			*plane2,
+								const uint8_t	*src,
+								const size_t	pixelCount)
+{
+size_t	iii;
+
+	for (iii=0; iii<pixelCount; iii++)
+	{
+		plane0[iii]	=	*src++;
+		plane1[iii]	=	*src++;
+		plane2[iii]	=	*src++;
+	}
+}
+
+//*****************************************************************************
+static void	Interleave24_C(	uint8_t			*dst,
+							const uint8_t	*plane0,
+							const uint8_t	*plane1,
+							const uint8_t	*plane2,
+							const size_t	pixelCount)
+{
+size_t	iii;
+
+	for (iii=0; iii<pixelCount; iii++)
+	{
+		*dst++	=	plane0[iii];
+		*dst++	=	plane1[iii];
+		*dst++	=	plane2[iii];
+	}
+}
+
+//*****************************************************************************
+//*	dst[(x * dstStride) + y] = src[(y * srcStride) + x]
+//*****************************************************************************
+static void	TransposeBlock8_C(	uint8_t			*dst,
+								const size_t	dstStride,
+								const uint8_t	*src,
+								const size_t	srcStride,
+								const int		width,
+								const int		height)
+{
+int		xxx;
+int		yyy;
+
+	for (xxx=0; xxx<width; xxx++)
+	{
+		for (yyy=0; yyy<height; yyy++)
+		{
+			dst[((size_t)xxx * dstStride) + yyy]	=	src[((size_t)yyy * srcStride) + xxx];
+		}
+	}
+}
+
+//*****************************************************************************
+static void	TransposeBlock16_C(	uint16_t		*dst,
+								const size_t	dstStride,
+								const uint16_t	*src,
+								const size_t	srcStride,
+								const int		width,
+								const int		height)
+{
+int		xxx;
+int		yyy;
+
+	for (xxx=0; xxx<width; xxx++)
+	{
+		for (yyy=0; yyy<height; yyy++)
+		{
+			dst[((size_t)xxx * dstStride) + yyy]	=	src[((size_t)yyy * srcStride) + xxx];
+		}
+	}
+}
+
+//*****************************************************************************
+//*	strides are in pixels
+//*****************************************************************************
+static void	TransposeBlock24_C(	uint8_t			*dst,
+								const size_t	dstStride,
+								const uint8_t	*src,
+								const size_t	srcStride,
+								const int		width,
+								const int		height,
+								const bool		swapRB)
+{
+const uint8_t	*srcPtr;
+uint8_t			*dstPtr;
+int				firstIdx;
+int				lastIdx;
+int				xxx;
+int				yyy;
+
+	firstIdx	=	swapRB ? 2 : 0;
+	lastIdx		=	2 - firstIdx;
+	for (xxx=0; xxx<width; xxx++)
+	{
+		srcPtr	=	src + ((size_t)xxx * 3);
+		dstPtr	=	dst + ((size_t)xxx * dstStride * 3);
+		for (yyy=0; yyy<height; yyy++)
+		{
+			dstPtr[0]	=	srcPtr[firstIdx];
+			dstPtr[1]	=	srcPtr[1];
+			dstPtr[2]	=	srcPtr[lastIdx];
+			dstPtr		+=	3;
+			srcPtr		+=	srcStride * 3;
+		}
+	}
+}
+
+#ifdef _PIXCONV_X86_
+#pragma mark -
+//*****************************************************************************
+//*	x86, SSE2 is always there on x86_64, SSSE3 adds pshufb, AVX2 is 32 bytes wide
+//*****************************************************************************
+PIXCONV_SSE2 static void	Widen8to16_SSE2(uint16_t *dst, const uint8_t *src, const size_t count, const int shift)
+{
+size_t	iii;
+__m128i	zero;
+__m128i	shiftCnt;
+__m128i	srcData;
+
+	zero		=	_mm_setzero_si128();
+	shiftCnt	=	_mm_cvtsi32_si128(shift);
+	for (iii=0; (iii + 16) <= count; iii += 16)
+	{
+		srcData	=	_mm_loadu_si128((const __m128i *)(src + iii));
+		_mm_storeu_si128((__m128i *)(dst + iii),		_mm_sll_epi16(_mm_unpacklo_epi8(srcData, zero), shiftCnt));
+		_mm_storeu_si128((__m128i *)(dst + iii + 8),	_mm_sll_epi16(_mm_unpackhi_epi8(srcData, zero), shiftCnt));
+	}
+	Widen8to16_C(dst + iii, src + iii, count - iii, shift);
+}
+
+//*****************************************************************************
+PIXCONV_AVX2 static void	Widen8to16_AVX2(uint16_t *dst, const uint8_t *src, const size_t count, const int shift)
+{
+size_t	iii;
+__m128i	shiftCnt;
+
+	shiftCnt	=	_mm_cvtsi32_si128(shift);
+	for (iii=0; (iii + 32) <= count; iii += 32)
+	{
+		_mm256_storeu_si256((__m256i *)(dst + iii),
+							_mm256_sll_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(src + iii))), shiftCnt));
+		_mm256_storeu_si256((__m256i *)(dst + iii + 16),
+							_mm256_sll_epi16(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)(src + iii + 16))), shiftCnt));
+	}
+	Widen8to16_C(dst + iii, src + iii, count - iii, shift);
+}
+
+//*****************************************************************************
+PIXCONV_SSE2 static void	Widen8to32_SSE2(uint32_t *dst, const uint8_t *src, const size_t count, const int shift)
+{
+size_t	iii;
+__m128i	zero;
+__m128i	shiftCnt;
+__m128i	srcData;
+__m128i	lo16;
+__m128i	hi16;
+
+	zero		=	_mm_setzero_si128();
+	shiftCnt	=	_mm_cvtsi32_si128(shift);
+	for (iii=0; (iii + 16) <= count; iii += 16)
+	{
+		srcData	=	_mm_loadu_si128((const __m128i *)(src + iii));
+		lo16	=	_mm_unpacklo_epi8(srcData, zero);
+		hi16	=	_mm_unpackhi_epi8(srcData, zero);
+		_mm_storeu_si128((__m128i *)(dst + iii),		_mm_sll_epi32(_mm_unpacklo_epi16(lo16, zero), shiftCnt));
+		_mm_storeu_si128((__m128i *)(dst + iii + 4),	_mm_sll_epi32(_mm_unpackhi_epi16(lo16, zero), shiftCnt));
+		_mm_storeu_si128((__m128i *)(dst + iii + 8),	_mm_sll_epi32(_mm_unpacklo_epi16(hi16, zero), shiftCnt));
+		_mm_storeu_si128((__m128i *)(dst + iii + 12),	_mm_sll_epi32(_mm_unpackhi_epi16(hi16, zero), shiftCnt));
+	}
+	Widen8to32_C(dst + iii, src + iii, count - iii, shift);
+}
+
+//*****************************************************************************
+PIXCONV_AVX2 static void	Widen8to32_AVX2(uint32_t *dst, const uint8_t *src, const size_t count, const int shift)
+{
+size_t	iii;
+__m128i	shiftCnt;
+
+	shiftCnt	=	_mm_cvtsi32_si128(shift);
+	for (iii=0; (iii + 16) <= count; iii += 16)
+	{
+		_mm256_storeu_si256((__m256i *)(dst + iii),
+							_mm256_sll_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(src + iii))), shiftCnt));
+		_mm256_storeu_si256((__m256i *)(dst + iii + 8),
+							_mm256_sll_epi32(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(src + iii + 8))), shiftCnt));
+	}
+	Widen8to32_C(dst + iii, src + iii, count - iii, shift);
+}
+
+//*****************************************************************************
+PIXCONV_SSE2 static void	Widen16to32_SSE2(uint32_t *dst, const uint16_t *src, const size_t count, const int shift)
+{
+size_t	iii;
+__m128i	zero;
+__m128i	shiftCnt;
+__m128i	srcData;
+
+	zero		=	_mm_setzero_si128();
+	shiftCnt	=	_mm_cvtsi32_si128(shift);
+	for (iii=0; (iii + 8) <= count; iii += 8)
+	{
+		srcData	=	_mm_loadu_si128((const __m128i *)(src + iii));
+		_mm_storeu_si128((__m128i *)(dst + iii),		_mm_sll_epi32(_mm_unpacklo_epi16(srcData, zero), shiftCnt));
+		_mm_storeu_si128((__m128i *)(dst + iii + 4),	_mm_sll_epi32(_mm_unpackhi_epi16(srcData, zero), shiftCnt));
+	}
+	Widen16to32_C(dst + iii, src + iii, count - iii, shift);
+}
+
+//*****************************************************************************
+PIXCONV_AVX2 static void	Widen16to32_AVX2(uint32_t *dst, const uint16_t *src, const size_t count, const int shift)
+{
+size_t	iii;
+__m128i	shiftCnt;
+
+	shiftCnt	=	_mm_cvtsi32_si128(shift);
+	for (iii=0; (iii + 16) <= count; iii += 16)
+	{
+		_mm256_storeu_si256((__m256i *)(dst + iii),
+							_mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(src + iii))), shiftCnt));
+		_mm256_storeu_si256((__m256i *)(dst + iii + 8),
+							_mm256_sll_epi32(_mm256_cvtepu16_epi32(_mm_loadu_si128((const __m128i *)(src + iii + 8))), shiftCnt));
+	}
+	Widen16to32_C(dst + iii, src + iii, count - iii, shift);
+}
+
+//*****************************************************************************
+PIXCONV_SSE2 static void	Narrow16to8_SSE2(uint8_t *dst, const uint16_t *src, const size_t count)
+{
+size_t	iii;
+__m128i	loHalf;
+__m128i	hiHalf;
+
+	for (iii=0; (iii + 16) <= count; iii += 16)
+	{
+		loHalf	=	_mm_srli_epi16(_mm_loadu_si128((const __m128i *)(src + iii)), 8);
+		hiHalf	=	_mm_srli_epi16(_mm_loadu_si128((const __m128i *)(src + iii + 8)), 8);
+		_mm_storeu_si128((__m128i *)(dst + iii), _mm_packus_epi16(loHalf, hiHalf));
+	}
+	Narrow16to8_C(dst + iii, src + iii, count - iii);
+}
+
+//*****************************************************************************
+PIXCONV_AVX2 static void	Narrow16to8_AVX2(uint8_t *dst, const uint16_t *src, const size_t count)
+{
+size_t	iii;
+__m256i	loHalf;
+__m256i	hiHalf;
+
+	for (iii=0; (iii + 32) <= count; iii += 32)
+	{
+		loHalf	=	_mm256_srli_epi16(_mm256_loadu_si256((const __m256i *)(src + iii)), 8);
+		hiHalf	=	_mm256_srli_epi16(_mm256_loadu_si256((const __m256i *)(src + iii + 16)), 8);
+		//*	packus works inside each 128 bit lane, put the quarters back in order
+		_mm256_storeu_si256((__m256i *)(dst + iii), _mm256_permute4x64_epi64(_mm256_packus_epi16(loHalf, hiHalf), 0xD8));
+	}
+	Narrow16to8_C(dst + iii, src + iii, count - iii);
+}
+
+//*****************************************************************************
+PIXCONV_SSE2 static void	ByteSwap16_SSE2(uint16_t *dst, const uint16_t *src, const size_t count)
+{
+size_t	iii;
+__m128i	srcData;
+
+	for (iii=0; (iii + 8) <= count; iii += 8)
+	{
+		srcData	=	_mm_loadu_si128((const __m128i *)(src + iii));
+		_mm_storeu_si128((__m128i *)(dst + iii), _mm_or_si128(_mm_slli_epi16(srcData, 8), _mm_srli_epi16(srcData, 8)));
+	}
+	ByteSwap16_C(dst + iii, src + iii, count - iii);
+}
+
+//*****************************************************************************
+PIXCONV_AVX2 static void	ByteSwap16_AVX2(uint16_t *dst, const uint16_t *src, const size_t count)
+{
+size_t	iii;
+__m256i	swapMask;
+
+	swapMask	=	_mm256_setr_epi8(	1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14,
+										1, 0, 3, 2, 5, 4, 7, 6, 9, 8, 11, 10, 13, 12, 15, 14);
+	for (iii=0; (iii + 16) <= count; iii += 16)
+	{
+		_mm256_storeu_si256((__m256i *)(dst + iii),
+							_mm256_shuffle_epi8(_mm256_loadu_si256((const __m256i *)(src + iii)), swapMask));
+	}
+	ByteSwap16_C(dst + iii, src + iii, count - iii);
+}
+
+//*****************************************************************************
+//*	16 bytes at a time holds 5 whole pixels, step 15 and leave byte 15 alone.
+//*	Byte 15 is written back unchanged before the next load reads it, so this
+//*	also works in place.
+//*****************************************************************************
+PIXCONV_SSSE3 static void	SwapRB24_SSSE3(uint8_t *dst, const uint8_t *src, const size_t pixelCount)
+{
+size_t	byteCount;
+size_t	iii;
+__m128i	swapMask;
+
+	swapMask	=	_mm_setr_epi8(2, 1, 0, 5, 4, 3, 8, 7, 6, 11, 10, 9, 14, 13, 12, 15);
+	byteCount	=	pixelCount * 3;
+	for (iii=0; (iii + 16) <= byteCount; iii += 15)
+	{
+		_mm_storeu_si128((__m128i *)(dst + iii), _mm_shuffle_epi8(_mm_loadu_si128((const __m128i *)(src + iii)), swapMask));
+	}
+	SwapRB24_C(dst + iii, src + iii, (byteCount - iii) / 3);
+}
+
+//*****************************************************************************
+//*	the pshufb masks for 16 pixels (48 bytes, 3 registers),
+//*	0x80 in a mask gives a zero byte so the 3 shuffles can be or'ed together.
+//*	Built once by PixConv_Detect()
+//*****************************************************************************
+static void	BuildShuffleMasks(void)
+{
+int		plane;
+int		reg;
+int		iii;
+int		byteIdx;
+
+	for (plane=0; plane<3; plane++)
+	{
+		for (reg=0; reg<3; reg++)
+		{
+			for (iii=0; iii<16; iii++)
+			{
+				//*	pixel iii of this plane comes from byte (iii * 3) + plane
+				byteIdx	=	(iii * 3) + plane;
+				gDeinterleaveMasks[plane][reg][iii]	=	((byteIdx / 16) == reg) ? (byteIdx % 16) : 0x80;
+
+				//*	output byte (reg * 16) + iii is pixel byteIdx / 3 of plane byteIdx % 3
+				byteIdx	=	(reg * 16) + iii;
+				gInterleaveMasks[reg][plane][iii]	=	((byteIdx % 3) == plane) ? (byteIdx / 3) : 0x80;
+			}
+		}
+	}
+}
+
+//*****************************************************************************
+PIXCONV_SSSE3 static void	Deinterleave24_SSSE3(	uint8_t			*plane0,
+													uint8_t			*plane1,
+													uint8_t			*plane2,
+													const uint8_t	*src,
+													const size_t	pixelCount)
+{
+__m128i	masks[3][3];
+__m128i	srcData[3];
+__m128i	planeData;
+uint8_t	*planes[3];
+size_t	iii;
+int		ppp;
+
+	for (ppp=0; ppp<3; ppp++)
+	{
+		masks[ppp][0]	=	_mm_loadu_si128((const __m128i *)gDeinterleaveMasks[ppp][0]);
+		masks[ppp][1]	=	_mm_loadu_si128((const __m128i *)gDeinterleaveMasks[ppp][1]);
+		masks[ppp][2]	=	_mm_loadu_si128((const __m128i *)gDeinterleaveMasks[ppp][2]);
+	}
+	planes[0]	=	plane0;
+	planes[1]	=	plane1;
+	planes[2]	=	plane2;
+	for (iii=0; (iii + 16) <= pixelCount; iii += 16)
+	{
+		srcData[0]	=	_mm_loadu_si128((const __m128i *)(src + (iii * 3)));
+		srcData[1]	=	_mm_loadu_si128((const __m128i *)(src + (iii * 3) + 16));
+		srcData[2]	=	_mm_loadu_si128((const __m128i *)(src + (iii * 3) + 32));
+		for (ppp=0; ppp<3; ppp++)
+		{
+			planeData	=	_mm_or_si128(	_mm_or_si128(	_mm_shuffle_epi8(srcData[0], masks[ppp][0]),
+															_mm_shuffle_epi8(srcData[1], masks[ppp][1])),
+											_mm_shuffle_epi8(srcData[2], masks[ppp][2]));
+			_mm_storeu_si128((__m128i *)(planes[ppp] + iii), planeData);
+		}
+	}
+	Deinterleave24_C(plane0 + iii, plane1 + iii, plane2 + iii, src + (iii * 3), pixelCount - iii);
+}
+
+//*****************************************************************************
+PIXCONV_SSSE3 static void	Interleave24_SSSE3(	uint8_t			*dst,
+												const uint8_t	*plane0,
+												const uint8_t	*plane1,
+												const uint8_t	*plane2,
+												const size_t	pixelCount)
+{
+__m128i	masks[3][3];
+__m128i	planeData[3];
+__m128i	dstData;
+size_t	iii;
+int		reg;
+
+	for (reg=0; reg<3; reg++)
+	{
+		masks[reg][0]	=	_mm_loadu_si128((const __m128i *)gInterleaveMasks[reg][0]);
+		masks[reg][1]	=	_mm_loadu_si128((const __m128i *)gInterleaveMasks[reg][1]);
+		masks[reg][2]	=	_mm_loadu_si128((const __m128i *)gInterleaveMasks[reg][2]);
+	}
+	for (iii=0; (iii + 16) <= pixelCount; iii += 16)
+	{
+		planeData[0]	=	_mm_loadu_si128((const __m128i *)(plane0 + iii));
+		planeData[1]	=	_mm_loadu_si128((const __m128i *)(plane1 + iii));
+		planeData[2]	=	_mm_loadu_si128((const __m128i *)(plane2 + iii));
+		for (reg=0; reg<3; reg++)
+		{
+			dstData	=	_mm_or_si128(	_mm_or_si128(	_mm_shuffle_epi8(planeData[0], masks[reg][0]),
+														_mm_shuffle_epi8(planeData[1], masks[reg][1])),
+										_mm_shuffle_epi8(planeData[2], masks[reg][2]));
+			_mm_storeu_si128((__m128i *)(dst + (iii * 3) + (reg * 16)), dstData);
+		}
+	}
+	Interleave24_C(dst + (iii * 3), plane0 + iii, plane1 + iii, plane2 + iii, pixelCount - iii);
+}
+
+//*****************************************************************************
+//*	16x16 bytes, 4 rounds of unpacks, each round doubles the size of the
+//*	pieces that are already in column order
+//*****************************************************************************
+PIXCONV_SSE2 static void	Transpose8_16x16_SSE2(	uint8_t			*dst,
+													const size_t	dstStride,
+													const uint8_t	*src,
+													const size_t	srcStride)
+{
+__m128i	rows[16];
+__m128i	stage1[16];
+__m128i	stage2[16];
+__m128i	stage3[2][8];
+int		iii;
+int		jjj;
+int		qqq;
+
+	for (iii=0; iii<16; iii++)
+	{
+		rows[iii]	=	_mm_loadu_si128((const __m128i *)(src + (iii * srcStride)));
+	}
+	//*	pairs of rows, 16 bit pieces: [0] = columns 0-7, [1] = columns 8-15
+	for (iii=0; iii<8; iii++)
+	{
+		stage1[2 * iii]			=	_mm_unpacklo_epi8(rows[2 * iii], rows[(2 * iii) + 1]);
+		stage1[(2 * iii) + 1]	=	_mm_unpackhi_epi8(rows[2 * iii], rows[(2 * iii) + 1]);
+	}
+	//*	groups of 4 rows, 32 bit pieces, 4 columns per register
+	for (jjj=0; jjj<4; jjj++)
+	{
+		stage2[(4 * jjj) + 0]	=	_mm_unpacklo_epi16(stage1[4 * jjj],			stage1[(4 * jjj) + 2]);
+		stage2[(4 * jjj) + 1]	=	_mm_unpackhi_epi16(stage1[4 * jjj],			stage1[(4 * jjj) + 2]);
+		stage2[(4 * jjj) + 2]	=	_mm_unpacklo_epi16(stage1[(4 * jjj) + 1],	stage1[(4 * jjj) + 3]);
+		stage2[(4 * jjj) + 3]	=	_mm_unpackhi_epi16(stage1[(4 * jjj) + 1],	stage1[(4 * jjj) + 3]);
+	}
+	//*	groups of 8 rows, 64 bit pieces, 2 columns per register
+	for (iii=0; iii<2; iii++)
+	{
+		for (qqq=0; qqq<4; qqq++)
+		{
+			stage3[iii][2 * qqq]		=	_mm_unpacklo_epi32(stage2[(8 * iii) + qqq], stage2[(8 * iii) + 4 + qqq]);
+			stage3[iii][(2 * qqq) + 1]	=	_mm_unpackhi_epi32(stage2[(8 * iii) + qqq], stage2[(8 * iii) + 4 + qqq]);
+		}
+	}
+	//*	all 16 rows
+	for (iii=0; iii<8; iii++)
+	{
+		_mm_storeu_si128((__m128i *)(dst + ((2 * iii) * dstStride)),		_mm_unpacklo_epi64(stage3[0][iii], stage3[1][iii]));
+		_mm_storeu_si128((__m128i *)(dst + (((2 * iii) + 1) * dstStride)),	_mm_unpackhi_epi64(stage3[0][iii], stage3[1][iii]));
+	}
+}
+
+//*****************************************************************************
+PIXCONV_SSE2 static void	Transpose16_8x8_SSE2(	uint16_t		*dst,
+													const size_t	dstStride,
+													const uint16_t	*src,
+													const size_t	srcStride)
+{
+__m128i	rows[8];
+__m128i	stage1[8];
+__m128i	stage2[8];
+int		iii;
+
+	for (iii=0; iii<8; iii++)
+	{
+		rows[iii]	=	_mm_loadu_si128((const __m128i *)(src + (iii * srcStride)));
+	}
+	for (iii=0; iii<4; iii++)
+	{
+		stage1[2 * iii]			=	_mm_unpacklo_epi16(rows[2 * iii], rows[(2 * iii) + 1]);
+		stage1[(2 * iii) + 1]	=	_mm_unpackhi_epi16(rows[2 * iii], rows[(2 * iii) + 1]);
+	}
+	stage2[0]	=	_mm_unpacklo_epi32(stage1[0], stage1[2]);		//*	columns 0,1 rows 0-3
+	stage2[1]	=	_mm_unpackhi_epi32(stage1[0], stage1[2]);		//*	columns 2,3
+	stage2[2]	=	_mm_unpacklo_epi32(stage1[1], stage1[3]);		//*	columns 4,5
+	stage2[3]	=	_mm_unpackhi_epi32(stage1[1], stage1[3]);		//*	columns 6,7
+	stage2[4]	=	_mm_unpacklo_epi32(stage1[4], stage1[6]);		//*	same for rows 4-7
+	stage2[5]	=	_mm_unpackhi_epi32(stage1[4], stage1[6]);
+	stage2[6]	=	_mm_unpacklo_epi32(stage1[5], stage1[7]);
+	stage2[7]	=	_mm_unpackhi_epi32(stage1[5], stage1[7]);
+	for (iii=0; iii<4; iii++)
+	{
+		_mm_storeu_si128((__m128i *)(dst + ((2 * iii) * dstStride)),		_mm_unpacklo_epi64(stage2[iii], stage2[iii + 4]));
+		_mm_storeu_si128((__m128i *)(dst + (((2 * iii) + 1) * dstStride)),	_mm_unpackhi_epi64(stage2[iii], stage2[iii + 4]));
+	}
+}
+
+//*****************************************************************************
+PIXCONV_SSE2 static void	TransposeBlock8_SSE2(	uint8_t			*dst,
+													const size_t	dstStride,
+													const uint8_t	*src,
+													const size_t	srcStride,
+													const int		width,
+													const int		height)
+{
+int		xxx;
+int		yyy;
+int		width16;
+int		height16;
+
+	width16		=	width & ~15;
+	height16	=	height & ~15;
+	for (xxx=0; xxx<width16; xxx += 16)
+	{
+		for (yyy=0; yyy<height16; yyy += 16)
+		{
+			Transpose8_16x16_SSE2(	dst + ((size_t)xxx * dstStride) + yyy, dstStride,
+									src + ((size_t)yyy * srcStride) + xxx, srcStride);
+		}
+	}
+	//*	the right and bottom edges
+	TransposeBlock8_C(	dst + ((size_t)width16 * dstStride), dstStride,
+						src + width16, srcStride, width - width16, height);
+	TransposeBlock8_C(	dst + height16, dstStride,
+						src + ((size_t)height16 * srcStride), srcStride, width16, height - height16);
+}
+
+//*****************************************************************************
+PIXCONV_SSE2 static void	TransposeBlock16_SSE2(	uint16_t		*dst,
+													const size_t	dstStride,
+													const uint16_t	*src,
+													const size_t	srcStride,
+													const int		width,
+													const int		height)
+{
+int		xxx;
+int		yyy;
+int		width8;
+int		height8;
+
+	width8	=	width & ~7;
+	height8	=	height & ~7;
+	for (xxx=0; xxx<width8; xxx += 8)
+	{
+		for (yyy=0; yyy<height8; yyy += 8)
+		{
+			Transpose16_8x8_SSE2(	dst + ((size_t)xxx * dstStride) + yyy, dstStride,
+									src + ((size_t)yyy * srcStride) + xxx, srcStride);
+		}
+	}
+	TransposeBlock16_C(	dst + ((size_t)width8 * dstStride), dstStride,
+						src + width8, srcStride, width - width8, height);
+	TransposeBlock16_C(	dst + height8, dstStride,
+						src + ((size_t)height8 * srcStride), srcStride, width8, height - height8);
+}
+#endif // _PIXCONV_X86_
+
+#ifdef _PIXCONV_NEON_
+#pragma mark -
+//*****************************************************************************
+//*	ARM NEON, 16 bytes at a time, vld3/vst3 do the 3 channel (de)interleave
+//*****************************************************************************
+static void	Widen8to16_NEON(uint16_t *dst, const uint8_t *src, const size_t count, const int shift)
+{
+size_t		iii;
+int16x8_t	shiftCnt;
+uint8x16_t	srcData;
+
+	shiftCnt	=	vdupq_n_s16(shift);
+	for (iii=0; (iii + 16) <= count; iii += 16)
+	{
+		srcData	=	vld1q_u8(src + iii);
+		vst1q_u16(dst + iii,		vshlq_u16(vmovl_u8(vget_low_u8(srcData)), shiftCnt));
+		vst1q_u16(dst + iii + 8,	vshlq_u16(vmovl_u8(vget_high_u8(srcData)), shiftCnt));
+	}
+	Widen8to16_C(dst + iii, src + iii, count - iii, shift);
+}
+
+//*****************************************************************************
+static void	Widen8to32_NEON(uint32_t *dst, const uint8_t *src, const size_t count, const int shift)
+{
+size_t		iii;
+int32x4_t	shiftCnt;
+uint16x8_t	lo16;
+uint16x8_t	hi16;
+
+	shiftCnt	=	vdupq_n_s32(shift);
+	for (iii=0; (iii + 16) <= count; iii += 16)
+	{
+		lo16	=	vmovl_u8(vld1_u8(src + iii));
+		hi16	=	vmovl_u8(vld1_u8(src + iii + 8));
+		vst1q_u32(dst + iii,		vshlq_u32(vmovl_u16(vget_low_u16(lo16)), shiftCnt));
+		vst1q_u32(dst + iii + 4,	vshlq_u32(vmovl_u16(vget_high_u16(lo16)), shiftCnt));
+		vst1q_u32(dst + iii + 8,	vshlq_u32(vmovl_u16(vget_low_u16(hi16)), shiftCnt));
+		vst1q_u32(dst + iii + 12,	vshlq_u32(vmovl_u16(vget_high_u16(hi16)), shiftCnt));
+	}
+	Widen8to32_C(dst + iii, src + iii, count - iii, shift);
+}
+
+//*****************************************************************************
+static void	Widen16to32_NEON(uint32_t *dst, const uint16_t *src, const size_t count, const int shift)
+{
+size_t		iii;
+int32x4_t	shiftCnt;
+uint16x8_t	srcData;
+
+	shiftCnt	=	vdupq_n_s32(shift);
+	for (iii=0; (iii + 8) <= count; iii += 8)
+	{
+		srcData	=	vld1q_u16(src + iii);
+		vst1q_u32(dst + iii,		vshlq_u32(vmovl_u16(vget_low_u16(srcData)), shiftCnt));
+		vst1q_u32(dst + iii + 4,	vshlq_u32(vmovl_u16(vget_high_u16(srcData)), shiftCnt));
+	}
+	Widen16to32_C(dst + iii, src + iii, count - iii, shift);
+}
+
+//*****************************************************************************
+static void	Narrow16to8_NEON(uint8_t *dst, const uint16_t *src, const size_t count)
+{
+size_t	iii;
+
+	for (iii=0; (iii + 16) <= count; iii += 16)
+	{
+		vst1q_u8(dst + iii, vcombine_u8(vshrn_n_u16(vld1q_u16(src + iii), 8),
+										vshrn_n_u16(vld1q_u16(src + iii + 8), 8)));
+	}
+	Narrow16to8_C(dst + iii, src + iii, count - iii);
+}
+
+//*****************************************************************************
+static void	ByteSwap16_NEON(uint16_t *dst, const uint16_t *src, const size_t count)
+{
+size_t	iii;
+
+	for (iii=0; (iii + 8) <= count; iii += 8)
+	{
+		vst1q_u16(dst + iii, vreinterpretq_u16_u8(vrev16q_u8(vreinterpretq_u8_u16(vld1q_u16(src + iii)))));
+	}
+	ByteSwap16_C(dst + iii, src + iii, count - iii);
+}
+
+//*****************************************************************************
+static void	SwapRB24_NEON(uint8_t *dst, const uint8_t *src, const size_t pixelCount)
+{
+size_t		iii;
+uint8x16x3_t	pixels;
+uint8x16_t	tempReg;
+
+	for (iii=0; (iii + 16) <= pixelCount; iii += 16)
+	{
+		pixels			=	vld3q_u8(src + (iii * 3));
+		tempReg			=	pixels.val[0];
+		pixels.val[0]	=	pixels.val[2];
+		pixels.val[2]	=	tempReg;
+		vst3q_u8(dst + (iii * 3), pixels);
+	}
+	SwapRB24_C(dst + (iii * 3), src + (iii * 3), pixelCount - iii);
+}
+
+//*****************************************************************************
+static void	Deinterleave24_NEON(uint8_t			*plane0,
+								uint8_t			*plane1,
+								uint8_t			*plane2,
+								const uint8_t	*src,
+								const size_t	pixelCount)
+{
+size_t			iii;
+uint8x16x3_t	pixels;
+
+	for (iii=0; (iii + 16) <= pixelCount; iii += 16)
+	{
+		pixels	=	vld3q_u8(src + (iii * 3));
+		vst1q_u8(plane0 + iii, pixels.val[0]);
+		vst1q_u8(plane1 + iii, pixels.val[1]);
+		vst1q_u8(plane2 + iii, pixels.val[2]);
+	}
+	Deinterleave24_C(plane0 + iii, plane1 + iii, plane2 + iii, src + (iii * 3), pixelCount - iii);
+}
+
+//*****************************************************************************
+static void	Interleave24_NEON(	uint8_t			*dst,
+								const uint8_t	*plane0,
+								const uint8_t	*plane1,
+								const uint8_t	*plane2,
+								const size_t	pixelCount)
+{
+size_t			iii;
+uint8x16x3_t	pixels;
+
+	for (iii=0; (iii + 16) <= pixelCount; iii += 16)
+	{
+		pixels.val[0]	=	vld1q_u8(plane0 + iii);
+		pixels.val[1]	=	vld1q_u8(plane1 + iii);
+		pixels.val[2]	=	vld1q_u8(plane2 + iii);
+		vst3q_u8(dst + (iii * 3), pixels);
+	}
+	Interleave24_C(dst + (iii * 3), plane0 + iii, plane1 + iii, plane2 + iii, pixelCount - iii);
+}
+//*****************************************************************************
+//*	16x16 bytes, the same 4 rounds as the SSE2 version,
+//*	vzipq gives the low and high unpack together
+//*****************************************************************************
+static void	Transpose8_16x16_NEON(	uint8_t			*dst,
+									const size_t	dstStride,
+									const uint8_t	*src,
+									const size_t	srcStride)
+{
+uint8x16_t		rows[16];
+uint16x8_t		stage1[16];
+uint32x4_t		stage2[16];
+uint64x2_t		stage3[2][8];
+uint8x16x2_t	zip8;
+uint16x8x2_t	zip16;
+uint32x4x2_t	zip32;
+int				iii;
+int				jjj;
+int				qqq;
+
+	for (iii=0; iii<16; iii++)
+	{
+		rows[iii]	=	vld1q_u8(src + (iii * srcStride));
+	}
+	//*	pairs of rows, 16 bit pieces
+	for (iii=0; iii<8; iii++)
+	{
+		zip8					=	vzipq_u8(rows[2 * iii], rows[(2 * iii) + 1]);
+		stage1[2 * iii]			=	vreinterpretq_u16_u8(zip8.val[0]);
+		stage1[(2 * iii) + 1]	=	vreinterpretq_u16_u8(zip8.val[1]);
+	}
+	//*	groups of 4 rows, 32 bit pieces
+	for (jjj=0; jjj<4; jjj++)
+	{
+		zip16					=	vzipq_u16(stage1[4 * jjj], stage1[(4 * jjj) + 2]);
+		stage2[(4 * jjj) + 0]	=	vreinterpretq_u32_u16(zip16.val[0]);
+		stage2[(4 * jjj) + 1]	=	vreinterpretq_u32_u16(zip16.val[1]);
+		zip16					=	vzipq_u16(stage1[(4 * jjj) + 1], stage1[(4 * jjj) + 3]);
+		stage2[(4 * jjj) + 2]	=	vreinterpretq_u32_u16(zip16.val[0]);
+		stage2[(4 * jjj) + 3]	=	vreinterpretq_u32_u16(zip16.val[1]);
+	}
+	//*	groups of 8 rows, 64 bit pieces
+	for (iii=0; iii<2; iii++)
+	{
+		for (qqq=0; qqq<4; qqq++)
+		{
+			zip32						=	vzipq_u32(stage2[(8 * iii) + qqq], stage2[(8 * iii) + 4 + qqq]);
+			stage3[iii][2 * qqq]		=	vreinterpretq_u64_u32(zip32.val[0]);
+			stage3[iii][(2 * qqq) + 1]	=	vreinterpretq_u64_u32(zip32.val[1]);
+		}
+	}
+	//*	all 16 rows
+	for (iii=0; iii<8; iii++)
+	{
+		vst1q_u8(dst + ((2 * iii) * dstStride),
+				vreinterpretq_u8_u64(vcombine_u64(vget_low_u64(stage3[0][iii]), vget_low_u64(stage3[1][iii]))));
+		vst1q_u8(dst + (((2 * iii) + 1) * dstStride),
+				vreinterpretq_u8_u64(vcombine_u64(vget_high_u64(stage3[0][iii]), vget_high_u64(stage3[1][iii]))));
+	}
+}
+
+//*****************************************************************************
+static void	Transpose16_8x8_NEON(	uint16_t		*dst,
+									const size_t	dstStride,
+									const uint16_t	*src,
+									const size_t	srcStride)
+{
+uint16x8_t		rows[8];
+uint32x4_t		stage1[8];
+uint64x2_t		stage2[8];
+uint16x8x2_t	zip16;
+uint32x4x2_t	zip32;
+int				iii;
+
+	for (iii=0; iii<8; iii++)
+	{
+		rows[iii]	=	vld1q_u16(src + (iii * srcStride));
+	}
+	for (iii=0; iii<4; iii++)
+	{
+		zip16					=	vzipq_u16(rows[2 * iii], rows[(2 * iii) + 1]);
+		stage1[2 * iii]			=	vreinterpretq_u32_u16(zip16.val[0]);
+		stage1[(2 * iii) + 1]	=	vreinterpretq_u32_u16(zip16.val[1]);
+	}
+	for (iii=0; iii<2; iii++)
+	{
+		zip32					=	vzipq_u32(stage1[(4 * iii) + 0], stage1[(4 * iii) + 2]);	//*	columns 0-3
+		stage2[(4 * iii) + 0]	=	vreinterpretq_u64_u32(zip32.val[0]);
+		stage2[(4 * iii) + 1]	=	vreinterpretq_u64_u32(zip32.val[1]);
+		zip32					=	vzipq_u32(stage1[(4 * iii) + 1], stage1[(4 * iii) + 3]);	//*	columns 4-7
+		stage2[(4 * iii) + 2]	=	vreinterpretq_u64_u32(zip32.val[0]);
+		stage2[(4 * iii) + 3]	=	vreinterpretq_u64_u32(zip32.val[1]);
+	}
+	for (iii=0; iii<4; iii++)
+	{
+		vst1q_u16(dst + ((2 * iii) * dstStride),
+				vreinterpretq_u16_u64(vcombine_u64(vget_low_u64(stage2[iii]), vget_low_u64(stage2[iii + 4]))));
+		vst1q_u16(dst + (((2 * iii) + 1) * dstStride),
+				vreinterpretq_u16_u64(vcombine_u64(vget_high_u64(stage2[iii]), vget_high_u64(stage2[iii + 4]))));
+	}
+}
+
+//*****************************************************************************
+static void	TransposeBlock8_NEON(	uint8_t			*dst,
+									const size_t	dstStride,
+									const uint8_t	*src,
+									const size_t	srcStride,
+									const int		width,
+									const int		height)
+{
+int		xxx;
+int		yyy;
+int		width16;
+int		height16;
+
+	width16		=	width & ~15;
+	height16	=	height & ~15;
+	for (xxx=0; xxx<width16; xxx += 16)
+	{
+		for (yyy=0; yyy<height16; yyy += 16)
+		{
+			Transpose8_16x16_NEON(	dst + ((size_t)xxx * dstStride) + yyy, dstStride,
+									src + ((size_t)yyy * srcStride) + xxx, srcStride);
+		}
+	}
+	TransposeBlock8_C(	dst + ((size_t)width16 * dstStride), dstStride,
+						src + width16, srcStride, width - width16, height);
+	TransposeBlock8_C(	dst + height16, dstStride,
+						src + ((size_t)height16 * srcStride), srcStride, width16, height - height16);
+}
+
+//*****************************************************************************
+static void	TransposeBlock16_NEON(	uint16_t		*dst,
+									const size_t	dstStride,
+									const uint16_t	*src,
+									const size_t	srcStride,
+									const int		width,
+									const int		height)
+{
+int		xxx;
+int		yyy;
+int		width8;
+int		height8;
+
+	width8	=	width & ~7;
+	height8	=	height & ~7;
+	for (xxx=0; xxx<width8; xxx += 8)
+	{
+		for (yyy=0; yyy<height8; yyy += 8)
+		{
+			Transpose16_8x8_NEON(	dst + ((size_t)xxx * dstStride) + yyy, dstStride,
+									src + ((size_t)yyy * srcStride) + xxx, srcStride);
+		}
+	}
+	TransposeBlock16_C(	dst + ((size_t)width8 * dstStride), dstStride,
+						src + width8, srcStride, width - width8, height);
+	TransposeBlock16_C(	dst + height8, dstStride,
+						src + ((size_t)height8 * srcStride), srcStride, width8, height - height8);
+}
+#endif // _PIXCONV_NEON_
+
+#pragma mark -
+//*****************************************************************************
+//*	the public entry points, pick the version for the current level
+//*****************************************************************************
+void	PixConv_Widen8to16(uint16_t *dst, const uint8_t *src, const size_t count, const int shift)
+{
+	switch(PixConv_GetLevel())
+	{
+#ifdef _PIXCONV_X86_
+		case kPixConv_AVX2:		Widen8to16_AVX2(dst, src, count, shift);	break;
+		case kPixConv_SSSE3:
+		case kPixConv_SSE2:		Widen8to16_SSE2(dst, src, count, shift);	break;
+#endif
+#ifdef _PIXCONV_NEON_
+		case kPixConv_NEON:		Widen8to16_NEON(dst, src, count, shift);	break;
+#endif
+		default:				Widen8to16_C(dst, src, count, shift);		break;
+	}
+}
+
+//*****************************************************************************
+void	PixConv_Widen8to32(uint32_t *dst, const uint8_t *src, const size_t count, const int shift)
+{
+	switch(PixConv_GetLevel())
+	{
+#ifdef _PIXCONV_X86_
+		case kPixConv_AVX2:		Widen8to32_AVX2(dst, src, count, shift);	break;
+		case kPixConv_SSSE3:
+		case kPixConv_SSE2:		Widen8to32_SSE2(dst, src, count, shift);	break;
+#endif
+#ifdef _PIXCONV_NEON_
+		case kPixConv_NEON:		Widen8to32_NEON(dst, src, count, shift);	break;
+#endif
+		default:				Widen8to32_C(dst, src, count, shift);		break;
+	}
+}
+
+//*****************************************************************************
+void	PixConv_Widen16to32(uint32_t *dst, const uint16_t *src, const size_t count, const int shift)
+{
+	switch(PixConv_GetLevel())
+	{
+#ifdef _PIXCONV_X86_
+		case kPixConv_AVX2:		Widen16to32_AVX2(dst, src, count, shift);	break;
+		case kPixConv_SSSE3:
+		case kPixConv_SSE2:		Widen16to32_SSE2(dst, src, count, shift);	break;
+#endif
+#ifdef _PIXCONV_NEON_
+		case kPixConv_NEON:		Widen16to32_NEON(dst, src, count, shift);	break;
+#endif
+		default:				Widen16to32_C(dst, src, count, shift);		break;
+	}
+}
+
+//*****************************************************************************
+//*	keeps the high byte
+//*****************************************************************************
+void	PixConv_Narrow16to8(uint8_t *dst, const uint16_t *src, const size_t count)
+{
+	switch(PixConv_GetLevel())
+	{
+#ifdef _PIXCONV_X86_
+		case kPixConv_AVX2:		Narrow16to8_AVX2(dst, src, count);	break;
+		case kPixConv_SSSE3:
+		case kPixConv_SSE2:		Narrow16to8_SSE2(dst, src, count);	break;
+#endif
+#ifdef _PIXCONV_NEON_
+		case kPixConv_NEON:		Narrow16to8_NEON(dst, src, count);	break;
+#endif
+		default:				Narrow16to8_C(dst, src, count);		break;
+	}
+}
+
+//*****************************************************************************
+//*	dst and src can be the same buffer
+//*****************************************************************************
+void	PixConv_ByteSwap16(uint16_t *dst, const uint16_t *src, const size_t count)
+{
+	switch(PixConv_GetLevel())
+	{
+#ifdef _PIXCONV_X86_
+		case kPixConv_AVX2:		ByteSwap16_AVX2(dst, src, count);	break;
+		case kPixConv_SSSE3:
+		case kPixConv_SSE2:		ByteSwap16_SSE2(dst, src, count);	break;
+#endif
+#ifdef _PIXCONV_NEON_
+		case kPixConv_NEON:		ByteSwap16_NEON(dst, src, count);	break;
+#endif
+		default:				ByteSwap16_C(dst, src, count);		break;
+	}
+}
+
+//*****************************************************************************
+//*	BGR <-> RGB, dst and src can be the same buffer
+//*****************************************************************************
+void	PixConv_SwapRB24(uint8_t *dst, const uint8_t *src, const size_t pixelCount)
+{
+	switch(PixConv_GetLevel())
+	{
+#ifdef _PIXCONV_X86_
+		case kPixConv_AVX2:
+		case kPixConv_SSSE3:	SwapRB24_SSSE3(dst, src, pixelCount);	break;
+#endif
+#ifdef _PIXCONV_NEON_
+		case kPixConv_NEON:		SwapRB24_NEON(dst, src, pixelCount);	break;
+#endif
+		default:				SwapRB24_C(dst, src, pixelCount);		break;
+	}
+}
+
+//*****************************************************************************
+//*	byte 0 of each pixel goes to plane0 and so on
+//*****************************************************************************
+void	PixConv_Deinterleave24(	uint8_t			*plane0,
+								uint8_t			*plane1,
+								uint8_t			*plane2,
+								const uint8_t	*src,
+								const size_t	pixelCount)
+{
+	switch(PixConv_GetLevel())
+	{
+#ifdef _PIXCONV_X86_
+		case kPixConv_AVX2:
+		case kPixConv_SSSE3:	Deinterleave24_SSSE3(plane0, plane1, plane2, src, pixelCount);	break;
+#endif
+#ifdef _PIXCONV_NEON_
+		case kPixConv_NEON:		Deinterleave24_NEON(plane0, plane1, plane2, src, pixelCount);	break;
+#endif
+		default:				Deinterleave24_C(plane0, plane1, plane2, src, pixelCount);		break;
+	}
+}
+
+//*****************************************************************************
+void	PixConv_Interleave24(	uint8_t			*dst,
+								const uint8_t	*plane0,
+								const uint8_t	*plane1,
+								const uint8_t	*plane2,
+								const size_t	pixelCount)
+{
+	switch(PixConv_GetLevel())
+	{
+#ifdef _PIXCONV_X86_
+		case kPixConv_AVX2:
+		case kPixConv_SSSE3:	Interleave24_SSSE3(dst, plane0, plane1, plane2, pixelCount);	break;
+#endif
+#ifdef _PIXCONV_NEON_
+		case kPixConv_NEON:		Interleave24_NEON(dst, plane0, plane1, plane2, pixelCount);		break;
+#endif
+		default:				Interleave24_C(dst, plane0, plane1, plane2, pixelCount);		break;
+	}
+}
+
+//*****************************************************************************
+static void	TransposeBlock8(	uint8_t			*dst,
+								const size_t	dstStride,
+								const uint8_t	*src,
+								const size_t	srcStride,
+								const int		width,
+								const int		height)
+{
+#ifdef _PIXCONV_NEON_
+	if (PixConv_GetLevel() == kPixConv_NEON)
+	{
+		TransposeBlock8_NEON(dst, dstStride, src, srcStride, width, height);
+		return;
+	}
+#endif
+#ifdef _PIXCONV_X86_
+	if (PixConv_GetLevel() >= kPixConv_SSE2)
+	{
+		TransposeBlock8_SSE2(dst, dstStride, src, srcStride, width, height);
+		return;
+	}
+#endif
+	TransposeBlock8_C(dst, dstStride, src, srcStride, width, height);
+}
+
+//*****************************************************************************
+static void	TransposeBlock16(	uint16_t		*dst,
+								const size_t	dstStride,
+								const uint16_t	*src,
+								const size_t	srcStride,
+								const int		width,
+								const int		height)
+{
+#ifdef _PIXCONV_NEON_
+	if (PixConv_GetLevel() == kPixConv_NEON)
+	{
+		TransposeBlock16_NEON(dst, dstStride, src, srcStride, width, height);
+		return;
+	}
+#endif
+#ifdef _PIXCONV_X86_
+	if (PixConv_GetLevel() >= kPixConv_SSE2)
+	{
+		TransposeBlock16_SSE2(dst, dstStride, src, srcStride, width, height);
+		return;
+	}
+#endif
+	TransposeBlock16_C(dst, dstStride, src, srcStride, width, height);
+}
+
+//*****************************************************************************
+//*	With pshufb / vld3 the tile is split into 3 planes, each plane goes through
+//*	the 8 bit transpose, and the columns are put back together, that is 3
+//*	sequential passes instead of one 3 byte gather per pixel.
+//*****************************************************************************
+static void	TransposeBlock24(	uint8_t			*dst,
+								const size_t	dstStride,
+								const uint8_t	*src,
+								const size_t	srcStride,
+								const int		width,
+								const int		height,
+								const bool		swapRB)
+{
+uint8_t	rowPlanes[3][kPixConv_TileSize * kPixConv_TileSize];
+uint8_t	colPlanes[3][kPixConv_TileSize * kPixConv_TileSize];
+int		firstIdx;
+int		lastIdx;
+int		level;
+int		xxx;
+int		yyy;
+int		ppp;
+
+	level	=	PixConv_GetLevel();
+	if ((level < kPixConv_SSSE3) || (width > kPixConv_TileSize) || (height > kPixConv_TileSize))
+	{
+		TransposeBlock24_C(dst, dstStride, src, srcStride, width, height, swapRB);
+		return;
+	}
+	for (yyy=0; yyy<height; yyy++)
+	{
+		PixConv_Deinterleave24(	rowPlanes[0] + (yyy * width),
+								rowPlanes[1] + (yyy * width),
+								rowPlanes[2] + (yyy * width),
+								src + ((size_t)yyy * srcStride * 3),
+								width);
+	}
+	for (ppp=0; ppp<3; ppp++)
+	{
+		TransposeBlock8(colPlanes[ppp], height, rowPlanes[ppp], width, width, height);
+	}
+	firstIdx	=	swapRB ? 2 : 0;
+	lastIdx		=	2 - firstIdx;
+	for (xxx=0; xxx<width; xxx++)
+	{
+		PixConv_Interleave24(	dst + ((size_t)xxx * dstStride * 3),
+								colPlanes[firstIdx] + (xxx * height),
+								colPlanes[1] + (xxx * height),
+								colPlanes[lastIdx] + (xxx * height),
+								height);
+	}
+}
+
+//*****************************************************************************
+void	PixConv_Transpose8(uint8_t *dst, const uint8_t *src, const int width, const int height)
+{
+int		xBlock;
+int		yBlock;
+int		tileWidth;
+int		tileHeight;
+
+	for (yBlock=0; yBlock < height; yBlock += kPixConv_TileSize)
+	{
+		tileHeight	=	((yBlock + kPixConv_TileSize) < height) ? kPixConv_TileSize : (height - yBlock);
+		for (xBlock=0; xBlock < width; xBlock += kPixConv_TileSize)
+		{
+			tileWidth	=	((xBlock + kPixConv_TileSize) < width) ? kPixConv_TileSize : (width - xBlock);
+			TransposeBlock8(dst + ((size_t)xBlock * height) + yBlock, height,
+							src + ((size_t)yBlock * width) + xBlock, width,
+							tileWidth, tileHeight);
+		}
+	}
+}
+
+//*****************************************************************************
+void	PixConv_Transpose16(uint16_t *dst, const uint16_t *src, const int width, const int height)
+{
+int		xBlock;
+int		yBlock;
+int		tileWidth;
+int		tileHeight;
+
+	for (yBlock=0; yBlock < height; yBlock += kPixConv_TileSize)
+	{
+		tileHeight	=	((yBlock + kPixConv_TileSize) < height) ? kPixConv_TileSize : (height - yBlock);
+		for (xBlock=0; xBlock < width; xBlock += kPixConv_TileSize)
+		{
+			tileWidth	=	((xBlock + kPixConv_TileSize) < width) ? kPixConv_TileSize : (width - xBlock);
+			TransposeBlock16(	dst + ((size_t)xBlock * height) + yBlock, height,
+								src + ((size_t)yBlock * width) + xBlock, width,
+								tileWidth, tileHeight);
+		}
+	}
+}
+
+//*****************************************************************************
+//*	3 byte pixels, swapRB turns the camera BGR into RGB on the way
+//*****************************************************************************
+void	PixConv_Transpose24(uint8_t *dst, const uint8_t *src, const int width, const int height, const bool swapRB)
+{
+int		xBlock;
+int		yBlock;
+int		tileWidth;
+int		tileHeight;
+
+	for (yBlock=0; yBlock < height; yBlock += kPixConv_TileSize)
+	{
+		tileHeight	=	((yBlock + kPixConv_TileSize) < height) ? kPixConv_TileSize : (height - yBlock);
+		for (xBlock=0; xBlock < width; xBlock += kPixConv_TileSize)
+		{
+			tileWidth	=	((xBlock + kPixConv_TileSize) < width) ? kPixConv_TileSize : (width - xBlock);
+			TransposeBlock24(	dst + ((((size_t)xBlock * height) + yBlock) * 3), height,
+								src + ((((size_t)yBlock * width) + xBlock) * 3), width,
+								tileWidth, tileHeight, swapRB);
+		}
+	}
+}
+
+//*****************************************************************************
+//*	one column of a tile, count values, from srcBytesPerValue to dstBytesPerValue
+//*****************************************************************************
+static void	ConvertRun(	void			*dst,
+						const int		dstBytesPerValue,
+						const int		shift,
+						const void		*src,
+						const int		srcBytesPerValue,
+						const size_t	count)
+{
+	if ((srcBytesPerValue == 1) && (dstBytesPerValue == 2))
+	{
+		PixConv_Widen8to16((uint16_t *)dst, (const uint8_t *)src, count, shift);
+	}
+	else if ((srcBytesPerValue == 1) && (dstBytesPerValue == 4))
+	{
+		PixConv_Widen8to32((uint32_t *)dst, (const uint8_t *)src, count, shift);
+	}
+	else if ((srcBytesPerValue == 2) && (dstBytesPerValue == 4))
+	{
+		PixConv_Widen16to32((uint32_t *)dst, (const uint16_t *)src, count, shift);
+	}
+	else if ((srcBytesPerValue == 2) && (dstBytesPerValue == 1))
+	{
+		PixConv_Narrow16to8((uint8_t *)dst, (const uint16_t *)src, count);
+	}
+	else
+	{
+		memcpy(dst, src, count * dstBytesPerValue);
+	}
+}
+
+//*****************************************************************************
+//*	Row major camera data to column major ImageBytes.
+//*		src				width x height pixels of channels values, srcBytesPerValue each
+//*		dst				[width][height][channels] of dstBytesPerValue each
+//*		shift			applied when widening (8 bit into the top of 16 is 8)
+//*	channels 3 is the camera BGR buffer and comes out RGB.
+//*	Same size values go straight through the tiled transposes, otherwise each
+//*	tile is transposed into a small buffer and each column of it widened.
+//*****************************************************************************
+void	PixConv_ToImageBytes(	void			*dst,
+								const int		dstBytesPerValue,
+								const int		shift,
+								const void		*src,
+								const int		srcBytesPerValue,
+								const int		channels,
+								const int		width,
+								const int		height)
+{
+uint8_t			tileBuffer[kPixConv_TileSize * kPixConv_TileSize * 3 * 2];
+const uint8_t	*srcPtr;
+uint8_t			*dstPtr;
+size_t			srcPixelBytes;
+size_t			dstPixelBytes;
+size_t			tileColumnBytes;
+int				xBlock;
+int				yBlock;
+int				tileWidth;
+int				tileHeight;
+int				xxx;
+
+	srcPtr	=	(const uint8_t *)src;
+	dstPtr	=	(uint8_t *)dst;
+	if ((srcBytesPerValue == dstBytesPerValue) && (shift == 0))
+	{
+		if (channels == 3)
+		{
+			PixConv_Transpose24(dstPtr, srcPtr, width, height, true);
+			return;
+		}
+		if ((channels == 1) && (srcBytesPerValue == 1))
+		{
+			PixConv_Transpose8(dstPtr, srcPtr, width, height);
+			return;
+		}
+		if ((channels == 1) && (srcBytesPerValue == 2))
+		{
+			PixConv_Transpose16((uint16_t *)dstPtr, (const uint16_t *)srcPtr, width, height);
+			return;
+		}
+	}
+	if (((channels != 1) && (channels != 3)) || (srcBytesPerValue > 2))
+	{
+		CONSOLE_DEBUG("Unsupported pixel format");
+		return;
+	}
+
+	srcPixelBytes	=	(size_t)channels * srcBytesPerValue;
+	dstPixelBytes	=	(size_t)channels * dstBytesPerValue;
+	for (yBlock=0; yBlock < height; yBlock += kPixConv_TileSize)
+	{
+		tileHeight		=	((yBlock + kPixConv_TileSize) < height) ? kPixConv_TileSize : (height - yBlock);
+		tileColumnBytes	=	tileHeight * srcPixelBytes;
+		for (xBlock=0; xBlock < width; xBlock += kPixConv_TileSize)
+		{
+			tileWidth	=	((xBlock + kPixConv_TileSize) < width) ? kPixConv_TileSize : (width - xBlock);
+			if (channels == 3)
+			{
+				//*	only 8 bit color comes from the camera
+				TransposeBlock24(	tileBuffer, tileHeight,
+									srcPtr + ((((size_t)yBlock * width) + xBlock) * srcPixelBytes), width,
+									tileWidth, tileHeight, true);
+			}
+			else if (srcBytesPerValue == 2)
+			{
+				TransposeBlock16(	(uint16_t *)tileBuffer, tileHeight,
+									(const uint16_t *)(srcPtr + ((((size_t)yBlock * width) + xBlock) * srcPixelBytes)), width,
+									tileWidth, tileHeight);
+			}
+			else
+			{
+				TransposeBlock8(	tileBuffer, tileHeight,
+									srcPtr + ((((size_t)yBlock * width) + xBlock) * srcPixelBytes), width,
+									tileWidth, tileHeight);
+			}
+			for (xxx=0; xxx<tileWidth; xxx++)
+			{
+				ConvertRun(	dstPtr + ((((size_t)(xBlock + xxx) * height) + yBlock) * dstPixelBytes),
+							dstBytesPerValue,
+							shift,
+							tileBuffer + (xxx * tileColumnBytes),
+							srcBytesPerValue,
+							(size_t)tileHeight * channels);
+			}
+		}
+	}
+}
+
+
+#ifdef _INCLUDE_PIXEL_CONVERT_MAIN_
+//*****************************************************************************
+//*	Checks every kernel at every level this cpu has against a straight
+//*	reference loop, including odd sizes and the left over tails, then prints
+//*	GB/s (bytes written) for each kernel on a 5496x3672 frame.
+//*
+//*	g++ -O3 -x c++ -D_INCLUDE_PIXEL_CONVERT_MAIN_ -I../libs/src_mlsLib pixel_convert.c -o pixconvtest
+//*****************************************************************************
+#include	<time.h>
+
+#define	kTestWidth		5496
+#define	kTestHeight		3672
+#define	kBenchLoops		5
+
+static int	gFailCnt	=	0;
+
+//*****************************************************************************
+static double	GetMilliSecs(void)
+{
+struct timespec	currentTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &currentTime);
+	return((currentTime.tv_sec * 1000.0) + (currentTime.tv_nsec / 1000000.0));
+}
+
+//*****************************************************************************
+static void	CheckResult(const char *testName, const void *result, const void *expected, const size_t byteCount, const size_t sizeArg)
+{
+	if (memcmp(result, expected, byteCount) != 0)
+	{
+		printf("FAIL: %-14s %-6s size=%lu\r\n", testName, PixConv_GetLevelName(PixConv_GetLevel()), (unsigned long)sizeArg);
+		gFailCnt++;
+	}
+}
+
+//*****************************************************************************
+static void	FillRandom(uint8_t *buffer, const size_t byteCount, uint32_t seed)
+{
+size_t	iii;
+
+	for (iii=0; iii<byteCount; iii++)
+	{
+		seed		=	(seed * 1103515245) + 12345;
+		buffer[iii]	=	(uint8_t)(seed >> 16);
+	}
+}
+
+//*****************************************************************************
+//*	every 8 and 16 bit value through the element kernels, lengths 0 - 200
+//*	so every tail length is hit, and the pixel kernels in place and not
+//*****************************************************************************
+static void	TestElementKernels(uint8_t *src, uint8_t *out, uint8_t *ref, uint8_t *out2)
+{
+size_t		count;
+size_t		iii;
+int			shift;
+uint16_t	*src16		=	(uint16_t *)src;
+uint16_t	*out16		=	(uint16_t *)out;
+uint16_t	*ref16		=	(uint16_t *)ref;
+uint32_t	*out32		=	(uint32_t *)out;
+uint32_t	*ref32		=	(uint32_t *)ref;
+
+	//*	all 65536 16 bit values, which also covers all 256 8 bit values
+	for (iii=0; iii<65536; iii++)
+	{
+		src16[iii]	=	(uint16_t)iii;
+	}
+	count	=	65536;
+	for (shift=0; shift<=16; shift += 4)
+	{
+		PixConv_Widen8to16(out16, src, count, shift / 2);
+		for (iii=0; iii<count; iii++)
+		{
+			ref16[iii]	=	(uint16_t)(src[iii] << (shift / 2));
+		}
+		CheckResult("Widen8to16", out, ref, count * 2, count);
+		PixConv_Widen8to32(out32, src, count, shift);
+		for (iii=0; iii<count; iii++)
+		{
+			ref32[iii]	=	(uint32_t)src[iii] << shift;
+		}
+		CheckResult("Widen8to32", out, ref, count * 4, count);
+		PixConv_Widen16to32(out32, src16, count, shift);
+		for (iii=0; iii<count; iii++)
+		{
+			ref32[iii]	=	(uint32_t)src16[iii] << shift;
+		}
+		CheckResult("Widen16to32", out, ref, count * 4, count);
+	}
+	PixConv_Narrow16to8(out, src16, count);
+	for (iii=0; iii<count; iii++)
+	{
+		ref[iii]	=	(uint8_t)(src16[iii] >> 8);
+	}
+	CheckResult("Narrow16to8", out, ref, count, count);
+	PixConv_ByteSwap16(out16, src16, count);
+	for (iii=0; iii<count; iii++)
+	{
+		ref16[iii]	=	(uint16_t)((iii & 0xff) << 8) | (uint16_t)(iii >> 8);
+	}
+	CheckResult("ByteSwap16", out, ref, count * 2, count);
+
+	//*	every length up to 200, starting at an odd address
+	for (count=0; count<=200; count++)
+	{
+		FillRandom(src, (count * 4) + 16, (uint32_t)count);
+		memset(out, 0xEE, (count * 4) + 16);
+		memset(ref, 0xEE, (count * 4) + 16);
+		PixConv_Widen8to16((uint16_t *)(out + 2), src + 1, count, 8);
+		for (iii=0; iii<count; iii++)
+		{
+			((uint16_t *)(ref + 2))[iii]	=	(uint16_t)(src[iii + 1] << 8);
+		}
+		CheckResult("Widen8to16", out, ref, (count * 4) + 16, count);
+
+		PixConv_Narrow16to8(out + 1, (uint16_t *)(src + 2), count);
+		for (iii=0; iii<count; iii++)
+		{
+			ref[iii + 1]	=	(uint8_t)(((uint16_t *)(src + 2))[iii] >> 8);
+		}
+		CheckResult("Narrow16to8", out, ref, (count * 4) + 16, count);
+
+		//*	3 byte pixel kernels
+		FillRandom(src, (count * 3) + 16, (uint32_t)count + 1000);
+		memset(out, 0xEE, (count * 3) + 16);
+		memset(ref, 0xEE, (count * 3) + 16);
+		PixConv_SwapRB24(out + 1, src, count);
+		for (iii=0; iii<count; iii++)
+		{
+			ref[(iii * 3) + 1]	=	src[(iii * 3) + 2];
+			ref[(iii * 3) + 2]	=	src[(iii * 3) + 1];
+			ref[(iii * 3) + 3]	=	src[(iii * 3) + 0];
+		}
+		CheckResult("SwapRB24", out, ref, (count * 3) + 16, count);
+		//*	in place
+		memcpy(out2, src, count * 3);
+		PixConv_SwapRB24(out2, out2, count);
+		CheckResult("SwapRB24 inplace", out2, ref + 1, count * 3, count);
+
+		memset(out, 0xEE, (count * 3) + 16);
+		memset(ref, 0xEE, (count * 3) + 16);
+		PixConv_Deinterleave24(out, out + count + 1, out + (2 * count) + 2, src + 1, count);
+		for (iii=0; iii<count; iii++)
+		{
+			ref[iii]					=	src[(iii * 3) + 1];
+			ref[count + 1 + iii]		=	src[(iii * 3) + 2];
+			ref[(2 * count) + 2 + iii]	=	src[(iii * 3) + 3];
+		}
+		CheckResult("Deinterleave24", out, ref, (count * 3) + 16, count);
+
+		//*	and back again
+		memset(out2, 0xEE, (count * 3) + 16);
+		PixConv_Interleave24(out2 + 1, out, out + count + 1, out + (2 * count) + 2, count);
+		CheckResult("Interleave24", out2 + 1, src + 1, count * 3, count);
+		if (out2[0] != 0xEE || out2[(count * 3) + 1] != 0xEE)
+		{
+			printf("FAIL: Interleave24 wrote outside the buffer, size=%lu\r\n", (unsigned long)count);
+			gFailCnt++;
+		}
+	}
+}
+
+//*****************************************************************************
+static void	CheckTransposeSize(uint8_t *src, uint8_t *out, uint8_t *ref, const int width, const int height)
+{
+int			xxx;
+int			yyy;
+int			ccc;
+size_t		pixelIdx;
+size_t		sizeArg;
+
+	sizeArg	=	((size_t)width * 10000) + height;
+	FillRandom(src, (size_t)width * height * 6, (uint32_t)sizeArg);
+
+	//*	8 bit
+	PixConv_Transpose8(out, src, width, height);
+	for (xxx=0; xxx<width; xxx++)
+	{
+		for (yyy=0; yyy<height; yyy++)
+		{
+			ref[(xxx * height) + yyy]	=	src[(yyy * width) + xxx];
+		}
+	}
+	CheckResult("Transpose8", out, ref, (size_t)width * height, sizeArg);
+
+	//*	16 bit
+	PixConv_Transpose16((uint16_t *)out, (uint16_t *)src, width, height);
+	for (xxx=0; xxx<width; xxx++)
+	{
+		for (yyy=0; yyy<height; yyy++)
+		{
+			((uint16_t *)ref)[(xxx * height) + yyy]	=	((uint16_t *)src)[(yyy * width) + xxx];
+		}
+	}
+	CheckResult("Transpose16", out, ref, (size_t)width * height * 2, sizeArg);
+
+	//*	24 bit, BGR to RGB
+	PixConv_Transpose24(out, src, width, height, true);
+	for (xxx=0; xxx<width; xxx++)
+	{
+		for (yyy=0; yyy<height; yyy++)
+		{
+			pixelIdx	=	((size_t)yyy * width) + xxx;
+			for (ccc=0; ccc<3; ccc++)
+			{
+				ref[(((xxx * height) + yyy) * 3) + ccc]	=	src[(pixelIdx * 3) + 2 - ccc];
+			}
+		}
+	}
+	CheckResult("Transpose24", out, ref, (size_t)width * height * 3, sizeArg);
+
+	//*	the imagearray conversions, 8 bit into the top of 16, 16 bit into the top of 32
+	PixConv_ToImageBytes(out, 2, 8, src, 1, 1, width, height);
+	for (xxx=0; xxx<width; xxx++)
+	{
+		for (yyy=0; yyy<height; yyy++)
+		{
+			((uint16_t *)ref)[(xxx * height) + yyy]	=	(uint16_t)(src[(yyy * width) + xxx] << 8);
+		}
+	}
+	CheckResult("ImageBytes 8>16", out, ref, (size_t)width * height * 2, sizeArg);
+
+	PixConv_ToImageBytes(out, 4, 16, src, 2, 1, width, height);
+	for (xxx=0; xxx<width; xxx++)
+	{
+		for (yyy=0; yyy<height; yyy++)
+		{
+			((uint32_t *)ref)[(xxx * height) + yyy]	=	(uint32_t)((uint16_t *)src)[(yyy * width) + xxx] << 16;
+		}
+	}
+	CheckResult("ImageBytes 16>32", out, ref, (size_t)width * height * 4, sizeArg);
+
+	PixConv_ToImageBytes(out, 2, 8, src, 1, 3, width, height);
+	for (xxx=0; xxx<width; xxx++)
+	{
+		for (yyy=0; yyy<height; yyy++)
+		{
+			pixelIdx	=	((size_t)yyy * width) + xxx;
+			for (ccc=0; ccc<3; ccc++)
+			{
+				((uint16_t *)ref)[(((xxx * height) + yyy) * 3) + ccc]	=	(uint16_t)(src[(pixelIdx * 3) + 2 - ccc] << 8);
+			}
+		}
+	}
+	CheckResult("ImageBytes rgb16", out, ref, (size_t)width * height * 6, sizeArg);
+}
+
+//*****************************************************************************
+//*	all sizes 1-40 in both directions, plus some bigger than a tile
+//*****************************************************************************
+static void	TestTransposes(uint8_t *src, uint8_t *out, uint8_t *ref)
+{
+int			width;
+int			height;
+int			iii;
+static const int	bigSizes[][2]	=	{	{129, 67}, {67, 129}, {200, 200}, {1000, 3}, {3, 1000}	};
+
+	for (width=1; width<=40; width++)
+	{
+		for (height=1; height<=40; height++)
+		{
+			CheckTransposeSize(src, out, ref, width, height);
+		}
+	}
+	for (iii=0; iii<(int)(sizeof(bigSizes) / sizeof(bigSizes[0])); iii++)
+	{
+		CheckTransposeSize(src, out, ref, bigSizes[iii][0], bigSizes[iii][1]);
+	}
+}
+
+//*****************************************************************************
+static void	PrintRate(const char *kernelName, const size_t bytesOut, const double elapsed_ms)
+{
+	printf("  %-22s %8.2f ms %8.2f GB/s\r\n", kernelName, elapsed_ms, (bytesOut / (elapsed_ms / 1000.0)) / 1.0e9);
+}
+
+//*****************************************************************************
+static void	RunBenchmarks(uint8_t *src, uint8_t *out)
+{
+size_t	pixelCnt;
+double	startTime_ms;
+int		loopCnt;
+
+	pixelCnt	=	(size_t)kTestWidth * kTestHeight;
+
+#define	BENCH(name, bytesOut, statement)								\
+	startTime_ms	=	GetMilliSecs();										\
+	for (loopCnt=0; loopCnt<kBenchLoops; loopCnt++)						\
+	{																	\
+		statement;														\
+	}																	\
+	PrintRate(name, bytesOut, (GetMilliSecs() - startTime_ms) / kBenchLoops);
+
+	BENCH("Widen8to16",			pixelCnt * 2,	PixConv_Widen8to16((uint16_t *)out, src, pixelCnt, 8));
+	BENCH("Widen8to32",			pixelCnt * 4,	PixConv_Widen8to32((uint32_t *)out, src, pixelCnt, 8));
+	BENCH("Widen16to32",		pixelCnt * 4,	PixConv_Widen16to32((uint32_t *)out, (uint16_t *)src, pixelCnt, 16));
+	BENCH("Narrow16to8",		pixelCnt,		PixConv_Narrow16to8(out, (uint16_t *)src, pixelCnt));
+	BENCH("ByteSwap16",			pixelCnt * 2,	PixConv_ByteSwap16((uint16_t *)out, (uint16_t *)src, pixelCnt));
+	BENCH("SwapRB24",			pixelCnt * 3,	PixConv_SwapRB24(out, src, pixelCnt));
+	BENCH("Deinterleave24",		pixelCnt * 3,	PixConv_Deinterleave24(out, out + pixelCnt, out + (2 * pixelCnt), src, pixelCnt));
+	BENCH("Interleave24",		pixelCnt * 3,	PixConv_Interleave24(out, src, src + pixelCnt, src + (2 * pixelCnt), pixelCnt));
+	BENCH("Transpose8",			pixelCnt,		PixConv_Transpose8(out, src, kTestWidth, kTestHeight));
+	BENCH("Transpose16",		pixelCnt * 2,	PixConv_Transpose16((uint16_t *)out, (uint16_t *)src, kTestWidth, kTestHeight));
+	BENCH("Transpose24",		pixelCnt * 3,	PixConv_Transpose24(out, src, kTestWidth, kTestHeight, true));
+	BENCH("ImageBytes 8>16",	pixelCnt * 2,	PixConv_ToImageBytes(out, 2, 8, src, 1, 1, kTestWidth, kTestHeight));
+	BENCH("ImageBytes 16>32",	pixelCnt * 4,	PixConv_ToImageBytes(out, 4, 16, src, 2, 1, kTestWidth, kTestHeight));
+	BENCH("ImageBytes rgb>rgb16",	pixelCnt * 6,	PixConv_ToImageBytes(out, 2, 8, src, 1, 3, kTestWidth, kTestHeight));
+#undef BENCH
+}
+
+//*****************************************************************************
+int main(int argc, char *argv[])
+{
+uint8_t		*src;
+uint8_t		*out;
+uint8_t		*ref;
+uint8_t		*out2;
+uint16_t	*oldLoop;
+size_t		pixelCnt;
+size_t		ccc;
+double		startTime_ms;
+int			maxLevel;
+int			level;
+int			xxx;
+int			yyy;
+
+	(void)argc;
+	(void)argv;
+	pixelCnt	=	(size_t)kTestWidth * kTestHeight;
+	src			=	(uint8_t *)malloc(pixelCnt * 6);
+	out			=	(uint8_t *)malloc(pixelCnt * 6);
+	ref			=	(uint8_t *)malloc(pixelCnt * 6);
+	out2		=	(uint8_t *)malloc(pixelCnt * 6);
+	maxLevel	=	PixConv_SetLevel(-1);
+	printf("cpu level: %s\r\n", PixConv_GetLevelName(maxLevel));
+
+	for (level=kPixConv_Scalar; level<=maxLevel; level++)
+	{
+		if (PixConv_SetLevel(level) != level)
+		{
+			continue;
+		}
+		TestElementKernels(src, out, ref, out2);
+		TestTransposes(src, out, ref);
+	}
+
+	FillRandom(src, pixelCnt * 6, 1);
+	for (level=kPixConv_Scalar; level<=maxLevel; level++)
+	{
+		if (PixConv_SetLevel(level) != level)
+		{
+			continue;
+		}
+		printf("%s, %dx%d\r\n", PixConv_GetLevelName(level), kTestWidth, kTestHeight);
+		RunBenchmarks(src, out);
+	}
+
+	//*	what BuildBinaryImage_Raw8_16bit() used to do
+	startTime_ms	=	GetMilliSecs();
+	oldLoop			=	(uint16_t *)out;
+	ccc				=	0;
+	for (xxx=0; xxx<kTestWidth; xxx++)
+	{
+		for (yyy=0; yyy<kTestHeight; yyy++)
+		{
+			oldLoop[ccc++]	=	(uint16_t)(src[(yyy * kTestWidth) + xxx] << 8);
+		}
+	}
+	printf("column loop 8>16, for reference\r\n");
+	PrintRate("", pixelCnt * 2, GetMilliSecs() - startTime_ms);
+
+	free(src);
+	free(out);
+	free(ref);
+	free(out2);
+	printf("Failures = %d\r\n", gFailCnt);
+	return(gFailCnt == 0 ? 0 : 1);
+}
+#endif // _INCLUDE_PIXEL_CONVERT_MAIN_
@@ -0,0 +1,80 @@
+//*****************************************************************************
+//#include	"pixel_convert.h"
+
+#ifndef _PIXEL_CONVERT_H_
+#define	_PIXEL_CONVERT_H_
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+#include	<stddef.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//*****************************************************************************
+//*	instruction set levels, PixConv_GetLevel() returns the best one this cpu has
+enum
+{
+	kPixConv_Scalar	=	0,
+	kPixConv_SSE2,
+	kPixConv_SSSE3,
+	kPixConv_AVX2,
+	kPixConv_NEON,
+
+	kPixConv_LevelCnt
+};
+
+#define	kPixConv_TileSize	64		//*	transposes are done in tiles this big
+
+//*****************************************************************************
+//*	All values are little endian (the Pi and x86), the same as ImageBytes.
+//*	"shift" is a left shift applied while widening, 8 turns an 8 bit value into
+//*	the top byte of a 16 bit one.
+//*	The transposes turn the row major camera buffer (width x height) into the
+//*	column major order used by imagearray: dst[(x * height) + y]
+//*****************************************************************************
+int			PixConv_GetLevel(void);
+int			PixConv_SetLevel(const int level);
+const char	*PixConv_GetLevelName(const int level);
+
+void	PixConv_Widen8to16(		uint16_t *dst, const uint8_t *src, const size_t count, const int shift);
+void	PixConv_Widen8to32(		uint32_t *dst, const uint8_t *src, const size_t count, const int shift);
+void	PixConv_Widen16to32(	uint32_t *dst, const uint16_t *src, const size_t count, const int shift);
+void	PixConv_Narrow16to8(	uint8_t *dst, const uint16_t *src, const size_t count);
+void	PixConv_ByteSwap16(		uint16_t *dst, const uint16_t *src, const size_t count);
+void	PixConv_SwapRB24(		uint8_t *dst, const uint8_t *src, const size_t pixelCount);
+void	PixConv_Deinterleave24(	uint8_t			*plane0,
+								uint8_t			*plane1,
+								uint8_t			*plane2,
+								const uint8_t	*src,
+								const size_t	pixelCount);
+void	PixConv_Interleave24(	uint8_t			*dst,
+								const uint8_t	*plane0,
+								const uint8_t	*plane1,
+								const uint8_t	*plane2,
+								const size_t	pixelCount);
+void	PixConv_Transpose8(		uint8_t *dst, const uint8_t *src, const int width, const int height);
+void	PixConv_Transpose16(	uint16_t *dst, const uint16_t *src, const int width, const int height);
+void	PixConv_Transpose24(	uint8_t *dst, const uint8_t *src, const int width, const int height, const bool swapRB);
+
+//*	row major camera data to column major ImageBytes, channels 3 is BGR in, RGB out
+void	PixConv_ToImageBytes(	void			*dst,
+								const int		dstBytesPerValue,
+								const int		shift,
+								const void		*src,
+								const int		srcBytesPerValue,
+								const int		channels,
+								const int		width,
+								const int		height);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _PIXEL_CONVERT_H_
@@ -0,0 +1,780 @@
+//*****************************************************************************
+//*	Name:			preview_pyramid.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	2x, 4x and 8x downsampled, stretched 8 bit previews of the
+//*					last frame, so clients that only need a thumbnail for framing
+//*					or focusing do not have to download the full imagearray.
+//*
+//*	The pyramid is built once per frame in one pass over the camera buffer.
+//*	Each pair of source rows makes one 2x row (2x2 box average), every second
+//*	2x row makes a 4x row from the 2x rows that are still in cache, and so on.
+//*	The inner loops are plain array loops with no branches so the compiler
+//*	can vectorize them (NEON on the Pi, SSE/AVX on x86).
+//*
+//*	The stretch (black/white point) comes from a histogram of the 8x level,
+//*	16 bit data also gets a square root curve so faint things show up.
+//*
+//*	The levels are built into back buffers and swapped in under the mutex,
+//*	the http thread never sees a half built level. The jpeg for a level is
+//*	encoded the first time it is requested and reused until the next frame.
+//*
+//*	Raw (bayer) frames are averaged as if they were monochrome, good enough
+//*	for framing and focus.
+//*
+//*	The MJPEG stream uses the same stretch and jpeg encoder, Pyramid_StretchLUT()
+//*	and Pyramid_EncodeJPEG().
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Re-distributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 18,	2026	<MLS> Created preview_pyramid.c
+//*	Oct 18,	2026	<MLS> Added Pyramid_StretchLUT() & Pyramid_EncodeJPEG() for the MJPEG stream
+//*	Oct 18,	2026	<MLS> libjpeg errors longjmp back instead of calling exit()
+//*****************************************************************************
+
+#ifdef _INCLUDE_PREVIEW_PYRAMID_MAIN_
+	#define	_ENABLE_PREVIEW_PYRAMID_
+#endif
+
+#if defined(_ENABLE_PREVIEW_PYRAMID_) || defined(_ENABLE_MJPEG_STREAM_)
+
+#include	<stdbool.h>
+#include	<stdint.h>
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	<math.h>
+#include	<time.h>
+#include	<setjmp.h>
+#include	<pthread.h>
+
+#include	<jpeglib.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"preview_pyramid.h"
+
+//*****************************************************************************
+static double	GetMilliSecs(void)
+{
+struct timespec	currentTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &currentTime);
+	return((currentTime.tv_sec * 1000.0) + (currentTime.tv_nsec / 1000000.0));
+}
+
+//*****************************************************************************
+//*	2x2 box average of two 8 bit source rows
+//*****************************************************************************
+static void	Downsample2x_U8(const uint8_t	*__restrict__ row0,
+							const uint8_t	*__restrict__ row1,
+							uint16_t		*__restrict__ outRow,
+							const int		outWidth,
+							const int		channels)
+{
+int		xxx;
+
+	if (channels == 3)
+	{
+		for (xxx=0; xxx<(outWidth * 3); xxx+=3)
+		{
+			outRow[xxx]		=	(row0[(xxx * 2)]		+ row0[(xxx * 2) + 3]	+ row1[(xxx * 2)]		+ row1[(xxx * 2) + 3]	+ 2) >> 2;
+			outRow[xxx + 1]	=	(row0[(xxx * 2) + 1]	+ row0[(xxx * 2) + 4]	+ row1[(xxx * 2) + 1]	+ row1[(xxx * 2) + 4]	+ 2) >> 2;
+			outRow[xxx + 2]	=	(row0[(xxx * 2) + 2]	+ row0[(xxx * 2) + 5]	+ row1[(xxx * 2) + 2]	+ row1[(xxx * 2) + 5]	+ 2) >> 2;
+		}
+	}
+	else
+	{
+		for (xxx=0; xxx<outWidth; xxx++)
+		{
+			outRow[xxx]	=	(row0[(xxx * 2)] + row0[(xxx * 2) + 1] + row1[(xxx * 2)] + row1[(xxx * 2) + 1] + 2) >> 2;
+		}
+	}
+}
+
+//*****************************************************************************
+//*	2x2 box average of two 16 bit rows, used for 16 bit sources and for
+//*	the 4x and 8x levels
+//*****************************************************************************
+static void	Downsample2x_U16(	const uint16_t	*__restrict__ row0,
+								const uint16_t	*__restrict__ row1,
+								uint16_t		*__restrict__ outRow,
+								const int		outWidth,
+								const int		channels)
+{
+int		xxx;
+
+	if (channels == 3)
+	{
+		for (xxx=0; xxx<(outWidth * 3); xxx+=3)
+		{
+			outRow[xxx]		=	((uint32_t)row0[(xxx * 2)]		+ row0[(xxx * 2) + 3]	+ row1[(xxx * 2)]		+ row1[(xxx * 2) + 3]	+ 2) >> 2;
+			outRow[xxx + 1]	=	((uint32_t)row0[(xxx * 2) + 1]	+ row0[(xxx * 2) + 4]	+ row1[(xxx * 2) + 1]	+ row1[(xxx * 2) + 4]	+ 2) >> 2;
+			outRow[xxx + 2]	=	((uint32_t)row0[(xxx * 2) + 2]	+ row0[(xxx * 2) + 5]	+ row1[(xxx * 2) + 2]	+ row1[(xxx * 2) + 5]	+ 2) >> 2;
+		}
+	}
+	else
+	{
+		for (xxx=0; xxx<outWidth; xxx++)
+		{
+			outRow[xxx]	=	((uint32_t)row0[(xxx * 2)] + row0[(xxx * 2) + 1] + row1[(xxx * 2)] + row1[(xxx * 2) + 1] + 2) >> 2;
+		}
+	}
+}
+
+//*****************************************************************************
+static bool	ReserveBuffer(void **bufferPtr, size_t *bufferSize, const size_t neededSize)
+{
+	if (neededSize > *bufferSize)
+	{
+		free(*bufferPtr);
+		*bufferPtr	=	malloc(neededSize);
+		*bufferSize	=	(*bufferPtr != NULL) ? neededSize : 0;
+	}
+	return(*bufferPtr != NULL);
+}
+
+//*****************************************************************************
+//*	black and white points from a histogram of pixelCnt values (0 to maxValue),
+//*	then the lookup table to 8 bits. squareRoot adds the curve for 16 bit data
+//*****************************************************************************
+void	Pyramid_StretchLUT(	const uint32_t	*histogram,
+							const uint32_t	maxValue,
+							const uint32_t	pixelCnt,
+							const bool		squareRoot,
+							uint8_t			*stretchLUT,
+							uint32_t		*blackLevelPtr,
+							uint32_t		*whiteLevelPtr)
+{
+uint32_t		blackCnt;
+uint32_t		whiteCnt;
+uint32_t		runningCnt;
+uint32_t		iii;
+uint32_t		blackLevel;
+uint32_t		whiteLevel;
+bool			blackFound;
+double			range;
+double			fraction;
+
+	//*	clip the darkest 0.5% and the brightest 0.05%
+	blackCnt	=	pixelCnt / 200;
+	whiteCnt	=	pixelCnt - (pixelCnt / 2000);
+	blackLevel	=	0;
+	whiteLevel	=	maxValue;
+	runningCnt	=	0;
+	blackFound	=	false;
+	for (iii=0; iii<=maxValue; iii++)
+	{
+		runningCnt	+=	histogram[iii];
+		if ((blackFound == false) && (runningCnt > blackCnt))
+		{
+			blackLevel	=	iii;
+			blackFound	=	true;
+		}
+		if (runningCnt >= whiteCnt)
+		{
+			whiteLevel	=	iii;
+			break;
+		}
+	}
+	if (whiteLevel <= blackLevel)
+	{
+		whiteLevel	=	blackLevel + 1;
+	}
+	*blackLevelPtr	=	blackLevel;
+	*whiteLevelPtr	=	whiteLevel;
+
+	range	=	whiteLevel - blackLevel;
+	for (iii=0; iii<=maxValue; iii++)
+	{
+		if (iii <= blackLevel)
+		{
+			stretchLUT[iii]	=	0;
+		}
+		else if (iii >= whiteLevel)
+		{
+			stretchLUT[iii]	=	255;
+		}
+		else
+		{
+			fraction	=	(iii - blackLevel) / range;
+			if (squareRoot)
+			{
+				fraction	=	sqrt(fraction);
+			}
+			stretchLUT[iii]	=	(uint8_t)((fraction * 255.0) + 0.5);
+		}
+	}
+}
+
+//*****************************************************************************
+//*	black and white points from the 8x level, then the lookup table
+//*****************************************************************************
+static void	BuildStretchLUT(TYPE_PREVIEW_PYRAMID *pyramid, const int channels)
+{
+const uint16_t	*linearPtr;
+uint32_t		maxValue;
+uint32_t		pixelCnt;
+uint32_t		iii;
+
+	maxValue	=	(pyramid->srcPixelType == kPyramid_Pixel_Gray16) ? 65535 : 255;
+	pixelCnt	=	pyramid->backLevel[kPyramid_LevelCnt - 1].width *
+					pyramid->backLevel[kPyramid_LevelCnt - 1].height * channels;
+	linearPtr	=	pyramid->linear[kPyramid_LevelCnt - 1];
+
+	memset(pyramid->histogram, 0, (maxValue + 1) * sizeof(uint32_t));
+	for (iii=0; iii<pixelCnt; iii++)
+	{
+		pyramid->histogram[linearPtr[iii]]++;
+	}
+	Pyramid_StretchLUT(	pyramid->histogram,
+						maxValue,
+						pixelCnt,
+						(pyramid->srcPixelType == kPyramid_Pixel_Gray16),
+						pyramid->stretchLUT,
+						&pyramid->blackLevel,
+						&pyramid->whiteLevel);
+}
+
+//*****************************************************************************
+TYPE_PREVIEW_PYRAMID	*Pyramid_Create(void)
+{
+TYPE_PREVIEW_PYRAMID	*pyramid;
+
+	pyramid	=	(TYPE_PREVIEW_PYRAMID *)calloc(1, sizeof(TYPE_PREVIEW_PYRAMID));
+	if (pyramid != NULL)
+	{
+		pyramid->histogram	=	(uint32_t *)malloc(65536 * sizeof(uint32_t));
+		pyramid->stretchLUT	=	(uint8_t *)malloc(65536);
+		if ((pyramid->histogram == NULL) || (pyramid->stretchLUT == NULL))
+		{
+			free(pyramid->histogram);
+			free(pyramid->stretchLUT);
+			free(pyramid);
+			return(NULL);
+		}
+		pthread_mutex_init(&pyramid->mutex, NULL);
+	}
+	return(pyramid);
+}
+
+//*****************************************************************************
+void	Pyramid_Delete(TYPE_PREVIEW_PYRAMID *pyramid)
+{
+int		iii;
+
+	if (pyramid != NULL)
+	{
+		for (iii=0; iii<kPyramid_LevelCnt; iii++)
+		{
+			free(pyramid->level[iii].pixels);
+			free(pyramid->level[iii].jpegData);
+			free(pyramid->backLevel[iii].pixels);
+			free(pyramid->backLevel[iii].jpegData);
+			free(pyramid->linear[iii]);
+		}
+		free(pyramid->histogram);
+		free(pyramid->stretchLUT);
+		pthread_mutex_destroy(&pyramid->mutex);
+		free(pyramid);
+	}
+}
+
+//*****************************************************************************
+//*	returns the level index for a scale factor of 2, 4 or 8, -1 if invalid
+//*****************************************************************************
+int	Pyramid_LevelFromScale(const int scaleFactor)
+{
+	switch(scaleFactor)
+	{
+		case 2:		return(0);
+		case 4:		return(1);
+		case 8:		return(2);
+		default:	return(-1);
+	}
+}
+
+//*****************************************************************************
+//*	called from the camera thread once per frame
+//*****************************************************************************
+bool	Pyramid_Build(	TYPE_PREVIEW_PYRAMID	*pyramid,
+						const void				*pixelData,
+						const int				width,
+						const int				height,
+						const int				pixelType,
+						const uint32_t			frameNum)
+{
+TYPE_PYRAMID_LEVEL	*backLevel;
+TYPE_PYRAMID_LEVEL	swapLevel;
+const uint8_t		*src8Ptr;
+const uint16_t		*src16Ptr;
+const uint16_t		*linearPtr;
+uint8_t				*pixelPtr;
+const uint8_t		*lut;
+int					channels;
+int					levelWidth[kPyramid_LevelCnt];
+int					levelHeight[kPyramid_LevelCnt];
+int					iii;
+int					yyy;
+int					y4;
+int					y8;
+size_t				valueCnt;
+size_t				vvv;
+double				startTime_ms;
+
+	if ((pyramid == NULL) || (pixelData == NULL))
+	{
+		return(false);
+	}
+	startTime_ms	=	GetMilliSecs();
+	channels		=	(pixelType == kPyramid_Pixel_BGR24) ? 3 : 1;
+	levelWidth[0]	=	width / 2;
+	levelHeight[0]	=	height / 2;
+	for (iii=1; iii<kPyramid_LevelCnt; iii++)
+	{
+		levelWidth[iii]		=	levelWidth[iii - 1] / 2;
+		levelHeight[iii]	=	levelHeight[iii - 1] / 2;
+	}
+	if ((levelWidth[kPyramid_LevelCnt - 1] <= 0) || (levelHeight[kPyramid_LevelCnt - 1] <= 0))
+	{
+		return(false);
+	}
+
+	//*	the back buffers and work buffers are only touched by this thread
+	for (iii=0; iii<kPyramid_LevelCnt; iii++)
+	{
+		valueCnt	=	(size_t)levelWidth[iii] * levelHeight[iii] * channels;
+		if ((ReserveBuffer((void **)&pyramid->linear[iii], &pyramid->linearSize[iii], (valueCnt * sizeof(uint16_t))) == false) ||
+			(ReserveBuffer((void **)&pyramid->backLevel[iii].pixels, &pyramid->backLevel[iii].pixelBufSize, valueCnt) == false))
+		{
+			CONSOLE_DEBUG("Failed to allocate preview pyramid buffers");
+			return(false);
+		}
+		pyramid->backLevel[iii].width		=	levelWidth[iii];
+		pyramid->backLevel[iii].height		=	levelHeight[iii];
+		pyramid->backLevel[iii].channels	=	channels;
+	}
+	pyramid->srcWidth		=	width;
+	pyramid->srcHeight		=	height;
+	pyramid->srcPixelType	=	pixelType;
+
+	//*	the single pass over the source, each level is made from rows that were just written
+	src8Ptr		=	(const uint8_t *)pixelData;
+	src16Ptr	=	(const uint16_t *)pixelData;
+	for (yyy=0; yyy<levelHeight[0]; yyy++)
+	{
+		if (pixelType == kPyramid_Pixel_Gray16)
+		{
+			Downsample2x_U16(	&src16Ptr[(size_t)(yyy * 2) * width],
+								&src16Ptr[(size_t)((yyy * 2) + 1) * width],
+								&pyramid->linear[0][(size_t)yyy * levelWidth[0]],
+								levelWidth[0],
+								1);
+		}
+		else
+		{
+			Downsample2x_U8(	&src8Ptr[(size_t)(yyy * 2) * width * channels],
+								&src8Ptr[(size_t)((yyy * 2) + 1) * width * channels],
+								&pyramid->linear[0][(size_t)yyy * levelWidth[0] * channels],
+								levelWidth[0],
+								channels);
+		}
+		y4	=	yyy / 2;
+		if ((yyy & 1) && (y4 < levelHeight[1]))
+		{
+			Downsample2x_U16(	&pyramid->linear[0][(size_t)(y4 * 2) * levelWidth[0] * channels],
+								&pyramid->linear[0][(size_t)((y4 * 2) + 1) * levelWidth[0] * channels],
+								&pyramid->linear[1][(size_t)y4 * levelWidth[1] * channels],
+								levelWidth[1],
+								channels);
+			y8	=	y4 / 2;
+			if ((y4 & 1) && (y8 < levelHeight[2]))
+			{
+				Downsample2x_U16(	&pyramid->linear[1][(size_t)(y8 * 2) * levelWidth[1] * channels],
+									&pyramid->linear[1][(size_t)((y8 * 2) + 1) * levelWidth[1] * channels],
+									&pyramid->linear[2][(size_t)y8 * levelWidth[2] * channels],
+									levelWidth[2],
+									channels);
+			}
+		}
+	}
+
+	//*	stretch to 8 bits, the camera color buffer is BGR, the previews are RGB
+	BuildStretchLUT(pyramid, channels);
+	lut	=	pyramid->stretchLUT;
+	for (iii=0; iii<kPyramid_LevelCnt; iii++)
+	{
+		backLevel	=	&pyramid->backLevel[iii];
+		linearPtr	=	pyramid->linear[iii];
+		pixelPtr	=	backLevel->pixels;
+		valueCnt	=	(size_t)backLevel->width * backLevel->height * channels;
+		if (channels == 3)
+		{
+			for (vvv=0; vvv<valueCnt; vvv+=3)
+			{
+				pixelPtr[vvv]		=	lut[linearPtr[vvv + 2]];
+				pixelPtr[vvv + 1]	=	lut[linearPtr[vvv + 1]];
+				pixelPtr[vvv + 2]	=	lut[linearPtr[vvv]];
+			}
+		}
+		else
+		{
+			for (vvv=0; vvv<valueCnt; vvv++)
+			{
+				pixelPtr[vvv]	=	lut[linearPtr[vvv]];
+			}
+		}
+	}
+
+	//*	publish, the old levels become the next back buffers
+	pthread_mutex_lock(&pyramid->mutex);
+	for (iii=0; iii<kPyramid_LevelCnt; iii++)
+	{
+		swapLevel				=	pyramid->level[iii];
+		pyramid->level[iii]		=	pyramid->backLevel[iii];
+		pyramid->backLevel[iii]	=	swapLevel;
+	}
+	pyramid->frameNum		=	frameNum;
+	pyramid->buildCnt++;
+	pyramid->buildTime_ms	=	GetMilliSecs() - startTime_ms;
+	pthread_mutex_unlock(&pyramid->mutex);
+
+	//*	the jpegs belong to the old frame
+	for (iii=0; iii<kPyramid_LevelCnt; iii++)
+	{
+		free(pyramid->backLevel[iii].jpegData);
+		pyramid->backLevel[iii].jpegData	=	NULL;
+		pyramid->backLevel[iii].jpegLen		=	0;
+	}
+	return(true);
+}
+
+//*****************************************************************************
+//*	the default libjpeg error handler calls exit(), this one jumps back to
+//*	Pyramid_EncodeJPEG() so a bad frame costs one preview, not the whole driver
+//*****************************************************************************
+typedef struct
+{
+	struct jpeg_error_mgr	jerr;
+	jmp_buf					jumpBuffer;
+} TYPE_JPEG_ERROR;
+
+//*****************************************************************************
+static void	JPEG_ErrorExit(j_common_ptr jinfo)
+{
+TYPE_JPEG_ERROR	*jpegError	=	(TYPE_JPEG_ERROR *)jinfo->err;
+char			errorMsg[JMSG_LENGTH_MAX];
+
+	(*jinfo->err->format_message)(jinfo, errorMsg);
+	CONSOLE_DEBUG_W_STR("libjpeg error:", errorMsg);
+	longjmp(jpegError->jumpBuffer, 1);
+}
+
+//*****************************************************************************
+//*	pixels are 8 bit, row major, 1 (gray) or 3 (RGB) channels.
+//*	*jpegData is malloc'd by libjpeg, the caller frees it
+//*****************************************************************************
+bool	Pyramid_EncodeJPEG(	const uint8_t	*pixels,
+							const int		width,
+							const int		height,
+							const int		channels,
+							const int		quality,
+							unsigned char	**jpegData,
+							unsigned long	*jpegLen)
+{
+struct jpeg_compress_struct	jinfo;
+TYPE_JPEG_ERROR				jpegError;
+JSAMPROW					rowPointer[1];
+int							yyy;
+
+	*jpegData					=	NULL;
+	*jpegLen					=	0;
+	jinfo.err					=	jpeg_std_error(&jpegError.jerr);
+	jpegError.jerr.error_exit	=	JPEG_ErrorExit;
+	if (setjmp(jpegError.jumpBuffer) != 0)
+	{
+		jpeg_destroy_compress(&jinfo);
+		free(*jpegData);
+		*jpegData	=	NULL;
+		*jpegLen	=	0;
+		return(false);
+	}
+	jpeg_create_compress(&jinfo);
+	jpeg_mem_dest(&jinfo, jpegData, jpegLen);
+	jinfo.image_width		=	width;
+	jinfo.image_height		=	height;
+	jinfo.input_components	=	channels;
+	jinfo.in_color_space	=	(channels == 3) ? JCS_RGB : JCS_GRAYSCALE;
+	jpeg_set_defaults(&jinfo);
+	jpeg_set_quality(&jinfo, quality, TRUE);
+	jinfo.dct_method		=	JDCT_IFAST;
+	jpeg_start_compress(&jinfo, TRUE);
+	for (yyy=0; yyy<height; yyy++)
+	{
+		rowPointer[0]	=	(JSAMPROW)&pixels[(size_t)yyy * width * channels];
+		jpeg_write_scanlines(&jinfo, rowPointer, 1);
+	}
+	jpeg_finish_compress(&jinfo);
+	jpeg_destroy_compress(&jinfo);
+	return(*jpegData != NULL);
+}
+
+//*****************************************************************************
+static bool	EncodeLevelJPEG(TYPE_PYRAMID_LEVEL *level)
+{
+	return(Pyramid_EncodeJPEG(	level->pixels,
+								level->width,
+								level->height,
+								level->channels,
+								kPyramid_JPEGquality,
+								&level->jpegData,
+								&level->jpegLen));
+}
+
+//*****************************************************************************
+//*	returns a copy of the level so the caller can send it without holding the lock
+//*****************************************************************************
+bool	Pyramid_GetLevel(	TYPE_PREVIEW_PYRAMID	*pyramid,
+							const int				levelIdx,
+							const int				outputFormat,
+							TYPE_PYRAMID_OUTPUT		*output)
+{
+TYPE_PYRAMID_LEVEL	*level;
+unsigned char		*outPtr;
+const uint8_t		*columnPtr;
+size_t				rowStride;
+int					xxx;
+int					yyy;
+int					ccc;
+bool				validData;
+
+	memset(output, 0, sizeof(TYPE_PYRAMID_OUTPUT));
+	if ((pyramid == NULL) || (levelIdx < 0) || (levelIdx >= kPyramid_LevelCnt))
+	{
+		return(false);
+	}
+	validData	=	false;
+	pthread_mutex_lock(&pyramid->mutex);
+	level	=	&pyramid->level[levelIdx];
+	if (level->pixels != NULL)
+	{
+		output->frameNum	=	pyramid->frameNum;
+		output->width		=	level->width;
+		output->height		=	level->height;
+		output->channels	=	level->channels;
+		if (outputFormat == kPyramid_Format_JPEG)
+		{
+			if ((level->jpegData != NULL) || EncodeLevelJPEG(level))
+			{
+				output->data	=	(unsigned char *)malloc(level->jpegLen);
+				if (output->data != NULL)
+				{
+					memcpy(output->data, level->jpegData, level->jpegLen);
+					output->dataLen	=	level->jpegLen;
+					validData		=	true;
+				}
+			}
+		}
+		else
+		{
+			//*	imagearray order, x is the outer loop
+			output->dataLen	=	(size_t)level->width * level->height * level->channels;
+			output->data	=	(unsigned char *)malloc(output->dataLen);
+			if (output->data != NULL)
+			{
+				outPtr		=	output->data;
+				rowStride	=	(size_t)level->width * level->channels;
+				for (xxx=0; xxx<level->width; xxx++)
+				{
+					columnPtr	=	&level->pixels[xxx * level->channels];
+					for (yyy=0; yyy<level->height; yyy++)
+					{
+						for (ccc=0; ccc<level->channels; ccc++)
+						{
+							*outPtr++	=	columnPtr[ccc];
+						}
+						columnPtr	+=	rowStride;
+					}
+				}
+				validData	=	true;
+			}
+		}
+	}
+	pthread_mutex_unlock(&pyramid->mutex);
+	return(validData);
+}
+
+
+#ifdef _INCLUDE_PREVIEW_PYRAMID_MAIN_
+//*****************************************************************************
+//*	Builds the pyramid for a simulated 20 megapixel 16 bit star field,
+//*	checks the averages and ordering, and reports the build time and
+//*	preview sizes against the full imagearray.
+//*
+//*	g++ -O2 -x c++ -D_INCLUDE_PREVIEW_PYRAMID_MAIN_ -I../libs/src_mlsLib preview_pyramid.c -ljpeg -lpthread -o pyramidtest
+//*****************************************************************************
+#define	kTestWidth		5496
+#define	kTestHeight		3672
+#define	kTestLoops		10
+#define	kWiFi_Mbits		2.0			//*	a phone on marginal Wi-Fi
+
+//*****************************************************************************
+int main(int argc, char *argv[])
+{
+TYPE_PREVIEW_PYRAMID	*pyramid;
+TYPE_PYRAMID_OUTPUT		output;
+unsigned char			*jpegData;
+unsigned long			jpegLen;
+uint16_t				*image16;
+uint8_t					*imageBGR;
+uint32_t				randomState;
+uint32_t				blockSum;
+int						xxx;
+int						yyy;
+int						iii;
+int						sss;
+int						starX;
+int						starY;
+int						failCnt;
+double					startTime_ms;
+double					totalTime_ms;
+double					fullSize_MB;
+
+	(void)argc;
+	(void)argv;
+	failCnt		=	0;
+	pyramid		=	Pyramid_Create();
+	image16		=	(uint16_t *)malloc((size_t)kTestWidth * kTestHeight * sizeof(uint16_t));
+	randomState	=	12345;
+	for (iii=0; iii<(kTestWidth * kTestHeight); iii++)
+	{
+		randomState	=	(randomState * 1103515245) + 12345;
+		image16[iii]	=	1000 + ((randomState >> 16) & 0x3f);
+	}
+	for (sss=0; sss<500; sss++)
+	{
+		randomState	=	(randomState * 1103515245) + 12345;
+		starX		=	8 + ((randomState >> 8) % (kTestWidth - 16));
+		randomState	=	(randomState * 1103515245) + 12345;
+		starY		=	8 + ((randomState >> 8) % (kTestHeight - 16));
+		for (yyy=-3; yyy<=3; yyy++)
+		{
+			for (xxx=-3; xxx<=3; xxx++)
+			{
+				image16[((starY + yyy) * kTestWidth) + starX + xxx]	+=	(uint16_t)(40000.0 * exp(-((xxx * xxx) + (yyy * yyy)) / 2.0));
+			}
+		}
+	}
+
+	//*	build time
+	totalTime_ms	=	0.0;
+	for (iii=0; iii<kTestLoops; iii++)
+	{
+		startTime_ms	=	GetMilliSecs();
+		Pyramid_Build(pyramid, image16, kTestWidth, kTestHeight, kPyramid_Pixel_Gray16, iii + 1);
+		totalTime_ms	+=	GetMilliSecs() - startTime_ms;
+	}
+	printf("Build %dx%d 16 bit: %1.2f ms per frame, black=%u white=%u\r\n",	kTestWidth, kTestHeight,
+																				totalTime_ms / kTestLoops,
+																				pyramid->blackLevel,
+																				pyramid->whiteLevel);
+
+	//*	the 8x level has to be the average of the 8x8 block (before the stretch)
+	for (yyy=0; yyy<pyramid->level[2].height; yyy+=37)
+	{
+		for (xxx=0; xxx<pyramid->level[2].width; xxx+=41)
+		{
+			blockSum	=	0;
+			for (iii=0; iii<64; iii++)
+			{
+				blockSum	+=	image16[(((yyy * 8) + (iii / 8)) * kTestWidth) + (xxx * 8) + (iii % 8)];
+			}
+			if (abs((int)(blockSum / 64) - (int)pyramid->linear[2][(yyy * pyramid->level[2].width) + xxx]) > 2)
+			{
+				printf("FAIL: 8x average at %d,%d\r\n", xxx, yyy);
+				failCnt++;
+			}
+		}
+	}
+
+	//*	sizes and times for each level
+	fullSize_MB	=	(kTestWidth * kTestHeight * 2.0) / 1000000.0;
+	printf("Full imagearray (imagebytes)  %9.0f KB %8.0f ms on %1.0f Mbit/s\r\n",	fullSize_MB * 1000.0,
+																					(fullSize_MB * 8.0 * 1000.0) / kWiFi_Mbits,
+																					kWiFi_Mbits);
+	for (iii=0; iii<kPyramid_LevelCnt; iii++)
+	{
+		startTime_ms	=	GetMilliSecs();
+		Pyramid_GetLevel(pyramid, iii, kPyramid_Format_JPEG, &output);
+		totalTime_ms	=	GetMilliSecs() - startTime_ms;
+		printf("%dx %4dx%-4d jpeg (encode %4.1f ms) %9.1f KB %8.1f ms\r\n",	(2 << iii),
+																			output.width, output.height,
+																			totalTime_ms,
+																			output.dataLen / 1000.0,
+																			(output.dataLen * 8.0) / (kWiFi_Mbits * 1000.0));
+		free(output.data);
+		Pyramid_GetLevel(pyramid, iii, kPyramid_Format_ImageBytes, &output);
+		printf("%dx %4dx%-4d imagebytes             %9.1f KB %8.1f ms\r\n",	(2 << iii),
+																			output.width, output.height,
+																			output.dataLen / 1000.0,
+																			(output.dataLen * 8.0) / (kWiFi_Mbits * 1000.0));
+		//*	column major, the second value is the pixel below the first
+		if (output.data[1] != pyramid->level[iii].pixels[output.width])
+		{
+			printf("FAIL: imagebytes order\r\n");
+			failCnt++;
+		}
+		free(output.data);
+	}
+
+	//*	color, pure blue BGR has to come out as RGB 0,0,255
+	imageBGR	=	(uint8_t *)calloc((size_t)640 * 480 * 3, 1);
+	for (iii=0; iii<(640 * 480); iii++)
+	{
+		imageBGR[(iii * 3)]	=	(iii < (640 * 240)) ? 200 : 10;
+	}
+	Pyramid_Build(pyramid, imageBGR, 640, 480, kPyramid_Pixel_BGR24, 100);
+	if ((pyramid->level[0].pixels[0] != 0) || (pyramid->level[0].pixels[2] != 255) || (pyramid->level[0].channels != 3))
+	{
+		printf("FAIL: BGR to RGB (%d,%d,%d)\r\n", pyramid->level[0].pixels[0], pyramid->level[0].pixels[1], pyramid->level[0].pixels[2]);
+		failCnt++;
+	}
+	if ((Pyramid_GetLevel(pyramid, 2, kPyramid_Format_JPEG, &output) == false) || (output.frameNum != 100) || (output.width != 80))
+	{
+		printf("FAIL: color jpeg\r\n");
+		failCnt++;
+	}
+	free(output.data);
+
+	//*	a libjpeg error has to come back as false, not exit()
+	if (Pyramid_EncodeJPEG(imageBGR, 70000, 1, 1, kPyramid_JPEGquality, &jpegData, &jpegLen) || (jpegData != NULL))
+	{
+		printf("FAIL: libjpeg error was not caught\r\n");
+		failCnt++;
+	}
+
+	Pyramid_Delete(pyramid);
+	free(image16);
+	free(imageBGR);
+	printf("Failures = %d\r\n", failCnt);
+	return(failCnt == 0 ? 0 : 1);
+}
+#endif // _INCLUDE_PREVIEW_PYRAMID_MAIN_
+
+#endif // _ENABLE_PREVIEW_PYRAMID_ || _ENABLE_MJPEG_STREAM_
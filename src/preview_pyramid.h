@@ -0,0 +1,115 @@
+//*****************************************************************************
+//#include	"preview_pyramid.h"
+
+#ifndef _PREVIEW_PYRAMID_H_
+#define	_PREVIEW_PYRAMID_H_
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+#include	<stddef.h>
+#include	<pthread.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define	kPyramid_LevelCnt		3			//*	2x, 4x, 8x
+#define	kPyramid_JPEGquality	80
+
+//*****************************************************************************
+enum
+{
+	kPyramid_Pixel_Gray8	=	0,
+	kPyramid_Pixel_Gray16,
+	kPyramid_Pixel_BGR24				//*	same order as the camera RGB24 buffer
+};
+
+//*****************************************************************************
+enum
+{
+	kPyramid_Format_JPEG	=	0,
+	kPyramid_Format_ImageBytes			//*	column major, same order as imagearray
+};
+
+//*****************************************************************************
+typedef struct	//	TYPE_PYRAMID_LEVEL
+{
+	int				width;
+	int				height;
+	int				channels;			//*	1 or 3 (RGB order)
+	uint8_t			*pixels;			//*	stretched 8 bit, row major
+	size_t			pixelBufSize;
+	unsigned char	*jpegData;			//*	encoded on the first request for this frame
+	unsigned long	jpegLen;
+} TYPE_PYRAMID_LEVEL;
+
+//*****************************************************************************
+typedef struct	//	TYPE_PREVIEW_PYRAMID
+{
+	pthread_mutex_t		mutex;
+	TYPE_PYRAMID_LEVEL	level[kPyramid_LevelCnt];		//*	what gets served
+	TYPE_PYRAMID_LEVEL	backLevel[kPyramid_LevelCnt];	//*	what is being built
+	uint16_t			*linear[kPyramid_LevelCnt];		//*	box averages, in the source range
+	size_t				linearSize[kPyramid_LevelCnt];
+	uint32_t			*histogram;
+	uint8_t				*stretchLUT;
+	uint32_t			frameNum;
+	int					srcWidth;
+	int					srcHeight;
+	int					srcPixelType;
+	uint32_t			blackLevel;
+	uint32_t			whiteLevel;
+	uint32_t			buildCnt;
+	double				buildTime_ms;					//*	last build
+} TYPE_PREVIEW_PYRAMID;
+
+//*****************************************************************************
+typedef struct	//	TYPE_PYRAMID_OUTPUT
+{
+	uint32_t		frameNum;
+	int				width;
+	int				height;
+	int				channels;
+	unsigned char	*data;				//*	malloc'd, the caller frees it
+	size_t			dataLen;
+} TYPE_PYRAMID_OUTPUT;
+
+
+TYPE_PREVIEW_PYRAMID	*Pyramid_Create(void);
+void					Pyramid_Delete(TYPE_PREVIEW_PYRAMID *pyramid);
+bool					Pyramid_Build(	TYPE_PREVIEW_PYRAMID	*pyramid,
+										const void				*pixelData,
+										const int				width,
+										const int				height,
+										const int				pixelType,
+										const uint32_t			frameNum);
+int						Pyramid_LevelFromScale(const int scaleFactor);
+void					Pyramid_StretchLUT(	const uint32_t	*histogram,
+											const uint32_t	maxValue,
+											const uint32_t	pixelCnt,
+											const bool		squareRoot,
+											uint8_t			*stretchLUT,
+											uint32_t		*blackLevelPtr,
+											uint32_t		*whiteLevelPtr);
+bool					Pyramid_EncodeJPEG(	const uint8_t	*pixels,
+											const int		width,
+											const int		height,
+											const int		channels,
+											const int		quality,
+											unsigned char	**jpegData,
+											unsigned long	*jpegLen);
+bool					Pyramid_GetLevel(	TYPE_PREVIEW_PYRAMID	*pyramid,
+											const int				levelIdx,
+											const int				outputFormat,
+											TYPE_PYRAMID_OUTPUT		*output);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _PREVIEW_PYRAMID_H_
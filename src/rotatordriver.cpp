@@ -45,6 +45,7 @@
 //*	Mar  2,	2023	<MLS> Working on Sync method to pass CONFORMU
 //*	Jun 18,	2023	<MLS> Added DeviceState_Add_Content() to rotator driver
 //*	May 18,	2024	<MLS> Started on http 400 error support for rotator driver
+//*	Oct 18,	2026	<MLS> Added PublishStateSnapshot()
 //*****************************************************************************
 
 #ifdef _ENABLE_ROTATOR_
@@ -61,6 +62,7 @@
 #include	"JsonResponse.h"
 
 #include	"alpacadriver.h"
+#include	"devicestate_snapshot.h"
 #include	"alpacadriver_helper.h"
 #include	"rotatordriver.h"
 
@@ -187,6 +189,25 @@ uint32_t	deltaMilliSecs;
 	return(5 * 1000 * 1000);
 }
 
+//*****************************************************************************
+//*	publish the current state for other devices, see devicestate_snapshot.c
+//*****************************************************************************
+void	RotatorDriver::PublishStateSnapshot(void)
+{
+TYPE_DeviceSnapshot	rotatorSnapshot;
+
+	memset(&rotatorSnapshot, 0, sizeof(TYPE_DeviceSnapshot));
+	rotatorSnapshot.deviceType					=	kDeviceType_Rotator;
+	rotatorSnapshot.alpacaDevNum				=	cAlpacaDeviceNum;
+	rotatorSnapshot.dev.rotator.Position_steps	=	cRotatorPosition_steps;
+	rotatorSnapshot.dev.rotator.Position_degs	=	cRotatorProp.Position;
+	rotatorSnapshot.dev.rotator.IsMoving		=	cRotatorProp.IsMoving;
+	strncpy(rotatorSnapshot.dev.rotator.Manufacturer,	cRotatorManufacturer,	(kSnapshotStrLen - 1));
+	strncpy(rotatorSnapshot.dev.rotator.Model,			cRotatorModel,			(kSnapshotStrLen - 1));
+	strncpy(rotatorSnapshot.dev.rotator.SerialNumber,	cRotatorSerialNum,		(kSnapshotStrLen - 1));
+	DeviceSnapshot_Publish(&rotatorSnapshot);
+}
+
 //*****************************************************************************
 TYPE_ASCOM_STATUS	RotatorDriver::ProcessCommand(TYPE_GetPutRequestData *reqData)
 {
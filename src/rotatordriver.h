@@ -41,6 +41,7 @@ class RotatorDriver: public AlpacaDriver
 		virtual	void				OutputHTML(TYPE_GetPutRequestData *reqData);
 //		virtual	void				OutputHTML_Part2(TYPE_GetPutRequestData *reqData);
 		virtual	int32_t				RunStateMachine(void);
+		virtual	void				PublishStateSnapshot(void);
 		virtual bool				GetCmdNameFromMyCmdTable(const int cmdNumber, char *comandName, char *getPut);
 
 		TYPE_ASCOM_STATUS	Get_Canreverse(			TYPE_GetPutRequestData *reqData, char *alpacaErrMsg, const char *responseString);
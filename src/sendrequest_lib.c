@@ -38,6 +38,7 @@
 //*	Sep  4,	2021	<MLS> Added microsecs arg to SetSocketTimeouts()
 //*	Sep  8,	2021	<MLS> Added "Connection: close" as per suggestion from Patrick Chevalley
 //*	Dec 14,	2021	<MLS> Added imagebytes option to OpenSocketAndSendRequest()
+//*	Oct 18,	2026	<MLS> Added OpenSocketAndSendRequest_Hdr() for extra header lines (Range:)
 //*****************************************************************************
 
 #include	<stdio.h>
@@ -119,6 +120,28 @@ int	OpenSocketAndSendRequest(	struct sockaddr_in	*deviceAddress,
 								const char			*sendData,
 								const char			*dataString,
 								const bool			includeImageBinary)
+{
+	return(OpenSocketAndSendRequest_Hdr(	deviceAddress,
+											port,
+											get_put_string,
+											sendData,
+											dataString,
+											includeImageBinary,
+											NULL));
+}
+
+//*****************************************************************************
+//*	same as above but allows additional header lines, i.e. "Range: bytes=0-1023\r\n"
+//*	extraHeaderLines must be complete lines including the CR/LF
+//*	returns a socket description
+//*****************************************************************************
+int	OpenSocketAndSendRequest_Hdr(	struct sockaddr_in	*deviceAddress,
+									const int			port,
+									const char			*get_put_string,	//*	must be either GET or PUT
+									const char			*sendData,
+									const char			*dataString,
+									const bool			includeImageBinary,
+									const char			*extraHeaderLines)
 {
 int					socket_desc;
 struct sockaddr_in	remoteDev;
@@ -190,6 +213,10 @@ int					so_oobinline;
 			strcat(xmitBuffer,	"\r\n");
 
 			strcat(xmitBuffer,	"Connection: close\r\n");
+			if (extraHeaderLines != NULL)
+			{
+				strcat(xmitBuffer,	extraHeaderLines);
+			}
 //			strcat(xmitBuffer,	"Accept: application/json, text/json, text/x-json, text/javascript, application/xml, text/xml\r\n");
 //			strcat(xmitBuffer,	"Accept-Language: en-US,en;q=0.5\r\n");
 
@@ -37,6 +37,13 @@ int		OpenSocketAndSendRequest(	struct sockaddr_in	*deviceAddress,
 									const char			*sendData,
 									const char			*dataString,
 									const bool			includeImageBinary);
+int		OpenSocketAndSendRequest_Hdr(	struct sockaddr_in	*deviceAddress,
+										const int			port,
+										const char			*get_put_string,	//*	must be either GET or PUT
+										const char			*sendData,
+										const char			*dataString,
+										const bool			includeImageBinary,
+										const char			*extraHeaderLines);
 
 extern	char		gUserAgentAlpacaPiStr[];
 
@@ -0,0 +1,692 @@
+//*****************************************************************************
+//*	Name:			serial_transport.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Event driven serial I/O for the command/response device protocols
+//*
+//*	The port is put in non-blocking mode and epoll is used to wait for data,
+//*	reads are done in bulk into a receive buffer and split into frames there.
+//*	This replaces the byte at a time read() with usleep() polling loops,
+//*	the caller wakes up as soon as the terminator arrives instead of at the next poll.
+//*
+//*	Bytes received after the end of a frame stay in the buffer for the next call,
+//*	this allows several commands to be sent back to back and the responses
+//*	picked up in order (SerialTransport_TransactBatch()).
+//*
+//*	The file descriptor belongs to the caller, it is opened and closed by the driver.
+//*
+//*	Not converted:
+//*		LX200 (lx200_com.c) talks to the mount over TCP and several replies are a
+//*		single character with no terminator (i.e. the ACK and slew replies), so the
+//*		framing depends on the command. It already blocks in recv() with a timeout.
+//*		The servo library (libs/src_servo) is binary with a fixed length reply per
+//*		command and a CRC, MC_read_comm() already waits with poll() and a deadline.
+//*		It is also built on its own (servo_test_tty, the _TEST_ programs) without src/.
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Re-distributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 18,	2026	<MLS> Created serial_transport.c
+//*	Oct 18,	2026	<MLS> kSerialStatus_Overflow is reported for truncated or discarded frames
+//*	Oct 18,	2026	<MLS> Added _INCLUDE_SERIAL_TRANSPORT_MAIN_ pty device emulator test
+//*****************************************************************************
+
+#include	<stdbool.h>
+#include	<stdint.h>
+#include	<stdio.h>
+#include	<string.h>
+#include	<errno.h>
+#include	<fcntl.h>
+#include	<unistd.h>
+#include	<termios.h>
+#include	<time.h>
+#include	<sys/epoll.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"serial_transport.h"
+
+//*****************************************************************************
+int64_t	SerialTransport_GetTime_us(void)
+{
+struct timespec	timeSpec;
+
+	clock_gettime(CLOCK_MONOTONIC, &timeSpec);
+	return(((int64_t)timeSpec.tv_sec * 1000000) + (timeSpec.tv_nsec / 1000));
+}
+
+//*****************************************************************************
+bool	SerialTransport_Init(TYPE_SerialTransport *transport, const int fileDesc)
+{
+struct epoll_event	epollEvent;
+int					fileFlags;
+bool				validFlag;
+
+	memset(transport, 0, sizeof(TYPE_SerialTransport));
+	transport->fileDesc		=	fileDesc;
+	transport->framingMode	=	kSerialFrame_Terminator;
+	transport->terminator	=	'\n';
+	transport->epollFD		=	-1;
+	transport->lastStatus	=	kSerialStatus_OK;
+
+	validFlag	=	false;
+	if (fileDesc >= 0)
+	{
+		fileFlags	=	fcntl(fileDesc, F_GETFL, 0);
+		fcntl(fileDesc, F_SETFL, fileFlags | O_NONBLOCK);
+
+		transport->epollFD	=	epoll_create1(EPOLL_CLOEXEC);
+		if (transport->epollFD >= 0)
+		{
+			memset(&epollEvent, 0, sizeof(struct epoll_event));
+			epollEvent.events	=	EPOLLIN;
+			epollEvent.data.fd	=	fileDesc;
+			if (epoll_ctl(transport->epollFD, EPOLL_CTL_ADD, fileDesc, &epollEvent) == 0)
+			{
+				validFlag	=	true;
+			}
+			else
+			{
+				CONSOLE_DEBUG_W_STR("epoll_ctl failed:", strerror(errno));
+				close(transport->epollFD);
+				transport->epollFD	=	-1;
+			}
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_STR("epoll_create1 failed:", strerror(errno));
+		}
+	}
+	return(validFlag);
+}
+
+//*****************************************************************************
+void	SerialTransport_Close(TYPE_SerialTransport *transport)
+{
+	if (transport->epollFD >= 0)
+	{
+		close(transport->epollFD);
+	}
+	transport->epollFD	=	-1;
+	transport->fileDesc	=	-1;
+	transport->rxCount	=	0;
+}
+
+//*****************************************************************************
+void	SerialTransport_SetTerminator(TYPE_SerialTransport *transport, const char terminator)
+{
+	transport->framingMode	=	kSerialFrame_Terminator;
+	transport->terminator	=	terminator;
+}
+
+//*****************************************************************************
+void	SerialTransport_SetFrameLength(TYPE_SerialTransport *transport, const int frameLength)
+{
+	transport->framingMode	=	kSerialFrame_Length;
+	transport->frameLength	=	frameLength;
+	if (transport->frameLength > kSerialRxBuffSize)
+	{
+		transport->frameLength	=	kSerialRxBuffSize;
+	}
+}
+
+//*****************************************************************************
+//*	throw away anything pending, both in the driver and in our buffer
+//*	returns false if tcflush() failed, i.e. the descriptor is a socket
+//*****************************************************************************
+bool	SerialTransport_Flush(TYPE_SerialTransport *transport)
+{
+int		tcReturnCode;
+
+	tcReturnCode		=	tcflush(transport->fileDesc, TCIFLUSH);
+	transport->rxCount	=	0;
+	return(tcReturnCode == 0);
+}
+
+//*****************************************************************************
+//*	returns -1 on error, 0 on timeout, 1 when the port is ready
+//*****************************************************************************
+static int	WaitForEvent(TYPE_SerialTransport *transport, const uint32_t events, const int timeout_ms)
+{
+struct epoll_event	epollEvent;
+int					eventCnt;
+
+	if (events != EPOLLIN)
+	{
+		memset(&epollEvent, 0, sizeof(struct epoll_event));
+		epollEvent.events	=	events;
+		epollEvent.data.fd	=	transport->fileDesc;
+		epoll_ctl(transport->epollFD, EPOLL_CTL_MOD, transport->fileDesc, &epollEvent);
+	}
+
+	do
+	{
+		eventCnt	=	epoll_wait(transport->epollFD, &epollEvent, 1, timeout_ms);
+	} while ((eventCnt < 0) && (errno == EINTR));
+
+	if (events != EPOLLIN)
+	{
+		epollEvent.events	=	EPOLLIN;
+		epollEvent.data.fd	=	transport->fileDesc;
+		epoll_ctl(transport->epollFD, EPOLL_CTL_MOD, transport->fileDesc, &epollEvent);
+	}
+	return(eventCnt);
+}
+
+//*****************************************************************************
+//*	returns the number of bytes written or -1 on error/timeout
+//*****************************************************************************
+int	SerialTransport_Write(	TYPE_SerialTransport	*transport,
+							const void				*xmitData,
+							const int				xmitLen,
+							const int				timeout_ms)
+{
+const char	*dataPtr;
+int			bytesSent;
+int			bytesWritten;
+int64_t		deadline_us;
+int			remaining_ms;
+
+	dataPtr		=	(const char *)xmitData;
+	bytesSent	=	0;
+	deadline_us	=	SerialTransport_GetTime_us() + ((int64_t)timeout_ms * 1000);
+	while (bytesSent < xmitLen)
+	{
+		bytesWritten	=	write(transport->fileDesc, (dataPtr + bytesSent), (xmitLen - bytesSent));
+		if (bytesWritten > 0)
+		{
+			bytesSent	+=	bytesWritten;
+		}
+		else if ((bytesWritten < 0) && (errno != EAGAIN) && (errno != EINTR))
+		{
+			CONSOLE_DEBUG_W_STR("write failed:", strerror(errno));
+			return(-1);
+		}
+		else
+		{
+			remaining_ms	=	(int)((deadline_us - SerialTransport_GetTime_us()) / 1000);
+			if ((remaining_ms <= 0) || (WaitForEvent(transport, EPOLLOUT, remaining_ms) <= 0))
+			{
+				CONSOLE_DEBUG("write timeout");
+				return(-1);
+			}
+		}
+	}
+	return(bytesSent);
+}
+
+//*****************************************************************************
+//*	if a complete frame is in the buffer, copy it out and return its length
+//*	the terminator is not included, the frame is null terminated
+//*****************************************************************************
+static int	ExtractFrame(TYPE_SerialTransport *transport, char *frameBuff, const int frameBuffLen)
+{
+int		frameLen;
+int		consumed;
+int		copyLen;
+int		iii;
+
+	frameLen	=	-1;
+	consumed	=	0;
+	if (transport->framingMode == kSerialFrame_Length)
+	{
+		if (transport->rxCount >= transport->frameLength)
+		{
+			frameLen	=	transport->frameLength;
+			consumed	=	frameLen;
+		}
+	}
+	else
+	{
+		for (iii=0; iii<transport->rxCount; iii++)
+		{
+			if (transport->rxBuff[iii] == (unsigned char)transport->terminator)
+			{
+				frameLen	=	iii;
+				consumed	=	iii + 1;
+				break;
+			}
+		}
+	}
+
+	if (frameLen >= 0)
+	{
+		copyLen	=	frameLen;
+		if (copyLen > (frameBuffLen - 1))
+		{
+			//*	the rest of the frame is thrown away, the caller has to know
+			copyLen					=	frameBuffLen - 1;
+			transport->lastStatus	=	kSerialStatus_Overflow;
+			transport->overflowCnt++;
+		}
+		memcpy(frameBuff, transport->rxBuff, copyLen);
+		frameBuff[copyLen]	=	0;
+		transport->rxCount	-=	consumed;
+		if (transport->rxCount > 0)
+		{
+			memmove(transport->rxBuff, (transport->rxBuff + consumed), transport->rxCount);
+		}
+		transport->framesRcvd++;
+		frameLen	=	copyLen;
+	}
+	return(frameLen);
+}
+
+//*****************************************************************************
+//*	read whatever is available without blocking
+//*	returns the number of bytes added to the buffer, -1 on error
+//*****************************************************************************
+static int	FillBuffer(TYPE_SerialTransport *transport)
+{
+int		bytesRead;
+int		totalRead;
+
+	totalRead	=	0;
+	while (transport->rxCount < kSerialRxBuffSize)
+	{
+		bytesRead	=	read(	transport->fileDesc,
+								(transport->rxBuff + transport->rxCount),
+								(kSerialRxBuffSize - transport->rxCount));
+		transport->readCalls++;
+		if (bytesRead > 0)
+		{
+			transport->rxCount		+=	bytesRead;
+			transport->bytesRead	+=	bytesRead;
+			totalRead				+=	bytesRead;
+		}
+		else if ((bytesRead < 0) && (errno != EAGAIN) && (errno != EINTR))
+		{
+			return(-1);
+		}
+		else
+		{
+			break;
+		}
+	}
+	return(totalRead);
+}
+
+//*****************************************************************************
+//*	returns the frame length (>= 0) or -1 if no complete frame arrived in time
+//*	timeout_ms = 0 checks what is already there without waiting
+//*****************************************************************************
+int	SerialTransport_ReadFrame(	TYPE_SerialTransport	*transport,
+								char					*frameBuff,
+								const int				frameBuffLen,
+								const int				timeout_ms)
+{
+int		frameLen;
+int64_t	deadline_us;
+int		remaining_ms;
+
+	deadline_us				=	SerialTransport_GetTime_us() + ((int64_t)timeout_ms * 1000);
+	transport->lastStatus	=	kSerialStatus_OK;
+	frameLen				=	ExtractFrame(transport, frameBuff, frameBuffLen);
+	while (frameLen < 0)
+	{
+		if (FillBuffer(transport) < 0)
+		{
+			CONSOLE_DEBUG_W_STR("read failed:", strerror(errno));
+			transport->lastStatus	=	kSerialStatus_Error;
+			break;
+		}
+		frameLen	=	ExtractFrame(transport, frameBuff, frameBuffLen);
+		if (frameLen >= 0)
+		{
+			break;
+		}
+		if (transport->rxCount >= kSerialRxBuffSize)
+		{
+			//*	no terminator in a full buffer, the stream is garbage, start over
+			CONSOLE_DEBUG("Receive buffer overflow, discarding");
+			transport->rxCount		=	0;
+			transport->lastStatus	=	kSerialStatus_Overflow;
+			transport->overflowCnt++;
+		}
+		remaining_ms	=	(int)((deadline_us - SerialTransport_GetTime_us() + 999) / 1000);
+		if ((remaining_ms <= 0) || (WaitForEvent(transport, EPOLLIN, remaining_ms) <= 0))
+		{
+			//*	one last look, data may have arrived right at the deadline
+			FillBuffer(transport);
+			frameLen	=	ExtractFrame(transport, frameBuff, frameBuffLen);
+			if (frameLen < 0)
+			{
+				if (transport->lastStatus == kSerialStatus_OK)
+				{
+					transport->lastStatus	=	kSerialStatus_Timeout;
+				}
+				if (timeout_ms > 0)
+				{
+					transport->timeoutCnt++;
+				}
+			}
+			break;
+		}
+	}
+	if (frameLen < 0)
+	{
+		frameBuff[0]	=	0;
+	}
+	return(frameLen);
+}
+
+//*****************************************************************************
+//*	send one command and wait for its response
+//*****************************************************************************
+int	SerialTransport_Transact(	TYPE_SerialTransport	*transport,
+								const char				*cmdData,
+								const int				cmdLen,
+								char					*response,
+								const int				responseMax,
+								const int				timeout_ms)
+{
+int		responseLen;
+
+	responseLen	=	-1;
+	if (SerialTransport_Write(transport, cmdData, cmdLen, timeout_ms) == cmdLen)
+	{
+		responseLen	=	SerialTransport_ReadFrame(transport, response, responseMax, timeout_ms);
+	}
+	return(responseLen);
+}
+
+//*****************************************************************************
+//*	send all the commands in one write, then collect the responses in order
+//*	the device sees the commands back to back, which saves one round trip per command
+//*	returns the number of requests that completed with kSerialStatus_OK
+//*
+//*	the caller must only batch commands the device processes in order,
+//*	if a response times out the remaining ones may be out of sync,
+//*	they are marked as errors and the receive buffer is flushed
+//*****************************************************************************
+int	SerialTransport_TransactBatch(	TYPE_SerialTransport	*transport,
+									TYPE_SerialRequest		*requests,
+									const int				requestCnt)
+{
+char	xmitBuff[kSerialRxBuffSize];
+int		xmitLen;
+int		okCnt;
+int		iii;
+int64_t	sendTime_us;
+int		remaining_ms;
+bool	inSync;
+
+	okCnt	=	0;
+	xmitLen	=	0;
+	for (iii=0; iii<requestCnt; iii++)
+	{
+		requests[iii].status		=	kSerialStatus_Error;
+		requests[iii].responseLen	=	-1;
+		if ((xmitLen + requests[iii].cmdLen) > (int)sizeof(xmitBuff))
+		{
+			CONSOLE_DEBUG("Batch too large");
+			return(0);
+		}
+		memcpy((xmitBuff + xmitLen), requests[iii].cmdData, requests[iii].cmdLen);
+		xmitLen	+=	requests[iii].cmdLen;
+	}
+
+	sendTime_us	=	SerialTransport_GetTime_us();
+	if (SerialTransport_Write(transport, xmitBuff, xmitLen, 1000) != xmitLen)
+	{
+		return(0);
+	}
+
+	inSync	=	true;
+	for (iii=0; iii<requestCnt; iii++)
+	{
+		if (requests[iii].expectResponse == false)
+		{
+			requests[iii].status	=	kSerialStatus_OK;
+			okCnt++;
+		}
+		else if (inSync)
+		{
+			remaining_ms	=	requests[iii].timeout_ms -
+								(int)((SerialTransport_GetTime_us() - sendTime_us) / 1000);
+			if (remaining_ms < 0)
+			{
+				remaining_ms	=	0;
+			}
+			requests[iii].responseLen	=	SerialTransport_ReadFrame(	transport,
+																		requests[iii].response,
+																		requests[iii].responseMax,
+																		remaining_ms);
+			requests[iii].status	=	transport->lastStatus;
+			if (requests[iii].status == kSerialStatus_OK)
+			{
+				okCnt++;
+			}
+			else if (requests[iii].responseLen < 0)
+			{
+				//*	nothing usable came back, the responses after this one can not be matched
+				inSync					=	false;
+			}
+		}
+	}
+	if (inSync == false)
+	{
+		SerialTransport_Flush(transport);
+	}
+	return(okCnt);
+}
+
+#ifdef _INCLUDE_SERIAL_TRANSPORT_MAIN_
+//*****************************************************************************
+//*	test against a device emulator on a pseudo terminal
+//*
+//*	gcc -O2 -D_INCLUDE_SERIAL_TRANSPORT_MAIN_ -I../libs/src_mlsLib serial_transport.c -lutil -lpthread -o serial_transport
+//*
+//*	the emulator answers MoonLite style commands terminated with '#'
+//*		:PING#		PONG#
+//*		:SLOW#		LATE# after 300 ms
+//*		:BIG#		200 bytes then #
+//*		:NONE#		no response
+//*		:FIX#		ABCD (no terminator, fixed length framing)
+//*****************************************************************************
+#include	<pthread.h>
+#include	<poll.h>
+#include	<pty.h>
+
+static int				gDeviceFD	=	-1;
+static volatile bool	gDeviceRun	=	true;
+
+//*****************************************************************************
+static void	DeviceReply(const char *replyData, const int replyLen)
+{
+	if (write(gDeviceFD, replyData, replyLen) != replyLen)
+	{
+		CONSOLE_DEBUG("device write failed");
+	}
+}
+
+//*****************************************************************************
+static void	*DeviceEmulator(void *arg)
+{
+char			cmdBuff[64];
+char			bigReply[256];
+int				cmdLen;
+char			theChar;
+struct pollfd	pollFd;
+
+	(void)arg;
+	cmdLen	=	0;
+	memset(bigReply, 'x', 200);
+	bigReply[200]	=	'#';
+	while (gDeviceRun)
+	{
+		pollFd.fd		=	gDeviceFD;
+		pollFd.events	=	POLLIN;
+		if ((poll(&pollFd, 1, 50) <= 0) || (read(gDeviceFD, &theChar, 1) != 1))
+		{
+			continue;
+		}
+		if (theChar == ':')
+		{
+			cmdLen	=	0;
+		}
+		else if ((theChar == '#') && (cmdLen < (int)sizeof(cmdBuff)))
+		{
+			cmdBuff[cmdLen]	=	0;
+			if (strcmp(cmdBuff, "PING") == 0)
+			{
+				DeviceReply("PONG#", 5);
+			}
+			else if (strcmp(cmdBuff, "SLOW") == 0)
+			{
+				usleep(300 * 1000);
+				DeviceReply("LATE#", 5);
+			}
+			else if (strcmp(cmdBuff, "BIG") == 0)
+			{
+				DeviceReply(bigReply, 201);
+			}
+			else if (strcmp(cmdBuff, "FIX") == 0)
+			{
+				DeviceReply("ABCD", 4);
+			}
+			cmdLen	=	0;
+		}
+		else if (cmdLen < ((int)sizeof(cmdBuff) - 1))
+		{
+			cmdBuff[cmdLen++]	=	theChar;
+		}
+	}
+	return(NULL);
+}
+
+//*****************************************************************************
+int	main(void)
+{
+TYPE_SerialTransport	transport;
+TYPE_SerialRequest		requests[4];
+char					responses[4][32];
+char					response[32];
+struct termios			ttySettings;
+pthread_t				deviceThread;
+int						hostFD;
+int						responseLen;
+int						okCnt;
+int64_t					startTime_us;
+int64_t					elapsed_ms;
+int						failCnt;
+int						iii;
+const char				*batchCmds[4]	=	{":PING#", ":NONE#", ":PING#", ":SLOW#"};
+const bool				batchExpect[4]	=	{true, false, true, true};
+
+	failCnt	=	0;
+	if (openpty(&hostFD, &gDeviceFD, NULL, NULL, NULL) != 0)
+	{
+		printf("FAIL: openpty\r\n");
+		return(1);
+	}
+	tcgetattr(hostFD, &ttySettings);
+	cfmakeraw(&ttySettings);
+	tcsetattr(hostFD, TCSANOW, &ttySettings);
+	tcgetattr(gDeviceFD, &ttySettings);
+	cfmakeraw(&ttySettings);
+	tcsetattr(gDeviceFD, TCSANOW, &ttySettings);
+	pthread_create(&deviceThread, NULL, DeviceEmulator, NULL);
+
+	SerialTransport_Init(&transport, hostFD);
+	SerialTransport_SetTerminator(&transport, '#');
+
+	//*	single transaction
+	responseLen	=	SerialTransport_Transact(&transport, ":PING#", 6, response, sizeof(response), 500);
+	if ((responseLen != 4) || (strcmp(response, "PONG") != 0) || (transport.lastStatus != kSerialStatus_OK))
+	{
+		printf("FAIL: transact, len=%d response=%s\r\n", responseLen, response);
+		failCnt++;
+	}
+
+	//*	no response, must return at the deadline, not before and not much after
+	startTime_us	=	SerialTransport_GetTime_us();
+	responseLen		=	SerialTransport_Transact(&transport, ":NONE#", 6, response, sizeof(response), 200);
+	elapsed_ms		=	(SerialTransport_GetTime_us() - startTime_us) / 1000;
+	if ((responseLen >= 0) || (transport.lastStatus != kSerialStatus_Timeout) || (elapsed_ms < 190) || (elapsed_ms > 400))
+	{
+		printf("FAIL: timeout, len=%d elapsed=%d ms\r\n", responseLen, (int)elapsed_ms);
+		failCnt++;
+	}
+
+	//*	response larger than the buffer
+	responseLen	=	SerialTransport_Transact(&transport, ":BIG#", 5, response, sizeof(response), 500);
+	if ((responseLen != ((int)sizeof(response) - 1)) || (transport.lastStatus != kSerialStatus_Overflow))
+	{
+		printf("FAIL: overflow not reported, len=%d status=%d\r\n", responseLen, transport.lastStatus);
+		failCnt++;
+	}
+	//*	the stream is still in sync after the overflow
+	responseLen	=	SerialTransport_Transact(&transport, ":PING#", 6, response, sizeof(response), 500);
+	if ((responseLen != 4) || (strcmp(response, "PONG") != 0))
+	{
+		printf("FAIL: out of sync after overflow, response=%s\r\n", response);
+		failCnt++;
+	}
+
+	//*	pipelined batch, responses matched in order, each with its own deadline
+	memset(requests, 0, sizeof(requests));
+	for (iii=0; iii<4; iii++)
+	{
+		requests[iii].cmdData			=	batchCmds[iii];
+		requests[iii].cmdLen			=	strlen(batchCmds[iii]);
+		requests[iii].expectResponse	=	batchExpect[iii];
+		requests[iii].timeout_ms		=	500;
+		requests[iii].response			=	responses[iii];
+		requests[iii].responseMax		=	sizeof(responses[iii]);
+	}
+	okCnt	=	SerialTransport_TransactBatch(&transport, requests, 4);
+	if ((okCnt != 4) || (strcmp(responses[0], "PONG") != 0) ||
+		(strcmp(responses[2], "PONG") != 0) || (strcmp(responses[3], "LATE") != 0))
+	{
+		printf("FAIL: batch, ok=%d\r\n", okCnt);
+		failCnt++;
+	}
+	//*	a deadline shorter than the device takes, the batch is flushed
+	requests[3].timeout_ms	=	100;
+	okCnt	=	SerialTransport_TransactBatch(&transport, requests, 4);
+	if ((okCnt != 3) || (requests[3].status != kSerialStatus_Timeout))
+	{
+		printf("FAIL: batch deadline, ok=%d status=%d\r\n", okCnt, requests[3].status);
+		failCnt++;
+	}
+	usleep(400 * 1000);
+	SerialTransport_Flush(&transport);
+
+	//*	fixed length framing
+	SerialTransport_SetFrameLength(&transport, 4);
+	responseLen	=	SerialTransport_Transact(&transport, ":FIX#", 5, response, sizeof(response), 500);
+	if ((responseLen != 4) || (strcmp(response, "ABCD") != 0))
+	{
+		printf("FAIL: fixed length, len=%d response=%s\r\n", responseLen, response);
+		failCnt++;
+	}
+
+	printf("frames=%u timeouts=%u overflows=%u read calls=%u bytes=%u\r\n",
+			transport.framesRcvd, transport.timeoutCnt, transport.overflowCnt,
+			transport.readCalls, transport.bytesRead);
+
+	gDeviceRun	=	false;
+	pthread_join(deviceThread, NULL);
+	SerialTransport_Close(&transport);
+	close(hostFD);
+	close(gDeviceFD);
+	printf("Failures = %d\r\n", failCnt);
+	return(failCnt);
+}
+#endif // _INCLUDE_SERIAL_TRANSPORT_MAIN_
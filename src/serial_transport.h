@@ -0,0 +1,102 @@
+//*****************************************************************************
+//#include	"serial_transport.h"
+
+#ifndef _SERIAL_TRANSPORT_H_
+#define	_SERIAL_TRANSPORT_H_
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+#include	<stddef.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define	kSerialRxBuffSize		1024
+#define	kSerialMaxBatchCnt		16
+
+//*****************************************************************************
+enum
+{
+	kSerialFrame_Terminator	=	0,		//*	frame ends with a specific character, i.e. '#' or '\n'
+	kSerialFrame_Length					//*	frame is a fixed number of bytes
+};
+
+//*****************************************************************************
+enum
+{
+	kSerialStatus_OK		=	0,
+	kSerialStatus_Timeout,
+	kSerialStatus_Error,
+	kSerialStatus_Overflow
+};
+
+//*****************************************************************************
+typedef struct	//	TYPE_SerialTransport
+{
+	int				fileDesc;			//*	owned by the caller, not closed by SerialTransport_Close()
+	int				epollFD;
+	int				framingMode;
+	char			terminator;
+	int				frameLength;
+	unsigned char	rxBuff[kSerialRxBuffSize];
+	int				rxCount;			//*	bytes in rxBuff not yet returned as a frame
+	int				lastStatus;			//*	kSerialStatus_xxx of the last SerialTransport_ReadFrame()
+
+	//*	statistics
+	uint32_t		framesRcvd;
+	uint32_t		timeoutCnt;
+	uint32_t		overflowCnt;		//*	frames truncated or discarded for lack of space
+	uint32_t		readCalls;
+	uint32_t		bytesRead;
+} TYPE_SerialTransport;
+
+//*****************************************************************************
+//*	one command of a pipelined batch, responses are matched to commands in order
+typedef struct	//	TYPE_SerialRequest
+{
+	const char		*cmdData;
+	int				cmdLen;
+	bool			expectResponse;
+	int				timeout_ms;			//*	deadline for this response, from the time the batch was sent
+	char			*response;
+	int				responseMax;
+	int				responseLen;
+	int				status;				//*	kSerialStatus_xxx
+} TYPE_SerialRequest;
+
+
+bool	SerialTransport_Init(			TYPE_SerialTransport *transport, const int fileDesc);
+void	SerialTransport_Close(			TYPE_SerialTransport *transport);
+void	SerialTransport_SetTerminator(	TYPE_SerialTransport *transport, const char terminator);
+void	SerialTransport_SetFrameLength(	TYPE_SerialTransport *transport, const int frameLength);
+bool	SerialTransport_Flush(			TYPE_SerialTransport *transport);
+int		SerialTransport_Write(			TYPE_SerialTransport	*transport,
+										const void				*xmitData,
+										const int				xmitLen,
+										const int				timeout_ms);
+int		SerialTransport_ReadFrame(		TYPE_SerialTransport	*transport,
+										char					*frameBuff,
+										const int				frameBuffLen,
+										const int				timeout_ms);
+int		SerialTransport_Transact(		TYPE_SerialTransport	*transport,
+										const char				*cmdData,
+										const int				cmdLen,
+										char					*response,
+										const int				responseMax,
+										const int				timeout_ms);
+int		SerialTransport_TransactBatch(	TYPE_SerialTransport	*transport,
+										TYPE_SerialRequest		*requests,
+										const int				requestCnt);
+int64_t	SerialTransport_GetTime_us(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SERIAL_TRANSPORT_H_
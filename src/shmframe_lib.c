@@ -0,0 +1,611 @@
+//*****************************************************************************
+//*	Name:			shmframe_lib.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Shared memory frame ring
+//*
+//*	The camera driver copies each frame into a ring of slots in /dev/shm.
+//*	Local tools (plate solvers, guiders, rgbmerge, fitsview) map the ring read only
+//*	and get the latest frame without going through http or a saved file.
+//*
+//*	Writer:		ShmFrame_CreateRing()	ShmFrame_Publish()
+//*	Reader:		ShmFrame_OpenReader()	ShmFrame_WaitForFrame()	ShmFrame_GetLatest()
+//*
+//*	A slot's sequence number is 0 while it is being written.
+//*	The ring has kShmFrameSlotCnt slots, a reader holding a pointer into a slot should
+//*	call ShmFrame_StillValid() when it is done to make sure the writer did not wrap
+//*	around and over write the frame while it was being used.
+//*	Readers sleep on a futex in the shared header, the writer wakes them on each frame.
+//*	When the writer re-creates the ring (bigger frames, driver restart), the old file
+//*	is unlinked and a new one is created, a reader still has the old one mapped.
+//*	ShmFrame_IsStale() tells the reader to close and open the ring again.
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Re-distributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 18,	2026	<MLS> Created shmframe_lib.c
+//*	Oct 18,	2026	<MLS> Added generation, ShmFrame_IsStale()
+//*	Oct 18,	2026	<MLS> Added reader and self test (_INCLUDE_SHMFRAME_MAIN_)
+//*****************************************************************************
+
+#include	<errno.h>
+#include	<fcntl.h>
+#include	<limits.h>
+#include	<stdbool.h>
+#include	<stdint.h>
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	<time.h>
+#include	<unistd.h>
+#include	<sys/mman.h>
+#include	<sys/stat.h>
+#include	<sys/syscall.h>
+#include	<sys/types.h>
+#include	<linux/futex.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"shmframe_lib.h"
+
+//*	number of times GetLatest will retry if the writer is in the middle of the slot
+#define	kShmFrameReadRetries	10
+
+//*****************************************************************************
+int64_t	ShmFrame_GetTime_us(void)
+{
+struct timespec	timeNow;
+
+	clock_gettime(CLOCK_REALTIME, &timeNow);
+	return((timeNow.tv_sec * 1000000LL) + (timeNow.tv_nsec / 1000));
+}
+
+//*****************************************************************************
+static size_t	RoundUpToPage(size_t theSize)
+{
+size_t	pageSize;
+
+	pageSize	=	sysconf(_SC_PAGESIZE);
+	return(((theSize + pageSize - 1) / pageSize) * pageSize);
+}
+
+//*****************************************************************************
+//*	slotSize is the maximum number of bytes of a frame
+//*****************************************************************************
+TYPE_ShmFrameRing	*ShmFrame_CreateRing(const int cameraNum, const uint32_t slotSize)
+{
+TYPE_ShmFrameRing	*ring;
+size_t				headerSize;
+size_t				slotSizeAligned;
+int					iii;
+
+	ring	=	(TYPE_ShmFrameRing *)calloc(1, sizeof(TYPE_ShmFrameRing));
+	if (ring != NULL)
+	{
+		ring->isWriter	=	true;
+		sprintf(ring->path, kShmFrameNameFmt, cameraNum);
+		headerSize		=	RoundUpToPage(sizeof(TYPE_ShmFrameHeader));
+		slotSizeAligned	=	RoundUpToPage(slotSize);
+		ring->mapSize	=	headerSize + (kShmFrameSlotCnt * slotSizeAligned);
+
+		//*	/dev/shm is a tmpfs, this is the same as shm_open() without needing -lrt
+		//*	always a new file, a reader that still has the old one mapped must not
+		//*	see it change size underneath it
+		unlink(ring->path);
+		ring->fileDesc	=	open(ring->path, (O_CREAT | O_RDWR | O_EXCL), 0644);
+		if ((ring->fileDesc >= 0) && (ftruncate(ring->fileDesc, ring->mapSize) == 0))
+		{
+			ring->mapPtr	=	(unsigned char *)mmap(NULL, ring->mapSize, (PROT_READ | PROT_WRITE), MAP_SHARED, ring->fileDesc, 0);
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_STR("Failed to create", ring->path);
+			ring->mapPtr	=	(unsigned char *)MAP_FAILED;
+		}
+
+		if (ring->mapPtr != MAP_FAILED)
+		{
+			ring->header			=	(TYPE_ShmFrameHeader *)ring->mapPtr;
+			ring->header->version	=	kShmFrameVersion;
+			ring->header->slotCnt	=	kShmFrameSlotCnt;
+			ring->header->slotSize	=	slotSizeAligned;
+			ring->header->writerPid	=	getpid();
+			ring->generation		=	ShmFrame_GetTime_us();
+			ring->header->generation	=	ring->generation;
+			for (iii=0; iii<kShmFrameSlotCnt; iii++)
+			{
+				ring->header->slot[iii].dataOffset	=	headerSize + (iii * slotSizeAligned);
+			}
+			//*	the magic number goes in last, readers check it
+			__atomic_store_n(&ring->header->magic, kShmFrameMagic, __ATOMIC_RELEASE);
+			CONSOLE_DEBUG_W_STR("Shared memory frame ring created:", ring->path);
+			CONSOLE_DEBUG_W_LONG("Shared memory size\t=", (long)ring->mapSize);
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_NUM("mmap failed, errno\t=", errno);
+			if (ring->fileDesc >= 0)
+			{
+				close(ring->fileDesc);
+				unlink(ring->path);
+			}
+			free(ring);
+			ring	=	NULL;
+		}
+	}
+	return(ring);
+}
+
+//*****************************************************************************
+//*	frameInfo supplies the geometry and times, sequence and offset are filled in here
+//*****************************************************************************
+bool	ShmFrame_Publish(	TYPE_ShmFrameRing		*ring,
+							const unsigned char		*frameData,
+							const TYPE_ShmFrameSlot	*frameInfo)
+{
+TYPE_ShmFrameSlot	*slotPtr;
+TYPE_ShmFrameSlot	newSlot;
+uint64_t			newSeq;
+uint32_t			dataOffset;
+bool				successFlag;
+
+	successFlag	=	false;
+	if ((ring != NULL) && ring->isWriter && (frameInfo->dataLen <= ring->header->slotSize))
+	{
+		newSeq		=	ring->header->latestSeq + 1;
+		slotPtr		=	&ring->header->slot[newSeq % kShmFrameSlotCnt];
+		dataOffset	=	slotPtr->dataOffset;
+
+		//*	mark the slot as being written
+		__atomic_store_n(&slotPtr->sequence, 0, __ATOMIC_RELEASE);
+		__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+		memcpy((ring->mapPtr + dataOffset), frameData, frameInfo->dataLen);
+		newSlot					=	*frameInfo;
+		newSlot.sequence		=	0;
+		newSlot.dataOffset		=	dataOffset;
+		newSlot.published_us	=	ShmFrame_GetTime_us();
+		*slotPtr				=	newSlot;
+
+		//*	now make it visible
+		__atomic_store_n(&slotPtr->sequence,			newSeq, __ATOMIC_RELEASE);
+		__atomic_store_n(&ring->header->latestSeq,	newSeq, __ATOMIC_RELEASE);
+		__atomic_add_fetch(&ring->header->futexWord,	1,		__ATOMIC_RELEASE);
+		syscall(SYS_futex, &ring->header->futexWord, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+		successFlag	=	true;
+	}
+	return(successFlag);
+}
+
+//*****************************************************************************
+TYPE_ShmFrameRing	*ShmFrame_OpenReader(const int cameraNum)
+{
+TYPE_ShmFrameRing	*ring;
+struct stat			fileStatus;
+
+	ring	=	(TYPE_ShmFrameRing *)calloc(1, sizeof(TYPE_ShmFrameRing));
+	if (ring != NULL)
+	{
+		ring->isWriter	=	false;
+		ring->mapPtr	=	(unsigned char *)MAP_FAILED;
+		sprintf(ring->path, kShmFrameNameFmt, cameraNum);
+		ring->fileDesc	=	open(ring->path, O_RDONLY);
+		if ((ring->fileDesc >= 0) && (fstat(ring->fileDesc, &fileStatus) == 0) &&
+			(fileStatus.st_size >= (off_t)sizeof(TYPE_ShmFrameHeader)))
+		{
+			ring->mapSize	=	fileStatus.st_size;
+			ring->inode		=	fileStatus.st_ino;
+			ring->mapPtr	=	(unsigned char *)mmap(NULL, ring->mapSize, PROT_READ, MAP_SHARED, ring->fileDesc, 0);
+		}
+		if (ring->mapPtr != MAP_FAILED)
+		{
+			ring->header		=	(TYPE_ShmFrameHeader *)ring->mapPtr;
+			ring->generation	=	__atomic_load_n(&ring->header->generation, __ATOMIC_ACQUIRE);
+			if ((__atomic_load_n(&ring->header->magic, __ATOMIC_ACQUIRE) != kShmFrameMagic) ||
+				(ring->header->version != kShmFrameVersion) ||
+				(ring->generation == 0))
+			{
+				CONSOLE_DEBUG_W_STR("Not a valid frame ring:", ring->path);
+				ShmFrame_Close(ring);
+				ring	=	NULL;
+			}
+		}
+		else
+		{
+			if (ring->fileDesc >= 0)
+			{
+				close(ring->fileDesc);
+			}
+			free(ring);
+			ring	=	NULL;
+		}
+	}
+	return(ring);
+}
+
+//*****************************************************************************
+//*	returns true when a frame newer than lastSeq is available
+//*****************************************************************************
+bool	ShmFrame_WaitForFrame(TYPE_ShmFrameRing *ring, const uint64_t lastSeq, const int timeout_ms)
+{
+struct timespec	timeOut;
+uint32_t		futexValue;
+int64_t			endTime_us;
+int64_t			remaining_us;
+bool			newFrame;
+
+	newFrame	=	false;
+	if (ring != NULL)
+	{
+		endTime_us	=	ShmFrame_GetTime_us() + (timeout_ms * 1000LL);
+		while (newFrame == false)
+		{
+			futexValue	=	__atomic_load_n(&ring->header->futexWord, __ATOMIC_ACQUIRE);
+			if (__atomic_load_n(&ring->header->generation, __ATOMIC_ACQUIRE) != ring->generation)
+			{
+				break;		//*	the writer closed this ring, the caller should re-open
+			}
+			else if (__atomic_load_n(&ring->header->latestSeq, __ATOMIC_ACQUIRE) > lastSeq)
+			{
+				newFrame	=	true;
+			}
+			else
+			{
+				remaining_us	=	endTime_us - ShmFrame_GetTime_us();
+				if (remaining_us <= 0)
+				{
+					break;
+				}
+				timeOut.tv_sec	=	remaining_us / 1000000;
+				timeOut.tv_nsec	=	(remaining_us % 1000000) * 1000;
+				//*	sleeps until the writer changes futexWord
+				syscall(SYS_futex, &ring->header->futexWord, FUTEX_WAIT, futexValue, &timeOut, NULL, 0);
+			}
+		}
+	}
+	return(newFrame);
+}
+
+//*****************************************************************************
+//*	no copy of the pixel data, frameInfo->dataPtr points into the ring
+//*****************************************************************************
+bool	ShmFrame_GetLatest(TYPE_ShmFrameRing *ring, TYPE_ShmFrameInfo *frameInfo)
+{
+TYPE_ShmFrameSlot	*slotPtr;
+uint64_t			latestSeq;
+int					retryCnt;
+bool				validFlag;
+
+	validFlag	=	false;
+	retryCnt	=	0;
+	while ((ring != NULL) && (validFlag == false) && (retryCnt < kShmFrameReadRetries))
+	{
+		latestSeq	=	__atomic_load_n(&ring->header->latestSeq, __ATOMIC_ACQUIRE);
+		if (latestSeq == 0)
+		{
+			break;		//*	nothing published yet
+		}
+		if (__atomic_load_n(&ring->header->generation, __ATOMIC_ACQUIRE) != ring->generation)
+		{
+			break;		//*	stale mapping
+		}
+		frameInfo->slotIdx	=	latestSeq % kShmFrameSlotCnt;
+		slotPtr				=	&ring->header->slot[frameInfo->slotIdx];
+		frameInfo->slotInfo	=	*slotPtr;
+		__atomic_thread_fence(__ATOMIC_ACQUIRE);
+		if ((frameInfo->slotInfo.sequence == latestSeq) &&
+			(__atomic_load_n(&slotPtr->sequence, __ATOMIC_ACQUIRE) == latestSeq) &&
+			((frameInfo->slotInfo.dataOffset + frameInfo->slotInfo.dataLen) <= ring->mapSize))
+		{
+			frameInfo->dataPtr		=	ring->mapPtr + frameInfo->slotInfo.dataOffset;
+			frameInfo->latency_us	=	ShmFrame_GetTime_us() - frameInfo->slotInfo.published_us;
+			validFlag				=	true;
+		}
+		retryCnt++;
+	}
+	return(validFlag);
+}
+
+//*****************************************************************************
+//*	returns false if the writer has re-used the slot since ShmFrame_GetLatest()
+//*****************************************************************************
+bool	ShmFrame_StillValid(TYPE_ShmFrameRing *ring, const TYPE_ShmFrameInfo *frameInfo)
+{
+uint64_t	slotSeq;
+
+	__atomic_thread_fence(__ATOMIC_ACQUIRE);
+	slotSeq	=	__atomic_load_n(&ring->header->slot[frameInfo->slotIdx].sequence, __ATOMIC_ACQUIRE);
+	return(slotSeq == frameInfo->slotInfo.sequence);
+}
+
+//*****************************************************************************
+//*	returns true if the writer has closed or re-created the ring since it was opened,
+//*	the reader should ShmFrame_Close() it and ShmFrame_OpenReader() again
+//*****************************************************************************
+bool	ShmFrame_IsStale(TYPE_ShmFrameRing *ring)
+{
+struct stat	fileStatus;
+bool		staleFlag;
+
+	staleFlag	=	true;
+	if (ring != NULL)
+	{
+		staleFlag	=	false;
+		if (__atomic_load_n(&ring->header->generation, __ATOMIC_ACQUIRE) != ring->generation)
+		{
+			staleFlag	=	true;
+		}
+		//*	if the writer died without closing, the file name now belongs to a new ring
+		else if ((stat(ring->path, &fileStatus) != 0) || (fileStatus.st_ino != ring->inode))
+		{
+			staleFlag	=	true;
+		}
+	}
+	return(staleFlag);
+}
+
+//*****************************************************************************
+void	ShmFrame_Close(TYPE_ShmFrameRing *ring)
+{
+	if (ring != NULL)
+	{
+		if (ring->isWriter && (ring->mapPtr != MAP_FAILED))
+		{
+			//*	tell the readers this ring is done, and wake up any that are waiting
+			__atomic_store_n(&ring->header->generation,	0,	__ATOMIC_RELEASE);
+			__atomic_add_fetch(&ring->header->futexWord,	1,	__ATOMIC_RELEASE);
+			syscall(SYS_futex, &ring->header->futexWord, FUTEX_WAKE, INT_MAX, NULL, NULL, 0);
+		}
+		if (ring->mapPtr != MAP_FAILED)
+		{
+			munmap(ring->mapPtr, ring->mapSize);
+		}
+		if (ring->fileDesc >= 0)
+		{
+			close(ring->fileDesc);
+		}
+		if (ring->isWriter)
+		{
+			unlink(ring->path);
+		}
+		free(ring);
+	}
+}
+
+#ifdef _INCLUDE_SHMFRAME_MAIN_
+//*****************************************************************************
+//*	shmframe -t			self test, writer and reader in one process
+//*	shmframe <cam#>		reader, prints each frame the camera driver publishes
+//*
+//*	gcc -O2 -D_INCLUDE_SHMFRAME_MAIN_ -I../libs/src_mlsLib shmframe_lib.c -o shmframe
+//*****************************************************************************
+#define	kTestCamNum		99
+#define	kTestFrameSize	(640 * 480)
+
+//*****************************************************************************
+static void	FillTestFrame(unsigned char *frameData, const uint32_t frameSize, const int frameNum)
+{
+uint32_t	iii;
+
+	for (iii=0; iii<frameSize; iii++)
+	{
+		frameData[iii]	=	(iii + frameNum) & 0xff;
+	}
+}
+
+//*****************************************************************************
+static bool	CheckTestFrame(const TYPE_ShmFrameInfo *frameInfo, const int frameNum)
+{
+uint32_t	iii;
+bool		frameOK;
+
+	frameOK	=	(frameInfo->slotInfo.dataLen == kTestFrameSize) && (frameInfo->slotInfo.exposure_us == frameNum);
+	for (iii=0; frameOK && (iii<frameInfo->slotInfo.dataLen); iii++)
+	{
+		if (frameInfo->dataPtr[iii] != ((iii + frameNum) & 0xff))
+		{
+			frameOK	=	false;
+		}
+	}
+	return(frameOK);
+}
+
+//*****************************************************************************
+static int	ShmFrame_SelfTest(void)
+{
+TYPE_ShmFrameRing	*writer;
+TYPE_ShmFrameRing	*reader;
+TYPE_ShmFrameSlot	slotInfo;
+TYPE_ShmFrameInfo	frameInfo;
+TYPE_ShmFrameInfo	oldFrameInfo;
+unsigned char		*frameData;
+int64_t				startTime_us;
+int					frameNum;
+int					failCnt;
+
+	failCnt		=	0;
+	frameData	=	(unsigned char *)malloc(kTestFrameSize);
+	writer		=	ShmFrame_CreateRing(kTestCamNum, kTestFrameSize);
+	reader		=	ShmFrame_OpenReader(kTestCamNum);
+	if ((frameData == NULL) || (writer == NULL) || (reader == NULL))
+	{
+		printf("FAIL: could not create the ring\r\n");
+		return(1);
+	}
+	memset(&slotInfo, 0, sizeof(TYPE_ShmFrameSlot));
+	slotInfo.width			=	640;
+	slotInfo.height			=	480;
+	slotInfo.bytesPerPixel	=	1;
+	slotInfo.dataLen		=	kTestFrameSize;
+
+	//*	nothing published yet
+	if (ShmFrame_GetLatest(reader, &frameInfo))
+	{
+		printf("FAIL: frame from an empty ring\r\n");
+		failCnt++;
+	}
+	//*	every frame comes through intact
+	for (frameNum=1; frameNum<=5; frameNum++)
+	{
+		FillTestFrame(frameData, kTestFrameSize, frameNum);
+		slotInfo.exposure_us	=	frameNum;
+		ShmFrame_Publish(writer, frameData, &slotInfo);
+		if ((ShmFrame_WaitForFrame(reader, frameNum - 1, 100) == false) ||
+			(ShmFrame_GetLatest(reader, &frameInfo) == false) ||
+			(frameInfo.slotInfo.sequence != (uint64_t)frameNum) ||
+			(CheckTestFrame(&frameInfo, frameNum) == false))
+		{
+			printf("FAIL: frame %d\r\n", frameNum);
+			failCnt++;
+		}
+	}
+	//*	a reader that holds a frame too long finds out
+	oldFrameInfo	=	frameInfo;
+	for (frameNum=6; frameNum<=(5 + kShmFrameSlotCnt); frameNum++)
+	{
+		FillTestFrame(frameData, kTestFrameSize, frameNum);
+		slotInfo.exposure_us	=	frameNum;
+		ShmFrame_Publish(writer, frameData, &slotInfo);
+	}
+	if (ShmFrame_StillValid(reader, &oldFrameInfo))
+	{
+		printf("FAIL: over written slot reported as still valid\r\n");
+		failCnt++;
+	}
+	if (ShmFrame_IsStale(reader))
+	{
+		printf("FAIL: ring reported stale while the writer is running\r\n");
+		failCnt++;
+	}
+
+	//*	the writer re-creates the ring, the waiting reader must not sleep out the timeout
+	ShmFrame_Close(writer);
+	writer			=	ShmFrame_CreateRing(kTestCamNum, (2 * kTestFrameSize));
+	startTime_us	=	ShmFrame_GetTime_us();
+	if (ShmFrame_WaitForFrame(reader, frameInfo.slotInfo.sequence + 100, 2000))
+	{
+		printf("FAIL: new frame from a closed ring\r\n");
+		failCnt++;
+	}
+	if ((ShmFrame_GetTime_us() - startTime_us) > 1000000)
+	{
+		printf("FAIL: reader was not woken when the ring was closed\r\n");
+		failCnt++;
+	}
+	if ((ShmFrame_IsStale(reader) == false) || ShmFrame_GetLatest(reader, &frameInfo))
+	{
+		printf("FAIL: stale mapping not detected\r\n");
+		failCnt++;
+	}
+	//*	re-open and carry on with the new ring
+	ShmFrame_Close(reader);
+	reader	=	ShmFrame_OpenReader(kTestCamNum);
+	FillTestFrame(frameData, kTestFrameSize, 42);
+	slotInfo.exposure_us	=	42;
+	ShmFrame_Publish(writer, frameData, &slotInfo);
+	if ((reader == NULL) || ShmFrame_IsStale(reader) ||
+		(ShmFrame_GetLatest(reader, &frameInfo) == false) ||
+		(CheckTestFrame(&frameInfo, 42) == false))
+	{
+		printf("FAIL: re-opened reader\r\n");
+		failCnt++;
+	}
+
+	//*	a writer that died without closing, the new file has a different inode
+	if (reader != NULL)
+	{
+		munmap(writer->mapPtr, writer->mapSize);
+		close(writer->fileDesc);
+		free(writer);
+		writer	=	ShmFrame_CreateRing(kTestCamNum, kTestFrameSize);
+		if (ShmFrame_IsStale(reader) == false)
+		{
+			printf("FAIL: ring from a crashed writer not detected\r\n");
+			failCnt++;
+		}
+	}
+	ShmFrame_Close(reader);
+	ShmFrame_Close(writer);
+	free(frameData);
+	printf("Failures = %d\r\n", failCnt);
+	return(failCnt);
+}
+
+//*****************************************************************************
+static void	ShmFrame_Reader(const int cameraNum)
+{
+TYPE_ShmFrameRing	*reader;
+TYPE_ShmFrameInfo	frameInfo;
+uint64_t			lastSeq;
+
+	reader	=	NULL;
+	lastSeq	=	0;
+	while (1)
+	{
+		if ((reader != NULL) && ShmFrame_IsStale(reader))
+		{
+			printf("Ring was re-created, re-opening\r\n");
+			ShmFrame_Close(reader);
+			reader	=	NULL;
+			lastSeq	=	0;
+		}
+		if (reader == NULL)
+		{
+			reader	=	ShmFrame_OpenReader(cameraNum);
+			if (reader == NULL)
+			{
+				sleep(1);
+				continue;
+			}
+			printf("Opened %s, %d slots of %d bytes\r\n", reader->path, reader->header->slotCnt, reader->header->slotSize);
+		}
+		if (ShmFrame_WaitForFrame(reader, lastSeq, 5000) && ShmFrame_GetLatest(reader, &frameInfo))
+		{
+			printf("Frame %6lld %4dx%-4d bpp=%d exp=%8d us latency=%6lld us\r\n",
+							(long long)frameInfo.slotInfo.sequence,
+							frameInfo.slotInfo.width,
+							frameInfo.slotInfo.height,
+							frameInfo.slotInfo.bytesPerPixel,
+							frameInfo.slotInfo.exposure_us,
+							(long long)frameInfo.latency_us);
+			lastSeq	=	frameInfo.slotInfo.sequence;
+		}
+	}
+}
+
+//*****************************************************************************
+int main(int argc, char *argv[])
+{
+int	returnCode;
+
+	returnCode	=	0;
+	if ((argc > 1) && (strcmp(argv[1], "-t") == 0))
+	{
+		returnCode	=	ShmFrame_SelfTest();
+	}
+	else if (argc > 1)
+	{
+		ShmFrame_Reader(atoi(argv[1]));
+	}
+	else
+	{
+		printf("usage: shmframe -t | <camera number>\r\n");
+	}
+	return(returnCode);
+}
+#endif // _INCLUDE_SHMFRAME_MAIN_
@@ -0,0 +1,114 @@
+//*****************************************************************************
+//#include	"shmframe_lib.h"
+
+#ifndef _SHMFRAME_LIB_H_
+#define	_SHMFRAME_LIB_H_
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+#ifndef _SYS_TYPES_H
+	#include	<sys/types.h>
+#endif
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+//*****************************************************************************
+//*	Shared memory frame ring
+//*		/dev/shm/alpacapi-cam<N>
+//*
+//*		+-----------------------+
+//*		| TYPE_ShmFrameHeader	|	ring header, one slot header per frame
+//*		+-----------------------+
+//*		| slot 0 data			|	slotSize bytes, page aligned
+//*		+-----------------------+
+//*		| slot 1 data			|
+//*		+-----------------------+
+//*		| ...					|
+//*****************************************************************************
+#define	kShmFrameMagic			0x46524D53		//*	'SMRF'
+#define	kShmFrameVersion		2
+#define	kShmFrameSlotCnt		3
+#define	kShmFrameNameFmt		"/dev/shm/alpacapi-cam%d"
+
+//*****************************************************************************
+typedef struct	//	TYPE_ShmFrameSlot
+{
+	uint64_t	sequence;			//*	frame sequence number, 0 while being written
+	uint32_t	dataOffset;			//*	offset of the pixel data from the start of the mapping
+	uint32_t	dataLen;			//*	bytes of pixel data
+	uint32_t	width;
+	uint32_t	height;
+	uint32_t	bytesPerPixel;
+	int32_t		imageType;			//*	TYPE_IMAGE_TYPE
+	int32_t		exposure_us;
+	int32_t		spare;
+	int64_t		exposureStart_us;	//*	CLOCK_REALTIME, micro seconds
+	int64_t		readoutEnd_us;
+	int64_t		published_us;		//*	time the frame was put in the ring
+} TYPE_ShmFrameSlot;
+
+//*****************************************************************************
+typedef struct	//	TYPE_ShmFrameHeader
+{
+	uint32_t			magic;
+	uint32_t			version;
+	uint32_t			slotCnt;
+	uint32_t			slotSize;		//*	maximum bytes of pixel data per slot
+	uint64_t			latestSeq;		//*	sequence number of the most recent complete frame
+	uint32_t			futexWord;		//*	incremented and woken on each new frame
+	uint32_t			writerPid;
+	uint64_t			generation;		//*	unique per ring, 0 once the writer has closed it
+	TYPE_ShmFrameSlot	slot[kShmFrameSlotCnt];
+} TYPE_ShmFrameHeader;
+
+//*****************************************************************************
+typedef struct	//	TYPE_ShmFrameRing
+{
+	int						fileDesc;
+	bool					isWriter;
+	char					path[64];
+	size_t					mapSize;
+	unsigned char			*mapPtr;
+	TYPE_ShmFrameHeader		*header;
+	uint64_t				generation;		//*	the generation that was mapped
+	ino_t					inode;			//*	of the file that was mapped
+} TYPE_ShmFrameRing;
+
+//*****************************************************************************
+//*	a frame returned to a reader, dataPtr points directly into the shared memory
+typedef struct	//	TYPE_ShmFrameInfo
+{
+	TYPE_ShmFrameSlot		slotInfo;
+	int						slotIdx;
+	const unsigned char		*dataPtr;
+	int64_t					latency_us;	//*	time from published to received
+} TYPE_ShmFrameInfo;
+
+
+//*	writer (camera driver)
+TYPE_ShmFrameRing	*ShmFrame_CreateRing(const int cameraNum, const uint32_t slotSize);
+bool				ShmFrame_Publish(	TYPE_ShmFrameRing		*ring,
+										const unsigned char		*frameData,
+										const TYPE_ShmFrameSlot	*frameInfo);
+//*	reader (local tools)
+TYPE_ShmFrameRing	*ShmFrame_OpenReader(const int cameraNum);
+bool				ShmFrame_WaitForFrame(TYPE_ShmFrameRing *ring, const uint64_t lastSeq, const int timeout_ms);
+bool				ShmFrame_GetLatest(TYPE_ShmFrameRing *ring, TYPE_ShmFrameInfo *frameInfo);
+bool				ShmFrame_StillValid(TYPE_ShmFrameRing *ring, const TYPE_ShmFrameInfo *frameInfo);
+bool				ShmFrame_IsStale(TYPE_ShmFrameRing *ring);
+//*	both
+void				ShmFrame_Close(TYPE_ShmFrameRing *ring);
+int64_t				ShmFrame_GetTime_us(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _SHMFRAME_LIB_H_
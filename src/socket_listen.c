@@ -26,6 +26,7 @@
 //*	Feb 10,	2021	<MLS> Reduced timeout to 2500 (micro-secs)
 //*	Dec  3,	2022	<MLS> Added ipAddressString to SendDataToSocket()
 //*	Jan  8,	2024	<MLS> Added _SHOW_HTTP_DATA_
+//*	Oct 18,	2026	<MLS> Added SocketListen_DetachSocket() for long running (streaming) responses
 //*****************************************************************************
 
 #define	_SHOW_HTTP_DATA_
@@ -63,6 +64,7 @@ SocketData_Callback			gSocketCallbackProcPtr		=	NULL;
 //*****************************************************************************
 //*	globals so we can make this code non-blocking
 static	int		gSocketFD;		//*	socket File Descriptor
+static	int		gDetachedSocket	=	-1;	//*	handed off to someone else, do not close it
 
 void SendDataToSocket(const int sock, const char *ipAddressString);
 
@@ -134,6 +136,15 @@ void	SocketListen_SetCallback(SocketData_Callback callBackPtr)
 	gSocketCallbackProcPtr	=	callBackPtr;
 }
 
+//*****************************************************************************
+//*	called from inside the callback when the socket has been handed off to
+//*	another thread (i.e. a stream), the new owner is responsible for closing it
+//*****************************************************************************
+void	SocketListen_DetachSocket(const int socket)
+{
+	gDetachedSocket	=	socket;
+}
+
 
 
 
@@ -160,7 +171,13 @@ char				ipAddrString[64];
 #endif // _SHOW_HTTP_DATA_
 	if (newsockfd >= 0)
 	{
+		gDetachedSocket	=	-1;
 		SendDataToSocket(newsockfd, ipAddrString);
+		if (newsockfd == gDetachedSocket)
+		{
+			gDetachedSocket	=	-1;
+			return(0);
+		}
 
 		shutDownRetCode	=	shutdown(newsockfd, SHUT_RDWR);
 		if (shutDownRetCode != 0)
@@ -0,0 +1,684 @@
+//*****************************************************************************
+//*	Name:			startup_probes.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Runs the device probes at startup in parallel
+//*
+//*	Each Create...Objects() function probes its vendor SDK or hardware, some of them
+//*	take seconds. They are independent of each other so each one runs in its own
+//*	thread. Anything that has to stay in order (ATIK before ASI) stays inside one probe.
+//*
+//*	Probes that claim serial/USB ports (USB_GetPathFromID() is first come first served)
+//*	are added with StartupProbe_AddPortProbe(). They still run on their own threads
+//*	but each one waits for the port probe added before it to finish, so they run one
+//*	after another in the order they were added and get the same ports every time.
+//*
+//*	A device created on a probe thread is not added to gAlpacaDeviceList right away,
+//*	it is staged with its probe. When all of the probes are done (or timed out) the
+//*	staged devices are registered in the order the probes were added, so the
+//*	device list is the same every time no matter which probe finished first.
+//*	The device number is needed by the constructor, so StartupProbe_StageDevice()
+//*	waits for the probes added before this one to finish before it counts the
+//*	devices ahead of it. The probe work before the first device is still parallel.
+//*
+//*	A probe that times out is left running. When it finishes its devices wait for the
+//*	main loop to call StartupProbe_RegisterLate(), the probe thread never touches the
+//*	device list while the main loop is walking it.
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Re-distributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 18,	2026	<MLS> Created startup_probes.c
+//*	Oct 18,	2026	<MLS> Added simulated probe test (_INCLUDE_STARTUP_PROBE_MAIN_)
+//*	Oct 18,	2026	<MLS> Late probes are registered by the main loop, StartupProbe_RegisterLate()
+//*	Oct 18,	2026	<MLS> Probe times are measured from the start of StartupProbe_RunAll()
+//*	Oct 18,	2026	<MLS> Added StartupProbe_AddPortProbe(), port probes run in the order added
+//*	Oct 18,	2026	<MLS> StartupProbe_StageDevice() waits for the earlier probes, device numbers are final
+//*****************************************************************************
+
+#include	<stdbool.h>
+#include	<stdint.h>
+#include	<stdio.h>
+#include	<string.h>
+#include	<time.h>
+#include	<pthread.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"startup_probes.h"
+
+static TYPE_STARTUP_PROBE	gStartupProbes[kMaxStartupProbes];
+static int					gStartupProbeCnt	=	0;
+static pthread_mutex_t		gProbeMutex			=	PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t		gProbeDoneCond		=	PTHREAD_COND_INITIALIZER;
+static PROBE_REGISTER_FUNC	gRegisterFunc		=	NULL;
+static double				gProbeStart_ms		=	0.0;
+static double				gProbeWall_ms		=	0.0;
+
+//*	which probe this thread is running, -1 on any other thread
+static __thread int			gThreadProbeIdx		=	-1;
+
+//*****************************************************************************
+static double	GetMilliSecs(void)
+{
+struct timespec	currentTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &currentTime);
+	return((currentTime.tv_sec * 1000.0) + (currentTime.tv_nsec / 1000000.0));
+}
+
+//*****************************************************************************
+static void	AddProbe(const char *probeName, PROBE_FUNCTION probeFunc, const int timeout_ms, const bool claimsPorts)
+{
+TYPE_STARTUP_PROBE	*probe;
+
+	if (gStartupProbeCnt < kMaxStartupProbes)
+	{
+		probe				=	&gStartupProbes[gStartupProbeCnt];
+		memset(probe, 0, sizeof(TYPE_STARTUP_PROBE));
+		strncpy(probe->probeName, probeName, (sizeof(probe->probeName) - 1));
+		probe->probeFunc	=	probeFunc;
+		probe->timeout_ms	=	(timeout_ms > 0) ? timeout_ms : kProbeDefaultTimeout_ms;
+		probe->probeState	=	kProbeState_Idle;
+		probe->claimsPorts	=	claimsPorts;
+		gStartupProbeCnt++;
+	}
+	else
+	{
+		CONSOLE_DEBUG_W_STR("Too many startup probes, running now:", probeName);
+		probeFunc();
+	}
+}
+
+//*****************************************************************************
+void	StartupProbe_Add(const char *probeName, PROBE_FUNCTION probeFunc, const int timeout_ms)
+{
+	AddProbe(probeName, probeFunc, timeout_ms, false);
+}
+
+//*****************************************************************************
+//*	for probes that claim serial/USB ports, they run one at a time in the order added
+//*****************************************************************************
+void	StartupProbe_AddPortProbe(const char *probeName, PROBE_FUNCTION probeFunc, const int timeout_ms)
+{
+	AddProbe(probeName, probeFunc, timeout_ms, true);
+}
+
+//*****************************************************************************
+//*	true once the probe function has returned, even if it was too late
+//*	gProbeMutex must be locked
+//*****************************************************************************
+static bool	ProbeHasFinished(const int probeIdx)
+{
+	switch(gStartupProbes[probeIdx].probeState)
+	{
+		case kProbeState_Done:
+		case kProbeState_Late:
+		case kProbeState_LateAdded:
+			return(true);
+
+		default:
+			return(false);
+	}
+}
+
+//*****************************************************************************
+static void	RegisterProbeDevices(TYPE_STARTUP_PROBE *probe)
+{
+int		iii;
+
+	for (iii=0; iii<probe->deviceCnt; iii++)
+	{
+		gRegisterFunc(probe->devices[iii]);
+	}
+}
+
+//*****************************************************************************
+//*	called from the AlpacaDriver constructor.
+//*	Returns true if the device was staged, false if the caller should add it
+//*	to the device list itself. stagedSameType is how many devices of the same
+//*	type will be registered ahead of this one by this probe and the probes before it.
+//*	If an earlier probe has not made its device yet the number is fixed up at registration.
+//*****************************************************************************
+bool	StartupProbe_StageDevice(void *device, const int deviceType, int *stagedSameType)
+{
+TYPE_STARTUP_PROBE	*probe;
+bool				staged;
+int					ppp;
+int					iii;
+
+	staged			=	false;
+	*stagedSameType	=	0;
+	if (gThreadProbeIdx >= 0)
+	{
+		pthread_mutex_lock(&gProbeMutex);
+		//*	wait for the probes added before this one, once they are done (or timed out)
+		//*	we know how many devices are ahead of this one
+		ppp	=	0;
+		while (ppp < gThreadProbeIdx)
+		{
+			if (gStartupProbes[ppp].probeState == kProbeState_Running)
+			{
+				pthread_cond_wait(&gProbeDoneCond, &gProbeMutex);
+				ppp	=	0;
+			}
+			else
+			{
+				ppp++;
+			}
+		}
+		probe	=	&gStartupProbes[gThreadProbeIdx];
+		if (probe->deviceCnt < kMaxProbeDevices)
+		{
+			//*	this probe and the ones before it get registered ahead of this device,
+			//*	probes that timed out are registered after all of the others
+			for (ppp=0; ppp<=gThreadProbeIdx; ppp++)
+			{
+				if ((ppp < gThreadProbeIdx) && (gStartupProbes[ppp].probeState != kProbeState_Done))
+				{
+					continue;
+				}
+				for (iii=0; iii<gStartupProbes[ppp].deviceCnt; iii++)
+				{
+					if (gStartupProbes[ppp].deviceTypes[iii] == deviceType)
+					{
+						(*stagedSameType)++;
+					}
+				}
+			}
+			probe->devices[probe->deviceCnt]		=	device;
+			probe->deviceTypes[probe->deviceCnt]	=	deviceType;
+			probe->deviceCnt++;
+			staged	=	true;
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_STR("Too many devices from probe", probe->probeName);
+		}
+		pthread_mutex_unlock(&gProbeMutex);
+	}
+	return(staged);
+}
+
+//*****************************************************************************
+static void	*StartupProbe_Thread(void *arg)
+{
+TYPE_STARTUP_PROBE	*probe;
+int					returnValue;
+int					prevIdx;
+
+	gThreadProbeIdx	=	(int)(intptr_t)arg;
+	probe			=	&gStartupProbes[gThreadProbeIdx];
+	if (probe->claimsPorts)
+	{
+		//*	wait for the port probe ahead of this one to finish
+		pthread_mutex_lock(&gProbeMutex);
+		prevIdx	=	gThreadProbeIdx - 1;
+		while ((prevIdx >= 0) && (gStartupProbes[prevIdx].claimsPorts == false))
+		{
+			prevIdx--;
+		}
+		while ((prevIdx >= 0) && (ProbeHasFinished(prevIdx) == false))
+		{
+			pthread_cond_wait(&gProbeDoneCond, &gProbeMutex);
+		}
+		pthread_mutex_unlock(&gProbeMutex);
+	}
+	returnValue		=	probe->probeFunc();
+
+	pthread_mutex_lock(&gProbeMutex);
+	probe->returnValue	=	returnValue;
+	//*	same start time as the time outs, so the times in the report line up
+	probe->elapsed_ms	=	GetMilliSecs() - gProbeStart_ms;
+	if (probe->probeState == kProbeState_TimedOut)
+	{
+		//*	the main loop owns the device list by now, StartupProbe_RegisterLate() adds them
+		CONSOLE_DEBUG_W_STR("Late probe finished:", probe->probeName);
+		probe->probeState	=	kProbeState_Late;
+	}
+	else
+	{
+		probe->probeState	=	kProbeState_Done;
+	}
+	pthread_cond_broadcast(&gProbeDoneCond);
+	pthread_mutex_unlock(&gProbeMutex);
+	gThreadProbeIdx	=	-1;
+	return(NULL);
+}
+
+//*****************************************************************************
+//*	returns the number of devices registered
+//*****************************************************************************
+int	StartupProbe_RunAll(PROBE_REGISTER_FUNC registerFunc)
+{
+pthread_t		threadIDs[kMaxStartupProbes];
+bool			threadOK[kMaxStartupProbes];
+double			startTime_ms;
+double			now_ms;
+double			nextDeadline_ms;
+double			deadline_ms;
+struct timespec	waitUntil;
+bool			stillRunning;
+int				deviceCnt;
+int				iii;
+
+	gRegisterFunc	=	registerFunc;
+	startTime_ms	=	GetMilliSecs();
+	gProbeStart_ms	=	startTime_ms;
+	for (iii=0; iii<gStartupProbeCnt; iii++)
+	{
+		gStartupProbes[iii].probeState	=	kProbeState_Running;
+		threadOK[iii]	=	(pthread_create(&threadIDs[iii], NULL, &StartupProbe_Thread, (void *)(intptr_t)iii) == 0);
+		if (threadOK[iii] == false)
+		{
+			//*	no thread, run it here
+			CONSOLE_DEBUG_W_STR("Failed to start probe thread, running in line:", gStartupProbes[iii].probeName);
+			StartupProbe_Thread((void *)(intptr_t)iii);
+		}
+	}
+
+	//*	wait until they are all done or past their time out
+	pthread_mutex_lock(&gProbeMutex);
+	stillRunning	=	true;
+	while (stillRunning)
+	{
+		stillRunning	=	false;
+		nextDeadline_ms	=	0.0;
+		now_ms			=	GetMilliSecs();
+		for (iii=0; iii<gStartupProbeCnt; iii++)
+		{
+			if (gStartupProbes[iii].probeState == kProbeState_Running)
+			{
+				deadline_ms	=	startTime_ms + gStartupProbes[iii].timeout_ms;
+				if (now_ms >= deadline_ms)
+				{
+					CONSOLE_DEBUG_W_STR("Probe timed out:", gStartupProbes[iii].probeName);
+					gStartupProbes[iii].probeState	=	kProbeState_TimedOut;
+					gStartupProbes[iii].elapsed_ms	=	now_ms - startTime_ms;
+					//*	probes waiting in StartupProbe_StageDevice() do not wait for this one
+					pthread_cond_broadcast(&gProbeDoneCond);
+				}
+				else
+				{
+					if ((stillRunning == false) || (deadline_ms < nextDeadline_ms))
+					{
+						nextDeadline_ms	=	deadline_ms;
+					}
+					stillRunning	=	true;
+				}
+			}
+		}
+		if (stillRunning)
+		{
+			clock_gettime(CLOCK_REALTIME, &waitUntil);
+			deadline_ms			=	nextDeadline_ms - now_ms;
+			waitUntil.tv_sec	+=	(time_t)(deadline_ms / 1000.0);
+			waitUntil.tv_nsec	+=	(long)((deadline_ms - ((time_t)(deadline_ms / 1000.0) * 1000.0)) * 1000000.0);
+			if (waitUntil.tv_nsec >= 1000000000L)
+			{
+				waitUntil.tv_nsec	-=	1000000000L;
+				waitUntil.tv_sec++;
+			}
+			pthread_cond_timedwait(&gProbeDoneCond, &gProbeMutex, &waitUntil);
+		}
+	}
+
+	//*	register in the order the probes were added
+	deviceCnt	=	0;
+	for (iii=0; iii<gStartupProbeCnt; iii++)
+	{
+		if (gStartupProbes[iii].probeState == kProbeState_Done)
+		{
+			RegisterProbeDevices(&gStartupProbes[iii]);
+			deviceCnt	+=	gStartupProbes[iii].deviceCnt;
+		}
+	}
+	gProbeWall_ms	=	GetMilliSecs() - startTime_ms;
+	pthread_mutex_unlock(&gProbeMutex);
+
+	for (iii=0; iii<gStartupProbeCnt; iii++)
+	{
+		if (threadOK[iii])
+		{
+			if (gStartupProbes[iii].probeState == kProbeState_TimedOut)
+			{
+				pthread_detach(threadIDs[iii]);
+			}
+			else
+			{
+				pthread_join(threadIDs[iii], NULL);
+			}
+		}
+	}
+	return(deviceCnt);
+}
+
+//*****************************************************************************
+//*	called from the main loop, between passes over the device list.
+//*	Registers the devices of probes that finished after they timed out,
+//*	returns the number of devices registered
+//*****************************************************************************
+int	StartupProbe_RegisterLate(void)
+{
+int		deviceCnt;
+int		iii;
+
+	deviceCnt	=	0;
+	if ((gStartupProbeCnt > 0) && (gRegisterFunc != NULL))
+	{
+		pthread_mutex_lock(&gProbeMutex);
+		for (iii=0; iii<gStartupProbeCnt; iii++)
+		{
+			if (gStartupProbes[iii].probeState == kProbeState_Late)
+			{
+				CONSOLE_DEBUG_W_STR("Registering devices from late probe:", gStartupProbes[iii].probeName);
+				RegisterProbeDevices(&gStartupProbes[iii]);
+				deviceCnt						+=	gStartupProbes[iii].deviceCnt;
+				gStartupProbes[iii].probeState	=	kProbeState_LateAdded;
+			}
+		}
+		pthread_mutex_unlock(&gProbeMutex);
+	}
+	return(deviceCnt);
+}
+
+//*****************************************************************************
+void	StartupProbe_PrintReport(void)
+{
+int			iii;
+double		total_ms;
+const char	*stateString;
+
+	total_ms	=	0.0;
+	printf("%-24s %-10s %10s %8s\r\n", "Probe", "State", "Time(ms)", "Devices");
+	pthread_mutex_lock(&gProbeMutex);
+	for (iii=0; iii<gStartupProbeCnt; iii++)
+	{
+		switch(gStartupProbes[iii].probeState)
+		{
+			case kProbeState_Done:		stateString	=	"ok";			break;
+			case kProbeState_TimedOut:	stateString	=	"TIMED-OUT";	break;
+			case kProbeState_Late:		stateString	=	"late";			break;
+			case kProbeState_LateAdded:	stateString	=	"late";			break;
+			default:					stateString	=	"?";			break;
+		}
+		printf("%-24s %-10s %10.1f %8d\r\n",	gStartupProbes[iii].probeName,
+												stateString,
+												gStartupProbes[iii].elapsed_ms,
+												gStartupProbes[iii].deviceCnt);
+		total_ms	+=	gStartupProbes[iii].elapsed_ms;
+	}
+	pthread_mutex_unlock(&gProbeMutex);
+	printf("Startup probes took %1.1f ms, %1.1f ms if run one after another\r\n", gProbeWall_ms, total_ms);
+}
+
+
+#ifdef _INCLUDE_STARTUP_PROBE_MAIN_
+//*****************************************************************************
+//*	Simulated probes with random delays, the device list, the device numbers
+//*	and the port claims have to come out the same every time and the startup
+//*	time has to be the slowest probe, not the sum of them.
+//*
+//*	gcc -O2 -D_INCLUDE_STARTUP_PROBE_MAIN_ -I../libs/src_mlsLib startup_probes.c -lpthread -o startupprobetest
+//*****************************************************************************
+#include	<stdlib.h>
+#include	<unistd.h>
+
+#define	kTestRuns		10
+#define	kTestMaxDelay	300
+
+//*****************************************************************************
+typedef struct
+{
+	int		deviceType;
+	int		deviceNum;
+	char	name[32];
+} TYPE_TEST_DEVICE;
+
+static TYPE_TEST_DEVICE	gTestDevices[64];
+static int				gTestDevCnt;
+static TYPE_TEST_DEVICE	*gTestList[64];
+static int				gTestListCnt;
+static int				gRenumbered;
+
+//*****************************************************************************
+static int	CountByType(const int deviceType)
+{
+int		iii;
+int		count;
+
+	count	=	0;
+	for (iii=0; iii<gTestListCnt; iii++)
+	{
+		if (gTestList[iii]->deviceType == deviceType)
+		{
+			count++;
+		}
+	}
+	return(count);
+}
+
+//*****************************************************************************
+//*	what the AlpacaDriver constructor does
+//*****************************************************************************
+static void	CreateTestDevice(const int deviceType, const char *name)
+{
+TYPE_TEST_DEVICE	*device;
+int					stagedSameType;
+
+	pthread_mutex_lock(&gProbeMutex);
+	device	=	&gTestDevices[gTestDevCnt++];
+	pthread_mutex_unlock(&gProbeMutex);
+	device->deviceType	=	deviceType;
+	strcpy(device->name, name);
+	if (StartupProbe_StageDevice(device, deviceType, &stagedSameType))
+	{
+		device->deviceNum	=	CountByType(deviceType) + stagedSameType;
+	}
+	else
+	{
+		device->deviceNum			=	CountByType(deviceType);
+		gTestList[gTestListCnt++]	=	device;
+	}
+}
+
+//*****************************************************************************
+//*	what AddToDeviceList() does
+//*****************************************************************************
+static void	RegisterTestDevice(void *devicePtr)
+{
+TYPE_TEST_DEVICE	*device	=	(TYPE_TEST_DEVICE *)devicePtr;
+int					deviceNum;
+
+	deviceNum	=	CountByType(device->deviceType);
+	if (deviceNum != device->deviceNum)
+	{
+		gRenumbered++;
+	}
+	device->deviceNum			=	deviceNum;
+	gTestList[gTestListCnt++]	=	device;
+}
+
+static int	gDelay[8];
+
+static int	Probe_Cameras(void)	{ usleep(gDelay[0] * 1000); CreateTestDevice(1, "ATIK"); usleep(gDelay[0] * 500); CreateTestDevice(1, "ASI"); return(2);	}
+static int	Probe_Focuser(void)	{ usleep(gDelay[1] * 1000); CreateTestDevice(2, "MoonLite"); return(1);	}
+static int	Probe_Dome(void)	{ usleep(gDelay[2] * 1000); CreateTestDevice(3, "ROR");	return(1);			}
+static int	Probe_Switch(void)	{ usleep(gDelay[3] * 1000); CreateTestDevice(4, "Power box"); CreateTestDevice(4, "Dew heater"); return(2); }
+static int	Probe_Nothing(void)	{ usleep(gDelay[4] * 1000); return(0);	}
+
+//*****************************************************************************
+//*	what USB_GetPathFromID() does, the first probe to ask gets the first port
+//*****************************************************************************
+static pthread_mutex_t	gTestPortMutex	=	PTHREAD_MUTEX_INITIALIZER;
+static char				gTestPortOwner[2][32];
+
+static void	ClaimTestPort(const char *owner)
+{
+int		iii;
+
+	pthread_mutex_lock(&gTestPortMutex);
+	for (iii=0; iii<2; iii++)
+	{
+		if (gTestPortOwner[iii][0] == 0)
+		{
+			strcpy(gTestPortOwner[iii], owner);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&gTestPortMutex);
+}
+
+//*	both want an FTDI port, the focuser was added first so it gets the first one
+static int	Probe_PortFocuser(void)	{ usleep(gDelay[5] * 1000); ClaimTestPort("NiteCrawler"); CreateTestDevice(2, "NiteCrawler"); return(1);	}
+static int	Probe_PortMount(void)	{ usleep(gDelay[6] * 1000); ClaimTestPort("ExpSci"); CreateTestDevice(6, "ExpSci"); return(1);		}
+static int	Probe_Hung(void)	{ usleep(800 * 1000); CreateTestDevice(5, "Stuck SDK"); return(1);	}
+
+//*****************************************************************************
+int main(int argc, char *argv[])
+{
+int		run;
+int		iii;
+char	firstOrder[512];
+char	thisOrder[512];
+char	deviceString[64];
+double	startTime_ms;
+double	elapsed_ms;
+int		probeTime;
+int		maxDelay;
+int		slowest_ms;
+int		sumDelay;
+int		failCnt;
+
+	(void)argc;
+	(void)argv;
+	srand(time(NULL));
+	failCnt	=	0;
+	firstOrder[0]	=	0;
+	for (run=0; run<kTestRuns; run++)
+	{
+		gStartupProbeCnt	=	0;
+		gTestDevCnt			=	0;
+		gTestListCnt		=	0;
+		gRenumbered			=	0;
+		maxDelay			=	0;
+		sumDelay			=	0;
+		memset(gTestPortOwner, 0, sizeof(gTestPortOwner));
+		for (iii=0; iii<7; iii++)
+		{
+			gDelay[iii]	=	rand() % kTestMaxDelay;
+		}
+		for (iii=0; iii<5; iii++)
+		{
+			probeTime	=	gDelay[iii];
+			if (iii == 0)
+			{
+				probeTime	+=	gDelay[0] / 2;		//*	the camera probe sleeps 1.5 times its delay
+			}
+			sumDelay	+=	probeTime;
+			if (probeTime > maxDelay)
+			{
+				maxDelay	=	probeTime;
+			}
+		}
+		//*	the port probes run one after the other
+		sumDelay	+=	gDelay[5] + gDelay[6];
+		if ((gDelay[5] + gDelay[6]) > maxDelay)
+		{
+			maxDelay	=	gDelay[5] + gDelay[6];
+		}
+
+		//*	a device made on the main thread before the probes
+		CreateTestDevice(4, "Main thread switch");
+
+		StartupProbe_Add("Cameras",		Probe_Cameras,	0);
+		StartupProbe_Add("Focuser",		Probe_Focuser,	0);
+		StartupProbe_AddPortProbe("Port focuser",	Probe_PortFocuser,	0);
+		StartupProbe_Add("Hung SDK",	Probe_Hung,		(run == 0) ? 500 : 2000);
+		StartupProbe_Add("Dome",		Probe_Dome,		0);
+		StartupProbe_Add("Nothing",		Probe_Nothing,	0);
+		StartupProbe_Add("Switch",		Probe_Switch,	0);
+		StartupProbe_AddPortProbe("Port mount",		Probe_PortMount,	0);
+		startTime_ms	=	GetMilliSecs();
+		StartupProbe_RunAll(RegisterTestDevice);
+		elapsed_ms		=	GetMilliSecs() - startTime_ms;
+		if (run == 0)
+		{
+			//*	the hung probe timed out, wait for it to finish and then do
+			//*	what the main loop does
+			usleep(500 * 1000);
+			if (StartupProbe_RegisterLate() != 1)
+			{
+				printf("FAIL: late probe was not registered\r\n");
+				failCnt++;
+			}
+		}
+		StartupProbe_PrintReport();
+
+		thisOrder[0]	=	0;
+		for (iii=0; iii<gTestListCnt; iii++)
+		{
+			sprintf(deviceString, "%s#%d, ", gTestList[iii]->name, gTestList[iii]->deviceNum);
+			strcat(thisOrder, deviceString);
+		}
+		printf("Run %d: %s\r\n", run, thisOrder);
+		slowest_ms	=	(run == 0) ? 500 : 800;		//*	the hung probe, or its time out
+		if (maxDelay > slowest_ms)
+		{
+			slowest_ms	=	maxDelay;
+		}
+		printf("Run %d: %1.0f ms, slowest probe %d ms, serial would be %d ms, renumbered %d\r\n",
+					run, elapsed_ms, slowest_ms, sumDelay + 800, gRenumbered);
+		if (elapsed_ms > (slowest_ms + 100))
+		{
+			printf("FAIL: probes did not run in parallel\r\n");
+			failCnt++;
+		}
+		if (run == 0)
+		{
+			//*	the late device has to be at the end
+			if (strstr(thisOrder, "Stuck SDK#0, ") != (thisOrder + strlen(thisOrder) - strlen("Stuck SDK#0, ")))
+			{
+				printf("FAIL: late device is not last\r\n");
+				failCnt++;
+			}
+		}
+		else if (firstOrder[0] == 0)
+		{
+			strcpy(firstOrder, thisOrder);
+		}
+		else if (strcmp(firstOrder, thisOrder) != 0)
+		{
+			printf("FAIL: order changed\r\n");
+			failCnt++;
+		}
+		if (gRenumbered != 0)
+		{
+			printf("FAIL: provisional device number was wrong\r\n");
+			failCnt++;
+		}
+		if (strcmp(gTestPortOwner[0], "NiteCrawler") != 0)
+		{
+			printf("FAIL: first port went to %s\r\n", gTestPortOwner[0]);
+			failCnt++;
+		}
+	}
+	printf("Failures = %d\r\n", failCnt);
+	return(failCnt == 0 ? 0 : 1);
+}
+#endif // _INCLUDE_STARTUP_PROBE_MAIN_
@@ -0,0 +1,64 @@
+//*****************************************************************************
+//#include	"startup_probes.h"
+
+#ifndef _STARTUP_PROBES_H_
+#define	_STARTUP_PROBES_H_
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define	kMaxStartupProbes			24
+#define	kMaxProbeDevices			16
+#define	kProbeDefaultTimeout_ms		30000
+
+//*****************************************************************************
+enum
+{
+	kProbeState_Idle	=	0,
+	kProbeState_Running,
+	kProbeState_Done,
+	kProbeState_TimedOut,		//*	still running, its devices are added when it finishes
+	kProbeState_Late,			//*	finished after it timed out, waiting for the main loop
+	kProbeState_LateAdded		//*	late devices have been registered
+};
+
+typedef int		(*PROBE_FUNCTION)(void);
+typedef void	(*PROBE_REGISTER_FUNC)(void *device);
+
+//*****************************************************************************
+typedef struct	//	TYPE_STARTUP_PROBE
+{
+	char			probeName[32];
+	PROBE_FUNCTION	probeFunc;
+	int				timeout_ms;
+	int				probeState;
+	int				returnValue;
+	bool			claimsPorts;		//*	waits for the port probe added before it
+	double			elapsed_ms;
+	int				deviceCnt;
+	void			*devices[kMaxProbeDevices];		//*	in the order they were created
+	int				deviceTypes[kMaxProbeDevices];
+} TYPE_STARTUP_PROBE;
+
+
+void	StartupProbe_Add(const char *probeName, PROBE_FUNCTION probeFunc, const int timeout_ms);
+void	StartupProbe_AddPortProbe(const char *probeName, PROBE_FUNCTION probeFunc, const int timeout_ms);
+int		StartupProbe_RunAll(PROBE_REGISTER_FUNC registerFunc);
+int		StartupProbe_RegisterLate(void);
+bool	StartupProbe_StageDevice(void *device, const int deviceType, int *stagedSameType);
+void	StartupProbe_PrintReport(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _STARTUP_PROBES_H_
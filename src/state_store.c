@@ -0,0 +1,1241 @@
+//*****************************************************************************
+//*	Name:			state_store.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Crash safe key/value store for driver state
+//*
+//*	Drivers keep small bits of state here (switch names and values etc) that have
+//*	to survive a power failure. A put only updates the table in memory and queues
+//*	a log record, a background thread writes everything queued in the last
+//*	kSS_FlushDelay_ms with one write() and one fdatasync().
+//*
+//*	Files
+//*		<base>.wal		write ahead log, records are appended, each one has a crc
+//*		<base>.snap		checkpoint of the whole table, written to a temp file and renamed
+//*
+//*	When the log gets to kSS_MaxLogSize the table is checkpointed and the log is emptied.
+//*	On open the checkpoint is loaded and the log is replayed on top of it, a torn
+//*	record at the end of the log (power failed in the middle of a write) is dropped.
+//*	Every record has a sequence number so a log that was not emptied after a
+//*	checkpoint does not undo anything.
+//*
+//*	A record only counts as on disk after the whole write and the fdatasync() worked.
+//*	If either fails the log is cut back to the last good record and the same
+//*	records are written again kSS_RetryDelay_ms later.
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Re-distributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 18,	2026	<MLS> Created state_store.c
+//*	Oct 18,	2026	<MLS> Added kill at random point test (_INCLUDE_STATE_STORE_MAIN_)
+//*	Oct 18,	2026	<MLS> Failed log writes are cut off and retried, StateStore_Sync() reports them
+//*	Oct 18,	2026	<MLS> Added StateStore_SetFilePath(), the store path is absolute
+//*	Oct 18,	2026	<MLS> Added write/fsync fault injection test
+//*****************************************************************************
+
+#include	<stdbool.h>
+#include	<stdint.h>
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<stddef.h>
+#include	<string.h>
+#include	<unistd.h>
+#include	<fcntl.h>
+#include	<errno.h>
+#include	<time.h>
+#include	<limits.h>
+#include	<pthread.h>
+#include	<sys/stat.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"state_store.h"
+
+#define	kSS_RecordMagic		0x52455353		//*	'SSER'
+#define	kSS_SnapMagic		0x50414E53		//*	'SNAP'
+#define	kSS_Version			1
+#define	kSS_PendingSize		(32 * 1024)
+
+//*	the self test swaps these for versions that can be told to fail
+#ifdef _INCLUDE_STATE_STORE_MAIN_
+	static ssize_t	Test_write(int fileDesc, const void *buffer, size_t count);
+	static int		Test_fdatasync(int fileDesc);
+	#define	LOG_WRITE		Test_write
+	#define	LOG_FDATASYNC	Test_fdatasync
+#else
+	#define	LOG_WRITE		write
+	#define	LOG_FDATASYNC	fdatasync
+#endif
+
+//*****************************************************************************
+//*	one log record, followed by the key and the value, no null terminators
+typedef struct	//	TYPE_SS_RecordHdr
+{
+	uint32_t	magic;
+	uint32_t	crc;			//*	from seq to the end of the value
+	uint64_t	seq;
+	uint16_t	keyLen;
+	uint16_t	valueLen;
+	uint32_t	spare;
+} TYPE_SS_RecordHdr;
+
+//*****************************************************************************
+//*	checkpoint file header, followed by entryCnt records in the log format
+typedef struct	//	TYPE_SS_SnapHdr
+{
+	uint32_t	magic;
+	uint32_t	version;
+	uint64_t	seq;			//*	everything up to here is in the checkpoint
+	uint32_t	entryCnt;
+	uint32_t	crc;			//*	of the header up to here
+} TYPE_SS_SnapHdr;
+
+//*****************************************************************************
+typedef struct	//	TYPE_SS_Entry
+{
+	char		key[kSS_MaxKeyLen];
+	char		value[kSS_MaxValueLen];
+	bool		inUse;
+} TYPE_SS_Entry;
+
+#define	kSS_MaxRecordSize	(sizeof(TYPE_SS_RecordHdr) + kSS_MaxKeyLen + kSS_MaxValueLen)
+
+static pthread_mutex_t	gSSmutex			=	PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t	gSSwakeCond			=	PTHREAD_COND_INITIALIZER;	//*	wakes the flush thread
+static pthread_cond_t	gSSdoneCond			=	PTHREAD_COND_INITIALIZER;	//*	a flush finished
+static pthread_t		gSSthreadID;
+static bool				gSSisOpen			=	false;
+static bool				gSSopenFailed		=	false;
+static bool				gSSrunning			=	false;
+static bool				gSSsyncRequested	=	false;
+static int				gSSlogFileDesc		=	-1;
+static char				gSSlogPath[256];
+static char				gSSsnapPath[256];
+static char				gSSdirPath[256];
+static off_t			gSSlogSize			=	0;
+static uint64_t			gSSseq				=	0;		//*	last record queued
+static uint64_t			gSSdurableSeq		=	0;		//*	last record on disk
+static uint32_t			gSScheckpointCnt	=	0;
+static uint32_t			gSSwriteFailCnt		=	0;
+static char				gSSfilePath[PATH_MAX]	=	"";
+
+static TYPE_SS_Entry	gSStable[kSS_MaxEntries];
+static int				gSSentryCnt			=	0;
+
+//*	puts go into the pending buffer, the flush thread copies it to the write buffer.
+//*	Records that failed to write stay at the start of the write buffer until they make it.
+static unsigned char	gSSpendingBuff[kSS_PendingSize];
+static unsigned char	gSSwriteBuff[2 * kSS_PendingSize];
+static int				gSSpendingLen		=	0;
+static int				gSSretryLen			=	0;
+static uint64_t			gSSretrySeq			=	0;
+
+//*	copy of the table for a checkpoint, taken while the lock is held
+static TYPE_SS_Entry	gSSsnapTable[kSS_MaxEntries];
+static unsigned char	gSSsnapBuff[sizeof(TYPE_SS_SnapHdr) + (kSS_MaxEntries * kSS_MaxRecordSize)];
+
+static uint32_t			gSScrcTable[256];
+static bool				gSScrcTableValid	=	false;
+
+//*****************************************************************************
+static uint32_t	CRC32(const unsigned char *dataPtr, const size_t dataLen, uint32_t crc)
+{
+size_t		iii;
+uint32_t	value;
+int			bitNum;
+
+	if (gSScrcTableValid == false)
+	{
+		for (iii=0; iii<256; iii++)
+		{
+			value	=	iii;
+			for (bitNum=0; bitNum<8; bitNum++)
+			{
+				value	=	(value & 1) ? (0xEDB88320 ^ (value >> 1)) : (value >> 1);
+			}
+			gSScrcTable[iii]	=	value;
+		}
+		gSScrcTableValid	=	true;
+	}
+	crc	=	~crc;
+	for (iii=0; iii<dataLen; iii++)
+	{
+		crc	=	gSScrcTable[(crc ^ dataPtr[iii]) & 0xff] ^ (crc >> 8);
+	}
+	return(~crc);
+}
+
+//*****************************************************************************
+//*	returns the number of bytes used
+//*****************************************************************************
+static int	EncodeRecord(unsigned char *buffer, const uint64_t seq, const char *key, const char *value)
+{
+TYPE_SS_RecordHdr	recordHdr;
+int					keyLen;
+int					valueLen;
+
+	keyLen		=	strlen(key);
+	valueLen	=	strlen(value);
+	memset(&recordHdr, 0, sizeof(TYPE_SS_RecordHdr));
+	recordHdr.magic		=	kSS_RecordMagic;
+	recordHdr.seq		=	seq;
+	recordHdr.keyLen	=	keyLen;
+	recordHdr.valueLen	=	valueLen;
+	memcpy(buffer, &recordHdr, sizeof(TYPE_SS_RecordHdr));
+	memcpy(buffer + sizeof(TYPE_SS_RecordHdr), key, keyLen);
+	memcpy(buffer + sizeof(TYPE_SS_RecordHdr) + keyLen, value, valueLen);
+
+	recordHdr.crc	=	CRC32(buffer + offsetof(TYPE_SS_RecordHdr, seq),
+							(sizeof(TYPE_SS_RecordHdr) - offsetof(TYPE_SS_RecordHdr, seq)) + keyLen + valueLen,
+							0);
+	memcpy(buffer + offsetof(TYPE_SS_RecordHdr, crc), &recordHdr.crc, sizeof(uint32_t));
+	return(sizeof(TYPE_SS_RecordHdr) + keyLen + valueLen);
+}
+
+//*****************************************************************************
+//*	returns the record length, 0 if there is not a complete valid record
+//*****************************************************************************
+static int	DecodeRecord(	const unsigned char	*buffer,
+							const size_t		bufferLen,
+							uint64_t			*seq,
+							char				*key,
+							char				*value)
+{
+TYPE_SS_RecordHdr	recordHdr;
+size_t				recordLen;
+
+	if (bufferLen < sizeof(TYPE_SS_RecordHdr))
+	{
+		return(0);
+	}
+	memcpy(&recordHdr, buffer, sizeof(TYPE_SS_RecordHdr));
+	if ((recordHdr.magic != kSS_RecordMagic) ||
+		(recordHdr.keyLen == 0) || (recordHdr.keyLen >= kSS_MaxKeyLen) ||
+		(recordHdr.valueLen >= kSS_MaxValueLen))
+	{
+		return(0);
+	}
+	recordLen	=	sizeof(TYPE_SS_RecordHdr) + recordHdr.keyLen + recordHdr.valueLen;
+	if ((recordLen > bufferLen) ||
+		(recordHdr.crc != CRC32(buffer + offsetof(TYPE_SS_RecordHdr, seq), recordLen - offsetof(TYPE_SS_RecordHdr, seq), 0)))
+	{
+		return(0);
+	}
+	*seq	=	recordHdr.seq;
+	memcpy(key,		buffer + sizeof(TYPE_SS_RecordHdr),						recordHdr.keyLen);
+	memcpy(value,	buffer + sizeof(TYPE_SS_RecordHdr) + recordHdr.keyLen,	recordHdr.valueLen);
+	key[recordHdr.keyLen]		=	0;
+	value[recordHdr.valueLen]	=	0;
+	return(recordLen);
+}
+
+//*****************************************************************************
+static int	FindEntry(const char *key)
+{
+int		iii;
+
+	for (iii=0; iii<gSSentryCnt; iii++)
+	{
+		if (strcmp(gSStable[iii].key, key) == 0)
+		{
+			return(iii);
+		}
+	}
+	return(-1);
+}
+
+//*****************************************************************************
+//*	returns true if the value changed
+//*****************************************************************************
+static bool	SetEntry(const char *key, const char *value)
+{
+int		entryIdx;
+
+	entryIdx	=	FindEntry(key);
+	if (entryIdx < 0)
+	{
+		if (gSSentryCnt >= kSS_MaxEntries)
+		{
+			CONSOLE_DEBUG_W_STR("State store is full, can not add", key);
+			return(false);
+		}
+		entryIdx	=	gSSentryCnt;
+		gSSentryCnt++;
+		strcpy(gSStable[entryIdx].key, key);
+		gSStable[entryIdx].inUse	=	true;
+	}
+	else if (strcmp(gSStable[entryIdx].value, value) == 0)
+	{
+		return(false);
+	}
+	strcpy(gSStable[entryIdx].value, value);
+	return(true);
+}
+
+//*****************************************************************************
+static bool	ReadWholeFile(const char *filePath, unsigned char **fileData, size_t *fileSize)
+{
+int			fileDesc;
+struct stat	fileStatus;
+ssize_t		bytesRead;
+bool		readOK;
+
+	readOK		=	false;
+	*fileData	=	NULL;
+	*fileSize	=	0;
+	fileDesc	=	open(filePath, O_RDONLY);
+	if (fileDesc >= 0)
+	{
+		if ((fstat(fileDesc, &fileStatus) == 0) && (fileStatus.st_size > 0))
+		{
+			*fileData	=	(unsigned char *)malloc(fileStatus.st_size);
+			if (*fileData != NULL)
+			{
+				bytesRead	=	read(fileDesc, *fileData, fileStatus.st_size);
+				if (bytesRead == fileStatus.st_size)
+				{
+					*fileSize	=	bytesRead;
+					readOK		=	true;
+				}
+				else
+				{
+					free(*fileData);
+					*fileData	=	NULL;
+				}
+			}
+		}
+		close(fileDesc);
+	}
+	return(readOK);
+}
+
+//*****************************************************************************
+//*	returns the sequence number of the checkpoint, 0 if there is none
+//*****************************************************************************
+static uint64_t	LoadSnapshot(void)
+{
+unsigned char	*fileData;
+size_t			fileSize;
+size_t			offset;
+TYPE_SS_SnapHdr	snapHdr;
+uint64_t		seq;
+uint32_t		iii;
+int				recordLen;
+char			key[kSS_MaxKeyLen];
+char			value[kSS_MaxValueLen];
+
+	snapHdr.seq	=	0;
+	if (ReadWholeFile(gSSsnapPath, &fileData, &fileSize))
+	{
+		memcpy(&snapHdr, fileData, (fileSize < sizeof(TYPE_SS_SnapHdr)) ? fileSize : sizeof(TYPE_SS_SnapHdr));
+		if ((fileSize >= sizeof(TYPE_SS_SnapHdr)) &&
+			(snapHdr.magic == kSS_SnapMagic) &&
+			(snapHdr.version == kSS_Version) &&
+			(snapHdr.entryCnt <= kSS_MaxEntries) &&
+			(snapHdr.crc == CRC32(fileData, offsetof(TYPE_SS_SnapHdr, crc), 0)))
+		{
+			offset	=	sizeof(TYPE_SS_SnapHdr);
+			for (iii=0; iii<snapHdr.entryCnt; iii++)
+			{
+				recordLen	=	DecodeRecord(fileData + offset, fileSize - offset, &seq, key, value);
+				if (recordLen <= 0)
+				{
+					CONSOLE_DEBUG_W_STR("Checkpoint is damaged", gSSsnapPath);
+					break;
+				}
+				SetEntry(key, value);
+				offset	+=	recordLen;
+			}
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_STR("Checkpoint is not valid", gSSsnapPath);
+			snapHdr.seq	=	0;
+		}
+		free(fileData);
+	}
+	return(snapHdr.seq);
+}
+
+//*****************************************************************************
+//*	applies the log on top of the checkpoint, a torn record at the end is cut off
+//*****************************************************************************
+static void	ReplayLog(const uint64_t snapSeq)
+{
+unsigned char	*fileData;
+size_t			fileSize;
+size_t			offset;
+uint64_t		seq;
+int				recordLen;
+int				replayCnt;
+char			key[kSS_MaxKeyLen];
+char			value[kSS_MaxValueLen];
+
+	gSSseq		=	snapSeq;
+	gSSlogSize	=	0;
+	replayCnt	=	0;
+	if (ReadWholeFile(gSSlogPath, &fileData, &fileSize))
+	{
+		offset	=	0;
+		while (offset < fileSize)
+		{
+			recordLen	=	DecodeRecord(fileData + offset, fileSize - offset, &seq, key, value);
+			if (recordLen <= 0)
+			{
+				break;
+			}
+			if (seq > gSSseq)
+			{
+				SetEntry(key, value);
+				gSSseq	=	seq;
+				replayCnt++;
+			}
+			offset	+=	recordLen;
+		}
+		if (offset < fileSize)
+		{
+			CONSOLE_DEBUG_W_NUM("Dropping torn log record at offset", (int)offset);
+			if (truncate(gSSlogPath, offset) != 0)
+			{
+				CONSOLE_DEBUG_W_STR("truncate failed on", gSSlogPath);
+			}
+		}
+		gSSlogSize	=	offset;
+		free(fileData);
+	}
+	gSSdurableSeq	=	gSSseq;
+//	CONSOLE_DEBUG_W_NUM("replayCnt\t=", replayCnt);
+}
+
+//*****************************************************************************
+static void	SyncDirectory(void)
+{
+int		dirFileDesc;
+
+	dirFileDesc	=	open(gSSdirPath, O_RDONLY);
+	if (dirFileDesc >= 0)
+	{
+		fsync(dirFileDesc);
+		close(dirFileDesc);
+	}
+}
+
+//*****************************************************************************
+//*	writes gSSsnapTable to a temp file and renames it over the checkpoint
+//*****************************************************************************
+static bool	WriteSnapshot(const uint64_t seq)
+{
+TYPE_SS_SnapHdr	snapHdr;
+char			tempPath[280];
+int				fileDesc;
+size_t			offset;
+int				iii;
+bool			writeOK;
+
+	memset(&snapHdr, 0, sizeof(TYPE_SS_SnapHdr));
+	snapHdr.magic		=	kSS_SnapMagic;
+	snapHdr.version		=	kSS_Version;
+	snapHdr.seq			=	seq;
+	offset				=	sizeof(TYPE_SS_SnapHdr);
+	for (iii=0; iii<kSS_MaxEntries; iii++)
+	{
+		if (gSSsnapTable[iii].inUse)
+		{
+			offset	+=	EncodeRecord(gSSsnapBuff + offset, seq, gSSsnapTable[iii].key, gSSsnapTable[iii].value);
+			snapHdr.entryCnt++;
+		}
+	}
+	snapHdr.crc	=	CRC32((unsigned char *)&snapHdr, offsetof(TYPE_SS_SnapHdr, crc), 0);
+	memcpy(gSSsnapBuff, &snapHdr, sizeof(TYPE_SS_SnapHdr));
+
+	writeOK		=	false;
+	sprintf(tempPath, "%s.tmp", gSSsnapPath);
+	fileDesc	=	open(tempPath, (O_WRONLY | O_CREAT | O_TRUNC), 0644);
+	if (fileDesc >= 0)
+	{
+		if ((write(fileDesc, gSSsnapBuff, offset) == (ssize_t)offset) && (fsync(fileDesc) == 0))
+		{
+			writeOK	=	true;
+		}
+		close(fileDesc);
+		if (writeOK && (rename(tempPath, gSSsnapPath) == 0))
+		{
+			SyncDirectory();
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_STR("Failed to write checkpoint", tempPath);
+			unlink(tempPath);
+			writeOK	=	false;
+		}
+	}
+	else
+	{
+		CONSOLE_DEBUG_W_STR("Failed to create", tempPath);
+	}
+	return(writeOK);
+}
+
+//*****************************************************************************
+//*	returns true if all of it is on disk. If not, the log is cut back to the
+//*	last good record so a retry does not leave a torn record in the middle.
+//*****************************************************************************
+static bool	WriteLog(const unsigned char *buffer, const int writeLen)
+{
+ssize_t		bytesWritten;
+bool		writeOK;
+
+	writeOK			=	false;
+	bytesWritten	=	LOG_WRITE(gSSlogFileDesc, buffer, writeLen);
+	if (bytesWritten != writeLen)
+	{
+		CONSOLE_DEBUG_W_NUM("Short write to the state store log, bytesWritten\t=", (int)bytesWritten);
+	}
+	else if (LOG_FDATASYNC(gSSlogFileDesc) != 0)
+	{
+		CONSOLE_DEBUG_W_STR("fdatasync failed on", gSSlogPath);
+	}
+	else
+	{
+		gSSlogSize	+=	writeLen;
+		writeOK		=	true;
+	}
+	if ((writeOK == false) && (ftruncate(gSSlogFileDesc, gSSlogSize) != 0))
+	{
+		CONSOLE_DEBUG_W_STR("ftruncate failed on", gSSlogPath);
+	}
+	return(writeOK);
+}
+
+//*****************************************************************************
+static void	GetDeadline(struct timespec *deadline, const int delay_ms)
+{
+	clock_gettime(CLOCK_REALTIME, deadline);
+	deadline->tv_sec	+=	delay_ms / 1000;
+	deadline->tv_nsec	+=	(delay_ms % 1000) * 1000000L;
+	if (deadline->tv_nsec >= 1000000000L)
+	{
+		deadline->tv_nsec	-=	1000000000L;
+		deadline->tv_sec++;
+	}
+}
+
+//*****************************************************************************
+static void	*StateStore_FlushThread(void *arg)
+{
+struct timespec	deadline;
+int				writeLen;
+uint64_t		writeSeq;
+bool			needCheckpoint;
+bool			keepRunning;
+bool			writeOK;
+
+	keepRunning	=	true;
+	while (keepRunning)
+	{
+		pthread_mutex_lock(&gSSmutex);
+		while (gSSrunning && (gSSpendingLen == 0) && (gSSretryLen == 0))
+		{
+			pthread_cond_wait(&gSSwakeCond, &gSSmutex);
+		}
+		if (gSSrunning && (gSSretryLen > 0))
+		{
+			//*	the last write failed, give the disk a moment, a sync does not hurry this
+			GetDeadline(&deadline, kSS_RetryDelay_ms);
+			while (gSSrunning)
+			{
+				if (pthread_cond_timedwait(&gSSwakeCond, &gSSmutex, &deadline) != 0)
+				{
+					break;
+				}
+			}
+		}
+		else if (gSSrunning && (gSSsyncRequested == false))
+		{
+			//*	give other puts a moment to join this write
+			GetDeadline(&deadline, kSS_FlushDelay_ms);
+			while (gSSrunning && (gSSsyncRequested == false) && (gSSpendingLen < (kSS_PendingSize / 2)))
+			{
+				if (pthread_cond_timedwait(&gSSwakeCond, &gSSmutex, &deadline) != 0)
+				{
+					break;
+				}
+			}
+		}
+		keepRunning			=	gSSrunning;
+		gSSsyncRequested	=	false;
+		//*	anything that failed last time goes first, the new records after it
+		writeLen			=	gSSretryLen;
+		writeSeq			=	gSSretrySeq;
+		needCheckpoint		=	false;
+		if ((gSSretryLen + gSSpendingLen) <= (int)sizeof(gSSwriteBuff))
+		{
+			memcpy(gSSwriteBuff + gSSretryLen, gSSpendingBuff, gSSpendingLen);
+			writeLen		+=	gSSpendingLen;
+			writeSeq		=	gSSseq;
+			gSSpendingLen	=	0;
+			//*	the table matches writeSeq only when everything queued is in this write
+			needCheckpoint	=	((gSSlogSize + writeLen) >= kSS_MaxLogSize) || (keepRunning == false);
+			if (needCheckpoint)
+			{
+				memcpy(gSSsnapTable, gSStable, sizeof(gSSsnapTable));
+			}
+		}
+		pthread_mutex_unlock(&gSSmutex);
+
+		//*	the log first, so the data is safe even if the checkpoint fails
+		writeOK	=	true;
+		if (writeLen > 0)
+		{
+			writeOK	=	WriteLog(gSSwriteBuff, writeLen);
+		}
+		if (writeOK && needCheckpoint && (gSSlogSize > 0))
+		{
+			if (WriteSnapshot(writeSeq))
+			{
+				//*	if this does not make it to disk, the records are skipped by their seq
+				if ((ftruncate(gSSlogFileDesc, 0) == 0) && (fdatasync(gSSlogFileDesc) == 0))
+				{
+					gSSlogSize	=	0;
+				}
+				gSScheckpointCnt++;
+			}
+		}
+
+		pthread_mutex_lock(&gSSmutex);
+		if (writeOK)
+		{
+			gSSdurableSeq	=	writeSeq;
+			gSSretryLen		=	0;
+		}
+		else
+		{
+			gSSretryLen		=	writeLen;
+			gSSretrySeq		=	writeSeq;
+			gSSwriteFailCnt++;
+		}
+		pthread_cond_broadcast(&gSSdoneCond);
+		pthread_mutex_unlock(&gSSmutex);
+	}
+	return(arg);
+}
+
+//*****************************************************************************
+bool	StateStore_Open(const char *basePath)
+{
+char	*slashPtr;
+int		threadErr;
+
+	pthread_mutex_lock(&gSSmutex);
+	if (gSSisOpen == false)
+	{
+		sprintf(gSSlogPath,		"%s.wal",	basePath);
+		sprintf(gSSsnapPath,	"%s.snap",	basePath);
+		strcpy(gSSdirPath, basePath);
+		slashPtr	=	strrchr(gSSdirPath, '/');
+		if (slashPtr != NULL)
+		{
+			slashPtr[1]	=	0;
+		}
+		else
+		{
+			strcpy(gSSdirPath, ".");
+		}
+
+		memset(gSStable, 0, sizeof(gSStable));
+		gSSentryCnt		=	0;
+		gSSpendingLen	=	0;
+		gSSretryLen		=	0;
+		ReplayLog(LoadSnapshot());
+
+		gSSlogFileDesc	=	open(gSSlogPath, (O_WRONLY | O_CREAT | O_APPEND), 0644);
+		if (gSSlogFileDesc >= 0)
+		{
+			gSSrunning	=	true;
+			threadErr	=	pthread_create(&gSSthreadID, NULL, &StateStore_FlushThread, NULL);
+			if (threadErr == 0)
+			{
+				gSSisOpen	=	true;
+			}
+			else
+			{
+				CONSOLE_DEBUG_W_NUM("Failed to start flush thread, error", threadErr);
+				gSSrunning	=	false;
+				close(gSSlogFileDesc);
+				gSSlogFileDesc	=	-1;
+			}
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_STR("Failed to open", gSSlogPath);
+		}
+		gSSopenFailed	=	(gSSisOpen == false);
+	}
+	pthread_mutex_unlock(&gSSmutex);
+	return(gSSisOpen);
+}
+
+//*****************************************************************************
+//*	writes anything pending and a final checkpoint
+//*****************************************************************************
+void	StateStore_Close(void)
+{
+bool	wasOpen;
+
+	pthread_mutex_lock(&gSSmutex);
+	wasOpen		=	gSSisOpen;
+	gSSrunning	=	false;
+	pthread_cond_signal(&gSSwakeCond);
+	pthread_mutex_unlock(&gSSmutex);
+	if (wasOpen)
+	{
+		pthread_join(gSSthreadID, NULL);
+		close(gSSlogFileDesc);
+		gSSlogFileDesc	=	-1;
+		gSSisOpen		=	false;
+	}
+}
+
+//*****************************************************************************
+//*	a relative path is made absolute now, so it does not move if the
+//*	current directory changes before the store is opened
+//*****************************************************************************
+void	StateStore_SetFilePath(const char *basePath)
+{
+char	currentDir[PATH_MAX / 2];
+
+	if ((basePath[0] != '/') && (getcwd(currentDir, sizeof(currentDir)) != NULL))
+	{
+		snprintf(gSSfilePath, sizeof(gSSfilePath), "%s/%s", currentDir, basePath);
+	}
+	else
+	{
+		strncpy(gSSfilePath, basePath, (sizeof(gSSfilePath) - 1));
+		gSSfilePath[sizeof(gSSfilePath) - 1]	=	0;
+	}
+}
+
+//*****************************************************************************
+const char	*StateStore_GetFilePath(void)
+{
+	if (gSSfilePath[0] == 0)
+	{
+		StateStore_SetFilePath(kSS_FileName);
+	}
+	return(gSSfilePath);
+}
+
+//*****************************************************************************
+static bool	OpenIfNeeded(void)
+{
+	if ((gSSisOpen == false) && (gSSopenFailed == false))
+	{
+		StateStore_Open(StateStore_GetFilePath());
+	}
+	return(gSSisOpen);
+}
+
+//*****************************************************************************
+//*	returns right away, the value is on disk within kSS_FlushDelay_ms plus the
+//*	time for one write. Use StateStore_Sync() to wait for it.
+//*****************************************************************************
+bool	StateStore_Put(const char *key, const char *value)
+{
+bool	putOK;
+int		entryIdx;
+
+	if ((strlen(key) == 0) || (strlen(key) >= kSS_MaxKeyLen) || (strlen(value) >= kSS_MaxValueLen))
+	{
+		CONSOLE_DEBUG_W_STR("Invalid state store key/value for", key);
+		return(false);
+	}
+	if (OpenIfNeeded() == false)
+	{
+		return(false);
+	}
+	putOK	=	true;
+	pthread_mutex_lock(&gSSmutex);
+	//*	wait for room if the flush thread is behind
+	while (gSSrunning && ((gSSpendingLen + (int)kSS_MaxRecordSize) > kSS_PendingSize))
+	{
+		gSSsyncRequested	=	true;
+		pthread_cond_signal(&gSSwakeCond);
+		pthread_cond_wait(&gSSdoneCond, &gSSmutex);
+	}
+	entryIdx	=	FindEntry(key);
+	if ((entryIdx >= 0) && (strcmp(gSStable[entryIdx].value, value) == 0))
+	{
+		//*	nothing changed, nothing to write
+	}
+	else if (SetEntry(key, value))
+	{
+		gSSseq++;
+		gSSpendingLen	+=	EncodeRecord(gSSpendingBuff + gSSpendingLen, gSSseq, key, value);
+		pthread_cond_signal(&gSSwakeCond);
+	}
+	else
+	{
+		putOK	=	false;
+	}
+	pthread_mutex_unlock(&gSSmutex);
+	return(putOK);
+}
+
+//*****************************************************************************
+bool	StateStore_PutDouble(const char *key, const double value)
+{
+char	valueString[48];
+
+	sprintf(valueString, "%.17g", value);
+	return(StateStore_Put(key, valueString));
+}
+
+//*****************************************************************************
+bool	StateStore_Get(const char *key, char *value, const int maxLen)
+{
+int		entryIdx;
+bool	foundIt;
+
+	foundIt	=	false;
+	if (OpenIfNeeded())
+	{
+		pthread_mutex_lock(&gSSmutex);
+		entryIdx	=	FindEntry(key);
+		if (entryIdx >= 0)
+		{
+			strncpy(value, gSStable[entryIdx].value, maxLen - 1);
+			value[maxLen - 1]	=	0;
+			foundIt				=	true;
+		}
+		pthread_mutex_unlock(&gSSmutex);
+	}
+	return(foundIt);
+}
+
+//*****************************************************************************
+bool	StateStore_GetDouble(const char *key, double *value)
+{
+char	valueString[kSS_MaxValueLen];
+bool	foundIt;
+
+	foundIt	=	StateStore_Get(key, valueString, sizeof(valueString));
+	if (foundIt)
+	{
+		*value	=	atof(valueString);
+	}
+	return(foundIt);
+}
+
+//*****************************************************************************
+//*	waits until everything put so far is on disk,
+//*	returns false if a write failed on the way, the records are retried later
+//*****************************************************************************
+bool	StateStore_Sync(void)
+{
+uint64_t	targetSeq;
+uint32_t	writeFailCnt;
+
+	if (gSSisOpen == false)
+	{
+		return(false);
+	}
+	pthread_mutex_lock(&gSSmutex);
+	targetSeq		=	gSSseq;
+	writeFailCnt	=	gSSwriteFailCnt;
+	while (gSSrunning && (gSSdurableSeq < targetSeq) && (gSSwriteFailCnt == writeFailCnt))
+	{
+		gSSsyncRequested	=	true;
+		pthread_cond_signal(&gSSwakeCond);
+		pthread_cond_wait(&gSSdoneCond, &gSSmutex);
+	}
+	pthread_mutex_unlock(&gSSmutex);
+	return(gSSdurableSeq >= targetSeq);
+}
+
+//*****************************************************************************
+uint32_t	StateStore_GetCheckpointCount(void)
+{
+	return(gSScheckpointCnt);
+}
+
+//*****************************************************************************
+uint32_t	StateStore_GetWriteFailCount(void)
+{
+	return(gSSwriteFailCnt);
+}
+
+
+#ifdef _INCLUDE_STATE_STORE_MAIN_
+//*****************************************************************************
+//*	Kill at a random point test.
+//*	A child process writes as fast as it can and reports every value it got
+//*	back from StateStore_Sync() through a pipe. The parent kills it with SIGKILL
+//*	at a random time, sometimes adds garbage to the end of the log like a
+//*	write that was cut off, and then checks in a new process that:
+//*		- nothing that was reported as synced was lost
+//*		- the state is a prefix of what was written, never a mix
+//*		- every value is one that was written
+//*
+//*	Before that, each kind of log write failure is injected once (short write,
+//*	write error, fdatasync error) to check that Sync reports it, the log is cut
+//*	back to the last good record and the retry puts the record on disk.
+//*
+//*	gcc -O2 -D_INCLUDE_STATE_STORE_MAIN_ -I../libs/src_mlsLib state_store.c -lpthread -o statestoretest
+//*****************************************************************************
+#include	<signal.h>
+#include	<sys/wait.h>
+
+#define	kTestTrials		300
+#define	kTestKeys		40
+#define	kTestBasePath	"/tmp/statestore_test/alpacapi-state"
+#define	kTestFaultPath	"/tmp/statestore_test/fault-state"
+
+enum
+{
+	kFault_None	=	0,
+	kFault_ShortWrite,
+	kFault_WriteError,
+	kFault_Fsync,
+
+	kFault_Last
+};
+
+static volatile int	gTestFault	=	kFault_None;
+
+//*****************************************************************************
+static ssize_t	Test_write(int fileDesc, const void *buffer, size_t count)
+{
+	switch(gTestFault)
+	{
+		case kFault_ShortWrite:
+			return(write(fileDesc, buffer, count / 2));
+
+		case kFault_WriteError:
+			errno	=	ENOSPC;
+			return(-1);
+	}
+	return(write(fileDesc, buffer, count));
+}
+
+//*****************************************************************************
+static int	Test_fdatasync(int fileDesc)
+{
+	if (gTestFault == kFault_Fsync)
+	{
+		errno	=	EIO;
+		return(-1);
+	}
+	return(fdatasync(fileDesc));
+}
+
+//*****************************************************************************
+//*	returns the size of the log, -1 if anything in it is not a whole record
+//*****************************************************************************
+static long	CheckLogFile(void)
+{
+unsigned char	*fileData;
+size_t			fileSize;
+size_t			offset;
+uint64_t		seq;
+int				recordLen;
+char			key[kSS_MaxKeyLen];
+char			value[kSS_MaxValueLen];
+
+	if (ReadWholeFile(gSSlogPath, &fileData, &fileSize) == false)
+	{
+		return(0);
+	}
+	offset	=	0;
+	while (offset < fileSize)
+	{
+		recordLen	=	DecodeRecord(fileData + offset, fileSize - offset, &seq, key, value);
+		if (recordLen <= 0)
+		{
+			break;
+		}
+		offset	+=	recordLen;
+	}
+	free(fileData);
+	return((offset == fileSize) ? (long)fileSize : -1);
+}
+
+//*****************************************************************************
+static int	FaultInjection_Test(void)
+{
+const char		*faultName[]	=	{"", "short write", "write error", "fdatasync error"};
+unsigned char	recordBuff[kSS_MaxRecordSize];
+int				faultType;
+int				errorCnt;
+int				errorsBefore;
+long			logSizeBefore;
+long			logSizeAfter;
+long			recordLen;
+uint32_t		writeFailCnt;
+char			valueString[64];
+
+	errorCnt	=	0;
+	for (faultType=kFault_ShortWrite; faultType<kFault_Last; faultType++)
+	{
+		errorsBefore	=	errorCnt;
+		unlink(kTestFaultPath ".wal");
+		unlink(kTestFaultPath ".snap");
+		StateStore_Open(kTestFaultPath);
+		StateStore_Put("good", "1");
+		if (StateStore_Sync() == false)
+		{
+			printf("%s: sync failed without a fault\r\n", faultName[faultType]);
+			errorCnt++;
+		}
+		logSizeBefore	=	CheckLogFile();
+		writeFailCnt	=	StateStore_GetWriteFailCount();
+
+		gTestFault	=	faultType;
+		StateStore_Put("bad", "2");
+		if (StateStore_Sync())
+		{
+			printf("%s: sync did not report the failure\r\n", faultName[faultType]);
+			errorCnt++;
+		}
+		if ((StateStore_GetWriteFailCount() == writeFailCnt) || (CheckLogFile() != logSizeBefore))
+		{
+			printf("%s: log was not cut back to %ld bytes, it is %ld\r\n", faultName[faultType], logSizeBefore, CheckLogFile());
+			errorCnt++;
+		}
+
+		//*	the disk is back, the record has to make it on the retry
+		gTestFault	=	kFault_None;
+		if (StateStore_Sync() == false)
+		{
+			printf("%s: retry did not sync\r\n", faultName[faultType]);
+			errorCnt++;
+		}
+		recordLen		=	EncodeRecord(recordBuff, 0, "bad", "2");
+		logSizeAfter	=	CheckLogFile();
+		if (logSizeAfter != (logSizeBefore + recordLen))
+		{
+			printf("%s: log is %ld bytes after the retry, expected %ld\r\n", faultName[faultType], logSizeAfter, logSizeBefore + recordLen);
+			errorCnt++;
+		}
+		StateStore_Close();
+
+		StateStore_Open(kTestFaultPath);
+		if ((StateStore_Get("bad", valueString, sizeof(valueString)) == false) || (strcmp(valueString, "2") != 0))
+		{
+			printf("%s: value lost after the retry\r\n", faultName[faultType]);
+			errorCnt++;
+		}
+		StateStore_Close();
+		printf("Fault %-16s = %s\r\n", faultName[faultType], (errorCnt == errorsBefore) ? "ok" : "FAILED");
+	}
+	return(errorCnt);
+}
+
+//*****************************************************************************
+static long	GetCounter(void)
+{
+double	counter;
+
+	if (StateStore_GetDouble("counter", &counter))
+	{
+		return((long)counter);
+	}
+	return(0);
+}
+
+//*****************************************************************************
+//*	keeps writing until it is killed, counter first, then name, then one of the keys
+//*****************************************************************************
+static void	Writer(const int pipeFD)
+{
+long	counter;
+char	keyString[32];
+char	valueString[64];
+
+	StateStore_Open(kTestBasePath);
+	counter	=	GetCounter();
+	while (true)
+	{
+		counter++;
+		StateStore_PutDouble("counter", counter);
+		sprintf(valueString, "Roof power %ld", counter);
+		StateStore_Put("switch0.name", valueString);
+		sprintf(keyString, "switch0.%ld.value", counter % kTestKeys);
+		StateStore_PutDouble(keyString, counter);
+		if ((rand() % 4) == 0)
+		{
+			StateStore_Sync();
+			if (write(pipeFD, &counter, sizeof(counter)) != sizeof(counter))
+			{
+				break;
+			}
+		}
+	}
+	exit(0);
+}
+
+//*****************************************************************************
+//*	exit status 0 if the store is good
+//*****************************************************************************
+static int	Verify(const long lastSynced)
+{
+long	counter;
+long	nameNumber;
+double	value;
+char	keyString[32];
+char	valueString[64];
+int		iii;
+int		errorCnt;
+
+	errorCnt	=	0;
+	StateStore_Open(kTestBasePath);
+	counter		=	GetCounter();
+	if (counter < lastSynced)
+	{
+		printf("LOST DATA: counter=%ld, last synced=%ld\r\n", counter, lastSynced);
+		errorCnt++;
+	}
+	//*	the name is written right after the counter
+	if (StateStore_Get("switch0.name", valueString, sizeof(valueString)))
+	{
+		nameNumber	=	atol(valueString + strlen("Roof power "));
+		if ((nameNumber != counter) && (nameNumber != (counter - 1)))
+		{
+			printf("NOT A PREFIX: counter=%ld, name=%s\r\n", counter, valueString);
+			errorCnt++;
+		}
+	}
+	//*	every key holds the last counter value that maps to it
+	for (iii=0; iii<kTestKeys; iii++)
+	{
+		sprintf(keyString, "switch0.%d.value", iii);
+		if (StateStore_GetDouble(keyString, &value))
+		{
+			if ((((long)value % kTestKeys) != iii) || ((long)value > counter) || ((long)value < (counter - kTestKeys)))
+			{
+				printf("BAD VALUE: %s=%f, counter=%ld\r\n", keyString, value, counter);
+				errorCnt++;
+			}
+		}
+	}
+	StateStore_Close();
+	return(errorCnt == 0 ? 0 : 1);
+}
+
+//*****************************************************************************
+static long	RunVerifier(const long lastSynced)
+{
+pid_t	childPID;
+int		childStatus;
+
+	childPID	=	fork();
+	if (childPID == 0)
+	{
+		exit(Verify(lastSynced));
+	}
+	waitpid(childPID, &childStatus, 0);
+	return(WIFEXITED(childStatus) ? WEXITSTATUS(childStatus) : 1);
+}
+
+//*****************************************************************************
+int main(int argc, char *argv[])
+{
+int		pipeFDs[2];
+pid_t	childPID;
+long	lastSynced;
+long	syncedValue;
+long	maxSynced;
+int		trial;
+int		failCnt;
+int		tornCnt;
+int		fileDesc;
+int		iii;
+unsigned char	garbage[64];
+char	logPath[256];
+
+	(void)argc;
+	(void)argv;
+	if (system("rm -rf /tmp/statestore_test; mkdir -p /tmp/statestore_test") != 0)
+	{
+		return(1);
+	}
+	sprintf(logPath, "%s.wal", kTestBasePath);
+	srand(time(NULL));
+	failCnt		=	FaultInjection_Test();
+	//*	or the children print it again when they exit
+	fflush(stdout);
+	tornCnt		=	0;
+	maxSynced	=	0;
+	for (trial=0; trial<kTestTrials; trial++)
+	{
+		if (pipe(pipeFDs) != 0)
+		{
+			return(1);
+		}
+		childPID	=	fork();
+		if (childPID == 0)
+		{
+			close(pipeFDs[0]);
+			srand(getpid());
+			Writer(pipeFDs[1]);
+		}
+		close(pipeFDs[1]);
+		usleep(1000 + (rand() % 60000));
+		kill(childPID, SIGKILL);
+		waitpid(childPID, NULL, 0);
+
+		lastSynced	=	maxSynced;
+		while (read(pipeFDs[0], &syncedValue, sizeof(syncedValue)) == sizeof(syncedValue))
+		{
+			lastSynced	=	syncedValue;
+		}
+		close(pipeFDs[0]);
+		maxSynced	=	lastSynced;
+
+		//*	half of the time, a partial record at the end of the log
+		if ((rand() % 2) == 0)
+		{
+			for (iii=0; iii<(int)sizeof(garbage); iii++)
+			{
+				garbage[iii]	=	rand();
+			}
+			//*	sometimes it starts like a real record
+			*(uint32_t *)garbage	=	((rand() % 2) == 0) ? kSS_RecordMagic : *(uint32_t *)garbage;
+			fileDesc	=	open(logPath, (O_WRONLY | O_APPEND));
+			if (fileDesc >= 0)
+			{
+				if (write(fileDesc, garbage, 1 + (rand() % sizeof(garbage))) > 0)
+				{
+					tornCnt++;
+				}
+				close(fileDesc);
+			}
+		}
+		if (RunVerifier(lastSynced) != 0)
+		{
+			failCnt++;
+		}
+	}
+	StateStore_Open(kTestBasePath);
+	printf("Trials               = %d\r\n",	kTestTrials);
+	printf("Torn log tails added = %d\r\n",	tornCnt);
+	printf("Final counter        = %ld (last synced %ld)\r\n",	GetCounter(), maxSynced);
+	printf("Failures = %d\r\n",	failCnt);
+	StateStore_Close();
+	return(failCnt == 0 ? 0 : 1);
+}
+#endif // _INCLUDE_STATE_STORE_MAIN_
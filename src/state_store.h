@@ -0,0 +1,44 @@
+//*****************************************************************************
+//#include	"state_store.h"
+
+#ifndef _STATE_STORE_H_
+#define	_STATE_STORE_H_
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define	kSS_FileName			"alpacapi-state"	//*	.wal and .snap are added
+#define	kSS_MaxEntries			256
+#define	kSS_MaxKeyLen			64
+#define	kSS_MaxValueLen			256
+#define	kSS_FlushDelay_ms		20			//*	puts within this time go out in one write
+#define	kSS_MaxLogSize			(64 * 1024)	//*	checkpoint when the log gets this big
+#define	kSS_RetryDelay_ms		1000		//*	wait this long after a failed write before trying again
+
+
+void		StateStore_SetFilePath(const char *basePath);
+const char	*StateStore_GetFilePath(void);
+bool		StateStore_Open(const char *basePath);
+void		StateStore_Close(void);
+bool		StateStore_Put(const char *key, const char *value);
+bool		StateStore_PutDouble(const char *key, const double value);
+bool		StateStore_Get(const char *key, char *value, const int maxLen);
+bool		StateStore_GetDouble(const char *key, double *value);
+bool		StateStore_Sync(void);
+uint32_t	StateStore_GetCheckpointCount(void);
+uint32_t	StateStore_GetWriteFailCount(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _STATE_STORE_H_
@@ -0,0 +1,1150 @@
+//*****************************************************************************
+//*	Name:			static_files.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Sends static files (images, html, js, css) to a socket
+//*
+//*	The file data goes out with sendfile(), it never gets copied into user space.
+//*	Every response has Content-Type, Content-Length, Last-Modified and ETag.
+//*	Browsers and dashboards that refresh the latest image send the ETag back in
+//*	If-None-Match (or the date in If-Modified-Since), if the file has not changed
+//*	they get a 304 with no body.
+//*
+//*	The ETag and date strings are kept in a small cache, they only get rebuilt
+//*	when stat() says the file has changed.
+//*
+//*	Range requests (single and multiple ranges) get a 206, so a download that
+//*	drops half way can be resumed and a big file can be fetched in parallel
+//*	pieces. If-Range makes sure the pieces all come from the same file (ETag),
+//*	if it has changed the whole new file is sent. StaticFile_SendBuffer() does
+//*	the same for data that is in memory (imagearray).
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Re-distributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 18,	2026	<MLS> Created static_files.c
+//*	Oct 18,	2026	<MLS> Added If-None-Match / If-Modified-Since, 304 response
+//*	Oct 18,	2026	<MLS> Added loopback benchmark (_INCLUDE_STATIC_FILES_MAIN_)
+//*	Oct 18,	2026	<MLS> Added Range / If-Range / If-Match, 206 and 416 responses
+//*	Oct 18,	2026	<MLS> Added StaticFile_SendBuffer()
+//*	Oct 18,	2026	<MLS> A body that was not completely sent returns kSF_ShortSend
+//*	Oct 18,	2026	<MLS> _GNU_SOURCE for strptime() when built with gcc
+//*****************************************************************************
+
+//*	strptime() is not declared by a plain gcc build without it
+#ifndef _GNU_SOURCE
+	#define	_GNU_SOURCE
+#endif
+
+#include	<stdbool.h>
+#include	<stdint.h>
+#include	<stdio.h>
+#include	<stdlib.h>
+#include	<string.h>
+#include	<strings.h>
+#include	<time.h>
+#include	<errno.h>
+#include	<fcntl.h>
+#include	<unistd.h>
+#include	<pthread.h>
+#include	<sys/stat.h>
+#include	<sys/types.h>
+#include	<sys/sendfile.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"static_files.h"
+
+static TYPE_STATIC_FILE_INFO	gFileInfoCache[kSF_MaxCacheEntries];
+static uint32_t					gFileInfoUseCntr	=	0;
+static pthread_mutex_t			gFileInfoMutex		=	PTHREAD_MUTEX_INITIALIZER;
+
+#define	kSF_Boundary	"AlpacaPi_byteranges"
+
+//*****************************************************************************
+//*	what is being sent, either an open file or a block of memory
+typedef struct
+{
+	int			fileDesc;			//*	-1 if the data is in memory
+	const char	*dataPtr;
+	int64_t		dataLen;
+	const char	*contentType;
+	const char	*eTag;
+	const char	*lastModified;		//*	can be NULL
+	const char	*extraHeaders;		//*	can be NULL, each line ends with \r\n
+} TYPE_SF_BODY;
+
+//*****************************************************************************
+typedef struct
+{
+	const char	*extension;
+	const char	*contentType;
+} TYPE_CONTENT_TYPE;
+
+static const TYPE_CONTENT_TYPE	gContentTypes[]	=
+{
+	{	".jpg",		"image/jpeg"				},
+	{	".jpeg",	"image/jpeg"				},
+	{	".png",		"image/png"					},
+	{	".gif",		"image/gif"					},
+	{	".ico",		"image/x-icon"				},
+	{	".svg",		"image/svg+xml"				},
+	{	".html",	"text/html"					},
+	{	".htm",		"text/html"					},
+	{	".css",		"text/css"					},
+	{	".js",		"text/javascript"			},
+	{	".json",	"application/json"			},
+	{	".txt",		"text/plain"				},
+	{	".csv",		"text/csv"					},
+	{	".fits",	"application/fits"			},
+	{	".fit",		"application/fits"			},
+	{	".pdf",		"application/pdf"			},
+	{	NULL,		NULL						}
+};
+
+//*****************************************************************************
+const char	*StaticFile_GetContentType(const char *filePath)
+{
+const char	*extPtr;
+int			iii;
+
+	extPtr	=	strrchr(filePath, '.');
+	if (extPtr != NULL)
+	{
+		iii	=	0;
+		while (gContentTypes[iii].extension != NULL)
+		{
+			if (strcasecmp(extPtr, gContentTypes[iii].extension) == 0)
+			{
+				return(gContentTypes[iii].contentType);
+			}
+			iii++;
+		}
+	}
+	return("application/octet-stream");
+}
+
+//*****************************************************************************
+static void	FormatHttpDate(const time_t theTime, char *dateString)
+{
+struct tm	gmTime;
+
+	gmtime_r(&theTime, &gmTime);
+	strftime(dateString, kSF_HttpDateLen, "%a, %d %b %Y %H:%M:%S GMT", &gmTime);
+}
+
+//*****************************************************************************
+//*	returns -1 if it is not a valid HTTP date
+//*****************************************************************************
+static time_t	ParseHttpDate(const char *dateString)
+{
+struct tm	gmTime;
+char		*endPtr;
+
+	memset(&gmTime, 0, sizeof(struct tm));
+	endPtr	=	strptime(dateString, "%a, %d %b %Y %H:%M:%S GMT", &gmTime);
+	if (endPtr == NULL)
+	{
+		return(-1);
+	}
+	return(timegm(&gmTime));
+}
+
+//*****************************************************************************
+//*	finds "fieldName:" at the start of a header line, case does not matter
+//*****************************************************************************
+bool	StaticFile_GetHeaderValue(const char *httpRequest, const char *fieldName, char *value, const int maxLen)
+{
+const char	*linePtr;
+int			fieldLen;
+int			ccc;
+
+	value[0]	=	0;
+	if (httpRequest == NULL)
+	{
+		return(false);
+	}
+	fieldLen	=	strlen(fieldName);
+	linePtr		=	strchr(httpRequest, '\n');
+	while (linePtr != NULL)
+	{
+		linePtr++;
+		if ((*linePtr == '\r') || (*linePtr == '\n') || (*linePtr == 0))
+		{
+			break;		//*	end of the headers
+		}
+		if ((strncasecmp(linePtr, fieldName, fieldLen) == 0) && (linePtr[fieldLen] == ':'))
+		{
+			linePtr	+=	fieldLen + 1;
+			while (*linePtr == 0x20)
+			{
+				linePtr++;
+			}
+			ccc	=	0;
+			while ((linePtr[ccc] >= 0x20) && (ccc < (maxLen - 1)))
+			{
+				value[ccc]	=	linePtr[ccc];
+				ccc++;
+			}
+			value[ccc]	=	0;
+			return(true);
+		}
+		linePtr	=	strchr(linePtr, '\n');
+	}
+	return(false);
+}
+
+//*****************************************************************************
+//*	If-None-Match can have a list of tags, or "*"
+//*	weak compare, W/ is ignored
+//*****************************************************************************
+static bool	ETagMatches(const char *ifNoneMatch, const char *eTag)
+{
+const char	*tagPtr;
+int			tagLen;
+
+	if (strcmp(ifNoneMatch, "*") == 0)
+	{
+		return(true);
+	}
+	tagLen	=	strlen(eTag);
+	tagPtr	=	strstr(ifNoneMatch, eTag);
+	while (tagPtr != NULL)
+	{
+		if ((tagPtr[tagLen] == 0) || (tagPtr[tagLen] == ',') || (tagPtr[tagLen] == 0x20))
+		{
+			return(true);
+		}
+		tagPtr	=	strstr(tagPtr + 1, eTag);
+	}
+	return(false);
+}
+
+//*****************************************************************************
+//*	returns the cached strings, rebuilds them if the file changed
+//*****************************************************************************
+static bool	GetCachedInfo(const char *filePath, const struct stat *statPtr, TYPE_STATIC_FILE_INFO *fileInfo)
+{
+TYPE_STATIC_FILE_INFO	*cacheEntry;
+int						iii;
+int						oldestIdx;
+
+	if ((statPtr->st_mode & S_IFMT) != S_IFREG)
+	{
+		return(false);
+	}
+	if (strlen(filePath) >= kSF_MaxPathLen)
+	{
+		CONSOLE_DEBUG_W_STR("Path too long to cache:", filePath);
+		return(false);
+	}
+
+	pthread_mutex_lock(&gFileInfoMutex);
+	gFileInfoUseCntr++;
+	cacheEntry	=	NULL;
+	oldestIdx	=	0;
+	for (iii=0; iii<kSF_MaxCacheEntries; iii++)
+	{
+		if (strcmp(gFileInfoCache[iii].filePath, filePath) == 0)
+		{
+			cacheEntry	=	&gFileInfoCache[iii];
+			break;
+		}
+		if (gFileInfoCache[iii].lastUsed < gFileInfoCache[oldestIdx].lastUsed)
+		{
+			oldestIdx	=	iii;
+		}
+	}
+	if (cacheEntry == NULL)
+	{
+		cacheEntry				=	&gFileInfoCache[oldestIdx];
+		strcpy(cacheEntry->filePath, filePath);
+		cacheEntry->inode		=	0;
+		cacheEntry->eTag[0]		=	0;
+		cacheEntry->contentType	=	StaticFile_GetContentType(filePath);
+	}
+
+	//*	the camera writes a new image with the same name, check everything
+	if ((cacheEntry->eTag[0] == 0)							||
+		(cacheEntry->inode			!= statPtr->st_ino)	||
+		(cacheEntry->fileSize		!= statPtr->st_size)	||
+		(cacheEntry->modTime_secs	!= statPtr->st_mtim.tv_sec) ||
+		(cacheEntry->modTime_nsecs	!= statPtr->st_mtim.tv_nsec))
+	{
+		cacheEntry->inode			=	statPtr->st_ino;
+		cacheEntry->fileSize		=	statPtr->st_size;
+		cacheEntry->modTime_secs	=	statPtr->st_mtim.tv_sec;
+		cacheEntry->modTime_nsecs	=	statPtr->st_mtim.tv_nsec;
+		snprintf(cacheEntry->eTag, kSF_ETagLen, "\"%lx-%llx-%llx\"",
+											(unsigned long)statPtr->st_ino,
+											(unsigned long long)statPtr->st_size,
+											((unsigned long long)statPtr->st_mtim.tv_sec * 1000000000ULL) + statPtr->st_mtim.tv_nsec);
+		FormatHttpDate(statPtr->st_mtim.tv_sec, cacheEntry->lastModified);
+	}
+	cacheEntry->lastUsed	=	gFileInfoUseCntr;
+	*fileInfo				=	*cacheEntry;
+	pthread_mutex_unlock(&gFileInfoMutex);
+	return(true);
+}
+
+//*****************************************************************************
+//*	stat()s the file and returns the cached strings
+//*****************************************************************************
+bool	StaticFile_GetInfo(const char *filePath, TYPE_STATIC_FILE_INFO *fileInfo)
+{
+struct stat		fileStatus;
+
+	if (stat(filePath, &fileStatus) != 0)
+	{
+		return(false);
+	}
+	return(GetCachedInfo(filePath, &fileStatus, fileInfo));
+}
+
+//*****************************************************************************
+//*	returns the number of bytes sent
+//*****************************************************************************
+int64_t	StaticFile_SendFileData(const int socket, const int fileDesc, off_t offset, int64_t byteCount)
+{
+int64_t		totalBytesSent;
+ssize_t		bytesSent;
+
+	totalBytesSent	=	0;
+	while (byteCount > 0)
+	{
+		bytesSent	=	sendfile(socket, fileDesc, &offset, byteCount);
+		if (bytesSent > 0)
+		{
+			totalBytesSent	+=	bytesSent;
+			byteCount		-=	bytesSent;
+		}
+		else if ((bytesSent < 0) && (errno == EINTR))
+		{
+			continue;
+		}
+		else
+		{
+			if (bytesSent < 0)
+			{
+				CONSOLE_DEBUG_W_STR("sendfile failed:", strerror(errno));
+			}
+			break;
+		}
+	}
+	return(totalBytesSent);
+}
+
+//*****************************************************************************
+static int64_t	WriteData(const int socket, const void *dataPtr, const int64_t dataLen)
+{
+ssize_t		bytesWritten;
+int64_t		totalWritten;
+
+	totalWritten	=	0;
+	while (totalWritten < dataLen)
+	{
+		bytesWritten	=	write(socket, ((const char *)dataPtr + totalWritten), (dataLen - totalWritten));
+		if (bytesWritten <= 0)
+		{
+			if ((bytesWritten < 0) && (errno == EINTR))
+			{
+				continue;
+			}
+			break;
+		}
+		totalWritten	+=	bytesWritten;
+	}
+	return(totalWritten);
+}
+
+//*****************************************************************************
+//*	Range: bytes=0-499,1000-,-500
+//*	returns	the number of ranges
+//*			0 if the header should be ignored (bad syntax or too many ranges),
+//*				the whole thing gets sent
+//*			-1 if none of the ranges are inside the data (416)
+//*****************************************************************************
+int	StaticFile_ParseRange(const char *rangeHeader, const int64_t totalLen, TYPE_BYTE_RANGE *ranges, const int maxRanges)
+{
+const char	*charPtr;
+char		*endPtr;
+int64_t		firstByte;
+int64_t		lastByte;
+int			rangeCnt;
+bool		specFound;
+
+	if (strncasecmp(rangeHeader, "bytes=", 6) != 0)
+	{
+		return(0);
+	}
+	rangeCnt	=	0;
+	specFound	=	false;
+	charPtr		=	rangeHeader + 6;
+	while (*charPtr != 0)
+	{
+		while ((*charPtr == 0x20) || (*charPtr == ','))
+		{
+			charPtr++;
+		}
+		if (*charPtr == 0)
+		{
+			break;
+		}
+		if (*charPtr == '-')
+		{
+			//*	suffix, the last N bytes
+			lastByte	=	strtoll(charPtr + 1, &endPtr, 10);
+			if ((endPtr == (charPtr + 1)) || (lastByte < 0))
+			{
+				return(0);
+			}
+			firstByte	=	totalLen - lastByte;
+			if (firstByte < 0)
+			{
+				firstByte	=	0;
+			}
+			lastByte	=	(lastByte > 0) ? (totalLen - 1) : -1;
+		}
+		else
+		{
+			firstByte	=	strtoll(charPtr, &endPtr, 10);
+			if ((endPtr == charPtr) || (*endPtr != '-') || (firstByte < 0))
+			{
+				return(0);
+			}
+			charPtr		=	endPtr + 1;
+			lastByte	=	strtoll(charPtr, &endPtr, 10);
+			if (endPtr == charPtr)
+			{
+				lastByte	=	totalLen - 1;		//*	open ended
+			}
+			else if (lastByte < firstByte)
+			{
+				return(0);
+			}
+			if (lastByte >= totalLen)
+			{
+				lastByte	=	totalLen - 1;
+			}
+		}
+		if ((*endPtr != 0) && (*endPtr != ',') && (*endPtr != 0x20))
+		{
+			return(0);
+		}
+		charPtr		=	endPtr;
+		specFound	=	true;
+
+		//*	ranges that start past the end are dropped
+		if ((firstByte < totalLen) && (lastByte >= firstByte))
+		{
+			if (rangeCnt >= maxRanges)
+			{
+				return(0);
+			}
+			ranges[rangeCnt].firstByte	=	firstByte;
+			ranges[rangeCnt].lastByte	=	lastByte;
+			rangeCnt++;
+		}
+	}
+	if (specFound == false)
+	{
+		return(0);
+	}
+	return((rangeCnt > 0) ? rangeCnt : -1);
+}
+
+//*****************************************************************************
+static int64_t	SendBodyData(const int socket, const TYPE_SF_BODY *body, const int64_t offset, const int64_t byteCount)
+{
+	if (body->fileDesc >= 0)
+	{
+		return(StaticFile_SendFileData(socket, body->fileDesc, offset, byteCount));
+	}
+	return(WriteData(socket, body->dataPtr + offset, byteCount));
+}
+
+//*****************************************************************************
+static int	FormatPartHeader(char *partHeader, const int maxLen, const TYPE_SF_BODY *body, const TYPE_BYTE_RANGE *range)
+{
+	return(snprintf(partHeader, maxLen,	"\r\n--" kSF_Boundary "\r\n"
+										"Content-Type: %s\r\n"
+										"Content-Range: bytes %lld-%lld/%lld\r\n"
+										"\r\n",
+										body->contentType,
+										(long long)range->firstByte,
+										(long long)range->lastByte,
+										(long long)body->dataLen));
+}
+
+//*****************************************************************************
+//*	everything after the 304 check, 200, 206, 412 or 416
+//*	returns the HTTP status that was sent
+//*****************************************************************************
+static int	SendBody(const int socket, const TYPE_SF_BODY *body, const char *httpRequest)
+{
+TYPE_BYTE_RANGE	ranges[kSF_MaxRanges];
+char			httpHeader[1024];
+char			partHeader[256];
+char			headerValue[256];
+char			commonHeaders[512];
+int				headerLen;
+int				rangeCnt;
+int				iii;
+int				statusCode;
+int64_t			contentLen;
+int64_t			bytesSent;
+
+	//*	these go in every response
+	snprintf(commonHeaders, sizeof(commonHeaders),	"%s%s%s"
+													"ETag: %s\r\n"
+													"Accept-Ranges: bytes\r\n"
+													"Cache-Control: no-cache\r\n"
+													"Access-Control-Allow-Origin: *\r\n"
+													"%s"
+													"Connection: close\r\n"
+													"\r\n",
+													((body->lastModified != NULL) ? "Last-Modified: " : ""),
+													((body->lastModified != NULL) ? body->lastModified : ""),
+													((body->lastModified != NULL) ? "\r\n" : ""),
+													body->eTag,
+													((body->extraHeaders != NULL) ? body->extraHeaders : ""));
+
+	//*	If-Match, the client only wants this exact version
+	if (StaticFile_GetHeaderValue(httpRequest, "If-Match", headerValue, sizeof(headerValue)) &&
+		(ETagMatches(headerValue, body->eTag) == false))
+	{
+		headerLen	=	snprintf(httpHeader, sizeof(httpHeader),	"HTTP/1.0 412 Precondition Failed\r\n"
+																	"Content-Length: 0\r\n"
+																	"%s",
+																	commonHeaders);
+		WriteData(socket, httpHeader, headerLen);
+		return(412);
+	}
+
+	rangeCnt	=	0;
+	if (StaticFile_GetHeaderValue(httpRequest, "Range", headerValue, sizeof(headerValue)))
+	{
+		rangeCnt	=	StaticFile_ParseRange(headerValue, body->dataLen, ranges, kSF_MaxRanges);
+
+		//*	If-Range, if it has changed they get the whole new one (RFC 7233 3.2)
+		//*	ETags have to match exactly, dates have to be the same string
+		if ((rangeCnt != 0) && StaticFile_GetHeaderValue(httpRequest, "If-Range", headerValue, sizeof(headerValue)))
+		{
+			if (headerValue[0] == '"')
+			{
+				if (strcmp(headerValue, body->eTag) != 0)
+				{
+					rangeCnt	=	0;
+				}
+			}
+			else if ((body->lastModified == NULL) || (strcmp(headerValue, body->lastModified) != 0))
+			{
+				rangeCnt	=	0;
+			}
+		}
+	}
+
+	if (rangeCnt < 0)
+	{
+		headerLen	=	snprintf(httpHeader, sizeof(httpHeader),	"HTTP/1.0 416 Range Not Satisfiable\r\n"
+																	"Content-Range: bytes */%lld\r\n"
+																	"Content-Length: 0\r\n"
+																	"%s",
+																	(long long)body->dataLen,
+																	commonHeaders);
+		WriteData(socket, httpHeader, headerLen);
+		return(416);
+	}
+
+	bytesSent	=	0;
+	if (rangeCnt == 0)
+	{
+		//*	no-cache means the browser can keep it but has to ask (and get a 304)
+		statusCode	=	200;
+		contentLen	=	body->dataLen;
+		headerLen	=	snprintf(httpHeader, sizeof(httpHeader),	"HTTP/1.0 200 OK\r\n"
+																	"Content-Type: %s\r\n"
+																	"Content-Length: %lld\r\n"
+																	"%s",
+																	body->contentType,
+																	(long long)contentLen,
+																	commonHeaders);
+		WriteData(socket, httpHeader, headerLen);
+		bytesSent	=	SendBodyData(socket, body, 0, contentLen);
+	}
+	else if (rangeCnt == 1)
+	{
+		statusCode	=	206;
+		contentLen	=	ranges[0].lastByte - ranges[0].firstByte + 1;
+		headerLen	=	snprintf(httpHeader, sizeof(httpHeader),	"HTTP/1.0 206 Partial Content\r\n"
+																	"Content-Type: %s\r\n"
+																	"Content-Range: bytes %lld-%lld/%lld\r\n"
+																	"Content-Length: %lld\r\n"
+																	"%s",
+																	body->contentType,
+																	(long long)ranges[0].firstByte,
+																	(long long)ranges[0].lastByte,
+																	(long long)body->dataLen,
+																	(long long)contentLen,
+																	commonHeaders);
+		WriteData(socket, httpHeader, headerLen);
+		bytesSent	=	SendBodyData(socket, body, ranges[0].firstByte, contentLen);
+	}
+	else
+	{
+		//*	multipart/byteranges, the length has to be worked out before anything is sent
+		statusCode	=	206;
+		contentLen	=	strlen("\r\n--" kSF_Boundary "--\r\n");
+		for (iii=0; iii<rangeCnt; iii++)
+		{
+			contentLen	+=	FormatPartHeader(partHeader, sizeof(partHeader), body, &ranges[iii]);
+			contentLen	+=	ranges[iii].lastByte - ranges[iii].firstByte + 1;
+		}
+		headerLen	=	snprintf(httpHeader, sizeof(httpHeader),	"HTTP/1.0 206 Partial Content\r\n"
+																	"Content-Type: multipart/byteranges; boundary=" kSF_Boundary "\r\n"
+																	"Content-Length: %lld\r\n"
+																	"%s",
+																	(long long)contentLen,
+																	commonHeaders);
+		WriteData(socket, httpHeader, headerLen);
+		for (iii=0; iii<rangeCnt; iii++)
+		{
+			headerLen	=	FormatPartHeader(partHeader, sizeof(partHeader), body, &ranges[iii]);
+			bytesSent	+=	WriteData(socket, partHeader, headerLen);
+			bytesSent	+=	SendBodyData(socket, body, ranges[iii].firstByte, (ranges[iii].lastByte - ranges[iii].firstByte + 1));
+		}
+		bytesSent	+=	WriteData(socket, "\r\n--" kSF_Boundary "--\r\n", strlen("\r\n--" kSF_Boundary "--\r\n"));
+	}
+	if (bytesSent != contentLen)
+	{
+		CONSOLE_DEBUG("Short send");
+		statusCode	=	kSF_ShortSend;
+	}
+	return(statusCode);
+}
+
+//*****************************************************************************
+//*	httpRequest is the whole request with the headers, can be NULL
+//*	returns the HTTP status that was sent (200, 206, 304, 404, 412 or 416)
+//*	or kSF_ShortSend if the client did not get all of the body
+//*****************************************************************************
+int	StaticFile_Send(const int socket, const char *filePath, const char *httpRequest)
+{
+TYPE_STATIC_FILE_INFO	fileInfo;
+TYPE_SF_BODY			body;
+struct stat				fileStatus;
+char					httpHeader[512];
+char					headerValue[256];
+int						headerLen;
+int						fileDesc;
+int						statusCode;
+time_t					sinceTime;
+bool					notModified;
+
+	//*	fstat() the open file so the headers match the data even if the file gets replaced
+	fileDesc	=	open(filePath, O_RDONLY);
+	if ((fileDesc < 0) || (fstat(fileDesc, &fileStatus) != 0) || (GetCachedInfo(filePath, &fileStatus, &fileInfo) == false))
+	{
+		if (fileDesc >= 0)
+		{
+			close(fileDesc);
+		}
+		CONSOLE_DEBUG_W_STR("File not found:", filePath);
+		headerLen	=	snprintf(httpHeader, sizeof(httpHeader),	"HTTP/1.0 404 Not Found\r\n"
+																	"Content-Type: text/plain\r\n"
+																	"Content-Length: 16\r\n"
+																	"Connection: close\r\n"
+																	"\r\n"
+																	"File not found\r\n");
+		WriteData(socket, httpHeader, headerLen);
+		return(404);
+	}
+
+	//*	If-None-Match wins if both are there (RFC 7232)
+	notModified	=	false;
+	if (StaticFile_GetHeaderValue(httpRequest, "If-None-Match", headerValue, sizeof(headerValue)))
+	{
+		notModified	=	ETagMatches(headerValue, fileInfo.eTag);
+	}
+	else if (StaticFile_GetHeaderValue(httpRequest, "If-Modified-Since", headerValue, sizeof(headerValue)))
+	{
+		sinceTime	=	ParseHttpDate(headerValue);
+		notModified	=	((sinceTime >= 0) && (fileInfo.modTime_secs <= sinceTime));
+	}
+
+	if (notModified)
+	{
+		headerLen	=	snprintf(httpHeader, sizeof(httpHeader),	"HTTP/1.0 304 Not Modified\r\n"
+																	"ETag: %s\r\n"
+																	"Last-Modified: %s\r\n"
+																	"Cache-Control: no-cache\r\n"
+																	"Connection: close\r\n"
+																	"\r\n",
+																	fileInfo.eTag,
+																	fileInfo.lastModified);
+		WriteData(socket, httpHeader, headerLen);
+		close(fileDesc);
+		return(304);
+	}
+
+	body.fileDesc		=	fileDesc;
+	body.dataPtr		=	NULL;
+	body.dataLen		=	fileInfo.fileSize;
+	body.contentType	=	fileInfo.contentType;
+	body.eTag			=	fileInfo.eTag;
+	body.lastModified	=	fileInfo.lastModified;
+	body.extraHeaders	=	NULL;
+	statusCode			=	SendBody(socket, &body, httpRequest);
+	close(fileDesc);
+	return(statusCode);
+}
+
+//*****************************************************************************
+//*	same as StaticFile_Send() for data that is already in memory
+//*	eTag has to change whenever the data does, it is what keeps the pieces of
+//*	a resumed or parallel download from coming from different data
+//*****************************************************************************
+int	StaticFile_SendBuffer(	const int			socket,
+							const void			*dataPtr,
+							const int64_t		dataLen,
+							const char			*contentType,
+							const char			*eTag,
+							const char			*extraHeaders,
+							const char			*httpRequest)
+{
+TYPE_SF_BODY	body;
+
+	body.fileDesc		=	-1;
+	body.dataPtr		=	(const char *)dataPtr;
+	body.dataLen		=	dataLen;
+	body.contentType	=	contentType;
+	body.eTag			=	eTag;
+	body.lastModified	=	NULL;
+	body.extraHeaders	=	extraHeaders;
+	return(SendBody(socket, &body, httpRequest));
+}
+
+
+#ifdef _INCLUDE_STATIC_FILES_MAIN_
+//*****************************************************************************
+//*	Loopback benchmark, the old fread()/write() loop against sendfile()
+//*	and a check of the 304 and 206 responses
+//*
+//*	gcc -O2 -D_INCLUDE_STATIC_FILES_MAIN_ -I../libs/src_mlsLib static_files.c -lpthread -o staticfiletest
+//*****************************************************************************
+#include	<sys/socket.h>
+#include	<netinet/in.h>
+#include	<arpa/inet.h>
+#include	<sys/wait.h>
+#include	<signal.h>
+
+#define	kTestFileName	"/tmp/staticfile_test.jpg"
+#define	kTestRuns		20
+
+static int			gListenSocket;
+static int			gResponseLen;
+static const char	*gSendBufferData	=	NULL;		//*	if set, CheckResponse() uses StaticFile_SendBuffer()
+static int64_t		gSendBufferLen;
+static const char	gOldJpegHeader[]	=	"HTTP/1.0 200 ok\r\nContent-Type: image/jpeg\r\nConnection: close\r\n\r\n";
+
+//*****************************************************************************
+static double	GetMilliSecs(void)
+{
+struct timespec	currentTime;
+
+	clock_gettime(CLOCK_MONOTONIC, &currentTime);
+	return((currentTime.tv_sec * 1000.0) + (currentTime.tv_nsec / 1000000.0));
+}
+
+//*****************************************************************************
+//*	the old SendFileToSocket()
+//*****************************************************************************
+static int64_t	SendWithFread(int socket, const char *fileName)
+{
+FILE	*filePointer;
+int		numRead;
+int64_t	totalBytesWritten;
+char	dataBuffer[1600];
+
+	totalBytesWritten	=	0;
+	filePointer			=	fopen(fileName, "r");
+	if (filePointer != NULL)
+	{
+		while ((numRead = fread(dataBuffer, 1, 1500, filePointer)) > 0)
+		{
+			totalBytesWritten	+=	write(socket, dataBuffer, numRead);
+		}
+		fclose(filePointer);
+	}
+	return(totalBytesWritten);
+}
+
+//*****************************************************************************
+//*	reads a whole response, returns the byte count, the header goes in headerBuf
+//*****************************************************************************
+static int64_t	ReadResponse(int clientSocket, char *headerBuf, int headerBufLen)
+{
+char	readBuf[65536];
+ssize_t	bytesRead;
+int64_t	totalRead;
+int		hdrLen;
+
+	totalRead	=	0;
+	hdrLen		=	0;
+	while ((bytesRead = read(clientSocket, readBuf, sizeof(readBuf))) > 0)
+	{
+		if ((headerBuf != NULL) && (hdrLen < (headerBufLen - 1)))
+		{
+			int	copyLen	=	(bytesRead < (headerBufLen - 1 - hdrLen)) ? bytesRead : (headerBufLen - 1 - hdrLen);
+			memcpy(headerBuf + hdrLen, readBuf, copyLen);
+			hdrLen	+=	copyLen;
+		}
+		totalRead	+=	bytesRead;
+	}
+	if (headerBuf != NULL)
+	{
+		headerBuf[hdrLen]	=	0;
+	}
+	return(totalRead);
+}
+
+//*****************************************************************************
+//*	connects, the server side does one response, returns what the client read
+//*****************************************************************************
+static int64_t	DoRequest(int method, const char *httpRequest, char *headerBuf, int headerBufLen, int *statusCode)
+{
+struct sockaddr_in	serverAddr;
+socklen_t			addrLen;
+int					clientSocket;
+int					serverSocket;
+int64_t				bytesRead;
+pid_t				childPID;
+
+	addrLen	=	sizeof(serverAddr);
+	getsockname(gListenSocket, (struct sockaddr *)&serverAddr, &addrLen);
+	clientSocket	=	socket(AF_INET, SOCK_STREAM, 0);
+	connect(clientSocket, (struct sockaddr *)&serverAddr, addrLen);
+	serverSocket	=	accept(gListenSocket, NULL, NULL);
+
+	//*	the client reads in a child so the server side can block on a full socket
+	childPID	=	fork();
+	if (childPID == 0)
+	{
+		close(serverSocket);
+		bytesRead	=	ReadResponse(clientSocket, headerBuf, headerBufLen);
+		_exit((bytesRead > 0) ? 0 : 1);
+	}
+	close(clientSocket);
+	*statusCode	=	0;
+	if (method == 0)
+	{
+		WriteData(serverSocket, gOldJpegHeader, strlen(gOldJpegHeader));
+		bytesRead	=	SendWithFread(serverSocket, kTestFileName);
+	}
+	else
+	{
+		*statusCode	=	StaticFile_Send(serverSocket, kTestFileName, httpRequest);
+		bytesRead	=	0;
+	}
+	close(serverSocket);
+	waitpid(childPID, NULL, 0);
+	return(bytesRead);
+}
+
+//*****************************************************************************
+//*	used for the header checks, client and server in the same process through a socketpair
+//*****************************************************************************
+static int	CheckResponse(const char *httpRequest, char *responseBuf, int responseBufLen)
+{
+int		sockets[2];
+int		statusCode;
+ssize_t	bytesRead;
+int		totalRead;
+
+	socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+	fflush(stdout);		//*	CONSOLE_DEBUG in the child would print it again
+	if (fork() == 0)
+	{
+		close(sockets[0]);
+		if (gSendBufferData != NULL)
+		{
+			StaticFile_SendBuffer(sockets[1], gSendBufferData, gSendBufferLen, "application/imagebytes", "\"frame-1\"", "X-Frame-Number: 1\r\n", httpRequest);
+		}
+		else
+		{
+			StaticFile_Send(sockets[1], kTestFileName, httpRequest);
+		}
+		close(sockets[1]);
+		_exit(0);
+	}
+	close(sockets[1]);
+	totalRead	=	0;
+	while ((bytesRead = read(sockets[0], responseBuf + totalRead, 4096)) > 0)
+	{
+		if (totalRead < (responseBufLen - 8192))
+		{
+			totalRead	+=	bytesRead;
+		}
+	}
+	responseBuf[totalRead]	=	0;
+	gResponseLen			=	totalRead;
+	close(sockets[0]);
+	wait(NULL);
+	statusCode	=	0;
+	sscanf(responseBuf, "HTTP/1.0 %d", &statusCode);
+	return(statusCode);
+}
+
+//*****************************************************************************
+//*	true if the body is expectedLen bytes and matches
+//*****************************************************************************
+static bool	CheckBody(const char *responseBuf, const char *expectedData, const int expectedLen)
+{
+const char	*bodyPtr;
+
+	bodyPtr	=	strstr(responseBuf, "\r\n\r\n");
+	if (bodyPtr == NULL)
+	{
+		return(false);
+	}
+	bodyPtr	+=	4;
+	return(((responseBuf + gResponseLen - bodyPtr) == expectedLen) && (memcmp(bodyPtr, expectedData, expectedLen) == 0));
+}
+
+//*****************************************************************************
+int main(int argc, char *argv[])
+{
+struct sockaddr_in		serverAddr;
+FILE					*filePointer;
+char					*dataBuf;
+int						fileSize_MB;
+int						iii;
+int						run;
+int						statusCode;
+int						failCnt;
+double					startTime_ms;
+double					elapsed_ms[2];
+char					*responseBuf;
+char					request[512];
+char					expected[128];
+TYPE_STATIC_FILE_INFO	fileInfo;
+int64_t					fileSize;
+int						contentLen;
+int						sockets[2];
+
+	fileSize_MB	=	(argc > 1) ? atoi(argv[1]) : 8;
+	failCnt		=	0;
+
+	//*	make a fake image
+	dataBuf		=	(char *)malloc(1024 * 1024);
+	for (iii=0; iii<(1024 * 1024); iii++)
+	{
+		dataBuf[iii]	=	random();
+	}
+	filePointer	=	fopen(kTestFileName, "w");
+	for (iii=0; iii<fileSize_MB; iii++)
+	{
+		fwrite(dataBuf, 1, (1024 * 1024), filePointer);
+	}
+	fclose(filePointer);
+
+	gListenSocket	=	socket(AF_INET, SOCK_STREAM, 0);
+	memset(&serverAddr, 0, sizeof(serverAddr));
+	serverAddr.sin_family		=	AF_INET;
+	serverAddr.sin_addr.s_addr	=	htonl(INADDR_LOOPBACK);
+	serverAddr.sin_port			=	0;
+	bind(gListenSocket, (struct sockaddr *)&serverAddr, sizeof(serverAddr));
+	listen(gListenSocket, 4);
+
+	//*	throughput
+	for (iii=0; iii<2; iii++)
+	{
+		startTime_ms	=	GetMilliSecs();
+		for (run=0; run<kTestRuns; run++)
+		{
+			DoRequest(iii, "GET /image.jpg HTTP/1.1\r\nHost: localhost\r\n\r\n", NULL, 0, &statusCode);
+		}
+		elapsed_ms[iii]	=	GetMilliSecs() - startTime_ms;
+		printf("%-16s %d x %d MB in %8.1f ms = %8.1f MB/s\r\n",	((iii == 0) ? "fread/write" : "sendfile"),
+																kTestRuns, fileSize_MB, elapsed_ms[iii],
+																(kTestRuns * fileSize_MB) / (elapsed_ms[iii] / 1000.0));
+	}
+
+	//*	conditional requests
+	responseBuf	=	(char *)malloc((fileSize_MB + 1) * 1024 * 1024);
+	StaticFile_GetInfo(kTestFileName, &fileInfo);
+
+	statusCode	=	CheckResponse("GET /image.jpg HTTP/1.1\r\nHost: localhost\r\n\r\n", responseBuf, (fileSize_MB + 1) * 1024 * 1024);
+	sprintf(request, "Content-Length: %d\r\n", fileSize_MB * 1024 * 1024);
+	if ((statusCode != 200) || (strstr(responseBuf, request) == NULL) || (strstr(responseBuf, "Content-Type: image/jpeg\r\n") == NULL) ||
+		(strstr(responseBuf, "Accept-Ranges: bytes\r\n") == NULL))
+	{
+		printf("FAIL: plain GET, status %d\r\n", statusCode);
+		failCnt++;
+	}
+
+	sprintf(request, "GET /image.jpg HTTP/1.1\r\nHost: localhost\r\nif-none-match: %s\r\n\r\n", fileInfo.eTag);
+	statusCode	=	CheckResponse(request, responseBuf, (fileSize_MB + 1) * 1024 * 1024);
+	if ((statusCode != 304) || (strstr(responseBuf, "\r\n\r\n")[4] != 0))
+	{
+		printf("FAIL: matching ETag, status %d\r\n", statusCode);
+		failCnt++;
+	}
+
+	statusCode	=	CheckResponse("GET /image.jpg HTTP/1.1\r\nIf-None-Match: \"1-2-3\"\r\n\r\n", responseBuf, (fileSize_MB + 1) * 1024 * 1024);
+	if (statusCode != 200)
+	{
+		printf("FAIL: stale ETag, status %d\r\n", statusCode);
+		failCnt++;
+	}
+
+	sprintf(request, "GET /image.jpg HTTP/1.1\r\nIf-Modified-Since: %s\r\n\r\n", fileInfo.lastModified);
+	statusCode	=	CheckResponse(request, responseBuf, (fileSize_MB + 1) * 1024 * 1024);
+	if (statusCode != 304)
+	{
+		printf("FAIL: If-Modified-Since, status %d\r\n", statusCode);
+		failCnt++;
+	}
+
+	statusCode	=	CheckResponse("GET /image.jpg HTTP/1.1\r\nIf-Modified-Since: Mon, 01 Jan 2001 00:00:00 GMT\r\n\r\n", responseBuf, (fileSize_MB + 1) * 1024 * 1024);
+	if (statusCode != 200)
+	{
+		printf("FAIL: old If-Modified-Since, status %d\r\n", statusCode);
+		failCnt++;
+	}
+
+	//*	ranges, the last MB of the file is the same as dataBuf
+	fileSize	=	(int64_t)fileSize_MB * 1024 * 1024;
+	statusCode	=	CheckResponse("GET /image.jpg HTTP/1.1\r\nRange: bytes=100-199\r\n\r\n", responseBuf, (fileSize_MB + 1) * 1024 * 1024);
+	sprintf(expected, "Content-Range: bytes 100-199/%lld\r\n", (long long)fileSize);
+	if ((statusCode != 206) || (strstr(responseBuf, expected) == NULL) || (CheckBody(responseBuf, dataBuf + 100, 100) == false))
+	{
+		printf("FAIL: single range, status %d\r\n", statusCode);
+		failCnt++;
+	}
+
+	statusCode	=	CheckResponse("GET /image.jpg HTTP/1.1\r\nRange: bytes=-100\r\n\r\n", responseBuf, (fileSize_MB + 1) * 1024 * 1024);
+	sprintf(expected, "Content-Range: bytes %lld-%lld/%lld\r\n", (long long)(fileSize - 100), (long long)(fileSize - 1), (long long)fileSize);
+	if ((statusCode != 206) || (strstr(responseBuf, expected) == NULL) || (CheckBody(responseBuf, dataBuf + (1024 * 1024) - 100, 100) == false))
+	{
+		printf("FAIL: suffix range, status %d\r\n", statusCode);
+		failCnt++;
+	}
+
+	//*	resume from a byte offset
+	sprintf(request, "GET /image.jpg HTTP/1.1\r\nRange: bytes=%lld-\r\nIf-Range: %s\r\n\r\n", (long long)(fileSize - 5000), fileInfo.eTag);
+	statusCode	=	CheckResponse(request, responseBuf, (fileSize_MB + 1) * 1024 * 1024);
+	if ((statusCode != 206) || (CheckBody(responseBuf, dataBuf + (1024 * 1024) - 5000, 5000) == false))
+	{
+		printf("FAIL: open ended range with If-Range, status %d\r\n", statusCode);
+		failCnt++;
+	}
+
+	//*	If-Range that does not match gets the whole thing
+	statusCode	=	CheckResponse("GET /image.jpg HTTP/1.1\r\nRange: bytes=0-99\r\nIf-Range: \"1-2-3\"\r\n\r\n", responseBuf, (fileSize_MB + 1) * 1024 * 1024);
+	if ((statusCode != 200) || ((gResponseLen - (strstr(responseBuf, "\r\n\r\n") + 4 - responseBuf)) != fileSize))
+	{
+		printf("FAIL: stale If-Range, status %d\r\n", statusCode);
+		failCnt++;
+	}
+
+	statusCode	=	CheckResponse("GET /image.jpg HTTP/1.1\r\nRange: bytes=0-9,50-59\r\n\r\n", responseBuf, (fileSize_MB + 1) * 1024 * 1024);
+	contentLen	=	0;
+	if (strstr(responseBuf, "Content-Length: ") != NULL)
+	{
+		contentLen	=	atoi(strstr(responseBuf, "Content-Length: ") + 16);
+	}
+	sprintf(expected, "Content-Range: bytes 50-59/%lld\r\n\r\n", (long long)fileSize);
+	if ((statusCode != 206) || (strstr(responseBuf, "multipart/byteranges") == NULL) ||
+		(strstr(responseBuf, expected) == NULL) ||
+		(memcmp(strstr(responseBuf, expected) + strlen(expected), dataBuf + 50, 10) != 0) ||
+		(contentLen != (gResponseLen - (strstr(responseBuf, "\r\n\r\n") + 4 - responseBuf))))
+	{
+		printf("FAIL: multiple ranges, status %d\r\n", statusCode);
+		failCnt++;
+	}
+
+	sprintf(request, "GET /image.jpg HTTP/1.1\r\nRange: bytes=%lld-\r\n\r\n", (long long)fileSize);
+	statusCode	=	CheckResponse(request, responseBuf, (fileSize_MB + 1) * 1024 * 1024);
+	if (statusCode != 416)
+	{
+		printf("FAIL: range past the end, status %d\r\n", statusCode);
+		failCnt++;
+	}
+
+	statusCode	=	CheckResponse("GET /image.jpg HTTP/1.1\r\nRange: bytes=abc\r\n\r\n", responseBuf, (fileSize_MB + 1) * 1024 * 1024);
+	if (statusCode != 200)
+	{
+		printf("FAIL: bad range syntax, status %d\r\n", statusCode);
+		failCnt++;
+	}
+
+	statusCode	=	CheckResponse("GET /image.jpg HTTP/1.1\r\nIf-Match: \"1-2-3\"\r\n\r\n", responseBuf, (fileSize_MB + 1) * 1024 * 1024);
+	if (statusCode != 412)
+	{
+		printf("FAIL: If-Match, status %d\r\n", statusCode);
+		failCnt++;
+	}
+
+	//*	the same from memory
+	gSendBufferData	=	dataBuf;
+	gSendBufferLen	=	1024 * 1024;
+	statusCode	=	CheckResponse("GET /imagearray HTTP/1.1\r\nRange: bytes=10-19\r\nIf-Range: \"frame-1\"\r\n\r\n", responseBuf, (fileSize_MB + 1) * 1024 * 1024);
+	if ((statusCode != 206) || (strstr(responseBuf, "X-Frame-Number: 1\r\n") == NULL) || (CheckBody(responseBuf, dataBuf + 10, 10) == false))
+	{
+		printf("FAIL: buffer range, status %d\r\n", statusCode);
+		failCnt++;
+	}
+	statusCode	=	CheckResponse("GET /imagearray HTTP/1.1\r\nRange: bytes=10-19\r\nIf-Range: \"frame-0\"\r\n\r\n", responseBuf, (fileSize_MB + 1) * 1024 * 1024);
+	if ((statusCode != 200) || (CheckBody(responseBuf, dataBuf, 1024 * 1024) == false))
+	{
+		printf("FAIL: buffer range from an old frame, status %d\r\n", statusCode);
+		failCnt++;
+	}
+	gSendBufferData	=	NULL;
+
+	//*	a client that hangs up has to show up as a short send
+	signal(SIGPIPE, SIG_IGN);
+	socketpair(AF_UNIX, SOCK_STREAM, 0, sockets);
+	close(sockets[0]);
+	statusCode	=	StaticFile_SendBuffer(sockets[1], dataBuf, (1024 * 1024), "application/imagebytes", "\"frame-1\"", NULL, NULL);
+	close(sockets[1]);
+	if (statusCode != kSF_ShortSend)
+	{
+		printf("FAIL: short send, status %d\r\n", statusCode);
+		failCnt++;
+	}
+
+	//*	rewrite the file, the old ETag must not match any more
+	usleep(10000);
+	filePointer	=	fopen(kTestFileName, "a");
+	fwrite(dataBuf, 1, 100, filePointer);
+	fclose(filePointer);
+	sprintf(request, "GET /image.jpg HTTP/1.1\r\nIf-None-Match: %s\r\n\r\n", fileInfo.eTag);
+	statusCode	=	CheckResponse(request, responseBuf, (fileSize_MB + 1) * 1024 * 1024);
+	if (statusCode != 200)
+	{
+		printf("FAIL: changed file, status %d\r\n", statusCode);
+		failCnt++;
+	}
+
+	unlink(kTestFileName);
+	printf("Failures = %d\r\n", failCnt);
+	return(failCnt == 0 ? 0 : 1);
+}
+#endif // _INCLUDE_STATIC_FILES_MAIN_
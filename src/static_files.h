@@ -0,0 +1,67 @@
+//*****************************************************************************
+//#include	"static_files.h"
+
+#ifndef _STATIC_FILES_H_
+#define	_STATIC_FILES_H_
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+#include	<sys/types.h>
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define	kSF_MaxCacheEntries		32
+#define	kSF_MaxPathLen			256
+#define	kSF_ETagLen				48
+#define	kSF_HttpDateLen			40
+#define	kSF_MaxRanges			16
+#define	kSF_ShortSend			-1			//*	returned when the body was not all sent
+
+//*****************************************************************************
+typedef struct	//	TYPE_STATIC_FILE_INFO
+{
+	char		filePath[kSF_MaxPathLen];
+	ino_t		inode;
+	off_t		fileSize;
+	time_t		modTime_secs;
+	long		modTime_nsecs;
+	char		eTag[kSF_ETagLen];
+	char		lastModified[kSF_HttpDateLen];
+	const char	*contentType;
+	uint32_t	lastUsed;
+} TYPE_STATIC_FILE_INFO;
+
+//*****************************************************************************
+typedef struct	//	TYPE_BYTE_RANGE
+{
+	int64_t		firstByte;
+	int64_t		lastByte;			//*	inclusive, same as the Range header
+} TYPE_BYTE_RANGE;
+
+
+int			StaticFile_Send(const int socket, const char *filePath, const char *httpRequest);
+int64_t		StaticFile_SendFileData(const int socket, const int fileDesc, off_t offset, int64_t byteCount);
+const char	*StaticFile_GetContentType(const char *filePath);
+bool		StaticFile_GetInfo(const char *filePath, TYPE_STATIC_FILE_INFO *fileInfo);
+bool		StaticFile_GetHeaderValue(const char *httpRequest, const char *fieldName, char *value, const int maxLen);
+int			StaticFile_ParseRange(const char *rangeHeader, const int64_t totalLen, TYPE_BYTE_RANGE *ranges, const int maxRanges);
+int			StaticFile_SendBuffer(	const int			socket,
+									const void			*dataPtr,
+									const int64_t		dataLen,
+									const char			*contentType,
+									const char			*eTag,
+									const char			*extraHeaders,
+									const char			*httpRequest);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _STATIC_FILES_H_
@@ -49,6 +49,10 @@
 //*	May 17,	2024	<MLS> Started on http 400 error support for switch driver
 //*	Jun 28,	2024	<MLS> Removed all "if (reqData != NULL)" from switchdriver.cpp
 //*	Jul 20,	2024	<MLS> Updated set switch functions to return true if successful
+//*	Oct 18,	2026	<MLS> Switch names and values are now saved in the state store (state_store.c)
+//*	Oct 18,	2026	<MLS> setswitchname no longer rewrites switchdescription.txt
+//*	Oct 18,	2026	<MLS> Saved switch values are restored through SetSwitchState()/SetSwitchValue()
+//*	Oct 18,	2026	<MLS> State store keys use the driver name, not the device number
 //*****************************************************************************
 
 #ifdef _ENABLE_SWITCH_
@@ -73,6 +77,7 @@
 #include	"switchdriver.h"
 
 #include	"helper_functions.h"
+#include	"state_store.h"
 #ifdef __arm__
 	#include	"switchdriver_rpi.h"
 #endif
@@ -137,6 +142,7 @@ int		iii;
 		cCurSwitchValue[iii]			=	0.0;
 	}
 	ReadSwitchDataFile();
+	//*	the saved state is restored by RunStateMachine(), the hardware is not set up yet
 }
 
 //**************************************************************************************
@@ -147,6 +153,18 @@ SwitchDriver::~SwitchDriver(void)
 	CONSOLE_DEBUG(__FUNCTION__);
 }
 
+//*****************************************************************************
+int32_t	SwitchDriver::RunStateMachine(void)
+{
+	//*	by now the sub class has configured the switches and the hardware
+	if (cRunStartupOperations)
+	{
+		RestoreSwitchState();
+		cRunStartupOperations	=	false;
+	}
+	return(AlpacaDriver::RunStateMachine());
+}
+
 //*****************************************************************************
 TYPE_ASCOM_STATUS	SwitchDriver::ProcessCommand(TYPE_GetPutRequestData *reqData)
 {
@@ -661,6 +679,7 @@ bool				newSwitchState;
 				{
 					cCurSwitchValue[switchNum]	=	cMinSwitchValue[switchNum];
 				}
+				SaveSwitchState(switchNum);
 				alpacaErrCode	=	kASCOM_Err_Success;
 			}
 			else
@@ -722,7 +741,7 @@ int					switchNum;
 									cSwitchTable[switchNum].switchName,
 									INCLUDE_COMMA);
 
-		WriteSwitchDataFile();
+		SaveSwitchState(switchNum);
 		alpacaErrCode	=	kASCOM_Err_Success;
 	}
 	else
@@ -769,6 +788,7 @@ double				newSwitchValue;
 				{
 					SetSwitchValue(switchNum, newSwitchValue);
 					cCurSwitchValue[switchNum]	=	AsciiToDouble(valueString);
+					SaveSwitchState(switchNum);
 					alpacaErrCode				=	kASCOM_Err_Success;
 				}
 				else
@@ -1182,6 +1202,98 @@ FILE	*filePointer;
 	}
 }
 
+//*****************************************************************************
+//*	The key has to be the same from one run to the next. The device number depends
+//*	on the order the drivers were found in and the UniqueID has a random serial number,
+//*	so it is the device type plus the serial number or the driver name.
+//*		switch.AlpacaPi_Switch_Simulator.3.value
+//*****************************************************************************
+void	SwitchDriver::GetStateKey(const int switchNum, const char *fieldName, char *keyString)
+{
+char	driverID[32];
+int		iii;
+
+	strncpy(driverID, ((cDeviceSerialNum[0] != 0) ? cDeviceSerialNum : cCommonProp.Name), (sizeof(driverID) - 1));
+	driverID[sizeof(driverID) - 1]	=	0;
+	iii	=	0;
+	while (driverID[iii] != 0)
+	{
+		if (isalnum(driverID[iii]) == false)
+		{
+			driverID[iii]	=	'_';
+		}
+		iii++;
+	}
+	sprintf(keyString, "%s.%s.%d.%s", cAlpacaName, driverID, switchNum, fieldName);
+}
+
+//*****************************************************************************
+//*	The names and values that were set over alpaca are kept in the state store,
+//*	it is crash safe and writes are batched. switchdescription.txt still has the
+//*	defaults, anything in the state store overrides it.
+//*****************************************************************************
+void	SwitchDriver::SaveSwitchState(const int switchNum)
+{
+char	keyString[kSS_MaxKeyLen];
+
+	if ((switchNum >= 0) && (switchNum < kMaxSwitchCnt))
+	{
+		GetStateKey(switchNum, "name", keyString);
+		StateStore_Put(keyString, cSwitchTable[switchNum].switchName);
+
+		GetStateKey(switchNum, "value", keyString);
+		StateStore_PutDouble(keyString, cCurSwitchValue[switchNum]);
+	}
+}
+
+//*****************************************************************************
+//*	the values go to the hardware the same way setswitch and setswitchvalue do,
+//*	the cached value is only updated if the hardware took it
+//*****************************************************************************
+void	SwitchDriver::RestoreSwitchState(void)
+{
+int		iii;
+char	keyString[kSS_MaxKeyLen];
+char	nameString[kMaxSwitchNameLen];
+double	switchValue;
+bool	newSwitchState;
+
+	for (iii=0; iii<cSwitchProp.MaxSwitch; iii++)
+	{
+		GetStateKey(iii, "name", keyString);
+		if (StateStore_Get(keyString, nameString, sizeof(nameString)))
+		{
+			strcpy(cSwitchTable[iii].switchName, nameString);
+		}
+		GetStateKey(iii, "value", keyString);
+		if (StateStore_GetDouble(keyString, &switchValue) &&
+			(switchValue >= cMinSwitchValue[iii]) && (switchValue <= cMaxSwitchValue[iii]))
+		{
+			switch(cSwitchTable[iii].switchType)
+			{
+				case kSwitchType_Relay:
+					newSwitchState	=	(switchValue > cMinSwitchValue[iii]);
+					if (SetSwitchState(iii, newSwitchState))
+					{
+						cCurSwitchValue[iii]	=	newSwitchState ? cMaxSwitchValue[iii] : cMinSwitchValue[iii];
+					}
+					break;
+
+				case kSwitchType_Analog:
+					if (SetSwitchValue(iii, switchValue))
+					{
+						cCurSwitchValue[iii]	=	switchValue;
+					}
+					break;
+
+				case kSwitchType_Status:
+					//*	read only, nothing to restore
+					break;
+			}
+		}
+	}
+}
+
 //*****************************************************************************
 bool	SwitchDriver::GetSwitchState(const int switchNumber)
 {
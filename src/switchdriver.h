@@ -11,6 +11,8 @@
 //*	Dec 26,	2019	<MLS> Created switchdriver.h
 //*	Nov 28,	2020	<MLS> Updated return values to TYPE_ASCOM_STATUS
 //*	Jan  1,	2022	<MLS> Added kSwitchType_Status
+//*	Oct 18,	2026	<MLS> Added SaveSwitchState() and RestoreSwitchState()
+//*	Oct 18,	2026	<MLS> Added RunStateMachine(), restores the saved state once the switches are set up
 //*****************************************************************************
 
 //#include	"switchdriver.h"
@@ -62,7 +64,7 @@ class SwitchDriver: public AlpacaDriver
 		virtual	TYPE_ASCOM_STATUS	ProcessCommand(TYPE_GetPutRequestData *reqData);
 		virtual	void				OutputHTML(TYPE_GetPutRequestData *reqData);
 //		virtual	void				OutputHTML_Part2(TYPE_GetPutRequestData *reqData);
-//		virtual	int32_t				RunStateMachine(void);
+		virtual	int32_t				RunStateMachine(void);
 		virtual bool				GetCmdNameFromMyCmdTable(const int cmdNumber, char *comandName, char *getPut);
 
 	protected:
@@ -86,6 +88,9 @@ class SwitchDriver: public AlpacaDriver
 
 				void	ReadSwitchDataFile(void);
 				void	WriteSwitchDataFile(void);
+				void	GetStateKey(const int switchNum, const char *fieldName, char *keyString);
+				void	SaveSwitchState(const int switchNum);
+				void	RestoreSwitchState(void);
 
 
 		virtual	bool	GetSwitchState(const int switchNumber);
@@ -81,6 +81,7 @@
 //*	May 17,	2024	<MLS> Added ExtractRaDecArguments() & ExtractAltAzArguments()
 //*	May 17,	2024	<MLS> Added http error 400 processing to telescope driver
 //*	Jun 28,	2024	<MLS> Removed all "if (reqData != NULL)" from telescopedriver.cpp
+//*	Oct 18,	2026	<MLS> Added PublishStateSnapshot()
 //*****************************************************************************
 
 
@@ -136,6 +137,7 @@
 
 #include	"alpaca_defs.h"
 #include	"alpacadriver.h"
+#include	"devicestate_snapshot.h"
 #include	"alpacadriver_helper.h"
 #include	"helper_functions.h"
 #include	"JsonResponse.h"
@@ -3948,9 +3950,8 @@ TYPE_ASCOM_STATUS	TelescopeDriver::Get_IMU(	TYPE_GetPutRequestData *reqData,
 TYPE_ASCOM_STATUS		alpacaErrCode	=	kASCOM_Err_Success;
 char					imuArrayText[256];
 
-	cTelescopeProp.IMU_Roll		=	IMU_GetAverageRoll();
-	cTelescopeProp.IMU_Pitch	=	IMU_GetAveragePitch();
-	cTelescopeProp.IMU_Yaw		=	IMU_GetAverageYaw();
+	//*	all three from the same update
+	IMU_GetAverageRoll_Pitch_Yaw(&cTelescopeProp.IMU_Roll, &cTelescopeProp.IMU_Pitch, &cTelescopeProp.IMU_Yaw);
 
 	JsonResponse_Add_ArrayStart(reqData->socket,
 								reqData->jsonTextBuffer,
@@ -4151,6 +4152,26 @@ int32_t	TelescopeDriver::RunStateMachine(void)
 	return(5 * 1000 * 1000);
 }
 
+//*****************************************************************************
+//*	publish the current state for other devices, see devicestate_snapshot.c
+//*****************************************************************************
+void	TelescopeDriver::PublishStateSnapshot(void)
+{
+TYPE_DeviceSnapshot	mountSnapshot;
+
+	memset(&mountSnapshot, 0, sizeof(TYPE_DeviceSnapshot));
+	mountSnapshot.deviceType					=	kDeviceType_Telescope;
+	mountSnapshot.alpacaDevNum					=	cAlpacaDeviceNum;
+	mountSnapshot.dev.telescope.RightAscension	=	cTelescopeProp.RightAscension;
+	mountSnapshot.dev.telescope.Declination		=	cTelescopeProp.Declination;
+	mountSnapshot.dev.telescope.Altitude		=	cTelescopeProp.Altitude;
+	mountSnapshot.dev.telescope.Azimuth			=	cTelescopeProp.Azimuth;
+	mountSnapshot.dev.telescope.Tracking		=	cTelescopeProp.Tracking;
+	mountSnapshot.dev.telescope.Slewing			=	cTelescopeProp.Slewing;
+	mountSnapshot.dev.telescope.AtPark			=	cTelescopeProp.AtPark;
+	DeviceSnapshot_Publish(&mountSnapshot);
+}
+
 //*****************************************************************************
 TYPE_ASCOM_STATUS	TelescopeDriver::Telescope_AbortSlew(char *alpacaErrMsg)
 {
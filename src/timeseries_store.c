@@ -0,0 +1,709 @@
+//*****************************************************************************
+//*	Name:			timeseries_store.c
+//*
+//*	Author:			Mark Sproul (C) 2026
+//*
+//*	Description:	Memory mapped time series store for device sensor data
+//*
+//*	Any driver can log samples to a named channel (cooler power, focuser temperature,
+//*	dome azimuth, cpu temperature etc). Each channel has a ring of raw samples and
+//*	rings of 1 second, 1 minute and 15 minute rollups (min/max/avg/count).
+//*
+//*	The file is a fixed size and is memory mapped, appending a sample is a few stores
+//*	into the mapping. Dirty pages are flushed with msync() once a minute so an SD card
+//*	sees one write per page per minute no matter how many samples are logged.
+//*
+//*	File layout
+//*		+-------------------------------+
+//*		| TYPE_TS_FileHdr				|	channel table, ring counts, rollup accumulators
+//*		+-------------------------------+	page aligned
+//*		| raw samples					|	[kTS_MaxChannels][kTS_RawEntries]
+//*		+-------------------------------+
+//*		| rollups						|	[kTS_MaxChannels][kTS_Level_Count - 1][kTS_RollupEntries]
+//*		+-------------------------------+
+//*****************************************************************************
+//*	AlpacaPi is an open source project written in C/C++
+//*
+//*	Use of this source code for private or individual use is granted
+//*	Use of this source code, in whole or in part for commercial purpose requires
+//*	written agreement in advance.
+//*
+//*	You may use or modify this source code in any way you find useful, provided
+//*	that you agree that the author(s) have no warranty, obligations or liability.  You
+//*	must determine the suitability of this source code for your use.
+//*
+//*	Re-distributions of this source code must retain this copyright notice.
+//*****************************************************************************
+//*	Edit History
+//*****************************************************************************
+//*	<MLS>	=	Mark L Sproul
+//*****************************************************************************
+//*	Oct 18,	2026	<MLS> Created timeseries_store.c
+//*	Oct 18,	2026	<MLS> Added TimeSeries_SetFilePath(), the store path is absolute
+//*	Oct 18,	2026	<MLS> Removed TimeSeries_AppendByName(), drivers keep a channel handle
+//*	Oct 18,	2026	<MLS> Added _INCLUDE_TIMESERIES_MAIN_ self test and append benchmark
+//*****************************************************************************
+
+#include	<stdbool.h>
+#include	<stdint.h>
+#include	<stdio.h>
+#include	<string.h>
+#include	<unistd.h>
+#include	<fcntl.h>
+#include	<time.h>
+#include	<limits.h>
+#include	<pthread.h>
+#include	<sys/mman.h>
+#include	<sys/stat.h>
+
+#define _ENABLE_CONSOLE_DEBUG_
+#include	"ConsoleDebug.h"
+
+#include	"timeseries_store.h"
+
+#define	kTS_SyncInterval_us		(60LL * 1000000LL)
+
+//*****************************************************************************
+typedef struct	//	TYPE_TS_Sample
+{
+	int64_t		time_us;
+	float		value;
+	uint32_t	spare;
+} TYPE_TS_Sample;
+
+//*****************************************************************************
+//*	the bucket currently being filled for one rollup level
+typedef struct	//	TYPE_TS_Accum
+{
+	int64_t		bucketStart_us;
+	double		sum;
+	float		minValue;
+	float		maxValue;
+	uint32_t	count;
+	uint32_t	spare;
+} TYPE_TS_Accum;
+
+//*****************************************************************************
+typedef struct	//	TYPE_TS_Channel
+{
+	char			name[kTS_ChannelNameLen];
+	uint64_t		rawCount;							//*	total samples ever appended
+	uint64_t		rollupCount[kTS_Level_Count];		//*	total buckets ever completed, [0] unused
+	TYPE_TS_Accum	accum[kTS_Level_Count];				//*	[0] unused
+} TYPE_TS_Channel;
+
+//*****************************************************************************
+typedef struct	//	TYPE_TS_FileHdr
+{
+	uint32_t		magic;
+	uint32_t		version;
+	uint32_t		maxChannels;
+	uint32_t		rawEntries;
+	uint32_t		rollupEntries;
+	uint32_t		channelCnt;
+	TYPE_TS_Channel	channel[kTS_MaxChannels];
+} TYPE_TS_FileHdr;
+
+static const int64_t	gBucketWidth_us[kTS_Level_Count]	=
+{
+	0,
+	1000000LL,
+	60LL * 1000000LL,
+	15LL * 60LL * 1000000LL
+};
+
+static pthread_mutex_t	gTSmutex			=	PTHREAD_MUTEX_INITIALIZER;
+static int				gTSfileDesc			=	-1;
+static bool				gTSopenFailed		=	false;
+static size_t			gTSmapSize			=	0;
+static unsigned char	*gTSmapPtr			=	NULL;
+static TYPE_TS_FileHdr	*gTSheader			=	NULL;
+static TYPE_TS_Sample	*gTSrawData			=	NULL;
+static TYPE_TS_Point	*gTSrollupData		=	NULL;
+static int64_t			gTSlastSync_us		=	0;
+static char				gTSfilePath[PATH_MAX]	=	"";
+
+//*****************************************************************************
+int64_t	TimeSeries_GetTime_us(void)
+{
+struct timespec	currentTime;
+
+	clock_gettime(CLOCK_REALTIME, &currentTime);
+	return((currentTime.tv_sec * 1000000LL) + (currentTime.tv_nsec / 1000));
+}
+
+//*****************************************************************************
+//*	a relative path is resolved against the current directory now, so the store
+//*	does not move if the process changes directory later (i.e. image data dir)
+//*****************************************************************************
+void	TimeSeries_SetFilePath(const char *filePath)
+{
+char	currentDir[PATH_MAX / 2];
+
+	if ((filePath[0] != '/') && (getcwd(currentDir, sizeof(currentDir)) != NULL))
+	{
+		snprintf(gTSfilePath, sizeof(gTSfilePath), "%s/%s", currentDir, filePath);
+	}
+	else
+	{
+		strncpy(gTSfilePath, filePath, (sizeof(gTSfilePath) - 1));
+		gTSfilePath[sizeof(gTSfilePath) - 1]	=	0;
+	}
+}
+
+//*****************************************************************************
+const char	*TimeSeries_GetFilePath(void)
+{
+	if (gTSfilePath[0] == 0)
+	{
+		TimeSeries_SetFilePath(kTS_FileName);
+	}
+	return(gTSfilePath);
+}
+
+//*****************************************************************************
+static TYPE_TS_Sample	*GetRawRing(const int channelIdx)
+{
+	return(&gTSrawData[channelIdx * kTS_RawEntries]);
+}
+
+//*****************************************************************************
+static TYPE_TS_Point	*GetRollupRing(const int channelIdx, const int level)
+{
+	return(&gTSrollupData[((channelIdx * (kTS_Level_Count - 1)) + (level - 1)) * kTS_RollupEntries]);
+}
+
+//*****************************************************************************
+bool	TimeSeries_Open(const char *filePath)
+{
+size_t		pageSize;
+size_t		hdrSize;
+size_t		rawSize;
+size_t		rollupSize;
+struct stat	fileStatus;
+bool		validFile;
+
+	pthread_mutex_lock(&gTSmutex);
+	if (gTSmapPtr == NULL)
+	{
+		pageSize	=	sysconf(_SC_PAGESIZE);
+		hdrSize		=	((sizeof(TYPE_TS_FileHdr) + pageSize - 1) / pageSize) * pageSize;
+		rawSize		=	sizeof(TYPE_TS_Sample) * kTS_MaxChannels * kTS_RawEntries;
+		rollupSize	=	sizeof(TYPE_TS_Point) * kTS_MaxChannels * (kTS_Level_Count - 1) * kTS_RollupEntries;
+		gTSmapSize	=	hdrSize + rawSize + rollupSize;
+
+		gTSfileDesc	=	open(filePath, (O_RDWR | O_CREAT), 0644);
+		if (gTSfileDesc >= 0)
+		{
+			//*	the file is a fixed size, ftruncate makes it sparse until the pages are used
+			fstat(gTSfileDesc, &fileStatus);
+			if ((size_t)fileStatus.st_size != gTSmapSize)
+			{
+				if (ftruncate(gTSfileDesc, gTSmapSize) != 0)
+				{
+					CONSOLE_DEBUG_W_STR("ftruncate failed on", filePath);
+				}
+			}
+			gTSmapPtr	=	(unsigned char *)mmap(NULL, gTSmapSize, (PROT_READ | PROT_WRITE), MAP_SHARED, gTSfileDesc, 0);
+			if (gTSmapPtr == MAP_FAILED)
+			{
+				CONSOLE_DEBUG_W_STR("mmap failed on", filePath);
+				gTSmapPtr	=	NULL;
+				close(gTSfileDesc);
+				gTSfileDesc	=	-1;
+			}
+		}
+		else
+		{
+			CONSOLE_DEBUG_W_STR("Failed to open", filePath);
+		}
+
+		if (gTSmapPtr != NULL)
+		{
+			gTSheader		=	(TYPE_TS_FileHdr *)gTSmapPtr;
+			gTSrawData		=	(TYPE_TS_Sample *)(gTSmapPtr + hdrSize);
+			gTSrollupData	=	(TYPE_TS_Point *)(gTSmapPtr + hdrSize + rawSize);
+
+			//*	keep the data from the last run if the layout matches
+			validFile	=	(gTSheader->magic == kTS_Magic) &&
+							(gTSheader->version == kTS_Version) &&
+							(gTSheader->maxChannels == kTS_MaxChannels) &&
+							(gTSheader->rawEntries == kTS_RawEntries) &&
+							(gTSheader->rollupEntries == kTS_RollupEntries) &&
+							(gTSheader->channelCnt <= kTS_MaxChannels);
+			if (validFile == false)
+			{
+				CONSOLE_DEBUG_W_STR("Initializing time series store", filePath);
+				memset(gTSheader, 0, sizeof(TYPE_TS_FileHdr));
+				gTSheader->version			=	kTS_Version;
+				gTSheader->maxChannels		=	kTS_MaxChannels;
+				gTSheader->rawEntries		=	kTS_RawEntries;
+				gTSheader->rollupEntries	=	kTS_RollupEntries;
+				gTSheader->magic			=	kTS_Magic;
+			}
+			gTSlastSync_us	=	TimeSeries_GetTime_us();
+		}
+		else
+		{
+			gTSopenFailed	=	true;
+		}
+	}
+	pthread_mutex_unlock(&gTSmutex);
+	return(gTSmapPtr != NULL);
+}
+
+//*****************************************************************************
+void	TimeSeries_Close(void)
+{
+	pthread_mutex_lock(&gTSmutex);
+	if (gTSmapPtr != NULL)
+	{
+		msync(gTSmapPtr, gTSmapSize, MS_SYNC);
+		munmap(gTSmapPtr, gTSmapSize);
+		close(gTSfileDesc);
+		gTSmapPtr		=	NULL;
+		gTSheader		=	NULL;
+		gTSrawData		=	NULL;
+		gTSrollupData	=	NULL;
+		gTSfileDesc		=	-1;
+	}
+	pthread_mutex_unlock(&gTSmutex);
+}
+
+//*****************************************************************************
+//*	flushing is rate limited so the SD card is not written on every sample
+//*****************************************************************************
+static void	TimeSeries_SyncLocked(const bool forceSync, const int64_t currentTime_us)
+{
+	if ((gTSmapPtr != NULL) && (forceSync || ((currentTime_us - gTSlastSync_us) >= kTS_SyncInterval_us)))
+	{
+		msync(gTSmapPtr, gTSmapSize, MS_ASYNC);
+		gTSlastSync_us	=	currentTime_us;
+	}
+}
+
+//*****************************************************************************
+void	TimeSeries_Sync(const bool forceSync)
+{
+	pthread_mutex_lock(&gTSmutex);
+	TimeSeries_SyncLocked(forceSync, TimeSeries_GetTime_us());
+	pthread_mutex_unlock(&gTSmutex);
+}
+
+//*****************************************************************************
+//*	returns the channel index, the channel is created if it does not exist
+//*	returns -1 if the store is not available or is full
+//*	this searches the channel table, call it once and keep the index
+//*****************************************************************************
+int	TimeSeries_GetChannel(const char *channelName)
+{
+int		channelIdx;
+int		iii;
+
+	if ((gTSmapPtr == NULL) && (gTSopenFailed == false))
+	{
+		TimeSeries_Open(TimeSeries_GetFilePath());
+	}
+	channelIdx	=	-1;
+	pthread_mutex_lock(&gTSmutex);
+	if (gTSheader != NULL)
+	{
+		for (iii=0; iii<(int)gTSheader->channelCnt; iii++)
+		{
+			if (strncmp(gTSheader->channel[iii].name, channelName, (kTS_ChannelNameLen - 1)) == 0)
+			{
+				channelIdx	=	iii;
+				break;
+			}
+		}
+		if ((channelIdx < 0) && (gTSheader->channelCnt < kTS_MaxChannels))
+		{
+			channelIdx	=	gTSheader->channelCnt;
+			memset(&gTSheader->channel[channelIdx], 0, sizeof(TYPE_TS_Channel));
+			strncpy(gTSheader->channel[channelIdx].name, channelName, (kTS_ChannelNameLen - 1));
+			gTSheader->channelCnt++;
+		}
+		else if (channelIdx < 0)
+		{
+			CONSOLE_DEBUG_W_STR("Time series store is full, cannot add", channelName);
+		}
+	}
+	pthread_mutex_unlock(&gTSmutex);
+	return(channelIdx);
+}
+
+//*****************************************************************************
+void	TimeSeries_Append(const int channelIdx, const double value)
+{
+TYPE_TS_Channel	*channelPtr;
+TYPE_TS_Sample	*samplePtr;
+TYPE_TS_Accum	*accumPtr;
+TYPE_TS_Point	*bucketPtr;
+int64_t			currentTime_us;
+int64_t			bucketStart_us;
+int				level;
+
+	if ((channelIdx < 0) || (channelIdx >= kTS_MaxChannels))
+	{
+		return;
+	}
+	currentTime_us	=	TimeSeries_GetTime_us();
+	pthread_mutex_lock(&gTSmutex);
+	if ((gTSheader != NULL) && (channelIdx < (int)gTSheader->channelCnt))
+	{
+		channelPtr			=	&gTSheader->channel[channelIdx];
+		samplePtr			=	&GetRawRing(channelIdx)[channelPtr->rawCount % kTS_RawEntries];
+		samplePtr->time_us	=	currentTime_us;
+		samplePtr->value	=	value;
+		channelPtr->rawCount++;
+
+		//*	roll the sample up into each of the coarser levels
+		for (level=kTS_Level_1Sec; level<kTS_Level_Count; level++)
+		{
+			accumPtr		=	&channelPtr->accum[level];
+			bucketStart_us	=	currentTime_us - (currentTime_us % gBucketWidth_us[level]);
+			if ((accumPtr->count > 0) && (accumPtr->bucketStart_us != bucketStart_us))
+			{
+				//*	the bucket is complete, move it to the ring
+				bucketPtr			=	&GetRollupRing(channelIdx, level)[channelPtr->rollupCount[level] % kTS_RollupEntries];
+				bucketPtr->time_us	=	accumPtr->bucketStart_us;
+				bucketPtr->minValue	=	accumPtr->minValue;
+				bucketPtr->maxValue	=	accumPtr->maxValue;
+				bucketPtr->avgValue	=	accumPtr->sum / accumPtr->count;
+				bucketPtr->count	=	accumPtr->count;
+				channelPtr->rollupCount[level]++;
+				accumPtr->count		=	0;
+			}
+			if (accumPtr->count == 0)
+			{
+				accumPtr->bucketStart_us	=	bucketStart_us;
+				accumPtr->sum				=	0.0;
+				accumPtr->minValue			=	value;
+				accumPtr->maxValue			=	value;
+			}
+			accumPtr->sum	+=	value;
+			if (value < accumPtr->minValue)
+			{
+				accumPtr->minValue	=	value;
+			}
+			if (value > accumPtr->maxValue)
+			{
+				accumPtr->maxValue	=	value;
+			}
+			accumPtr->count++;
+		}
+		TimeSeries_SyncLocked(false, currentTime_us);
+	}
+	pthread_mutex_unlock(&gTSmutex);
+}
+
+//*****************************************************************************
+//*	returns the time of a logical ring entry, 0 is the oldest
+//*****************************************************************************
+static int64_t	GetEntryTime(const int channelIdx, const int level, const uint64_t firstEntry, const uint64_t entryIdx)
+{
+int64_t		entryTime_us;
+
+	if (level == kTS_Level_Raw)
+	{
+		entryTime_us	=	GetRawRing(channelIdx)[(firstEntry + entryIdx) % kTS_RawEntries].time_us;
+	}
+	else
+	{
+		entryTime_us	=	GetRollupRing(channelIdx, level)[(firstEntry + entryIdx) % kTS_RollupEntries].time_us;
+	}
+	return(entryTime_us);
+}
+
+//*****************************************************************************
+//*	returns the number of points copied, the rings are in time order so the
+//*	start of the range is found with a binary search
+//*****************************************************************************
+int	TimeSeries_Query(	const int		channelIdx,
+						const int		level,
+						const int64_t	start_us,
+						const int64_t	end_us,
+						TYPE_TS_Point	*points,
+						const int		maxPoints)
+{
+TYPE_TS_Channel	*channelPtr;
+TYPE_TS_Sample	*samplePtr;
+TYPE_TS_Accum	*accumPtr;
+uint64_t		totalCount;
+uint64_t		capacity;
+uint64_t		validCnt;
+uint64_t		firstEntry;
+uint64_t		lowIdx;
+uint64_t		highIdx;
+uint64_t		midIdx;
+int64_t			entryTime_us;
+int				pointCnt;
+
+	pointCnt	=	0;
+	if ((channelIdx < 0) || (channelIdx >= kTS_MaxChannels) || (level < 0) || (level >= kTS_Level_Count))
+	{
+		return(0);
+	}
+	pthread_mutex_lock(&gTSmutex);
+	if ((gTSheader != NULL) && (channelIdx < (int)gTSheader->channelCnt))
+	{
+		channelPtr	=	&gTSheader->channel[channelIdx];
+		if (level == kTS_Level_Raw)
+		{
+			totalCount	=	channelPtr->rawCount;
+			capacity	=	kTS_RawEntries;
+		}
+		else
+		{
+			totalCount	=	channelPtr->rollupCount[level];
+			capacity	=	kTS_RollupEntries;
+		}
+		validCnt	=	(totalCount < capacity) ? totalCount : capacity;
+		firstEntry	=	totalCount - validCnt;
+
+		lowIdx		=	0;
+		highIdx		=	validCnt;
+		while (lowIdx < highIdx)
+		{
+			midIdx	=	(lowIdx + highIdx) / 2;
+			if (GetEntryTime(channelIdx, level, firstEntry, midIdx) < start_us)
+			{
+				lowIdx	=	midIdx + 1;
+			}
+			else
+			{
+				highIdx	=	midIdx;
+			}
+		}
+
+		while ((lowIdx < validCnt) && (pointCnt < maxPoints))
+		{
+			entryTime_us	=	GetEntryTime(channelIdx, level, firstEntry, lowIdx);
+			if (entryTime_us > end_us)
+			{
+				break;
+			}
+			if (level == kTS_Level_Raw)
+			{
+				samplePtr						=	&GetRawRing(channelIdx)[(firstEntry + lowIdx) % kTS_RawEntries];
+				points[pointCnt].time_us		=	samplePtr->time_us;
+				points[pointCnt].minValue		=	samplePtr->value;
+				points[pointCnt].maxValue		=	samplePtr->value;
+				points[pointCnt].avgValue		=	samplePtr->value;
+				points[pointCnt].count			=	1;
+			}
+			else
+			{
+				points[pointCnt]	=	GetRollupRing(channelIdx, level)[(firstEntry + lowIdx) % kTS_RollupEntries];
+			}
+			pointCnt++;
+			lowIdx++;
+		}
+
+		//*	include the bucket that is still being filled
+		if (level != kTS_Level_Raw)
+		{
+			accumPtr	=	&channelPtr->accum[level];
+			if ((accumPtr->count > 0) && (pointCnt < maxPoints) &&
+				(accumPtr->bucketStart_us >= start_us) && (accumPtr->bucketStart_us <= end_us))
+			{
+				points[pointCnt].time_us		=	accumPtr->bucketStart_us;
+				points[pointCnt].minValue		=	accumPtr->minValue;
+				points[pointCnt].maxValue		=	accumPtr->maxValue;
+				points[pointCnt].avgValue		=	accumPtr->sum / accumPtr->count;
+				points[pointCnt].count			=	accumPtr->count;
+				pointCnt++;
+			}
+		}
+	}
+	pthread_mutex_unlock(&gTSmutex);
+	return(pointCnt);
+}
+
+//*****************************************************************************
+//*	returns the finest level that still has data back to start_us
+//*****************************************************************************
+int	TimeSeries_GetBestLevel(const int channelIdx, const int64_t start_us)
+{
+TYPE_TS_Channel	*channelPtr;
+uint64_t		totalCount;
+uint64_t		capacity;
+int				bestLevel;
+int				level;
+
+	bestLevel	=	kTS_Level_Count - 1;
+	pthread_mutex_lock(&gTSmutex);
+	if ((gTSheader != NULL) && (channelIdx >= 0) && (channelIdx < (int)gTSheader->channelCnt))
+	{
+		channelPtr	=	&gTSheader->channel[channelIdx];
+		for (level=kTS_Level_Raw; level<kTS_Level_Count; level++)
+		{
+			totalCount	=	(level == kTS_Level_Raw) ? channelPtr->rawCount : channelPtr->rollupCount[level];
+			capacity	=	(level == kTS_Level_Raw) ? kTS_RawEntries : kTS_RollupEntries;
+			//*	if the ring has not wrapped, it has everything
+			if ((totalCount <= capacity) ||
+				(GetEntryTime(channelIdx, level, (totalCount - capacity), 0) <= start_us))
+			{
+				bestLevel	=	level;
+				break;
+			}
+		}
+	}
+	pthread_mutex_unlock(&gTSmutex);
+	return(bestLevel);
+}
+
+//*****************************************************************************
+int	TimeSeries_GetChannelCount(void)
+{
+int		channelCnt;
+
+	if ((gTSmapPtr == NULL) && (gTSopenFailed == false))
+	{
+		TimeSeries_Open(TimeSeries_GetFilePath());
+	}
+	channelCnt	=	0;
+	pthread_mutex_lock(&gTSmutex);
+	if (gTSheader != NULL)
+	{
+		channelCnt	=	gTSheader->channelCnt;
+	}
+	pthread_mutex_unlock(&gTSmutex);
+	return(channelCnt);
+}
+
+//*****************************************************************************
+bool	TimeSeries_GetChannelName(const int channelIdx, char *channelName)
+{
+bool	validFlag;
+
+	validFlag	=	false;
+	pthread_mutex_lock(&gTSmutex);
+	if ((gTSheader != NULL) && (channelIdx >= 0) && (channelIdx < (int)gTSheader->channelCnt))
+	{
+		strncpy(channelName, gTSheader->channel[channelIdx].name, kTS_ChannelNameLen);
+		channelName[kTS_ChannelNameLen - 1]	=	0;
+		validFlag	=	true;
+	}
+	pthread_mutex_unlock(&gTSmutex);
+	return(validFlag);
+}
+
+//*****************************************************************************
+uint64_t	TimeSeries_GetSampleCount(const int channelIdx)
+{
+uint64_t	sampleCnt;
+
+	sampleCnt	=	0;
+	pthread_mutex_lock(&gTSmutex);
+	if ((gTSheader != NULL) && (channelIdx >= 0) && (channelIdx < (int)gTSheader->channelCnt))
+	{
+		sampleCnt	=	gTSheader->channel[channelIdx].rawCount;
+	}
+	pthread_mutex_unlock(&gTSmutex);
+	return(sampleCnt);
+}
+
+#ifdef _INCLUDE_TIMESERIES_MAIN_
+//*****************************************************************************
+//*	self test and append benchmark
+//*
+//*	gcc -O2 -D_INCLUDE_TIMESERIES_MAIN_ -I../libs/src_mlsLib timeseries_store.c -lpthread -o timeseries
+//*****************************************************************************
+#include	<stdlib.h>
+
+#define	kBenchSampleCnt		1000000
+#define	kBenchChannelCnt	40
+
+//*****************************************************************************
+int	main(void)
+{
+char			testPath[64];
+char			channelName[kTS_ChannelNameLen];
+int				channelIdx[kBenchChannelCnt];
+TYPE_TS_Point	*points;
+int64_t			startTime_us;
+int64_t			byHandle_us;
+int64_t			byName_us;
+int				pointCnt;
+int				failCnt;
+int				iii;
+
+	failCnt	=	0;
+	points	=	(TYPE_TS_Point *)malloc(kTS_RawEntries * sizeof(TYPE_TS_Point));
+	sprintf(testPath, "timeseries-test-%d.dat", getpid());
+	TimeSeries_SetFilePath(testPath);
+	if (TimeSeries_GetFilePath()[0] != '/')
+	{
+		printf("FAIL: store path is not absolute (%s)\r\n", TimeSeries_GetFilePath());
+		failCnt++;
+	}
+	if ((points == NULL) || (TimeSeries_Open(TimeSeries_GetFilePath()) == false))
+	{
+		printf("FAIL: could not open %s\r\n", TimeSeries_GetFilePath());
+		return(1);
+	}
+
+	//*	registering the same name twice gives the same channel
+	for (iii=0; iii<kBenchChannelCnt; iii++)
+	{
+		sprintf(channelName, "camera%d-CoolerPower", iii);
+		channelIdx[iii]	=	TimeSeries_GetChannel(channelName);
+	}
+	if ((channelIdx[0] < 0) || (TimeSeries_GetChannel("camera0-CoolerPower") != channelIdx[0]))
+	{
+		printf("FAIL: channel registration\r\n");
+		failCnt++;
+	}
+
+	//*	the last channel is the worst case for a lookup by name
+	startTime_us	=	TimeSeries_GetTime_us();
+	for (iii=0; iii<kBenchSampleCnt; iii++)
+	{
+		TimeSeries_Append(channelIdx[kBenchChannelCnt - 1], iii);
+	}
+	byHandle_us		=	TimeSeries_GetTime_us() - startTime_us;
+
+	sprintf(channelName, "camera%d-CoolerPower", (kBenchChannelCnt - 2));
+	startTime_us	=	TimeSeries_GetTime_us();
+	for (iii=0; iii<kBenchSampleCnt; iii++)
+	{
+		TimeSeries_Append(TimeSeries_GetChannel(channelName), iii);
+	}
+	byName_us		=	TimeSeries_GetTime_us() - startTime_us;
+
+	printf("append by handle\t= %6.1f ns/sample\r\n", (1000.0 * byHandle_us) / kBenchSampleCnt);
+	printf("append by name\t\t= %6.1f ns/sample (%d channels)\r\n", (1000.0 * byName_us) / kBenchSampleCnt, kBenchChannelCnt);
+
+	//*	the raw ring keeps the newest kTS_RawEntries samples in order
+	if (TimeSeries_GetSampleCount(channelIdx[kBenchChannelCnt - 1]) != kBenchSampleCnt)
+	{
+		printf("FAIL: sample count\r\n");
+		failCnt++;
+	}
+	pointCnt	=	TimeSeries_Query(channelIdx[kBenchChannelCnt - 1], kTS_Level_Raw, 0, INT64_MAX, points, kTS_RawEntries);
+	if ((pointCnt != kTS_RawEntries) ||
+		(points[0].avgValue != (kBenchSampleCnt - kTS_RawEntries)) ||
+		(points[pointCnt - 1].avgValue != (kBenchSampleCnt - 1)))
+	{
+		printf("FAIL: raw query, %d points\r\n", pointCnt);
+		failCnt++;
+	}
+	//*	every sample is in some 1 second bucket
+	pointCnt	=	TimeSeries_Query(channelIdx[kBenchChannelCnt - 1], kTS_Level_1Sec, 0, INT64_MAX, points, kTS_RawEntries);
+	if ((pointCnt < 1) || (points[pointCnt - 1].maxValue != (kBenchSampleCnt - 1)))
+	{
+		printf("FAIL: 1 second rollup, %d points\r\n", pointCnt);
+		failCnt++;
+	}
+	//*	an invalid handle is ignored
+	TimeSeries_Append(-1, 1.0);
+	TimeSeries_Append(kTS_NotRegistered, 1.0);
+
+	TimeSeries_Close();
+	unlink(TimeSeries_GetFilePath());
+	free(points);
+	printf("Failures = %d\r\n", failCnt);
+	return(failCnt);
+}
+#endif // _INCLUDE_TIMESERIES_MAIN_
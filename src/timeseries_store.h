@@ -0,0 +1,90 @@
+//*****************************************************************************
+//#include	"timeseries_store.h"
+
+#ifndef _TIMESERIES_STORE_H_
+#define	_TIMESERIES_STORE_H_
+
+#ifndef _STDINT_H
+	#include	<stdint.h>
+#endif
+#ifndef _STDBOOL_H
+	#include	<stdbool.h>
+#endif
+
+#ifdef __cplusplus
+	extern "C" {
+#endif
+
+#define	kTS_FileName			"alpacapi-timeseries.dat"
+#define	kTS_Magic				0x53455354		//*	'TSES'
+#define	kTS_Version				1
+#define	kTS_MaxChannels			48
+#define	kTS_ChannelNameLen		48
+#define	kTS_RawEntries			8192		//*	per channel
+#define	kTS_RollupEntries		2048		//*	per channel, per level
+#define	kTS_NotRegistered		-2			//*	initial value of a channel handle, -1 is a failed registration
+
+//*****************************************************************************
+//*	resolution levels, the raw samples are rolled up into fixed width buckets
+enum
+{
+	kTS_Level_Raw	=	0,
+	kTS_Level_1Sec,
+	kTS_Level_1Min,
+	kTS_Level_15Min,
+
+	kTS_Level_Count
+};
+
+//*****************************************************************************
+//*	one point returned from a query, for raw samples min=max=avg and count=1
+//*	this is also the on the wire format of the binary query response
+typedef struct	//	TYPE_TS_Point
+{
+	int64_t		time_us;		//*	sample time or start of the bucket, micro seconds since epoch
+	float		minValue;
+	float		maxValue;
+	float		avgValue;
+	uint32_t	count;
+} TYPE_TS_Point;
+
+//*****************************************************************************
+//*	header of the binary query response, followed by pointCnt TYPE_TS_Point
+typedef struct	//	TYPE_TS_QueryHdr
+{
+	uint32_t	magic;
+	uint32_t	version;
+	uint32_t	headerSize;		//*	offset to the first point
+	uint32_t	pointSize;		//*	sizeof(TYPE_TS_Point)
+	uint32_t	level;
+	uint32_t	pointCnt;
+	int64_t		start_us;
+	int64_t		end_us;
+} TYPE_TS_QueryHdr;
+
+
+void		TimeSeries_SetFilePath(const char *filePath);
+const char	*TimeSeries_GetFilePath(void);
+bool		TimeSeries_Open(const char *filePath);
+void		TimeSeries_Close(void);
+int			TimeSeries_GetChannel(const char *channelName);
+void		TimeSeries_Append(const int channelIdx, const double value);
+int			TimeSeries_Query(	const int		channelIdx,
+								const int		level,
+								const int64_t	start_us,
+								const int64_t	end_us,
+								TYPE_TS_Point	*points,
+								const int		maxPoints);
+int			TimeSeries_GetBestLevel(const int channelIdx, const int64_t start_us);
+int			TimeSeries_GetChannelCount(void);
+bool		TimeSeries_GetChannelName(const int channelIdx, char *channelName);
+uint64_t	TimeSeries_GetSampleCount(const int channelIdx);
+void		TimeSeries_Sync(const bool forceSync);
+int64_t		TimeSeries_GetTime_us(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // _TIMESERIES_STORE_H_
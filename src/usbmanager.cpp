@@ -31,6 +31,7 @@
 //*	Sep 20,	2023	<MLS> Added USB_DumpTable()
 //*	May  9,	2024	<MLS> Added auto init to USB_GetPathFromID()
 //*	Jun  1,	2024	<MLS> Added ttyACM to scanned ports
+//*	Oct 18,	2026	<MLS> Added mutex, startup probes call this from more than one thread
 //*****************************************************************************
 
 #include	<stdlib.h>
@@ -39,6 +40,7 @@
 #include	<dirent.h>
 #include	<errno.h>
 #include	<sys/stat.h>
+#include	<pthread.h>
 
 #define _ENABLE_CONSOLE_DEBUG_
 #include	"ConsoleDebug.h"
@@ -58,6 +60,7 @@ typedef struct
 
 static	TYPE_USBentry	gUSBtable[kMaxUSBdeviceCnt];
 static	int				gUSBcount	=	-1;
+static	pthread_mutex_t	gUSBmutex	=	PTHREAD_MUTEX_INITIALIZER;
 
 static int	USB_BuildTable(void);
 static int	USBpathSort(const void *e1, const void* e2);
@@ -70,6 +73,7 @@ int	USB_InitTable(void)
 {
 //	CONSOLE_DEBUG(__FUNCTION__);
 
+	pthread_mutex_lock(&gUSBmutex);
 	if (gUSBcount <= 0)
 	{
 		gUSBcount	=	USB_BuildTable();
@@ -78,6 +82,7 @@ int	USB_InitTable(void)
 			RunUSBprofile();
 		}
 	}
+	pthread_mutex_unlock(&gUSBmutex);
 //	CONSOLE_DEBUG_W_NUM("gUSBcount\t=", gUSBcount);
 
 	return(gUSBcount);
@@ -207,6 +212,7 @@ bool	foundIt;
 
 //	CONSOLE_DEBUG_W_STR("Looking for:", idString);
 
+	pthread_mutex_lock(&gUSBmutex);
 	foundIt	=	false;
 	iii		=	0;
 	while ((foundIt == false) && (iii < gUSBcount))
@@ -226,6 +232,7 @@ bool	foundIt;
 		}
 		iii++;
 	}
+	pthread_mutex_unlock(&gUSBmutex);
 	return(foundIt);
 }
 